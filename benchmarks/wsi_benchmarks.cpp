@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Micro-benchmarks for the layer's swapchain hot paths.
+ *
+ * Exercises the machinery a present travels through - the futex-based timed semaphores, the
+ * pending-present ring buffer handoff to the page flip thread, and the dispatch table lookup -
+ * without needing a display, compositor or ICD. A mock presenter thread stands in for the page
+ * flip thread so the acquire/present round-trip can be measured end to end.
+ *
+ * Results are printed as one JSON object per line so CI can gate merges on the percentiles:
+ *
+ *    {"benchmark": "acquire_present_round_trip", "samples": 10000, "p50_ns": ..., ...}
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include <layer/private_data.hpp>
+#include <util/ring_buffer.hpp>
+#include <util/timed_semaphore.hpp>
+
+namespace
+{
+
+uint64_t monotonic_ns()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t percentile(std::vector<uint64_t> &sorted_samples, double p)
+{
+   const size_t index = static_cast<size_t>(p * static_cast<double>(sorted_samples.size() - 1));
+   return sorted_samples[index];
+}
+
+void report(const char *name, std::vector<uint64_t> &samples)
+{
+   std::sort(samples.begin(), samples.end());
+
+   uint64_t sum = 0;
+   for (auto sample : samples)
+   {
+      sum += sample;
+   }
+
+   std::printf("{\"benchmark\": \"%s\", \"samples\": %zu, \"mean_ns\": %" PRIu64 ", \"p50_ns\": %" PRIu64
+               ", \"p90_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64 ", \"max_ns\": %" PRIu64 "}\n",
+               name, samples.size(), sum / samples.size(), percentile(samples, 0.5), percentile(samples, 0.9),
+               percentile(samples, 0.99), samples.back());
+}
+
+/**
+ * @brief Uncontended post/wait pair, the fast path of acquire when an image is already free.
+ */
+void benchmark_semaphore_uncontended()
+{
+   constexpr size_t iterations = 100000;
+
+   util::timed_semaphore sem;
+   if (sem.init(0) != VK_SUCCESS)
+   {
+      std::fprintf(stderr, "semaphore init failed\n");
+      return;
+   }
+
+   std::vector<uint64_t> samples;
+   samples.reserve(iterations);
+
+   for (size_t i = 0; i < iterations; i++)
+   {
+      const uint64_t start = monotonic_ns();
+      sem.post();
+      sem.wait(UINT64_MAX);
+      samples.push_back(monotonic_ns() - start);
+   }
+
+   report("timed_semaphore_uncontended", samples);
+}
+
+/**
+ * @brief Cross-thread wake latency: time from post() to the sleeping waiter running again.
+ *
+ * This is the latency acquire_next_image pays when it blocks until the page flip thread
+ * releases an image.
+ */
+void benchmark_semaphore_wake()
+{
+   constexpr size_t iterations = 10000;
+
+   util::timed_semaphore wake_sem;
+   util::timed_semaphore ack_sem;
+   if (wake_sem.init(0) != VK_SUCCESS || ack_sem.init(0) != VK_SUCCESS)
+   {
+      std::fprintf(stderr, "semaphore init failed\n");
+      return;
+   }
+
+   std::vector<uint64_t> samples(iterations);
+   uint64_t post_time = 0;
+
+   std::thread waiter{ [&]() {
+      for (size_t i = 0; i < iterations; i++)
+      {
+         wake_sem.wait(UINT64_MAX);
+         samples[i] = monotonic_ns() - post_time;
+         ack_sem.post();
+      }
+   } };
+
+   for (size_t i = 0; i < iterations; i++)
+   {
+      /* Give the waiter time to go back to sleep so the futex wake is measured,
+       * not the spin path. */
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+      post_time = monotonic_ns();
+      wake_sem.post();
+      ack_sem.wait(UINT64_MAX);
+   }
+
+   waiter.join();
+   report("timed_semaphore_wake", samples);
+}
+
+struct mock_present_request
+{
+   uint32_t image_index;
+};
+
+/**
+ * @brief Full acquire/present/release round-trip against a mock presenter thread.
+ *
+ * Replicates the swapchain handoff: the application thread queues a present into the
+ * lock-free pending ring and posts the page flip semaphore; the presenter consumes it and
+ * posts the free-image semaphore, which the application blocks on like acquire_next_image.
+ */
+void benchmark_acquire_present_round_trip()
+{
+   constexpr size_t iterations = 10000;
+   constexpr uint32_t num_images = 3;
+
+   util::spsc_ring_buffer<mock_present_request, 8> pending_ring;
+   util::timed_semaphore page_flip_sem;
+   util::timed_semaphore free_image_sem;
+   if (page_flip_sem.init(0) != VK_SUCCESS || free_image_sem.init(num_images) != VK_SUCCESS)
+   {
+      std::fprintf(stderr, "semaphore init failed\n");
+      return;
+   }
+
+   std::thread presenter{ [&]() {
+      for (size_t i = 0; i < iterations; i++)
+      {
+         page_flip_sem.wait(UINT64_MAX);
+         auto request = pending_ring.pop_front();
+         if (!request.has_value())
+         {
+            std::fprintf(stderr, "pending ring empty\n");
+            return;
+         }
+         free_image_sem.post();
+      }
+   } };
+
+   std::vector<uint64_t> samples;
+   samples.reserve(iterations);
+
+   for (size_t i = 0; i < iterations; i++)
+   {
+      const uint64_t start = monotonic_ns();
+      pending_ring.push_back({ static_cast<uint32_t>(i % num_images) });
+      page_flip_sem.post();
+      free_image_sem.wait(UINT64_MAX);
+      samples.push_back(monotonic_ns() - start);
+   }
+
+   presenter.join();
+   report("acquire_present_round_trip", samples);
+}
+
+VKAPI_ATTR void VKAPI_CALL stub_entrypoint()
+{
+}
+
+/**
+ * @brief Cost of the name-based dispatch table lookup performed per intercepted call.
+ *
+ * The lookups are timed in batches as a single lookup is below clock resolution; the
+ * distribution is over per-lookup averages of each batch.
+ */
+void benchmark_dispatch_lookup()
+{
+   constexpr size_t batches = 1000;
+   constexpr size_t batch_size = 1024;
+
+   const auto &allocator = util::allocator::get_generic();
+   auto entrypoints = allocator.make_unique<layer::dispatch_table::entrypoint_list>(allocator);
+   if (entrypoints == nullptr)
+   {
+      std::fprintf(stderr, "dispatch table creation failed\n");
+      return;
+   }
+
+   /* Fill the entrypoint map with a realistic number of entries. */
+   static const char *entrypoint_names[] = {
+      "vkGetDeviceProcAddr",     "vkQueuePresentKHR",      "vkAcquireNextImageKHR", "vkCreateSwapchainKHR",
+      "vkDestroySwapchainKHR",   "vkGetSwapchainImagesKHR", "vkCreateImage",         "vkDestroyImage",
+      "vkAllocateMemory",        "vkFreeMemory",            "vkBindImageMemory",     "vkCreateFence",
+      "vkDestroyFence",          "vkWaitForFences",         "vkResetFences",         "vkCreateSemaphore",
+      "vkDestroySemaphore",      "vkQueueSubmit",           "vkQueueWaitIdle",       "vkDeviceWaitIdle",
+      "vkGetImageMemoryRequirements", "vkGetFenceStatus",   "vkDestroyDevice",       "vkSetDebugUtilsObjectNameEXT",
+   };
+
+   for (auto *name : entrypoint_names)
+   {
+      layer::entrypoint ep = { name, "", reinterpret_cast<PFN_vkVoidFunction>(stub_entrypoint), 0, false, true, 0 };
+      auto result = entrypoints->try_insert(std::make_pair(std::string{ name }, ep));
+      if (!result.has_value())
+      {
+         std::fprintf(stderr, "dispatch table insertion failed\n");
+         return;
+      }
+   }
+
+   layer::dispatch_table table{ std::move(entrypoints) };
+
+   std::vector<uint64_t> samples;
+   samples.reserve(batches);
+   PFN_vkVoidFunction sink = nullptr;
+
+   for (size_t batch = 0; batch < batches; batch++)
+   {
+      const uint64_t start = monotonic_ns();
+      for (size_t i = 0; i < batch_size; i++)
+      {
+         auto fn = table.get_fn<PFN_vkVoidFunction>("vkQueuePresentKHR");
+         if (fn.has_value())
+         {
+            sink = *fn;
+         }
+      }
+      samples.push_back((monotonic_ns() - start) / batch_size);
+   }
+
+   /* Keep the lookups observable. */
+   if (sink != nullptr)
+   {
+      sink();
+   }
+
+   report("dispatch_table_lookup", samples);
+}
+
+} /* namespace */
+
+int main()
+{
+   benchmark_semaphore_uncontended();
+   benchmark_semaphore_wake();
+   benchmark_acquire_present_round_trip();
+   benchmark_dispatch_lookup();
+   return 0;
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Auto-tuning benchmark for the SHM presenter's copy kernels.
+ *
+ * The optimal copy thread count, the frame size above which threading pays off
+ * and the size above which streaming stores beat the cache differ wildly
+ * between CPU implementations; hand-tuning them per SKU does not scale. This
+ * tool measures the same copy strategies the presenter uses - cached and
+ * streaming stores, single-threaded and split across a worker pool - on the
+ * local machine across frame sizes and strides, and writes a small profile:
+ *
+ *    # wsi_copy_bench machine profile
+ *    COPY_THREADS=4
+ *    COPY_THREAD_PIXELS=307200
+ *    COPY_NT_BYTES=2097152
+ *
+ * The presenter loads the profile at init from /etc/sky1/wsi-copy-profile.conf
+ * or /usr/share/cix-gpu/wsi-copy-profile.conf (VULKAN_WSI_COPY_PROFILE
+ * overrides the path). Measurements are also printed as one JSON object per
+ * line, in the same shape as wsi_benchmarks.
+ *
+ * Usage: wsi_copy_bench [output-profile-path]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+/* Mirrors the presenter's pool limit and row claiming granularity. */
+constexpr uint32_t MAX_COPY_THREADS = 8u;
+constexpr uint32_t COPY_ROWS_PER_CHUNK = 16u;
+
+/* Padding appended to the source stride so the row loop is measured with the
+ * non-contiguous layouts real swapchain images have. */
+constexpr uint32_t STRIDE_PAD_PIXELS = 16u;
+
+constexpr int WARMUP_ITERATIONS = 3;
+constexpr int TIMED_ITERATIONS = 15;
+
+uint64_t monotonic_ns()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/* Streaming-store copy, matching the presenter's non-temporal kernels. */
+void copy_bytes_streaming(void *dst, const void *src, size_t size)
+{
+#if defined(__x86_64__) || defined(__i386__)
+   auto *d = static_cast<char *>(dst);
+   auto *s = static_cast<const char *>(src);
+
+   size_t head = (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15;
+   head = std::min(head, size);
+   std::memcpy(d, s, head);
+   d += head;
+   s += head;
+   size -= head;
+
+   const size_t vectors = size / 16;
+   for (size_t i = 0; i < vectors; i++)
+   {
+      __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s) + i);
+      _mm_stream_si128(reinterpret_cast<__m128i *>(d) + i, pixels);
+   }
+
+   std::memcpy(d + vectors * 16, s + vectors * 16, size - vectors * 16);
+   _mm_sfence();
+#elif defined(__aarch64__)
+   auto *d = static_cast<unsigned char *>(dst);
+   auto *s = static_cast<const unsigned char *>(src);
+
+   const size_t pairs = size / 32;
+   for (size_t i = 0; i < pairs; i++)
+   {
+      uint8x16_t lo = vld1q_u8(s + i * 32);
+      uint8x16_t hi = vld1q_u8(s + i * 32 + 16);
+      __asm__ volatile("stnp %q0, %q1, [%2]" : : "w"(lo), "w"(hi), "r"(d + i * 32) : "memory");
+   }
+
+   std::memcpy(d + pairs * 32, s + pairs * 32, size - pairs * 32);
+   __asm__ volatile("dmb ishst" ::: "memory");
+#else
+   std::memcpy(dst, src, size);
+#endif
+}
+
+/* Row copy with the presenter's chunked row claiming, so the thread scaling
+ * measured here includes the same atomic contention the pool sees. */
+void copy_rows_chunked(std::atomic<uint32_t> &next_row, const uint32_t *src, uint32_t *dst, uint32_t src_stride_pixels,
+                       uint32_t width, uint32_t height, bool streaming)
+{
+   const size_t row_bytes = static_cast<size_t>(width) * sizeof(uint32_t);
+   while (true)
+   {
+      const uint32_t row = next_row.fetch_add(COPY_ROWS_PER_CHUNK, std::memory_order_relaxed);
+      if (row >= height)
+      {
+         return;
+      }
+
+      const uint32_t count = std::min(COPY_ROWS_PER_CHUNK, height - row);
+      for (uint32_t i = 0; i < count; i++)
+      {
+         const uint32_t *src_row = src + static_cast<size_t>(row + i) * src_stride_pixels;
+         uint32_t *dst_row = dst + static_cast<size_t>(row + i) * width;
+         if (streaming)
+         {
+            copy_bytes_streaming(dst_row, src_row, row_bytes);
+         }
+         else
+         {
+            std::memcpy(dst_row, src_row, row_bytes);
+         }
+      }
+   }
+}
+
+/* Median time in nanoseconds for one full copy of the frame. */
+uint64_t time_copy(const uint32_t *src, uint32_t *dst, uint32_t src_stride_pixels, uint32_t width, uint32_t height,
+                   uint32_t threads, bool streaming)
+{
+   std::vector<uint64_t> samples;
+   samples.reserve(TIMED_ITERATIONS);
+
+   for (int iteration = 0; iteration < WARMUP_ITERATIONS + TIMED_ITERATIONS; iteration++)
+   {
+      std::atomic<uint32_t> next_row{ 0 };
+      const uint64_t start = monotonic_ns();
+
+      std::vector<std::thread> workers;
+      workers.reserve(threads - 1);
+      for (uint32_t i = 1; i < threads; i++)
+      {
+         workers.emplace_back(copy_rows_chunked, std::ref(next_row), src, dst, src_stride_pixels, width, height,
+                              streaming);
+      }
+      copy_rows_chunked(next_row, src, dst, src_stride_pixels, width, height, streaming);
+      for (auto &worker : workers)
+      {
+         worker.join();
+      }
+
+      if (iteration >= WARMUP_ITERATIONS)
+      {
+         samples.push_back(monotonic_ns() - start);
+      }
+   }
+
+   std::sort(samples.begin(), samples.end());
+   return samples[samples.size() / 2];
+}
+
+void report(const char *name, uint32_t width, uint32_t height, uint32_t threads, bool streaming, uint64_t median_ns)
+{
+   const double bytes = static_cast<double>(width) * height * sizeof(uint32_t);
+   const double gib_per_s = bytes / (static_cast<double>(median_ns) / 1e9) / (1024.0 * 1024.0 * 1024.0);
+   std::printf("{\"benchmark\": \"%s\", \"width\": %" PRIu32 ", \"height\": %" PRIu32 ", \"threads\": %" PRIu32
+               ", \"streaming\": %s, \"median_ns\": %" PRIu64 ", \"gib_per_s\": %.2f}\n",
+               name, width, height, threads, streaming ? "true" : "false", median_ns, gib_per_s);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+   const char *profile_path = argc > 1 ? argv[1] : "wsi-copy-profile.conf";
+
+   uint32_t hw_threads = std::thread::hardware_concurrency();
+   if (hw_threads == 0)
+   {
+      hw_threads = 1;
+   }
+   const uint32_t max_threads = std::min(hw_threads, MAX_COPY_THREADS);
+
+   /* One buffer pair big enough for the largest measured frame. */
+   const uint32_t max_width = 3840;
+   const uint32_t max_height = 2160;
+   const size_t max_pixels = static_cast<size_t>(max_width + STRIDE_PAD_PIXELS) * max_height;
+   std::vector<uint32_t> src(max_pixels, 0x12345678u);
+   std::vector<uint32_t> dst(max_pixels, 0);
+
+   /* 1. Streaming store crossover: the smallest frame where bypassing the
+    *    cache beats writing through it. Below the crossover the copy fits in
+    *    cache and stays warm for the X server's read back. */
+   const uint32_t crossover_heights[] = { 135, 270, 540, 1080, 2160 };
+   size_t nt_bytes = 0;
+   for (uint32_t height : crossover_heights)
+   {
+      const uint32_t width = 1920;
+      const uint32_t stride = width + STRIDE_PAD_PIXELS;
+      const uint64_t cached_ns = time_copy(src.data(), dst.data(), stride, width, height, 1, false);
+      const uint64_t streaming_ns = time_copy(src.data(), dst.data(), stride, width, height, 1, true);
+      report("nt_crossover", width, height, 1, false, cached_ns);
+      report("nt_crossover", width, height, 1, true, streaming_ns);
+
+      if (nt_bytes == 0 && streaming_ns < cached_ns)
+      {
+         nt_bytes = static_cast<size_t>(width) * height * sizeof(uint32_t);
+      }
+   }
+
+   /* 2. Copy thread count: scale a full 1080p frame across the pool and take
+    *    the smallest thread count within 5% of the best, so marginal gains do
+    *    not claim cores the application could use. */
+   uint64_t best_ns = UINT64_MAX;
+   std::vector<uint64_t> thread_times(max_threads + 1, 0);
+   for (uint32_t threads = 1; threads <= max_threads; threads++)
+   {
+      const uint64_t median_ns = time_copy(src.data(), dst.data(), 1920 + STRIDE_PAD_PIXELS, 1920, 1080, threads, false);
+      thread_times[threads] = median_ns;
+      best_ns = std::min(best_ns, median_ns);
+      report("thread_scaling", 1920, 1080, threads, false, median_ns);
+   }
+
+   uint32_t copy_threads = 1;
+   for (uint32_t threads = 1; threads <= max_threads; threads++)
+   {
+      if (thread_times[threads] <= best_ns + best_ns / 20)
+      {
+         copy_threads = threads;
+         break;
+      }
+   }
+
+   /* 3. Threading threshold: the smallest frame where waking the pool beats
+    *    copying on the presentation thread alone. */
+   const uint32_t threshold_sizes[] = { 128, 256, 400, 512, 768, 1024 };
+   uint32_t thread_pixels = 0;
+   if (copy_threads > 1)
+   {
+      for (uint32_t size : threshold_sizes)
+      {
+         const uint64_t single_ns = time_copy(src.data(), dst.data(), size + STRIDE_PAD_PIXELS, size, size, 1, false);
+         const uint64_t threaded_ns =
+            time_copy(src.data(), dst.data(), size + STRIDE_PAD_PIXELS, size, size, copy_threads, false);
+         report("threading_threshold", size, size, 1, false, single_ns);
+         report("threading_threshold", size, size, copy_threads, false, threaded_ns);
+
+         if (thread_pixels == 0 && threaded_ns < single_ns)
+         {
+            thread_pixels = size * size;
+         }
+      }
+   }
+
+   FILE *profile = std::fopen(profile_path, "w");
+   if (profile == nullptr)
+   {
+      std::fprintf(stderr, "wsi_copy_bench: cannot write %s\n", profile_path);
+      return 1;
+   }
+
+   /* Keys the measurements could not decide are left out; the presenter keeps
+    * its built-in heuristics for them. */
+   std::fprintf(profile, "# wsi_copy_bench machine profile, %" PRIu32 " hardware threads\n", hw_threads);
+   std::fprintf(profile, "COPY_THREADS=%" PRIu32 "\n", copy_threads);
+   if (thread_pixels != 0)
+   {
+      std::fprintf(profile, "COPY_THREAD_PIXELS=%" PRIu32 "\n", thread_pixels);
+   }
+   if (nt_bytes != 0)
+   {
+      std::fprintf(profile, "COPY_NT_BYTES=%zu\n", nt_bytes);
+   }
+   std::fclose(profile);
+
+   std::printf("{\"profile\": \"%s\", \"copy_threads\": %" PRIu32 ", \"thread_pixels\": %" PRIu32
+               ", \"nt_bytes\": %zu}\n",
+               profile_path, copy_threads, thread_pixels, nt_bytes);
+   return 0;
+}
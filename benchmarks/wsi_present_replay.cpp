@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Deterministic replay of captured present traces.
+ *
+ * Replays a trace recorded with VULKAN_WSI_PRESENT_TRACE against a headless
+ * swapchain, reproducing the application's acquire/present cadence - the same
+ * inter-call gaps, present mode and queue depth - so layer-side latency
+ * regressions can be bisected offline, without the game or the compositor.
+ * The headless backend completes presents immediately, acting as the mock
+ * presentation engine; everything above it (payload submission, the page flip
+ * thread, image state bookkeeping) is the real swapchain_base machinery.
+ *
+ * The time each replayed call spends inside the layer is printed as one JSON
+ * object per line, in the same shape as wsi_benchmarks:
+ *
+ *    {"benchmark": "replay_acquire", "samples": ..., "p50_ns": ..., ...}
+ *
+ * Usage: wsi_present_replay <trace-file>
+ *
+ * Run with the layer enabled (VK_EXT_headless_surface is the layer's own
+ * surface type) and VULKAN_WSI_PRESENT_TRACE unset, or the replay will record
+ * a trace of itself.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace
+{
+
+/* Layouts of the trace file, matching wsi/present_trace.hpp. */
+struct trace_header
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t record_size;
+};
+
+struct trace_record
+{
+   uint64_t timestamp_ns;
+   uint32_t event;
+   uint32_t image_index;
+   uint32_t present_mode;
+   uint32_t queue_depth;
+   uint32_t extension_mask;
+   uint32_t reserved;
+};
+
+constexpr uint32_t TRACE_EVENT_ACQUIRE = 0;
+constexpr uint32_t TRACE_EVENT_PRESENT = 1;
+
+uint64_t monotonic_ns()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t percentile(std::vector<uint64_t> &sorted_samples, double p)
+{
+   const size_t index = static_cast<size_t>(p * static_cast<double>(sorted_samples.size() - 1));
+   return sorted_samples[index];
+}
+
+void report(const char *name, std::vector<uint64_t> &samples)
+{
+   if (samples.empty())
+   {
+      return;
+   }
+   std::sort(samples.begin(), samples.end());
+
+   uint64_t sum = 0;
+   for (auto sample : samples)
+   {
+      sum += sample;
+   }
+
+   std::printf("{\"benchmark\": \"%s\", \"samples\": %zu, \"mean_ns\": %" PRIu64 ", \"p50_ns\": %" PRIu64
+               ", \"p90_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64 ", \"max_ns\": %" PRIu64 "}\n",
+               name, samples.size(), sum / samples.size(), percentile(samples, 0.5), percentile(samples, 0.9),
+               percentile(samples, 0.99), samples.back());
+}
+
+bool load_trace(const char *path, std::vector<trace_record> &records)
+{
+   FILE *file = std::fopen(path, "rb");
+   if (file == nullptr)
+   {
+      std::fprintf(stderr, "wsi_present_replay: cannot open %s\n", path);
+      return false;
+   }
+
+   trace_header header;
+   if (std::fread(&header, sizeof(header), 1, file) != 1 || std::memcmp(header.magic, "WSITRC0", 8) != 0 ||
+       header.version != 1 || header.record_size != sizeof(trace_record))
+   {
+      std::fprintf(stderr, "wsi_present_replay: %s is not a version 1 present trace\n", path);
+      std::fclose(file);
+      return false;
+   }
+
+   trace_record record;
+   while (std::fread(&record, sizeof(record), 1, file) == 1)
+   {
+      records.push_back(record);
+   }
+   std::fclose(file);
+
+   if (records.empty())
+   {
+      std::fprintf(stderr, "wsi_present_replay: %s holds no records\n", path);
+      return false;
+   }
+   return true;
+}
+
+/* Busy-free wait until the recorded offset from replay start has elapsed, so
+ * the replayed calls hit the layer with the recorded inter-call gaps. */
+void pace(uint64_t replay_start_ns, uint64_t trace_start_ns, uint64_t record_ns)
+{
+   const uint64_t target_ns = replay_start_ns + (record_ns - trace_start_ns);
+   const uint64_t now_ns = monotonic_ns();
+   if (target_ns > now_ns)
+   {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(target_ns - now_ns));
+   }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+   if (argc != 2)
+   {
+      std::fprintf(stderr, "usage: wsi_present_replay <trace-file>\n");
+      return 1;
+   }
+
+   std::vector<trace_record> records;
+   if (!load_trace(argv[1], records))
+   {
+      return 1;
+   }
+
+   /* Swapchain parameters reconstructed from the trace: the present mode of
+    * the first present, and enough images to cover the deepest recorded
+    * acquire-ahead. */
+   VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
+   uint32_t image_count = 0;
+   for (const auto &record : records)
+   {
+      if (record.event == TRACE_EVENT_PRESENT && image_count == 0)
+      {
+         present_mode = static_cast<VkPresentModeKHR>(record.present_mode);
+      }
+      image_count = std::max(image_count, record.image_index + 1);
+   }
+   image_count = std::max(image_count, 2u);
+
+   VkApplicationInfo app_info = {};
+   app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+   app_info.pApplicationName = "wsi_present_replay";
+   app_info.apiVersion = VK_API_VERSION_1_1;
+
+   const char *instance_extensions[] = { VK_KHR_SURFACE_EXTENSION_NAME, "VK_EXT_headless_surface" };
+   VkInstanceCreateInfo instance_info = {};
+   instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+   instance_info.pApplicationInfo = &app_info;
+   instance_info.enabledExtensionCount = 2;
+   instance_info.ppEnabledExtensionNames = instance_extensions;
+
+   VkInstance instance = VK_NULL_HANDLE;
+   if (vkCreateInstance(&instance_info, nullptr, &instance) != VK_SUCCESS)
+   {
+      std::fprintf(stderr, "wsi_present_replay: instance creation failed\n");
+      return 1;
+   }
+
+   uint32_t physical_device_count = 1;
+   VkPhysicalDevice physical_device = VK_NULL_HANDLE;
+   vkEnumeratePhysicalDevices(instance, &physical_device_count, &physical_device);
+   if (physical_device == VK_NULL_HANDLE)
+   {
+      std::fprintf(stderr, "wsi_present_replay: no physical device\n");
+      return 1;
+   }
+
+   VkHeadlessSurfaceCreateInfoEXT surface_info = {};
+   surface_info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+   auto create_headless_surface = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+      vkGetInstanceProcAddr(instance, "vkCreateHeadlessSurfaceEXT"));
+   VkSurfaceKHR surface = VK_NULL_HANDLE;
+   if (create_headless_surface == nullptr || create_headless_surface(instance, &surface_info, nullptr, &surface) != VK_SUCCESS)
+   {
+      std::fprintf(stderr, "wsi_present_replay: headless surface creation failed; is the layer enabled?\n");
+      return 1;
+   }
+
+   const float queue_priority = 1.0f;
+   VkDeviceQueueCreateInfo queue_info = {};
+   queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+   queue_info.queueFamilyIndex = 0;
+   queue_info.queueCount = 1;
+   queue_info.pQueuePriorities = &queue_priority;
+
+   const char *device_extensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+   VkDeviceCreateInfo device_info = {};
+   device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+   device_info.queueCreateInfoCount = 1;
+   device_info.pQueueCreateInfos = &queue_info;
+   device_info.enabledExtensionCount = 1;
+   device_info.ppEnabledExtensionNames = device_extensions;
+
+   VkDevice device = VK_NULL_HANDLE;
+   if (vkCreateDevice(physical_device, &device_info, nullptr, &device) != VK_SUCCESS)
+   {
+      std::fprintf(stderr, "wsi_present_replay: device creation failed\n");
+      return 1;
+   }
+   VkQueue queue = VK_NULL_HANDLE;
+   vkGetDeviceQueue(device, 0, 0, &queue);
+
+   VkSurfaceCapabilitiesKHR capabilities = {};
+   vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physical_device, surface, &capabilities);
+
+   VkSwapchainCreateInfoKHR swapchain_info = {};
+   swapchain_info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+   swapchain_info.surface = surface;
+   swapchain_info.minImageCount = std::max(image_count, capabilities.minImageCount);
+   swapchain_info.imageFormat = VK_FORMAT_B8G8R8A8_UNORM;
+   swapchain_info.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+   swapchain_info.imageExtent = { 1920, 1080 };
+   swapchain_info.imageArrayLayers = 1;
+   swapchain_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+   swapchain_info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+   swapchain_info.preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+   swapchain_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+   swapchain_info.presentMode = present_mode;
+   swapchain_info.clipped = VK_TRUE;
+
+   VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+   if (vkCreateSwapchainKHR(device, &swapchain_info, nullptr, &swapchain) != VK_SUCCESS)
+   {
+      std::fprintf(stderr, "wsi_present_replay: swapchain creation failed\n");
+      return 1;
+   }
+
+   VkFenceCreateInfo fence_info = {};
+   fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+   VkFence acquire_fence = VK_NULL_HANDLE;
+   vkCreateFence(device, &fence_info, nullptr, &acquire_fence);
+
+   /* Replay. The image index the mock presentation engine hands back can
+    * differ from the recorded one - what is reproduced is the call cadence,
+    * queue depth and present mode, which is what the layer's timing depends
+    * on. */
+   std::vector<uint64_t> acquire_samples;
+   std::vector<uint64_t> present_samples;
+   const uint64_t trace_start_ns = records.front().timestamp_ns;
+   const uint64_t replay_start_ns = monotonic_ns();
+   uint32_t acquired_index = UINT32_MAX;
+
+   for (const auto &record : records)
+   {
+      pace(replay_start_ns, trace_start_ns, record.timestamp_ns);
+
+      if (record.event == TRACE_EVENT_ACQUIRE)
+      {
+         const uint64_t start = monotonic_ns();
+         VkResult res = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, VK_NULL_HANDLE, acquire_fence,
+                                              &acquired_index);
+         acquire_samples.push_back(monotonic_ns() - start);
+         if (res != VK_SUCCESS)
+         {
+            std::fprintf(stderr, "wsi_present_replay: acquire failed (%d)\n", static_cast<int>(res));
+            return 1;
+         }
+         vkWaitForFences(device, 1, &acquire_fence, VK_TRUE, UINT64_MAX);
+         vkResetFences(device, 1, &acquire_fence);
+      }
+      else if (record.event == TRACE_EVENT_PRESENT && acquired_index != UINT32_MAX)
+      {
+         VkPresentInfoKHR present_info = {};
+         present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+         present_info.swapchainCount = 1;
+         present_info.pSwapchains = &swapchain;
+         present_info.pImageIndices = &acquired_index;
+
+         const uint64_t start = monotonic_ns();
+         VkResult res = vkQueuePresentKHR(queue, &present_info);
+         present_samples.push_back(monotonic_ns() - start);
+         if (res != VK_SUCCESS)
+         {
+            std::fprintf(stderr, "wsi_present_replay: present failed (%d)\n", static_cast<int>(res));
+            return 1;
+         }
+         acquired_index = UINT32_MAX;
+      }
+   }
+
+   vkDeviceWaitIdle(device);
+   report("replay_acquire", acquire_samples);
+   report("replay_present", present_samples);
+
+   const uint64_t trace_span_ns = records.back().timestamp_ns - trace_start_ns;
+   const uint64_t replay_span_ns = monotonic_ns() - replay_start_ns;
+   std::printf("{\"benchmark\": \"replay_cadence\", \"trace_span_ns\": %" PRIu64 ", \"replay_span_ns\": %" PRIu64
+               "}\n",
+               trace_span_ns, replay_span_ns);
+
+   vkDestroyFence(device, acquire_fence, nullptr);
+   vkDestroySwapchainKHR(device, swapchain, nullptr);
+   vkDestroyDevice(device, nullptr);
+   vkDestroySurfaceKHR(instance, surface, nullptr);
+   vkDestroyInstance(instance, nullptr);
+   return 0;
+}
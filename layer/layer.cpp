@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2025 Arm Limited.
+ * Copyright (c) 2016-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -351,6 +351,7 @@ VKAPI_ATTR VkResult create_device(VkPhysicalDevice physicalDevice, const VkDevic
     */
    auto &device_data = layer::device_private_data::get(*pDevice);
    device_data.set_layer_frame_boundary_handling_enabled(should_layer_handle_frame_boundary_events);
+   device_data.select_present_queue(pCreateInfo);
 
    result = device_data.set_device_enabled_extensions(modified_info.ppEnabledExtensionNames,
                                                       modified_info.enabledExtensionCount);
@@ -377,6 +378,13 @@ VKAPI_ATTR VkResult create_device(VkPhysicalDevice physicalDevice, const VkDevic
       device_data.set_present_id_feature_enabled(present_id_features->presentId);
    }
 
+   const auto present_wait_features = util::find_extension<VkPhysicalDevicePresentWaitFeaturesKHR>(
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR, pCreateInfo->pNext);
+   if (present_wait_features != nullptr)
+   {
+      device_data.set_present_wait_feature_enabled(present_wait_features->presentWait);
+   }
+
    auto *physical_device_swapchain_maintenance1_features =
       util::find_extension<VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT>(
          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT, pCreateInfo->pNext);
@@ -502,6 +510,13 @@ wsi_layer_vkGetPhysicalDeviceFeatures2KHR(VkPhysicalDevice physicalDevice,
       present_id_features->presentId = true;
    }
 
+   auto *present_wait_features = util::find_extension<VkPhysicalDevicePresentWaitFeaturesKHR>(
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR, pFeatures->pNext);
+   if (present_wait_features != nullptr)
+   {
+      present_wait_features->presentWait = true;
+   }
+
    wsi::set_swapchain_maintenance1_state(physicalDevice, physical_device_swapchain_maintenance1_features);
 
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
@@ -516,13 +531,34 @@ wsi_layer_vkGetPhysicalDeviceFeatures2KHR(VkPhysicalDevice physicalDevice,
 #endif
 }
 
-#define GET_PROC_ADDR(func)      \
-   if (!strcmp(funcName, #func)) \
-      return (PFN_vkVoidFunction)&wsi_layer_##func;
+/* Compile-time FNV-1a over entrypoint names. Engines and capture tools call
+ * GetProcAddr thousands of times at startup, so the intercepted-name chains below
+ * first compare a hash of the requested name against each candidate's hash, which
+ * the compiler folds to a constant; the full string compare only runs on a hash
+ * match, i.e. at most once per lookup barring 32-bit collisions.
+ */
+static constexpr uint32_t entrypoint_name_hash(const char *name)
+{
+   uint32_t hash = 2166136261u;
+   while (*name != '\0')
+   {
+      hash ^= static_cast<uint8_t>(*name++);
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+#define GET_PROC_ADDR(func)                                               \
+   {                                                                      \
+      constexpr uint32_t candidate_hash = entrypoint_name_hash(#func);    \
+      if (func_name_hash == candidate_hash && !strcmp(funcName, #func))   \
+         return (PFN_vkVoidFunction)&wsi_layer_##func;                    \
+   }
 
 VWL_VKAPI_CALL(PFN_vkVoidFunction)
 wsi_layer_vkGetDeviceProcAddr(VkDevice device, const char *funcName) VWL_API_POST
 {
+   const uint32_t func_name_hash = entrypoint_name_hash(funcName);
    if (layer::device_private_data::get(device).is_device_extension_enabled(VK_KHR_SWAPCHAIN_EXTENSION_NAME))
    {
       GET_PROC_ADDR(vkCreateSwapchainKHR);
@@ -533,12 +569,22 @@ wsi_layer_vkGetDeviceProcAddr(VkDevice device, const char *funcName) VWL_API_POS
       GET_PROC_ADDR(vkAcquireNextImage2KHR);
       GET_PROC_ADDR(vkGetDeviceGroupPresentCapabilitiesKHR);
       GET_PROC_ADDR(vkGetDeviceGroupSurfacePresentModesKHR);
+      /* Layer-specific readback query for host-visible swapchain images. */
+      GET_PROC_ADDR(vkGetSwapchainImageMappingWSI);
+      /* Layer-specific zero-copy frame capture interface. */
+      GET_PROC_ADDR(vkRegisterSwapchainFrameCaptureWSI);
+      GET_PROC_ADDR(vkUnregisterSwapchainFrameCaptureWSI);
+      GET_PROC_ADDR(vkCompleteCapturedFrameWSI);
    }
    if (layer::device_private_data::get(device).is_device_extension_enabled(
           VK_KHR_SHARED_PRESENTABLE_IMAGE_EXTENSION_NAME))
    {
       GET_PROC_ADDR(vkGetSwapchainStatusKHR);
    }
+   if (layer::device_private_data::get(device).is_device_extension_enabled(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+   {
+      GET_PROC_ADDR(vkWaitForPresentKHR);
+   }
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
    if (layer::device_private_data::get(device).is_device_extension_enabled(VK_EXT_PRESENT_TIMING_EXTENSION_NAME))
    {
@@ -551,6 +597,7 @@ wsi_layer_vkGetDeviceProcAddr(VkDevice device, const char *funcName) VWL_API_POS
    GET_PROC_ADDR(vkDestroyDevice);
 
    GET_PROC_ADDR(vkCreateImage);
+   GET_PROC_ADDR(vkDestroyImage);
    GET_PROC_ADDR(vkBindImageMemory2);
 
    /* VK_EXT_swapchain_maintenance1 */
@@ -560,6 +607,12 @@ wsi_layer_vkGetDeviceProcAddr(VkDevice device, const char *funcName) VWL_API_POS
       GET_PROC_ADDR(vkReleaseSwapchainImagesEXT);
    }
 
+   /* VK_EXT_display_control */
+   if (layer::device_private_data::get(device).is_device_extension_enabled(VK_EXT_DISPLAY_CONTROL_EXTENSION_NAME))
+   {
+      GET_PROC_ADDR(vkGetSwapchainCounterEXT);
+   }
+
    return layer::device_private_data::get(device).disp.get_user_enabled_entrypoint(
       device, layer::device_private_data::get(device).instance_data.api_version, funcName);
 }
@@ -567,6 +620,8 @@ wsi_layer_vkGetDeviceProcAddr(VkDevice device, const char *funcName) VWL_API_POS
 VWL_VKAPI_CALL(PFN_vkVoidFunction)
 wsi_layer_vkGetInstanceProcAddr(VkInstance instance, const char *funcName) VWL_API_POST
 {
+   const uint32_t func_name_hash = entrypoint_name_hash(funcName);
+
    GET_PROC_ADDR(vkGetDeviceProcAddr);
    GET_PROC_ADDR(vkGetInstanceProcAddr);
    GET_PROC_ADDR(vkCreateInstance);
@@ -574,9 +629,12 @@ wsi_layer_vkGetInstanceProcAddr(VkInstance instance, const char *funcName) VWL_A
    GET_PROC_ADDR(vkCreateDevice);
    GET_PROC_ADDR(vkGetPhysicalDevicePresentRectanglesKHR);
 
-   if (!strcmp(funcName, "vkGetPhysicalDeviceFeatures2"))
    {
-      return (PFN_vkVoidFunction)wsi_layer_vkGetPhysicalDeviceFeatures2KHR;
+      constexpr uint32_t features2_hash = entrypoint_name_hash("vkGetPhysicalDeviceFeatures2");
+      if (func_name_hash == features2_hash && !strcmp(funcName, "vkGetPhysicalDeviceFeatures2"))
+      {
+         return (PFN_vkVoidFunction)wsi_layer_vkGetPhysicalDeviceFeatures2KHR;
+      }
    }
 
    auto &instance_data = layer::instance_private_data::get(instance);
@@ -605,6 +663,11 @@ wsi_layer_vkGetInstanceProcAddr(VkInstance instance, const char *funcName) VWL_A
          GET_PROC_ADDR(vkGetPhysicalDeviceSurfaceCapabilities2KHR);
          GET_PROC_ADDR(vkGetPhysicalDeviceSurfaceFormats2KHR);
       }
+
+      if (instance_data.is_instance_extension_enabled(VK_EXT_DISPLAY_SURFACE_COUNTER_EXTENSION_NAME))
+      {
+         GET_PROC_ADDR(vkGetPhysicalDeviceSurfaceCapabilities2EXT);
+      }
    }
 
    return instance_data.disp.get_user_enabled_entrypoint(instance, instance_data.api_version, funcName);
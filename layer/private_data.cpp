@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2025 Arm Limited.
+ * Copyright (c) 2018-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -24,48 +24,133 @@
 
 #include <vulkan/vulkan.h>
 
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "private_data.hpp"
 #include "wsi/wsi_factory.hpp"
+#include "wsi/presentation_thread_pool.hpp"
 #include "wsi/surface.hpp"
+#include "wsi/swapchain_base.hpp"
+#include "util/config.hpp"
 #include "util/unordered_map.hpp"
+#include "util/handle_map.hpp"
 #include "util/log.hpp"
 #include "util/helpers.hpp"
 #include "util/macros.hpp"
 
+#include <cstdlib>
+#include <system_error>
+
 namespace layer
 {
 
+/* Serializes handle association and disassociation. Lookups on the entrypoint
+ * hot path go through util::concurrent_handle_map::get and do not take this lock.
+ */
 static std::mutex g_data_lock;
 
-/* The dictionaries below use plain pointers to store the instance/device private data objects.
+/* The tables below use plain pointers to store the instance/device private data objects.
  * This means that these objects are leaked if the application terminates without calling vkDestroyInstance
  * or vkDestroyDevice. This is fine as it is the application's responsibility to call these.
  */
-static util::unordered_map<void *, instance_private_data *> g_instance_data{ util::allocator::get_generic() };
-static util::unordered_map<void *, device_private_data *> g_device_data{ util::allocator::get_generic() };
+static constexpr std::size_t MAX_TRACKED_HANDLES = 64;
+static util::concurrent_handle_map<instance_private_data, MAX_TRACKED_HANDLES> g_instance_data;
+static util::concurrent_handle_map<device_private_data, MAX_TRACKED_HANDLES> g_device_data;
+
+/* Optional instance entrypoints that are still resolved eagerly at populate() time.
+ * These are the surface queries issued around swapchain creation and present mode
+ * switches, whose first call should not pay the lazy resolution cost.
+ */
+static constexpr const char *INSTANCE_HOT_ENTRYPOINTS[] = {
+   "vkGetPhysicalDeviceSurfaceCapabilitiesKHR", "vkGetPhysicalDeviceSurfaceFormatsKHR",
+   "vkGetPhysicalDeviceSurfacePresentModesKHR", "vkGetPhysicalDeviceSurfaceSupportKHR",
+   "vkGetPhysicalDeviceSurfaceCapabilities2KHR", "vkGetPhysicalDeviceSurfaceFormats2KHR",
+};
+
+/* Optional device entrypoints on the acquire/present frame loop, resolved eagerly so
+ * the first frame does not pay the lazy resolution cost.
+ */
+static constexpr const char *DEVICE_HOT_ENTRYPOINTS[] = {
+   "vkCreateSwapchainKHR",  "vkDestroySwapchainKHR",  "vkGetSwapchainImagesKHR",       "vkAcquireNextImageKHR",
+   "vkAcquireNextImage2KHR", "vkQueuePresentKHR",     "vkGetSwapchainStatusKHR",       "vkWaitForPresentKHR",
+   "vkImportFenceFdKHR",    "vkGetFenceFdKHR",        "vkImportSemaphoreFdKHR",        "vkGetSemaphoreFdKHR",
+   "vkWaitSemaphoresKHR",   "vkGetSemaphoreCounterValueKHR",
+};
+
+template <std::size_t N>
+static bool is_hot_entrypoint(const char *name, const char *const (&hot_list)[N])
+{
+   for (const char *hot_name : hot_list)
+   {
+      if (strcmp(name, hot_name) == 0)
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+PFN_vkVoidFunction dispatch_table::resolve_entrypoint_at(std::size_t index) const
+{
+   scoped_mutex lock(m_resolve_lock);
+   if (m_resolved[index])
+   {
+      return m_fn_table[index].load(std::memory_order_relaxed);
+   }
+   if (m_entrypoint_defs == nullptr || index >= m_entrypoint_count)
+   {
+      return nullptr;
+   }
+
+   PFN_vkVoidFunction fn = resolve_entrypoint(m_entrypoint_defs[index].name);
+   m_fn_table[index].store(fn, std::memory_order_release);
+   m_resolved[index] = true;
+   return fn;
+}
+
+PFN_vkVoidFunction instance_dispatch_table::resolve_entrypoint(const char *fn_name) const
+{
+   assert(m_get_proc != nullptr);
+   return m_get_proc(m_instance, fn_name);
+}
 
 VkResult instance_dispatch_table::populate(VkInstance instance, PFN_vkGetInstanceProcAddr get_proc)
 {
    static constexpr entrypoint entrypoints_init[] = {
 #define DISPATCH_TABLE_ENTRY(name, ext_name, api_version, required) \
-   { "vk" #name, ext_name, nullptr, api_version, false, required },
+   { "vk" #name, ext_name, nullptr, api_version, false, required, 0 },
       INSTANCE_ENTRYPOINTS_LIST(DISPATCH_TABLE_ENTRY)
 #undef DISPATCH_TABLE_ENTRY
    };
 
    static constexpr auto num_entrypoints = std::distance(std::begin(entrypoints_init), std::end(entrypoints_init));
 
+   m_instance = instance;
+   m_get_proc = get_proc;
+   m_entrypoint_defs = entrypoints_init;
+   m_entrypoint_count = num_entrypoints;
+
    for (size_t i = 0; i < num_entrypoints; i++)
    {
-      const entrypoint *entrypoint = &entrypoints_init[i];
-      PFN_vkVoidFunction ret = get_proc(instance, entrypoint->name);
-      if (!ret && entrypoint->required)
+      struct entrypoint e = entrypoints_init[i];
+      e.user_visible = false;
+      e.index = i;
+
+      /* Only entrypoints whose absence must fail instance creation and the hot
+       * surface-query set are resolved up front; the rest are resolved on first use. */
+      if (e.required || is_hot_entrypoint(e.name, INSTANCE_HOT_ENTRYPOINTS))
       {
-         return VK_ERROR_INITIALIZATION_FAILED;
+         PFN_vkVoidFunction ret = get_proc(instance, e.name);
+         if (!ret && e.required)
+         {
+            return VK_ERROR_INITIALIZATION_FAILED;
+         }
+         e.fn = ret;
+         m_fn_table[i].store(ret, std::memory_order_relaxed);
+         m_resolved[i] = true;
       }
-      struct entrypoint e = *entrypoint;
-      e.fn = ret;
-      e.user_visible = false;
 
       if (!m_entrypoints->try_insert(std::make_pair(e.name, e)).has_value())
       {
@@ -102,7 +187,13 @@ PFN_vkVoidFunction instance_dispatch_table::get_user_enabled_entrypoint(VkInstan
       if (item->second.user_visible || item->second.api_version <= api_version ||
           item->second.api_version == VK_API_VERSION_1_0)
       {
-         return item->second.fn;
+         /* Lazily resolved entrypoints keep nullptr in the map; fetch those through the
+          * function table, which caches the resolution. */
+         if (item->second.fn != nullptr)
+         {
+            return item->second.fn;
+         }
+         return get_cached_fn(item->second.index);
       }
       else
       {
@@ -113,27 +204,46 @@ PFN_vkVoidFunction instance_dispatch_table::get_user_enabled_entrypoint(VkInstan
    return GetInstanceProcAddr(instance, fn_name).value_or(nullptr);
 }
 
+PFN_vkVoidFunction device_dispatch_table::resolve_entrypoint(const char *fn_name) const
+{
+   assert(m_get_proc != nullptr);
+   return m_get_proc(m_device, fn_name);
+}
+
 VkResult device_dispatch_table::populate(VkDevice dev, PFN_vkGetDeviceProcAddr get_proc_fn)
 {
    static constexpr entrypoint entrypoints_init[] = {
 #define DISPATCH_TABLE_ENTRY(name, ext_name, api_version, required) \
-   { "vk" #name, ext_name, nullptr, api_version, false, required },
+   { "vk" #name, ext_name, nullptr, api_version, false, required, 0 },
       DEVICE_ENTRYPOINTS_LIST(DISPATCH_TABLE_ENTRY)
 #undef DISPATCH_TABLE_ENTRY
    };
    static constexpr auto num_entrypoints = std::distance(std::begin(entrypoints_init), std::end(entrypoints_init));
 
+   m_device = dev;
+   m_get_proc = get_proc_fn;
+   m_entrypoint_defs = entrypoints_init;
+   m_entrypoint_count = num_entrypoints;
+
    for (size_t i = 0; i < num_entrypoints; i++)
    {
-      const entrypoint entrypoint = entrypoints_init[i];
-      PFN_vkVoidFunction ret = get_proc_fn(dev, entrypoint.name);
-      if (!ret && entrypoint.required)
+      struct entrypoint e = entrypoints_init[i];
+      e.user_visible = false;
+      e.index = i;
+
+      /* Only entrypoints whose absence must fail device creation and the hot
+       * acquire/present set are resolved up front; the rest are resolved on first use. */
+      if (e.required || is_hot_entrypoint(e.name, DEVICE_HOT_ENTRYPOINTS))
       {
-         return VK_ERROR_INITIALIZATION_FAILED;
+         PFN_vkVoidFunction ret = get_proc_fn(dev, e.name);
+         if (!ret && e.required)
+         {
+            return VK_ERROR_INITIALIZATION_FAILED;
+         }
+         e.fn = ret;
+         m_fn_table[i].store(ret, std::memory_order_relaxed);
+         m_resolved[i] = true;
       }
-      struct entrypoint e = entrypoint;
-      e.fn = ret;
-      e.user_visible = false;
 
       if (!m_entrypoints->try_insert(std::make_pair(e.name, e)).has_value())
       {
@@ -156,7 +266,13 @@ PFN_vkVoidFunction device_dispatch_table::get_user_enabled_entrypoint(VkDevice d
       if (item->second.user_visible || item->second.api_version <= api_version ||
           item->second.api_version == VK_API_VERSION_1_0)
       {
-         return item->second.fn;
+         /* Lazily resolved entrypoints keep nullptr in the map; fetch those through the
+          * function table, which caches the resolution. */
+         if (item->second.fn != nullptr)
+         {
+            return item->second.fn;
+         }
+         return get_cached_fn(item->second.index);
       }
       else
       {
@@ -176,10 +292,25 @@ instance_private_data::instance_private_data(instance_dispatch_table table, PFN_
    , enabled_layer_platforms{ enabled_layer_platforms }
    , allocator{ alloc }
    , surfaces{ alloc }
+   , device_extensions_cache{ alloc }
+   , render_node_cache{ alloc }
    , enabled_extensions{ allocator }
 {
 }
 
+instance_private_data::~instance_private_data()
+{
+   for (auto &entry : device_extensions_cache)
+   {
+      allocator.destroy<util::extension_list>(1, entry.second);
+   }
+
+   for (auto &entry : render_node_cache)
+   {
+      close(entry.second);
+   }
+}
+
 /**
  * @brief Obtain the loader's dispatch table for the given dispatchable object.
  * @note Dispatchable objects are structures that have a VkLayerDispatchTable as their first member.
@@ -197,6 +328,10 @@ VkResult instance_private_data::associate(VkInstance instance, instance_dispatch
                                           util::wsi_platform_set enabled_layer_platforms, const uint32_t api_version,
                                           const util::allocator &allocator)
 {
+   /* Force the one-time configuration parse at a well-defined point, before
+    * any swapchain hot path can ask for a knob. */
+   util::config::get();
+
    auto instance_data = allocator.make_unique<instance_private_data>(std::move(table), set_loader_data,
                                                                      enabled_layer_platforms, api_version, allocator);
 
@@ -210,24 +345,23 @@ VkResult instance_private_data::associate(VkInstance instance, instance_dispatch
    const auto key = get_key(instance);
    scoped_mutex lock(g_data_lock);
 
-   auto it = g_instance_data.find(key);
-   if (it != g_instance_data.end())
+   auto *existing = g_instance_data.get(key);
+   if (existing != nullptr)
    {
       WSI_LOG_WARNING("Hash collision when adding new instance (%p)", reinterpret_cast<void *>(instance));
 
-      destroy(it->second);
-      g_instance_data.erase(it);
+      destroy(existing);
+      g_instance_data.erase(key);
    }
 
-   auto result = g_instance_data.try_insert(std::make_pair(key, instance_data.get()));
-   if (result.has_value())
+   if (g_instance_data.insert(key, instance_data.get()))
    {
       instance_data.release(); // NOLINT(bugprone-unused-return-value)
       return VK_SUCCESS;
    }
    else
    {
-      WSI_LOG_WARNING("Failed to insert instance_private_data for instance (%p) as host is out of memory",
+      WSI_LOG_WARNING("Failed to insert instance_private_data for instance (%p) as the handle table is full",
                       reinterpret_cast<void *>(instance));
 
       return VK_ERROR_OUT_OF_HOST_MEMORY;
@@ -240,15 +374,13 @@ void instance_private_data::disassociate(VkInstance instance)
    instance_private_data *instance_data = nullptr;
    {
       scoped_mutex lock(g_data_lock);
-      auto it = g_instance_data.find(get_key(instance));
-      if (it == g_instance_data.end())
-      {
-         WSI_LOG_WARNING("Failed to find private data for instance (%p)", reinterpret_cast<void *>(instance));
-         return;
-      }
+      instance_data = g_instance_data.erase(get_key(instance));
+   }
 
-      instance_data = it->second;
-      g_instance_data.erase(it);
+   if (instance_data == nullptr)
+   {
+      WSI_LOG_WARNING("Failed to find private data for instance (%p)", reinterpret_cast<void *>(instance));
+      return;
    }
 
    destroy(instance_data);
@@ -257,8 +389,9 @@ void instance_private_data::disassociate(VkInstance instance)
 template <typename dispatchable_type>
 static instance_private_data &get_instance_private_data(dispatchable_type dispatchable_object)
 {
-   scoped_mutex lock(g_data_lock);
-   return *g_instance_data.at(get_key(dispatchable_object));
+   auto *instance_data = g_instance_data.get(get_key(dispatchable_object));
+   assert(instance_data != nullptr);
+   return *instance_data;
 }
 
 instance_private_data &instance_private_data::get(VkInstance instance)
@@ -327,6 +460,85 @@ bool instance_private_data::does_layer_support_surface(VkSurfaceKHR surface)
    return it != surfaces.end();
 }
 
+const util::extension_list *instance_private_data::get_cached_device_extensions(VkPhysicalDevice phys_dev)
+{
+   scoped_mutex lock(device_extensions_cache_lock);
+   auto it = device_extensions_cache.find(phys_dev);
+   if (it != device_extensions_cache.end())
+   {
+      return it->second;
+   }
+
+   return nullptr;
+}
+
+VkResult instance_private_data::cache_device_extensions(VkPhysicalDevice phys_dev,
+                                                        const util::extension_list &extensions)
+{
+   scoped_mutex lock(device_extensions_cache_lock);
+   auto it = device_extensions_cache.find(phys_dev);
+   if (it != device_extensions_cache.end())
+   {
+      /* Another thread already populated the entry; keep the existing copy. */
+      return VK_SUCCESS;
+   }
+
+   auto cached_extensions = allocator.make_unique<util::extension_list>(allocator);
+   if (cached_extensions == nullptr)
+   {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+   TRY(cached_extensions->add(extensions));
+
+   auto result = device_extensions_cache.try_insert(std::make_pair(phys_dev, cached_extensions.get()));
+   if (!result.has_value())
+   {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+   assert(result->second);
+   cached_extensions.release();
+
+   return VK_SUCCESS;
+}
+
+int instance_private_data::get_cached_render_node_fd(xcb_connection_t *connection)
+{
+   scoped_mutex lock(render_node_cache_lock);
+   auto it = render_node_cache.find(connection);
+   if (it != render_node_cache.end())
+   {
+      return fcntl(it->second, F_DUPFD_CLOEXEC, 0);
+   }
+
+   return -1;
+}
+
+VkResult instance_private_data::cache_render_node_fd(xcb_connection_t *connection, int fd)
+{
+   scoped_mutex lock(render_node_cache_lock);
+   auto it = render_node_cache.find(connection);
+   if (it != render_node_cache.end())
+   {
+      /* Another thread already populated the entry; keep the existing node. */
+      return VK_SUCCESS;
+   }
+
+   int cached_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+   if (cached_fd < 0)
+   {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   auto result = render_node_cache.try_insert(std::make_pair(connection, cached_fd));
+   if (!result.has_value())
+   {
+      close(cached_fd);
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   return VK_SUCCESS;
+}
+
 void instance_private_data::destroy(instance_private_data *instance_data)
 {
    assert(instance_data);
@@ -411,11 +623,16 @@ device_private_data::device_private_data(instance_private_data &inst_data, VkPhy
    , SetDeviceLoaderData{ set_loader_data }
    , physical_device{ phys_dev }
    , device{ dev }
-   , allocator{ alloc }
-   , swapchains{ allocator } /* clang-format off */
+   , allocator{ alloc } /* clang-format off */
+   , fd_memory_type_bits_cache{ allocator }
+   , aliased_images{ allocator }
+   , swapchain_reaper_queue{ allocator }
+   , fence_pool{ allocator }
+   , exportable_fence_pool{ allocator }
    , enabled_extensions{ allocator }
    , compression_control_enabled{ false }
    , present_id_enabled { false }
+   , present_wait_enabled{ false }
    , swapchain_maintenance1_enabled{ false }
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
    , present_timing_enabled { true }
@@ -424,6 +641,50 @@ device_private_data::device_private_data(instance_private_data &inst_data, VkPhy
 {
 }
 
+/**
+ * @brief Destroy a swapchain with the allocator it was created from.
+ *
+ * The allocation callbacks passed to vkDestroySwapchainKHR are only valid for the duration of
+ * that call, so deferred destruction uses the callbacks the swapchain itself was allocated with.
+ */
+static void reap_swapchain(wsi::swapchain_base *swapchain)
+{
+   util::allocator alloc{ swapchain->get_allocator() };
+   alloc.destroy(1, swapchain);
+}
+
+device_private_data::~device_private_data()
+{
+   {
+      scoped_mutex lock(swapchain_reaper_lock);
+      swapchain_reaper_run = false;
+      swapchain_reaper_cond.notify_one();
+   }
+
+   if (swapchain_reaper.joinable())
+   {
+      swapchain_reaper.join();
+   }
+
+   /* The reaper may have stopped with swapchains still queued. We are called before the device
+    * is destroyed, so they can still be torn down here. */
+   for (auto *swapchain : swapchain_reaper_queue)
+   {
+      reap_swapchain(swapchain);
+   }
+
+   /* Swapchain teardown releases fences into the pool, so this must run after
+    * the queued swapchains have been reaped. */
+   for (auto fence : fence_pool)
+   {
+      disp.DestroyFence(device, fence, get_allocator().get_original_callbacks());
+   }
+   for (auto fence : exportable_fence_pool)
+   {
+      disp.DestroyFence(device, fence, get_allocator().get_original_callbacks());
+   }
+}
+
 VkResult device_private_data::associate(VkDevice dev, instance_private_data &inst_data, VkPhysicalDevice phys_dev,
                                         device_dispatch_table table, PFN_vkSetDeviceLoaderData set_loader_data,
                                         const util::allocator &allocator)
@@ -441,23 +702,22 @@ VkResult device_private_data::associate(VkDevice dev, instance_private_data &ins
    const auto key = get_key(dev);
    scoped_mutex lock(g_data_lock);
 
-   auto it = g_device_data.find(key);
-   if (it != g_device_data.end())
+   auto *existing = g_device_data.get(key);
+   if (existing != nullptr)
    {
       WSI_LOG_WARNING("Hash collision when adding new device (%p)", reinterpret_cast<void *>(dev));
-      destroy(it->second);
-      g_device_data.erase(it);
+      destroy(existing);
+      g_device_data.erase(key);
    }
 
-   auto result = g_device_data.try_insert(std::make_pair(key, device_data.get()));
-   if (result.has_value())
+   if (g_device_data.insert(key, device_data.get()))
    {
       device_data.release(); // NOLINT(bugprone-unused-return-value)
       return VK_SUCCESS;
    }
    else
    {
-      WSI_LOG_WARNING("Failed to insert device_private_data for device (%p) as host is out of memory",
+      WSI_LOG_WARNING("Failed to insert device_private_data for device (%p) as the handle table is full",
                       reinterpret_cast<void *>(dev));
 
       return VK_ERROR_OUT_OF_HOST_MEMORY;
@@ -470,15 +730,13 @@ void device_private_data::disassociate(VkDevice dev)
    device_private_data *device_data = nullptr;
    {
       scoped_mutex lock(g_data_lock);
-      auto it = g_device_data.find(get_key(dev));
-      if (it == g_device_data.end())
-      {
-         WSI_LOG_WARNING("Failed to find private data for device (%p)", reinterpret_cast<void *>(dev));
-         return;
-      }
+      device_data = g_device_data.erase(get_key(dev));
+   }
 
-      device_data = it->second;
-      g_device_data.erase(it);
+   if (device_data == nullptr)
+   {
+      WSI_LOG_WARNING("Failed to find private data for device (%p)", reinterpret_cast<void *>(dev));
+      return;
    }
 
    destroy(device_data);
@@ -487,9 +745,9 @@ void device_private_data::disassociate(VkDevice dev)
 template <typename dispatchable_type>
 static device_private_data &get_device_private_data(dispatchable_type dispatchable_object)
 {
-   scoped_mutex lock(g_data_lock);
-
-   return *g_device_data.at(get_key(dispatchable_object));
+   auto *device_data = g_device_data.get(get_key(dispatchable_object));
+   assert(device_data != nullptr);
+   return *device_data;
 }
 
 device_private_data &device_private_data::get(VkDevice device)
@@ -505,26 +763,199 @@ device_private_data &device_private_data::get(VkQueue queue)
 VkResult device_private_data::add_layer_swapchain(VkSwapchainKHR swapchain)
 {
    scoped_mutex lock(swapchains_lock);
-   auto result = swapchains.try_insert(swapchain);
-   return result.has_value() ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+   return swapchains.insert(swapchain) ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
 }
 
 void device_private_data::remove_layer_swapchain(VkSwapchainKHR swapchain)
 {
    scoped_mutex lock(swapchains_lock);
-   auto it = swapchains.find(swapchain);
-   if (it != swapchains.end())
+   swapchains.erase(swapchain);
+}
+
+bool device_private_data::is_deferred_swapchain_destruction_enabled()
+{
+   return util::config::get().deferred_swapchain_destroy();
+}
+
+void device_private_data::swapchain_reaper_main()
+{
+   std::unique_lock<std::mutex> lock(swapchain_reaper_lock);
+   while (swapchain_reaper_run)
+   {
+      if (swapchain_reaper_queue.empty())
+      {
+         swapchain_reaper_cond.wait(lock);
+         continue;
+      }
+
+      auto *swapchain = swapchain_reaper_queue.front();
+      swapchain_reaper_queue.erase(swapchain_reaper_queue.begin());
+
+      /* Tearing down a swapchain can block on its pending presents, so drop the lock while
+       * doing it to keep the hand-over path non-blocking. */
+      lock.unlock();
+      reap_swapchain(swapchain);
+      lock.lock();
+   }
+}
+
+VkResult device_private_data::defer_swapchain_destruction(wsi::swapchain_base *swapchain)
+{
+   scoped_mutex lock(swapchain_reaper_lock);
+
+   if (!swapchain_reaper.joinable())
+   {
+      swapchain_reaper_run = true;
+      try
+      {
+         swapchain_reaper = std::thread(&device_private_data::swapchain_reaper_main, this);
+      }
+      catch (const std::system_error &)
+      {
+         swapchain_reaper_run = false;
+         return VK_ERROR_INITIALIZATION_FAILED;
+      }
+      catch (const std::bad_alloc &)
+      {
+         swapchain_reaper_run = false;
+         return VK_ERROR_INITIALIZATION_FAILED;
+      }
+   }
+
+   if (!swapchain_reaper_queue.try_push_back(swapchain))
+   {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   swapchain_reaper_cond.notify_one();
+   return VK_SUCCESS;
+}
+
+wsi::presentation_thread_pool *device_private_data::get_presentation_thread_pool()
+{
+   scoped_mutex lock(presentation_pool_lock);
+
+   if (!presentation_pool_initialized)
+   {
+      /* Whatever the outcome, do not retry on every swapchain creation. */
+      presentation_pool_initialized = true;
+
+      const uint32_t num_threads = util::config::get().present_threads();
+      if (num_threads == 0)
+      {
+         return nullptr;
+      }
+
+      auto pool = allocator.make_unique<wsi::presentation_thread_pool>(allocator);
+      if (pool == nullptr)
+      {
+         WSI_LOG_WARNING("Failed to allocate the presentation thread pool.");
+         return nullptr;
+      }
+
+      if (pool->start(num_threads) != VK_SUCCESS)
+      {
+         WSI_LOG_WARNING("Failed to start the presentation thread pool, swapchains will use dedicated threads.");
+         return nullptr;
+      }
+
+      presentation_pool = std::move(pool);
+   }
+
+   return presentation_pool.get();
+}
+
+/* Upper bound on the number of fences kept per kind in the sync-object pool. */
+constexpr size_t MAX_POOLED_FENCES = 32;
+
+VkFence device_private_data::acquire_pooled_fence(bool exportable)
+{
+   scoped_mutex lock(fence_pool_lock);
+   auto &pool = exportable ? exportable_fence_pool : fence_pool;
+   if (pool.empty())
    {
-      swapchains.erase(swapchain);
+      return VK_NULL_HANDLE;
    }
+   VkFence fence = pool.back();
+   pool.pop_back();
+   return fence;
+}
+
+void device_private_data::select_present_queue(const VkDeviceCreateInfo *create_info)
+{
+   const auto queue_exists = [create_info](uint32_t family, uint32_t index) {
+      for (uint32_t i = 0; i < create_info->queueCreateInfoCount; i++)
+      {
+         const auto &info = create_info->pQueueCreateInfos[i];
+         /* Protected queues cannot be retrieved with vkGetDeviceQueue. */
+         if ((info.flags & VK_DEVICE_QUEUE_CREATE_PROTECTED_BIT) == 0 && info.queueFamilyIndex == family &&
+             index < info.queueCount)
+         {
+            return true;
+         }
+      }
+      return false;
+   };
+
+   if (const char *env = util::config::get().present_queue())
+   {
+      char *separator = nullptr;
+      unsigned long family = strtoul(env, &separator, 0);
+      if (separator != env && *separator == ':')
+      {
+         const char *index_string = separator + 1;
+         unsigned long index = strtoul(index_string, &separator, 0);
+         if (separator != index_string && *separator == '\0' && queue_exists(family, index))
+         {
+            present_queue_family = family;
+            present_queue_index = index;
+            return;
+         }
+      }
+      WSI_LOG_WARNING("Ignoring VULKAN_WSI_PRESENT_QUEUE value '%s': expected 'family:index' of a created queue.",
+                      env);
+   }
+
+   /* Prefer a queue the application is least likely to render on: a non-zero
+    * family first, then an extra queue in family 0. When neither exists this
+    * keeps the historical (0, 0) choice. */
+   for (uint32_t i = 0; i < create_info->queueCreateInfoCount; i++)
+   {
+      const auto &info = create_info->pQueueCreateInfos[i];
+      if ((info.flags & VK_DEVICE_QUEUE_CREATE_PROTECTED_BIT) != 0 || info.queueCount == 0)
+      {
+         continue;
+      }
+      if (info.queueFamilyIndex != 0)
+      {
+         present_queue_family = info.queueFamilyIndex;
+         present_queue_index = info.queueCount - 1;
+      }
+      else if (present_queue_family == 0 && info.queueCount > 1)
+      {
+         present_queue_index = info.queueCount - 1;
+      }
+   }
+}
+
+bool device_private_data::release_pooled_fence(VkFence fence, bool exportable)
+{
+   scoped_mutex lock(fence_pool_lock);
+   auto &pool = exportable ? exportable_fence_pool : fence_pool;
+   if (pool.size() >= MAX_POOLED_FENCES)
+   {
+      return false;
+   }
+   return pool.try_push_back(fence);
 }
 
 bool device_private_data::layer_owns_all_swapchains(const VkSwapchainKHR *swapchain, uint32_t swapchain_count) const
 {
-   scoped_mutex lock(swapchains_lock);
+   /* Wait-free: the ownership test runs on every present and must not contend
+    * with swapchain creation and destruction on other threads. */
    for (uint32_t i = 0; i < swapchain_count; i++)
    {
-      if (swapchains.find(swapchain[i]) == swapchains.end())
+      if (!swapchains.contains(swapchain[i]))
       {
          return false;
       }
@@ -591,6 +1022,16 @@ bool device_private_data::is_present_id_enabled()
    return present_id_enabled;
 }
 
+void device_private_data::set_present_wait_feature_enabled(bool enable)
+{
+   present_wait_enabled = enable;
+}
+
+bool device_private_data::is_present_wait_enabled()
+{
+   return present_wait_enabled;
+}
+
 void device_private_data::set_swapchain_maintenance1_enabled(bool enable)
 {
    swapchain_maintenance1_enabled = enable;
@@ -601,4 +1042,101 @@ bool device_private_data::is_swapchain_maintenance1_enabled() const
    return swapchain_maintenance1_enabled;
 }
 
+VkResult device_private_data::get_fd_memory_type_bits(VkExternalMemoryHandleTypeFlagBits handle_type, int fd,
+                                                      uint32_t *mem_type_bits)
+{
+   /* Inode numbers are recycled once a buffer is destroyed, so keep the cache
+    * from growing without bound over the process lifetime. */
+   constexpr size_t FD_MEMORY_TYPE_CACHE_MAX_ENTRIES = 64;
+
+   struct stat fd_stat = {};
+   const bool can_cache = fstat(fd, &fd_stat) == 0;
+   const fd_memory_props_key key = { static_cast<uint64_t>(fd_stat.st_ino), static_cast<uint64_t>(fd_stat.st_size) };
+
+   if (can_cache)
+   {
+      const std::lock_guard<std::mutex> lock(fd_memory_type_bits_lock);
+      auto entry = fd_memory_type_bits_cache.find(key);
+      if (entry != fd_memory_type_bits_cache.end())
+      {
+         *mem_type_bits = entry->second;
+         return VK_SUCCESS;
+      }
+   }
+
+   VkMemoryFdPropertiesKHR mem_props = {};
+   mem_props.sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR;
+   TRY_LOG(disp.GetMemoryFdPropertiesKHR(device, handle_type, fd, &mem_props),
+           "Error querying file descriptor properties");
+
+   if (can_cache)
+   {
+      const std::lock_guard<std::mutex> lock(fd_memory_type_bits_lock);
+      if (fd_memory_type_bits_cache.size() >= FD_MEMORY_TYPE_CACHE_MAX_ENTRIES)
+      {
+         fd_memory_type_bits_cache.clear();
+      }
+      /* Insertion failure only loses the memoization, not correctness. */
+      fd_memory_type_bits_cache.try_insert(std::make_pair(key, mem_props.memoryTypeBits));
+   }
+
+   *mem_type_bits = mem_props.memoryTypeBits;
+   return VK_SUCCESS;
+}
+
+void device_private_data::track_aliased_image(VkImage image, VkSwapchainKHR swapchain)
+{
+   /* An application leaking unbound aliased handles must not grow the map
+    * without bound; dropped entries take the regular destruction path. */
+   constexpr size_t ALIASED_IMAGE_TRACK_MAX_ENTRIES = 256;
+
+   const std::lock_guard<std::mutex> lock(aliased_images_lock);
+   if (aliased_images.size() >= ALIASED_IMAGE_TRACK_MAX_ENTRIES)
+   {
+      aliased_images.clear();
+   }
+   /* Insertion failure only loses the recycling, not correctness. */
+   aliased_images.try_insert(std::make_pair(image, swapchain));
+}
+
+void device_private_data::untrack_aliased_image(VkImage image)
+{
+   const std::lock_guard<std::mutex> lock(aliased_images_lock);
+   auto entry = aliased_images.find(image);
+   if (entry != aliased_images.end())
+   {
+      aliased_images.erase(entry);
+   }
+}
+
+bool device_private_data::try_recycle_aliased_image(VkImage image)
+{
+   const std::lock_guard<std::mutex> lock(aliased_images_lock);
+   auto entry = aliased_images.find(image);
+   if (entry == aliased_images.end())
+   {
+      return false;
+   }
+
+   /* The entry's presence means the swapchain is still alive: teardown drops
+    * its entries under this lock before the swapchain is freed. */
+   auto *sc = reinterpret_cast<wsi::swapchain_base *>(entry->second);
+   aliased_images.erase(entry);
+   return sc->recycle_aliased_image_handle(image);
+}
+
+void device_private_data::untrack_swapchain_aliased_images(VkSwapchainKHR swapchain)
+{
+   const std::lock_guard<std::mutex> lock(aliased_images_lock);
+   for (auto entry = aliased_images.begin(); entry != aliased_images.end();)
+   {
+      auto current = entry;
+      ++entry;
+      if (current->second == swapchain)
+      {
+         aliased_images.erase(current);
+      }
+   }
+}
+
 } /* namespace layer */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2025 Arm Limited.
+ * Copyright (c) 2018-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -28,7 +28,8 @@
 
 #include <util/platform_set.hpp>
 #include <util/custom_allocator.hpp>
-#include <util/unordered_set.hpp>
+#include <util/flat_hash_map.hpp>
+#include <util/handle_set.hpp>
 #include <util/unordered_map.hpp>
 #include <util/extension_list.hpp>
 
@@ -43,16 +44,23 @@
 
 #include <memory>
 #include <unordered_set>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstddef>
 #include <mutex>
 #include <limits>
 #include <cstring>
+#include <thread>
 using scoped_mutex = std::lock_guard<std::mutex>;
 
 /** Forward declare stored objects */
 namespace wsi
 {
 class surface;
+class swapchain_base;
+class presentation_thread_pool;
 }
 
 namespace layer
@@ -69,6 +77,8 @@ struct entrypoint
    uint32_t api_version;
    bool user_visible;
    bool required;
+   /** Position of the entrypoint in the table's entrypoint list, used to index the function table. */
+   std::size_t index;
 };
 
 /**
@@ -81,6 +91,9 @@ class dispatch_table
 public:
    using entrypoint_list = util::unordered_map<std::string, entrypoint>;
 
+   /** Maximum number of entrypoints the fixed-index function table can hold. */
+   static constexpr std::size_t MAX_ENTRYPOINTS = 128;
+
    /**
     * @brief Construct a new dispatch table object
     *
@@ -93,6 +106,24 @@ public:
       assert(m_entrypoints != nullptr);
    }
 
+   virtual ~dispatch_table() = default;
+
+   /* Dispatch tables are only moved while the instance or device that owns them is being
+    * created, before the table can be reached from other threads, so relaxed copies of
+    * the cached function pointers are sufficient here.
+    */
+   dispatch_table(dispatch_table &&rhs) noexcept
+      : m_entrypoints(std::move(rhs.m_entrypoints))
+      , m_resolved(rhs.m_resolved)
+      , m_entrypoint_defs(rhs.m_entrypoint_defs)
+      , m_entrypoint_count(rhs.m_entrypoint_count)
+   {
+      for (std::size_t i = 0; i < MAX_ENTRYPOINTS; i++)
+      {
+         m_fn_table[i].store(rhs.m_fn_table[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+   }
+
    /**
     * @brief Get the function object from the entrypoints.
     *
@@ -106,12 +137,37 @@ public:
       auto fn = m_entrypoints->find(fn_name);
       if (fn != m_entrypoints->end())
       {
-         return reinterpret_cast<FunctionType>(fn->second.fn);
+         /* Entrypoints resolved eagerly at populate() time keep their pointer in the map.
+          * Lazily resolved ones leave nullptr there and are fetched through the function
+          * table, which caches the resolution. */
+         if (fn->second.fn != nullptr)
+         {
+            return reinterpret_cast<FunctionType>(fn->second.fn);
+         }
+         return reinterpret_cast<FunctionType>(get_cached_fn(fn->second.index));
       }
 
       return std::nullopt;
    }
 
+   /**
+    * @brief Get a function from the fixed-index function table.
+    *
+    * The index is generated at compile time from the position of the entrypoint in the
+    * dispatch table's entrypoint list, so no string hashing or map lookup is involved.
+    * Entrypoints that populate() left unresolved are resolved on first use.
+    *
+    * @tparam FunctionType The signature of the requested function.
+    * @param index Position of the entrypoint in the table's entrypoint list.
+    * @return the requested function pointer, which is nullptr if the entrypoint is unavailable.
+    */
+   template <typename FunctionType>
+   FunctionType get_fn(std::size_t index) const
+   {
+      assert(index < MAX_ENTRYPOINTS);
+      return reinterpret_cast<FunctionType>(get_cached_fn(index));
+   }
+
    /**
     * @brief Set the user enabled extensions.
     *
@@ -196,8 +252,146 @@ protected:
       return VK_ERROR_EXTENSION_NOT_PRESENT;
    }
 
+   /**
+    * @brief Call function from the fixed-index function table.
+    *
+    * Indexed counterpart of the name based overload above, used by the dispatch table
+    * shortcuts to avoid hashing the entrypoint name on every call.
+    *
+    * @tparam FunctionType The signature of the function to call.
+    * @tparam Args Argument types of the function to call.
+    *
+    * @param index Position of the entrypoint in the table's entrypoint list.
+    * @param fn_name Name of the function to call, only used for logging.
+    * @param args Arguments to the function to call.
+    * @return function return value or std::nullopt if function is not present in the table
+    */
+   template <
+      typename FunctionType, class... Args, typename ReturnType = std::invoke_result_t<FunctionType, Args...>,
+      std::enable_if_t<!std::is_void<ReturnType>::value && !std::is_same<ReturnType, VkResult>::value, bool> = true>
+   std::optional<ReturnType> call_fn(std::size_t index, const char *fn_name, Args &&...args) const
+   {
+      auto fn = get_fn<FunctionType>(index);
+      if (fn != nullptr)
+      {
+         return fn(std::forward<Args>(args)...);
+      }
+
+      WSI_LOG_WARNING("Call to %s failed, dispatch table does not contain the function.", fn_name);
+
+      return std::nullopt;
+   }
+
+   /**
+    * @brief Call function from the fixed-index function table.
+    * @note This overload matches for functions with void return type.
+    *
+    * @tparam FunctionType The signature of the function to call.
+    * @tparam Args Argument types of the function to call.
+    *
+    * @param index Position of the entrypoint in the table's entrypoint list.
+    * @param fn_name Name of the function to call, only used for logging.
+    * @param args Arguments to the function to call.
+    */
+   template <typename FunctionType, class... Args, typename ReturnType = std::invoke_result_t<FunctionType, Args...>,
+             std::enable_if_t<std::is_void<ReturnType>::value, bool> = true>
+   void call_fn(std::size_t index, const char *fn_name, Args &&...args) const
+   {
+      auto fn = get_fn<FunctionType>(index);
+      if (fn != nullptr)
+      {
+         return fn(std::forward<Args>(args)...);
+      }
+
+      WSI_LOG_WARNING("Call to %s failed, dispatch table does not contain the function.", fn_name);
+   }
+
+   /**
+    * @brief Call function from the fixed-index function table.
+    * @note This overload matches for functions with VkResult return type.
+    *
+    * @tparam FunctionType The signature of the function to call.
+    * @tparam Args Argument types of the function to call.
+    *
+    * @param index Position of the entrypoint in the table's entrypoint list.
+    * @param fn_name Name of the function to call, only used for logging.
+    * @param args Arguments to the function to call.
+    * @return function return value or VK_ERROR_EXTENSION_NOT_PRESENT if function is not present in the table
+    */
+   template <typename FunctionType, class... Args, typename ReturnType = std::invoke_result_t<FunctionType, Args...>,
+             std::enable_if_t<std::is_same<ReturnType, VkResult>::value, bool> = true>
+   VkResult call_fn(std::size_t index, const char *fn_name, Args &&...args) const
+   {
+      auto fn = get_fn<FunctionType>(index);
+      if (fn != nullptr)
+      {
+         return fn(std::forward<Args>(args)...);
+      }
+
+      WSI_LOG_WARNING("Call to %s failed, dispatch table does not contain the function.", fn_name);
+
+      return VK_ERROR_EXTENSION_NOT_PRESENT;
+   }
+
+   /**
+    * @brief Get the cached function pointer at @p index, resolving it on first use.
+    *
+    * The fast path is a single acquire-load of the cached pointer; only entrypoints
+    * that populate() left unresolved take the locked resolution path, and only once.
+    *
+    * @param index Position of the entrypoint in the table's entrypoint list.
+    * @return the function pointer, which is nullptr if the entrypoint is unavailable.
+    */
+   PFN_vkVoidFunction get_cached_fn(std::size_t index) const
+   {
+      PFN_vkVoidFunction fn = m_fn_table[index].load(std::memory_order_acquire);
+      if (fn == nullptr)
+      {
+         fn = resolve_entrypoint_at(index);
+      }
+      return fn;
+   }
+
+   /**
+    * @brief Resolve an entrypoint by name through the next layer's get-proc-addr.
+    *
+    * The base table has no resolver; derived tables override this with the
+    * vkGetInstanceProcAddr / vkGetDeviceProcAddr captured by populate().
+    *
+    * @param fn_name Name of the entrypoint to resolve.
+    * @return the resolved function pointer, or nullptr if the entrypoint is unavailable.
+    */
+   virtual PFN_vkVoidFunction resolve_entrypoint(const char *fn_name) const
+   {
+      UNUSED(fn_name);
+      return nullptr;
+   }
+
+   /**
+    * @brief Slow path of get_cached_fn: resolve the entrypoint at @p index and cache it.
+    *
+    * @param index Position of the entrypoint in the table's entrypoint list.
+    * @return the resolved function pointer, or nullptr if the entrypoint is unavailable.
+    */
+   PFN_vkVoidFunction resolve_entrypoint_at(std::size_t index) const;
+
    /** @brief Vector that holds the entrypoints of the dispatch table */
    util::unique_ptr<entrypoint_list> m_entrypoints;
+
+   /** @brief Function pointers indexed by position in the table's entrypoint list, resolved lazily. */
+   mutable std::array<std::atomic<PFN_vkVoidFunction>, MAX_ENTRYPOINTS> m_fn_table{};
+
+   /** @brief Tracks which entrypoints have been resolved, so unavailable ones are only probed once. */
+   mutable std::array<bool, MAX_ENTRYPOINTS> m_resolved{};
+
+   /** @brief Static definitions of the table's entrypoints, set by populate() for lazy resolution. */
+   const entrypoint *m_entrypoint_defs{ nullptr };
+
+   /** @brief Number of entries in m_entrypoint_defs. */
+   std::size_t m_entrypoint_count{ 0 };
+
+   /** @brief Serializes lazy entrypoint resolution; also guards m_resolved. */
+   mutable std::mutex m_resolve_lock;
 };
 
 /* Represents the maximum possible Vulkan API version. */
@@ -241,6 +435,9 @@ static constexpr uint32_t API_VERSION_MAX = UINT32_MAX;
    EP(GetPhysicalDeviceSurfaceCapabilities2KHR, VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME, API_VERSION_MAX,   \
       false)                                                                                                         \
    EP(GetPhysicalDeviceSurfaceFormats2KHR, VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME, API_VERSION_MAX, false) \
+   /* VK_EXT_display_surface_counter */                                                                              \
+   EP(GetPhysicalDeviceSurfaceCapabilities2EXT, VK_EXT_DISPLAY_SURFACE_COUNTER_EXTENSION_NAME, API_VERSION_MAX,      \
+      false)                                                                                                         \
    /* VK_KHR_get_physical_device_properties2 or */                                                                   \
    /* 1.1 (without KHR suffix) */                                                                                    \
    EP(GetPhysicalDeviceImageFormatProperties2KHR, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME,            \
@@ -267,6 +464,18 @@ static constexpr uint32_t API_VERSION_MAX = UINT32_MAX;
    EP(GetPhysicalDeviceExternalBufferPropertiesKHR, VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME,              \
       VK_API_VERSION_1_1, false)
 
+/* Compile-time indices of the instance entrypoints, in INSTANCE_ENTRYPOINTS_LIST order.
+ * The dispatch table shortcuts use these to index the fixed function table directly
+ * instead of hashing the entrypoint name on every call.
+ */
+enum class instance_entrypoint : std::size_t
+{
+#define DISPATCH_TABLE_INDEX(name, unused1, unused2, unused3) name,
+   INSTANCE_ENTRYPOINTS_LIST(DISPATCH_TABLE_INDEX)
+#undef DISPATCH_TABLE_INDEX
+      count
+};
+
 /**
  * @brief Struct representing the instance dispatch table.
  */
@@ -286,8 +495,9 @@ public:
 
    /**
     * @brief Populate the instance dispatch table with functions that it requires.
-    * @note  The function greedy fetches all the functions it needs so even in the
-    *        case of failure functions that are not marked as nullptr are safe to call.
+    * @note  Required entrypoints and the hot surface-query set are fetched eagerly, so
+    *        populate() fails when a required entrypoint is unavailable. The remaining
+    *        entrypoints are resolved on first use to keep instance creation cheap.
     *
     * @param instance The instance for which the dispatch table will be populated.
     * @param get_proc The pointer to vkGetInstanceProcAddr function.
@@ -311,16 +521,20 @@ public:
     *    disp.GetInstanceProcAddr(instance, fn_name);
     * The result type will be matching the function signature, so there is no need for casting.
     */
-#define DISPATCH_TABLE_SHORTCUT(name, unused1, unused2, unused3)             \
-   template <class... Args>                                                  \
-   auto name(Args &&...args) const                                           \
-   {                                                                         \
-      return call_fn<PFN_vk##name>("vk" #name, std::forward<Args>(args)...); \
+#define DISPATCH_TABLE_SHORTCUT(name, unused1, unused2, unused3)                                          \
+   template <class... Args>                                                                               \
+   auto name(Args &&...args) const                                                                        \
+   {                                                                                                      \
+      return call_fn<PFN_vk##name>(static_cast<std::size_t>(instance_entrypoint::name), "vk" #name,       \
+                                   std::forward<Args>(args)...);                                          \
    };
 
    INSTANCE_ENTRYPOINTS_LIST(DISPATCH_TABLE_SHORTCUT)
 #undef DISPATCH_TABLE_SHORTCUT
 
+   static_assert(static_cast<std::size_t>(instance_entrypoint::count) <= MAX_ENTRYPOINTS,
+                 "instance entrypoint list does not fit the fixed-index function table");
+
 private:
    /**
     * @brief Construct instance dispatch table object
@@ -331,6 +545,14 @@ private:
       : dispatch_table{ std::move(table) }
    {
    }
+
+   PFN_vkVoidFunction resolve_entrypoint(const char *fn_name) const override;
+
+   /** @brief Instance handle captured by populate() for lazy entrypoint resolution. */
+   VkInstance m_instance{ VK_NULL_HANDLE };
+
+   /** @brief The next layer's vkGetInstanceProcAddr, captured by populate(). */
+   PFN_vkGetInstanceProcAddr m_get_proc{ nullptr };
 };
 
 /* List of device entrypoints in the layer's device dispatch table.
@@ -398,6 +620,10 @@ private:
    EP(QueuePresentKHR, VK_KHR_SWAPCHAIN_EXTENSION_NAME, API_VERSION_MAX, false)                                    \
    /* VK_KHR_shared_presentable_image */                                                                           \
    EP(GetSwapchainStatusKHR, VK_KHR_SHARED_PRESENTABLE_IMAGE_EXTENSION_NAME, API_VERSION_MAX, false)               \
+   /* VK_KHR_present_wait */                                                                                       \
+   EP(WaitForPresentKHR, VK_KHR_PRESENT_WAIT_EXTENSION_NAME, API_VERSION_MAX, false)                               \
+   /* VK_EXT_display_control */                                                                                    \
+   EP(GetSwapchainCounterEXT, VK_EXT_DISPLAY_CONTROL_EXTENSION_NAME, API_VERSION_MAX, false)                       \
    /* VK_KHR_device_group + VK_KHR_swapchain or */ /* 1.1 with VK_KHR_swapchain */                                 \
    EP(AcquireNextImage2KHR, VK_KHR_DEVICE_GROUP_EXTENSION_NAME, VK_API_VERSION_1_1, false)                         \
    /* VK_KHR_device_group + VK_KHR_surface or */ /* 1.1 with VK_KHR_swapchain */                                   \
@@ -428,9 +654,24 @@ private:
    EP(GetImageSparseMemoryRequirements2KHR, VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME, VK_API_VERSION_1_1,   \
       false)                                                                                                       \
    EP(ReleaseSwapchainImagesEXT, VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME, VK_API_VERSION_1_1, false)         \
+   /* VK_KHR_timeline_semaphore */                                                                                 \
+   EP(WaitSemaphoresKHR, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, VK_API_VERSION_1_2, false)                      \
+   EP(GetSemaphoreCounterValueKHR, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, VK_API_VERSION_1_2, false)            \
    /* Custom entrypoints */                                                                                        \
    DEVICE_ENTRYPOINTS_LIST_EXPANSION(EP)
 
+/* Compile-time indices of the device entrypoints, in DEVICE_ENTRYPOINTS_LIST order.
+ * The dispatch table shortcuts use these to index the fixed function table directly
+ * instead of hashing the entrypoint name on every call.
+ */
+enum class device_entrypoint : std::size_t
+{
+#define DISPATCH_TABLE_INDEX(name, unused1, unused2, unused3) name,
+   DEVICE_ENTRYPOINTS_LIST(DISPATCH_TABLE_INDEX)
+#undef DISPATCH_TABLE_INDEX
+      count
+};
+
 /**
  * @brief Struct representing the device dispatch table.
  */
@@ -450,8 +691,9 @@ public:
 
    /**
     * @brief Populate the device dispatch table with functions that it requires.
-    * @note  The function greedy fetches all the functions it needs so even in the
-    *        case of failure functions that are not marked as nullptr are safe to call.
+    * @note  Required entrypoints and the hot acquire/present set are fetched eagerly, so
+    *        populate() fails when a required entrypoint is unavailable. The remaining
+    *        entrypoints are resolved on first use to keep device creation cheap.
     *
     * @param device The device for which the dispatch table will be populated.
     * @param get_proc The pointer to vkGetDeviceProcAddr function.
@@ -475,16 +717,20 @@ public:
     *    disp.GetDeviceProcAddr(instance, fn_name);
     * The result type will be matching the function signature, so there is no need for casting.
     */
-#define DISPATCH_TABLE_SHORTCUT(name, unused1, unused2, unused3)             \
-   template <class... Args>                                                  \
-   auto name(Args &&...args) const                                           \
-   {                                                                         \
-      return call_fn<PFN_vk##name>("vk" #name, std::forward<Args>(args)...); \
+#define DISPATCH_TABLE_SHORTCUT(name, unused1, unused2, unused3)                                          \
+   template <class... Args>                                                                               \
+   auto name(Args &&...args) const                                                                        \
+   {                                                                                                      \
+      return call_fn<PFN_vk##name>(static_cast<std::size_t>(device_entrypoint::name), "vk" #name,         \
+                                   std::forward<Args>(args)...);                                          \
    };
 
    DEVICE_ENTRYPOINTS_LIST(DISPATCH_TABLE_SHORTCUT)
 #undef DISPATCH_TABLE_SHORTCUT
 
+   static_assert(static_cast<std::size_t>(device_entrypoint::count) <= MAX_ENTRYPOINTS,
+                 "device entrypoint list does not fit the fixed-index function table");
+
 private:
    /**
     * @brief Construct instance dispatch table object
@@ -495,6 +741,14 @@ private:
       : dispatch_table{ std::move(table) }
    {
    }
+
+   PFN_vkVoidFunction resolve_entrypoint(const char *fn_name) const override;
+
+   /** @brief Device handle captured by populate() for lazy entrypoint resolution. */
+   VkDevice m_device{ VK_NULL_HANDLE };
+
+   /** @brief The next layer's vkGetDeviceProcAddr, captured by populate(). */
+   PFN_vkGetDeviceProcAddr m_get_proc{ nullptr };
 };
 
 /**
@@ -621,6 +875,60 @@ public:
 
    bool has_frame_boundary_support(VkPhysicalDevice phys_dev);
 
+   /**
+    * @brief Get the cached list of device extensions supported by a physical device.
+    *
+    * The extension set of a physical device cannot change over the lifetime of the
+    * instance, so the result of the first enumeration is kept and served to any
+    * subsequent vkCreateDevice call on the same physical device.
+    *
+    * @param phys_dev The physical device the extensions were enumerated from.
+    *
+    * @return Pointer to the cached list, or nullptr if nothing has been cached yet. The
+    *         pointer stays valid until the instance is destroyed.
+    */
+   const util::extension_list *get_cached_device_extensions(VkPhysicalDevice phys_dev);
+
+   /**
+    * @brief Cache the list of device extensions supported by a physical device.
+    *
+    * Stores a copy of @p extensions made with the instance allocator. If an entry
+    * already exists for @p phys_dev the existing copy is kept unchanged.
+    *
+    * @param phys_dev   The physical device the extensions were enumerated from.
+    * @param extensions The enumerated extension list.
+    *
+    * @return VK_SUCCESS or VK_ERROR_OUT_OF_HOST_MEMORY.
+    */
+   VkResult cache_device_extensions(VkPhysicalDevice phys_dev, const util::extension_list &extensions);
+
+   /**
+    * @brief Get a handle to the DRM render node cached for an X11 connection.
+    *
+    * Returns a duplicate of the cached descriptor, so the caller owns an
+    * independent handle to the same node and may close it at any time.
+    *
+    * @param connection The X11 connection the render node was probed for.
+    *
+    * @return A file descriptor owned by the caller, or -1 if no node has been
+    *         cached for @p connection yet.
+    */
+   int get_cached_render_node_fd(xcb_connection_t *connection);
+
+   /**
+    * @brief Cache the DRM render node opened for an X11 connection.
+    *
+    * Stores a duplicate of @p fd made with F_DUPFD_CLOEXEC; the caller keeps
+    * ownership of its own descriptor. If an entry already exists for
+    * @p connection the existing one is kept.
+    *
+    * @param connection The X11 connection the render node was probed for.
+    * @param fd         The open render node file descriptor.
+    *
+    * @return VK_SUCCESS or VK_ERROR_OUT_OF_HOST_MEMORY.
+    */
+   VkResult cache_render_node_fd(xcb_connection_t *connection, int fd);
+
    /**
     * @brief Get the instance allocator
     *
@@ -686,6 +994,11 @@ private:
                          util::wsi_platform_set enabled_layer_platforms, const uint32_t api_version,
                          const util::allocator &alloc);
 
+   /**
+    * @brief Destructor releasing the cached device extension lists.
+    */
+   ~instance_private_data();
+
    /**
     * @brief Destroy the instance_private_data properly with its allocator
     *
@@ -707,14 +1020,47 @@ private:
     *
     * Uses plain pointers to store surface data as the lifetime of the object is explicitly controlled by the Vulkan
     * application. The application may also use different but compatible host allocators on creation and destruction.
+    *
+    * Looked up on every surface capability query and swapchain creation, so it uses the
+    * open-addressed map: the typical one or two surfaces live in its inline slots.
     */
-   util::unordered_map<VkSurfaceKHR, wsi::surface *> surfaces;
+   util::flat_hash_map<VkSurfaceKHR, wsi::surface *> surfaces;
 
    /**
     * @brief Lock for thread safe access to @ref surfaces
     */
    std::mutex surfaces_lock;
 
+   /**
+    * @brief Cache of the device extensions supported by each physical device.
+    *
+    * Filled lazily on the first vkCreateDevice call for a physical device so later
+    * device creations skip re-enumerating the extensions. Entries are allocated with
+    * the instance allocator and destroyed with the instance.
+    */
+   util::flat_hash_map<VkPhysicalDevice, util::extension_list *> device_extensions_cache;
+
+   /**
+    * @brief Lock for thread safe access to @ref device_extensions_cache
+    */
+   std::mutex device_extensions_cache_lock;
+
+   /**
+    * @brief Cache of the DRM render node fd probed for each X11 connection.
+    *
+    * The X server hands out the same render node for the lifetime of a
+    * connection, so the first DRI3 probe stores its fd here and later
+    * swapchain creations on the connection - including every resize
+    * recreation - bind to the node without touching the filesystem. The
+    * cached descriptors are closed with the instance.
+    */
+   util::flat_hash_map<xcb_connection_t *, int> render_node_cache;
+
+   /**
+    * @brief Lock for thread safe access to @ref render_node_cache
+    */
+   std::mutex render_node_cache_lock;
+
    /**
     * @brief List with the names of the enabled instance extensions.
     */
@@ -876,6 +1222,20 @@ public:
     */
    bool is_present_id_enabled();
 
+   /**
+    * @brief Set whether the device supports the present wait feature.
+    *
+    * @param enable Value to set m_present_wait_enabled member variable.
+    */
+   void set_present_wait_feature_enabled(bool enable);
+
+   /**
+    * @brief Check whether the device can support the present wait feature.
+    *
+    * @return true if supported, false otherwise.
+    */
+   bool is_present_wait_enabled();
+
    /**
     * @brief Selectively enable/disable the swapchain maintenance1 features for this device.
     *
@@ -890,6 +1250,174 @@ public:
     */
    bool is_swapchain_maintenance1_enabled() const;
 
+   /**
+    * @brief Get the supported memory type bits for importing an external memory fd.
+    *
+    * Memoizes vkGetMemoryFdPropertiesKHR results per underlying buffer, keyed by
+    * the fd's inode and size, so that importing the planes of every swapchain
+    * image does not re-query the same dma-buf.
+    *
+    * @param      handle_type   External memory handle type of the fd.
+    * @param      fd            The external memory fd.
+    * @param[out] mem_type_bits Memory types the fd can be imported as.
+    *
+    * @return VK_SUCCESS on success, an appropriate error code otherwise.
+    */
+   VkResult get_fd_memory_type_bits(VkExternalMemoryHandleTypeFlagBits handle_type, int fd, uint32_t *mem_type_bits);
+
+   /**
+    * @brief Track an application-owned aliased swapchain image handle.
+    *
+    * Aliased handles - images created with a VkImageSwapchainCreateInfoKHR in
+    * the pNext chain - are tracked from creation until they are bound or
+    * destroyed, so that vkDestroyImage can route never-bound handles back to
+    * the owning swapchain's handle cache instead of the driver. Tracking is
+    * best-effort: an untracked handle simply takes the regular destruction
+    * path.
+    *
+    * @param image     The aliased image handle.
+    * @param swapchain The layer swapchain the handle was created from.
+    */
+   void track_aliased_image(VkImage image, VkSwapchainKHR swapchain);
+
+   /**
+    * @brief Stop tracking an aliased image handle.
+    *
+    * Called when the handle is bound to swapchain memory: a bound image can
+    * never be bound again, so it is no longer recyclable.
+    *
+    * @param image The aliased image handle.
+    */
+   void untrack_aliased_image(VkImage image);
+
+   /**
+    * @brief Hand a never-bound aliased image handle back to its swapchain.
+    *
+    * @param image The image handle passed to vkDestroyImage.
+    *
+    * @return true when the handle was recycled by the owning swapchain and
+    *         must not be destroyed, false when the caller should pass the
+    *         destruction down to the driver.
+    */
+   bool try_recycle_aliased_image(VkImage image);
+
+   /**
+    * @brief Drop all aliased image handles tracked for a swapchain.
+    *
+    * Called on swapchain teardown. Aliased handles the application still
+    * holds remain valid and are subsequently destroyed by the driver as
+    * usual.
+    *
+    * @param swapchain The swapchain being torn down.
+    */
+   void untrack_swapchain_aliased_images(VkSwapchainKHR swapchain);
+
+   /**
+    * @brief Check whether deferred swapchain destruction has been requested.
+    *
+    * Controlled by the VULKAN_WSI_DEFERRED_SWAPCHAIN_DESTROY environment variable. When set,
+    * vkDestroySwapchainKHR hands the swapchain to a per-device reaper thread instead of waiting
+    * for pending presents and destroying the images inline.
+    *
+    * @return true if deferred destruction is enabled, false otherwise.
+    */
+   static bool is_deferred_swapchain_destruction_enabled();
+
+   /**
+    * @brief Hand a swapchain to the reaper thread for deferred destruction.
+    *
+    * The swapchain must already have been removed from the layer's swapchain registry, so no
+    * further API calls can reach it. The reaper performs the teardown - waiting for pending
+    * presents and destroying the images - off the application thread, in the order the
+    * swapchains were handed over so a deprecated ancestor is always torn down before its
+    * descendant. Any swapchains still queued when the device is destroyed are reaped before
+    * the destruction of the device proceeds.
+    *
+    * @param swapchain The swapchain to destroy. Ownership is transferred on success.
+    *
+    * @return VK_SUCCESS if the swapchain was queued, an error code otherwise, in which case
+    *         the caller retains ownership and should destroy the swapchain synchronously.
+    */
+   VkResult defer_swapchain_destruction(wsi::swapchain_base *swapchain);
+
+   /**
+    * @brief Get the device's shared presentation thread pool.
+    *
+    * The pool is created lazily on the first call. Its size is controlled by
+    * the VULKAN_WSI_PRESENT_THREADS environment variable (default 2); setting
+    * it to 0 disables the pool, in which case every swapchain keeps its
+    * dedicated page flip thread.
+    *
+    * @return The pool, or nullptr when disabled or when its creation failed.
+    */
+   wsi::presentation_thread_pool *get_presentation_thread_pool();
+
+   /**
+    * @brief Take a recycled fence from the device's sync-object pool.
+    *
+    * Fences are recycled across swapchain generations so that recreating a
+    * swapchain - e.g. during a resize storm - does not pay a fence creation
+    * ioctl per image. The returned fence may be in the signaled state; callers
+    * reset it before attaching a payload.
+    *
+    * @param exportable Whether a fence created exportable to a native sync FD
+    *                   is required. Exportability is a creation-time property,
+    *                   so the two kinds are pooled separately.
+    *
+    * @return A pooled fence, or VK_NULL_HANDLE when the pool is empty and the
+    *         caller must create one.
+    */
+   VkFence acquire_pooled_fence(bool exportable);
+
+   /**
+    * @brief Return a fence to the sync-object pool for reuse.
+    *
+    * Any payload of the fence must have completed. The pool takes ownership on
+    * success and destroys pooled fences when the device private data goes away.
+    *
+    * @param fence      The fence to recycle.
+    * @param exportable Whether the fence was created exportable to a native
+    *                   sync FD.
+    *
+    * @return true when the fence was pooled, false when the pool is full and
+    *         the caller must destroy the fence itself.
+    */
+   bool release_pooled_fence(VkFence fence, bool exportable);
+
+   /**
+    * @brief Pick the queue the layer submits present payloads on.
+    *
+    * Called once at device creation. Applications typically render on queue
+    * (0, 0), which is also what the layer historically used for its payload
+    * submissions, so those submissions contended with render work. When the
+    * application created more than one queue, prefer one it is least likely to
+    * render on: the last queue of the last non-zero family, then the highest
+    * index in family 0. Only queues present in @p create_info can be selected.
+    * The VULKAN_WSI_PRESENT_QUEUE environment variable ("family:index")
+    * overrides the choice when it names a created queue.
+    *
+    * @param create_info The device creation info listing the created queues.
+    */
+   void select_present_queue(const VkDeviceCreateInfo *create_info);
+
+   /**
+    * @brief Queue family of the layer's present payload queue.
+    */
+   uint32_t get_present_queue_family() const
+   {
+      return present_queue_family;
+   }
+
+   /**
+    * @brief Queue index of the layer's present payload queue.
+    */
+   uint32_t get_present_queue_index() const
+   {
+      return present_queue_index;
+   }
+
+   ~device_private_data();
+
 private:
    /* Allow util::allocator to access the private constructor */
    friend util::allocator;
@@ -917,9 +1445,108 @@ private:
    static void destroy(device_private_data *device_data);
 
    const util::allocator allocator;
-   util::unordered_set<VkSwapchainKHR> swapchains;
+
+   /** Maximum number of swapchains a device can own at once. A device rarely has
+    * more than a handful live; the headroom covers deferred destruction keeping
+    * retired ancestors alive across resize churn. */
+   static constexpr size_t MAX_LAYER_SWAPCHAINS = 64;
+
+   /**
+    * The swapchains owned by the layer for this device. Ownership tests on the
+    * present path are wait-free reads; #swapchains_lock only serializes the
+    * writers in add_layer_swapchain() and remove_layer_swapchain().
+    */
+   util::concurrent_handle_set<VkSwapchainKHR, MAX_LAYER_SWAPCHAINS> swapchains;
    mutable std::mutex swapchains_lock;
 
+   /**
+    * @brief Key identifying the buffer behind an external memory fd.
+    *
+    * Dup'd fds referring to the same dma-buf share the inode of its anonymous
+    * file, so (inode, size) identifies the buffer rather than the descriptor.
+    */
+   struct fd_memory_props_key
+   {
+      uint64_t inode;
+      uint64_t size;
+
+      bool operator==(const fd_memory_props_key &other) const
+      {
+         return inode == other.inode && size == other.size;
+      }
+   };
+
+   struct fd_memory_props_key_hash
+   {
+      size_t operator()(const fd_memory_props_key &key) const
+      {
+         return std::hash<uint64_t>{}(key.inode) ^ (std::hash<uint64_t>{}(key.size) << 1);
+      }
+   };
+
+   /**
+    * @brief Memoized vkGetMemoryFdPropertiesKHR results for imported dma-bufs.
+    */
+   util::flat_hash_map<fd_memory_props_key, uint32_t, fd_memory_props_key_hash> fd_memory_type_bits_cache;
+   mutable std::mutex fd_memory_type_bits_lock;
+
+   /**
+    * @brief Application-owned aliased image handles that have never been
+    *        bound, keyed to the swapchain that created them.
+    *
+    * The bind path removes entries, so what remains is exactly the set of
+    * handles vkDestroyImage may hand back to their swapchain for reuse.
+    */
+   util::flat_hash_map<VkImage, VkSwapchainKHR> aliased_images;
+   mutable std::mutex aliased_images_lock;
+
+   /**
+    * @brief Main loop of the swapchain reaper thread.
+    *
+    * Destroys queued swapchains in FIFO order until the device_private_data is destroyed.
+    */
+   void swapchain_reaper_main();
+
+   /**
+    * @brief Swapchains waiting to be destroyed by the reaper thread, in hand-over order.
+    */
+   util::vector<wsi::swapchain_base *> swapchain_reaper_queue;
+   std::mutex swapchain_reaper_lock;
+   std::condition_variable swapchain_reaper_cond;
+
+   /**
+    * @brief Reaper thread for deferred swapchain destruction. Started lazily on the first
+    *        hand-over and joined when the device_private_data is destroyed.
+    */
+   std::thread swapchain_reaper;
+   bool swapchain_reaper_run{ false };
+
+   /**
+    * @brief Shared presentation thread pool multiplexing the device's swapchains.
+    *        Created lazily by the first eligible swapchain; destroyed after the
+    *        reaper thread is joined, as reaped swapchains unregister from it.
+    */
+   util::unique_ptr<wsi::presentation_thread_pool> presentation_pool;
+   std::mutex presentation_pool_lock;
+
+   /** Whether creating the pool has been attempted, successfully or not. */
+   bool presentation_pool_initialized{ false };
+
+   /**
+    * @brief Fences recycled across swapchain generations, split by whether
+    *        they were created exportable to a native sync FD.
+    */
+   util::vector<VkFence> fence_pool;
+   util::vector<VkFence> exportable_fence_pool;
+   std::mutex fence_pool_lock;
+
+   /**
+    * @brief The queue used for present payload submissions, chosen by
+    *        select_present_queue() from the queues the application created.
+    */
+   uint32_t present_queue_family{ 0 };
+   uint32_t present_queue_index{ 0 };
+
    /**
     * @brief List with the names of the enabled device extensions.
     */
@@ -942,6 +1569,12 @@ private:
     */
    bool present_id_enabled;
 
+   /**
+    * @brief Stores whether the device supports the present wait feature.
+    *
+    */
+   bool present_wait_enabled;
+
    /**
     * @brief Stores whether the device has enabled support for the swapchain maintenance1 features.
     */
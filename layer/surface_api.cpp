@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, 2019, 2021-2022, 2024 Arm Limited.
+ * Copyright (c) 2016-2017, 2019, 2021-2022, 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -84,6 +84,46 @@ wsi_layer_vkGetPhysicalDeviceSurfaceCapabilities2KHR(VkPhysicalDevice physicalDe
    return instance.disp.GetPhysicalDeviceSurfaceCapabilities2KHR(physicalDevice, pSurfaceInfo, pSurfaceCapabilities);
 }
 
+/**
+ * @brief Implements vkGetPhysicalDeviceSurfaceCapabilities2EXT Vulkan entrypoint.
+ */
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkGetPhysicalDeviceSurfaceCapabilities2EXT(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
+                                                     VkSurfaceCapabilities2EXT *pSurfaceCapabilities) VWL_API_POST
+{
+   auto &instance = layer::instance_private_data::get(physicalDevice);
+   if (instance.should_layer_handle_surface(physicalDevice, surface))
+   {
+      wsi::surface_properties *props = wsi::get_surface_properties(instance, surface);
+      assert(props != nullptr);
+
+      /* VkSurfaceCapabilities2EXT mirrors VkSurfaceCapabilitiesKHR field for field
+       * and appends the supported surface counters. */
+      VkSurfaceCapabilitiesKHR capabilities = {};
+      VkResult res = props->get_surface_capabilities(physicalDevice, &capabilities);
+      if (res != VK_SUCCESS)
+      {
+         return res;
+      }
+
+      pSurfaceCapabilities->minImageCount = capabilities.minImageCount;
+      pSurfaceCapabilities->maxImageCount = capabilities.maxImageCount;
+      pSurfaceCapabilities->currentExtent = capabilities.currentExtent;
+      pSurfaceCapabilities->minImageExtent = capabilities.minImageExtent;
+      pSurfaceCapabilities->maxImageExtent = capabilities.maxImageExtent;
+      pSurfaceCapabilities->maxImageArrayLayers = capabilities.maxImageArrayLayers;
+      pSurfaceCapabilities->supportedTransforms = capabilities.supportedTransforms;
+      pSurfaceCapabilities->currentTransform = capabilities.currentTransform;
+      pSurfaceCapabilities->supportedCompositeAlpha = capabilities.supportedCompositeAlpha;
+      pSurfaceCapabilities->supportedUsageFlags = capabilities.supportedUsageFlags;
+      pSurfaceCapabilities->supportedSurfaceCounters = props->get_supported_surface_counters();
+
+      return VK_SUCCESS;
+   }
+
+   return instance.disp.GetPhysicalDeviceSurfaceCapabilities2EXT(physicalDevice, surface, pSurfaceCapabilities);
+}
+
 /**
  * @brief Implements vkGetPhysicalDeviceSurfaceFormatsKHR Vulkan entrypoint.
  */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, 2019, 2021-2025 Arm Limited.
+ * Copyright (c) 2017, 2019, 2021-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -28,6 +28,7 @@
  * @brief Contains the Vulkan entrypoints for the swapchain.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <new>
@@ -35,6 +36,8 @@
 #include "private_data.hpp"
 #include "swapchain_api.hpp"
 
+#include <util/allocation_tracker.hpp>
+#include <util/arena_allocator.hpp>
 #include <util/helpers.hpp>
 
 #include <wsi/synchronization.hpp>
@@ -90,6 +93,16 @@ wsi_layer_vkDestroySwapchainKHR(VkDevice device, VkSwapchainKHR swapc,
    device_data.remove_layer_swapchain(swapc);
 
    auto *sc = reinterpret_cast<wsi::swapchain_base *>(swapc);
+
+   /* With deferred destruction enabled the reaper thread waits for the pending presents and
+    * destroys the images, so this entrypoint does not stall the application. Fall back to the
+    * synchronous path if the swapchain cannot be handed over. */
+   if (layer::device_private_data::is_deferred_swapchain_destruction_enabled() &&
+       device_data.defer_swapchain_destruction(sc) == VK_SUCCESS)
+   {
+      return;
+   }
+
    wsi::destroy_surface_swapchain(sc, device_data, pAllocator);
 }
 
@@ -129,19 +142,48 @@ wsi_layer_vkAcquireNextImageKHR(VkDevice device, VkSwapchainKHR swapc, uint64_t
 }
 
 static VkResult submit_wait_request(VkQueue queue, const VkPresentInfoKHR &present_info,
-                                    layer::device_private_data &device_data, bool &frame_boundary_event_handled)
+                                    const wsi::present_info_extensions &extensions,
+                                    layer::device_private_data &device_data, bool &handle_frame_boundary_in_present,
+                                    bool &payloads_batched)
 {
-   util::vector<VkSemaphore> swapchain_semaphores{ util::allocator(device_data.get_allocator(),
-                                                                   VK_SYSTEM_ALLOCATION_SCOPE_COMMAND) };
+   /* The semaphore list only lives for this call, serve it from a bump allocator
+    * rather than paying for a heap allocation on every present. */
+   util::arena arena{ device_data.get_allocator() };
+   util::vector<VkSemaphore> swapchain_semaphores{ arena.get_allocator() };
    if (!swapchain_semaphores.try_resize(present_info.swapchainCount))
    {
       return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
 
+   /* Fold every swapchain's present payload into this submission when possible:
+    * signalling each swapchain's timeline point here replaces the per-swapchain
+    * payload submission in queue_present, so presenting N swapchains costs one
+    * vkQueueSubmit instead of 1 + N. A present fence needs its own chained
+    * submission per swapchain, so its presence keeps the unbatched path. */
+   bool batch_payloads = extensions.present_fence_info == nullptr;
+   for (uint32_t i = 0; batch_payloads && i < present_info.swapchainCount; ++i)
+   {
+      auto swapchain = reinterpret_cast<wsi::swapchain_base *>(present_info.pSwapchains[i]);
+      batch_payloads = swapchain->can_batch_present_payload();
+   }
+
+   util::vector<uint64_t> signal_values{ arena.get_allocator() };
+   if (batch_payloads && !signal_values.try_resize(present_info.swapchainCount))
+   {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
    for (uint32_t i = 0; i < present_info.swapchainCount; ++i)
    {
       auto swapchain = reinterpret_cast<wsi::swapchain_base *>(present_info.pSwapchains[i]);
-      swapchain_semaphores[i] = swapchain->get_image_present_semaphore(present_info.pImageIndices[i]);
+      if (batch_payloads)
+      {
+         swapchain_semaphores[i] = swapchain->begin_batched_payload(present_info.pImageIndices[i], &signal_values[i]);
+      }
+      else
+      {
+         swapchain_semaphores[i] = swapchain->get_image_present_semaphore(present_info.pImageIndices[i]);
+      }
    }
 
    wsi::queue_submit_semaphores semaphores = { present_info.pWaitSemaphores, present_info.waitSemaphoreCount,
@@ -149,16 +191,72 @@ static VkResult submit_wait_request(VkQueue queue, const VkPresentInfoKHR &prese
                                                static_cast<uint32_t>(swapchain_semaphores.size()) };
 
    void *submission_pnext = nullptr;
-   auto frame_boundary = wsi::create_frame_boundary(present_info);
+   std::optional<VkFrameBoundaryEXT> frame_boundary;
+   if (extensions.frame_boundary != nullptr)
+   {
+      /* Extract the application's boundary to avoid passing other, unrelated
+       * chained structures to vkQueueSubmit. */
+      frame_boundary = util::shallow_copy_extension(extensions.frame_boundary);
+   }
+
+   /* Without an application-provided boundary, a layer-generated one (when
+    * enabled) also rides this submission: every presented image is listed in a
+    * single boundary, so boundary tracking does not cost a queue submission of
+    * its own. */
+   util::vector<VkImage> boundary_images{ arena.get_allocator() };
+   if (!frame_boundary.has_value())
+   {
+      auto *first_swapchain = reinterpret_cast<wsi::swapchain_base *>(present_info.pSwapchains[0]);
+      auto *frame_boundary_ext = first_swapchain->get_swapchain_extension<wsi::wsi_ext_frame_boundary>();
+      if (frame_boundary_ext != nullptr)
+      {
+         if (!boundary_images.try_resize(present_info.swapchainCount))
+         {
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+         }
+         for (uint32_t i = 0; i < present_info.swapchainCount; ++i)
+         {
+            auto swapchain = reinterpret_cast<wsi::swapchain_base *>(present_info.pSwapchains[i]);
+            boundary_images[i] = swapchain->get_image_handle(present_info.pImageIndices[i]);
+         }
+         frame_boundary = frame_boundary_ext->create_layer_frame_boundary(
+            boundary_images.data(), static_cast<uint32_t>(boundary_images.size()));
+      }
+   }
+
    if (frame_boundary.has_value())
    {
       submission_pnext = &frame_boundary.value();
    }
 
-   /* Notify that we don't want to pass any further frame boundary events */
-   frame_boundary_event_handled = submission_pnext != nullptr;
+   /* Any frame boundary for this present - the application's or the layer's -
+    * was attached here, so queue_present must not emit another one. */
+   handle_frame_boundary_in_present = false;
+
+   VkTimelineSemaphoreSubmitInfoKHR timeline_info = {};
+   if (batch_payloads)
+   {
+      timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+      timeline_info.pNext = submission_pnext;
+      timeline_info.signalSemaphoreValueCount = static_cast<uint32_t>(signal_values.size());
+      timeline_info.pSignalSemaphoreValues = signal_values.data();
+      submission_pnext = &timeline_info;
+   }
 
-   TRY(wsi::sync_queue_submit(device_data, queue, VK_NULL_HANDLE, semaphores, submission_pnext));
+   VkResult res = wsi::sync_queue_submit(device_data, queue, VK_NULL_HANDLE, semaphores, submission_pnext);
+   if (res != VK_SUCCESS && batch_payloads)
+   {
+      /* Nothing was queued: roll the reserved timeline points back so later
+       * payload waits do not hang on points that will never signal. */
+      for (uint32_t i = 0; i < present_info.swapchainCount; ++i)
+      {
+         auto swapchain = reinterpret_cast<wsi::swapchain_base *>(present_info.pSwapchains[i]);
+         swapchain->abandon_batched_payload(present_info.pImageIndices[i]);
+      }
+   }
+   TRY(res);
+
+   payloads_batched = batch_payloads;
    return VK_SUCCESS;
 }
 
@@ -168,6 +266,11 @@ wsi_layer_vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR *pPresentInfo)
    assert(queue != VK_NULL_HANDLE);
    assert(pPresentInfo != nullptr);
 
+   /* The whole present entrypoint is expected to stay off the heap in steady
+    * state - the multi-swapchain wait request below is served from a stack
+    * arena. Report any spill-over when allocation tracking is enabled. */
+   util::hot_path_scope allocation_scope;
+
    layer::device_private_data &device_data = layer::device_private_data::get(queue);
 
    if (!device_data.layer_owns_all_swapchains(pPresentInfo->pSwapchains, pPresentInfo->swapchainCount))
@@ -175,26 +278,29 @@ wsi_layer_vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR *pPresentInfo)
       return device_data.disp.QueuePresentKHR(queue, pPresentInfo);
    }
 
+   /* One walk of the pNext chain serves every extension consumer below. */
+   const auto extensions = wsi::index_present_info_extensions(pPresentInfo->pNext);
+
    /* Avoid allocating on the heap when there is only one swapchain. */
    const VkPresentInfoKHR *present_info = pPresentInfo;
    bool use_image_present_semaphore = false;
-   bool frame_boundary_event_handled = true;
+   bool handle_frame_boundary_in_present = true;
+   bool payloads_batched = false;
    if (pPresentInfo->swapchainCount > 1)
    {
-      TRY_LOG_CALL(submit_wait_request(queue, *pPresentInfo, device_data, frame_boundary_event_handled));
+      TRY_LOG_CALL(submit_wait_request(queue, *pPresentInfo, extensions, device_data, handle_frame_boundary_in_present,
+                                       payloads_batched));
       use_image_present_semaphore = true;
    }
 
    VkResult ret = VK_SUCCESS;
 
-   auto *present_ids = util::find_extension<VkPresentIdKHR>(VK_STRUCTURE_TYPE_PRESENT_ID_KHR, pPresentInfo->pNext);
-   const auto present_fence_info = util::find_extension<VkSwapchainPresentFenceInfoEXT>(
-      VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_FENCE_INFO_EXT, present_info->pNext);
-   const auto swapchain_present_mode_info = util::find_extension<VkSwapchainPresentModeInfoEXT>(
-      VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_MODE_INFO_EXT, present_info->pNext);
+   const auto *present_ids = extensions.present_ids;
+   const auto *present_regions = extensions.present_regions;
+   const auto *present_fence_info = extensions.present_fence_info;
+   const auto *swapchain_present_mode_info = extensions.present_mode_info;
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
-   const auto present_timings_info =
-      util::find_extension<VkPresentTimingsInfoEXT>(VK_STRUCTURE_TYPE_PRESENT_TIMINGS_INFO_EXT, present_info->pNext);
+   const auto *present_timings_info = extensions.present_timings_info;
    if (present_timings_info)
    {
       assert(present_timings_info->swapchainCount == pPresentInfo->swapchainCount);
@@ -223,14 +329,41 @@ wsi_layer_vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR *pPresentInfo)
       present_params.pending_present.image_index = pPresentInfo->pImageIndices[i];
       present_params.pending_present.present_id = present_id;
 
+      /* VK_KHR_incremental_present: copy the damage rectangles out of the pNext chain as the present request can
+       * outlive this call. Rectangle lists that do not fit are treated as full-surface damage. */
+      if (present_regions != nullptr && present_regions->pRegions != nullptr &&
+          present_regions->swapchainCount == pPresentInfo->swapchainCount)
+      {
+         const VkPresentRegionKHR &region = present_regions->pRegions[i];
+         if (region.pRectangles != nullptr && region.rectangleCount > 0 &&
+             region.rectangleCount <= wsi::pending_present_request::MAX_DAMAGE_RECTANGLES)
+         {
+            present_params.pending_present.damage_rect_count = region.rectangleCount;
+            std::copy_n(region.pRectangles, region.rectangleCount,
+                        present_params.pending_present.damage_rects.begin());
+         }
+      }
+
       present_params.use_image_present_semaphore = use_image_present_semaphore;
-      present_params.handle_present_frame_boundary_event = frame_boundary_event_handled;
+      present_params.handle_present_frame_boundary_event = handle_frame_boundary_in_present;
+      present_params.app_frame_boundary = extensions.frame_boundary;
+      present_params.payload_already_set = payloads_batched;
 
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
       if (present_timings_info)
       {
          present_params.m_present_timing_info = present_timings_info->pTimingInfos[i];
          present_params.m_present_timing_info.pNext = nullptr;
+
+         /* Absolute target present times are carried with the request so the page
+          * flip thread can hold the commit back until the target is due. Relative
+          * targets and present durations are not scheduled yet and present
+          * immediately. */
+         const VkPresentTimingInfoEXT &timing_info = present_params.m_present_timing_info;
+         if (!timing_info.presentAtRelativeTime && timing_info.time.targetPresentTime != 0)
+         {
+            present_params.pending_present.target_present_time = timing_info.time.targetPresentTime;
+         }
       }
 #endif
       VkResult res = sc->queue_present(queue, present_info, present_params);
@@ -370,6 +503,21 @@ wsi_layer_vkCreateImage(VkDevice device, const VkImageCreateInfo *pCreateInfo, c
    return sc->create_aliased_image_handle(pImage);
 }
 
+VWL_VKAPI_CALL(void)
+wsi_layer_vkDestroyImage(VkDevice device, VkImage image, const VkAllocationCallbacks *pAllocator) VWL_API_POST
+{
+   auto &device_data = layer::device_private_data::get(device);
+
+   /* A never-bound aliased handle goes back to its swapchain's cache so the
+    * next vkCreateImage against that swapchain skips the driver entirely. */
+   if (image != VK_NULL_HANDLE && device_data.try_recycle_aliased_image(image))
+   {
+      return;
+   }
+
+   device_data.disp.DestroyImage(device, image, pAllocator);
+}
+
 VWL_VKAPI_CALL(VkResult)
 wsi_layer_vkBindImageMemory2(VkDevice device, uint32_t bindInfoCount,
                              const VkBindImageMemoryInfo *pBindInfos) VWL_API_POST
@@ -399,6 +547,12 @@ wsi_layer_vkBindImageMemory2(VkDevice device, uint32_t bindInfoCount,
                  "Bind is not allowed on images that haven't been acquired first.");
          result = sc->bind_swapchain_image(device, &pBindInfos[i], bind_sc_info);
          error_message = "Failed to bind an image to the swapchain";
+         if (result == VK_SUCCESS)
+         {
+            /* A bound image can never be bound again, so the handle stops
+             * being recyclable. */
+            device_data.untrack_aliased_image(pBindInfos[i].image);
+         }
       }
 
       if (maintenance_6)
@@ -437,3 +591,108 @@ wsi_layer_vkGetSwapchainStatusKHR(VkDevice device, VkSwapchainKHR swapchain) VWL
 
    return sc->get_swapchain_status();
 }
+
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkWaitForPresentKHR(VkDevice device, VkSwapchainKHR swapchain, uint64_t presentId,
+                              uint64_t timeout) VWL_API_POST
+{
+   auto &device_data = layer::device_private_data::get(device);
+
+   if (!device_data.layer_owns_swapchain(swapchain))
+   {
+      return device_data.disp.WaitForPresentKHR(device, swapchain, presentId, timeout);
+   }
+
+   auto *sc = reinterpret_cast<wsi::swapchain_base *>(swapchain);
+
+   return sc->wait_for_present(presentId, timeout);
+}
+
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkGetSwapchainCounterEXT(VkDevice device, VkSwapchainKHR swapchain, VkSurfaceCounterFlagBitsEXT counter,
+                                   uint64_t *pCounterValue) VWL_API_POST
+{
+   auto &device_data = layer::device_private_data::get(device);
+
+   if (!device_data.layer_owns_swapchain(swapchain))
+   {
+      return device_data.disp.GetSwapchainCounterEXT(device, swapchain, counter, pCounterValue);
+   }
+
+   auto *sc = reinterpret_cast<wsi::swapchain_base *>(swapchain);
+
+   return sc->get_swapchain_counter(counter, pCounterValue);
+}
+
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkGetSwapchainImageMappingWSI(VkDevice device, VkSwapchainKHR swapchain, uint32_t imageIndex, void **ppData,
+                                        VkSubresourceLayout *pLayout) VWL_API_POST
+{
+   auto &device_data = layer::device_private_data::get(device);
+
+   /* This is a layer-specific query; there is nothing to call down to for
+    * swapchains the layer does not own. */
+   if (!device_data.layer_owns_swapchain(swapchain))
+   {
+      return VK_ERROR_FEATURE_NOT_PRESENT;
+   }
+
+   auto *sc = reinterpret_cast<wsi::swapchain_base *>(swapchain);
+
+   return sc->get_host_image_mapping(imageIndex, ppData, pLayout);
+}
+
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkRegisterSwapchainFrameCaptureWSI(VkDevice device, VkSwapchainKHR swapchain,
+                                             PFN_vkFrameCaptureCallbackWSI pfnCallback, void *pUserData,
+                                             uint32_t maxPendingFrames) VWL_API_POST
+{
+   auto &device_data = layer::device_private_data::get(device);
+
+   /* This is a layer-specific interface; there is nothing to call down to for
+    * swapchains the layer does not own. */
+   if (!device_data.layer_owns_swapchain(swapchain))
+   {
+      return VK_ERROR_FEATURE_NOT_PRESENT;
+   }
+
+   if (pfnCallback == nullptr)
+   {
+      return VK_ERROR_INITIALIZATION_FAILED;
+   }
+
+   auto *sc = reinterpret_cast<wsi::swapchain_base *>(swapchain);
+
+   return sc->register_frame_capture(pfnCallback, pUserData, maxPendingFrames);
+}
+
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkUnregisterSwapchainFrameCaptureWSI(VkDevice device, VkSwapchainKHR swapchain) VWL_API_POST
+{
+   auto &device_data = layer::device_private_data::get(device);
+
+   if (!device_data.layer_owns_swapchain(swapchain))
+   {
+      return VK_ERROR_FEATURE_NOT_PRESENT;
+   }
+
+   auto *sc = reinterpret_cast<wsi::swapchain_base *>(swapchain);
+
+   return sc->unregister_frame_capture();
+}
+
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkCompleteCapturedFrameWSI(VkDevice device, VkSwapchainKHR swapchain) VWL_API_POST
+{
+   auto &device_data = layer::device_private_data::get(device);
+
+   if (!device_data.layer_owns_swapchain(swapchain))
+   {
+      return VK_ERROR_FEATURE_NOT_PRESENT;
+   }
+
+   auto *sc = reinterpret_cast<wsi::swapchain_base *>(swapchain);
+
+   sc->complete_captured_frame();
+   return VK_SUCCESS;
+}
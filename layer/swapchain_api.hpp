@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2019, 2024 Arm Limited.
+ * Copyright (c) 2018-2019, 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -32,6 +32,7 @@
 
 #include <vulkan/vulkan.h>
 #include "util/macros.hpp"
+#include "wsi/frame_capture.hpp"
 
 VWL_VKAPI_CALL(VkResult)
 wsi_layer_vkCreateSwapchainKHR(VkDevice device, const VkSwapchainCreateInfoKHR *pSwapchainCreateInfo,
@@ -73,9 +74,55 @@ VWL_VKAPI_CALL(VkResult)
 wsi_layer_vkCreateImage(VkDevice device, const VkImageCreateInfo *pCreateInfo, const VkAllocationCallbacks *pAllocator,
                         VkImage *pImage) VWL_API_POST;
 
+VWL_VKAPI_CALL(void)
+wsi_layer_vkDestroyImage(VkDevice device, VkImage image, const VkAllocationCallbacks *pAllocator) VWL_API_POST;
+
 VWL_VKAPI_CALL(VkResult)
 wsi_layer_vkBindImageMemory2(VkDevice device, uint32_t bindInfoCount,
                              const VkBindImageMemoryInfo *pBindInfos) VWL_API_POST;
 
 VWL_VKAPI_CALL(VkResult)
 wsi_layer_vkGetSwapchainStatusKHR(VkDevice device, VkSwapchainKHR swapchain) VWL_API_POST;
+
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkWaitForPresentKHR(VkDevice device, VkSwapchainKHR swapchain, uint64_t presentId,
+                              uint64_t timeout) VWL_API_POST;
+
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkGetSwapchainCounterEXT(VkDevice device, VkSwapchainKHR swapchain, VkSurfaceCounterFlagBitsEXT counter,
+                                   uint64_t *pCounterValue) VWL_API_POST;
+
+/**
+ * @brief Layer-specific query for the persistent CPU mapping of a swapchain image.
+ *
+ * Only implemented by backends that allocate host-visible, persistently mapped
+ * images (currently the headless backend in host-visible mode). Applications
+ * obtain this entrypoint by name through vkGetDeviceProcAddr.
+ */
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkGetSwapchainImageMappingWSI(VkDevice device, VkSwapchainKHR swapchain, uint32_t imageIndex, void **ppData,
+                                        VkSubresourceLayout *pLayout) VWL_API_POST;
+
+/**
+ * @brief Layer-specific registration of a zero-copy frame capture consumer.
+ *
+ * The callback receives every frame the swapchain presents as duplicated
+ * dmabuf fds plus a sync_fd release fence - a zero-GPU-cost capture of exactly
+ * what was presented. Only served by the dmabuf-backed backends; frames the
+ * backend cannot export are silently skipped, as are frames presented while
+ * the consumer already holds maxPendingFrames of them. Applications obtain
+ * these entrypoints by name through vkGetDeviceProcAddr.
+ */
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkRegisterSwapchainFrameCaptureWSI(VkDevice device, VkSwapchainKHR swapchain,
+                                             PFN_vkFrameCaptureCallbackWSI pfnCallback, void *pUserData,
+                                             uint32_t maxPendingFrames) VWL_API_POST;
+
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkUnregisterSwapchainFrameCaptureWSI(VkDevice device, VkSwapchainKHR swapchain) VWL_API_POST;
+
+/**
+ * @brief Mark one captured frame as processed, unblocking frame delivery.
+ */
+VWL_VKAPI_CALL(VkResult)
+wsi_layer_vkCompleteCapturedFrameWSI(VkDevice device, VkSwapchainKHR swapchain) VWL_API_POST;
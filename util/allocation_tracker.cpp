@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Opt-in tracking of heap allocations on presentation hot paths.
+ */
+
+#include "allocation_tracker.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "config.hpp"
+#include "log.hpp"
+
+namespace util
+{
+
+namespace
+{
+
+enum class tracking_mode
+{
+   disabled,
+   /** Log and count hot-path heap allocations. */
+   count,
+   /** Log, count and abort on the first hot-path heap allocation. */
+   abort_on_allocation,
+};
+
+tracking_mode get_tracking_mode()
+{
+   /* The configuration is read once; changing the knob mid-run has no effect. */
+   static const tracking_mode mode = [] {
+      const char *value = config::get().alloc_track();
+      if (value == nullptr)
+      {
+         return tracking_mode::disabled;
+      }
+      if (std::strcmp(value, "abort") == 0)
+      {
+         return tracking_mode::abort_on_allocation;
+      }
+      return tracking_mode::count;
+   }();
+   return mode;
+}
+
+} /* namespace */
+
+thread_local uint32_t allocation_tracker::m_hot_path_depth = 0;
+std::atomic<uint64_t> allocation_tracker::m_hot_path_allocations{ 0 };
+
+void allocation_tracker::notify_allocation(size_t size)
+{
+   if (m_hot_path_depth == 0)
+   {
+      return;
+   }
+
+   const tracking_mode mode = get_tracking_mode();
+   if (mode == tracking_mode::disabled)
+   {
+      return;
+   }
+
+   m_hot_path_allocations.fetch_add(1, std::memory_order_relaxed);
+   WSI_LOG_WARNING("Heap allocation of %zu bytes on a presentation hot path.", size);
+
+   if (mode == tracking_mode::abort_on_allocation)
+   {
+      WSI_LOG_ERROR("Aborting: VULKAN_WSI_ALLOC_TRACK=abort and a hot path allocated.");
+      std::abort();
+   }
+}
+
+uint64_t allocation_tracker::hot_path_allocation_count()
+{
+   return m_hot_path_allocations.load(std::memory_order_relaxed);
+}
+
+} /* namespace util */
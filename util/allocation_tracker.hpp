@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Opt-in tracking of heap allocations on presentation hot paths.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "helpers.hpp"
+
+namespace util
+{
+
+/**
+ * @brief Tracks heap allocations made while a thread is inside a hot-path scope.
+ *
+ * The present and acquire paths are expected to be allocation-free in steady
+ * state; this tracker makes violations visible. It is enabled by setting
+ * VULKAN_WSI_ALLOC_TRACK to "count", which logs and counts every hot-path heap
+ * allocation, or to "abort", which additionally aborts on the first one so a CI
+ * run (e.g. any client on the headless backend) fails loudly. When disabled
+ * every hook is a thread-local read and an early return, so the instrumentation
+ * can stay compiled in.
+ *
+ * Only the layer's default callbacks are hooked: allocations routed to
+ * application-provided VkAllocationCallbacks are outside the layer's control
+ * and cannot be observed, and arena-served allocations never touch the heap in
+ * the first place.
+ */
+class allocation_tracker
+{
+public:
+   /**
+    * @brief Called by the default allocation callbacks for every heap allocation.
+    *
+    * Counts the allocation when the calling thread is inside a hot-path scope
+    * and tracking is enabled; aborts in abort mode.
+    *
+    * @param size The size of the allocation in bytes.
+    */
+   static void notify_allocation(size_t size);
+
+   /**
+    * @brief Number of heap allocations observed inside hot-path scopes so far.
+    */
+   static uint64_t hot_path_allocation_count();
+
+private:
+   friend class hot_path_scope;
+
+   /** Nesting depth of hot-path scopes on the current thread. */
+   static thread_local uint32_t m_hot_path_depth;
+
+   /** Process-wide count of heap allocations observed inside hot-path scopes. */
+   static std::atomic<uint64_t> m_hot_path_allocations;
+};
+
+/**
+ * @brief RAII marker for a presentation hot path.
+ *
+ * While an instance is alive, heap allocations on the current thread are
+ * reported to the allocation_tracker. Scopes may nest; the thread leaves the
+ * hot path when the outermost scope is destroyed.
+ */
+class hot_path_scope : private noncopyable
+{
+public:
+   hot_path_scope()
+   {
+      allocation_tracker::m_hot_path_depth++;
+   }
+
+   ~hot_path_scope()
+   {
+      allocation_tracker::m_hot_path_depth--;
+   }
+};
+
+} /* namespace util */
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "arena_allocator.hpp"
+#include "macros.hpp"
+
+#include <cstring>
+
+namespace util
+{
+
+namespace
+{
+
+/* Each allocation served from the arena is preceded by its size, so reallocations
+ * know how many bytes to preserve. */
+constexpr std::size_t HEADER_SIZE = sizeof(std::size_t);
+
+std::size_t align_up(std::size_t value, std::size_t alignment)
+{
+   assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+   return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} /* anonymous namespace */
+
+arena::arena(const allocator &parent)
+   : m_parent{ parent, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND }
+   , m_allocator{ VK_SYSTEM_ALLOCATION_SCOPE_COMMAND, nullptr }
+{
+   m_allocator.m_callbacks = {};
+   m_allocator.m_callbacks.pUserData = this;
+   m_allocator.m_callbacks.pfnAllocation = arena_allocation;
+   m_allocator.m_callbacks.pfnReallocation = arena_reallocation;
+   m_allocator.m_callbacks.pfnFree = arena_free;
+}
+
+void *arena::allocate(std::size_t size, std::size_t alignment)
+{
+   if (alignment < alignof(std::size_t))
+   {
+      alignment = alignof(std::size_t);
+   }
+
+   const std::size_t base = align_up(m_offset + HEADER_SIZE, alignment);
+   if (size > ARENA_SIZE || base > ARENA_SIZE - size)
+   {
+      /* Does not fit, serve it from the parent allocator instead. */
+      auto &cb = m_parent.m_callbacks;
+      return cb.pfnAllocation(cb.pUserData, size, alignment, m_parent.m_scope);
+   }
+
+   std::memcpy(m_storage + base - HEADER_SIZE, &size, HEADER_SIZE);
+   m_offset = base + size;
+   return m_storage + base;
+}
+
+void *arena::reallocate(void *original, std::size_t size, std::size_t alignment)
+{
+   if (original == nullptr)
+   {
+      return allocate(size, alignment);
+   }
+
+   if (!owns(original))
+   {
+      auto &cb = m_parent.m_callbacks;
+      return cb.pfnReallocation(cb.pUserData, original, size, alignment, m_parent.m_scope);
+   }
+
+   std::size_t old_size = 0;
+   std::memcpy(&old_size, static_cast<unsigned char *>(original) - HEADER_SIZE, HEADER_SIZE);
+   if (size <= old_size)
+   {
+      return original;
+   }
+
+   /* Grow in place when the block is the most recent arena allocation and the
+    * extra bytes fit, otherwise allocate a fresh block and copy. The stale block
+    * is reclaimed when the arena is reset. */
+   const std::size_t base = static_cast<unsigned char *>(original) - m_storage;
+   if (base + old_size == m_offset && size <= ARENA_SIZE && base <= ARENA_SIZE - size)
+   {
+      std::memcpy(m_storage + base - HEADER_SIZE, &size, HEADER_SIZE);
+      m_offset = base + size;
+      return original;
+   }
+
+   void *replacement = allocate(size, alignment);
+   if (replacement != nullptr)
+   {
+      std::memcpy(replacement, original, old_size);
+   }
+   return replacement;
+}
+
+VKAPI_ATTR void *VKAPI_CALL arena::arena_allocation(void *user_data, size_t size, size_t alignment,
+                                                    VkSystemAllocationScope scope)
+{
+   UNUSED(scope);
+   return static_cast<arena *>(user_data)->allocate(size, alignment);
+}
+
+VKAPI_ATTR void *VKAPI_CALL arena::arena_reallocation(void *user_data, void *original, size_t size, size_t alignment,
+                                                      VkSystemAllocationScope scope)
+{
+   UNUSED(scope);
+   return static_cast<arena *>(user_data)->reallocate(original, size, alignment);
+}
+
+VKAPI_ATTR void VKAPI_CALL arena::arena_free(void *user_data, void *memory)
+{
+   auto *self = static_cast<arena *>(user_data);
+   if (memory == nullptr || self->owns(memory))
+   {
+      return;
+   }
+
+   auto &cb = self->m_parent.m_callbacks;
+   cb.pfnFree(cb.pUserData, memory);
+}
+
+} /* namespace util */
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file arena_allocator.hpp
+ *
+ * @brief Contains a bump allocator for per-call transient allocations.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "custom_allocator.hpp"
+
+namespace util
+{
+
+/**
+ * @brief Resettable bump allocator for transient allocations within a single call.
+ *
+ * Wraps a fixed buffer behind VkAllocationCallbacks so that util::allocator based
+ * containers (util::vector, util::extension_list, ...) built for the lifetime of one
+ * entrypoint invocation can be served without touching the heap. Allocations bump a
+ * pointer into the internal storage and frees are no-ops; everything is reclaimed at
+ * once when the arena goes out of scope or @ref reset is called. Allocations that do
+ * not fit fall back to the parent allocator and are freed individually as usual, so
+ * the arena is always safe to use regardless of allocation sizes.
+ *
+ * The arena uses @c VK_SYSTEM_ALLOCATION_SCOPE_COMMAND as all its allocations must
+ * end with the current command. It is not thread-safe and is intended to live on the
+ * stack of the entrypoint using it. Containers allocated from the arena must not
+ * outlive it.
+ */
+class arena
+{
+public:
+   /** Size of the internal storage served before falling back to the parent allocator. */
+   static constexpr std::size_t ARENA_SIZE = 8 * 1024;
+
+   /**
+    * @brief Construct an arena falling back to the given parent allocator.
+    *
+    * @param parent Allocator used for allocations that do not fit the internal storage.
+    */
+   arena(const allocator &parent);
+
+   arena(const arena &) = delete;
+   arena &operator=(const arena &) = delete;
+
+   /**
+    * @brief Get an allocator view serving allocations from this arena.
+    */
+   const allocator &get_allocator() const
+   {
+      return m_allocator;
+   }
+
+   /**
+    * @brief Release all arena-owned allocations at once.
+    *
+    * Any pointer previously returned from the internal storage becomes invalid.
+    * Fallback allocations made through the parent allocator are not affected.
+    */
+   void reset()
+   {
+      m_offset = 0;
+   }
+
+private:
+   static VKAPI_ATTR void *VKAPI_CALL arena_allocation(void *user_data, size_t size, size_t alignment,
+                                                       VkSystemAllocationScope scope);
+   static VKAPI_ATTR void *VKAPI_CALL arena_reallocation(void *user_data, void *original, size_t size,
+                                                         size_t alignment, VkSystemAllocationScope scope);
+   static VKAPI_ATTR void VKAPI_CALL arena_free(void *user_data, void *memory);
+
+   void *allocate(std::size_t size, std::size_t alignment);
+   void *reallocate(void *original, std::size_t size, std::size_t alignment);
+
+   /**
+    * @brief Check whether a pointer was served from the internal storage.
+    */
+   bool owns(const void *memory) const
+   {
+      return memory >= m_storage && memory < m_storage + ARENA_SIZE;
+   }
+
+   alignas(alignof(std::max_align_t)) unsigned char m_storage[ARENA_SIZE];
+
+   /** Offset into #m_storage of the next free byte. */
+   std::size_t m_offset = 0;
+
+   /** Allocator used when an allocation does not fit the internal storage. */
+   allocator m_parent;
+
+   /** Allocator view handed out by get_allocator(). */
+   allocator m_allocator;
+};
+
+} /* namespace util */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Immutable, once-parsed layer configuration.
+ */
+
+#include "config.hpp"
+#include "log.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace util
+{
+
+namespace
+{
+
+/* Knob keys, in config::knob order. The keys double as the environment
+ * variable names. */
+constexpr const char *KNOB_KEYS[] = {
+   "VULKAN_WSI_DEBUG_LEVEL",
+   "VULKAN_WSI_LOG_SYNC",
+   "VULKAN_WSI_ALLOC_TRACK",
+   "VULKAN_WSI_PRESENT_RT_PRIORITY",
+   "VULKAN_WSI_PRESENT_CPU_AFFINITY",
+   "VULKAN_WSI_ACQUIRE_SPIN_US",
+   "VULKAN_WSI_LAZY_IMAGE_COUNT",
+   "VULKAN_WSI_HEADLESS_HOST_VISIBLE",
+   "VULKAN_WSI_LATENCY_DUMP",
+   "VULKAN_WSI_DEFERRED_SWAPCHAIN_DESTROY",
+   "VULKAN_WSI_PRESENT_THREADS",
+   "VULKAN_WSI_PRESENT_QUEUE",
+   "WSI_NO_WAYLAND_BYPASS",
+   "WSI_DISPLAY_DRI_DEV",
+   "VULKAN_WSI_COPY_PROFILE",
+   "VULKAN_WSI_PRESENT_TRACE",
+   "VULKAN_WSI_IDLE_TRIM_MS",
+   "VULKAN_WSI_LATENCY_GOVERNOR",
+};
+
+/* Searched in order; the first file that sets a key wins. */
+constexpr const char *CONFIG_PATHS[] = {
+   "/etc/sky1/wsi-layer.conf",
+   "/usr/share/cix-gpu/wsi-layer.conf",
+};
+
+} /* anonymous namespace */
+
+const config &config::get()
+{
+   static const config instance;
+   return instance;
+}
+
+config::config()
+   : m_debug_level(WSI_DEFAULT_LOG_LEVEL)
+   , m_acquire_spin_us(0)
+   , m_lazy_image_count(0)
+   , m_present_threads(2)
+   , m_idle_trim_ms(5000)
+{
+   static_assert(sizeof(KNOB_KEYS) / sizeof(KNOB_KEYS[0]) == NUM_KNOBS, "KNOB_KEYS is out of sync with config::knob");
+
+   for (const char *path : CONFIG_PATHS)
+   {
+      parse_file(path);
+   }
+   apply_environment();
+
+   if (m_raw[DEBUG_LEVEL].present)
+   {
+      m_debug_level = static_cast<int>(std::strtol(m_raw[DEBUG_LEVEL].value, nullptr, 0));
+   }
+   if (m_raw[ACQUIRE_SPIN_US].present)
+   {
+      m_acquire_spin_us = std::strtoull(m_raw[ACQUIRE_SPIN_US].value, nullptr, 0);
+   }
+   if (m_raw[LAZY_IMAGE_COUNT].present)
+   {
+      constexpr uint32_t DEFAULT_EAGER_IMAGES = 2;
+      const uint32_t eager = static_cast<uint32_t>(std::strtoul(m_raw[LAZY_IMAGE_COUNT].value, nullptr, 0));
+      m_lazy_image_count = eager > 0 ? eager : DEFAULT_EAGER_IMAGES;
+   }
+   if (m_raw[PRESENT_THREADS].present)
+   {
+      m_present_threads = static_cast<uint32_t>(std::strtoul(m_raw[PRESENT_THREADS].value, nullptr, 0));
+   }
+   if (m_raw[IDLE_TRIM_MS].present)
+   {
+      m_idle_trim_ms = static_cast<uint32_t>(std::strtoul(m_raw[IDLE_TRIM_MS].value, nullptr, 0));
+   }
+}
+
+void config::parse_file(const char *path)
+{
+   FILE *file = std::fopen(path, "r");
+   if (file == nullptr)
+   {
+      return;
+   }
+
+   char line[512];
+   while (std::fgets(line, sizeof(line), file) != nullptr)
+   {
+      if (line[0] == '#' || line[0] == '\n')
+      {
+         continue;
+      }
+
+      char *separator = std::strchr(line, '=');
+      if (separator == nullptr)
+      {
+         continue;
+      }
+      *separator = '\0';
+
+      char *value = separator + 1;
+      char *newline = std::strchr(value, '\n');
+      if (newline != nullptr)
+      {
+         *newline = '\0';
+      }
+
+      set_value(line, value, false);
+   }
+   std::fclose(file);
+}
+
+void config::apply_environment()
+{
+   for (size_t i = 0; i < NUM_KNOBS; i++)
+   {
+      const char *value = std::getenv(KNOB_KEYS[i]);
+      if (value != nullptr)
+      {
+         set_value(KNOB_KEYS[i], value, true);
+      }
+   }
+}
+
+void config::set_value(const char *key, const char *value, bool overwrite)
+{
+   for (size_t i = 0; i < NUM_KNOBS; i++)
+   {
+      if (std::strcmp(key, KNOB_KEYS[i]) != 0)
+      {
+         continue;
+      }
+      if (m_raw[i].present && !overwrite)
+      {
+         return;
+      }
+      m_raw[i].present = true;
+      std::strncpy(m_raw[i].value, value, sizeof(m_raw[i].value) - 1);
+      m_raw[i].value[sizeof(m_raw[i].value) - 1] = '\0';
+      return;
+   }
+}
+
+} /* namespace util */
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Immutable, once-parsed layer configuration.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace util
+{
+
+/**
+ * @brief All of the layer's tuning knobs, parsed once per process.
+ *
+ * Every knob the layer used to read ad hoc with getenv lives here, parsed a
+ * single time into an immutable struct so runtime reads are plain loads. A
+ * knob is looked up first in the environment, then in the config files at
+ * @ref CONFIG_PATHS (first file that sets a key wins); the environment always
+ * overrides the files.
+ *
+ * Config files hold one "KEY=value" entry per line, keyed by the environment
+ * variable names; '#' starts a comment. Presence-style boolean knobs (for
+ * example VULKAN_WSI_LOG_SYNC) are enabled by setting the key at all, which
+ * matches their environment variable semantics.
+ *
+ * The struct is built on first use and forced during instance creation; it
+ * must not log, since the logger itself reads its level from here.
+ */
+class config
+{
+public:
+   /**
+    * @brief Get the process-wide configuration, parsing it on first use.
+    */
+   static const config &get();
+
+   /** VULKAN_WSI_DEBUG_LEVEL: maximum log level that is printed. */
+   int debug_level() const
+   {
+      return m_debug_level;
+   }
+
+   /** VULKAN_WSI_LOG_SYNC: strictly ordered, unbuffered log output. */
+   bool log_sync() const
+   {
+      return m_raw[LOG_SYNC].present;
+   }
+
+   /**
+    * VULKAN_WSI_ALLOC_TRACK: hot-path heap allocation tracking; "abort" also
+    * aborts on the first tracked allocation. nullptr when unset.
+    */
+   const char *alloc_track() const
+   {
+      return as_ptr(m_raw[ALLOC_TRACK]);
+   }
+
+   /**
+    * VULKAN_WSI_PRESENT_RT_PRIORITY: SCHED_FIFO priority for presentation
+    * threads, unparsed; nullptr when unset.
+    */
+   const char *present_rt_priority() const
+   {
+      return as_ptr(m_raw[PRESENT_RT_PRIORITY]);
+   }
+
+   /**
+    * VULKAN_WSI_PRESENT_CPU_AFFINITY: CPU list for presentation threads,
+    * unparsed; nullptr when unset.
+    */
+   const char *present_cpu_affinity() const
+   {
+      return as_ptr(m_raw[PRESENT_CPU_AFFINITY]);
+   }
+
+   /**
+    * VULKAN_WSI_ACQUIRE_SPIN_US: microseconds acquire may busy-poll for a free
+    * buffer before parking on the semaphore. 0 when unset.
+    */
+   uint64_t acquire_spin_us() const
+   {
+      return m_acquire_spin_us;
+   }
+
+   /**
+    * VULKAN_WSI_LAZY_IMAGE_COUNT: number of swapchain images built eagerly,
+    * with the rest allocated on first demand. 0 disables lazy growth; a set
+    * but unparsable value falls back to 2.
+    */
+   uint32_t lazy_image_count() const
+   {
+      return m_lazy_image_count;
+   }
+
+   /** VULKAN_WSI_HEADLESS_HOST_VISIBLE: host-visible headless swapchain images. */
+   bool headless_host_visible() const
+   {
+      return m_raw[HEADLESS_HOST_VISIBLE].present;
+   }
+
+   /**
+    * VULKAN_WSI_LATENCY_DUMP: path prefix for the frame latency dump; nullptr
+    * when the instrumentation is disabled.
+    */
+   const char *latency_dump() const
+   {
+      return as_ptr(m_raw[LATENCY_DUMP]);
+   }
+
+   /** VULKAN_WSI_DEFERRED_SWAPCHAIN_DESTROY: retire swapchains on a reaper thread. */
+   bool deferred_swapchain_destroy() const
+   {
+      return m_raw[DEFERRED_SWAPCHAIN_DESTROY].present;
+   }
+
+   /**
+    * VULKAN_WSI_PRESENT_THREADS: size of the shared presentation thread pool.
+    * 0 disables the pool in favour of dedicated page flip threads; defaults
+    * to 2 when unset.
+    */
+   uint32_t present_threads() const
+   {
+      return m_present_threads;
+   }
+
+   /**
+    * VULKAN_WSI_PRESENT_QUEUE: "family:index" override for the queue used to
+    * submit present payloads, unparsed; nullptr when unset.
+    */
+   const char *present_queue() const
+   {
+      return as_ptr(m_raw[PRESENT_QUEUE]);
+   }
+
+   /** WSI_NO_WAYLAND_BYPASS: disable the X11-to-Wayland bypass presenter. */
+   bool wayland_bypass_disabled() const
+   {
+      return m_raw[NO_WAYLAND_BYPASS].present;
+   }
+
+   /** WSI_DISPLAY_DRI_DEV: DRI device node for the display backend; nullptr when unset. */
+   const char *display_dri_device() const
+   {
+      return as_ptr(m_raw[DISPLAY_DRI_DEV]);
+   }
+
+   /**
+    * VULKAN_WSI_COPY_PROFILE: path of the wsi_copy_bench machine profile for
+    * the SHM copy kernels; nullptr when unset, in which case the presenter
+    * looks in the standard config directories.
+    */
+   const char *copy_profile() const
+   {
+      return as_ptr(m_raw[COPY_PROFILE]);
+   }
+
+   /**
+    * VULKAN_WSI_PRESENT_TRACE: path prefix for the binary acquire/present
+    * trace consumed by wsi_present_replay; nullptr when tracing is disabled.
+    */
+   const char *present_trace() const
+   {
+      return as_ptr(m_raw[PRESENT_TRACE]);
+   }
+
+   /**
+    * VULKAN_WSI_IDLE_TRIM_MS: milliseconds without a present before a
+    * swapchain's pooled resources (copy workers, scaling LUTs, pooled SHM
+    * segments) are trimmed. 0 disables trimming; defaults to 5000 when unset.
+    */
+   uint32_t idle_trim_ms() const
+   {
+      return m_idle_trim_ms;
+   }
+
+   /**
+    * VULKAN_WSI_LATENCY_GOVERNOR: adapt the number of swapchain images handed
+    * to the application from measured present queue residency, trading unused
+    * buffering for latency when the application consistently beats vsync.
+    */
+   bool latency_governor() const
+   {
+      return m_raw[LATENCY_GOVERNOR].present;
+   }
+
+private:
+   /** Indices of the known knobs, in @ref KNOB_KEYS order. */
+   enum knob : size_t
+   {
+      DEBUG_LEVEL = 0,
+      LOG_SYNC,
+      ALLOC_TRACK,
+      PRESENT_RT_PRIORITY,
+      PRESENT_CPU_AFFINITY,
+      ACQUIRE_SPIN_US,
+      LAZY_IMAGE_COUNT,
+      HEADLESS_HOST_VISIBLE,
+      LATENCY_DUMP,
+      DEFERRED_SWAPCHAIN_DESTROY,
+      PRESENT_THREADS,
+      PRESENT_QUEUE,
+      NO_WAYLAND_BYPASS,
+      DISPLAY_DRI_DEV,
+      COPY_PROFILE,
+      PRESENT_TRACE,
+      IDLE_TRIM_MS,
+      LATENCY_GOVERNOR,
+      NUM_KNOBS,
+   };
+
+   /** A knob's raw value; present distinguishes "unset" from "set to empty". */
+   struct raw_value
+   {
+      bool present = false;
+      char value[256] = {};
+   };
+
+   static const char *as_ptr(const raw_value &raw)
+   {
+      return raw.present ? raw.value : nullptr;
+   }
+
+   config();
+
+   /**
+    * @brief Read "KEY=value" entries from @p path into knobs not yet set.
+    */
+   void parse_file(const char *path);
+
+   /**
+    * @brief Overwrite every knob that is set in the environment.
+    */
+   void apply_environment();
+
+   /**
+    * @brief Store @p value for @p key if it is a known knob.
+    *
+    * @param overwrite Whether a value that is already set may be replaced;
+    *                  the environment overwrites files, files never overwrite
+    *                  each other.
+    */
+   void set_value(const char *key, const char *value, bool overwrite);
+
+   /** Raw values, indexed by @ref knob. */
+   raw_value m_raw[NUM_KNOBS];
+
+   /* Typed fields derived from the raw values once at construction. */
+   int m_debug_level;
+   uint64_t m_acquire_spin_us;
+   uint32_t m_lazy_image_count;
+   uint32_t m_present_threads;
+   uint32_t m_idle_trim_ms;
+};
+
+} /* namespace util */
@@ -23,6 +23,7 @@
  */
 
 #include "custom_allocator.hpp"
+#include "allocation_tracker.hpp"
 #include "macros.hpp"
 #include <vulkan/vulkan.h>
 
@@ -31,12 +32,14 @@ namespace util
 
 VWL_VKAPI_CALL(void *) default_allocation(void *, size_t size, size_t, VkSystemAllocationScope) VWL_API_POST
 {
+   allocation_tracker::notify_allocation(size);
    return malloc(size);
 }
 
 VWL_VKAPI_CALL(void *)
 default_reallocation(void *, void *pOriginal, size_t size, size_t, VkSystemAllocationScope) VWL_API_POST
 {
+   allocation_tracker::notify_allocation(size);
    return realloc(pOriginal, size);
 }
 
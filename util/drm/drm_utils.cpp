@@ -25,27 +25,105 @@
 #include "drm_utils.hpp"
 #include "format_table.h"
 
+#include <algorithm>
+#include <array>
+
 namespace util
 {
 namespace drm
 {
 
-uint32_t vk_to_drm_format(VkFormat vk_format)
+namespace
+{
+
+/**
+ * @brief Compact mapping entry used for binary searched format lookups.
+ */
+struct format_mapping
 {
-   for (size_t i = 0; i < fourcc_format_table_len; i++)
+   uint32_t drm_format;
+   VkFormat vk_format;
+   uint32_t bits_per_pixel;
+};
+
+#define FORMAT_MAPPING_ENTRY(drm_format, nr_planes, bpp0, bpp1, bpp2, bpp3, vk_format) \
+   format_mapping{ drm_format, vk_format, (bpp0) + (bpp1) + (bpp2) + (bpp3) },
+#define FORMAT_MAPPING_COUNT(drm_format, nr_planes, bpp0, bpp1, bpp2, bpp3, vk_format) +1
+
+constexpr size_t format_mapping_count = 0 FOURCC_FORMAT_TABLE(FORMAT_MAPPING_COUNT);
+constexpr size_t srgb_format_mapping_count = 0 SRGB_FOURCC_FORMAT_TABLE(FORMAT_MAPPING_COUNT);
+
+template <size_t size>
+using mapping_table = std::array<format_mapping, size>;
+
+struct order_by_drm_format
+{
+   constexpr bool operator()(const format_mapping &lhs, const format_mapping &rhs) const
    {
-      if (vk_format == fourcc_format_table[i].vk_format)
-      {
-         return fourcc_format_table[i].drm_format;
-      }
+      return lhs.drm_format < rhs.drm_format;
+   }
+};
+
+struct order_by_vk_format
+{
+   constexpr bool operator()(const format_mapping &lhs, const format_mapping &rhs) const
+   {
+      return lhs.vk_format < rhs.vk_format;
    }
+};
 
-   for (size_t i = 0; i < srgb_fourcc_format_table_len; i++)
+/* std::sort only becomes constexpr with C++20, so sort the small tables at
+ * compile time with an insertion sort. It is stable, which keeps the table
+ * order deterministic for entries that compare equal. */
+template <size_t size, typename compare>
+constexpr mapping_table<size> sort_table(mapping_table<size> table, compare order)
+{
+   for (size_t i = 1; i < size; i++)
    {
-      if (vk_format == srgb_fourcc_format_table[i].vk_format)
+      format_mapping entry = table[i];
+      size_t j = i;
+      for (; j > 0 && order(entry, table[j - 1]); j--)
       {
-         return srgb_fourcc_format_table[i].drm_format;
+         table[j] = table[j - 1];
       }
+      table[j] = entry;
+   }
+   return table;
+}
+
+constexpr auto drm_to_vk_table =
+   sort_table(mapping_table<format_mapping_count>{ FOURCC_FORMAT_TABLE(FORMAT_MAPPING_ENTRY) }, order_by_drm_format{});
+constexpr auto vk_to_drm_table =
+   sort_table(mapping_table<format_mapping_count>{ FOURCC_FORMAT_TABLE(FORMAT_MAPPING_ENTRY) }, order_by_vk_format{});
+constexpr auto srgb_drm_to_vk_table = sort_table(
+   mapping_table<srgb_format_mapping_count>{ SRGB_FOURCC_FORMAT_TABLE(FORMAT_MAPPING_ENTRY) }, order_by_drm_format{});
+constexpr auto srgb_vk_to_drm_table = sort_table(
+   mapping_table<srgb_format_mapping_count>{ SRGB_FOURCC_FORMAT_TABLE(FORMAT_MAPPING_ENTRY) }, order_by_vk_format{});
+
+template <size_t size, typename compare>
+const format_mapping *find_mapping(const mapping_table<size> &table, const format_mapping &key, compare order)
+{
+   auto entry = std::lower_bound(table.begin(), table.end(), key, order);
+   if (entry != table.end() && !order(key, *entry))
+   {
+      return &*entry;
+   }
+   return nullptr;
+}
+
+} /* namespace */
+
+uint32_t vk_to_drm_format(VkFormat vk_format)
+{
+   const format_mapping key{ 0, vk_format, 0 };
+   if (const auto *entry = find_mapping(vk_to_drm_table, key, order_by_vk_format{}))
+   {
+      return entry->drm_format;
+   }
+
+   if (const auto *entry = find_mapping(srgb_vk_to_drm_table, key, order_by_vk_format{}))
+   {
+      return entry->drm_format;
    }
 
    return 0;
@@ -53,12 +131,10 @@ uint32_t vk_to_drm_format(VkFormat vk_format)
 
 VkFormat drm_to_vk_format(uint32_t drm_format)
 {
-   for (size_t i = 0; i < fourcc_format_table_len; i++)
+   const format_mapping key{ drm_format, VK_FORMAT_UNDEFINED, 0 };
+   if (const auto *entry = find_mapping(drm_to_vk_table, key, order_by_drm_format{}))
    {
-      if (drm_format == fourcc_format_table[i].drm_format)
-      {
-         return fourcc_format_table[i].vk_format;
-      }
+      return entry->vk_format;
    }
 
    return VK_FORMAT_UNDEFINED;
@@ -66,17 +142,34 @@ VkFormat drm_to_vk_format(uint32_t drm_format)
 
 VkFormat drm_to_vk_srgb_format(uint32_t drm_format)
 {
-   for (size_t i = 0; i < srgb_fourcc_format_table_len; i++)
+   const format_mapping key{ drm_format, VK_FORMAT_UNDEFINED, 0 };
+   if (const auto *entry = find_mapping(srgb_drm_to_vk_table, key, order_by_drm_format{}))
    {
-      if (drm_format == srgb_fourcc_format_table[i].drm_format)
-      {
-         return srgb_fourcc_format_table[i].vk_format;
-      }
+      return entry->vk_format;
    }
 
    return VK_FORMAT_UNDEFINED;
 }
 
+uint32_t modifier_score(uint32_t drm_format, uint64_t modifier, bool scanout_capable)
+{
+   /* Assume 32 bits per pixel when the format is not in the mapping table. */
+   uint32_t bits_per_pixel = 32;
+   const format_mapping key{ drm_format, VK_FORMAT_UNDEFINED, 0 };
+   if (const auto *entry = find_mapping(drm_to_vk_table, key, order_by_drm_format{}))
+   {
+      bits_per_pixel = entry->bits_per_pixel;
+   }
+
+   /* Non-linear modifiers are assumed to select compressed or tiled layouts,
+    * which cost less memory bandwidth to fetch than a linear image. */
+   const uint32_t scanout_rank = scanout_capable ? 1u : 0u;
+   const uint32_t compressed_rank = modifier != DRM_FORMAT_MOD_LINEAR ? 1u : 0u;
+
+   /* A lower bandwidth estimate breaks ties within a rank. */
+   return (scanout_rank << 17) | (compressed_rank << 16) | (0xffffu - std::min(bits_per_pixel, 0xffffu));
+}
+
 /* Returns the number of planes represented by a fourcc format. */
 uint32_t drm_fourcc_format_get_num_planes(uint32_t format)
 {
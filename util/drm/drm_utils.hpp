@@ -36,5 +36,19 @@ VkFormat drm_to_vk_format(uint32_t drm_format);
 VkFormat drm_to_vk_srgb_format(uint32_t drm_format);
 uint32_t drm_fourcc_format_get_num_planes(uint32_t format);
 
+/**
+ * @brief Rank a format and modifier candidate for presentable image allocation.
+ *
+ * Scanout capable candidates beat compressed (non-linear) ones, which in turn
+ * beat linear, with a lower estimated bandwidth breaking ties within a rank.
+ *
+ * @param drm_format      The fourcc format of the candidate.
+ * @param modifier        The DRM format modifier of the candidate.
+ * @param scanout_capable Whether the presentation engine can scan the candidate out directly.
+ *
+ * @return The candidate's score, where a higher score is a better candidate.
+ */
+uint32_t modifier_score(uint32_t drm_format, uint64_t modifier, bool scanout_capable);
+
 } // namespace drm
 } // namespace util
@@ -35,6 +35,49 @@
 
 #define NELEMS(x) (sizeof(x) / sizeof(x[0]))
 
+/* Single source of truth for the fourcc <-> Vulkan format mappings. The ENTRY
+ * arguments are: drm format, plane count, per plane bits per pixel, Vulkan
+ * format. format_table.c expands the lists into the arrays indexed by the C
+ * allocator helpers, while drm_utils.cpp expands them into compile time sorted
+ * tables for binary searched lookups. */
+#define FOURCC_FORMAT_TABLE(ENTRY)                                          \
+   /* Supported R,G,B,A formats */                                          \
+   ENTRY(DRM_FORMAT_RGB332, 1, 8, 0, 0, 0, VK_FORMAT_UNDEFINED)             \
+   ENTRY(DRM_FORMAT_BGR233, 1, 8, 0, 0, 0, VK_FORMAT_UNDEFINED)             \
+   ENTRY(DRM_FORMAT_XRGB4444, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_XBGR4444, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_RGBX4444, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_BGRX4444, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_ARGB4444, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_ABGR4444, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_RGBA4444, 1, 16, 0, 0, 0, VK_FORMAT_R4G4B4A4_UNORM_PACK16) \
+   ENTRY(DRM_FORMAT_BGRA4444, 1, 16, 0, 0, 0, VK_FORMAT_B4G4R4A4_UNORM_PACK16) \
+   ENTRY(DRM_FORMAT_XRGB1555, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_XBGR1555, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_RGBX5551, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_BGRX5551, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_ARGB1555, 1, 16, 0, 0, 0, VK_FORMAT_A1R5G5B5_UNORM_PACK16) \
+   ENTRY(DRM_FORMAT_ABGR1555, 1, 16, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_RGBA5551, 1, 16, 0, 0, 0, VK_FORMAT_R5G5B5A1_UNORM_PACK16) \
+   ENTRY(DRM_FORMAT_BGRA5551, 1, 16, 0, 0, 0, VK_FORMAT_B5G5R5A1_UNORM_PACK16) \
+   ENTRY(DRM_FORMAT_RGB565, 1, 16, 0, 0, 0, VK_FORMAT_R5G6B5_UNORM_PACK16)  \
+   ENTRY(DRM_FORMAT_BGR565, 1, 16, 0, 0, 0, VK_FORMAT_B5G6R5_UNORM_PACK16)  \
+   ENTRY(DRM_FORMAT_RGB888, 1, 24, 0, 0, 0, VK_FORMAT_B8G8R8_UNORM)         \
+   ENTRY(DRM_FORMAT_BGR888, 1, 24, 0, 0, 0, VK_FORMAT_R8G8B8_UNORM)         \
+   ENTRY(DRM_FORMAT_XRGB8888, 1, 32, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_XBGR8888, 1, 32, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_RGBX8888, 1, 32, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_BGRX8888, 1, 32, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_ARGB8888, 1, 32, 0, 0, 0, VK_FORMAT_B8G8R8A8_UNORM)     \
+   ENTRY(DRM_FORMAT_ABGR8888, 1, 32, 0, 0, 0, VK_FORMAT_R8G8B8A8_UNORM)     \
+   ENTRY(DRM_FORMAT_RGBA8888, 1, 32, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   ENTRY(DRM_FORMAT_BGRA8888, 1, 32, 0, 0, 0, VK_FORMAT_UNDEFINED)          \
+   /* ENTRY(DRM_FORMAT_ABGR2101010, 1, 32, 0, 0, 0, VK_FORMAT_A2B10G10R10_UNORM_PACK32) */
+
+#define SRGB_FOURCC_FORMAT_TABLE(ENTRY)                                     \
+   ENTRY(DRM_FORMAT_ARGB8888, 1, 32, 0, 0, 0, VK_FORMAT_B8G8R8A8_SRGB)      \
+   ENTRY(DRM_FORMAT_ABGR8888, 1, 32, 0, 0, 0, VK_FORMAT_R8G8B8A8_SRGB)
+
 typedef struct fmt_spec
 {
    uint32_t drm_format;
@@ -24,6 +24,7 @@
 
 #include "extension_list.hpp"
 #include "util/custom_allocator.hpp"
+#include "util/macros.hpp"
 #include <layer/private_data.hpp>
 #include <cstdio>
 #include <cstring>
@@ -32,10 +33,100 @@
 namespace util
 {
 
+/**
+ * @brief Compute the 64-bit FNV-1a hash of an extension name.
+ */
+static uint64_t hash_name(const char *name)
+{
+   uint64_t hash = 0xcbf29ce484222325ull;
+   for (const char *c = name; *c != '\0'; c++)
+   {
+      hash ^= static_cast<unsigned char>(*c);
+      hash *= 0x100000001b3ull;
+   }
+   return hash;
+}
+
 extension_list::extension_list(const util::allocator &allocator)
    : m_alloc{ allocator }
    , m_ext_props(allocator)
+   , m_spilled_keys(allocator)
+{
+}
+
+extension_list::name_key *extension_list::keys()
+{
+   return m_keys_spilled ? m_spilled_keys.data() : m_inline_keys.data();
+}
+
+const extension_list::name_key *extension_list::keys() const
+{
+   return m_keys_spilled ? m_spilled_keys.data() : m_inline_keys.data();
+}
+
+bool extension_list::reserve_key()
+{
+   if (!m_keys_spilled && m_key_count < INLINE_KEY_COUNT)
+   {
+      return true;
+   }
+
+   if (!m_spilled_keys.try_resize(m_key_count + 1))
+   {
+      return false;
+   }
+
+   if (!m_keys_spilled)
+   {
+      std::copy(m_inline_keys.begin(), m_inline_keys.end(), m_spilled_keys.begin());
+      m_keys_spilled = true;
+   }
+   return true;
+}
+
+bool extension_list::insert_key(uint64_t hash, uint32_t index)
+{
+   if (!reserve_key())
+   {
+      return false;
+   }
+
+   name_key *data = keys();
+   name_key *pos = std::upper_bound(data, data + m_key_count, hash,
+                                    [](uint64_t value, const name_key &key) { return value < key.hash; });
+   std::memmove(pos + 1, pos, (data + m_key_count - pos) * sizeof(name_key));
+   *pos = { hash, index };
+   m_key_count++;
+   return true;
+}
+
+bool extension_list::insert_keys(size_t first_index, size_t count)
 {
+   for (size_t i = 0; i < count; i++)
+   {
+      if (!insert_key(hash_name(m_ext_props[first_index + i].extensionName),
+                      static_cast<uint32_t>(first_index + i)))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+void extension_list::rebuild_keys()
+{
+   m_key_count = 0;
+   if (m_keys_spilled)
+   {
+      /* Shrinking cannot fail and the retained capacity covers the regrowth below. */
+      bool shrunk = m_spilled_keys.try_resize(0);
+      assert(shrunk);
+      UNUSED(shrunk);
+   }
+
+   bool inserted = insert_keys(0, m_ext_props.size());
+   assert(inserted);
+   UNUSED(inserted);
 }
 
 VkResult extension_list::add(const char *const *extensions, size_t count)
@@ -66,6 +157,15 @@ VkResult extension_list::add(const char *const *extensions, size_t count)
          abort();
       }
    }
+
+   if (!insert_keys(initial_size, count))
+   {
+      bool shrunk = m_ext_props.try_resize(initial_size);
+      assert(shrunk);
+      UNUSED(shrunk);
+      rebuild_keys();
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
    return VK_SUCCESS;
 }
 
@@ -104,6 +204,11 @@ VkResult extension_list::add(VkExtensionProperties ext_prop)
       {
          return VK_ERROR_OUT_OF_HOST_MEMORY;
       }
+      if (!insert_keys(m_ext_props.size() - 1, 1))
+      {
+         m_ext_props.pop_back();
+         return VK_ERROR_OUT_OF_HOST_MEMORY;
+      }
    }
    return VK_SUCCESS;
 }
@@ -119,6 +224,15 @@ VkResult extension_list::add(const VkExtensionProperties *props, size_t count)
    {
       m_ext_props[initial_size + i] = props[i];
    }
+
+   if (!insert_keys(initial_size, count))
+   {
+      bool shrunk = m_ext_props.try_resize(initial_size);
+      assert(shrunk);
+      UNUSED(shrunk);
+      rebuild_keys();
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
    return VK_SUCCESS;
 }
 
@@ -163,9 +277,14 @@ bool extension_list::contains(const extension_list &req) const
 
 bool extension_list::contains(const char *extension_name) const
 {
-   for (const auto &p : m_ext_props)
+   const uint64_t hash = hash_name(extension_name);
+   const name_key *data = keys();
+   const name_key *end = data + m_key_count;
+   const name_key *it = std::lower_bound(data, end, hash,
+                                         [](const name_key &key, uint64_t value) { return key.hash < value; });
+   for (; it != end && it->hash == hash; ++it)
    {
-      if (strcmp(p.extensionName, extension_name) == 0)
+      if (strcmp(m_ext_props[it->index].extensionName, extension_name) == 0)
       {
          return true;
       }
@@ -178,5 +297,7 @@ void extension_list::remove(const char *ext)
    m_ext_props.erase(std::remove_if(m_ext_props.begin(), m_ext_props.end(), [&ext](VkExtensionProperties ext_prop) {
       return (strcmp(ext_prop.extensionName, ext) == 0);
    }));
+   /* Indices of the remaining entries may have shifted. */
+   rebuild_keys();
 }
 } // namespace util
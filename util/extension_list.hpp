@@ -26,6 +26,8 @@
 #include "custom_allocator.hpp"
 #include "helpers.hpp"
 
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 
@@ -105,11 +107,80 @@ public:
    VkResult add(const char *const *extensions, size_t count, const char *const *extensions_subset, size_t subset_count);
 
 private:
+   /**
+    * @brief Hashed key referencing an entry of @ref m_ext_props.
+    *
+    * The keys are kept sorted by hash so @ref contains can binary search over
+    * 12-byte records instead of scanning 256-byte VkExtensionProperties
+    * entries. Entries sharing a hash are disambiguated with strcmp via the
+    * stored index.
+    */
+   struct name_key
+   {
+      uint64_t hash;  /**< 64-bit FNV-1a hash of the extension name. */
+      uint32_t index; /**< Index of the entry in @ref m_ext_props. */
+   };
+
+   /**
+    * @brief Number of keys that can be stored without a heap allocation.
+    */
+   static constexpr size_t INLINE_KEY_COUNT = 16;
+
+   /**
+    * @brief Get the active key storage, either the inline buffer or the heap vector.
+    */
+   name_key *keys();
+   const name_key *keys() const;
+
+   /**
+    * @brief Make room for one more key, spilling to the heap when the inline buffer is full.
+    */
+   bool reserve_key();
+
+   /**
+    * @brief Insert a key at its sorted position.
+    */
+   bool insert_key(uint64_t hash, uint32_t index);
+
+   /**
+    * @brief Insert keys for @p count entries of @ref m_ext_props starting at @p first_index.
+    */
+   bool insert_keys(size_t first_index, size_t count);
+
+   /**
+    * @brief Rebuild the key index from @ref m_ext_props.
+    *
+    * Only shrinks the key storage, so it cannot fail. Used after removing
+    * entries or to roll back a partially failed addition.
+    */
+   void rebuild_keys();
+
    util::allocator m_alloc;
 
    /**
     * @note We are using VkExtensionProperties to store the extension name only
     */
    util::vector<VkExtensionProperties> m_ext_props;
+
+   /**
+    * @brief Inline key storage for the common case of small extension lists.
+    */
+   std::array<name_key, INLINE_KEY_COUNT> m_inline_keys{};
+
+   /**
+    * @brief Heap key storage, used once the list outgrows @ref m_inline_keys.
+    */
+   util::vector<name_key> m_spilled_keys;
+
+   /**
+    * @brief Number of valid keys in the active storage.
+    */
+   size_t m_key_count{ 0 };
+
+   /**
+    * @brief Whether the keys have moved to @ref m_spilled_keys. Once spilled
+    * the keys stay on the heap even if entries are removed.
+    */
+   bool m_keys_spilled{ false };
 };
 } // namespace util
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, 2024 Arm Limited.
+ * Copyright (c) 2021, 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <cerrno>
+#include <poll.h>
 #include <unistd.h>
 #include <utility>
 
@@ -74,6 +76,16 @@ public:
       return fd_handle;
    }
 
+   /**
+    * @brief Give up ownership of the descriptor, returning it to the caller.
+    */
+   int release()
+   {
+      int fd = fd_handle;
+      fd_handle = -1;
+      return fd;
+   }
+
    bool is_valid() const
    {
       return fd_handle >= 0;
@@ -83,4 +95,54 @@ private:
    int fd_handle{ -1 };
 };
 
+/**
+ * @brief Result of waiting for activity on a file descriptor.
+ */
+enum class fd_wait_status
+{
+   /** The descriptor has data to read. */
+   readable,
+   /** The timeout expired with no activity. */
+   timeout,
+   /** The wait failed or the descriptor entered an error state; errno holds
+    *  the failure when the wait itself failed. */
+   error,
+};
+
+/**
+ * @brief Wait until a file descriptor becomes readable.
+ *
+ * Shared readiness wait for the backends' event loops - a single syscall per
+ * wait, with no descriptor-number limit, unlike select(). Signal interruptions
+ * restart the wait, which resets the timeout.
+ *
+ * @param fd         The descriptor to wait on.
+ * @param timeout_ms Wait timeout in milliseconds, negative to wait indefinitely.
+ *
+ * @return Whether the descriptor is readable, the wait timed out or failed.
+ */
+inline fd_wait_status wait_for_readable(int fd, int timeout_ms)
+{
+   struct pollfd pfd = {};
+   pfd.fd = fd;
+   pfd.events = POLLIN;
+
+   while (true)
+   {
+      int res = poll(&pfd, 1, timeout_ms);
+      if (res > 0)
+      {
+         return (pfd.revents & POLLIN) != 0 ? fd_wait_status::readable : fd_wait_status::error;
+      }
+      else if (res == 0)
+      {
+         return fd_wait_status::timeout;
+      }
+      else if (errno != EINTR && errno != EAGAIN)
+      {
+         return fd_wait_status::error;
+      }
+   }
+}
+
 } /* namespace util */
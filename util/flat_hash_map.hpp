@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file flat_hash_map.hpp
+ *
+ * @brief Contains an open-addressed hash map for small hot lookup tables.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "custom_allocator.hpp"
+#include "helpers.hpp"
+
+namespace util
+{
+
+/**
+ * @brief Open-addressed hash map with inline storage for the first entries.
+ *
+ * Drop-in for the @ref util::unordered_map pattern (custom allocator, no
+ * throwing insertions) for tables that are looked up on hot paths: entries
+ * live contiguously in a single slot array probed linearly, so a @c find is
+ * one hash and a short scan instead of the bucket and node dereferences of
+ * the node-based map. The first @p inline_capacity slots are embedded in the
+ * object itself, so small tables never allocate at all.
+ *
+ * Unlike the node-based map, iterators and entry pointers are invalidated by
+ * any insertion.
+ *
+ * @tparam Key             The key type.
+ * @tparam Value           The mapped type.
+ * @tparam Hash            Hash functor for the key.
+ * @tparam Comparator      Equality functor for the key.
+ * @tparam inline_capacity Number of slots embedded in the object, must be a
+ *                         power of two.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Comparator = std::equal_to<Key>,
+          std::size_t inline_capacity = 8>
+class flat_hash_map : private noncopyable
+{
+public:
+   static_assert(inline_capacity != 0 && (inline_capacity & (inline_capacity - 1)) == 0,
+                 "inline_capacity must be a power of two");
+
+   using value_type = std::pair<Key, Value>;
+   using size_type = std::size_t;
+
+private:
+   enum class slot_state : uint8_t
+   {
+      empty = 0,
+      full,
+      /* Erased slot; probe chains running through it stay intact and the slot
+       * is reused by a later insertion. Purged on rehash. */
+      tombstone,
+   };
+
+   struct slot
+   {
+      slot_state state = slot_state::empty;
+      typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+
+      value_type *entry()
+      {
+         return reinterpret_cast<value_type *>(&storage);
+      }
+   };
+
+public:
+   /**
+    * @brief Forward iterator over the occupied slots of the map.
+    */
+   class iterator
+   {
+   public:
+      iterator(slot *pos, slot *end)
+         : m_pos(pos)
+         , m_end(end)
+      {
+         skip_to_full();
+      }
+
+      value_type &operator*() const
+      {
+         return *m_pos->entry();
+      }
+
+      value_type *operator->() const
+      {
+         return m_pos->entry();
+      }
+
+      iterator &operator++()
+      {
+         m_pos++;
+         skip_to_full();
+         return *this;
+      }
+
+      bool operator==(const iterator &other) const
+      {
+         return m_pos == other.m_pos;
+      }
+
+      bool operator!=(const iterator &other) const
+      {
+         return m_pos != other.m_pos;
+      }
+
+   private:
+      void skip_to_full()
+      {
+         while (m_pos != m_end && m_pos->state != slot_state::full)
+         {
+            m_pos++;
+         }
+      }
+
+      slot *m_pos;
+      slot *m_end;
+
+      friend class flat_hash_map;
+   };
+
+   /**
+    * @brief Construct a new flat hash map with a custom allocator.
+    *
+    * @param allocator The allocator that will be used for spilled tables.
+    */
+   explicit flat_hash_map(util::custom_allocator<value_type> allocator)
+      : m_allocator(allocator)
+   {
+   }
+
+   ~flat_hash_map()
+   {
+      clear();
+      if (m_slots != m_inline_slots)
+      {
+         m_allocator.deallocate(m_slots, m_capacity);
+      }
+   }
+
+   iterator begin()
+   {
+      return iterator(m_slots, m_slots + m_capacity);
+   }
+
+   iterator end()
+   {
+      return iterator(m_slots + m_capacity, m_slots + m_capacity);
+   }
+
+   size_type size() const
+   {
+      return m_size;
+   }
+
+   /**
+    * @brief Find the entry for a key.
+    *
+    * @param key The key to search for.
+    *
+    * @return Iterator to the entry, or @ref end when the key is not present.
+    */
+   iterator find(const Key &key)
+   {
+      const size_type mask = m_capacity - 1;
+      const size_type home = hash_slot(key);
+      for (size_type probe = 0; probe < m_capacity; probe++)
+      {
+         slot &entry = m_slots[(home + probe) & mask];
+         if (entry.state == slot_state::empty)
+         {
+            break;
+         }
+         if (entry.state == slot_state::full && Comparator{}(entry.entry()->first, key))
+         {
+            return iterator(&entry, m_slots + m_capacity);
+         }
+      }
+      return end();
+   }
+
+   /**
+    * @brief Like std::unordered_map.insert but doesn't throw on out of memory errors.
+    *
+    * @param value The value to insert in the map.
+    * @return std::optional<std::pair<iterator,bool>> If successful, the optional will
+    *         contain the same return value as from std::unordered_map.insert, otherwise
+    *         if out of memory, the function returns std::nullopt.
+    */
+   std::optional<std::pair<iterator, bool>> try_insert(const std::pair<Key, Value> &value)
+   {
+      /* Grow at 7/8 occupancy counting tombstones, so probe chains stay short
+       * and insertion always finds a usable slot. */
+      if ((m_size + m_tombstones + 1) * 8 > m_capacity * 7)
+      {
+         if (!grow())
+         {
+            return std::nullopt;
+         }
+      }
+
+      const size_type mask = m_capacity - 1;
+      const size_type home = hash_slot(value.first);
+      slot *insert_slot = nullptr;
+      for (size_type probe = 0; probe < m_capacity; probe++)
+      {
+         slot &entry = m_slots[(home + probe) & mask];
+         if (entry.state == slot_state::empty)
+         {
+            if (insert_slot == nullptr)
+            {
+               insert_slot = &entry;
+            }
+            break;
+         }
+         if (entry.state == slot_state::tombstone)
+         {
+            if (insert_slot == nullptr)
+            {
+               insert_slot = &entry;
+            }
+         }
+         else if (Comparator{}(entry.entry()->first, value.first))
+         {
+            return { { iterator(&entry, m_slots + m_capacity), false } };
+         }
+      }
+
+      assert(insert_slot != nullptr);
+      if (insert_slot->state == slot_state::tombstone)
+      {
+         m_tombstones--;
+      }
+      new (insert_slot->entry()) value_type(value);
+      insert_slot->state = slot_state::full;
+      m_size++;
+      return { { iterator(insert_slot, m_slots + m_capacity), true } };
+   }
+
+   /**
+    * @brief Remove the entry an iterator points at.
+    *
+    * @param pos Iterator returned by @ref find, must not be @ref end.
+    */
+   void erase(iterator pos)
+   {
+      assert(pos.m_pos != m_slots + m_capacity && pos.m_pos->state == slot_state::full);
+      pos.m_pos->entry()->~value_type();
+      pos.m_pos->state = slot_state::tombstone;
+      m_size--;
+      m_tombstones++;
+   }
+
+   /**
+    * @brief Remove every entry, keeping the current table.
+    */
+   void clear()
+   {
+      for (size_type i = 0; i < m_capacity; i++)
+      {
+         if (m_slots[i].state == slot_state::full)
+         {
+            m_slots[i].entry()->~value_type();
+         }
+         m_slots[i].state = slot_state::empty;
+      }
+      m_size = 0;
+      m_tombstones = 0;
+   }
+
+private:
+   size_type hash_slot(const Key &key) const
+   {
+      /* The table index is the hash masked to a power of two, but std::hash is
+       * close to an identity for pointers and integers, so aligned handles
+       * would collide on their constant low bits. Mix the hash before
+       * masking. */
+      size_type h = Hash{}(key);
+      h ^= h >> 33;
+      h *= static_cast<size_type>(0xff51afd7ed558ccdULL);
+      h ^= h >> 33;
+      return h & (m_capacity - 1);
+   }
+
+   /**
+    * @brief Move the entries into a table twice the size.
+    *
+    * Tombstones are dropped in the process. The inline slots are abandoned
+    * (not freed) when the map first spills to the heap.
+    *
+    * @return true on success, false when the host is out of memory.
+    */
+   bool grow()
+   {
+      const size_type new_capacity = m_capacity * 2;
+      slot *new_slots = nullptr;
+      try
+      {
+         new_slots = m_slot_allocator.allocate(new_capacity);
+      }
+      catch (const std::bad_alloc &)
+      {
+         return false;
+      }
+      for (size_type i = 0; i < new_capacity; i++)
+      {
+         new (&new_slots[i]) slot();
+      }
+
+      slot *old_slots = m_slots;
+      const size_type old_capacity = m_capacity;
+      m_slots = new_slots;
+      m_capacity = new_capacity;
+      m_tombstones = 0;
+
+      const size_type mask = new_capacity - 1;
+      for (size_type i = 0; i < old_capacity; i++)
+      {
+         if (old_slots[i].state != slot_state::full)
+         {
+            continue;
+         }
+         value_type *entry = old_slots[i].entry();
+         const size_type home = hash_slot(entry->first);
+         for (size_type probe = 0; probe < new_capacity; probe++)
+         {
+            slot &target = m_slots[(home + probe) & mask];
+            if (target.state == slot_state::empty)
+            {
+               new (target.entry()) value_type(std::move(*entry));
+               target.state = slot_state::full;
+               break;
+            }
+         }
+         entry->~value_type();
+      }
+
+      if (old_slots != m_inline_slots)
+      {
+         m_slot_allocator.deallocate(old_slots, old_capacity);
+      }
+      return true;
+   }
+
+   util::custom_allocator<value_type> m_allocator;
+   util::custom_allocator<slot> m_slot_allocator{ m_allocator };
+
+   slot m_inline_slots[inline_capacity];
+   slot *m_slots = m_inline_slots;
+   size_type m_capacity = inline_capacity;
+   size_type m_size = 0;
+   size_type m_tombstones = 0;
+};
+
+} /* namespace util */
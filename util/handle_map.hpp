@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file handle_map.hpp
+ *
+ * @brief Contains a read-mostly map from dispatchable handle keys to private data.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace util
+{
+
+/**
+ * @brief Fixed capacity pointer map with wait-free lookup.
+ *
+ * Open addressed hash table mapping a dispatch key to a pointer, intended for
+ * associations that are written a handful of times (handle creation and
+ * destruction) but read on every intercepted entrypoint. @ref get takes no
+ * lock and performs no allocation, so concurrent readers never serialize on
+ * each other or on writers.
+ *
+ * @ref insert and @ref erase must be externally synchronized against each
+ * other by the caller; they are safe to run concurrently with @ref get.
+ * Erased slots are tombstoned rather than cleared so that probe chains stay
+ * intact for concurrent readers, and tombstones are reused by later
+ * insertions. Looking up a key while it is concurrently erased or its slot is
+ * reused returns either the old or the new association, which matches the
+ * Vulkan requirement that applications do not use handles being destroyed.
+ *
+ * @tparam value_type Type the stored pointers point to.
+ * @tparam num_slots  Table capacity, must be a power of two.
+ */
+template <typename value_type, std::size_t num_slots>
+class concurrent_handle_map
+{
+public:
+   static_assert(num_slots != 0 && (num_slots & (num_slots - 1)) == 0, "num_slots must be a power of two");
+
+   /**
+    * @brief Look up the value associated with a key without taking any lock.
+    *
+    * @param key The dispatch key to search for.
+    *
+    * @return The associated pointer, or @c nullptr if the key is not present.
+    */
+   value_type *get(void *key) const
+   {
+      const std::size_t home = hash_key(key);
+      for (std::size_t probe = 0; probe < num_slots; probe++)
+      {
+         const slot &entry = m_slots[(home + probe) & (num_slots - 1)];
+         void *slot_key = entry.key.load(std::memory_order_acquire);
+         if (slot_key == key)
+         {
+            return entry.value.load(std::memory_order_acquire);
+         }
+         else if (slot_key == nullptr)
+         {
+            return nullptr;
+         }
+      }
+      return nullptr;
+   }
+
+   /**
+    * @brief Associate a key with a value, replacing any existing association.
+    *
+    * Must be externally synchronized with other calls to @ref insert and
+    * @ref erase.
+    *
+    * @param key   The dispatch key to associate, must not be @c nullptr.
+    * @param value The pointer to associate with the key.
+    *
+    * @return @c true on success, @c false if the table is full.
+    */
+   bool insert(void *key, value_type *value)
+   {
+      slot *reusable = nullptr;
+      const std::size_t home = hash_key(key);
+      for (std::size_t probe = 0; probe < num_slots; probe++)
+      {
+         slot &entry = m_slots[(home + probe) & (num_slots - 1)];
+         void *slot_key = entry.key.load(std::memory_order_relaxed);
+         if (slot_key == key)
+         {
+            entry.value.store(value, std::memory_order_release);
+            return true;
+         }
+         else if (slot_key == nullptr)
+         {
+            if (reusable == nullptr)
+            {
+               reusable = &entry;
+            }
+            break;
+         }
+         else if (reusable == nullptr && entry.value.load(std::memory_order_relaxed) == nullptr)
+         {
+            reusable = &entry;
+         }
+      }
+
+      if (reusable == nullptr)
+      {
+         return false;
+      }
+
+      /* Publish the value before the key so a reader matching the key always
+       * observes a fully initialized slot. */
+      reusable->value.store(value, std::memory_order_release);
+      reusable->key.store(key, std::memory_order_release);
+      return true;
+   }
+
+   /**
+    * @brief Remove the association for a key.
+    *
+    * Must be externally synchronized with other calls to @ref insert and
+    * @ref erase.
+    *
+    * @param key The dispatch key to remove.
+    *
+    * @return The previously associated pointer, or @c nullptr if the key was
+    *         not present.
+    */
+   value_type *erase(void *key)
+   {
+      const std::size_t home = hash_key(key);
+      for (std::size_t probe = 0; probe < num_slots; probe++)
+      {
+         slot &entry = m_slots[(home + probe) & (num_slots - 1)];
+         void *slot_key = entry.key.load(std::memory_order_relaxed);
+         if (slot_key == key)
+         {
+            return entry.value.exchange(nullptr, std::memory_order_acq_rel);
+         }
+         else if (slot_key == nullptr)
+         {
+            return nullptr;
+         }
+      }
+      return nullptr;
+   }
+
+private:
+   struct slot
+   {
+      std::atomic<void *> key{ nullptr };
+      std::atomic<value_type *> value{ nullptr };
+   };
+
+   static std::size_t hash_key(void *key)
+   {
+      return std::hash<void *>{}(key);
+   }
+
+   slot m_slots[num_slots];
+};
+
+} /* namespace util */
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file handle_set.hpp
+ *
+ * @brief Contains a read-mostly set of Vulkan handles.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace util
+{
+
+/**
+ * @brief Fixed capacity handle set with wait-free membership test.
+ *
+ * Open addressed hash set of non-dispatchable Vulkan handles, intended for
+ * sets that are written a handful of times (handle creation and destruction)
+ * but tested on every intercepted entrypoint. @ref contains takes no lock and
+ * performs no allocation, so concurrent readers never serialize on each other
+ * or on writers.
+ *
+ * @ref insert and @ref erase must be externally synchronized against each
+ * other by the caller; they are safe to run concurrently with @ref contains.
+ * Erased slots are tombstoned rather than cleared so that probe chains stay
+ * intact for concurrent readers, and tombstones are reused by later
+ * insertions. Testing a handle while it is concurrently erased or its slot is
+ * reused returns either the old or the new membership, which matches the
+ * Vulkan requirement that applications do not use handles being destroyed.
+ *
+ * @tparam handle_type Vulkan handle type stored in the set.
+ * @tparam num_slots   Set capacity, must be a power of two.
+ */
+template <typename handle_type, std::size_t num_slots>
+class concurrent_handle_set
+{
+public:
+   static_assert(num_slots != 0 && (num_slots & (num_slots - 1)) == 0, "num_slots must be a power of two");
+
+   /**
+    * @brief Test whether a handle is in the set without taking any lock.
+    *
+    * @param handle The handle to search for.
+    *
+    * @return @c true if the handle is present.
+    */
+   bool contains(handle_type handle) const
+   {
+      const uint64_t key = to_key(handle);
+      const std::size_t home = hash_key(key);
+      for (std::size_t probe = 0; probe < num_slots; probe++)
+      {
+         uint64_t slot_key = m_slots[(home + probe) & (num_slots - 1)].load(std::memory_order_acquire);
+         if (slot_key == key)
+         {
+            return true;
+         }
+         else if (slot_key == EMPTY)
+         {
+            return false;
+         }
+      }
+      return false;
+   }
+
+   /**
+    * @brief Insert a handle into the set.
+    *
+    * Must be externally synchronized with other calls to @ref insert and
+    * @ref erase.
+    *
+    * @param handle The handle to insert, must not be a null handle.
+    *
+    * @return @c true on success or if the handle was already present, @c false
+    *         if the set is full.
+    */
+   bool insert(handle_type handle)
+   {
+      const uint64_t key = to_key(handle);
+      std::atomic<uint64_t> *reusable = nullptr;
+      const std::size_t home = hash_key(key);
+      for (std::size_t probe = 0; probe < num_slots; probe++)
+      {
+         std::atomic<uint64_t> &entry = m_slots[(home + probe) & (num_slots - 1)];
+         uint64_t slot_key = entry.load(std::memory_order_relaxed);
+         if (slot_key == key)
+         {
+            return true;
+         }
+         else if (slot_key == EMPTY)
+         {
+            if (reusable == nullptr)
+            {
+               reusable = &entry;
+            }
+            break;
+         }
+         else if (reusable == nullptr && slot_key == TOMBSTONE)
+         {
+            reusable = &entry;
+         }
+      }
+
+      if (reusable == nullptr)
+      {
+         return false;
+      }
+
+      reusable->store(key, std::memory_order_release);
+      return true;
+   }
+
+   /**
+    * @brief Remove a handle from the set.
+    *
+    * Must be externally synchronized with other calls to @ref insert and
+    * @ref erase.
+    *
+    * @param handle The handle to remove.
+    *
+    * @return @c true if the handle was present.
+    */
+   bool erase(handle_type handle)
+   {
+      const uint64_t key = to_key(handle);
+      const std::size_t home = hash_key(key);
+      for (std::size_t probe = 0; probe < num_slots; probe++)
+      {
+         std::atomic<uint64_t> &entry = m_slots[(home + probe) & (num_slots - 1)];
+         uint64_t slot_key = entry.load(std::memory_order_relaxed);
+         if (slot_key == key)
+         {
+            entry.store(TOMBSTONE, std::memory_order_release);
+            return true;
+         }
+         else if (slot_key == EMPTY)
+         {
+            return false;
+         }
+      }
+      return false;
+   }
+
+private:
+   /** Key of a slot that has never been used; probe chains end here. */
+   static constexpr uint64_t EMPTY = 0;
+
+   /** Key of an erased slot; skipped by probes and reused by insertions. */
+   static constexpr uint64_t TOMBSTONE = ~uint64_t{ 0 };
+
+   /* Non-dispatchable handles are a pointer or a uint64_t depending on the
+    * platform; a C-style cast converts from either. */
+   static uint64_t to_key(handle_type handle)
+   {
+      return (uint64_t)handle;
+   }
+
+   static std::size_t hash_key(uint64_t key)
+   {
+      return std::hash<uint64_t>{}(key);
+   }
+
+   std::atomic<uint64_t> m_slots[num_slots]{};
+};
+
+} /* namespace util */
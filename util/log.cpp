@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2023 Arm Limited.
+ * Copyright (c) 2021-2023, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -22,74 +22,324 @@
  * SOFTWARE.
  */
 
+#include "config.hpp"
 #include "log.hpp"
-#include <iostream>
-#include <charconv>
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
-#include <string>
 #include <cstring>
+#include <ctime>
+#include <mutex>
+#include <thread>
 
 namespace util
 {
 
 #ifndef NDEBUG
 
+namespace
+{
+
+constexpr uint64_t NSEC_PER_SEC = 1000000000;
+
+/* Formatted message payload of a log record. Longer messages are truncated. */
+constexpr size_t MESSAGE_SIZE = 232;
+
+/* Records buffered per logging thread before messages are dropped. */
+constexpr size_t RECORDS_PER_THREAD = 64;
+
+/* Number of threads that can log asynchronously at the same time. Further
+ * threads fall back to writing to stderr directly. */
+constexpr size_t MAX_THREAD_RINGS = 16;
+
+/* Token bucket rate limiting: each call-site may burst up to BUCKET_CAPACITY
+ * messages and then refills one token every TOKEN_REFILL_NS. */
+constexpr int32_t BUCKET_CAPACITY = 16;
+constexpr uint64_t TOKEN_REFILL_NS = 125000000;
+
+/* Call-sites are hashed into this many token buckets; distinct call-sites
+ * that collide conservatively share a budget. */
+constexpr size_t CALL_SITE_SLOTS = 64;
+
+uint64_t monotonic_now_ns()
+{
+   timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return static_cast<uint64_t>(now.tv_sec) * NSEC_PER_SEC + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/**
+ * @brief A formatted log message together with its origin.
+ *
+ * The file pointer refers to a __FILE__ string literal, which has static
+ * storage duration, so it is safe to keep across threads.
+ */
+struct log_record
+{
+   int level;
+   int line;
+   const char *file;
+   char message[MESSAGE_SIZE];
+};
+
+void print_record(const log_record &record)
+{
+   switch (record.level)
+   {
+   case 0:
+      /* Reserved for no logging */
+      break;
+   case 1:
+      std::fprintf(stderr, "ERROR");
+      break;
+   case 2:
+      std::fprintf(stderr, "WARNING");
+      break;
+   case 3:
+      std::fprintf(stderr, "INFO");
+      break;
+   default:
+      std::fprintf(stderr, "LEVEL_%d", record.level);
+      break;
+   }
+   std::fprintf(stderr, "(%s:%d): %s\n", record.file, record.line, record.message);
+}
+
+/**
+ * @brief Per call-site token bucket.
+ */
+struct call_site_bucket
+{
+   std::atomic<int32_t> tokens{ BUCKET_CAPACITY };
+   std::atomic<uint64_t> last_refill_ns{ 0 };
+   std::atomic<uint32_t> suppressed{ 0 };
+};
+
 /**
- * @brief check if a log level is enabled, and print it
+ * @brief Buffered asynchronous logging backend.
+ *
+ * Logging threads format their message into a fixed size record and push it
+ * to a preallocated per-thread lock-free ring; a background flusher thread
+ * drains the rings to stderr. The logging hot path therefore costs one
+ * vsnprintf and a ring push, and never blocks on the stderr stream even when
+ * an error storm makes a presentation thread log every frame.
  */
-static bool check_and_print_log_level(int level)
+class async_logger
 {
-   struct log_state
+public:
+   static async_logger &instance()
+   {
+      static async_logger logger;
+      return logger;
+   }
+
+   void log(int level, const char *file, int line, const char *format, va_list args)
+   {
+      call_site_bucket &bucket = bucket_for(file, line);
+      if (!take_token(bucket))
+      {
+         bucket.suppressed.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+
+      log_record record;
+      record.level = level;
+      record.line = line;
+      record.file = file;
+      std::vsnprintf(record.message, sizeof(record.message), format, args);
+
+      const uint32_t suppressed = bucket.suppressed.exchange(0, std::memory_order_relaxed);
+      if (suppressed != 0)
+      {
+         log_record note = record;
+         std::snprintf(note.message, sizeof(note.message), "rate limit: suppressed %u earlier messages", suppressed);
+         submit(note);
+      }
+      submit(record);
+   }
+
+private:
+   struct thread_ring
+   {
+      spsc_ring_buffer<log_record, RECORDS_PER_THREAD> records;
+      std::atomic<uint32_t> dropped{ 0 };
+      std::atomic<bool> in_use{ false };
+   };
+
+   /**
+    * @brief Claims a slot out of the ring pool for the lifetime of a thread.
+    *
+    * The slot is released when the thread exits; any records still queued are
+    * picked up by the flusher before or after a new thread claims the slot,
+    * since the handoff through the in_use flag keeps a single producer per
+    * ring at any time.
+    */
+   struct ring_handle
    {
-      int level = WSI_DEFAULT_LOG_LEVEL;
-      log_state()
+      ring_handle(async_logger &logger)
       {
-         if (const char *env = std::getenv("VULKAN_WSI_DEBUG_LEVEL"))
+         for (auto &candidate : logger.m_rings)
          {
-            std::from_chars(env, env + std::strlen(env), level);
+            bool expected = false;
+            if (candidate.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+               ring = &candidate;
+               break;
+            }
          }
       }
+
+      ~ring_handle()
+      {
+         if (ring != nullptr)
+         {
+            ring->in_use.store(false, std::memory_order_release);
+         }
+      }
+
+      thread_ring *ring = nullptr;
    };
-   static log_state state;
 
-   bool result = level <= state.level;
-   if (result)
+   async_logger()
    {
-      switch (level)
+      /* Escape hatch for debugging: strictly ordered, unbuffered output. */
+      m_synchronous = config::get().log_sync();
+      if (!m_synchronous)
       {
-      case 0:
-         /* Reserved for no logging */
-         break;
-      case 1:
-         std::fprintf(stderr, "ERROR");
-         break;
-      case 2:
-         std::fprintf(stderr, "WARNING");
-         break;
-      case 3:
-         std::fprintf(stderr, "INFO");
-         break;
-      default:
-         std::fprintf(stderr, "LEVEL_%d", level);
-         break;
+         m_flusher = std::thread(&async_logger::flush_loop, this);
       }
    }
-   return result;
-}
+
+   ~async_logger()
+   {
+      if (m_flusher.joinable())
+      {
+         {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+         }
+         m_condition.notify_one();
+         m_flusher.join();
+         drain_all();
+      }
+   }
+
+   call_site_bucket &bucket_for(const char *file, int line)
+   {
+      const uint64_t key =
+         reinterpret_cast<uintptr_t>(file) + static_cast<uint64_t>(line) * UINT64_C(0x9e3779b97f4a7c15);
+      return m_call_sites[key % CALL_SITE_SLOTS];
+   }
+
+   bool take_token(call_site_bucket &bucket)
+   {
+      const uint64_t now = monotonic_now_ns();
+      uint64_t last = bucket.last_refill_ns.load(std::memory_order_relaxed);
+      if (now - last >= TOKEN_REFILL_NS &&
+          bucket.last_refill_ns.compare_exchange_strong(last, now, std::memory_order_relaxed))
+      {
+         const int64_t refill = static_cast<int64_t>((now - last) / TOKEN_REFILL_NS);
+         const int32_t tokens = bucket.tokens.load(std::memory_order_relaxed);
+         const int64_t replenished = std::min<int64_t>(BUCKET_CAPACITY, tokens + refill);
+         /* Tokens taken between the load and this store are miscounted; the
+          * bucket only needs to be approximately fair. */
+         bucket.tokens.store(static_cast<int32_t>(replenished), std::memory_order_relaxed);
+      }
+
+      if (bucket.tokens.fetch_sub(1, std::memory_order_relaxed) > 0)
+      {
+         return true;
+      }
+      bucket.tokens.fetch_add(1, std::memory_order_relaxed);
+      return false;
+   }
+
+   void submit(const log_record &record)
+   {
+      if (m_synchronous)
+      {
+         print_record(record);
+         return;
+      }
+
+      thread_local ring_handle handle{ *this };
+      if (handle.ring == nullptr)
+      {
+         /* All rings are claimed by other threads; print directly. */
+         print_record(record);
+         return;
+      }
+
+      if (!handle.ring->records.push_back(record))
+      {
+         handle.ring->dropped.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+
+      m_pending.store(true, std::memory_order_release);
+      m_condition.notify_one();
+   }
+
+   void flush_loop()
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while (!m_stop)
+      {
+         m_condition.wait_for(lock, std::chrono::milliseconds(100),
+                              [this] { return m_stop || m_pending.load(std::memory_order_acquire); });
+         m_pending.store(false, std::memory_order_relaxed);
+         lock.unlock();
+         drain_all();
+         lock.lock();
+      }
+   }
+
+   void drain_all()
+   {
+      for (auto &ring : m_rings)
+      {
+         /* One acquire load and one release store per ring, however many
+          * records the batch carries. */
+         ring.records.pop_all_into([](log_record &&record) { print_record(record); });
+
+         const uint32_t dropped = ring.dropped.exchange(0, std::memory_order_relaxed);
+         if (dropped != 0)
+         {
+            std::fprintf(stderr, "WARNING(%s): dropped %u messages from a saturated log ring\n", __FILE__, dropped);
+         }
+      }
+   }
+
+   thread_ring m_rings[MAX_THREAD_RINGS];
+   call_site_bucket m_call_sites[CALL_SITE_SLOTS];
+   std::thread m_flusher;
+   std::mutex m_mutex;
+   std::condition_variable m_condition;
+   std::atomic<bool> m_pending{ false };
+   bool m_stop = false;
+   bool m_synchronous = false;
+};
+
+} /* namespace */
 
 void wsi_log_message(int level, const char *file, int line, const char *format, ...)
 {
-   if (check_and_print_log_level(level))
+   if (level > config::get().debug_level())
    {
-      std::fprintf(stderr, "(%s:%d): ", file, line);
-      std::va_list args;
-      va_start(args, format);
-      std::vfprintf(stderr, format, args);
-      va_end(args);
-      std::putc('\n', stderr);
+      return;
    }
+
+   std::va_list args;
+   va_start(args, format);
+   async_logger::instance().log(level, file, line, format, args);
+   va_end(args);
 }
 
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022 Arm Limited.
+ * Copyright (c) 2021-2022, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -22,13 +22,40 @@
  * SOFTWARE.
  */
 
+#pragma once
+
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <memory>
 #include <optional>
 
 namespace util
 {
 
+/**
+ * @brief Smallest power of two not smaller than @p n.
+ */
+constexpr std::size_t next_power_of_two(std::size_t n)
+{
+   std::size_t pow = 1;
+   while (pow < n)
+   {
+      pow *= 2;
+   }
+   return pow;
+}
+
+/**
+ * @brief Alignment separating indices written by different threads.
+ *
+ * 64 bytes covers the destructive interference size of every target the layer
+ * builds for; std::hardware_destructive_interference_size is deliberately not
+ * used as its value is an ABI hazard across translation units.
+ */
+constexpr std::size_t RING_INDEX_ALIGNMENT = 64;
+
 template <typename T, std::size_t N>
 class ring_buffer
 {
@@ -83,6 +110,14 @@ public:
       return get((m_begin + m_size + N - 1) % N);
    }
 
+   /**
+    * @brief Gets a pointer to the item @p index positions after the starting index.
+    */
+   T *at(std::size_t index)
+   {
+      return get((m_begin + index) % N);
+   }
+
    /**
     * @brief Pop the front of the ring buffer.
     *
@@ -128,4 +163,336 @@ private:
    std::size_t m_size{};
 };
 
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ *
+ * A fixed capacity ring buffer that allows one thread to push entries while
+ * another thread concurrently pops them without any locking. The producer
+ * only writes the tail index and the consumer only writes the head index,
+ * so a release store paired with an acquire load on the other index is
+ * enough to make the entry data visible to the other thread. Storage is
+ * rounded up to a power of two so every index reduction is a mask, and the
+ * two indices live on separate cache lines so the producer and consumer do
+ * not false-share.
+ *
+ * @note Only a single producer thread and a single consumer thread may use
+ *       the buffer at any time. T must be default constructible.
+ */
+template <typename T, std::size_t N>
+class spsc_ring_buffer
+{
+public:
+   /**
+    * @brief Return maximum capacity of the ring buffer.
+    */
+   constexpr std::size_t capacity()
+   {
+      return N;
+   }
+
+   /**
+    * @brief Return current size of the ring buffer.
+    *
+    * The value is a snapshot and may be stale as soon as it is returned if
+    * the other thread is pushing or popping concurrently.
+    */
+   std::size_t size() const
+   {
+      return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+   }
+
+   /**
+    * @brief Places item into next slot of the ring buffer.
+    *
+    * Must only be called from the producer thread.
+    *
+    * @return Boolean to indicate success or failure.
+    */
+   template <typename U>
+   bool push_back(U &&item)
+   {
+      const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+      if (tail - m_head.load(std::memory_order_acquire) == N)
+      {
+         return false;
+      }
+
+      m_data[tail & MASK] = std::forward<U>(item);
+      m_tail.store(tail + 1, std::memory_order_release);
+
+      return true;
+   }
+
+   /**
+    * @brief Place up to @p count items into the ring buffer as one batch.
+    *
+    * Must only be called from the producer thread. The items pushed become
+    * visible to the consumer together, through a single release store of the
+    * tail index.
+    *
+    * @return The number of items pushed, less than @p count when the buffer
+    *         filled up.
+    */
+   std::size_t try_push_n(const T *items, std::size_t count)
+   {
+      const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+      const std::size_t free_slots = N - (tail - m_head.load(std::memory_order_acquire));
+      const std::size_t to_push = std::min(count, free_slots);
+
+      for (std::size_t i = 0; i < to_push; i++)
+      {
+         m_data[(tail + i) & MASK] = items[i];
+      }
+      if (to_push != 0)
+      {
+         m_tail.store(tail + to_push, std::memory_order_release);
+      }
+
+      return to_push;
+   }
+
+   /**
+    * @brief Pop the front of the ring buffer.
+    *
+    * Must only be called from the consumer thread.
+    *
+    * @return Item wrapped in an optional, which is empty if the buffer was empty.
+    */
+   std::optional<T> pop_front()
+   {
+      const std::size_t head = m_head.load(std::memory_order_relaxed);
+      if (m_tail.load(std::memory_order_acquire) == head)
+      {
+         return std::nullopt;
+      }
+
+      std::optional<T> value{ std::move(m_data[head & MASK]) };
+      m_head.store(head + 1, std::memory_order_release);
+
+      return value;
+   }
+
+   /**
+    * @brief Pop every available entry as one batch.
+    *
+    * Must only be called from the consumer thread. @p sink is invoked once per
+    * entry, in push order, with an rvalue reference to the entry; the head
+    * index is published once, after the whole batch, so the drain costs one
+    * atomic release regardless of how many entries it takes.
+    *
+    * @return The number of entries popped.
+    */
+   template <typename Sink>
+   std::size_t pop_all_into(Sink &&sink)
+   {
+      const std::size_t head = m_head.load(std::memory_order_relaxed);
+      const std::size_t tail = m_tail.load(std::memory_order_acquire);
+
+      for (std::size_t i = head; i != tail; i++)
+      {
+         sink(std::move(m_data[i & MASK]));
+      }
+      if (tail != head)
+      {
+         m_head.store(tail, std::memory_order_release);
+      }
+
+      return tail - head;
+   }
+
+   /**
+    * @brief Gets a pointer to the item at the front of the ring buffer without popping it.
+    *
+    * Must only be called from the consumer thread, which is the only writer of the
+    * head index, so the returned entry stays valid until the consumer pops it.
+    *
+    * @return Pointer to the front item, or nullptr if the buffer was empty.
+    */
+   T *front()
+   {
+      const std::size_t head = m_head.load(std::memory_order_relaxed);
+      if (m_tail.load(std::memory_order_acquire) == head)
+      {
+         return nullptr;
+      }
+
+      return &m_data[head & MASK];
+   }
+
+private:
+   // Power-of-two slot count, so index reductions are a single mask. The
+   // logical capacity stays N; the rounding only ever adds unused slots.
+   static constexpr std::size_t STORAGE = next_power_of_two(N);
+   static constexpr std::size_t MASK = STORAGE - 1;
+
+   std::array<T, STORAGE> m_data{};
+
+   // Index of the next entry to pop, only written by the consumer. The
+   // indices increase monotonically and are masked on access. Aligned apart
+   // from the tail so pushes and pops do not false-share a cache line.
+   alignas(RING_INDEX_ALIGNMENT) std::atomic<std::size_t> m_head{ 0 };
+
+   // Index of the next free slot, only written by the producer.
+   alignas(RING_INDEX_ALIGNMENT) std::atomic<std::size_t> m_tail{ 0 };
+};
+
+/**
+ * @brief Lock-free multi-producer/single-consumer ring buffer.
+ *
+ * A fixed capacity ring buffer that allows several threads to push entries
+ * concurrently while one thread pops them, without any locking. Producers
+ * claim a slot by advancing the tail with a compare-and-swap and publish the
+ * entry by bumping the slot's sequence number; the consumer reads slots in
+ * order and recycles each sequence number once the entry has been taken, so
+ * a slow producer never makes the consumer observe a gap. The slot count is
+ * rounded up to a power of two so every index reduction is a mask, and the
+ * tail lives on its own cache line away from the consumer's head.
+ *
+ * @note Only a single consumer thread may pop at any time. T must be default
+ *       constructible.
+ */
+template <typename T, std::size_t N>
+class mpsc_ring_buffer
+{
+public:
+   mpsc_ring_buffer()
+   {
+      for (std::size_t i = 0; i < STORAGE; i++)
+      {
+         m_slots[i].sequence.store(i, std::memory_order_relaxed);
+      }
+   }
+
+   /**
+    * @brief Return maximum capacity of the ring buffer.
+    *
+    * The requested capacity rounded up to the next power of two; the sequence
+    * protocol tracks fullness per slot, so every slot is usable.
+    */
+   constexpr std::size_t capacity()
+   {
+      return STORAGE;
+   }
+
+   /**
+    * @brief Places item into next slot of the ring buffer.
+    *
+    * May be called from any number of producer threads concurrently.
+    *
+    * @return Boolean to indicate success or failure. Fails when the buffer
+    *         is full.
+    */
+   template <typename U>
+   bool push_back(U &&item)
+   {
+      std::size_t tail = m_tail.load(std::memory_order_relaxed);
+      while (true)
+      {
+         slot &entry = m_slots[tail & MASK];
+         const std::size_t sequence = entry.sequence.load(std::memory_order_acquire);
+         const std::ptrdiff_t diff =
+            static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(tail);
+         if (diff == 0)
+         {
+            if (m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+            {
+               entry.data = std::forward<U>(item);
+               entry.sequence.store(tail + 1, std::memory_order_release);
+               return true;
+            }
+         }
+         else if (diff < 0)
+         {
+            /* The slot still holds an entry the consumer has not taken. */
+            return false;
+         }
+         else
+         {
+            /* Another producer claimed this slot; reload and retry. */
+            tail = m_tail.load(std::memory_order_relaxed);
+         }
+      }
+   }
+
+   /**
+    * @brief Pop the front of the ring buffer.
+    *
+    * Must only be called from the consumer thread.
+    *
+    * @return Item wrapped in an optional, which is empty if no published
+    *         entry was available.
+    */
+   std::optional<T> pop_front()
+   {
+      slot &entry = m_slots[m_head & MASK];
+      const std::size_t sequence = entry.sequence.load(std::memory_order_acquire);
+      if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(m_head + 1) < 0)
+      {
+         return std::nullopt;
+      }
+
+      std::optional<T> value{ std::move(entry.data) };
+      entry.sequence.store(m_head + STORAGE, std::memory_order_release);
+      ++m_head;
+
+      return value;
+   }
+
+   /**
+    * @brief Pop every published entry as one batch.
+    *
+    * Must only be called from the consumer thread. @p sink is invoked once per
+    * entry, in claim order, with an rvalue reference to the entry. Each slot's
+    * sequence must still be recycled individually - producers wait on it - so
+    * unlike the SPSC drain this costs one atomic release per entry; the batch
+    * form saves the per-call optional and function overhead. Stops at the
+    * first slot whose producer has not published yet.
+    *
+    * @return The number of entries popped.
+    */
+   template <typename Sink>
+   std::size_t pop_all_into(Sink &&sink)
+   {
+      std::size_t popped = 0;
+      while (true)
+      {
+         slot &entry = m_slots[m_head & MASK];
+         const std::size_t sequence = entry.sequence.load(std::memory_order_acquire);
+         if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(m_head + 1) < 0)
+         {
+            return popped;
+         }
+
+         sink(std::move(entry.data));
+         entry.sequence.store(m_head + STORAGE, std::memory_order_release);
+         ++m_head;
+         ++popped;
+      }
+   }
+
+private:
+   // Power-of-two slot count, so index reductions are a single mask.
+   static constexpr std::size_t STORAGE = next_power_of_two(N);
+   static constexpr std::size_t MASK = STORAGE - 1;
+
+   struct slot
+   {
+      // Parity with the head/tail indices: slot index i starts at i, is set
+      // to claim-index + 1 when an entry is published and claim-index +
+      // STORAGE once the consumer has taken it, making it reusable one lap
+      // later.
+      std::atomic<std::size_t> sequence{ 0 };
+      T data{};
+   };
+
+   std::array<slot, STORAGE> m_slots{};
+
+   // Index of the next entry to pop, only accessed by the consumer. Aligned
+   // apart from the tail the producers hammer with CAS.
+   alignas(RING_INDEX_ALIGNMENT) std::size_t m_head{ 0 };
+
+   // Index of the next slot to claim, advanced by producers with CAS.
+   alignas(RING_INDEX_ALIGNMENT) std::atomic<std::size_t> m_tail{ 0 };
+};
+
 } /* namespace util */
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thread_scheduling.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "config.hpp"
+#include "log.hpp"
+
+namespace util
+{
+
+namespace
+{
+
+struct thread_scheduling_config
+{
+   /** SCHED_FIFO priority to apply, 0 to keep the default policy. */
+   int rt_priority{ 0 };
+   /** Whether an affinity mask was configured. */
+   bool have_affinity{ false };
+   /** The configured affinity mask. */
+   cpu_set_t affinity{};
+};
+
+/**
+ * @brief Parse a CPU list of the form "0,2,4-7" into a cpu_set_t.
+ *
+ * @return true if the whole string parsed and selected at least one CPU.
+ */
+bool parse_cpu_list(const char *list, cpu_set_t *set)
+{
+   CPU_ZERO(set);
+
+   const char *pos = list;
+   while (*pos != '\0')
+   {
+      char *end = nullptr;
+      long first = std::strtol(pos, &end, 10);
+      if (end == pos || first < 0 || first >= CPU_SETSIZE)
+      {
+         return false;
+      }
+
+      long last = first;
+      if (*end == '-')
+      {
+         pos = end + 1;
+         last = std::strtol(pos, &end, 10);
+         if (end == pos || last < first || last >= CPU_SETSIZE)
+         {
+            return false;
+         }
+      }
+
+      for (long cpu = first; cpu <= last; cpu++)
+      {
+         CPU_SET(cpu, set);
+      }
+
+      if (*end == ',')
+      {
+         end++;
+      }
+      else if (*end != '\0')
+      {
+         return false;
+      }
+      pos = end;
+   }
+
+   return CPU_COUNT(set) > 0;
+}
+
+const thread_scheduling_config &get_config()
+{
+   /* The configuration is read once; changing the knobs mid-run has no effect. */
+   static const thread_scheduling_config config = [] {
+      thread_scheduling_config cfg{};
+
+      if (const char *env = config::get().present_rt_priority())
+      {
+         char *end = nullptr;
+         long priority = std::strtol(env, &end, 10);
+         const int min_priority = sched_get_priority_min(SCHED_FIFO);
+         const int max_priority = sched_get_priority_max(SCHED_FIFO);
+         if (end == env || *end != '\0' || priority < min_priority || priority > max_priority)
+         {
+            WSI_LOG_WARNING("Ignoring VULKAN_WSI_PRESENT_RT_PRIORITY=%s, expected an integer in [%d, %d].", env,
+                            min_priority, max_priority);
+         }
+         else
+         {
+            cfg.rt_priority = static_cast<int>(priority);
+         }
+      }
+
+      if (const char *env = config::get().present_cpu_affinity())
+      {
+         if (parse_cpu_list(env, &cfg.affinity))
+         {
+            cfg.have_affinity = true;
+         }
+         else
+         {
+            WSI_LOG_WARNING("Ignoring VULKAN_WSI_PRESENT_CPU_AFFINITY=%s, expected a CPU list such as \"2,3\" or "
+                            "\"4-7\".",
+                            env);
+         }
+      }
+
+      return cfg;
+   }();
+   return config;
+}
+
+} /* namespace */
+
+void apply_presentation_thread_scheduling(const char *thread_name)
+{
+   const thread_scheduling_config &config = get_config();
+
+   if (config.rt_priority > 0)
+   {
+      struct sched_param param = {};
+      param.sched_priority = config.rt_priority;
+      int res = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+      if (res != 0)
+      {
+         /* Typically EPERM without CAP_SYS_NICE or an RTPRIO rlimit; keep the
+          * default policy and warn once rather than once per thread. */
+         static std::atomic<bool> warned{ false };
+         if (!warned.exchange(true))
+         {
+            WSI_LOG_WARNING("Could not set SCHED_FIFO priority %d on %s thread: %s. Continuing with the default "
+                            "scheduling policy.",
+                            config.rt_priority, thread_name, std::strerror(res));
+         }
+      }
+   }
+
+   if (config.have_affinity)
+   {
+      int res = pthread_setaffinity_np(pthread_self(), sizeof(config.affinity), &config.affinity);
+      if (res != 0)
+      {
+         static std::atomic<bool> warned{ false };
+         if (!warned.exchange(true))
+         {
+            WSI_LOG_WARNING("Could not set CPU affinity on %s thread: %s. Continuing with the default affinity.",
+                            thread_name, std::strerror(res));
+         }
+      }
+   }
+}
+
+} /* namespace util */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file thread_scheduling.hpp
+ *
+ * @brief Optional real-time scheduling and CPU affinity for presentation threads.
+ *
+ * On a loaded system the layer's presentation threads (page flip, present
+ * event, copy pool workers) compete with the application's render workers
+ * under the default scheduler, adding multiple milliseconds of present
+ * dispatch jitter. This helper applies an opt-in SCHED_FIFO priority and CPU
+ * affinity mask to the calling thread, configured through the environment:
+ *
+ *   VULKAN_WSI_PRESENT_RT_PRIORITY  SCHED_FIFO priority (1-99). Unset or 0
+ *                                   leaves the default policy in place.
+ *   VULKAN_WSI_PRESENT_CPU_AFFINITY Comma-separated CPU list, ranges allowed
+ *                                   (e.g. "2,3" or "4-7"). Unset leaves the
+ *                                   default affinity in place.
+ *
+ * Both knobs degrade gracefully: an unprivileged process that may not raise
+ * its scheduling class keeps running with the default policy and a single
+ * warning in the log.
+ */
+
+#pragma once
+
+namespace util
+{
+
+/**
+ * @brief Apply the configured scheduling policy and CPU affinity to the calling thread.
+ *
+ * Reads the configuration from the environment on first use and applies it to
+ * the thread invoking the call. Threads created before the first call are not
+ * retroactively adjusted, so call this at the top of each thread entry point.
+ *
+ * @param thread_name Short name for the thread, used in failure log messages.
+ */
+void apply_presentation_thread_scheduling(const char *thread_name);
+
+} /* namespace util */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, 2019, 2021-2022 Arm Limited.
+ * Copyright (c) 2017, 2019, 2021-2022, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -24,147 +24,217 @@
 
 #include <cassert>
 #include <cerrno>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "timed_semaphore.hpp"
 
 namespace util
 {
 
-VkResult timed_semaphore::init(unsigned count)
+namespace
 {
-   int res;
 
-   m_count = count;
+constexpr uint64_t NSEC_PER_SEC = 1000ull * 1000ull * 1000ull;
 
-   pthread_condattr_t attr;
-   res = pthread_condattr_init(&attr);
-   /* the only failure that can occur is ENOMEM */
-   assert(res == 0 || res == ENOMEM);
-   if (res != 0)
-   {
-      return VK_ERROR_OUT_OF_HOST_MEMORY;
-   }
+/* Bounds for the adaptive spin phase. The upper bound is small enough that a
+ * futile spin costs well under a scheduler timeslice. */
+constexpr uint32_t SPIN_LIMIT_MIN = 0;
+constexpr uint32_t SPIN_LIMIT_MAX = 1024;
 
-   res = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
-   /* only programming error can cause _setclock to fail */
-   assert(res == 0);
+long futex(std::atomic<uint32_t> *word, int op, uint32_t value, const struct timespec *timeout)
+{
+   return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), op, value, timeout, nullptr, 0);
+}
 
-   res = pthread_cond_init(&m_cond, &attr);
-   /* the only failure that can occur that is not programming error is ENOMEM */
-   assert(res == 0 || res == ENOMEM);
-   if (res != 0)
-   {
-      res = pthread_condattr_destroy(&attr);
-      assert(res == 0);
-      return VK_ERROR_OUT_OF_HOST_MEMORY;
-   }
+void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+   __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+   __asm__ __volatile__("yield");
+#endif
+}
 
-   res = pthread_condattr_destroy(&attr);
-   /* only programming error can cause _destroy to fail */
-   assert(res == 0);
+uint64_t monotonic_now_ns()
+{
+   struct timespec now = {};
+   int res = clock_gettime(CLOCK_MONOTONIC, &now);
+   assert(res == 0); /* only fails with programming error (EINVAL, EFAULT, EPERM) */
+   (void)res;
+   return static_cast<uint64_t>(now.tv_sec) * NSEC_PER_SEC + static_cast<uint64_t>(now.tv_nsec);
+}
 
-   res = pthread_mutex_init(&m_mutex, nullptr);
-   /* only programming errors can result in failure */
-   assert(res == 0);
+} /* anonymous namespace */
+
+VkResult timed_semaphore::init(unsigned count)
+{
+   m_count.store(count, std::memory_order_relaxed);
+   m_waiters.store(0, std::memory_order_relaxed);
+   m_spin_limit.store(SPIN_LIMIT_MIN, std::memory_order_relaxed);
 
    initialized = true;
 
    return VK_SUCCESS;
 }
 
-timed_semaphore::~timed_semaphore()
+bool timed_semaphore::try_wait()
 {
-   int res;
-   (void)res; /* unused when NDEBUG */
-
-   if (initialized)
+   uint32_t count = m_count.load(std::memory_order_relaxed);
+   while (count != 0)
    {
-      res = pthread_cond_destroy(&m_cond);
-      assert(res == 0); /* only programming error (EBUSY, EINVAL) */
-
-      res = pthread_mutex_destroy(&m_mutex);
-      assert(res == 0); /* only programming error (EBUSY, EINVAL) */
+      if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+      {
+         return true;
+      }
    }
+   return false;
 }
 
 VkResult timed_semaphore::wait(uint64_t timeout)
 {
-   VkResult retval = VK_SUCCESS;
-   int res;
-
    assert(initialized);
 
-   res = pthread_mutex_lock(&m_mutex);
-   assert(res == 0); /* only fails with programming error (EINVAL) */
+   if (try_wait())
+   {
+      return VK_SUCCESS;
+   }
 
-   if (m_count == 0)
+   if (timeout == 0)
    {
-      switch (timeout)
-      {
-      case 0:
-         retval = VK_NOT_READY;
-         break;
-      case UINT64_MAX:
-         res = pthread_cond_wait(&m_cond, &m_mutex);
-         assert(res == 0); /* only fails with programming error (EINVAL) */
+      return VK_NOT_READY;
+   }
 
-         break;
-      default:
-         struct timespec diff = { /* narrowing casts */
-                                  static_cast<time_t>(timeout / (1000 * 1000 * 1000)),
-                                  static_cast<long>(timeout % (1000 * 1000 * 1000))
-         };
+   /* Spin for a while before sleeping: at high frame rates the counter is
+    * usually posted again within microseconds, and a futex sleep/wake pair
+    * costs far more than that. Adapt the spin budget to the observed success
+    * rate so idle scenes do not burn CPU spinning. */
+   uint32_t spin_limit = m_spin_limit.load(std::memory_order_relaxed);
+   for (uint32_t spin = 0; spin < spin_limit; spin++)
+   {
+      if (try_wait())
+      {
+         m_spin_limit.store(spin_limit < SPIN_LIMIT_MAX ? spin_limit * 2 + 1 : SPIN_LIMIT_MAX,
+                            std::memory_order_relaxed);
+         return VK_SUCCESS;
+      }
+      cpu_relax();
+   }
+   /* Either the spin budget ran out or spinning is disabled, shrink it and
+    * give it another chance to grow next time a spin succeeds. */
+   m_spin_limit.store(spin_limit > SPIN_LIMIT_MIN + 1 ? spin_limit / 2 : SPIN_LIMIT_MIN + 1,
+                      std::memory_order_relaxed);
 
-         struct timespec now = {};
-         res = clock_gettime(CLOCK_MONOTONIC, &now);
-         assert(res == 0); /* only fails with programming error (EINVAL, EFAULT, EPERM) */
+   const bool indefinite = timeout == UINT64_MAX;
+   const uint64_t deadline = indefinite ? 0 : monotonic_now_ns() + timeout;
 
-         /* add diff to now, handling overflow */
-         struct timespec end = { now.tv_sec + diff.tv_sec, now.tv_nsec + diff.tv_nsec };
+   m_waiters.fetch_add(1, std::memory_order_seq_cst);
 
-         if (end.tv_nsec >= 1000 * 1000 * 1000)
-         {
-            end.tv_nsec -= 1000 * 1000 * 1000;
-            end.tv_sec++;
-         }
+   VkResult retval = VK_SUCCESS;
+   while (true)
+   {
+      if (try_wait())
+      {
+         break;
+      }
 
-         res = pthread_cond_timedwait(&m_cond, &m_mutex, &end);
-         /* only fails with programming error, other than timeout */
-         assert(res == 0 || res == ETIMEDOUT);
-         if (res != 0)
+      struct timespec remaining_ts = {};
+      const struct timespec *remaining = nullptr;
+      if (!indefinite)
+      {
+         uint64_t now = monotonic_now_ns();
+         if (now >= deadline)
          {
             retval = VK_TIMEOUT;
+            break;
          }
+         uint64_t remaining_ns = deadline - now;
+         remaining_ts.tv_sec = static_cast<time_t>(remaining_ns / NSEC_PER_SEC);
+         remaining_ts.tv_nsec = static_cast<long>(remaining_ns % NSEC_PER_SEC);
+         remaining = &remaining_ts;
       }
+
+      /* FUTEX_WAIT timeouts are relative and measured against CLOCK_MONOTONIC,
+       * so a system time change cannot distort the wait. */
+      long res = futex(&m_count, FUTEX_WAIT_PRIVATE, 0, remaining);
+      /* EAGAIN means the counter changed before we slept, EINTR that a signal
+       * woke us; both just mean "try again". A timeout is detected by the
+       * deadline check above so the extra try_wait after ETIMEDOUT gives one
+       * last chance to a post racing the expiry. */
+      assert(res == 0 || errno == EAGAIN || errno == EINTR || errno == ETIMEDOUT);
+      (void)res;
+   }
+
+   m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+
+   return retval;
+}
+
+VkResult timed_semaphore::spin_wait(uint64_t spin_ns)
+{
+   assert(initialized);
+
+   if (try_wait())
+   {
+      return VK_SUCCESS;
    }
-   if (retval == VK_SUCCESS)
+
+   if (spin_ns == 0)
    {
-      assert(m_count > 0);
-      m_count--;
+      return VK_NOT_READY;
    }
-   res = pthread_mutex_unlock(&m_mutex);
-   assert(res == 0); /* only fails with programming error (EPERM) */
 
-   return retval;
+   const uint64_t deadline = monotonic_now_ns() + spin_ns;
+   do
+   {
+      /* Only read the clock every few iterations, a clock_gettime per relax
+       * would dominate the loop. */
+      for (uint32_t spin = 0; spin < 64; spin++)
+      {
+         if (try_wait())
+         {
+            return VK_SUCCESS;
+         }
+         cpu_relax();
+      }
+   } while (monotonic_now_ns() < deadline);
+
+   return VK_NOT_READY;
 }
 
 void timed_semaphore::post()
 {
-   int res;
-   (void)res; /* unused when NDEBUG */
-
    assert(initialized);
 
-   res = pthread_mutex_lock(&m_mutex);
-   assert(res == 0); /* only fails with programming error (EINVAL) */
+   m_count.fetch_add(1, std::memory_order_seq_cst);
 
-   m_count++;
+   if (m_waiters.load(std::memory_order_seq_cst) > 0)
+   {
+      futex(&m_count, FUTEX_WAKE_PRIVATE, 1, nullptr);
+   }
+}
 
-   res = pthread_cond_signal(&m_cond);
-   assert(res == 0); /* only fails with programming error (EINVAL) */
+void timed_semaphore::post(uint32_t count)
+{
+   assert(initialized);
+
+   if (count == 0)
+   {
+      return;
+   }
+
+   m_count.fetch_add(count, std::memory_order_seq_cst);
 
-   res = pthread_mutex_unlock(&m_mutex);
-   assert(res == 0); /* only fails with programming error (EPERM) */
+   /* A single wake for the whole batch: the kernel wakes up to count threads
+    * from the futex queue, so posting n resources costs one syscall rather
+    * than n lock-step post/wake cycles. */
+   if (m_waiters.load(std::memory_order_seq_cst) > 0)
+   {
+      futex(&m_count, FUTEX_WAKE_PRIVATE, count, nullptr);
+   }
 }
 
 } /* namespace util */
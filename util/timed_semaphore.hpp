@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, 2019, 2024 Arm Limited.
+ * Copyright (c) 2017, 2019, 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -32,16 +32,16 @@
  * as the system time may change, resulting in an incorrect timeout period
  * (potentially by a significant amount).
  *
- * We therefore have to re-engineer semaphores using condition variables.
+ * We therefore implement the semaphore on top of an atomic counter and the
+ * futex syscall, whose relative timeouts are measured against CLOCK_MONOTONIC.
  *
  * This code does not use the C++ standard library to avoid exceptions.
  */
 
 #pragma once
 
-extern "C" {
-#include <pthread.h>
-}
+#include <atomic>
+#include <cstdint>
 
 #include <vulkan/vulkan.h>
 #include "helpers.hpp"
@@ -50,21 +50,20 @@ namespace util
 {
 
 /**
- * brief semaphore with a safe relative timed wait
+ * @brief semaphore with a safe relative timed wait
  *
- * sem_timedwait takes an absolute time, based on CLOCK_REALTIME. Simply
- * taking the current time and adding on a relative timeout is not correct,
- * as the system time may change, resulting in an incorrect timeout period
- * (potentially by a significant amount).
- *
- * We therefore have to re-engineer semaphores using condition variables.
- *
- * This code does not use the C++ standard library to avoid exceptions.
+ * The semaphore value is an atomic counter: posts and uncontended waits are a
+ * single atomic operation with no syscall. A waiter that finds the counter at
+ * zero first spins briefly - the spin length adapts to how often spinning pays
+ * off - and only then sleeps on a futex. Producer/consumer pairs that post
+ * within microseconds of the wait (for example the page flip thread recycling
+ * a buffer right as acquire_next_image blocks) are therefore handled entirely
+ * in user space.
  */
 class timed_semaphore : private noncopyable
 {
 public:
-   ~timed_semaphore();
+   ~timed_semaphore() = default;
    timed_semaphore()
       : initialized(false){};
 
@@ -72,7 +71,6 @@ public:
     * @brief initializes the semaphore
     *
     * @param count initial value of the semaphore
-    * @retval VK_ERROR_OUT_OF_HOST_MEMORY out of memory condition from pthread calls
     * @retval VK_SUCCESS on success
     */
    VkResult init(unsigned count);
@@ -87,25 +85,69 @@ public:
     */
    VkResult wait(uint64_t timeout);
 
+   /**
+    * @brief decrement semaphore, busy-polling for up to a time budget without sleeping
+    *
+    * Unlike wait(), the calling thread never goes to sleep: it polls the counter
+    * with a cpu relax between attempts until the budget runs out. Intended for
+    * callers that know the expected post latency and want to avoid the futex
+    * sleep/wake round trip when a post is imminent.
+    *
+    * @param spin_ns maximum time to busy-poll (ns). 0 only tries once.
+    * @retval VK_NOT_READY the budget ran out with the count still 0
+    * @retval VK_SUCCESS on success
+    */
+   VkResult spin_wait(uint64_t spin_ns);
+
    /**
     * @brief increment semaphore, potentially unblocking a waiting thread
     */
    void post();
 
+   /**
+    * @brief increment semaphore by @p count, potentially unblocking waiting threads
+    *
+    * Equivalent to @p count calls to post(), but performed as a single counter
+    * add and at most one wake syscall. Useful when several resources become
+    * available at once, e.g. a batch of swapchain images being released.
+    *
+    * @param count amount to add to the semaphore value.
+    */
+   void post(uint32_t count);
+
 private:
    /**
-    * @brief true if the semaphore has been initialized
+    * @brief try to decrement the counter without blocking
     *
-    * Determines if the destructor should cleanup the mutex and cond.
+    * @return true if the counter was decremented, false if it was 0.
+    */
+   bool try_wait();
+
+   /**
+    * @brief true if the semaphore has been initialized
     */
    bool initialized;
+
    /**
-    * @brief semaphore value
+    * @brief semaphore value, also used as the futex word
     */
-   unsigned m_count;
+   std::atomic<uint32_t> m_count{ 0 };
 
-   pthread_mutex_t m_mutex;
-   pthread_cond_t m_cond;
+   /**
+    * @brief number of threads that are sleeping, or about to sleep, on the futex
+    *
+    * Lets post() skip the wake syscall when nobody is waiting.
+    */
+   std::atomic<uint32_t> m_waiters{ 0 };
+
+   /**
+    * @brief current number of spin iterations to attempt before sleeping
+    *
+    * Grown each time spinning acquires the semaphore and shrunk each time the
+    * waiter ends up sleeping anyway, so busy producer/consumer pairs spin
+    * longer while idle ones fall through to the futex almost immediately.
+    */
+   std::atomic<uint32_t> m_spin_limit{ 0 };
 };
 
 } /* namespace util */
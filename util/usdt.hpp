@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief USDT tracepoints for the presentation hot path.
+ *
+ * When the layer is built with ENABLE_WSI_USDT each probe compiles to a
+ * single nop plus an ELF note, so the probes can ship in production builds:
+ * they cost nothing until a tracer (perf, bpftrace, or perfetto's
+ * traced_probes) attaches, at which point layer activity lines up against
+ * compositor and GPU tracks in a system-wide trace.
+ *
+ * All probes live under the "vulkan_wsi" provider and carry the swapchain
+ * address as their first argument, so the per-swapchain streams can be
+ * separated and an image's journey (queue_present -> present_dispatch ->
+ * present_submit -> buffer_release) correlated by image index and present id.
+ *
+ * Requires systemtap's <sys/sdt.h> at build time; without ENABLE_WSI_USDT the
+ * macros expand to nothing.
+ */
+
+#pragma once
+
+#if ENABLE_WSI_USDT
+
+#include <sys/sdt.h>
+
+#define WSI_USDT2(name, arg1, arg2) DTRACE_PROBE2(vulkan_wsi, name, arg1, arg2)
+#define WSI_USDT3(name, arg1, arg2, arg3) DTRACE_PROBE3(vulkan_wsi, name, arg1, arg2, arg3)
+
+#else
+
+#define WSI_USDT2(name, arg1, arg2)
+#define WSI_USDT3(name, arg1, arg2, arg3)
+
+#endif /* ENABLE_WSI_USDT */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2024 Arm Limited.
+ * Copyright (c) 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -50,16 +50,23 @@ struct present_mode_compatibility
    std::array<VkPresentModeKHR, MAX_PRESENT_MODES> compatible_present_modes;
 };
 
-template <std::size_t SIZE>
+/**
+ * @brief Non-owning view of a backend's present mode compatibility table.
+ *
+ * The compatibility relation is fixed per backend, so each backend defines one
+ * constexpr table at file scope and every surface_properties instance just
+ * points at it: the EXT_surface_maintenance1 queries perform no allocation and
+ * no construction.
+ */
 class compatible_present_modes
 {
 public:
-   compatible_present_modes()
-   {
-   }
+   constexpr compatible_present_modes() = default;
 
-   compatible_present_modes(std::array<present_mode_compatibility, SIZE> present_mode_compatibilites)
-      : m_present_mode_compatibilites(present_mode_compatibilites)
+   template <std::size_t SIZE>
+   constexpr compatible_present_modes(const std::array<present_mode_compatibility, SIZE> &present_mode_compatibilites)
+      : m_present_mode_compatibilites(present_mode_compatibilites.data())
+      , m_present_mode_compatibilites_count(SIZE)
    {
    }
 
@@ -75,7 +82,7 @@ public:
     *
     */
    void get_surface_present_mode_compatibility_common(const VkPhysicalDeviceSurfaceInfo2KHR *pSurfaceInfo,
-                                                      VkSurfaceCapabilities2KHR *pSurfaceCapabilities)
+                                                      VkSurfaceCapabilities2KHR *pSurfaceCapabilities) const
    {
       auto surface_present_mode =
          util::find_extension<VkSurfacePresentModeEXT>(VK_STRUCTURE_TYPE_SURFACE_PRESENT_MODE_EXT, pSurfaceInfo);
@@ -88,9 +95,9 @@ public:
       }
 
       VkPresentModeKHR present_mode = surface_present_mode->presentMode;
-      auto it = std::find_if(m_present_mode_compatibilites.begin(), m_present_mode_compatibilites.end(),
+      auto it = std::find_if(begin(), end(),
                              [present_mode](present_mode_compatibility p) { return p.present_mode == present_mode; });
-      if (it == m_present_mode_compatibilites.end())
+      if (it == end())
       {
          WSI_LOG_ERROR("Querying compatible presentation mode support for a presentation mode that is not supported.");
          return;
@@ -119,12 +126,12 @@ public:
     *
     * @return true if compatible, false otherwise.
     */
-   bool is_compatible_present_modes(VkPresentModeKHR present_mode_a, VkPresentModeKHR present_mode_b)
+   bool is_compatible_present_modes(VkPresentModeKHR present_mode_a, VkPresentModeKHR present_mode_b) const
    {
       auto it =
-         std::find_if(m_present_mode_compatibilites.begin(), m_present_mode_compatibilites.end(),
+         std::find_if(begin(), end(),
                       [present_mode_a](present_mode_compatibility p) { return p.present_mode == present_mode_a; });
-      if (it == m_present_mode_compatibilites.end())
+      if (it == end())
       {
          WSI_LOG_ERROR("Querying compatible presentation mode support for a presentation mode that is not supported.");
          return false;
@@ -139,7 +146,19 @@ public:
    }
 
 private:
-   std::array<present_mode_compatibility, SIZE> m_present_mode_compatibilites;
+   const present_mode_compatibility *begin() const
+   {
+      return m_present_mode_compatibilites;
+   }
+
+   const present_mode_compatibility *end() const
+   {
+      return m_present_mode_compatibilites + m_present_mode_compatibilites_count;
+   }
+
+   /* Points at a backend's file-scope constexpr table; never owned. */
+   const present_mode_compatibility *m_present_mode_compatibilites = nullptr;
+   std::size_t m_present_mode_compatibilites_count = 0;
 };
 
 } // namespace wsi
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2024 Arm Limited.
+ * Copyright (c) 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -23,18 +23,30 @@
  */
 
 #include "drm_display.hpp"
+#include "util/config.hpp"
 #include "util/custom_allocator.hpp"
 #include "wsi/surface.hpp"
 
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <sys/sysmacros.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <assert.h>
 #include <mutex>
 #include <drm_fourcc.h>
+
+/* Older libdrm headers predate the atomic async flip capability (Linux 6.8);
+ * the kernel simply reports 0 for capabilities it does not know. */
+#ifndef DRM_CAP_ATOMIC_ASYNC_PAGE_FLIP
+#define DRM_CAP_ATOMIC_ASYNC_PAGE_FLIP 0x15
+#endif
+
 namespace wsi
 {
 
@@ -43,19 +55,39 @@ namespace display
 
 const std::string default_dri_device_name{ "/dev/dri/card0" };
 
+/* Highest /dev/dri/cardN minor probed when no display device is configured. */
+constexpr int MAX_PROBED_DRI_DEVICES = 8;
+
+/* Guards the cached connector state against concurrent display property queries.
+ * It cannot be a drm_display member as the class relies on its defaulted move
+ * operations during creation. */
+static std::mutex connector_state_mutex;
+
 drm_display::drm_display(util::fd_owner drm_fd, int crtc_id, drm_connector_owner drm_connector,
                          util::unique_ptr<util::vector<drm_format_pair>> supported_formats,
                          util::unique_ptr<drm_display_mode> display_modes, size_t num_display_modes, uint32_t max_width,
-                         uint32_t max_height, bool supports_fb_modifiers)
+                         uint32_t max_height, bool supports_fb_modifiers,
+                         util::unique_ptr<util::vector<display_plane>> planes, bool supports_atomic,
+                         bool supports_async_flip, uint32_t crtc_vrr_enabled_prop_id,
+                         VkSurfaceTransformFlagBitsKHR panel_transform, uint64_t panel_rotation,
+                         util::fd_owner uevent_fd)
    : m_drm_fd(std::move(drm_fd))
    , m_crtc_id(crtc_id)
    , m_drm_connector(std::move(drm_connector))
    , m_supported_formats(std::move(supported_formats))
    , m_display_modes(std::move(display_modes))
    , m_num_display_modes(num_display_modes)
+   , m_display_mode_capacity(num_display_modes)
+   , m_uevent_fd(std::move(uevent_fd))
    , m_max_width(max_width)
    , m_max_height(max_height)
    , m_supports_fb_modifiers(supports_fb_modifiers)
+   , m_planes(std::move(planes))
+   , m_supports_atomic(supports_atomic)
+   , m_supports_async_flip(supports_async_flip)
+   , m_crtc_vrr_enabled_prop_id(crtc_vrr_enabled_prop_id)
+   , m_panel_transform(panel_transform)
+   , m_panel_rotation(panel_rotation)
 {
 }
 
@@ -146,6 +178,203 @@ static bool find_primary_plane(const util::fd_owner &drm_fd, const drm_plane_res
    return false;
 }
 
+/**
+ * @brief Utility function to find the id of a named property on a DRM object.
+ *
+ * @return true if the property was found, otherwise false.
+ */
+static bool find_object_property_id(int fd, uint32_t object_id, uint32_t object_type, const char *name,
+                                    uint32_t *prop_id)
+{
+   drm_object_properties_owner props{ drmModeObjectGetProperties(fd, object_id, object_type) };
+   if (props == nullptr)
+   {
+      return false;
+   }
+
+   for (uint32_t i = 0; i < props->count_props; i++)
+   {
+      drm_property_owner prop{ drmModeGetProperty(fd, props->props[i]) };
+      if (prop != nullptr && !strcmp(prop->name, name))
+      {
+         *prop_id = prop->prop_id;
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/**
+ * @brief Utility function to read the value of a named property on a DRM object.
+ *
+ * @return true if the property was found, otherwise false.
+ */
+static bool find_object_property_value(int fd, uint32_t object_id, uint32_t object_type, const char *name,
+                                       uint64_t *value)
+{
+   drm_object_properties_owner props{ drmModeObjectGetProperties(fd, object_id, object_type) };
+   if (props == nullptr)
+   {
+      return false;
+   }
+
+   for (uint32_t i = 0; i < props->count_props; i++)
+   {
+      drm_property_owner prop{ drmModeGetProperty(fd, props->props[i]) };
+      if (prop != nullptr && !strcmp(prop->name, name))
+      {
+         *value = props->prop_values[i];
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/**
+ * @brief Look up every property id needed for atomic commits.
+ *
+ * @return true if all mandatory properties were found, otherwise false.
+ */
+static bool fill_atomic_properties(int fd, uint32_t plane_id, uint32_t crtc_id, uint32_t connector_id,
+                                   drm_atomic_properties &props)
+{
+   const bool found_mandatory =
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "FB_ID", &props.plane_fb_id) &&
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_ID", &props.plane_crtc_id) &&
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "SRC_X", &props.plane_src_x) &&
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "SRC_Y", &props.plane_src_y) &&
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "SRC_W", &props.plane_src_w) &&
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "SRC_H", &props.plane_src_h) &&
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_X", &props.plane_crtc_x) &&
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_Y", &props.plane_crtc_y) &&
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_W", &props.plane_crtc_w) &&
+      find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_H", &props.plane_crtc_h) &&
+      find_object_property_id(fd, crtc_id, DRM_MODE_OBJECT_CRTC, "MODE_ID", &props.crtc_mode_id) &&
+      find_object_property_id(fd, crtc_id, DRM_MODE_OBJECT_CRTC, "ACTIVE", &props.crtc_active) &&
+      find_object_property_id(fd, connector_id, DRM_MODE_OBJECT_CONNECTOR, "CRTC_ID", &props.connector_crtc_id);
+
+   /* Explicit fencing is optional: without it a commit simply relies on the
+    * present payload wait that happens on the page flip thread. */
+   if (!find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "IN_FENCE_FD", &props.plane_in_fence_fd))
+   {
+      props.plane_in_fence_fd = 0;
+   }
+
+   /* Damage hints are optional: without them every flip simply updates the
+    * whole plane, as it always did. */
+   if (!find_object_property_id(fd, plane_id, DRM_MODE_OBJECT_PLANE, "FB_DAMAGE_CLIPS", &props.plane_fb_damage_clips))
+   {
+      props.plane_fb_damage_clips = 0;
+   }
+
+   return found_mandatory;
+}
+
+/**
+ * @brief Look up a plane's rotation property and the rotations it accepts.
+ *
+ * The property is a bitmask whose enum entries name the supported rotations
+ * and reflections; the mask is rebuilt from those entries rather than assumed,
+ * as most hardware only exposes a subset of the DRM_MODE_ROTATE_* values.
+ *
+ * @param[out] prop_id             Id of the rotation property, 0 when absent.
+ * @param[out] supported_rotations Bitmask of supported DRM_MODE_ROTATE_* /
+ *                                 DRM_MODE_REFLECT_* values, 0 when absent.
+ */
+static void find_plane_rotations(int fd, uint32_t plane_id, uint32_t *prop_id, uint64_t *supported_rotations)
+{
+   *prop_id = 0;
+   *supported_rotations = 0;
+
+   drm_object_properties_owner props{ drmModeObjectGetProperties(fd, plane_id, DRM_MODE_OBJECT_PLANE) };
+   if (props == nullptr)
+   {
+      return;
+   }
+
+   for (uint32_t i = 0; i < props->count_props; i++)
+   {
+      drm_property_owner prop{ drmModeGetProperty(fd, props->props[i]) };
+      if (prop == nullptr || strcmp(prop->name, "rotation") != 0)
+      {
+         continue;
+      }
+
+      *prop_id = prop->prop_id;
+      for (int j = 0; j < prop->count_enums; j++)
+      {
+         *supported_rotations |= 1ull << prop->enums[j].value;
+      }
+      return;
+   }
+}
+
+/**
+ * @brief Map the connector's "panel orientation" property to a surface transform.
+ *
+ * The orientation describes how the panel is physically mounted; the returned
+ * transform is what applications should pre-rotate their content by, with the
+ * plane rotation value that undoes it during scanout. DRM rotations are
+ * counter-clockwise while Vulkan transforms are clockwise, so the pairs are
+ * inverses of each other. The property's enum values are not part of the DRM
+ * uapi, so the current value is matched against the enum entry names.
+ *
+ * @param[out] transform Transform for the panel orientation, identity when the
+ *                       property is absent or reports a normal mounting.
+ * @param[out] rotation  Plane rotation that applies @p transform.
+ */
+static void find_panel_transform(int fd, uint32_t connector_id, VkSurfaceTransformFlagBitsKHR *transform,
+                                 uint64_t *rotation)
+{
+   *transform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+   *rotation = DRM_MODE_ROTATE_0;
+
+   uint64_t orientation = 0;
+   if (!find_object_property_value(fd, connector_id, DRM_MODE_OBJECT_CONNECTOR, "panel orientation", &orientation))
+   {
+      return;
+   }
+
+   uint32_t prop_id = 0;
+   if (!find_object_property_id(fd, connector_id, DRM_MODE_OBJECT_CONNECTOR, "panel orientation", &prop_id))
+   {
+      return;
+   }
+
+   drm_property_owner prop{ drmModeGetProperty(fd, prop_id) };
+   if (prop == nullptr)
+   {
+      return;
+   }
+
+   for (int i = 0; i < prop->count_enums; i++)
+   {
+      if (prop->enums[i].value != orientation)
+      {
+         continue;
+      }
+
+      if (strcmp(prop->enums[i].name, "Upside Down") == 0)
+      {
+         *transform = VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR;
+         *rotation = DRM_MODE_ROTATE_180;
+      }
+      else if (strcmp(prop->enums[i].name, "Left Side Up") == 0)
+      {
+         *transform = VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR;
+         *rotation = DRM_MODE_ROTATE_90;
+      }
+      else if (strcmp(prop->enums[i].name, "Right Side Up") == 0)
+      {
+         *transform = VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR;
+         *rotation = DRM_MODE_ROTATE_270;
+      }
+      return;
+   }
+}
+
 static bool fill_supported_formats(const drm_plane_owner &primary_plane,
                                    util::vector<drm_format_pair> &supported_formats)
 {
@@ -202,6 +431,68 @@ static bool fill_supported_formats_with_modifiers(uint32_t primary_plane_index,
    return true;
 }
 
+/**
+ * @brief Check whether a DRM node has a connected connector.
+ *
+ * Used to pick the display device on multi-GPU systems: discrete GPUs without
+ * outputs wired to them expose no connected connectors, while the device that
+ * actually drives the panel does.
+ *
+ * @return true if the node could be opened and reports a connected connector.
+ */
+static bool device_has_connected_connector(const char *drm_device)
+{
+   util::fd_owner drm_fd{ open(drm_device, O_RDWR | O_CLOEXEC, 0) };
+   if (!drm_fd.is_valid())
+   {
+      return false;
+   }
+
+   drm_resources_owner resources{ drmModeGetResources(drm_fd.get()) };
+   if (resources == nullptr)
+   {
+      /* Render-only nodes expose no mode resources. */
+      return false;
+   }
+
+   for (int i = 0; i < resources->count_connectors; i++)
+   {
+      drm_connector_owner connector{ drmModeGetConnector(drm_fd.get(), resources->connectors[i]) };
+      if (connector != nullptr && connector->connection == DRM_MODE_CONNECTED)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+/**
+ * @brief Open a non-blocking kernel uevent socket subscribed to hotplug events.
+ *
+ * @return The socket fd owner, which is invalid when the socket could not be created.
+ */
+static util::fd_owner open_uevent_socket()
+{
+   util::fd_owner uevent_fd{ socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT) };
+   if (!uevent_fd.is_valid())
+   {
+      return uevent_fd;
+   }
+
+   struct sockaddr_nl addr = {};
+   addr.nl_family = AF_NETLINK;
+   /* Group 1 is where the kernel broadcasts uevents. */
+   addr.nl_groups = 1;
+
+   if (bind(uevent_fd.get(), reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0)
+   {
+      return util::fd_owner{};
+   }
+
+   return uevent_fd;
+}
+
 std::optional<drm_display> drm_display::make_display(const util::allocator &allocator, const char *drm_device)
 {
    util::fd_owner drm_fd{ open(drm_device, O_RDWR | O_CLOEXEC, 0) };
@@ -307,6 +598,139 @@ std::optional<drm_display> drm_display::make_display(const util::allocator &allo
    assert(primary_plane != nullptr);
    assert(primary_plane_index != std::numeric_limits<uint32_t>::max());
 
+   const uint32_t primary_plane_id = plane_res->planes[primary_plane_index];
+
+   /* Probe the atomic modesetting API and cache the property ids needed to
+    * build commits. On failure the swapchain falls back to legacy page flips. */
+   bool supports_atomic = false;
+   drm_atomic_properties atomic_props = {};
+   if (drmSetClientCap(drm_fd.get(), DRM_CLIENT_CAP_ATOMIC, 1) == 0)
+   {
+      supports_atomic = fill_atomic_properties(drm_fd.get(), primary_plane_id, static_cast<uint32_t>(crtc_id),
+                                               connector->connector_id, atomic_props);
+   }
+
+   if (!supports_atomic)
+   {
+      WSI_LOG_WARNING("DRM atomic modesetting not available, using legacy page flips.");
+   }
+
+   /* Rotated scanout needs atomic commits, as the legacy ioctls cannot set
+    * plane properties. */
+   uint64_t primary_plane_rotations = 0;
+   if (supports_atomic)
+   {
+      find_plane_rotations(drm_fd.get(), primary_plane_id, &atomic_props.plane_rotation, &primary_plane_rotations);
+   }
+
+   /* Report the panel's native orientation only when the primary plane can
+    * undo the matching pre-rotation in hardware; otherwise keep identity so
+    * applications never pre-rotate into a transform the display cannot apply. */
+   VkSurfaceTransformFlagBitsKHR panel_transform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+   uint64_t panel_rotation = DRM_MODE_ROTATE_0;
+   if (atomic_props.plane_rotation != 0)
+   {
+      find_panel_transform(drm_fd.get(), connector->connector_id, &panel_transform, &panel_rotation);
+      if ((primary_plane_rotations & panel_rotation) == 0)
+      {
+         panel_transform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+         panel_rotation = DRM_MODE_ROTATE_0;
+      }
+      else if (panel_transform != VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)
+      {
+         WSI_LOG_INFO("Panel is mounted rotated; advertising pre-rotation with hardware plane rotation.");
+      }
+   }
+
+   /* Variable refresh needs atomic commits: VRR_ENABLED is a CRTC property and
+    * the legacy ioctls have no way to set it. The property id is cached so the
+    * presentation path can toggle VRR without re-querying the property lists. */
+   uint32_t crtc_vrr_enabled_prop_id = 0;
+   uint64_t vrr_capable = 0;
+   if (supports_atomic &&
+       find_object_property_value(drm_fd.get(), connector->connector_id, DRM_MODE_OBJECT_CONNECTOR, "vrr_capable",
+                                  &vrr_capable) &&
+       vrr_capable != 0)
+   {
+      if (!find_object_property_id(drm_fd.get(), static_cast<uint32_t>(crtc_id), DRM_MODE_OBJECT_CRTC, "VRR_ENABLED",
+                                   &crtc_vrr_enabled_prop_id))
+      {
+         crtc_vrr_enabled_prop_id = 0;
+      }
+   }
+
+   /* Asynchronous page flips back VK_PRESENT_MODE_IMMEDIATE_KHR. The atomic
+    * API gates them behind its own capability, so probe the one matching the
+    * commit path the swapchain will use. */
+   bool supports_async_flip = false;
+   uint64_t async_flip_cap = 0;
+   if (drmGetCap(drm_fd.get(), supports_atomic ? DRM_CAP_ATOMIC_ASYNC_PAGE_FLIP : DRM_CAP_ASYNC_PAGE_FLIP,
+                 &async_flip_cap) == 0)
+   {
+      supports_async_flip = async_flip_cap != 0;
+   }
+
+   auto planes = allocator.make_unique<util::vector<display_plane>>(allocator);
+   if (planes == nullptr || !planes->try_push_back({ primary_plane_id, true, atomic_props, primary_plane_rotations }))
+   {
+      WSI_LOG_ERROR("Failed to allocate memory for display planes.");
+      return std::nullopt;
+   }
+
+   /* Expose overlay planes compatible with the chosen CRTC so swapchains can be routed to
+    * separate hardware planes and composed by the display controller. The legacy page flip
+    * ioctl only drives the primary plane, so overlays require atomic commits. */
+   if (supports_atomic)
+   {
+      uint32_t crtc_index = 0;
+      for (int i = 0; i < resources->count_crtcs; i++)
+      {
+         if (resources->crtcs[i] == static_cast<uint32_t>(crtc_id))
+         {
+            crtc_index = static_cast<uint32_t>(i);
+            break;
+         }
+      }
+
+      for (uint32_t i = 0; i < plane_res->count_planes; i++)
+      {
+         if (i == primary_plane_index)
+         {
+            continue;
+         }
+
+         drm_plane_owner plane{ drmModeGetPlane(drm_fd.get(), plane_res->planes[i]) };
+         if (plane == nullptr || !(plane->possible_crtcs & (1u << crtc_index)))
+         {
+            continue;
+         }
+
+         uint64_t plane_type = 0;
+         if (!find_object_property_value(drm_fd.get(), plane_res->planes[i], DRM_MODE_OBJECT_PLANE, "type",
+                                         &plane_type) ||
+             plane_type != DRM_PLANE_TYPE_OVERLAY)
+         {
+            continue;
+         }
+
+         drm_atomic_properties overlay_props = {};
+         if (!fill_atomic_properties(drm_fd.get(), plane_res->planes[i], static_cast<uint32_t>(crtc_id),
+                                     connector->connector_id, overlay_props))
+         {
+            continue;
+         }
+
+         uint64_t overlay_rotations = 0;
+         find_plane_rotations(drm_fd.get(), plane_res->planes[i], &overlay_props.plane_rotation, &overlay_rotations);
+
+         if (!planes->try_push_back({ plane_res->planes[i], false, overlay_props, overlay_rotations }))
+         {
+            WSI_LOG_ERROR("Failed to allocate memory for display planes.");
+            return std::nullopt;
+         }
+      }
+   }
+
    bool supports_fb_modifiers = false;
 
 #if WSI_DISPLAY_SUPPORT_FORMAT_MODIFIERS
@@ -340,10 +764,28 @@ std::optional<drm_display> drm_display::make_display(const util::allocator &allo
 
    std::copy(display_modes.begin(), display_modes.end(), display_modes_mem.get());
 
-   drm_display display{
-      std::move(drm_fd),    crtc_id,   std::move(connector), std::move(supported_formats), std::move(display_modes_mem),
-      display_modes.size(), max_width, max_height,           supports_fb_modifiers
-   };
+   util::fd_owner uevent_fd = open_uevent_socket();
+   if (!uevent_fd.is_valid())
+   {
+      WSI_LOG_WARNING("Failed to open uevent socket, display hotplug events will not be detected.");
+   }
+
+   drm_display display{ std::move(drm_fd),
+                        crtc_id,
+                        std::move(connector),
+                        std::move(supported_formats),
+                        std::move(display_modes_mem),
+                        display_modes.size(),
+                        max_width,
+                        max_height,
+                        supports_fb_modifiers,
+                        std::move(planes),
+                        supports_atomic,
+                        supports_async_flip,
+                        crtc_vrr_enabled_prop_id,
+                        panel_transform,
+                        panel_rotation,
+                        std::move(uevent_fd) };
 
    return std::make_optional(std::move(display));
 }
@@ -354,13 +796,41 @@ std::optional<drm_display> &drm_display::get_display()
    static std::optional<drm_display> display{ std::nullopt };
 
    std::call_once(flag, []() {
-      const char *dri_device = std::getenv("WSI_DISPLAY_DRI_DEV");
-      if (!dri_device)
+      const char *dri_device = util::config::get().display_dri_device();
+      if (dri_device != nullptr)
       {
-         dri_device = default_dri_device_name.c_str();
+         display = drm_display::make_display(util::allocator::get_generic(), dri_device);
+         return;
+      }
+
+      /* Without an explicit override, scan the card nodes for one with a
+       * connected connector. On hybrid systems the panel is typically wired to
+       * the integrated GPU, which is not guaranteed to be card0 - probing by
+       * connector state selects the scanout device regardless of enumeration
+       * order and skips render-only GPUs. */
+      for (int card = 0; card < MAX_PROBED_DRI_DEVICES; card++)
+      {
+         char device_name[32];
+         std::snprintf(device_name, sizeof(device_name), "/dev/dri/card%d", card);
+         if (!device_has_connected_connector(device_name))
+         {
+            continue;
+         }
+
+         display = drm_display::make_display(util::allocator::get_generic(), device_name);
+         if (display.has_value())
+         {
+            if (default_dri_device_name != device_name)
+            {
+               WSI_LOG_INFO("Using DRM device %s for display output.", device_name);
+            }
+            return;
+         }
       }
 
-      display = drm_display::make_display(util::allocator::get_generic(), dri_device);
+      /* Fall back to the historical default so the failure is reported against
+       * a concrete device. */
+      display = drm_display::make_display(util::allocator::get_generic(), default_dri_device_name.c_str());
    });
    return display;
 }
@@ -447,6 +917,17 @@ int drm_display::get_drm_fd() const
    return m_drm_fd.get();
 }
 
+bool drm_display::is_same_device(int64_t device_major, int64_t device_minor) const
+{
+   struct stat drm_node_stat = {};
+   if (fstat(m_drm_fd.get(), &drm_node_stat) != 0)
+   {
+      return false;
+   }
+
+   return major(drm_node_stat.st_rdev) == device_major && minor(drm_node_stat.st_rdev) == device_minor;
+}
+
 uint32_t drm_display::get_connector_id() const
 {
    return m_drm_connector->connector_id;
@@ -457,6 +938,72 @@ int drm_display::get_crtc_id() const
    return m_crtc_id;
 }
 
+bool drm_display::supports_atomic_commit() const
+{
+   return m_supports_atomic;
+}
+
+bool drm_display::supports_async_page_flip() const
+{
+   return m_supports_async_flip;
+}
+
+bool drm_display::supports_variable_refresh() const
+{
+   return m_crtc_vrr_enabled_prop_id != 0;
+}
+
+uint32_t drm_display::get_vrr_enabled_prop_id() const
+{
+   return m_crtc_vrr_enabled_prop_id;
+}
+
+uint32_t drm_display::get_min_refresh_rate() const
+{
+   uint32_t min_refresh_rate = 0;
+   for (size_t i = 0; i < m_num_display_modes; i++)
+   {
+      const uint32_t refresh_rate = m_display_modes.get()[i].get_refresh_rate();
+      if (refresh_rate != 0 && (min_refresh_rate == 0 || refresh_rate < min_refresh_rate))
+      {
+         min_refresh_rate = refresh_rate;
+      }
+   }
+
+   return min_refresh_rate;
+}
+
+uint32_t drm_display::get_primary_plane_id() const
+{
+   return get_plane(0).id;
+}
+
+const drm_atomic_properties &drm_display::get_atomic_properties() const
+{
+   return get_plane(0).atomic_props;
+}
+
+uint32_t drm_display::get_num_planes() const
+{
+   return static_cast<uint32_t>(m_planes->size());
+}
+
+const display_plane &drm_display::get_plane(uint32_t plane_index) const
+{
+   assert(plane_index < m_planes->size());
+   return (*m_planes)[plane_index];
+}
+
+VkSurfaceTransformFlagBitsKHR drm_display::get_panel_transform() const
+{
+   return m_panel_transform;
+}
+
+uint64_t drm_display::get_panel_rotation() const
+{
+   return m_panel_rotation;
+}
+
 drmModeConnector *drm_display::get_connector() const
 {
    return m_drm_connector.get();
@@ -471,6 +1018,103 @@ uint32_t drm_display::get_max_height() const
    return m_max_height;
 }
 
+void drm_display::get_physical_dimensions(uint32_t *width_mm, uint32_t *height_mm) const
+{
+   const std::lock_guard<std::mutex> lock(connector_state_mutex);
+   *width_mm = m_drm_connector->mmWidth;
+   *height_mm = m_drm_connector->mmHeight;
+}
+
+void drm_display::check_for_hotplug()
+{
+   if (!m_uevent_fd.is_valid())
+   {
+      return;
+   }
+
+   bool hotplug_received = false;
+   char buffer[1024];
+
+   /* In the steady state this is a single non-blocking recv returning EAGAIN. */
+   while (true)
+   {
+      ssize_t len = recv(m_uevent_fd.get(), buffer, sizeof(buffer) - 1, 0);
+      if (len <= 0)
+      {
+         break;
+      }
+      buffer[len] = '\0';
+
+      /* A uevent message is a list of NUL separated KEY=value entries. */
+      bool is_drm_subsystem = false;
+      bool is_hotplug = false;
+      for (ssize_t offset = 0; offset < len; offset += std::strlen(&buffer[offset]) + 1)
+      {
+         if (!std::strcmp(&buffer[offset], "SUBSYSTEM=drm"))
+         {
+            is_drm_subsystem = true;
+         }
+         else if (!std::strcmp(&buffer[offset], "HOTPLUG=1"))
+         {
+            is_hotplug = true;
+         }
+      }
+
+      if (is_drm_subsystem && is_hotplug)
+      {
+         hotplug_received = true;
+      }
+   }
+
+   if (hotplug_received)
+   {
+      refresh_connector();
+   }
+}
+
+void drm_display::refresh_connector()
+{
+   const std::lock_guard<std::mutex> lock(connector_state_mutex);
+
+   drm_connector_owner connector{ drmModeGetConnector(m_drm_fd.get(), m_drm_connector->connector_id) };
+   if (connector == nullptr)
+   {
+      WSI_LOG_WARNING("Failed to re-query DRM connector after hotplug event.");
+      return;
+   }
+
+   /* Rewrite the cached modes in place: VkDisplayModeKHR handles given to the
+    * application point into this storage, so it must never move. */
+   size_t num_modes = static_cast<size_t>(connector->count_modes);
+   if (num_modes > m_display_mode_capacity)
+   {
+      WSI_LOG_WARNING("Connector exposes %zu modes after hotplug, only caching %zu.", num_modes,
+                      m_display_mode_capacity);
+      num_modes = m_display_mode_capacity;
+   }
+
+   uint32_t max_width = 0;
+   uint32_t max_height = 0;
+   for (size_t i = 0; i < num_modes; ++i)
+   {
+      drm_display_mode &mode = m_display_modes.get()[i];
+      mode.set_drm_mode(connector->modes[i]);
+      mode.set_preferred(connector->modes[i].type == DRM_MODE_TYPE_PREFERRED);
+
+      uint32_t resolution = static_cast<uint32_t>(mode.get_width()) * static_cast<uint32_t>(mode.get_height());
+      if (resolution >= max_width * max_height)
+      {
+         max_width = mode.get_width();
+         max_height = mode.get_height();
+      }
+   }
+
+   m_num_display_modes = num_modes;
+   m_max_width = max_width;
+   m_max_height = max_height;
+   m_drm_connector = std::move(connector);
+}
+
 } /* namespace display */
 
 } /* namespace wsi */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2024 Arm Limited.
+ * Copyright (c) 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -62,6 +62,66 @@ using drm_plane_resources_owner = drm_owner<_drmModePlaneRes, drmModeFreePlaneRe
 using drm_object_properties_owner = drm_owner<_drmModeObjectProperties, drmModeFreeObjectProperties>;
 using drm_property_owner = drm_owner<_drmModeProperty, drmModeFreeProperty>;
 using drm_property_blob_owner = drm_owner<_drmModePropertyBlob, drmModeFreePropertyBlob>;
+using drm_atomic_req_owner = drm_owner<drmModeAtomicReq, drmModeAtomicFree>;
+
+/**
+ * @brief DRM object property ids needed to build an atomic commit.
+ *
+ * The ids are looked up once when the display is created so the presentation
+ * path does not have to re-query the property lists for every flip.
+ */
+struct drm_atomic_properties
+{
+   /* Primary plane properties. */
+   uint32_t plane_fb_id;
+   uint32_t plane_crtc_id;
+   uint32_t plane_src_x;
+   uint32_t plane_src_y;
+   uint32_t plane_src_w;
+   uint32_t plane_src_h;
+   uint32_t plane_crtc_x;
+   uint32_t plane_crtc_y;
+   uint32_t plane_crtc_w;
+   uint32_t plane_crtc_h;
+   /** Optional, 0 when the driver does not support explicit fencing. */
+   uint32_t plane_in_fence_fd;
+   /** Optional, 0 when the plane cannot rotate the buffer during scanout. */
+   uint32_t plane_rotation;
+   /** Optional, 0 when the driver does not accept per-flip damage hints. */
+   uint32_t plane_fb_damage_clips;
+
+   /* CRTC properties. */
+   uint32_t crtc_mode_id;
+   uint32_t crtc_active;
+
+   /* Connector properties. */
+   uint32_t connector_crtc_id;
+};
+
+/**
+ * @brief A hardware plane that can scan out on the display's CRTC.
+ *
+ * The display exposes its primary plane and, when atomic commits are available, any overlay
+ * planes compatible with the CRTC, so swapchains can be routed to different hardware planes
+ * and composed by the display controller.
+ */
+struct display_plane
+{
+   /** DRM object id of the plane. */
+   uint32_t id;
+
+   /** True for the CRTC's primary plane, false for overlay planes. */
+   bool primary;
+
+   /** Cached property ids for atomic commits targeting this plane. */
+   drm_atomic_properties atomic_props;
+
+   /**
+    * Bitmask of DRM_MODE_ROTATE_* / DRM_MODE_REFLECT_* values the plane's
+    * rotation property accepts; 0 when the plane has no rotation property.
+    */
+   uint64_t supported_rotations;
+};
 
 /**
  * @brief Owner class for an array of DRM GEM buffer handles.
@@ -230,6 +290,19 @@ public:
     */
    int get_drm_fd() const;
 
+   /**
+    * @brief Check whether the display device is the given DRM node.
+    *
+    * Lets swapchains detect hybrid setups where rendering happens on a
+    * different GPU than the one driving the display, by comparing against the
+    * render device's primary node as reported by VK_EXT_physical_device_drm.
+    *
+    * @param device_major Major number of the DRM node to compare against.
+    * @param device_minor Minor number of the DRM node to compare against.
+    * @return true when the numbers identify the display's device node.
+    */
+   bool is_same_device(int64_t device_major, int64_t device_minor) const;
+
    /**
     * @brief Get function for the connector id.
     *
@@ -280,6 +353,99 @@ public:
     */
    int get_crtc_id() const;
 
+   /**
+    * @brief Query the display for support for the atomic modesetting API.
+    *
+    * @return true if atomic commits can be used, otherwise false.
+    */
+   bool supports_atomic_commit() const;
+
+   /**
+    * @brief Query the display for asynchronous (tearing) page flip support.
+    *
+    * Async flips update the scanout address immediately instead of waiting
+    * for the next vertical blank; they back VK_PRESENT_MODE_IMMEDIATE_KHR.
+    * The capability is probed against the flip API actually in use, as the
+    * atomic API gates async flips behind its own capability.
+    *
+    * @return true if DRM_MODE_PAGE_FLIP_ASYNC can be used, otherwise false.
+    */
+   bool supports_async_page_flip() const;
+
+   /**
+    * @brief Query the display for variable refresh rate support.
+    *
+    * @return true when the connector reports vrr_capable and the CRTC exposes the
+    *         VRR_ENABLED property, otherwise false. Requires atomic commits, as the
+    *         legacy ioctls cannot set CRTC properties.
+    */
+   bool supports_variable_refresh() const;
+
+   /**
+    * @brief Get the id of the CRTC's VRR_ENABLED property.
+    *
+    * Only valid when supports_variable_refresh() returns true.
+    */
+   uint32_t get_vrr_enabled_prop_id() const;
+
+   /**
+    * @brief Get the lowest refresh rate reported by any display mode, in mHz.
+    *
+    * The kernel does not expose the display's variable refresh floor, so the
+    * slowest listed mode is used as an approximation of it.
+    *
+    * @return The lowest refresh rate, or 0 when no mode reports one.
+    */
+   uint32_t get_min_refresh_rate() const;
+
+   /**
+    * @brief Get the id of the primary plane driven by this display's CRTC.
+    */
+   uint32_t get_primary_plane_id() const;
+
+   /**
+    * @brief Get the cached property ids used to build atomic commits on the primary plane.
+    *
+    * Only valid when supports_atomic_commit() returns true.
+    */
+   const drm_atomic_properties &get_atomic_properties() const;
+
+   /**
+    * @brief Get the number of hardware planes usable for scanout on this display.
+    *
+    * Always at least 1; overlay planes beyond the primary are only exposed when atomic
+    * commits are supported, as the legacy presentation path can only flip the primary plane.
+    */
+   uint32_t get_num_planes() const;
+
+   /**
+    * @brief Get a hardware plane by index. Index 0 is always the primary plane.
+    */
+   const display_plane &get_plane(uint32_t plane_index) const;
+
+   /**
+    * @brief Get the surface transform matching the panel's native orientation.
+    *
+    * Read from the connector's "panel orientation" property. Non-identity only
+    * when the primary plane can actually undo the pre-rotation in hardware
+    * (atomic commits available and the plane's rotation property supports the
+    * needed rotation), so advertising it never promises a rotation the
+    * presentation path cannot program.
+    *
+    * @return The transform applications should pre-rotate by, or
+    *         VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR for normally mounted panels.
+    */
+   VkSurfaceTransformFlagBitsKHR get_panel_transform() const;
+
+   /**
+    * @brief Get the plane rotation value that applies get_panel_transform().
+    *
+    * DRM_MODE_ROTATE_0 when the panel transform is identity. DRM rotations are
+    * counter-clockwise while Vulkan transforms are clockwise, so the value is
+    * the inverse rotation of the reported transform.
+    */
+   uint64_t get_panel_rotation() const;
+
    /**
     * @brief Get the max width of the display in pixels.
     */
@@ -290,6 +456,27 @@ public:
     */
    uint32_t get_max_height() const;
 
+   /**
+    * @brief Get the physical dimensions of the connected display in millimetres.
+    *
+    * Reads the cached connector state, which check_for_hotplug() may refresh.
+    *
+    * @param[out] width_mm  Physical width in millimetres.
+    * @param[out] height_mm Physical height in millimetres.
+    */
+   void get_physical_dimensions(uint32_t *width_mm, uint32_t *height_mm) const;
+
+   /**
+    * @brief Re-query the connector state if a DRM hotplug event is pending.
+    *
+    * The connector, encoder and mode topology is cached when the display is created so
+    * steady state display property queries cost no ioctls. This method drains a
+    * non-blocking kernel uevent socket and only re-queries the connector when a DRM
+    * hotplug event actually arrived, picking up mode list and physical dimension
+    * changes. It is called from the display property query entrypoints.
+    */
+   void check_for_hotplug();
+
 private:
    /**
     * @brief display constructor.
@@ -299,7 +486,19 @@ private:
    drm_display(util::fd_owner drm_fd, int crtc_id, drm_connector_owner drm_connector,
                util::unique_ptr<util::vector<drm_format_pair>> supported_formats,
                util::unique_ptr<drm_display_mode> display_modes, size_t num_display_modes, uint32_t max_width,
-               uint32_t max_height, bool supports_fb_modifiers);
+               uint32_t max_height, bool supports_fb_modifiers,
+               util::unique_ptr<util::vector<display_plane>> planes, bool supports_atomic,
+               bool supports_async_flip, uint32_t crtc_vrr_enabled_prop_id,
+               VkSurfaceTransformFlagBitsKHR panel_transform, uint64_t panel_rotation, util::fd_owner uevent_fd);
+
+   /**
+    * @brief Refresh the cached connector state after a hotplug event.
+    *
+    * Re-queries the connector and rewrites the mode entries in place - the mode
+    * storage never moves so VkDisplayModeKHR handles held by the application stay
+    * valid - and updates the cached physical dimensions and maximum resolution.
+    */
+   void refresh_connector();
 
    /**
     * @brief File descriptor for the display device.
@@ -331,6 +530,22 @@ private:
     */
    size_t m_num_display_modes;
 
+   /**
+    * @brief Number of mode slots allocated in @ref m_display_modes.
+    *
+    * refresh_connector() rewrites modes in place, so after a hotplug at most this
+    * many modes can be exposed without moving the storage.
+    */
+   size_t m_display_mode_capacity;
+
+   /**
+    * @brief Non-blocking kernel uevent socket used to detect DRM hotplug events.
+    *
+    * Invalid when the socket could not be created, in which case the cached
+    * connector state is never refreshed.
+    */
+   util::fd_owner m_uevent_fd;
+
    /**
     * @brief Maximum display resolution width.
     */
@@ -345,6 +560,40 @@ private:
     * @brief Flag to indicate if the display supports framebuffers with format modifiers.
     */
    bool m_supports_fb_modifiers;
+
+   /**
+    * @brief Hardware planes usable for scanout on @ref m_crtc_id. Index 0 is the primary plane.
+    */
+   util::unique_ptr<util::vector<display_plane>> m_planes;
+
+   /**
+    * @brief Flag to indicate if the display supports the atomic modesetting API.
+    */
+   bool m_supports_atomic;
+
+   /**
+    * @brief Flag to indicate if the display supports asynchronous page flips.
+    */
+   bool m_supports_async_flip;
+
+   /**
+    * @brief Id of the CRTC's VRR_ENABLED property, 0 when the display does not
+    *        support variable refresh rate.
+    */
+   uint32_t m_crtc_vrr_enabled_prop_id;
+
+   /**
+    * @brief Surface transform matching the panel's native orientation.
+    *
+    * Identity unless the panel is mounted rotated and the primary plane can
+    * undo the pre-rotation during scanout. See get_panel_transform().
+    */
+   VkSurfaceTransformFlagBitsKHR m_panel_transform;
+
+   /**
+    * @brief Plane rotation value that applies @ref m_panel_transform.
+    */
+   uint64_t m_panel_rotation;
 };
 
 } /* namespace display */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file present_timing_handler.cpp
+ *
+ * @brief Contains the functionality to implement features for present timing extension.
+ */
+
+#include "present_timing_handler.hpp"
+
+#include <util/log.hpp>
+
+#include <xf86drm.h>
+
+drm_vblank_time_domain::drm_vblank_time_domain(VkPresentStageFlagsEXT present_stages, int drm_fd, uint32_t crtc_id)
+   : wsi::swapchain_time_domain(present_stages)
+   , m_drm_fd(drm_fd)
+   , m_crtc_id(crtc_id)
+{
+}
+
+wsi::swapchain_calibrated_time drm_vblank_time_domain::calibrate()
+{
+   uint64_t sequence = 0;
+   uint64_t timestamp_ns = 0;
+   if (drmCrtcGetSequence(m_drm_fd, m_crtc_id, &sequence, &timestamp_ns) == 0)
+   {
+      return { VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR, timestamp_ns };
+   }
+
+   /* Older kernels without DRM_IOCTL_CRTC_GET_SEQUENCE: a zero-length relative
+    * wait does not block and reports the timestamp of the most recent vblank. */
+   drmVBlank vblank = {};
+   vblank.request.type = DRM_VBLANK_RELATIVE;
+   if (drmWaitVBlank(m_drm_fd, &vblank) == 0)
+   {
+      uint64_t timestamp_us = static_cast<uint64_t>(vblank.reply.tval_sec) * 1000000ull + vblank.reply.tval_usec;
+      return { VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR, timestamp_us * 1000ull };
+   }
+
+   WSI_LOG_WARNING("Failed to query a vblank timestamp for CRTC %u.", m_crtc_id);
+   return { VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR, 0 };
+}
+
+wsi_ext_present_timing_display::wsi_ext_present_timing_display(const util::allocator &allocator,
+                                                               uint64_t refresh_duration_ns,
+                                                               uint64_t variable_refresh_delay_ns)
+   : wsi_ext_present_timing(allocator)
+   , m_refresh_duration_ns(refresh_duration_ns)
+   , m_variable_refresh_delay_ns(variable_refresh_delay_ns)
+{
+}
+
+util::unique_ptr<wsi_ext_present_timing_display> wsi_ext_present_timing_display::create(
+   const util::allocator &allocator, int drm_fd, uint32_t crtc_id, uint64_t refresh_duration_ns,
+   uint64_t variable_refresh_delay_ns)
+{
+   auto present_timing =
+      allocator.make_unique<wsi_ext_present_timing_display>(allocator, refresh_duration_ns,
+                                                            variable_refresh_delay_ns);
+   if (present_timing == nullptr)
+   {
+      return nullptr;
+   }
+
+   auto queue_end_domain = allocator.make_unique<wsi::vulkan_time_domain>(VK_PRESENT_STAGE_QUEUE_OPERATIONS_END_BIT_EXT,
+                                                                          VK_TIME_DOMAIN_DEVICE_KHR);
+   auto vblank_domain = allocator.make_unique<drm_vblank_time_domain>(
+      static_cast<VkPresentStageFlagsEXT>(VK_PRESENT_STAGE_IMAGE_FIRST_PIXEL_OUT_BIT_EXT |
+                                          VK_PRESENT_STAGE_IMAGE_FIRST_PIXEL_VISIBLE_BIT_EXT),
+      drm_fd, crtc_id);
+
+   if (!present_timing->get_swapchain_time_domains().add_time_domain(std::move(queue_end_domain)) ||
+       !present_timing->get_swapchain_time_domains().add_time_domain(std::move(vblank_domain)))
+   {
+      WSI_LOG_ERROR("Failed to add a time domain.");
+      return nullptr;
+   }
+
+   return present_timing;
+}
+
+VkResult wsi_ext_present_timing_display::get_swapchain_timing_properties(
+   uint64_t &timing_properties_counter, VkSwapchainTimingPropertiesEXT &timing_properties)
+{
+   /* The display mode is fixed for the lifetime of the swapchain, so the
+    * properties never change after creation. On a VRR-capable display the
+    * variable refresh delay reports how far past the mode's refresh duration a
+    * cycle may stretch, giving the application's pacer the refresh range it can
+    * target. */
+   timing_properties_counter = 1;
+   timing_properties.refreshDuration = m_refresh_duration_ns;
+   timing_properties.variableRefreshDelay = m_variable_refresh_delay_ns;
+
+   return VK_SUCCESS;
+}
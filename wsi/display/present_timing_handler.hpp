@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file present_timing_handler.hpp
+ *
+ * @brief Contains the functionality to implement features for present timing extension.
+ */
+#pragma once
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+
+#include <wsi/extensions/present_timing.hpp>
+
+/**
+ * @brief Time domain backed by the CRTC's hardware vblank timestamps.
+ *
+ * Calibrates against the timestamp of the most recent vblank the kernel recorded
+ * for the swapchain's CRTC, so scanout-side present stages correlate with real
+ * photon time without a userspace clock round-trip per frame. The reported
+ * offset is the CLOCK_MONOTONIC timestamp of that vblank in nanoseconds.
+ */
+class drm_vblank_time_domain : public wsi::swapchain_time_domain
+{
+public:
+   /**
+    * @brief Construct a vblank-backed time domain.
+    *
+    * @param present_stages Present stages this domain provides timestamps for.
+    * @param drm_fd         DRM fd of the device driving the CRTC. The fd is
+    *                       borrowed and must outlive the time domain.
+    * @param crtc_id        The CRTC whose vblank timestamps are used.
+    */
+   drm_vblank_time_domain(VkPresentStageFlagsEXT present_stages, int drm_fd, uint32_t crtc_id);
+
+   wsi::swapchain_calibrated_time calibrate() override;
+
+private:
+   int m_drm_fd;
+   uint32_t m_crtc_id;
+};
+
+/**
+ * @brief Present timing extension class
+ *
+ * This class implements present timing features declarations that are specific to the display backend.
+ */
+class wsi_ext_present_timing_display : public wsi::wsi_ext_present_timing
+{
+public:
+   /**
+    * @brief Create the present timing extension for a display swapchain.
+    *
+    * @param allocator                 The allocator to use for the extension.
+    * @param drm_fd                    DRM fd of the device driving the CRTC.
+    * @param crtc_id                   The CRTC the swapchain presents to.
+    * @param refresh_duration_ns       Duration of one refresh cycle in nanoseconds.
+    * @param variable_refresh_delay_ns Maximum delay variable refresh can add to a
+    *                                  refresh cycle in nanoseconds, or UINT64_MAX
+    *                                  when the display has a fixed refresh.
+    */
+   static util::unique_ptr<wsi_ext_present_timing_display> create(const util::allocator &allocator, int drm_fd,
+                                                                  uint32_t crtc_id, uint64_t refresh_duration_ns,
+                                                                  uint64_t variable_refresh_delay_ns);
+
+   VkResult get_swapchain_timing_properties(uint64_t &timing_properties_counter,
+                                            VkSwapchainTimingPropertiesEXT &timing_properties) override;
+
+private:
+   wsi_ext_present_timing_display(const util::allocator &allocator, uint64_t refresh_duration_ns,
+                                  uint64_t variable_refresh_delay_ns);
+
+   /* Allow util::allocator to access the private constructor */
+   friend util::allocator;
+
+   /**
+    * @brief Duration of one refresh cycle of the fixed display mode, in nanoseconds.
+    */
+   uint64_t m_refresh_duration_ns;
+
+   /**
+    * @brief Maximum delay variable refresh can add to a refresh cycle, in nanoseconds.
+    *
+    * UINT64_MAX when the display has a fixed refresh. On a VRR-capable display
+    * this bounds the refresh range the application's pacer can target:
+    * refreshDuration is the fastest cycle and refreshDuration plus this delay
+    * the slowest.
+    */
+   uint64_t m_variable_refresh_delay_ns;
+};
+
+#endif
@@ -35,9 +35,10 @@ namespace wsi
 namespace display
 {
 
-surface::surface(drm_display_mode *display_mode, VkExtent2D extent)
+surface::surface(drm_display_mode *display_mode, VkExtent2D extent, uint32_t plane_index)
    : m_display_mode(display_mode)
    , m_extent(extent)
+   , m_plane_index(plane_index)
    , m_surface_properties(this)
 {
 }
@@ -64,5 +65,10 @@ drm_display_mode *surface::get_display_mode()
    return m_display_mode;
 }
 
+uint32_t surface::get_plane_index() const
+{
+   return m_plane_index;
+}
+
 } /* namespace display */
 } /* namespace wsi */
@@ -45,8 +45,9 @@ public:
     *
     * @param mode The display mode to be used with the surface.
     * @param extent The extent of the surface.
+    * @param plane_index Index of the hardware plane the surface presents to.
     */
-   surface(drm_display_mode *mode, VkExtent2D extent);
+   surface(drm_display_mode *mode, VkExtent2D extent, uint32_t plane_index);
 
    wsi::surface_properties &get_properties() override;
    util::unique_ptr<swapchain_base> allocate_swapchain(layer::device_private_data &dev_data,
@@ -62,6 +63,13 @@ public:
     */
    drm_display_mode *get_display_mode();
 
+   /**
+    * @brief Get the index of the hardware plane this surface presents to.
+    *
+    * Indexes into the planes exposed by @ref drm_display::get_plane.
+    */
+   uint32_t get_plane_index() const;
+
 private:
    /**
     * @brief Pointer to the DRM display mode used with this surface.
@@ -73,6 +81,11 @@ private:
     */
    VkExtent2D m_extent;
 
+   /**
+    * @brief Index of the hardware plane this surface presents to.
+    */
+   uint32_t m_plane_index;
+
    /**
     * @brief Surface properties instance specific to this surface.
     */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2024-2025 Arm Limited.
+ * Copyright (c) 2024-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -24,6 +24,7 @@
 
 #include <cstring>
 #include <algorithm>
+#include <mutex>
 
 #include "surface_properties.hpp"
 #include "surface.hpp"
@@ -37,18 +38,21 @@ namespace display
 
 constexpr int max_core_1_0_formats = VK_FORMAT_ASTC_12x12_SRGB_BLOCK + 1;
 
-void surface_properties::populate_present_mode_compatibilities()
-{
-   std::array<present_mode_compatibility, 1> compatible_present_modes_list = { present_mode_compatibility{
-      VK_PRESENT_MODE_FIFO_KHR, 1, { VK_PRESENT_MODE_FIFO_KHR } } };
-   m_compatible_present_modes = compatible_present_modes<1>(compatible_present_modes_list);
-}
+/* The compatibility relation is fixed for the backend: every surface points at
+ * this table, so the EXT_surface_maintenance1 queries build nothing at runtime. */
+static constexpr std::array<present_mode_compatibility, 3> COMPATIBLE_PRESENT_MODES = {
+   present_mode_compatibility{ VK_PRESENT_MODE_FIFO_KHR, 1, { VK_PRESENT_MODE_FIFO_KHR } },
+   present_mode_compatibility{ VK_PRESENT_MODE_IMMEDIATE_KHR, 1, { VK_PRESENT_MODE_IMMEDIATE_KHR } },
+   present_mode_compatibility{
+      VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR, 1, { VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR } }
+};
 
 surface_properties::surface_properties(surface *wsi_surface)
    : m_specific_surface(wsi_surface)
-   , m_supported_modes({ VK_PRESENT_MODE_FIFO_KHR })
+   , m_supported_modes({ VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR,
+                         VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR })
+   , m_compatible_present_modes(COMPATIBLE_PRESENT_MODES)
 {
-   populate_present_mode_compatibilities();
 }
 
 surface_properties::surface_properties()
@@ -76,6 +80,17 @@ VkResult surface_properties::get_surface_capabilities(VkPhysicalDevice physical_
    pSurfaceCapabilities->supportedCompositeAlpha =
       static_cast<VkCompositeAlphaFlagBitsKHR>(VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR | VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR);
 
+   /* Report the panel's native orientation so applications pre-rotate and the
+    * scanout hardware applies the rotation, instead of a GPU rotation pass in
+    * the application or a compositor. Identity on normally mounted panels and
+    * whenever the plane cannot rotate, in which case nothing changes. */
+   const auto &display = drm_display::get_display();
+   if (display.has_value() && display->get_panel_transform() != VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)
+   {
+      pSurfaceCapabilities->supportedTransforms |= display->get_panel_transform();
+      pSurfaceCapabilities->currentTransform = display->get_panel_transform();
+   }
+
    return VK_SUCCESS;
 }
 
@@ -88,6 +103,17 @@ VkResult surface_properties::get_surface_capabilities(VkPhysicalDevice physical_
    /* Image count limits */
    get_surface_capabilities(physical_device, &pSurfaceCapabilities->surfaceCapabilities);
 
+   /* A shared swapchain is its single scanout buffer, so a per-present-mode
+    * query for it reports exactly one image. */
+   auto surface_present_mode =
+      util::find_extension<VkSurfacePresentModeEXT>(VK_STRUCTURE_TYPE_SURFACE_PRESENT_MODE_EXT, pSurfaceInfo);
+   if (surface_present_mode != nullptr &&
+       surface_present_mode->presentMode == VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR)
+   {
+      pSurfaceCapabilities->surfaceCapabilities.minImageCount = 1;
+      pSurfaceCapabilities->surfaceCapabilities.maxImageCount = 1;
+   }
+
    m_compatible_present_modes.get_surface_present_mode_compatibility_common(pSurfaceInfo, pSurfaceCapabilities);
 
    auto surface_scaling_capabilities = util::find_extension<VkSurfacePresentScalingCapabilitiesEXT>(
@@ -102,26 +128,13 @@ VkResult surface_properties::get_surface_capabilities(VkPhysicalDevice physical_
    return VK_SUCCESS;
 }
 
-VkResult surface_properties::get_surface_formats(VkPhysicalDevice physical_device, uint32_t *surfaceFormatCount,
-                                                 VkSurfaceFormatKHR *surfaceFormats,
-                                                 VkSurfaceFormat2KHR *extended_surface_formats)
+static uint32_t fill_supported_formats(VkPhysicalDevice physical_device,
+                                       const util::vector<drm_format_pair> &display_formats,
+                                       std::array<surface_format_properties, max_core_1_0_formats> &formats)
 {
-   auto &display = drm_display::get_display();
-   if (!display.has_value())
-   {
-      return VK_ERROR_SURFACE_LOST_KHR;
-   }
-
-   auto display_formats = display->get_supported_formats();
-
    uint32_t format_count = 0;
 
-   assert(display_formats->size() > 0);
-   assert(display_formats->size() <= max_core_1_0_formats);
-
-   std::array<surface_format_properties, max_core_1_0_formats> formats{};
-
-   for (const auto &drm_format : *display_formats)
+   for (const auto &drm_format : display_formats)
    {
       auto vk_format = util::drm::drm_to_vk_format(drm_format.fourcc);
       if (VK_FORMAT_UNDEFINED != vk_format)
@@ -172,8 +185,44 @@ VkResult surface_properties::get_surface_formats(VkPhysicalDevice physical_devic
       }
    }
 
-   return surface_properties_formats_helper(formats.begin(), formats.begin() + format_count, surfaceFormatCount,
-                                            surfaceFormats, extended_surface_formats);
+   return format_count;
+}
+
+/* The per-format support and fixed-rate compression capabilities are immutable
+ * for a given physical device and shared by every display surface, so probing
+ * the driver is only done on the first query; later queries are served from
+ * this cache with no driver round trips or allocations. Guarded by a mutex as
+ * surface format queries may run concurrently. */
+static std::mutex format_cache_mutex;
+static VkPhysicalDevice format_cache_device = VK_NULL_HANDLE;
+static uint32_t cached_format_count = 0;
+static std::array<surface_format_properties, max_core_1_0_formats> cached_formats{};
+
+VkResult surface_properties::get_surface_formats(VkPhysicalDevice physical_device, uint32_t *surfaceFormatCount,
+                                                 VkSurfaceFormatKHR *surfaceFormats,
+                                                 VkSurfaceFormat2KHR *extended_surface_formats)
+{
+   auto &display = drm_display::get_display();
+   if (!display.has_value())
+   {
+      return VK_ERROR_SURFACE_LOST_KHR;
+   }
+
+   auto display_formats = display->get_supported_formats();
+
+   assert(display_formats->size() > 0);
+   assert(display_formats->size() <= max_core_1_0_formats);
+
+   const std::lock_guard<std::mutex> lock(format_cache_mutex);
+
+   if (format_cache_device != physical_device)
+   {
+      cached_format_count = fill_supported_formats(physical_device, *display_formats, cached_formats);
+      format_cache_device = physical_device;
+   }
+
+   return surface_properties_formats_helper(cached_formats.begin(), cached_formats.begin() + cached_format_count,
+                                            surfaceFormatCount, surfaceFormats, extended_surface_formats);
 }
 
 VkResult surface_properties::get_surface_present_modes(VkPhysicalDevice physical_device, VkSurfaceKHR surface,
@@ -238,7 +287,7 @@ CreateDisplayPlaneSurfaceKHR(VkInstance instance, const VkDisplaySurfaceCreateIn
    if (res == VK_SUCCESS)
    {
 
-      auto wsi_surface = allocator.make_unique<surface>(display_mode, pCreateInfo->imageExtent);
+      auto wsi_surface = allocator.make_unique<surface>(display_mode, pCreateInfo->imageExtent, pCreateInfo->planeIndex);
       if (wsi_surface == nullptr)
       {
          return VK_ERROR_OUT_OF_HOST_MEMORY;
@@ -265,6 +314,8 @@ GetDisplayModePropertiesKHR(VkPhysicalDevice physicalDevice, VkDisplayKHR displa
    drm_display *dpy = reinterpret_cast<drm_display *>(display);
    assert(dpy != nullptr);
 
+   dpy->check_for_hotplug();
+
    drm_display_mode *modes{ dpy->get_display_modes_begin() };
    size_t num_modes{ dpy->get_num_display_modes() };
 
@@ -319,9 +370,7 @@ GetDisplayPlaneCapabilitiesKHR(VkPhysicalDevice physicalDevice, VkDisplayModeKHR
       return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
 
-   /* Implementation supports only one plane for presenting
-    * images. Therefore plane index must be 0. */
-   assert(planeIndex == 0);
+   assert(planeIndex < display->get_num_planes());
 
    auto valid_mode =
       std::find_if(display->get_display_modes_begin(), display->get_display_modes_end(), [&display_mode](auto &mode) {
@@ -365,14 +414,11 @@ GetDisplayPlaneSupportedDisplaysKHR(VkPhysicalDevice physicalDevice, uint32_t pl
       return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
 
-   /* Implementation supports only one plane for presenting
-    * images. Therefore plane index must be 0. */
-   assert(planeIndex == 0);
+   assert(planeIndex < display->get_num_planes());
 
    if (pDisplays == nullptr)
    {
-      /* Implementation will expose just one (the main)
-       * plane for the application to use. */
+      /* Every exposed plane scans out on the one connected display. */
       *pDisplayCount = 1;
       return VK_SUCCESS;
    }
@@ -403,30 +449,28 @@ GetPhysicalDeviceDisplayPlanePropertiesKHR(VkPhysicalDevice physicalDevice, uint
       return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
 
+   const uint32_t num_planes = display->get_num_planes();
    if (pProperties == nullptr)
    {
-      /* Implementation will expose just one (the main)
-       * plane for the application to use. */
-      *pPropertyCount = 1;
+      /* The primary plane plus any overlay planes usable through atomic commits. */
+      *pPropertyCount = num_planes;
       return VK_SUCCESS;
    }
 
-   if (*pPropertyCount == 0)
+   const uint32_t count = std::min(*pPropertyCount, num_planes);
+   for (uint32_t i = 0; i < count; i++)
    {
-      return VK_INCOMPLETE;
-   }
-
-   VkDisplayPlanePropertiesKHR planeProperties{};
-   planeProperties.currentDisplay = reinterpret_cast<VkDisplayKHR>(&display.value());
+      VkDisplayPlanePropertiesKHR planeProperties{};
+      planeProperties.currentDisplay = reinterpret_cast<VkDisplayKHR>(&display.value());
 
-   /* Since the implementation is exposing just one plane the value for
-    * the current stack index must be 0.*/
-   planeProperties.currentStackIndex = 0;
+      /* Planes are exposed in stacking order, with the primary plane bottom-most. */
+      planeProperties.currentStackIndex = i;
 
-   *pProperties = planeProperties;
-   *pPropertyCount = 1;
+      pProperties[i] = planeProperties;
+   }
+   *pPropertyCount = count;
 
-   return VK_SUCCESS;
+   return count < num_planes ? VK_INCOMPLETE : VK_SUCCESS;
 }
 
 VWL_VKAPI_CALL(VkResult)
@@ -445,6 +489,8 @@ GetPhysicalDeviceDisplayPropertiesKHR(VkPhysicalDevice physicalDevice, uint32_t
       return VK_SUCCESS;
    }
 
+   display->check_for_hotplug();
+
    if (pProperties == nullptr)
    {
       *pPropertyCount = 1;
@@ -458,12 +504,16 @@ GetPhysicalDeviceDisplayPropertiesKHR(VkPhysicalDevice physicalDevice, uint32_t
 
    *pPropertyCount = 1;
 
+   uint32_t physical_width_mm = 0;
+   uint32_t physical_height_mm = 0;
+   display->get_physical_dimensions(&physical_width_mm, &physical_height_mm);
+
    VkDisplayPropertiesKHR display_properties = {};
    display_properties.display = reinterpret_cast<VkDisplayKHR>(&display.value());
    display_properties.displayName = "DRM display";
-   display_properties.physicalDimensions = { display->get_connector()->mmWidth, display->get_connector()->mmHeight };
+   display_properties.physicalDimensions = { physical_width_mm, physical_height_mm };
    display_properties.physicalResolution = { display->get_max_width(), display->get_max_height() };
-   display_properties.supportedTransforms = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+   display_properties.supportedTransforms = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR | display->get_panel_transform();
    display_properties.planeReorderPossible = VK_FALSE;
    display_properties.persistentContent = VK_FALSE;
 
@@ -535,10 +585,14 @@ bool surface_properties::is_surface_extension_enabled(const layer::instance_priv
 void surface_properties::get_present_timing_surface_caps(
    VkPresentTimingSurfaceCapabilitiesEXT *present_timing_surface_caps)
 {
-   present_timing_surface_caps->presentTimingSupported = VK_FALSE;
+   present_timing_surface_caps->presentTimingSupported = VK_TRUE;
    present_timing_surface_caps->presentAtAbsoluteTimeSupported = VK_FALSE;
    present_timing_surface_caps->presentAtRelativeTimeSupported = VK_FALSE;
-   present_timing_surface_caps->presentStageQueries = 0;
+   /* Scanout-side stages are timestamped from the CRTC's hardware vblank
+    * counter; queue completion uses the device time domain. */
+   present_timing_surface_caps->presentStageQueries = VK_PRESENT_STAGE_QUEUE_OPERATIONS_END_BIT_EXT |
+                                                      VK_PRESENT_STAGE_IMAGE_FIRST_PIXEL_OUT_BIT_EXT |
+                                                      VK_PRESENT_STAGE_IMAGE_FIRST_PIXEL_VISIBLE_BIT_EXT;
    present_timing_surface_caps->presentStageTargets = 0;
 }
 #endif
@@ -563,6 +617,27 @@ bool surface_properties::is_compatible_present_modes(VkPresentModeKHR present_mo
    return m_compatible_present_modes.is_compatible_present_modes(present_mode_a, present_mode_b);
 }
 
+VkSurfaceCounterFlagsEXT surface_properties::get_supported_surface_counters()
+{
+   /* The vblank counter is served with DRM_IOCTL_CRTC_GET_SEQUENCE, which older
+    * kernels do not implement; probe the ioctl so the capability is only
+    * advertised when the query can actually be answered. */
+   auto &display = drm_display::get_display();
+   if (!display.has_value())
+   {
+      return 0;
+   }
+
+   uint64_t sequence = 0;
+   uint64_t timestamp_ns = 0;
+   if (drmCrtcGetSequence(display->get_drm_fd(), display->get_crtc_id(), &sequence, &timestamp_ns) != 0)
+   {
+      return 0;
+   }
+
+   return VK_SURFACE_COUNTER_VBLANK_BIT_EXT;
+}
+
 } /* namespace display */
 
 } /* namespace wsi */
\ No newline at end of file
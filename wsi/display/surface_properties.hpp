@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2024 Arm Limited.
+ * Copyright (c) 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -74,17 +74,18 @@ public:
 
    bool is_compatible_present_modes(VkPresentModeKHR present_mode_a, VkPresentModeKHR present_mode_b) override;
 
+   VkSurfaceCounterFlagsEXT get_supported_surface_counters() override;
+
 private:
    surface *const m_specific_surface;
 
    /* List of supported presentation modes */
-   std::array<VkPresentModeKHR, 1> m_supported_modes;
+   std::array<VkPresentModeKHR, 3> m_supported_modes;
 
-   /* Stores compatible presentation modes */
-   compatible_present_modes<1> m_compatible_present_modes;
+   /* View of the backend's constexpr compatibility table */
+   compatible_present_modes m_compatible_present_modes;
 
    void get_surface_present_scaling_and_gravity(VkSurfacePresentScalingCapabilitiesEXT *scaling_capabilities) override;
-   void populate_present_mode_compatibilities() override;
 };
 
 } /* namespace display */
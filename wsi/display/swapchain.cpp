@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2024-2025 Arm Limited.
+ * Copyright (c) 2024-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -32,11 +32,18 @@
 #include <vulkan/vulkan.h>
 #include <errno.h>
 
+#include <ctime>
+#include <mutex>
+
+#include <util/file_descriptor.hpp>
 #include <util/macros.hpp>
+#include <util/usdt.hpp>
 #include <wsi/extensions/image_compression_control.hpp>
 #include <wsi/extensions/present_id.hpp>
 #include <wsi/swapchain_base.hpp>
+#include <wsi/swapchain_present_loop.hpp>
 
+#include "present_timing_handler.hpp"
 #include "swapchain.hpp"
 
 namespace wsi
@@ -50,9 +57,22 @@ swapchain::swapchain(layer::device_private_data &dev_data, const VkAllocationCal
    : wsi::swapchain_base(dev_data, pAllocator)
    , m_wsi_allocator(nullptr)
    , m_display_mode(wsi_surface.get_display_mode())
+   , m_plane_index(wsi_surface.get_plane_index())
    , m_image_creation_parameters({}, m_allocator, {}, {})
+   , m_pending_flip(false)
+   , m_displaced_image_index(0)
+   , m_flip_event_received(false)
+   , m_last_present_time_ns(0)
+   , m_frame_interval_ns(0)
+   , m_frame_interval_jitter_ns(0)
+   , m_vrr_enabled(false)
+   , m_enabled_surface_counters(0)
+   , m_async_flip_rejected(false)
+   , m_is_cross_adapter(false)
+   , m_pre_transform(VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)
 {
    m_image_create_info.format = VK_FORMAT_UNDEFINED;
+   select_present_loop<swapchain>();
 }
 
 swapchain::~swapchain()
@@ -60,6 +80,18 @@ swapchain::~swapchain()
    /* Call the base class teardown */
    teardown();
 
+   /* A non-blocking flip queued by the page flip thread (joined by teardown) may
+    * still have its completion event queued on the shared DRM fd. Consume it so
+    * its user data pointer into this object does not outlive the swapchain. */
+   if (m_pending_flip)
+   {
+      const auto &display = drm_display::get_display();
+      if (display.has_value())
+      {
+         complete_pending_flip(*display, false);
+      }
+   }
+
    /* Free WSI allocator. */
    if (m_wsi_allocator != nullptr)
    {
@@ -78,6 +110,26 @@ static void page_flip_event(int fd, unsigned int sequence, unsigned int tv_sec,
    *done = true;
 }
 
+/* The DRM fd is shared between all display swapchains through the drm_display
+ * singleton, so completion events queued by different swapchains can interleave
+ * on it. Serialize drmHandleEvent calls so two swapchains draining their flip
+ * events concurrently do not race on reads from the fd; each event still
+ * reaches the right swapchain through its user data pointer. */
+static std::mutex drm_event_mutex;
+
+/* How long to wait for a DRM completion event before logging and retrying. */
+constexpr int DRM_EVENT_WAIT_TIMEOUT_MS = 1000;
+
+/* Weight denominator for the exponential moving averages tracking the
+ * inter-present interval and its jitter. */
+constexpr int64_t FRAME_INTERVAL_EMA_WEIGHT = 8;
+
+/* Jitter thresholds for toggling variable refresh, expressed as the divisor of
+ * the average frame interval the jitter is compared against. The disable
+ * threshold is lower than the enable one to provide hysteresis. */
+constexpr uint64_t VRR_ENABLE_JITTER_DIVISOR = 8;
+constexpr uint64_t VRR_DISABLE_JITTER_DIVISOR = 16;
+
 VkResult swapchain::add_required_extensions(VkDevice device, const VkSwapchainCreateInfoKHR *swapchain_create_info)
 {
    auto compression_control = wsi_ext_image_compression_control::create(device, swapchain_create_info);
@@ -105,6 +157,41 @@ VkResult swapchain::add_required_extensions(VkDevice device, const VkSwapchainCr
       }
    }
 
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   bool swapchain_support_enabled = swapchain_create_info->flags & VK_SWAPCHAIN_CREATE_PRESENT_TIMING_BIT_EXT;
+   if (swapchain_support_enabled)
+   {
+      auto &display = drm_display::get_display();
+      if (display.has_value() && m_display_mode != nullptr && m_display_mode->get_refresh_rate() != 0)
+      {
+         /* The mode's refresh rate is reported in mHz. */
+         const uint64_t refresh_duration_ns = 1000000000000ull / m_display_mode->get_refresh_rate();
+
+         /* On a VRR-capable display a refresh cycle can stretch beyond the
+          * mode's duration, down to the slowest rate the display advertises.
+          * Report the extra delay so the application's pacer knows the range it
+          * can target; UINT64_MAX means the refresh is fixed. */
+         uint64_t variable_refresh_delay_ns = UINT64_MAX;
+         if (display->supports_variable_refresh())
+         {
+            const uint32_t min_refresh_rate = display->get_min_refresh_rate();
+            variable_refresh_delay_ns = 0;
+            if (min_refresh_rate != 0 && min_refresh_rate < m_display_mode->get_refresh_rate())
+            {
+               variable_refresh_delay_ns = 1000000000000ull / min_refresh_rate - refresh_duration_ns;
+            }
+         }
+
+         if (!add_swapchain_extension(
+                wsi_ext_present_timing_display::create(m_allocator, display->get_drm_fd(), display->get_crtc_id(),
+                                                       refresh_duration_ns, variable_refresh_delay_ns)))
+         {
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+         }
+      }
+   }
+#endif
+
    return VK_SUCCESS;
 }
 
@@ -112,8 +199,14 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
                                   bool &use_presentation_thread)
 {
    UNUSED(device);
-   UNUSED(swapchain_create_info);
-   UNUSED(use_presentation_thread);
+
+   /* In shared demand refresh mode every vkQueuePresentKHR maps to exactly one
+    * flip of the single scanout buffer, so presents run synchronously on the
+    * application thread: no page flip thread to wake every 250 ms while the
+    * application is idle, and no queueing latency between the present call and
+    * the flip. */
+   use_presentation_thread = swapchain_create_info->presentMode != VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR;
+
    WSIALLOC_ASSERT_VERSION();
    if (wsialloc_new(&m_wsi_allocator) != WSIALLOC_ERROR_NONE)
    {
@@ -121,6 +214,40 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
       return VK_ERROR_INITIALIZATION_FAILED;
    }
 
+   detect_cross_adapter();
+
+   m_pre_transform = swapchain_create_info->preTransform;
+
+   auto *counter_info = util::find_extension<VkSwapchainCounterCreateInfoEXT>(
+      VK_STRUCTURE_TYPE_SWAPCHAIN_COUNTER_CREATE_INFO_EXT, swapchain_create_info->pNext);
+   if (counter_info != nullptr)
+   {
+      m_enabled_surface_counters = counter_info->surfaceCounters;
+   }
+
+   return VK_SUCCESS;
+}
+
+VkResult swapchain::get_swapchain_counter(VkSurfaceCounterFlagBitsEXT counter, uint64_t *counter_value)
+{
+   if (counter != VK_SURFACE_COUNTER_VBLANK_BIT_EXT || !(m_enabled_surface_counters & counter))
+   {
+      return VK_ERROR_FEATURE_NOT_PRESENT;
+   }
+
+   const auto &display = drm_display::get_display();
+   if (!display.has_value())
+   {
+      return VK_ERROR_OUT_OF_DATE_KHR;
+   }
+
+   uint64_t timestamp_ns = 0;
+   if (drmCrtcGetSequence(display->get_drm_fd(), display->get_crtc_id(), counter_value, &timestamp_ns) != 0)
+   {
+      WSI_LOG_ERROR("Failed to read the CRTC sequence counter: %s\n", std::strerror(errno));
+      return VK_ERROR_DEVICE_LOST;
+   }
+
    return VK_SUCCESS;
 }
 
@@ -133,6 +260,38 @@ VkResult swapchain::bind_swapchain_image(VkDevice &device, const VkBindImageMemo
    return image_data->external_mem.bind_swapchain_image_memory(bind_image_mem_info->image);
 }
 
+void swapchain::detect_cross_adapter()
+{
+   const auto &display = drm_display::get_display();
+   if (!display.has_value())
+   {
+      return;
+   }
+
+   VkPhysicalDeviceDrmPropertiesEXT drm_props = {};
+   drm_props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DRM_PROPERTIES_EXT;
+
+   VkPhysicalDeviceProperties2KHR props = {};
+   props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+   props.pNext = &drm_props;
+
+   m_device_data.instance_data.disp.GetPhysicalDeviceProperties2KHR(m_device_data.physical_device, &props);
+
+   /* Without VK_EXT_physical_device_drm the render device's DRM node cannot be
+    * identified; hasPrimary stays false and the single-GPU case is assumed. */
+   if (drm_props.hasPrimary == VK_FALSE)
+   {
+      return;
+   }
+
+   if (!display->is_same_device(drm_props.primaryMajor, drm_props.primaryMinor))
+   {
+      m_is_cross_adapter = true;
+      WSI_LOG_INFO("Rendering and display are on different GPUs; scanout buffers are allocated for the display "
+                   "device and imported into the render device as dmabufs.");
+   }
+}
+
 VkResult swapchain::get_surface_compatible_formats(const VkImageCreateInfo &info,
                                                    util::vector<wsialloc_format> &importable_formats,
                                                    util::vector<uint64_t> &exportable_modifers,
@@ -226,8 +385,11 @@ VkResult swapchain::get_surface_compatible_formats(const VkImageCreateInfo &info
          continue;
       }
 
-      if (external_props.externalMemoryProperties.externalMemoryFeatures &
-          VK_EXTERNAL_MEMORY_FEATURE_EXPORTABLE_BIT_KHR)
+      /* Exportable render-device allocations can only back scanout when
+       * rendering and display share a device, so they are not candidates in
+       * the cross-adapter case. */
+      if (!m_is_cross_adapter && (external_props.externalMemoryProperties.externalMemoryFeatures &
+                                  VK_EXTERNAL_MEMORY_FEATURE_EXPORTABLE_BIT_KHR))
       {
          if (!exportable_modifers.try_push_back(drm_format.modifier))
          {
@@ -428,14 +590,11 @@ VkResult swapchain::create_framebuffer(const VkImageCreateInfo &image_create_inf
 
 VkResult swapchain::allocate_and_bind_swapchain_image(VkImageCreateInfo image_create_info, swapchain_image &image)
 {
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
    image.status = swapchain_image::FREE;
    assert(image.data != nullptr);
    auto image_data = static_cast<display_image_data *>(image.data);
    TRY_LOG(allocate_image(image_data), "Failed to allocate image");
 
-   image_status_lock.unlock();
-
    TRY_LOG(create_framebuffer(image_create_info, image_data), "Failed to create framebuffer");
 
    TRY_LOG(image_data->external_mem.import_memory_and_bind_swapchain_image(image.image),
@@ -455,7 +614,7 @@ VkResult swapchain::allocate_and_bind_swapchain_image(VkImageCreateInfo image_cr
 VkResult swapchain::create_swapchain_image(VkImageCreateInfo image_create_info, swapchain_image &image)
 {
    /* Create image_data */
-   auto image_data = m_allocator.create<display_image_data>(1, m_device, m_allocator);
+   auto image_data = create_image_data<display_image_data>(m_device, m_allocator);
    if (image_data == nullptr)
    {
       return VK_ERROR_OUT_OF_HOST_MEMORY;
@@ -505,8 +664,389 @@ VkResult swapchain::create_swapchain_image(VkImageCreateInfo image_create_info,
    return m_device_data.disp.CreateImage(m_device, &m_image_create_info, get_allocation_callbacks(), &image.image);
 }
 
+bool swapchain::presentation_engine_waits_for_payload() const
+{
+   const auto &display = drm_display::get_display();
+   return display.has_value() && display->supports_atomic_commit() &&
+          display->get_plane(m_plane_index).atomic_props.plane_in_fence_fd != 0;
+}
+
+VkResult swapchain::inherit_image_creation_parameters(const swapchain_base &ancestor)
+{
+   /* oldSwapchain is created on the same surface, so the ancestor is a display swapchain. */
+   const auto &ancestor_sc = static_cast<const swapchain &>(ancestor);
+   const auto &ancestor_params = ancestor_sc.m_image_creation_parameters;
+   auto &params = m_image_creation_parameters;
+
+   params.m_allocated_format = ancestor_params.m_allocated_format;
+
+   params.m_image_layout.clear();
+   if (!params.m_image_layout.try_resize(ancestor_params.m_image_layout.size()))
+   {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+   std::copy(ancestor_params.m_image_layout.begin(), ancestor_params.m_image_layout.end(),
+             params.m_image_layout.begin());
+
+   /* Re-point the copied pNext chain at this swapchain's storage. The ancestor's
+    * chain tail referenced creation-time state that is no longer valid, so it is
+    * dropped rather than carried over. */
+   params.m_drm_mod_info = ancestor_params.m_drm_mod_info;
+   params.m_drm_mod_info.pNext = nullptr;
+   params.m_drm_mod_info.pPlaneLayouts = params.m_image_layout.data();
+   params.m_external_info = ancestor_params.m_external_info;
+   params.m_external_info.pNext = &params.m_drm_mod_info;
+   m_image_create_info.pNext = &params.m_external_info;
+
+   return VK_SUCCESS;
+}
+
+void swapchain::complete_pending_flip(const drm_display &display, bool recycle_displaced)
+{
+   assert(m_pending_flip);
+
+   const std::lock_guard<std::mutex> lock(drm_event_mutex);
+
+   while (!m_flip_event_received)
+   {
+      auto wait_status = util::wait_for_readable(display.get_drm_fd(), DRM_EVENT_WAIT_TIMEOUT_MS);
+      if (wait_status == util::fd_wait_status::error)
+      {
+         WSI_LOG_ERROR("Waiting for DRM events failed with errno: %d\n", errno);
+         set_error_state(VK_ERROR_SURFACE_LOST_KHR);
+         break;
+      }
+      else if (wait_status == util::fd_wait_status::timeout)
+      {
+         WSI_LOG_ERROR("Timed out waiting for flip completion\n");
+      }
+      else
+      {
+         drmEventContext ev = {};
+         ev.version = DRM_EVENT_CONTEXT_VERSION;
+         ev.page_flip_handler = page_flip_event;
+
+         drmHandleEvent(display.get_drm_fd(), &ev);
+      }
+   }
+
+   m_pending_flip = false;
+   m_flip_event_received = false;
+
+   if (recycle_displaced && m_displaced_image_index < m_swapchain_images.size())
+   {
+      unpresent_image(m_displaced_image_index);
+   }
+}
+
+bool swapchain::want_variable_refresh()
+{
+   timespec now = {};
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   const uint64_t now_ns = static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+
+   if (m_last_present_time_ns != 0)
+   {
+      const int64_t interval_ns = static_cast<int64_t>(now_ns - m_last_present_time_ns);
+      if (m_frame_interval_ns == 0)
+      {
+         m_frame_interval_ns = static_cast<uint64_t>(interval_ns);
+      }
+
+      const int64_t interval_delta = interval_ns - static_cast<int64_t>(m_frame_interval_ns);
+      m_frame_interval_ns =
+         static_cast<uint64_t>(static_cast<int64_t>(m_frame_interval_ns) + interval_delta / FRAME_INTERVAL_EMA_WEIGHT);
+
+      const int64_t deviation = interval_delta < 0 ? -interval_delta : interval_delta;
+      const int64_t jitter_delta = deviation - static_cast<int64_t>(m_frame_interval_jitter_ns);
+      m_frame_interval_jitter_ns = static_cast<uint64_t>(static_cast<int64_t>(m_frame_interval_jitter_ns) +
+                                                         jitter_delta / FRAME_INTERVAL_EMA_WEIGHT);
+   }
+   m_last_present_time_ns = now_ns;
+
+   /* Variable refresh only helps when presents are throttled to the display:
+    * a shared swapchain flips the same buffer on demand and has no queue to
+    * smooth out. */
+   if (m_present_mode != VK_PRESENT_MODE_FIFO_KHR || m_frame_interval_ns == 0)
+   {
+      return false;
+   }
+
+   const uint64_t divisor = m_vrr_enabled ? VRR_DISABLE_JITTER_DIVISOR : VRR_ENABLE_JITTER_DIVISOR;
+   return m_frame_interval_jitter_ns > m_frame_interval_ns / divisor;
+}
+
+void swapchain::present_image_atomic(const drm_display &display, const pending_present_request &pending_present)
+{
+   display_image_data *image_data =
+      reinterpret_cast<display_image_data *>(m_swapchain_images[pending_present.image_index].data);
+
+   /* Only one flip is kept in flight as queueing another before the previous
+    * one completed would fail with EBUSY. The previous flip has normally
+    * completed by the time the next present request has been prepared, so this
+    * rarely blocks. */
+   if (m_pending_flip)
+   {
+      complete_pending_flip(display, true);
+      if (error_has_occured())
+      {
+         return;
+      }
+   }
+
+   /* Find currently presented image */
+   uint32_t presented_index = m_swapchain_images.size();
+   if (!m_first_present)
+   {
+      for (uint32_t i = 0; i < m_swapchain_images.size(); ++i)
+      {
+         if (m_swapchain_images[i].status == swapchain_image::PRESENTED)
+         {
+            presented_index = i;
+            break;
+         }
+      }
+      /* There should always be a presented image, unless there was an error or
+       * the swapchain is shared: re-presenting the single shared image moves it
+       * from PRESENTED back to PENDING, leaving nothing to displace. */
+      assert(presented_index < m_swapchain_images.size() ||
+             m_present_mode == VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR);
+   }
+
+   drm_atomic_req_owner req{ drmModeAtomicAlloc() };
+   if (req == nullptr)
+   {
+      set_error_state(VK_ERROR_OUT_OF_HOST_MEMORY);
+      return;
+   }
+
+   /* Commits are routed to the hardware plane the surface was created for, so swapchains
+    * on different planes are composed by the display controller. */
+   const auto &plane = display.get_plane(m_plane_index);
+   const auto &props = plane.atomic_props;
+   const uint32_t plane_id = plane.id;
+   const uint32_t crtc_id = static_cast<uint32_t>(display.get_crtc_id());
+
+   bool add_failed = drmModeAtomicAddProperty(req.get(), plane_id, props.plane_fb_id, image_data->fb_id) < 0;
+
+   /* Hand the present fence to the kernel so the flip waits for rendering
+    * completion there instead of on the page flip thread. The fd stays open
+    * until after the commit, which duplicates it. */
+   util::fd_owner in_fence_fd{};
+   if (props.plane_in_fence_fd != 0)
+   {
+      auto exported_fd = image_data->present_fence.export_sync_fd();
+      if (exported_fd.has_value() && exported_fd->is_valid())
+      {
+         in_fence_fd = std::move(exported_fd.value());
+         add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_in_fence_fd,
+                                                static_cast<uint64_t>(in_fence_fd.get())) < 0;
+      }
+      else
+      {
+         /* Without a fence for the kernel to wait on, wait for the payload
+          * here as the legacy path does. */
+         WSI_LOG_WARNING("Failed to export present fence, waiting for the payload on the CPU instead.");
+         image_wait_present(m_swapchain_images[pending_present.image_index], UINT64_MAX);
+      }
+   }
+
+   /* Toggle VRR as the application's pacing changes. VRR_ENABLED can be
+    * changed without a modeset, so the property is only added to a commit when
+    * the desired state differs from what is programmed. The first present sets
+    * it explicitly, as a previous DRM client may have left the CRTC in either
+    * state. */
+   bool vrr_state = m_vrr_enabled;
+   if (display.supports_variable_refresh())
+   {
+      vrr_state = want_variable_refresh();
+      if (vrr_state != m_vrr_enabled || m_first_present)
+      {
+         add_failed |=
+            drmModeAtomicAddProperty(req.get(), crtc_id, display.get_vrr_enabled_prop_id(), vrr_state ? 1 : 0) < 0;
+      }
+   }
+
+   /* Pass the application's incremental-present regions to the kernel as
+    * FB_DAMAGE_CLIPS, so the display controller (and self-refresh or writeback
+    * hardware) only processes the dirty part of the framebuffer. A count of 0
+    * means the damage is unknown and the property is left unset, which the
+    * kernel treats as full-plane damage. Blob creation failure only loses the
+    * hint, so it is not an error. */
+   uint32_t damage_blob_id = 0;
+   if (props.plane_fb_damage_clips != 0 && pending_present.damage_rect_count > 0)
+   {
+      std::array<struct drm_mode_rect, pending_present_request::MAX_DAMAGE_RECTANGLES> damage_clips;
+      for (uint32_t i = 0; i < pending_present.damage_rect_count; i++)
+      {
+         const VkRectLayerKHR &rect = pending_present.damage_rects[i];
+         damage_clips[i] = { rect.offset.x, rect.offset.y, rect.offset.x + static_cast<int32_t>(rect.extent.width),
+                             rect.offset.y + static_cast<int32_t>(rect.extent.height) };
+      }
+
+      if (drmModeCreatePropertyBlob(display.get_drm_fd(), damage_clips.data(),
+                                    pending_present.damage_rect_count * sizeof(struct drm_mode_rect),
+                                    &damage_blob_id) == 0)
+      {
+         add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_fb_damage_clips, damage_blob_id) < 0;
+      }
+   }
+
+   uint32_t mode_blob_id = 0;
+   uint32_t commit_flags = 0;
+   if (m_first_present)
+   {
+      /* Modesets cannot be made non-blocking, so the first present commits the
+       * full display state and waits for it to be applied. */
+      drmModeModeInfo mode_info = m_display_mode->get_drm_mode();
+      if (drmModeCreatePropertyBlob(display.get_drm_fd(), &mode_info, sizeof(mode_info), &mode_blob_id) != 0)
+      {
+         WSI_LOG_ERROR("Failed to create mode property blob: %s\n", std::strerror(errno));
+         set_error_state(VK_ERROR_SURFACE_LOST_KHR);
+         return;
+      }
+
+      add_failed |= drmModeAtomicAddProperty(req.get(), crtc_id, props.crtc_mode_id, mode_blob_id) < 0;
+      add_failed |= drmModeAtomicAddProperty(req.get(), crtc_id, props.crtc_active, 1) < 0;
+      add_failed |=
+         drmModeAtomicAddProperty(req.get(), display.get_connector_id(), props.connector_crtc_id, crtc_id) < 0;
+
+      /* Scan out the whole framebuffer at the native size of the mode. */
+      add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_crtc_id, crtc_id) < 0;
+      add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_src_x, 0) < 0;
+      add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_src_y, 0) < 0;
+      add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_src_w,
+                                             static_cast<uint64_t>(m_image_create_info.extent.width) << 16) < 0;
+      add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_src_h,
+                                             static_cast<uint64_t>(m_image_create_info.extent.height) << 16) < 0;
+      add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_crtc_x, 0) < 0;
+      add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_crtc_y, 0) < 0;
+      add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_crtc_w, mode_info.hdisplay) < 0;
+      add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_crtc_h, mode_info.vdisplay) < 0;
+
+      /* When the application pre-rotated to the panel's native orientation,
+       * program the plane rotation that undoes it so the rotation happens in
+       * the scanout hardware. Reset to rotate-0 otherwise, as a previous DRM
+       * client may have left a rotation programmed. Plane state persists, so
+       * setting it once with the modeset covers every later flip. */
+      if (props.plane_rotation != 0)
+      {
+         /* Overlay planes do not necessarily support the rotation the primary
+          * plane advertised; commit rotate-0 rather than a value the kernel
+          * would reject. */
+         const bool undo_pre_rotation = m_pre_transform == display.get_panel_transform() &&
+                                        (plane.supported_rotations & display.get_panel_rotation()) != 0;
+         const uint64_t rotation =
+            undo_pre_rotation ? display.get_panel_rotation() : static_cast<uint64_t>(DRM_MODE_ROTATE_0);
+         add_failed |= drmModeAtomicAddProperty(req.get(), plane_id, props.plane_rotation, rotation) < 0;
+      }
+
+      commit_flags = DRM_MODE_ATOMIC_ALLOW_MODESET;
+   }
+   else
+   {
+      commit_flags = DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT;
+      if (use_async_flip(display))
+      {
+         /* Flip as soon as the commit is processed instead of at the next
+          * vertical blank; the completion event then arrives within
+          * microseconds and the pending flip never stalls the next present. */
+         commit_flags |= DRM_MODE_PAGE_FLIP_ASYNC;
+      }
+   }
+
+   int drm_res = 0;
+   if (add_failed)
+   {
+      WSI_LOG_ERROR("Failed to build atomic commit request.\n");
+      set_error_state(VK_ERROR_SURFACE_LOST_KHR);
+   }
+   else
+   {
+      m_flip_event_received = false;
+      drm_res = drmModeAtomicCommit(display.get_drm_fd(), req.get(), commit_flags, &m_flip_event_received);
+      if (drm_res != 0 && (commit_flags & DRM_MODE_PAGE_FLIP_ASYNC) != 0)
+      {
+         /* The capability cannot express every constraint; the kernel may
+          * still refuse an async flip, e.g. for a framebuffer layout the
+          * hardware cannot switch mid-scanout. Stay vsynced from here on. */
+         WSI_LOG_WARNING("Asynchronous page flip rejected: %s. Falling back to vsynced flips.\n",
+                         std::strerror(errno));
+         m_async_flip_rejected = true;
+         commit_flags &= ~DRM_MODE_PAGE_FLIP_ASYNC;
+         drm_res = drmModeAtomicCommit(display.get_drm_fd(), req.get(), commit_flags, &m_flip_event_received);
+      }
+   }
+
+   if (mode_blob_id != 0)
+   {
+      drmModeDestroyPropertyBlob(display.get_drm_fd(), mode_blob_id);
+   }
+   if (damage_blob_id != 0)
+   {
+      drmModeDestroyPropertyBlob(display.get_drm_fd(), damage_blob_id);
+   }
+
+   if (add_failed)
+   {
+      return;
+   }
+
+   if (drm_res != 0)
+   {
+      WSI_LOG_ERROR("drmModeAtomicCommit failed: %s\n", std::strerror(errno));
+      set_error_state(VK_ERROR_SURFACE_LOST_KHR);
+      return;
+   }
+
+   m_vrr_enabled = vrr_state;
+
+   /* The image is either on screen (modeset) or queued for the next vertical
+    * blank (non-blocking flip), change the image status to PRESENTED. */
+   m_swapchain_images[pending_present.image_index].status = swapchain_image::PRESENTED;
+
+   sample_vblank_counter(display, pending_present.image_index);
+
+   if (m_device_data.is_present_id_enabled())
+   {
+      auto *ext = get_swapchain_extension<wsi_ext_present_id>(true);
+      ext->set_present_id(pending_present.present_id);
+   }
+
+   if (!m_first_present)
+   {
+      /* The displaced image stays on screen until the queued flip completes, so
+       * its release is deferred to the completion event. */
+      m_pending_flip = true;
+      m_displaced_image_index = presented_index;
+   }
+}
+
+bool swapchain::use_async_flip(const drm_display &display) const
+{
+   return m_present_mode == VK_PRESENT_MODE_IMMEDIATE_KHR && display.supports_async_page_flip() &&
+          !m_async_flip_rejected;
+}
+
+void swapchain::sample_vblank_counter(const drm_display &display, uint32_t image_index)
+{
+   if (!m_latency_tracker.is_enabled())
+   {
+      return;
+   }
+
+   uint64_t sequence = 0;
+   uint64_t timestamp_ns = 0;
+   if (drmCrtcGetSequence(display.get_drm_fd(), display.get_crtc_id(), &sequence, &timestamp_ns) == 0)
+   {
+      m_latency_tracker.mark_vblank(image_index, sequence);
+   }
+}
+
 void swapchain::present_image(const pending_present_request &pending_present)
 {
+   WSI_USDT3(present_submit, this, pending_present.image_index, pending_present.present_id);
+
    int drm_res = 0;
    display_image_data *image_data =
       reinterpret_cast<display_image_data *>(m_swapchain_images[pending_present.image_index].data);
@@ -517,6 +1057,34 @@ void swapchain::present_image(const pending_present_request &pending_present)
       return;
    }
 
+   /* Shared demand refresh presents run on the application thread without the
+    * page flip thread that normally waits for the present payload, so unless
+    * the payload is handed to the kernel as an in-fence the wait happens here,
+    * before the buffer is flipped to the screen. */
+   if (m_present_mode == VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR && !presentation_engine_waits_for_payload())
+   {
+      VkResult vk_res = VK_SUCCESS;
+      while ((vk_res = image_wait_present(m_swapchain_images[pending_present.image_index], UINT64_MAX)) == VK_TIMEOUT)
+      {
+         WSI_LOG_WARNING("Timeout waiting for image's present fences, retrying..");
+      }
+      if (vk_res != VK_SUCCESS)
+      {
+         set_error_state(vk_res);
+         return;
+      }
+   }
+
+   if (display->supports_atomic_commit())
+   {
+      present_image_atomic(*display, pending_present);
+      return;
+   }
+
+   /* Overlay planes are only exposed when atomic commits are supported, so the legacy
+    * path can only ever be presenting on the primary plane. */
+   assert(m_plane_index == 0);
+
    if (m_first_present)
    {
       /* Now we can set the mode of the new swapchain. */
@@ -539,8 +1107,27 @@ void swapchain::present_image(const pending_present_request &pending_present)
 
       bool page_flip_complete = false;
 
-      drm_res = drmModePageFlip(display->get_drm_fd(), display->get_crtc_id(), image_data->fb_id,
-                                DRM_MODE_PAGE_FLIP_EVENT, (void *)&page_flip_complete);
+      uint32_t flip_flags = DRM_MODE_PAGE_FLIP_EVENT;
+      if (use_async_flip(*display))
+      {
+         /* The flip applies immediately instead of at the next vertical
+          * blank, so the completion wait below returns within microseconds. */
+         flip_flags |= DRM_MODE_PAGE_FLIP_ASYNC;
+      }
+
+      drm_res = drmModePageFlip(display->get_drm_fd(), display->get_crtc_id(), image_data->fb_id, flip_flags,
+                                (void *)&page_flip_complete);
+
+      if (drm_res != 0 && (flip_flags & DRM_MODE_PAGE_FLIP_ASYNC) != 0)
+      {
+         /* The capability cannot express every constraint; the kernel may
+          * still refuse an async flip. Stay vsynced from here on. */
+         WSI_LOG_WARNING("Asynchronous page flip rejected: %s. Falling back to vsynced flips.\n",
+                         std::strerror(errno));
+         m_async_flip_rejected = true;
+         drm_res = drmModePageFlip(display->get_drm_fd(), display->get_crtc_id(), image_data->fb_id,
+                                   DRM_MODE_PAGE_FLIP_EVENT, (void *)&page_flip_complete);
+      }
 
       if (drm_res != 0)
       {
@@ -549,43 +1136,28 @@ void swapchain::present_image(const pending_present_request &pending_present)
          return;
       }
 
-      fd_set fds;
-      FD_ZERO(&fds);
-      FD_SET(display->get_drm_fd(), &fds);
-
-      do
+      while (!page_flip_complete)
       {
-         struct timeval t;
-         t.tv_sec = 1;
-         t.tv_usec = 0;
-         drm_res = select(display->get_drm_fd() + 1, &fds, NULL, NULL, &t);
-
-         if (drm_res < 0)
+         auto wait_status = util::wait_for_readable(display->get_drm_fd(), DRM_EVENT_WAIT_TIMEOUT_MS);
+         if (wait_status == util::fd_wait_status::error)
          {
-            if (errno != EINTR && errno != EAGAIN)
-            {
-               WSI_LOG_ERROR("select() failed with errno: %d\n", errno);
-               set_error_state(VK_ERROR_SURFACE_LOST_KHR);
-               break;
-            }
-            WSI_LOG_ERROR("select() failed with %d, carrying on with page flip\n", errno);
+            WSI_LOG_ERROR("Waiting for DRM events failed with errno: %d\n", errno);
+            set_error_state(VK_ERROR_SURFACE_LOST_KHR);
+            break;
          }
-         else if (drm_res == 0)
+         else if (wait_status == util::fd_wait_status::timeout)
          {
-            WSI_LOG_ERROR("select() timed out, carrying on with page flip\n");
+            WSI_LOG_ERROR("Timed out waiting for page flip, carrying on\n");
          }
          else
          {
-            int result = FD_ISSET(display->get_drm_fd(), &fds);
-            assert(result > 0);
-            UNUSED(result);
             drmEventContext ev = {};
             ev.version = DRM_EVENT_CONTEXT_VERSION;
             ev.page_flip_handler = page_flip_event;
 
             drmHandleEvent(display->get_drm_fd(), &ev);
          }
-      } while ((drm_res == -1 && (errno == EINTR || errno == EAGAIN)) || drm_res == 0 || !page_flip_complete);
+      }
    }
 
    /* Find currently presented image */
@@ -600,12 +1172,17 @@ void swapchain::present_image(const pending_present_request &pending_present)
             break;
          }
       }
-      /* There should always be a presented image, unless there was an error */
-      assert(presented_index < m_swapchain_images.size());
+      /* There should always be a presented image, unless there was an error or
+       * the swapchain is shared: re-presenting the single shared image moves it
+       * from PRESENTED back to PENDING, leaving nothing to displace. */
+      assert(presented_index < m_swapchain_images.size() ||
+             m_present_mode == VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR);
    }
    /* The image is on screen, change the image status to PRESENTED. */
    m_swapchain_images[pending_present.image_index].status = swapchain_image::PRESENTED;
 
+   sample_vblank_counter(*display, pending_present.image_index);
+
    if (m_device_data.is_present_id_enabled())
    {
       auto *ext = get_swapchain_extension<wsi_ext_present_id>(true);
@@ -621,6 +1198,12 @@ void swapchain::present_image(const pending_present_request &pending_present)
    return;
 }
 
+bool swapchain::fill_captured_frame(uint32_t image_index, VkCapturedFrameWSI &frame)
+{
+   auto *image_data = reinterpret_cast<display_image_data *>(m_swapchain_images[image_index].data);
+   return fill_captured_frame_from_dmabuf(image_data->external_mem, image_data->present_fence, frame);
+}
+
 VkResult swapchain::image_set_present_payload(swapchain_image &image, VkQueue queue,
                                               const queue_submit_semaphores &semaphores, const void *submission_pnext)
 {
@@ -636,21 +1219,18 @@ VkResult swapchain::image_wait_present(swapchain_image &image, uint64_t timeout)
 
 void swapchain::destroy_image(swapchain_image &image)
 {
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
-
-   if (image.status != swapchain_image::INVALID)
+   /* Move the status to INVALID atomically: only the caller whose exchange
+    * observes a different previous state tears the VkImage down, which keeps
+    * destroy_image safe to reach twice for the same image. */
+   if (image.status.exchange(swapchain_image::INVALID) != swapchain_image::INVALID)
    {
       if (image.image != VK_NULL_HANDLE)
       {
          m_device_data.disp.DestroyImage(m_device, image.image, get_allocation_callbacks());
          image.image = VK_NULL_HANDLE;
       }
-
-      image.status = swapchain_image::INVALID;
    }
 
-   image_status_lock.unlock();
-
    if (image.data != nullptr)
    {
       auto image_data = reinterpret_cast<display_image_data *>(image.data);
@@ -666,7 +1246,7 @@ void swapchain::destroy_image(swapchain_image &image)
          UNUSED(result);
       }
 
-      m_allocator.destroy(1, image_data);
+      destroy_image_data(image_data);
       image.data = nullptr;
    }
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2024-2025 Arm Limited.
+ * Copyright (c) 2024-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -78,7 +78,7 @@ struct image_creation_parameters
 /**
  * @brief Display swapchain class.
  */
-class swapchain : public wsi::swapchain_base
+class swapchain final : public wsi::swapchain_base
 {
 public:
    swapchain(layer::device_private_data &dev_data, const VkAllocationCallbacks *pAllocator, surface &wsi_surface);
@@ -102,6 +102,11 @@ public:
     */
    void present_image(const pending_present_request &pending_present) override;
 
+   /**
+    * @brief Fill a captured frame with the dmabuf handles backing an image.
+    */
+   bool fill_captured_frame(uint32_t image_index, VkCapturedFrameWSI &frame) override;
+
    virtual VkResult image_set_present_payload(swapchain_image &image, VkQueue queue,
                                               const queue_submit_semaphores &semaphores,
                                               const void *submission_pnext) override;
@@ -110,9 +115,114 @@ public:
 
    void destroy_image(swapchain_image &image) override;
 
+   /**
+    * @brief Read a surface counter straight out of the display hardware.
+    *
+    * The vblank counter is served with a single DRM_IOCTL_CRTC_GET_SEQUENCE on
+    * the display's CRTC, so a pacing loop gets the exact hardware count instead
+    * of deriving one from timestamps. Only counters requested with
+    * VkSwapchainCounterCreateInfoEXT at swapchain creation can be queried.
+    */
+   VkResult get_swapchain_counter(VkSurfaceCounterFlagBitsEXT counter, uint64_t *counter_value) override;
+
+protected:
+   /**
+    * @brief Whether the present payload wait can be left to the kernel.
+    *
+    * @return true when atomic commits with explicit fencing are available, in which
+    *         case the payload is handed to the kernel as an IN_FENCE_FD instead of
+    *         being waited for on the page flip thread.
+    */
+   bool presentation_engine_waits_for_payload() const override;
+
+   /**
+    * @brief Display images can be adopted from a deprecated ancestor swapchain.
+    *
+    * An image's resources - its dmabufs, the GEM-backed DRM framebuffer and the
+    * present fence - are tied to the process wide DRM fd rather than to the
+    * swapchain, so an adopted image's fb_id stays valid and a recreation that
+    * reuses buffers skips the PRIME import and AddFB ioctls entirely.
+    */
+   bool can_transfer_images() const override
+   {
+      return true;
+   }
+
+   /**
+    * @brief Copy the negotiated format and modifier layout from the ancestor.
+    *
+    * Images created from scratch next to adopted ones must use the same wsialloc
+    * format and DRM modifier plane layout, which create_swapchain_image only derives
+    * when it starts from an undefined format.
+    */
+   VkResult inherit_image_creation_parameters(const swapchain_base &ancestor) override;
+
 private:
    VkResult allocate_image(display_image_data *image_data);
 
+   /**
+    * @brief Present an image with a non-blocking DRM atomic commit.
+    *
+    * The first present performs a blocking modeset. Subsequent flips are queued
+    * with DRM_MODE_ATOMIC_NONBLOCK so the page flip thread can start preparing
+    * the next pending present request while the flip is in flight. The image
+    * displaced by a queued flip is only released once its completion event has
+    * been received.
+    *
+    * @param display         The DRM display to present on.
+    * @param pending_present Information on the pending present request.
+    */
+   void present_image_atomic(const drm_display &display, const pending_present_request &pending_present);
+
+   /**
+    * @brief Decide whether variable refresh should be active for this present.
+    *
+    * Tracks the application's inter-present interval and its jitter with
+    * exponential moving averages. When FIFO presents arrive with consistently
+    * varying frame times, enabling VRR lets the display stretch its refresh
+    * cycle to match the application instead of quantizing every frame to the
+    * fixed rate. Separate enable and disable thresholds keep the state from
+    * flapping when the jitter hovers around one of them.
+    *
+    * @return true when VRR_ENABLED should be set on the CRTC.
+    */
+   bool want_variable_refresh();
+
+   /**
+    * @brief Decide whether this present should flip asynchronously.
+    *
+    * IMMEDIATE presents flip with DRM_MODE_PAGE_FLIP_ASYNC when the hardware
+    * supports it: the scanout address changes immediately instead of at the
+    * next vertical blank, trading tearing for up to a refresh cycle of
+    * latency. Sticky-off once the kernel has rejected an async flip.
+    *
+    * @param display The DRM display the flip will be queued on.
+    *
+    * @return true when DRM_MODE_PAGE_FLIP_ASYNC should be set on the flip.
+    */
+   bool use_async_flip(const drm_display &display) const;
+
+   /**
+    * @brief Block until the outstanding non-blocking flip has completed.
+    *
+    * @param display           The DRM display the flip was queued on.
+    * @param recycle_displaced Whether to release the image that the completed flip
+    *                          replaced on screen back to the application.
+    */
+   void complete_pending_flip(const drm_display &display, bool recycle_displaced);
+
+   /**
+    * @brief Record the CRTC's vblank counter for a just presented frame.
+    *
+    * Feeds the hardware count into the frame latency instrumentation so dropped
+    * frames show up as exact gaps in the counter rather than being inferred from
+    * timestamps. A no-op unless the latency tracker is enabled.
+    *
+    * @param display     The DRM display the frame was presented on.
+    * @param image_index The presented image's index.
+    */
+   void sample_vblank_counter(const drm_display &display, uint32_t image_index);
+
    VkResult allocate_wsialloc(VkImageCreateInfo &image_create_info, display_image_data *image_data,
                               util::vector<wsialloc_format> &importable_formats, wsialloc_format *allocated_format,
                               bool avoid_allocation);
@@ -124,6 +234,18 @@ private:
 
    VkResult create_framebuffer(const VkImageCreateInfo &image_create_info, display_image_data *image_data);
 
+   /**
+    * @brief Detect whether the render device differs from the display device.
+    *
+    * Compares the render device's primary DRM node against the display's node
+    * and sets @ref m_is_cross_adapter accordingly. Swapchain memory always
+    * comes from the external allocator and reaches the render device as
+    * imported dmabufs, so the cross-adapter case only constrains the format
+    * negotiation: every candidate modifier must be importable by the render
+    * device and scannable by the display device.
+    */
+   void detect_cross_adapter();
+
    /**
     * @brief Adds required extensions to the extension list of the swapchain
     *
@@ -135,7 +257,80 @@ private:
 
    wsialloc_allocator *m_wsi_allocator;
    drm_display_mode *m_display_mode;
+
+   /**
+    * @brief Index of the hardware plane this swapchain scans out on, from the surface.
+    *
+    * Index 0 is the primary plane; overlay planes are only exposed when atomic commits
+    * are supported.
+    */
+   uint32_t m_plane_index;
+
    image_creation_parameters m_image_creation_parameters;
+
+   /**
+    * @brief True while a non-blocking atomic flip is queued in the kernel.
+    */
+   bool m_pending_flip;
+
+   /**
+    * @brief Image replaced on screen by the queued flip, released on its completion.
+    */
+   uint32_t m_displaced_image_index;
+
+   /**
+    * @brief Set by the DRM event handler when the queued flip has completed.
+    */
+   bool m_flip_event_received;
+
+   /**
+    * @brief CLOCK_MONOTONIC time of the previous present in nanoseconds, 0 before the first.
+    */
+   uint64_t m_last_present_time_ns;
+
+   /**
+    * @brief Exponential moving average of the inter-present interval in nanoseconds.
+    */
+   uint64_t m_frame_interval_ns;
+
+   /**
+    * @brief Exponential moving average of the interval's deviation from @ref m_frame_interval_ns.
+    */
+   uint64_t m_frame_interval_jitter_ns;
+
+   /**
+    * @brief Whether VRR_ENABLED is currently programmed on the CRTC.
+    */
+   bool m_vrr_enabled;
+
+   /**
+    * @brief Surface counters requested with VkSwapchainCounterCreateInfoEXT at creation.
+    */
+   VkSurfaceCounterFlagsEXT m_enabled_surface_counters;
+
+   /**
+    * @brief Set when the kernel rejects an async flip; later presents stay vsynced.
+    */
+   bool m_async_flip_rejected;
+
+   /**
+    * @brief Whether rendering and scanout happen on different GPUs.
+    *
+    * Set when the render device's primary DRM node, as reported by
+    * VK_EXT_physical_device_drm, is not the display device. False when the
+    * extension is unavailable, in which case the single-GPU case is assumed.
+    */
+   bool m_is_cross_adapter;
+
+   /**
+    * @brief The preTransform the swapchain was created with.
+    *
+    * When it matches the panel transform advertised in the surface
+    * capabilities, the atomic modeset programs the plane rotation that undoes
+    * the application's pre-rotation, so the scanout hardware performs the
+    * rotation instead of a GPU pass.
+    */
+   VkSurfaceTransformFlagBitsKHR m_pre_transform;
 };
 } /* namespace display */
 
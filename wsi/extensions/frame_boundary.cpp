@@ -38,37 +38,34 @@ wsi_ext_frame_boundary::wsi_ext_frame_boundary(const layer::device_private_data
 }
 
 std::optional<VkFrameBoundaryEXT> wsi_ext_frame_boundary::handle_frame_boundary_event(
-   const VkPresentInfoKHR *present_info, VkImage *current_image_to_be_presented)
+   const VkFrameBoundaryEXT *app_frame_boundary, VkImage *current_image_to_be_presented)
 {
    /* If frame boundary feature is not enabled by the application, the layer will
     * pass its own frame boundary events back to ICD. Otherwise, let the application
     * handle the frame boundary events. */
 
-   /* First, check if the application passed any frame boundary events and if that's
-    * the case, just forward it at queue submission. */
-   auto application_frame_boundary_event = wsi::create_frame_boundary(*present_info);
-   if (application_frame_boundary_event.has_value())
+   /* First, check if the application passed a frame boundary event and if that's
+    * the case, just forward it at queue submission. The copy avoids passing
+    * other, unrelated chained structures to vkQueueSubmit. */
+   if (app_frame_boundary != nullptr)
    {
-      return application_frame_boundary_event;
+      return util::shallow_copy_extension(app_frame_boundary);
    }
 
    if (m_handle_frame_boundary_events)
    {
-      return create_frame_boundary(current_image_to_be_presented);
+      return create_frame_boundary(current_image_to_be_presented, 1);
    }
 
    return std::nullopt;
 }
 
-std::optional<VkFrameBoundaryEXT> create_frame_boundary(const VkPresentInfoKHR &present_info)
+std::optional<VkFrameBoundaryEXT> wsi_ext_frame_boundary::create_layer_frame_boundary(VkImage *images,
+                                                                                      uint32_t image_count)
 {
-   auto *present_frame_boundary =
-      util::find_extension<VkFrameBoundaryEXT>(VK_STRUCTURE_TYPE_PRESENT_ID_KHR, present_info.pNext);
-
-   /* Extract the VkFrameBoundaryEXT structure to avoid passing other, unrelated structures to vkQueueSubmit */
-   if (present_frame_boundary != nullptr)
+   if (m_handle_frame_boundary_events)
    {
-      return util::shallow_copy_extension(present_frame_boundary);
+      return create_frame_boundary(images, image_count);
    }
 
    return std::nullopt;
@@ -79,7 +76,7 @@ bool wsi_ext_frame_boundary::should_layer_handle_frame_boundary_events() const
    return m_handle_frame_boundary_events;
 }
 
-VkFrameBoundaryEXT wsi_ext_frame_boundary::create_frame_boundary(VkImage *image)
+VkFrameBoundaryEXT wsi_ext_frame_boundary::create_frame_boundary(VkImage *images, uint32_t image_count)
 {
    VkFrameBoundaryEXT frame_boundary{};
    frame_boundary.pNext = nullptr;
@@ -90,8 +87,8 @@ VkFrameBoundaryEXT wsi_ext_frame_boundary::create_frame_boundary(VkImage *image)
     * number frame ID could remain the same until the image is picked
     * up by the thread so we use our own counter for the frame boundary. */
    frame_boundary.frameID = m_current_frame_boundary_id++;
-   frame_boundary.imageCount = 1;
-   frame_boundary.pImages = image;
+   frame_boundary.imageCount = image_count;
+   frame_boundary.pImages = images;
    frame_boundary.pBuffers = nullptr;
    frame_boundary.bufferCount = 0;
 
@@ -107,16 +104,22 @@ VkFrameBoundaryEXT wsi_ext_frame_boundary::create_frame_boundary(VkImage *image)
    return frame_boundary;
 }
 
-std::optional<VkFrameBoundaryEXT> handle_frame_boundary_event(const VkPresentInfoKHR *present_info,
+std::optional<VkFrameBoundaryEXT> handle_frame_boundary_event(const VkFrameBoundaryEXT *app_frame_boundary,
                                                               VkImage *current_image_to_be_presented,
                                                               wsi::wsi_ext_frame_boundary *frame_boundary)
 {
    if (frame_boundary)
    {
-      return frame_boundary->handle_frame_boundary_event(present_info, current_image_to_be_presented);
+      return frame_boundary->handle_frame_boundary_event(app_frame_boundary, current_image_to_be_presented);
+   }
+
+   /* No extension object: forward the application's boundary, if any. */
+   if (app_frame_boundary != nullptr)
+   {
+      return util::shallow_copy_extension(app_frame_boundary);
    }
 
-   return create_frame_boundary(*present_info);
+   return std::nullopt;
 }
 
 }
@@ -62,20 +62,38 @@ public:
    /**
     * @brief Handle frame boundary event at present time
     *
-    * @param present_info Information about the swapchain and image to be presented.
+    * @param app_frame_boundary Frame boundary the application chained to the present info,
+    *                           as indexed by index_present_info_extensions(), or nullptr.
     * @param current_image_to_be_presented Address to the currently to be presented image
     */
-   std::optional<VkFrameBoundaryEXT> handle_frame_boundary_event(const VkPresentInfoKHR *present_info,
+   std::optional<VkFrameBoundaryEXT> handle_frame_boundary_event(const VkFrameBoundaryEXT *app_frame_boundary,
                                                                  VkImage *current_image_to_be_presented);
 
+   /**
+    * @brief Create a layer-generated frame boundary for a batched submission.
+    *
+    * Covers every image of a multi-swapchain present in a single boundary so
+    * boundary tracking can ride the batched payload submission instead of
+    * costing a queue submission of its own.
+    *
+    * @param images      The images presented this frame. Must stay valid until the
+    *                    submission carrying the boundary has been made.
+    * @param image_count Number of entries in @p images.
+    *
+    * @return Frame boundary when the layer is configured to generate frame
+    *         boundary events, otherwise std::nullopt.
+    */
+   std::optional<VkFrameBoundaryEXT> create_layer_frame_boundary(VkImage *images, uint32_t image_count);
+
 private:
    /**
-    * @brief Create a frame boundary with the current image
+    * @brief Create a frame boundary with the given images
     *
-    * @param image Address to the currently to be presented image
+    * @param images      Address of the images presented this frame
+    * @param image_count Number of entries in @p images
     * @return Frame boundary structure
     */
-   VkFrameBoundaryEXT create_frame_boundary(VkImage *image);
+   VkFrameBoundaryEXT create_frame_boundary(VkImage *images, uint32_t image_count);
 
    /**
     * @brief Check whether we should handle frame boundary events.
@@ -95,22 +113,15 @@ private:
    const bool m_handle_frame_boundary_events;
 };
 
-/**
- * @brief Create a frame boundary object
- *
- * @param present_info Present info
- * @return Frame boundary if @p present_info has passed it.
- */
-std::optional<VkFrameBoundaryEXT> create_frame_boundary(const VkPresentInfoKHR &present_info);
-
 /**
  * @brief Handle frame boundary event at present time
  *
- * @param present_info Information about the swapchain and image to be presented.
+ * @param app_frame_boundary Frame boundary the application chained to the present info,
+ *                           as indexed by index_present_info_extensions(), or nullptr.
  * @param current_image_to_be_presented Address to the currently to be presented image
  * @param frame_boundary Frame boundary extension for current backend or nullptr if not enabled.
  */
-std::optional<VkFrameBoundaryEXT> handle_frame_boundary_event(const VkPresentInfoKHR *present_info,
+std::optional<VkFrameBoundaryEXT> handle_frame_boundary_event(const VkFrameBoundaryEXT *app_frame_boundary,
                                                               VkImage *current_image_to_be_presented,
                                                               wsi::wsi_ext_frame_boundary *frame_boundary);
 
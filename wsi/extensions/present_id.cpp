@@ -29,16 +29,111 @@
  */
 #include "present_id.hpp"
 
+#include <cassert>
+#include <cerrno>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 namespace wsi
 {
 
+namespace
+{
+
+constexpr uint64_t NSEC_PER_SEC = 1000ull * 1000ull * 1000ull;
+
+long futex(std::atomic<uint32_t> *word, int op, uint32_t value, const struct timespec *timeout)
+{
+   return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), op, value, timeout, nullptr, 0);
+}
+
+uint64_t monotonic_now_ns()
+{
+   struct timespec now = {};
+   int res = clock_gettime(CLOCK_MONOTONIC, &now);
+   assert(res == 0); /* only fails with programming error (EINVAL, EFAULT, EPERM) */
+   (void)res;
+   return static_cast<uint64_t>(now.tv_sec) * NSEC_PER_SEC + static_cast<uint64_t>(now.tv_nsec);
+}
+
+} /* anonymous namespace */
+
 void wsi_ext_present_id::set_present_id(uint64_t value)
 {
    if (value != 0)
    {
-      assert(value > m_present_id);
-      m_present_id = value;
+      assert(value > m_present_id.load(std::memory_order_relaxed));
+      m_present_id.store(value, std::memory_order_release);
+      m_generation.fetch_add(1, std::memory_order_seq_cst);
+
+      if (m_waiters.load(std::memory_order_seq_cst) > 0)
+      {
+         /* Wake everyone: waiters target different IDs, so each re-checks and
+          * goes back to sleep if its target has not been reached yet. */
+         futex(&m_generation, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr);
+      }
+   }
+}
+
+VkResult wsi_ext_present_id::wait_for_present_id(uint64_t present_id, uint64_t timeout)
+{
+   if (m_present_id.load(std::memory_order_acquire) >= present_id)
+   {
+      return VK_SUCCESS;
+   }
+
+   if (timeout == 0)
+   {
+      return VK_TIMEOUT;
    }
+
+   const bool indefinite = timeout == UINT64_MAX;
+   const uint64_t deadline = indefinite ? 0 : monotonic_now_ns() + timeout;
+
+   m_waiters.fetch_add(1, std::memory_order_seq_cst);
+
+   VkResult retval = VK_SUCCESS;
+   while (true)
+   {
+      const uint32_t generation = m_generation.load(std::memory_order_seq_cst);
+      if (m_present_id.load(std::memory_order_acquire) >= present_id)
+      {
+         break;
+      }
+
+      struct timespec remaining_ts = {};
+      const struct timespec *remaining = nullptr;
+      if (!indefinite)
+      {
+         uint64_t now = monotonic_now_ns();
+         if (now >= deadline)
+         {
+            retval = VK_TIMEOUT;
+            break;
+         }
+         uint64_t remaining_ns = deadline - now;
+         remaining_ts.tv_sec = static_cast<time_t>(remaining_ns / NSEC_PER_SEC);
+         remaining_ts.tv_nsec = static_cast<long>(remaining_ns % NSEC_PER_SEC);
+         remaining = &remaining_ts;
+      }
+
+      /* FUTEX_WAIT timeouts are relative and measured against CLOCK_MONOTONIC,
+       * so a system time change cannot distort the wait. */
+      long res = futex(&m_generation, FUTEX_WAIT_PRIVATE, generation, remaining);
+      /* EAGAIN means the generation changed before we slept, EINTR that a
+       * signal woke us; both just mean "re-check". A timeout is detected by
+       * the deadline check above so the extra ID check after ETIMEDOUT gives
+       * one last chance to an update racing the expiry. */
+      assert(res == 0 || errno == EAGAIN || errno == EINTR || errno == ETIMEDOUT);
+      (void)res;
+   }
+
+   m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+
+   return retval;
 }
 
 };
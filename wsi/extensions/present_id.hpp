@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
 #include <util/custom_allocator.hpp>
 #include <util/macros.hpp>
 
@@ -55,15 +58,50 @@ public:
    /**
     * @brief Set the present ID for the swapchain.
     *
+    * Updates the published ID and wakes any threads sleeping in
+    * wait_for_present_id(). Called by the page flip thread once the
+    * presentation request has been handed to the presentation engine.
+    *
     * @param value Value to set for the present_id.
     */
    void set_present_id(uint64_t value);
 
+   /**
+    * @brief Block until the swapchain's present ID reaches @p present_id.
+    *
+    * Sleeps on a futex that is only woken when the published ID changes, so a
+    * waiter does not wake on frames that cannot satisfy its target.
+    *
+    * @param present_id The present ID to wait for.
+    * @param timeout    Time to wait (ns). 0 doesn't block, UINT64_MAX waits indefinitely.
+    *
+    * @retval VK_SUCCESS the present ID was reached.
+    * @retval VK_TIMEOUT the timeout expired first.
+    */
+   VkResult wait_for_present_id(uint64_t present_id, uint64_t timeout);
+
 private:
    /**
     * @brief Current present ID for this swapchain.
+    *
+    * Written by the page flip thread, read by waiters without a lock.
+    */
+   std::atomic<uint64_t> m_present_id{ 0 };
+
+   /**
+    * @brief Futex word bumped on every present ID update.
+    *
+    * The ID itself is 64-bit and a futex word is 32, so waiters sleep on this
+    * generation counter and re-check the ID after each wake.
+    */
+   std::atomic<uint32_t> m_generation{ 0 };
+
+   /**
+    * @brief Number of threads that are sleeping, or about to sleep, on the futex.
+    *
+    * Lets set_present_id() skip the wake syscall when nobody is waiting.
     */
-   uint64_t m_present_id{ 0 };
+   std::atomic<uint32_t> m_waiters{ 0 };
 };
 
 } /* namespace wsi */
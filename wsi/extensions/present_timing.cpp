@@ -49,6 +49,8 @@ wsi_ext_present_timing::~wsi_ext_present_timing()
 
 VkResult wsi_ext_present_timing::present_timing_queue_set_size(size_t queue_size)
 {
+   TRY(drain_presentation_entries());
+
    if (present_timing_get_num_outstanding_results() > queue_size)
    {
       return VK_NOT_READY;
@@ -90,13 +92,28 @@ size_t wsi_ext_present_timing::present_timing_get_num_outstanding_results()
 
 VkResult wsi_ext_present_timing::add_presentation_entry(const wsi::swapchain_presentation_entry &presentation_entry)
 {
-   if (!m_queue.m_timings.try_push_back(presentation_entry))
+   /* The presentation path must not touch m_queue, which may concurrently be
+    * read by a query entrypoint; stage the entry in the lock-free ring
+    * instead. */
+   if (!m_pending_entries.push_back(presentation_entry))
    {
       return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
    return VK_SUCCESS;
 }
 
+VkResult wsi_ext_present_timing::drain_presentation_entries()
+{
+   while (auto entry = m_pending_entries.pop_front())
+   {
+      if (!m_queue.m_timings.try_push_back(*entry))
+      {
+         return VK_ERROR_OUT_OF_HOST_MEMORY;
+      }
+   }
+   return VK_SUCCESS;
+}
+
 swapchain_time_domains &wsi_ext_present_timing::get_swapchain_time_domains()
 {
    return m_time_domains;
@@ -34,6 +34,7 @@
 #include <layer/wsi_layer_experimental.hpp>
 #include <util/custom_allocator.hpp>
 #include <util/macros.hpp>
+#include <util/ring_buffer.hpp>
 
 #include <iterator>
 #include <type_traits>
@@ -229,12 +230,16 @@ public:
    /**
     * @brief Add a presentation entry to the present timing queue.
     *
-    * This API pushes a presentation entry to the present timing queue.
+    * This API stages a presentation entry for the present timing queue. The
+    * entry is placed in a fixed capacity lock-free ring buffer so the
+    * presentation hot path never blocks on a thread that is reading the
+    * queue; staged entries are moved into the queue the next time it is
+    * accessed from a query entrypoint.
     *
     * @param sc_presentation_entry Reference to the presentation entry to be added.
     *
-    * @return VK_SUCCESS when the entry was inserted successfully and VK_ERROR_OUT_OF_HOST_MEMORY
-    * when there is no host memory.
+    * @return VK_SUCCESS when the entry was staged successfully and VK_ERROR_OUT_OF_HOST_MEMORY
+    * when no slot is available.
     */
    VkResult add_presentation_entry(const wsi::swapchain_presentation_entry &sc_presentation_entry);
 
@@ -261,6 +266,32 @@ protected:
    const util::allocator m_allocator;
 
 private:
+   /**
+    * @brief Move any staged presentation entries into the timing queue.
+    *
+    * Drains the lock-free staging ring buffer into m_queue. Must only be
+    * called from the query entrypoints, which are externally synchronized
+    * with respect to the swapchain.
+    *
+    * @return VK_SUCCESS on success, VK_ERROR_OUT_OF_HOST_MEMORY if the
+    * queue could not hold a staged entry.
+    */
+   VkResult drain_presentation_entries();
+
+   /**
+    * @brief The maximum number of presentation entries that can be staged
+    * between two accesses to the timing queue.
+    */
+   static constexpr std::size_t PENDING_PRESENTATION_ENTRIES = 64;
+
+   /**
+    * @brief Lock-free staging buffer for presentation entries.
+    *
+    * Written by the threads calling vkQueuePresentKHR and drained into
+    * m_queue by the present timing query entrypoints.
+    */
+   util::mpsc_ring_buffer<swapchain_presentation_entry, PENDING_PRESENTATION_ENTRIES> m_pending_entries;
+
    /**
     * @brief The presentation timing queue.
     */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022-2024 Arm Limited.
+ * Copyright (c) 2022-2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -26,6 +26,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <algorithm>
 
@@ -112,22 +113,35 @@ VkResult external_memory::configure_for_host_visible(const VkImageCreateInfo &im
    
    m_num_planes = 1;
    m_num_memories = 1;
-   
+
    return VK_SUCCESS;
 }
 
+void external_memory::configure_for_host_visible_slice(VkDeviceMemory memory, VkDeviceSize offset, void *mapped_ptr,
+                                                       bool memory_cached)
+{
+   assert(m_memory_type == wsi_memory_type::HOST_VISIBLE);
+
+   m_host_memory = memory;
+   m_host_memory_offset = offset;
+   m_host_mapped_ptr = mapped_ptr;
+   m_owns_host_memory = false;
+   m_host_memory_cached = memory_cached;
+}
+
 VkResult external_memory::get_fd_mem_type_index(int fd, uint32_t *mem_idx)
 {
    auto &device_data = layer::device_private_data::get(m_device);
-   VkMemoryFdPropertiesKHR mem_props = {};
-   mem_props.sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR;
 
-   TRY_LOG(device_data.disp.GetMemoryFdPropertiesKHR(m_device, m_handle_type, fd, &mem_props),
-           "Error querying file descriptor properties");
+   /* The query result is memoized per buffer in the device private data, as
+    * every plane of every swapchain image would otherwise pay for the same
+    * round trip to the driver. */
+   uint32_t mem_type_bits = 0;
+   TRY_LOG_CALL(device_data.get_fd_memory_type_bits(m_handle_type, fd, &mem_type_bits));
 
    for (*mem_idx = 0; *mem_idx < VK_MAX_MEMORY_TYPES; (*mem_idx)++)
    {
-      if (mem_props.memoryTypeBits & (1 << *mem_idx))
+      if (mem_type_bits & (1 << *mem_idx))
       {
          break;
       }
@@ -138,19 +152,68 @@ VkResult external_memory::get_fd_mem_type_index(int fd, uint32_t *mem_idx)
    return VK_SUCCESS;
 }
 
+/**
+ * @brief Check whether two fds refer to the same underlying buffer.
+ *
+ * Planes of a non-disjoint allocation can be returned as dup'd fds of the same
+ * dma-buf, which compare unequal as descriptors but share the inode of the
+ * buffer's anonymous file.
+ */
+static bool is_same_buffer(int fd_a, int fd_b)
+{
+   if (fd_a == fd_b)
+   {
+      return true;
+   }
+
+   struct stat stat_a = {};
+   struct stat stat_b = {};
+   if (fstat(fd_a, &stat_a) != 0 || fstat(fd_b, &stat_b) != 0)
+   {
+      return false;
+   }
+
+   return stat_a.st_dev == stat_b.st_dev && stat_a.st_ino == stat_b.st_ino && stat_a.st_size == stat_b.st_size;
+}
+
 VkResult external_memory::import_plane_memories()
 {
    if (is_disjoint())
    {
       uint32_t memory_plane = 0;
+      std::array<uint32_t, MAX_PLANES> import_source_plane = {};
       for (uint32_t plane = 0; plane < get_num_planes(); plane++)
       {
          auto it = std::find(std::begin(m_buffer_fds), std::end(m_buffer_fds), m_buffer_fds[plane]);
-         if (std::distance(std::begin(m_buffer_fds), it) == static_cast<int>(plane))
+         if (std::distance(std::begin(m_buffer_fds), it) != static_cast<int>(plane))
+         {
+            continue;
+         }
+
+         /* Planes can also reference the same buffer through dup'd fds; reuse
+          * the import made for the first such plane instead of importing the
+          * same buffer again. Aliased handles are deduplicated again when the
+          * memory is freed. */
+         int aliased_memory = -1;
+         for (uint32_t memory = 0; memory < memory_plane; memory++)
+         {
+            if (is_same_buffer(m_buffer_fds[import_source_plane[memory]], m_buffer_fds[plane]))
+            {
+               aliased_memory = static_cast<int>(memory);
+               break;
+            }
+         }
+
+         if (aliased_memory >= 0)
+         {
+            m_memories[memory_plane] = m_memories[aliased_memory];
+         }
+         else
          {
             TRY_LOG_CALL(import_plane_memory(m_buffer_fds[plane], &m_memories[memory_plane]));
-            memory_plane++;
          }
+         import_source_plane[memory_plane] = plane;
+         memory_plane++;
       }
       return VK_SUCCESS;
    }
@@ -263,16 +326,25 @@ void external_memory::fill_external_info(VkExternalMemoryImageCreateInfoKHR &ext
    external_info.handleTypes = m_handle_type;
 }
 
-VkResult external_memory::find_host_visible_memory_type(const VkMemoryRequirements &mem_requirements, uint32_t *memory_type_index)
+/**
+ * @brief Find a memory type satisfying the requirements and property flags.
+ *
+ * Tries the optimal flags first and falls back to the required ones. The full
+ * property flags of the chosen type are returned so callers can record
+ * properties they asked for only optimally, such as HOST_CACHED_BIT.
+ */
+static VkResult find_memory_type_with_props(const VkDevice &device, const VkMemoryRequirements &mem_requirements,
+                                            VkMemoryPropertyFlags optimal_props, VkMemoryPropertyFlags required_props,
+                                            uint32_t *memory_type_index, VkMemoryPropertyFlags *memory_type_props)
 {
-   auto &device_data = layer::device_private_data::get(m_device);
-   
+   auto &device_data = layer::device_private_data::get(device);
+
    VkPhysicalDeviceMemoryProperties2 memory_props = {};
    memory_props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
    device_data.instance_data.disp.GetPhysicalDeviceMemoryProperties2KHR(device_data.physical_device, &memory_props);
-   
-   VkMemoryPropertyFlags props_to_try[] = { m_optimal_props, m_required_props };
-   
+
+   VkMemoryPropertyFlags props_to_try[] = { optimal_props, required_props };
+
    for (VkMemoryPropertyFlags props : props_to_try)
    {
       for (uint32_t i = 0; i < memory_props.memoryProperties.memoryTypeCount; i++)
@@ -281,36 +353,63 @@ VkResult external_memory::find_host_visible_memory_type(const VkMemoryRequiremen
              (memory_props.memoryProperties.memoryTypes[i].propertyFlags & props) == props)
          {
             *memory_type_index = i;
+            *memory_type_props = memory_props.memoryProperties.memoryTypes[i].propertyFlags;
             return VK_SUCCESS;
          }
       }
    }
-   
+
    return VK_ERROR_FORMAT_NOT_SUPPORTED;
 }
 
+VkResult external_memory::find_host_visible_memory_type(const VkMemoryRequirements &mem_requirements, uint32_t *memory_type_index)
+{
+   VkMemoryPropertyFlags memory_type_props = 0;
+   TRY(find_memory_type_with_props(m_device, mem_requirements, m_optimal_props, m_required_props, memory_type_index,
+                                   &memory_type_props));
+   m_host_memory_cached = (memory_type_props & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) != 0;
+   return VK_SUCCESS;
+}
+
 VkResult external_memory::allocate_host_visible_and_bind(const VkImage &image, const VkImageCreateInfo &image_info)
 {
    UNUSED(image_info);
    auto &device_data = layer::device_private_data::get(m_device);
-   
+
+   if (!m_owns_host_memory)
+   {
+      /* The swapchain's memory slab has already made (and possibly mapped) the
+       * allocation; only the bind and the layout query are per image. */
+      TRY_LOG(device_data.disp.BindImageMemory(m_device, image, m_host_memory, m_host_memory_offset),
+              "Failed to bind slab memory to image");
+
+      VkImageSubresource subresource = {};
+      subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      subresource.mipLevel = 0;
+      subresource.arrayLayer = 0;
+
+      device_data.disp.GetImageSubresourceLayout(m_device, image, &subresource, &m_host_layout);
+
+      return VK_SUCCESS;
+   }
+
    VkMemoryRequirements mem_requirements;
    device_data.disp.GetImageMemoryRequirements(m_device, image, &mem_requirements);
-   
+
    uint32_t memory_type_index;
    TRY_LOG_CALL(find_host_visible_memory_type(mem_requirements, &memory_type_index));
-   
+
    VkMemoryAllocateInfo alloc_info = {};
    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
    alloc_info.allocationSize = mem_requirements.size;
    alloc_info.memoryTypeIndex = memory_type_index;
-   
+
    TRY_LOG(device_data.disp.AllocateMemory(m_device, &alloc_info, m_allocator.get_original_callbacks(), &m_host_memory),
            "Failed to allocate host-visible memory");
-   
+
    TRY_LOG(device_data.disp.BindImageMemory(m_device, image, m_host_memory, 0),
            "Failed to bind host-visible memory to image");
-   
+
    VkImageSubresource subresource = {};
    subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
    subresource.mipLevel = 0;
@@ -333,7 +432,15 @@ VkResult external_memory::map_host_memory(void **mapped_ptr)
       *mapped_ptr = m_host_mapped_ptr;
       return VK_SUCCESS;
    }
-   
+
+   if (!m_owns_host_memory)
+   {
+      /* The slab memory may already be mapped for its other slices; mapping it
+       * again per image would be invalid. Slices either come pre-mapped or not
+       * at all. */
+      return VK_ERROR_MEMORY_MAP_FAILED;
+   }
+
    auto &device_data = layer::device_private_data::get(m_device);
    VkResult result = device_data.disp.MapMemory(m_device, m_host_memory, 0, VK_WHOLE_SIZE, 0, &m_host_mapped_ptr);
    if (result == VK_SUCCESS)
@@ -346,7 +453,7 @@ VkResult external_memory::map_host_memory(void **mapped_ptr)
 
 void external_memory::unmap_host_memory()
 {
-   if (m_host_mapped_ptr != nullptr && m_host_memory != VK_NULL_HANDLE)
+   if (m_host_mapped_ptr != nullptr && m_host_memory != VK_NULL_HANDLE && m_owns_host_memory)
    {
       auto &device_data = layer::device_private_data::get(m_device);
       device_data.disp.UnmapMemory(m_device, m_host_memory);
@@ -382,6 +489,14 @@ VkResult external_memory::allocate_and_bind_image(const VkImage &image, const Vk
 
 void external_memory::cleanup_host_visible_memory()
 {
+   if (!m_owns_host_memory)
+   {
+      /* The slab owns the memory and its mapping; they outlive the images. */
+      m_host_memory = VK_NULL_HANDLE;
+      m_host_mapped_ptr = nullptr;
+      return;
+   }
+
    if (m_host_mapped_ptr)
    {
       auto &device_data = layer::device_private_data::get(m_device);
@@ -404,8 +519,14 @@ void external_memory::cleanup_external_memory()
       auto &memory = m_memories[plane];
       if (memory != VK_NULL_HANDLE)
       {
-         auto &device_data = layer::device_private_data::get(m_device);
-         device_data.disp.FreeMemory(m_device, memory, m_allocator.get_original_callbacks());
+         /* Planes referencing the same buffer alias a single import, only the
+          * first occurrence of a handle owns the memory. */
+         auto it = std::find(std::begin(m_memories), std::begin(m_memories) + plane, memory);
+         if (it == std::begin(m_memories) + plane)
+         {
+            auto &device_data = layer::device_private_data::get(m_device);
+            device_data.disp.FreeMemory(m_device, memory, m_allocator.get_original_callbacks());
+         }
       }
       else if (m_buffer_fds[plane] >= 0)
       {
@@ -418,4 +539,116 @@ void external_memory::cleanup_external_memory()
    }
 }
 
+device_memory_slab::device_memory_slab(const VkDevice &device, const util::allocator &allocator)
+   : m_device(device)
+   , m_allocator(allocator)
+{
+}
+
+device_memory_slab::~device_memory_slab()
+{
+   if (m_memory != VK_NULL_HANDLE)
+   {
+      auto &device_data = layer::device_private_data::get(m_device);
+      if (m_mapped_ptr != nullptr)
+      {
+         device_data.disp.UnmapMemory(m_device, m_memory);
+      }
+      device_data.disp.FreeMemory(m_device, m_memory, m_allocator.get_original_callbacks());
+   }
+}
+
+void device_memory_slab::configure(uint32_t image_count, VkMemoryPropertyFlags required_props,
+                                   VkMemoryPropertyFlags optimal_props, bool persistently_map)
+{
+   m_image_count = image_count;
+   m_required_props = required_props;
+   m_optimal_props = optimal_props;
+   m_persistently_map = persistently_map;
+}
+
+VkResult device_memory_slab::allocate(const VkMemoryRequirements &requirements)
+{
+   auto &device_data = layer::device_private_data::get(m_device);
+
+   VkPhysicalDeviceProperties device_props = {};
+   device_data.instance_data.disp.GetPhysicalDeviceProperties(device_data.physical_device, &device_props);
+
+   /* Both the alignment and bufferImageGranularity are powers of two, so the
+    * larger of the two satisfies both; spacing slices by the image size
+    * rounded up to it keeps neighbouring slices out of each other's
+    * granularity pages. */
+   VkDeviceSize granularity = std::max<VkDeviceSize>(requirements.alignment,
+                                                     device_props.limits.bufferImageGranularity);
+   m_slice_stride = (requirements.size + granularity - 1) & ~(granularity - 1);
+
+   uint32_t memory_type_index = 0;
+   VkMemoryPropertyFlags memory_type_props = 0;
+   TRY_LOG_CALL(find_memory_type_with_props(m_device, requirements, m_optimal_props, m_required_props,
+                                            &memory_type_index, &memory_type_props));
+   m_memory_cached = (memory_type_props & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) != 0;
+
+   VkMemoryAllocateInfo alloc_info = {};
+   alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+   alloc_info.allocationSize = m_slice_stride * m_image_count;
+   alloc_info.memoryTypeIndex = memory_type_index;
+
+   TRY_LOG(device_data.disp.AllocateMemory(m_device, &alloc_info, m_allocator.get_original_callbacks(), &m_memory),
+           "Failed to allocate the swapchain memory slab");
+
+   if (m_persistently_map)
+   {
+      VkResult result = device_data.disp.MapMemory(m_device, m_memory, 0, VK_WHOLE_SIZE, 0, &m_mapped_ptr);
+      if (result != VK_SUCCESS)
+      {
+         WSI_LOG_ERROR("Failed to map the swapchain memory slab.");
+         device_data.disp.FreeMemory(m_device, m_memory, m_allocator.get_original_callbacks());
+         m_memory = VK_NULL_HANDLE;
+         return result;
+      }
+   }
+
+   return VK_SUCCESS;
+}
+
+VkResult device_memory_slab::acquire_slice(const VkImage &image, VkDeviceMemory *memory, VkDeviceSize *offset,
+                                           void **mapped_ptr)
+{
+   auto &device_data = layer::device_private_data::get(m_device);
+
+   VkMemoryRequirements requirements = {};
+   device_data.disp.GetImageMemoryRequirements(m_device, image, &requirements);
+
+   std::lock_guard<std::mutex> lock(m_lock);
+
+   if (m_memory == VK_NULL_HANDLE)
+   {
+      if (m_allocation_failed)
+      {
+         return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+      }
+      VkResult result = allocate(requirements);
+      if (result != VK_SUCCESS)
+      {
+         m_allocation_failed = true;
+         return result;
+      }
+   }
+
+   if (m_next_slice >= m_image_count || requirements.size > m_slice_stride)
+   {
+      /* More images than the slab was sized for, or an image whose
+       * requirements no longer match the first one; a dedicated allocation
+       * handles it. */
+      return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+   }
+
+   *offset = static_cast<VkDeviceSize>(m_next_slice) * m_slice_stride;
+   *memory = m_memory;
+   *mapped_ptr = m_mapped_ptr != nullptr ? static_cast<char *>(m_mapped_ptr) + *offset : nullptr;
+   m_next_slice++;
+
+   return VK_SUCCESS;
+}
+
 } // namespace wsi
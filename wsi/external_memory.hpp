@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022-2024 Arm Limited.
+ * Copyright (c) 2022-2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -32,6 +32,7 @@
 
 #include <array>
 #include <cstdint>
+#include <mutex>
 #include <vulkan/vulkan.h>
 
 #include "wsi/synchronization.hpp"
@@ -157,6 +158,24 @@ public:
                                        VkMemoryPropertyFlags required_props,
                                        VkMemoryPropertyFlags optimal_props);
 
+   /**
+    * @brief Configure to bind into a slice of a shared device memory allocation.
+    *
+    * Instead of allocating its own VkDeviceMemory the image binds at an offset
+    * into memory owned by a device_memory_slab, so a swapchain makes one driver
+    * allocation for all of its images. The memory is not owned: the slab frees
+    * it after the images are gone. Must be called after
+    * configure_for_host_visible().
+    *
+    * @param memory        The shared device memory.
+    * @param offset        Byte offset of this image's slice within the memory.
+    * @param mapped_ptr    Persistent mapping of the slice, or nullptr when the
+    *                      slab is not mapped.
+    * @param memory_cached Whether the slab's memory type is host cached.
+    */
+   void configure_for_host_visible_slice(VkDeviceMemory memory, VkDeviceSize offset, void *mapped_ptr,
+                                         bool memory_cached);
+
    /**
     * @brief Check if external_memory instance is properly configured.
     */
@@ -167,6 +186,20 @@ public:
     */
    bool is_host_visible() const;
 
+   /**
+    * @brief Whether the bound host-visible memory type is host cached.
+    *
+    * Recorded when the memory type is chosen at bind time. Host-visible types
+    * without VK_MEMORY_PROPERTY_HOST_CACHED_BIT are typically mapped
+    * write-combined, where CPU reads bypass the caches and run at a fraction
+    * of DRAM speed; readback paths use this to pick a streaming-load kernel
+    * without per-frame queries.
+    */
+   bool is_host_memory_cached() const
+   {
+      return m_host_memory_cached;
+   }
+
    /**
     * @brief Get current memory type.
     */
@@ -311,6 +344,11 @@ private:
    wsi_memory_type m_memory_type = wsi_memory_type::EXTERNAL_DMA_BUF;
    
    VkDeviceMemory m_host_memory = VK_NULL_HANDLE;
+   VkDeviceSize m_host_memory_offset = 0;
+   /** False when m_host_memory is a slice of a device_memory_slab. */
+   bool m_owns_host_memory = true;
+   /** Assume cached (ordinary memcpy readback) until the memory type is known. */
+   bool m_host_memory_cached = true;
    void* m_host_mapped_ptr = nullptr;
    VkSubresourceLayout m_host_layout = {};
    VkMemoryPropertyFlags m_required_props = 0;
@@ -320,4 +358,100 @@ private:
    const util::allocator &m_allocator;
 };
 
+/**
+ * @brief One larger device memory allocation backing every image of a swapchain.
+ *
+ * Swapchain images are created from identical create info, so their memory
+ * requirements match. The slab makes a single vkAllocateMemory call for the
+ * whole swapchain and hands each image a slice, spaced by the image size
+ * rounded up to the larger of the image alignment and bufferImageGranularity.
+ * One driver allocation instead of one per image cuts the per-allocation
+ * kernel overhead and metadata, and with it swapchain creation latency.
+ */
+class device_memory_slab
+{
+public:
+   device_memory_slab(const VkDevice &device, const util::allocator &allocator);
+   ~device_memory_slab();
+
+   /**
+    * @brief Arm the slab for a swapchain's images.
+    *
+    * Called once, before image allocation starts. The memory itself is
+    * allocated lazily by the first acquire_slice(), when an image exists to
+    * take the requirements from.
+    *
+    * @param image_count      Number of images the slab must hold.
+    * @param required_props   Required memory property flags.
+    * @param optimal_props    Optimal memory property flags (fallback to required).
+    * @param persistently_map Whether to map the slab for the lifetime of the
+    *                         swapchain and hand out per-slice pointers.
+    */
+   void configure(uint32_t image_count, VkMemoryPropertyFlags required_props, VkMemoryPropertyFlags optimal_props,
+                  bool persistently_map);
+
+   /**
+    * @brief Whether configure() has armed the slab.
+    */
+   bool is_configured() const
+   {
+      return m_image_count > 0;
+   }
+
+   /**
+    * @brief Claim the next slice for an image.
+    *
+    * Thread safe, as image allocation can run concurrently. On failure the
+    * slab stays usable for other images and the caller is expected to fall
+    * back to a dedicated allocation.
+    *
+    * @param image      The image the slice is for, used for the memory
+    *                   requirements query.
+    * @param memory     Set to the slab memory.
+    * @param offset     Set to the byte offset of the claimed slice.
+    * @param mapped_ptr Set to the persistent mapping of the slice, or nullptr
+    *                   when the slab is not mapped.
+    *
+    * @return VK_SUCCESS when a slice was claimed, otherwise an error code.
+    */
+   VkResult acquire_slice(const VkImage &image, VkDeviceMemory *memory, VkDeviceSize *offset, void **mapped_ptr);
+
+   /**
+    * @brief Whether the slab's memory type is host cached.
+    *
+    * Only meaningful after acquire_slice() has succeeded at least once.
+    */
+   bool is_memory_cached() const
+   {
+      return m_memory_cached;
+   }
+
+private:
+   /**
+    * @brief Allocate (and optionally map) the slab memory. Called under m_lock.
+    */
+   VkResult allocate(const VkMemoryRequirements &requirements);
+
+   const VkDevice &m_device;
+   const util::allocator &m_allocator;
+
+   /** Guards the allocation and the slice counter. */
+   std::mutex m_lock;
+
+   VkDeviceMemory m_memory = VK_NULL_HANDLE;
+   void *m_mapped_ptr = nullptr;
+   /** Bytes between consecutive slices; covers image size, alignment and bufferImageGranularity. */
+   VkDeviceSize m_slice_stride = 0;
+   /** Index of the next unclaimed slice. */
+   uint32_t m_next_slice = 0;
+   uint32_t m_image_count = 0;
+   VkMemoryPropertyFlags m_required_props = 0;
+   VkMemoryPropertyFlags m_optimal_props = 0;
+   bool m_persistently_map = false;
+   /** Remembers a failed allocation so later images fall back immediately. */
+   bool m_allocation_failed = false;
+   /** Whether the chosen memory type has VK_MEMORY_PROPERTY_HOST_CACHED_BIT. */
+   bool m_memory_cached = false;
+};
+
 } // namespace wsi
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Zero-copy capture of presented frames as dmabuf handles.
+ */
+
+#include "frame_capture.hpp"
+#include "external_memory.hpp"
+#include "synchronization.hpp"
+#include "util/helpers.hpp"
+
+#include <unistd.h>
+
+namespace wsi
+{
+
+static_assert(WSI_FRAME_CAPTURE_MAX_PLANES == util::MAX_PLANES,
+              "The consumer-facing plane cap must match the layer's plane limit");
+
+namespace
+{
+
+/**
+ * @brief Close every fd a frame owns; used when a claimed frame cannot be delivered.
+ */
+void close_frame_fds(const VkCapturedFrameWSI &frame)
+{
+   for (uint32_t plane = 0; plane < frame.planeCount; plane++)
+   {
+      if (frame.planeFds[plane] >= 0)
+      {
+         close(frame.planeFds[plane]);
+      }
+   }
+   if (frame.releaseFenceFd >= 0)
+   {
+      close(frame.releaseFenceFd);
+   }
+}
+
+} /* anonymous namespace */
+
+bool fill_captured_frame_from_dmabuf(external_memory &memory, sync_fd_fence_sync &present_fence,
+                                     VkCapturedFrameWSI &frame)
+{
+   const auto &buffer_fds = memory.get_buffer_fds();
+   if (memory.is_host_visible() || buffer_fds[0] < 0)
+   {
+      /* The image is not backed by exportable buffers, e.g. a host-visible
+       * image serving the X11 SHM presenter. */
+      return false;
+   }
+
+   /* Share rather than export: sync fd export resets the fence, and the
+    * presentation path exports the same payload for its own commit. */
+   auto release_fence = present_fence.share_sync_fd();
+   if (!release_fence.has_value())
+   {
+      return false;
+   }
+
+   const auto &strides = memory.get_strides();
+   const auto &offsets = memory.get_offsets();
+   frame.planeCount = memory.get_num_memories();
+   for (uint32_t plane = 0; plane < frame.planeCount; plane++)
+   {
+      int duplicated_fd = dup(buffer_fds[plane]);
+      if (duplicated_fd < 0)
+      {
+         while (plane > 0)
+         {
+            close(frame.planeFds[--plane]);
+         }
+         return false;
+      }
+      frame.planeFds[plane] = duplicated_fd;
+      frame.planeStrides[plane] = static_cast<uint32_t>(strides[plane]);
+      frame.planeOffsets[plane] = offsets[plane];
+   }
+
+   frame.releaseFenceFd = release_fence->release();
+   return true;
+}
+
+VkResult frame_capture::register_consumer(PFN_vkFrameCaptureCallbackWSI callback, void *user_data,
+                                          uint32_t max_pending_frames)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+   if (m_armed.load(std::memory_order_relaxed))
+   {
+      return VK_ERROR_INITIALIZATION_FAILED;
+   }
+
+   m_callback = callback;
+   m_user_data = user_data;
+   m_max_pending = max_pending_frames > 0 ? max_pending_frames : 1;
+   m_in_flight.store(0, std::memory_order_relaxed);
+   /* The release pairs with the acquire in try_claim_frame, which publishes
+    * the callback fields to the presentation thread without it taking the
+    * lock on every frame. */
+   m_armed.store(true, std::memory_order_release);
+   return VK_SUCCESS;
+}
+
+VkResult frame_capture::unregister_consumer()
+{
+   /* Taking the lock waits out a delivery in progress on the presentation
+    * thread, so the callback cannot fire after this returns. */
+   std::lock_guard<std::mutex> lock(m_lock);
+   m_armed.store(false, std::memory_order_relaxed);
+   m_callback = nullptr;
+   m_user_data = nullptr;
+   return VK_SUCCESS;
+}
+
+void frame_capture::complete_frame()
+{
+   /* A CAS loop rather than an unconditional decrement, so a spurious call
+    * with no frame outstanding cannot wrap the counter and disable the
+    * backpressure for good. */
+   uint32_t in_flight = m_in_flight.load(std::memory_order_relaxed);
+   while (in_flight > 0 && !m_in_flight.compare_exchange_weak(in_flight, in_flight - 1, std::memory_order_relaxed))
+   {
+   }
+}
+
+bool frame_capture::try_claim_frame()
+{
+   if (!m_armed.load(std::memory_order_acquire))
+   {
+      return false;
+   }
+
+   uint32_t in_flight = m_in_flight.load(std::memory_order_relaxed);
+   do
+   {
+      if (in_flight >= m_max_pending)
+      {
+         return false;
+      }
+   } while (!m_in_flight.compare_exchange_weak(in_flight, in_flight + 1, std::memory_order_relaxed));
+   return true;
+}
+
+void frame_capture::abandon_frame()
+{
+   m_in_flight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void frame_capture::deliver(const VkCapturedFrameWSI &frame)
+{
+   std::lock_guard<std::mutex> lock(m_lock);
+   if (!m_armed.load(std::memory_order_relaxed))
+   {
+      /* The consumer unregistered between the claim and the delivery. */
+      close_frame_fds(frame);
+      abandon_frame();
+      return;
+   }
+   m_callback(m_user_data, &frame);
+}
+
+} /* namespace wsi */
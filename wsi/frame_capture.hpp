@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Zero-copy capture of presented frames as dmabuf handles.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+/** Maximum number of memory planes a captured frame can carry. */
+#define WSI_FRAME_CAPTURE_MAX_PLANES 4
+
+/**
+ * @brief One presented frame, as handed to a frame capture callback.
+ *
+ * All file descriptors in the structure are owned by the consumer, which must
+ * close them once it is done with the frame. The dmabuf fds keep the
+ * underlying memory alive on their own, so a captured frame stays readable
+ * even after the swapchain that produced it is destroyed.
+ */
+typedef struct VkCapturedFrameWSI
+{
+   /** Swapchain image index the frame was presented from. */
+   uint32_t imageIndex;
+
+   /** VK_KHR_present_id value of the present, 0 when the application set none. */
+   uint64_t presentId;
+
+   /** Image extent, from the swapchain's image creation parameters. */
+   uint32_t width;
+   uint32_t height;
+
+   /** Image format, from the swapchain's image creation parameters. */
+   VkFormat format;
+
+   /** Number of entries used in the per-plane arrays below. */
+   uint32_t planeCount;
+
+   /** dmabuf fd backing each memory plane; duplicates owned by the consumer. */
+   int planeFds[WSI_FRAME_CAPTURE_MAX_PLANES];
+
+   /** Row stride of each memory plane, in bytes. */
+   uint32_t planeStrides[WSI_FRAME_CAPTURE_MAX_PLANES];
+
+   /** Byte offset of each memory plane within its dmabuf. */
+   uint32_t planeOffsets[WSI_FRAME_CAPTURE_MAX_PLANES];
+
+   /**
+    * Sync FD that signals when the GPU has finished rendering to the image.
+    * The consumer must wait on it before reading the dmabufs; it is a
+    * duplicate of the fence the presentation engine itself waits on, so
+    * waiting adds no latency over the display path.
+    */
+   int releaseFenceFd;
+} VkCapturedFrameWSI;
+
+/**
+ * @brief Frame capture callback, invoked on the layer's presentation thread.
+ *
+ * The callback must return quickly - it runs on the path that hands frames to
+ * the presentation engine, so any real work (encoding, copying) belongs on the
+ * consumer's own thread. Ownership of the frame's file descriptors passes to
+ * the consumer, which signals that it is done processing the frame by calling
+ * vkCompleteCapturedFrameWSI. The callback must not unregister the capture or
+ * destroy the swapchain from within its own invocation.
+ */
+typedef void(VKAPI_PTR *PFN_vkFrameCaptureCallbackWSI)(void *pUserData, const VkCapturedFrameWSI *pFrame);
+
+namespace wsi
+{
+
+class external_memory;
+class sync_fd_fence_sync;
+
+/**
+ * @brief Fill a captured frame from a dmabuf-backed image.
+ *
+ * Shared by the backends' fill_captured_frame implementations: duplicates the
+ * image's per-plane buffer fds into the frame and shares the image's present
+ * fence as the release fence. On success the frame's fds are owned by the
+ * caller; on failure nothing is left open.
+ *
+ * @param[in]     memory        The image's external memory.
+ * @param[in]     present_fence The image's present fence, already submitted.
+ * @param[in,out] frame         The frame to fill.
+ *
+ * @return true when the frame was filled, false when the image is not backed
+ *         by exportable buffers or a handle could not be duplicated.
+ */
+bool fill_captured_frame_from_dmabuf(external_memory &memory, sync_fd_fence_sync &present_fence,
+                                     VkCapturedFrameWSI &frame);
+
+/**
+ * @brief Publishes presented frames to a registered capture consumer.
+ *
+ * Backed by the observation that the swapchain images of the dmabuf-based
+ * backends already are exportable buffers: capture hands the consumer
+ * duplicated dmabuf fds and a sync_fd release fence instead of rendering an
+ * extra copy, so capturing costs no GPU work at all. A consumer registers per
+ * swapchain through the layer-specific vkRegisterSwapchainFrameCaptureWSI
+ * entrypoint and receives every presented frame from the presentation thread.
+ *
+ * Backpressure is frame skipping: the consumer declares at registration how
+ * many frames it can hold concurrently, and while that many are outstanding
+ * new frames are dropped before any fds are duplicated, so a stalled consumer
+ * costs the presentation path a single atomic load per frame. When no
+ * consumer is registered the per-present overhead is the same relaxed load
+ * and early return as @ref present_trace.
+ */
+class frame_capture
+{
+public:
+   /**
+    * @brief Whether a consumer is registered.
+    */
+   bool is_armed() const
+   {
+      return m_armed.load(std::memory_order_relaxed);
+   }
+
+   /**
+    * @brief Register a capture consumer.
+    *
+    * @param callback           Invoked with each presented frame.
+    * @param user_data          Opaque pointer passed back to the callback.
+    * @param max_pending_frames Frames the consumer may hold before new ones
+    *                           are skipped; 0 selects the default of 1.
+    *
+    * @return VK_SUCCESS on success, VK_ERROR_INITIALIZATION_FAILED when a
+    *         consumer is already registered.
+    */
+   VkResult register_consumer(PFN_vkFrameCaptureCallbackWSI callback, void *user_data, uint32_t max_pending_frames);
+
+   /**
+    * @brief Unregister the capture consumer.
+    *
+    * Waits for a callback in flight on the presentation thread to return, so
+    * once this call completes the callback will not be invoked again. Frames
+    * already handed out remain valid; their fds are the consumer's to close.
+    */
+   VkResult unregister_consumer();
+
+   /**
+    * @brief Mark one outstanding frame as processed, unblocking frame delivery.
+    */
+   void complete_frame();
+
+   /**
+    * @brief Reserve delivery of one frame, skipping it when the consumer is saturated.
+    *
+    * @return true when the frame should be built and delivered, false when it
+    *         is dropped for backpressure (or no consumer is registered).
+    */
+   bool try_claim_frame();
+
+   /**
+    * @brief Return a claim made with try_claim_frame() without delivering.
+    */
+   void abandon_frame();
+
+   /**
+    * @brief Hand a claimed frame to the consumer.
+    *
+    * Takes ownership of the frame's file descriptors: they pass to the
+    * consumer's callback, or are closed here if the consumer unregistered
+    * between the claim and the delivery.
+    */
+   void deliver(const VkCapturedFrameWSI &frame);
+
+private:
+   /** Checked with a relaxed load on every present. Written under m_lock. */
+   std::atomic<bool> m_armed{ false };
+
+   /** Frames handed out but not yet completed by the consumer. */
+   std::atomic<uint32_t> m_in_flight{ 0 };
+
+   /** Outstanding frames at which try_claim_frame() starts skipping. */
+   uint32_t m_max_pending{ 1 };
+
+   PFN_vkFrameCaptureCallbackWSI m_callback{ nullptr };
+   void *m_user_data{ nullptr };
+
+   /** Serializes registration against a delivery on the presentation thread. */
+   std::mutex m_lock;
+};
+
+} /* namespace wsi */
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Per-swapchain frame latency instrumentation.
+ */
+
+#include "frame_latency_tracker.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <unistd.h>
+
+#include <util/config.hpp>
+#include <util/log.hpp>
+
+namespace wsi
+{
+
+/**
+ * @brief File header of a binary latency dump: magic, version and record count.
+ */
+struct frame_latency_dump_header
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t record_count;
+};
+
+static uint64_t monotonic_ns()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+static const char *dump_path_prefix()
+{
+   return util::config::get().latency_dump();
+}
+
+frame_latency_tracker::frame_latency_tracker()
+   : m_enabled(dump_path_prefix() != nullptr)
+   , m_in_flight()
+{
+}
+
+frame_latency_tracker::~frame_latency_tracker()
+{
+   if (is_enabled())
+   {
+      dump();
+   }
+}
+
+void frame_latency_tracker::mark_queue_present(uint32_t image_index)
+{
+   if (!is_enabled())
+   {
+      return;
+   }
+
+   assert(image_index < m_in_flight.size());
+   m_in_flight[image_index] = {};
+   m_in_flight[image_index].image_index = image_index;
+   m_in_flight[image_index].queue_present_ns = monotonic_ns();
+}
+
+void frame_latency_tracker::mark_flip_dequeue(uint32_t image_index)
+{
+   if (!is_enabled())
+   {
+      return;
+   }
+
+   assert(image_index < m_in_flight.size());
+   m_in_flight[image_index].flip_dequeue_ns = monotonic_ns();
+}
+
+void frame_latency_tracker::mark_payload_done(uint32_t image_index)
+{
+   if (!is_enabled())
+   {
+      return;
+   }
+
+   assert(image_index < m_in_flight.size());
+   m_in_flight[image_index].payload_done_ns = monotonic_ns();
+}
+
+void frame_latency_tracker::mark_presented(uint32_t image_index)
+{
+   if (!is_enabled())
+   {
+      return;
+   }
+
+   assert(image_index < m_in_flight.size());
+   m_in_flight[image_index].presented_ns = monotonic_ns();
+}
+
+void frame_latency_tracker::mark_vblank(uint32_t image_index, uint64_t vblank_counter)
+{
+   if (!is_enabled())
+   {
+      return;
+   }
+
+   assert(image_index < m_in_flight.size());
+   m_in_flight[image_index].vblank_counter = vblank_counter;
+}
+
+void frame_latency_tracker::mark_released(uint32_t image_index)
+{
+   if (!is_enabled())
+   {
+      return;
+   }
+
+   assert(image_index < m_in_flight.size());
+
+   /* An image that was never queued for present (e.g. released during teardown) has no
+    * frame in flight and produces no record. */
+   if (m_in_flight[image_index].queue_present_ns == 0)
+   {
+      return;
+   }
+
+   m_in_flight[image_index].released_ns = monotonic_ns();
+
+   const std::lock_guard<std::mutex> lock(m_completed_lock);
+   if (m_completed.size() == m_completed.capacity())
+   {
+      m_completed.pop_front();
+   }
+   m_completed.push_back(m_in_flight[image_index]);
+   m_in_flight[image_index] = {};
+}
+
+size_t frame_latency_tracker::get_records(frame_latency_record *records, size_t count)
+{
+   if (!is_enabled())
+   {
+      return 0;
+   }
+
+   const std::lock_guard<std::mutex> lock(m_completed_lock);
+   size_t copied = 0;
+   for (size_t i = 0; i < m_completed.size() && copied < count; i++)
+   {
+      records[copied++] = *m_completed.at(i);
+   }
+   return copied;
+}
+
+void frame_latency_tracker::dump()
+{
+   const std::lock_guard<std::mutex> lock(m_completed_lock);
+   if (m_completed.size() == 0)
+   {
+      return;
+   }
+
+   char path[256];
+   std::snprintf(path, sizeof(path), "%s.%d.%p.bin", dump_path_prefix(), static_cast<int>(getpid()),
+                 static_cast<void *>(this));
+
+   FILE *file = std::fopen(path, "wb");
+   if (file == nullptr)
+   {
+      WSI_LOG_WARNING("Failed to open latency dump file %s", path);
+      return;
+   }
+
+   frame_latency_dump_header header = { { 'W', 'S', 'I', 'L', 'A', 'T', '0', '\0' },
+                                        1,
+                                        static_cast<uint32_t>(m_completed.size()) };
+   bool write_failed = std::fwrite(&header, sizeof(header), 1, file) != 1;
+   while (auto record = m_completed.pop_front())
+   {
+      write_failed |= std::fwrite(&record.value(), sizeof(record.value()), 1, file) != 1;
+   }
+
+   write_failed |= std::fclose(file) != 0;
+   if (write_failed)
+   {
+      WSI_LOG_WARNING("Failed to write latency dump file %s", path);
+   }
+}
+
+} /* namespace wsi */
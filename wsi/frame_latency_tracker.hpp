@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Per-swapchain frame latency instrumentation.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include <util/ring_buffer.hpp>
+
+#include "surface_properties.hpp"
+
+namespace wsi
+{
+
+/**
+ * @brief Monotonic timestamps recording where one frame spent time inside the layer.
+ *
+ * All timestamps are CLOCK_MONOTONIC style nanoseconds; a stage that a frame never went
+ * through (e.g. the payload wait of a mailbox-dropped frame) is left as 0.
+ */
+struct frame_latency_record
+{
+   /** Swapchain image the frame was presented with. */
+   uint32_t image_index;
+
+   /** The present request was queued to the page flip thread in queue_present. */
+   uint64_t queue_present_ns;
+
+   /** The page flip thread picked the request up after its semaphore wait. */
+   uint64_t flip_dequeue_ns;
+
+   /** The present payload wait on the page flip thread completed. */
+   uint64_t payload_done_ns;
+
+   /** The backend present call returned. */
+   uint64_t presented_ns;
+
+   /** The presentation engine released the image back to the swapchain. */
+   uint64_t released_ns;
+
+   /**
+    * Hardware vblank counter sampled when the backend present call returned; 0 when the
+    * backend exposes no counter. Consecutive records advancing by more than the expected
+    * number of refresh cycles pinpoint dropped frames exactly, without inferring them
+    * from timestamps.
+    */
+   uint64_t vblank_counter;
+};
+
+/**
+ * @brief Records per-frame stage timestamps into a fixed-size ring of completed frames.
+ *
+ * The tracker is enabled by setting VULKAN_WSI_LATENCY_DUMP to a file path prefix; on
+ * swapchain destruction the completed records are appended as a binary dump to
+ * "<prefix>.<pid>.<tracker>.bin". When disabled every mark call is a single relaxed atomic
+ * load and an early return, so the instrumentation can stay compiled in. No locks are taken
+ * on any mark path except completing a frame, which can race between the page flip thread
+ * and the backend's event thread.
+ */
+class frame_latency_tracker
+{
+public:
+   /** Number of completed frame records kept. Older frames are dropped when full. */
+   static constexpr size_t MAX_COMPLETED_RECORDS = 1024;
+
+   frame_latency_tracker();
+   ~frame_latency_tracker();
+
+   /**
+    * @brief Whether the tracker records timestamps.
+    */
+   bool is_enabled() const
+   {
+      return m_enabled.load(std::memory_order_relaxed);
+   }
+
+   /**
+    * @brief Start a new frame record: the present request was queued in queue_present.
+    */
+   void mark_queue_present(uint32_t image_index);
+
+   /**
+    * @brief The page flip thread dequeued the frame's present request.
+    */
+   void mark_flip_dequeue(uint32_t image_index);
+
+   /**
+    * @brief The frame's present payload wait completed on the page flip thread.
+    */
+   void mark_payload_done(uint32_t image_index);
+
+   /**
+    * @brief The backend present call for the frame returned.
+    */
+   void mark_presented(uint32_t image_index);
+
+   /**
+    * @brief Record the hardware vblank counter for the frame's present.
+    *
+    * Called by backends that can read a counter out of the presentation hardware,
+    * alongside their present call.
+    */
+   void mark_vblank(uint32_t image_index, uint64_t vblank_counter);
+
+   /**
+    * @brief The image was released back to the swapchain; completes the frame record.
+    */
+   void mark_released(uint32_t image_index);
+
+   /**
+    * @brief Copy up to @p count completed records, oldest first.
+    *
+    * Allows tooling with access to the swapchain object to sample the latency history
+    * without going through the file dump.
+    *
+    * @return The number of records copied.
+    */
+   size_t get_records(frame_latency_record *records, size_t count);
+
+private:
+   /**
+    * @brief Append the completed records to the dump file.
+    */
+   void dump();
+
+   /** Checked with a relaxed load on every mark call. Constant after construction. */
+   std::atomic<bool> m_enabled;
+
+   /**
+    * @brief One in-progress record per swapchain image.
+    *
+    * An image has at most one frame in flight, and each stage of that frame is marked by
+    * exactly one thread, so the slots need no synchronization between stages.
+    */
+   std::array<frame_latency_record, surface_properties::MAX_SWAPCHAIN_IMAGE_COUNT> m_in_flight;
+
+   /** Completed frames, oldest first. Guarded by m_completed_lock. */
+   util::ring_buffer<frame_latency_record, MAX_COMPLETED_RECORDS> m_completed;
+   std::mutex m_completed_lock;
+};
+
+} /* namespace wsi */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, 2021-2025 Arm Limited.
+ * Copyright (c) 2017-2019, 2021-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -46,27 +46,24 @@ namespace headless
 
 constexpr int max_core_1_0_formats = VK_FORMAT_ASTC_12x12_SRGB_BLOCK + 1;
 
-void surface_properties::populate_present_mode_compatibilities()
-{
-   std::array compatible_present_modes_list = {
-      present_mode_compatibility{
-         VK_PRESENT_MODE_FIFO_KHR, 2, { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR } },
-      present_mode_compatibility{
-         VK_PRESENT_MODE_FIFO_RELAXED_KHR, 2, { VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR } },
-      present_mode_compatibility{
-         VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR, 1, { VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR } },
-      present_mode_compatibility{
-         VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR, 1, { VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR } },
-   };
-   m_compatible_present_modes =
-      compatible_present_modes<compatible_present_modes_list.size()>(compatible_present_modes_list);
-}
+/* The compatibility relation is fixed for the backend: every surface points at
+ * this table, so the EXT_surface_maintenance1 queries build nothing at runtime. */
+static constexpr std::array<present_mode_compatibility, 4> COMPATIBLE_PRESENT_MODES = {
+   present_mode_compatibility{
+      VK_PRESENT_MODE_FIFO_KHR, 2, { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR } },
+   present_mode_compatibility{
+      VK_PRESENT_MODE_FIFO_RELAXED_KHR, 2, { VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR } },
+   present_mode_compatibility{
+      VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR, 1, { VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR } },
+   present_mode_compatibility{
+      VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR, 1, { VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR } },
+};
 
 surface_properties::surface_properties()
    : m_supported_modes({ VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR,
                          VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR, VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR })
+   , m_compatible_present_modes(COMPATIBLE_PRESENT_MODES)
 {
-   populate_present_mode_compatibilities();
 }
 
 surface_properties &surface_properties::get_instance()
@@ -133,16 +130,31 @@ static uint32_t fill_supported_formats(VkPhysicalDevice physical_device,
    return format_count;
 }
 
+/* The per-format support and fixed-rate compression capabilities are immutable
+ * for a given physical device, so probing the driver for every format is only
+ * done on the first query; later queries are served from this cache with no
+ * driver round trips or allocations. Guarded by a mutex as surface format
+ * queries may run concurrently. */
+static std::mutex format_cache_mutex;
+static VkPhysicalDevice format_cache_device = VK_NULL_HANDLE;
+static uint32_t cached_format_count = 0;
+static std::array<surface_format_properties, max_core_1_0_formats> cached_formats{};
+
 VkResult surface_properties::get_surface_formats(VkPhysicalDevice physical_device, uint32_t *surface_format_count,
                                                  VkSurfaceFormatKHR *surface_formats,
                                                  VkSurfaceFormat2KHR *extended_surface_formats)
 {
-   /* Construct a list of all formats supported by the driver - for color attachment */
-   std::array<surface_format_properties, max_core_1_0_formats> formats{};
-   auto format_count = fill_supported_formats(physical_device, formats);
+   const std::lock_guard<std::mutex> lock(format_cache_mutex);
+
+   if (format_cache_device != physical_device)
+   {
+      /* Construct a list of all formats supported by the driver - for color attachment */
+      cached_format_count = fill_supported_formats(physical_device, cached_formats);
+      format_cache_device = physical_device;
+   }
 
-   return surface_properties_formats_helper(formats.begin(), formats.begin() + format_count, surface_format_count,
-                                            surface_formats, extended_surface_formats);
+   return surface_properties_formats_helper(cached_formats.begin(), cached_formats.begin() + cached_format_count,
+                                            surface_format_count, surface_formats, extended_surface_formats);
 }
 
 VkResult surface_properties::get_surface_present_modes(VkPhysicalDevice physical_device, VkSurfaceKHR surface,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, 2022-2024 Arm Limited.
+ * Copyright (c) 2017-2019, 2022-2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -70,10 +70,8 @@ private:
    /* List of supported presentation modes */
    std::array<VkPresentModeKHR, 4> m_supported_modes;
 
-   /* Stores compatible presentation modes */
-   compatible_present_modes<4> m_compatible_present_modes;
-
-   void populate_present_mode_compatibilities() override;
+   /* View of the backend's constexpr compatibility table */
+   compatible_present_modes m_compatible_present_modes;
 
    void get_surface_present_scaling_and_gravity(VkSurfacePresentScalingCapabilitiesEXT *scaling_capabilities) override;
 };
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2025 Arm Limited.
+ * Copyright (c) 2017-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -33,13 +33,17 @@
 
 #include "swapchain.hpp"
 
+#include <util/config.hpp>
 #include <util/custom_allocator.hpp>
 #include <util/timed_semaphore.hpp>
 
+#include <wsi/external_memory.hpp>
+#include <wsi/swapchain_present_loop.hpp>
 #include <wsi/extensions/present_id.hpp>
 #include <wsi/extensions/swapchain_maintenance.hpp>
 #include <wsi/extensions/image_compression_control.hpp>
 #include "util/macros.hpp"
+#include "util/usdt.hpp"
 
 #include "present_timing_handler.hpp"
 
@@ -50,14 +54,24 @@ namespace headless
 
 struct image_data
 {
-   /* Device memory backing the image. */
+   image_data(const VkDevice &device, const util::allocator &allocator)
+      : external_mem(device, allocator)
+   {
+   }
+
+   /* Device memory backing the image (device-local mode). */
    VkDeviceMemory memory{};
+   /* Host-visible backing with a persistent CPU mapping (host-visible mode). */
+   external_memory external_mem;
+   void *mapped_ptr = nullptr;
    fence_sync present_fence;
 };
 
 swapchain::swapchain(layer::device_private_data &dev_data, const VkAllocationCallbacks *pAllocator)
    : wsi::swapchain_base(dev_data, pAllocator)
+   , m_memory_slab(m_device, m_allocator)
 {
+   select_present_loop<swapchain>();
 }
 
 swapchain::~swapchain()
@@ -128,6 +142,20 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
       use_presentation_thread = true;
    }
 
+   /* Streaming deployments can opt into host-visible, persistently mapped
+    * images so an encoder reads presented frames without a GPU copy. */
+   m_host_visible = util::config::get().headless_host_visible();
+
+   if (m_host_visible)
+   {
+      /* All images come from one shared host-visible allocation, mapped once
+       * for the persistent per-image pointers. */
+      VkMemoryPropertyFlags optimal = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+                                      VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+      VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+      m_memory_slab.configure(static_cast<uint32_t>(m_swapchain_images.size()), required, optimal, true);
+   }
+
    return VK_SUCCESS;
 }
 
@@ -135,31 +163,11 @@ VkResult swapchain::allocate_and_bind_swapchain_image(VkImageCreateInfo image_cr
 {
    UNUSED(image_create);
    VkResult res = VK_SUCCESS;
-   const std::lock_guard<std::recursive_mutex> lock(m_image_status_mutex);
-
-   VkMemoryRequirements memory_requirements = {};
-   m_device_data.disp.GetImageMemoryRequirements(m_device, image.image, &memory_requirements);
 
-   /* Find a memory type */
-   size_t mem_type_idx = 0;
-   for (; mem_type_idx < 8 * sizeof(memory_requirements.memoryTypeBits); ++mem_type_idx)
-   {
-      if (memory_requirements.memoryTypeBits & (1u << mem_type_idx))
-      {
-         break;
-      }
-   }
-
-   assert(mem_type_idx <= 8 * sizeof(memory_requirements.memoryTypeBits) - 1);
-
-   VkMemoryAllocateInfo mem_info = {};
-   mem_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-   mem_info.allocationSize = memory_requirements.size;
-   mem_info.memoryTypeIndex = mem_type_idx;
    image_data *data = nullptr;
 
    /* Create image_data */
-   data = m_allocator.create<image_data>(1);
+   data = create_image_data<image_data>(m_device, m_allocator);
    if (data == nullptr)
    {
       m_device_data.disp.DestroyImage(m_device, image.image, get_allocation_callbacks());
@@ -168,20 +176,78 @@ VkResult swapchain::allocate_and_bind_swapchain_image(VkImageCreateInfo image_cr
    image.data = reinterpret_cast<void *>(data);
    image.status = wsi::swapchain_image::FREE;
 
-   res = m_device_data.disp.AllocateMemory(m_device, &mem_info, get_allocation_callbacks(), &data->memory);
-   assert(VK_SUCCESS == res);
-   if (res != VK_SUCCESS)
+   if (m_host_visible)
    {
-      destroy_image(image);
-      return res;
+      /* Host-visible mode: allocate from host-visible memory and keep the
+       * mapping alive for the lifetime of the image. */
+      VkMemoryPropertyFlags optimal = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+                                      VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+      VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+      res = data->external_mem.configure_for_host_visible(m_image_create_info, required, optimal);
+      if (res == VK_SUCCESS && m_memory_slab.is_configured())
+      {
+         VkDeviceMemory slab_memory = VK_NULL_HANDLE;
+         VkDeviceSize slab_offset = 0;
+         void *slab_mapped = nullptr;
+         if (m_memory_slab.acquire_slice(image.image, &slab_memory, &slab_offset, &slab_mapped) == VK_SUCCESS)
+         {
+            data->external_mem.configure_for_host_visible_slice(slab_memory, slab_offset, slab_mapped,
+                                                                m_memory_slab.is_memory_cached());
+         }
+         /* On failure the image simply falls back to a dedicated allocation. */
+      }
+      if (res == VK_SUCCESS)
+      {
+         res = data->external_mem.allocate_and_bind_image(image.image, m_image_create_info);
+      }
+      if (res == VK_SUCCESS)
+      {
+         res = data->external_mem.map_host_memory(&data->mapped_ptr);
+      }
+      if (res != VK_SUCCESS)
+      {
+         destroy_image(image);
+         return res;
+      }
    }
-
-   res = m_device_data.disp.BindImageMemory(m_device, image.image, data->memory, 0);
-   assert(VK_SUCCESS == res);
-   if (res != VK_SUCCESS)
+   else
    {
-      destroy_image(image);
-      return res;
+      VkMemoryRequirements memory_requirements = {};
+      m_device_data.disp.GetImageMemoryRequirements(m_device, image.image, &memory_requirements);
+
+      /* Find a memory type */
+      size_t mem_type_idx = 0;
+      for (; mem_type_idx < 8 * sizeof(memory_requirements.memoryTypeBits); ++mem_type_idx)
+      {
+         if (memory_requirements.memoryTypeBits & (1u << mem_type_idx))
+         {
+            break;
+         }
+      }
+
+      assert(mem_type_idx <= 8 * sizeof(memory_requirements.memoryTypeBits) - 1);
+
+      VkMemoryAllocateInfo mem_info = {};
+      mem_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+      mem_info.allocationSize = memory_requirements.size;
+      mem_info.memoryTypeIndex = mem_type_idx;
+
+      res = m_device_data.disp.AllocateMemory(m_device, &mem_info, get_allocation_callbacks(), &data->memory);
+      assert(VK_SUCCESS == res);
+      if (res != VK_SUCCESS)
+      {
+         destroy_image(image);
+         return res;
+      }
+
+      res = m_device_data.disp.BindImageMemory(m_device, image.image, data->memory, 0);
+      assert(VK_SUCCESS == res);
+      if (res != VK_SUCCESS)
+      {
+         destroy_image(image);
+         return res;
+      }
    }
 
    /* Initialize presentation fence. */
@@ -215,11 +281,20 @@ VkResult swapchain::create_swapchain_image(VkImageCreateInfo image_create_info,
          m_image_create_info.pNext = &image_compression_control;
       }
    }
+
+   if (m_host_visible)
+   {
+      /* CPU readers need a linear layout with queryable row strides. */
+      m_image_create_info.tiling = VK_IMAGE_TILING_LINEAR;
+   }
+
    return m_device_data.disp.CreateImage(m_device, &m_image_create_info, get_allocation_callbacks(), &image.image);
 }
 
 void swapchain::present_image(const pending_present_request &pending_present)
 {
+   WSI_USDT3(present_submit, this, pending_present.image_index, pending_present.present_id);
+
    if (m_device_data.is_present_id_enabled())
    {
       auto *ext = get_swapchain_extension<wsi_ext_present_id>(true);
@@ -230,20 +305,18 @@ void swapchain::present_image(const pending_present_request &pending_present)
 
 void swapchain::destroy_image(wsi::swapchain_image &image)
 {
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
-   if (image.status != wsi::swapchain_image::INVALID)
+   /* Move the status to INVALID atomically: only the caller whose exchange
+    * observes a different previous state tears the VkImage down, which keeps
+    * destroy_image safe to reach twice for the same image. */
+   if (image.status.exchange(wsi::swapchain_image::INVALID) != wsi::swapchain_image::INVALID)
    {
       if (image.image != VK_NULL_HANDLE)
       {
          m_device_data.disp.DestroyImage(m_device, image.image, get_allocation_callbacks());
          image.image = VK_NULL_HANDLE;
       }
-
-      image.status = wsi::swapchain_image::INVALID;
    }
 
-   image_status_lock.unlock();
-
    if (image.data != nullptr)
    {
       auto *data = reinterpret_cast<image_data *>(image.data);
@@ -252,7 +325,7 @@ void swapchain::destroy_image(wsi::swapchain_image &image)
          m_device_data.disp.FreeMemory(m_device, data->memory, get_allocation_callbacks());
          data->memory = VK_NULL_HANDLE;
       }
-      m_allocator.destroy(1, data);
+      destroy_image_data(data);
       image.data = nullptr;
    }
 }
@@ -281,5 +354,27 @@ VkResult swapchain::bind_swapchain_image(VkDevice &device, const VkBindImageMemo
    return device_data.disp.BindImageMemory(device, bind_image_mem_info->image, memory, 0);
 }
 
+VkResult swapchain::get_host_image_mapping(uint32_t image_index, void **mapped_ptr, VkSubresourceLayout *layout)
+{
+   if (!m_host_visible || image_index >= m_swapchain_images.size())
+   {
+      return VK_ERROR_FEATURE_NOT_PRESENT;
+   }
+
+   auto *data = reinterpret_cast<image_data *>(m_swapchain_images[image_index].data);
+   if (data == nullptr || data->mapped_ptr == nullptr)
+   {
+      return VK_ERROR_MEMORY_MAP_FAILED;
+   }
+
+   *mapped_ptr = data->mapped_ptr;
+   if (layout != nullptr)
+   {
+      *layout = data->external_mem.get_host_layout();
+   }
+
+   return VK_SUCCESS;
+}
+
 } /* namespace headless */
 } /* namespace wsi */
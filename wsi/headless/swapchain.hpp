@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2025 Arm Limited.
+ * Copyright (c) 2017-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -33,6 +33,7 @@
 #include <vulkan/vk_icd.h>
 #include <vulkan/vulkan.h>
 
+#include <wsi/external_memory.hpp>
 #include <wsi/swapchain_base.hpp>
 
 namespace wsi
@@ -45,13 +46,21 @@ namespace headless
  * This class is mostly empty, because all the swapchain stuff is handled by the swapchain class,
  * which we inherit. This class only provides a way to create an image and page-flip ops.
  */
-class swapchain : public wsi::swapchain_base
+class swapchain final : public wsi::swapchain_base
 {
 public:
    explicit swapchain(layer::device_private_data &dev_data, const VkAllocationCallbacks *pAllocator);
 
    ~swapchain();
 
+   /**
+    * @brief Query the persistent CPU mapping of a swapchain image.
+    *
+    * Only available when the swapchain runs in host-visible mode; see
+    * @ref m_host_visible.
+    */
+   VkResult get_host_image_mapping(uint32_t image_index, void **mapped_ptr, VkSubresourceLayout *layout) override;
+
 protected:
    /**
     * @brief Platform specific init
@@ -112,6 +121,27 @@ protected:
 
    VkResult image_wait_present(swapchain_image &image, uint64_t timeout) override;
 
+   /**
+    * @brief The present payloads are only used for CPU-side waiting, so the
+    * swapchain can rely on the base class timeline semaphore synchronization
+    * when the device supports it.
+    */
+   bool can_use_timeline_sync() const override
+   {
+      return true;
+   }
+
+   /**
+    * @brief Headless images are plain device memory allocations with no windowing
+    * system state attached, so they can move to a descendant swapchain as-is.
+    * Host-visible images are the exception: they are slices of the swapchain's
+    * shared memory slab, which does not outlive the swapchain.
+    */
+   bool can_transfer_images() const override
+   {
+      return !m_host_visible;
+   }
+
    /**
     * @brief Bind image to a swapchain
     *
@@ -134,6 +164,23 @@ private:
     * @return VK_SUCCESS on success, other result codes on failure
     */
    VkResult add_required_extensions(VkDevice device, const VkSwapchainCreateInfoKHR *swapchain_create_info) override;
+
+   /**
+    * @brief Whether images are allocated from host-visible memory with a
+    * persistent CPU mapping instead of the default device-local path.
+    *
+    * Enabled with the VULKAN_WSI_HEADLESS_HOST_VISIBLE environment variable.
+    * Images are created with linear tiling so readers can consume them with
+    * the row strides reported by @ref get_host_image_mapping, letting a
+    * streaming encoder read frames with no GPU copy.
+    */
+   bool m_host_visible = false;
+
+   /**
+    * @brief One host-visible allocation shared by all images in host-visible
+    * mode, mapped once for the persistent per-image pointers.
+    */
+   device_memory_slab m_memory_slab;
 };
 
 } /* namespace headless */
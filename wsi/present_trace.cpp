@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Per-swapchain acquire/present trace capture.
+ */
+
+#include "present_trace.hpp"
+
+#include <cstdio>
+#include <ctime>
+
+#include <unistd.h>
+
+#include <util/config.hpp>
+#include <util/log.hpp>
+
+namespace wsi
+{
+
+static const char *trace_path_prefix()
+{
+   return util::config::get().present_trace();
+}
+
+present_trace::present_trace()
+   : m_enabled(trace_path_prefix() != nullptr)
+{
+}
+
+present_trace::~present_trace()
+{
+   if (!is_enabled())
+   {
+      return;
+   }
+
+   flush();
+   if (m_file != nullptr)
+   {
+      if (std::fclose(m_file) != 0)
+      {
+         WSI_LOG_WARNING("Failed to write present trace file");
+      }
+   }
+}
+
+uint64_t present_trace::timestamp()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void present_trace::trace_acquire(uint64_t start_ns, uint32_t image_index, uint32_t present_mode, uint32_t queue_depth)
+{
+   if (!is_enabled())
+   {
+      return;
+   }
+
+   push({ start_ns, PRESENT_TRACE_ACQUIRE, image_index, present_mode, queue_depth, 0, 0 });
+}
+
+void present_trace::trace_present(uint64_t start_ns, uint32_t image_index, uint32_t present_mode, uint32_t queue_depth,
+                                  uint32_t extension_mask)
+{
+   if (!is_enabled())
+   {
+      return;
+   }
+
+   push({ start_ns, PRESENT_TRACE_PRESENT, image_index, present_mode, queue_depth, extension_mask, 0 });
+}
+
+void present_trace::push(const present_trace_record &record)
+{
+   const std::lock_guard<std::mutex> lock(m_lock);
+   if (m_records.size() == m_records.capacity())
+   {
+      flush();
+   }
+   m_records.push_back(record);
+}
+
+void present_trace::flush()
+{
+   if (m_file == nullptr)
+   {
+      char path[256];
+      std::snprintf(path, sizeof(path), "%s.%d.%p.bin", trace_path_prefix(), static_cast<int>(getpid()),
+                    static_cast<void *>(this));
+
+      m_file = std::fopen(path, "wb");
+      if (m_file == nullptr)
+      {
+         /* Nothing can be recorded; drop the buffered records and disable the
+          * trace so the per-frame calls stop paying for it. */
+         WSI_LOG_WARNING("Failed to open present trace file %s", path);
+         m_enabled.store(false, std::memory_order_relaxed);
+         return;
+      }
+
+      static_assert(sizeof(present_trace_record) == 32, "present_trace_record layout is part of the file format");
+      present_trace_header header = { { 'W', 'S', 'I', 'T', 'R', 'C', '0', '\0' },
+                                      1,
+                                      static_cast<uint32_t>(sizeof(present_trace_record)) };
+      if (std::fwrite(&header, sizeof(header), 1, m_file) != 1)
+      {
+         WSI_LOG_WARNING("Failed to write present trace file %s", path);
+      }
+   }
+
+   while (auto record = m_records.pop_front())
+   {
+      if (std::fwrite(&record.value(), sizeof(record.value()), 1, m_file) != 1)
+      {
+         WSI_LOG_WARNING("Failed to write present trace file");
+         break;
+      }
+   }
+}
+
+} /* namespace wsi */
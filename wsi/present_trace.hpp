@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Per-swapchain acquire/present trace capture.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#include <vulkan/vulkan.h>
+
+#include <util/ring_buffer.hpp>
+
+namespace wsi
+{
+
+/** Event kinds a @ref present_trace_record can describe. */
+enum present_trace_event : uint32_t
+{
+   PRESENT_TRACE_ACQUIRE = 0,
+   PRESENT_TRACE_PRESENT = 1,
+};
+
+/** Bits of @ref present_trace_record::extension_mask, one per recognized pNext struct. */
+enum present_trace_extension : uint32_t
+{
+   PRESENT_TRACE_EXT_PRESENT_ID = 1u << 0,
+   PRESENT_TRACE_EXT_PRESENT_REGIONS = 1u << 1,
+   PRESENT_TRACE_EXT_PRESENT_FENCE = 1u << 2,
+   PRESENT_TRACE_EXT_PRESENT_MODE_INFO = 1u << 3,
+   PRESENT_TRACE_EXT_FRAME_BOUNDARY = 1u << 4,
+   PRESENT_TRACE_EXT_PRESENT_TIMINGS = 1u << 5,
+};
+
+/**
+ * @brief One acquire or present call as it entered the layer.
+ *
+ * The records are written to the trace file verbatim, so the layout is fixed:
+ * 32 bytes, little-endian, no implicit padding.
+ */
+struct present_trace_record
+{
+   /** CLOCK_MONOTONIC nanoseconds when the call entered the layer. */
+   uint64_t timestamp_ns;
+
+   /** @ref present_trace_event. */
+   uint32_t event;
+
+   /** Swapchain image the call acquired or presented. */
+   uint32_t image_index;
+
+   /** VkPresentModeKHR in effect for the call. */
+   uint32_t present_mode;
+
+   /**
+    * Present requests already queued to the page flip thread when this call
+    * entered, i.e. how far ahead of the presentation engine the application
+    * was running.
+    */
+   uint32_t queue_depth;
+
+   /** Recognized VkPresentInfoKHR pNext structs; 0 for acquire events. */
+   uint32_t extension_mask;
+
+   /** Zero; keeps the record layout at a stable 32 bytes. */
+   uint32_t reserved;
+};
+
+/** File header of a binary present trace: magic, version and record size. */
+struct present_trace_header
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t record_size;
+};
+
+/**
+ * @brief Streams per-frame acquire/present parameters to a binary trace file.
+ *
+ * Enabled by setting VULKAN_WSI_PRESENT_TRACE to a file path prefix; each
+ * swapchain writes "<prefix>.<pid>.<trace>.bin" containing a
+ * @ref present_trace_header followed by @ref present_trace_record entries
+ * until end of file. wsi_present_replay reproduces the recorded cadence
+ * against a headless swapchain to bisect layer-side latency regressions
+ * offline.
+ *
+ * Records are buffered in a ring and flushed to the file once per
+ * @ref RECORDS_PER_FLUSH frames and at destruction, so the file I/O stays off
+ * the per-frame path. When disabled every trace call is a single relaxed
+ * atomic load and an early return, mirroring @ref frame_latency_tracker.
+ */
+class present_trace
+{
+public:
+   /** Records buffered between file writes. */
+   static constexpr size_t RECORDS_PER_FLUSH = 1024;
+
+   present_trace();
+   ~present_trace();
+
+   /**
+    * @brief Whether the trace records events.
+    */
+   bool is_enabled() const
+   {
+      return m_enabled.load(std::memory_order_relaxed);
+   }
+
+   /**
+    * @brief CLOCK_MONOTONIC timestamp for the start of a traced call.
+    *
+    * Taken by the caller on entry, so the recorded cadence reflects when the
+    * application made the call rather than when it completed.
+    */
+   static uint64_t timestamp();
+
+   /**
+    * @brief Record a successful acquire_next_image call.
+    */
+   void trace_acquire(uint64_t start_ns, uint32_t image_index, uint32_t present_mode, uint32_t queue_depth);
+
+   /**
+    * @brief Record a queue_present call.
+    */
+   void trace_present(uint64_t start_ns, uint32_t image_index, uint32_t present_mode, uint32_t queue_depth,
+                      uint32_t extension_mask);
+
+private:
+   /**
+    * @brief Append a record, flushing the buffer to the file when it is full.
+    */
+   void push(const present_trace_record &record);
+
+   /**
+    * @brief Write the buffered records out, opening the file on first use.
+    */
+   void flush();
+
+   /** Checked with a relaxed load on every trace call. Constant after construction. */
+   std::atomic<bool> m_enabled;
+
+   /** Trace output, opened lazily on the first flush. nullptr until then or on failure. */
+   FILE *m_file = nullptr;
+
+   /** Buffered records, oldest first. Guarded by m_lock. */
+   util::ring_buffer<present_trace_record, RECORDS_PER_FLUSH> m_records;
+
+   /** Serializes acquire and present events from different application threads. */
+   std::mutex m_lock;
+};
+
+} /* namespace wsi */
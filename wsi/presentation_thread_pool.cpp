@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ *
+ * @brief Implementation of the shared presentation thread pool.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <functional>
+#include <new>
+#include <system_error>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "util/log.hpp"
+#include "util/macros.hpp"
+#include "util/thread_scheduling.hpp"
+
+#include "presentation_thread_pool.hpp"
+#include "swapchain_base.hpp"
+
+namespace wsi
+{
+
+/** Hard cap on the number of workers, whatever the configuration asks for. */
+constexpr uint32_t MAX_PRESENT_POOL_THREADS = 8;
+
+/** Upper bound on events fetched per epoll_wait call. */
+constexpr int MAX_POOL_EVENTS = 16;
+
+presentation_thread_pool::presentation_thread_pool(const util::allocator &allocator)
+   : m_allocator(allocator)
+   , m_workers(m_allocator)
+   , m_registrations(m_allocator)
+{
+}
+
+presentation_thread_pool::~presentation_thread_pool()
+{
+   /* All swapchains unregister during their teardown, which happens before the
+    * device_private_data - and with it this pool - is destroyed. */
+   assert(m_registrations.empty());
+
+   for (auto &w : m_workers)
+   {
+      {
+         std::lock_guard<std::mutex> lock(w->lock);
+         w->run = false;
+      }
+      wake_worker(*w);
+   }
+
+   for (auto &w : m_workers)
+   {
+      if (w->thread.joinable())
+      {
+         w->thread.join();
+      }
+   }
+}
+
+VkResult presentation_thread_pool::start(uint32_t num_threads)
+{
+   assert(m_workers.empty());
+
+   num_threads = std::min(std::max(num_threads, 1u), MAX_PRESENT_POOL_THREADS);
+   if (!m_workers.try_reserve(num_threads))
+   {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   for (uint32_t i = 0; i < num_threads; i++)
+   {
+      auto w = m_allocator.make_unique<worker>();
+      if (w == nullptr)
+      {
+         return VK_ERROR_OUT_OF_HOST_MEMORY;
+      }
+
+      w->epoll_fd = util::fd_owner{ epoll_create1(EPOLL_CLOEXEC) };
+      w->wake_fd = util::fd_owner{ eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) };
+      if (!w->epoll_fd.is_valid() || !w->wake_fd.is_valid())
+      {
+         WSI_LOG_ERROR("Failed to create epoll/eventfd for presentation pool worker.");
+         return VK_ERROR_INITIALIZATION_FAILED;
+      }
+
+      /* The wake fd is recognized by its null data pointer. */
+      struct epoll_event event = {};
+      event.events = EPOLLIN;
+      event.data.ptr = nullptr;
+      if (epoll_ctl(w->epoll_fd.get(), EPOLL_CTL_ADD, w->wake_fd.get(), &event) != 0)
+      {
+         return VK_ERROR_INITIALIZATION_FAILED;
+      }
+
+      w->run = true;
+      try
+      {
+         w->thread = std::thread(&presentation_thread_pool::worker_main, this, std::ref(*w));
+      }
+      catch (const std::system_error &)
+      {
+         w->run = false;
+         return VK_ERROR_INITIALIZATION_FAILED;
+      }
+      catch (const std::bad_alloc &)
+      {
+         w->run = false;
+         return VK_ERROR_INITIALIZATION_FAILED;
+      }
+
+      bool pushed = m_workers.try_push_back(std::move(w));
+      assert(pushed);
+      UNUSED(pushed);
+   }
+
+   return VK_SUCCESS;
+}
+
+int presentation_thread_pool::register_swapchain(swapchain_base &swapchain)
+{
+   std::lock_guard<std::mutex> registry_guard(m_registry_lock);
+
+   assert(!m_workers.empty());
+
+   /* Pin the swapchain to the worker with the fewest swapchains. The
+    * assignment never changes, preserving per-swapchain present order and the
+    * single-consumer contract of the pending buffer ring. */
+   size_t worker_index = 0;
+   for (size_t i = 1; i < m_workers.size(); i++)
+   {
+      if (m_workers[i]->swapchain_count < m_workers[worker_index]->swapchain_count)
+      {
+         worker_index = i;
+      }
+   }
+
+   auto reg = m_allocator.make_unique<registration>();
+   if (reg == nullptr)
+   {
+      return -1;
+   }
+   reg->swapchain = &swapchain;
+   reg->event_fd = util::fd_owner{ eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) };
+   reg->worker_index = worker_index;
+   if (!reg->event_fd.is_valid())
+   {
+      WSI_LOG_WARNING("Failed to create present eventfd, falling back to a dedicated thread.");
+      return -1;
+   }
+
+   if (!m_registrations.try_reserve(m_registrations.size() + 1))
+   {
+      return -1;
+   }
+
+   struct epoll_event event = {};
+   event.events = EPOLLIN;
+   event.data.ptr = reg.get();
+   if (epoll_ctl(m_workers[worker_index]->epoll_fd.get(), EPOLL_CTL_ADD, reg->event_fd.get(), &event) != 0)
+   {
+      WSI_LOG_WARNING("Failed to register present eventfd, falling back to a dedicated thread.");
+      return -1;
+   }
+
+   int event_fd = reg->event_fd.get();
+   bool pushed = m_registrations.try_push_back(std::move(reg));
+   assert(pushed);
+   UNUSED(pushed);
+
+   m_workers[worker_index]->swapchain_count++;
+   return event_fd;
+}
+
+void presentation_thread_pool::unregister_swapchain(swapchain_base &swapchain)
+{
+   std::lock_guard<std::mutex> registry_guard(m_registry_lock);
+
+   auto entry = std::find_if(m_registrations.begin(), m_registrations.end(),
+                             [&swapchain](const auto &reg) { return reg->swapchain == &swapchain; });
+   if (entry == m_registrations.end())
+   {
+      return;
+   }
+
+   auto &w = *m_workers[(*entry)->worker_index];
+
+   /* Stop event delivery first, then wait for the worker to pass a sync point:
+    * any event batch fetched before the removal - which may still hold a
+    * pointer to this registration - has then been fully processed, and the
+    * eventfd can be closed safely. */
+   epoll_ctl(w.epoll_fd.get(), EPOLL_CTL_DEL, (*entry)->event_fd.get(), nullptr);
+   synchronize_worker(w);
+
+   w.swapchain_count--;
+   m_registrations.erase(entry);
+}
+
+void presentation_thread_pool::wake_worker(worker &w)
+{
+   const uint64_t one = 1;
+   UNUSED(write(w.wake_fd.get(), &one, sizeof(one)));
+}
+
+void presentation_thread_pool::synchronize_worker(worker &w)
+{
+   std::unique_lock<std::mutex> lock(w.lock);
+   if (!w.run)
+   {
+      return;
+   }
+   const uint64_t target = w.epoch + 1;
+   wake_worker(w);
+   w.cond.wait(lock, [&w, target] { return w.epoch >= target || !w.run; });
+}
+
+void presentation_thread_pool::worker_main(worker &w)
+{
+   util::apply_presentation_thread_scheduling("present pool worker");
+
+   while (true)
+   {
+      struct epoll_event events[MAX_POOL_EVENTS];
+      int num_events = epoll_wait(w.epoll_fd.get(), events, MAX_POOL_EVENTS, -1);
+      if (num_events < 0)
+      {
+         if (errno == EINTR)
+         {
+            continue;
+         }
+         /* Unrecoverable. Mark the worker stopped so unregistration does not
+          * wait for sync points that will never come. */
+         WSI_LOG_ERROR("epoll_wait failed in presentation pool worker: %d", errno);
+         {
+            std::lock_guard<std::mutex> lock(w.lock);
+            w.run = false;
+         }
+         w.cond.notify_all();
+         break;
+      }
+
+      for (int i = 0; i < num_events; i++)
+      {
+         auto *reg = static_cast<registration *>(events[i].data.ptr);
+         if (reg == nullptr)
+         {
+            /* Wake fd: drain it and fall through to the epoch/run update. */
+            uint64_t value = 0;
+            UNUSED(read(w.wake_fd.get(), &value, sizeof(value)));
+            continue;
+         }
+
+         /* The eventfd read returns the whole accumulated counter, so a
+          * swapchain that queued several presents since the last wake-up is
+          * handled as one batch. */
+         uint64_t count = 0;
+         if (read(reg->event_fd.get(), &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count)) && count > 0)
+         {
+            reg->swapchain->process_pending_presents(count);
+         }
+      }
+
+      bool keep_running = true;
+      {
+         std::lock_guard<std::mutex> lock(w.lock);
+         w.epoch++;
+         keep_running = w.run;
+      }
+      w.cond.notify_all();
+
+      if (!keep_running)
+      {
+         break;
+      }
+   }
+}
+
+} /* namespace wsi */
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ *
+ * @brief A small per-device thread pool that multiplexes the present queues of
+ *        many swapchains, replacing the thread-per-swapchain page flip model.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "util/custom_allocator.hpp"
+#include "util/file_descriptor.hpp"
+
+namespace wsi
+{
+
+class swapchain_base;
+
+/**
+ * @brief Shared presentation engine multiplexing several swapchains.
+ *
+ * Each registered swapchain gets an eventfd acting as its present queue
+ * doorbell: the application thread increments it once per queued present and a
+ * pool worker reads the accumulated counter in one go and processes that many
+ * entries from the swapchain's pending buffer ring. Every swapchain is pinned
+ * to a single worker for its whole lifetime, so the single-consumer contract of
+ * the ring buffer and the FIFO present order are preserved. Workers sleep in
+ * epoll_wait rather than on per-swapchain timed semaphores, so an idle device
+ * costs a handful of parked threads instead of two wake-ups per swapchain every
+ * 250 ms.
+ */
+class presentation_thread_pool
+{
+public:
+   presentation_thread_pool(const util::allocator &allocator);
+   ~presentation_thread_pool();
+
+   presentation_thread_pool(const presentation_thread_pool &) = delete;
+   presentation_thread_pool &operator=(const presentation_thread_pool &) = delete;
+
+   /**
+    * @brief Start the worker threads.
+    *
+    * @param num_threads Number of workers to spawn, clamped to a small maximum.
+    *
+    * @return VK_SUCCESS on success, VK_ERROR_INITIALIZATION_FAILED if a thread
+    *         or its epoll/eventfd instances could not be created.
+    */
+   VkResult start(uint32_t num_threads);
+
+   /**
+    * @brief Register a swapchain with the pool.
+    *
+    * Assigns the swapchain to the least loaded worker and creates the eventfd
+    * the swapchain signals for each queued present. The pool keeps ownership of
+    * the file descriptor until unregister_swapchain().
+    *
+    * @param swapchain The swapchain whose presents the pool will process.
+    *
+    * @return The eventfd to signal per present, or -1 on failure, in which case
+    *         the swapchain should fall back to a dedicated thread.
+    */
+   int register_swapchain(swapchain_base &swapchain);
+
+   /**
+    * @brief Remove a swapchain from the pool.
+    *
+    * Synchronizes with the swapchain's worker: when this returns, no worker is
+    * processing - or will ever again process - presents for the swapchain, and
+    * its eventfd has been closed. Must be called before the swapchain is
+    * destroyed. Unbalanced calls for swapchains that never registered are
+    * ignored.
+    *
+    * @param swapchain The swapchain to remove.
+    */
+   void unregister_swapchain(swapchain_base &swapchain);
+
+private:
+   /**
+    * @brief A swapchain's slot in the pool.
+    *
+    * Heap-allocated so its address is stable: the epoll event for the
+    * swapchain's eventfd carries a pointer to this entry.
+    */
+   struct registration
+   {
+      swapchain_base *swapchain;
+      util::fd_owner event_fd;
+      size_t worker_index;
+   };
+
+   struct worker
+   {
+      std::thread thread;
+      util::fd_owner epoll_fd;
+
+      /** eventfd used to interrupt epoll_wait for shutdown and unregistration. */
+      util::fd_owner wake_fd;
+
+      /** Protects epoch and run; the condition variable signals epoch advances. */
+      std::mutex lock;
+      std::condition_variable cond;
+
+      /**
+       * @brief Incremented by the worker after each processed event batch.
+       *
+       * Lets unregister_swapchain() wait until any batch that may still
+       * reference a removed registration has finished.
+       */
+      uint64_t epoch{ 0 };
+      bool run{ false };
+
+      /** Swapchains currently assigned to this worker, for load balancing. */
+      uint32_t swapchain_count{ 0 };
+   };
+
+   /**
+    * @brief Worker loop: sleep in epoll_wait and process present batches.
+    */
+   void worker_main(worker &w);
+
+   /**
+    * @brief Signal a worker's wake eventfd.
+    */
+   static void wake_worker(worker &w);
+
+   /**
+    * @brief Block until @p w has gone through a full loop iteration.
+    *
+    * On return any event batch the worker had fetched before the call has been
+    * fully processed.
+    */
+   static void synchronize_worker(worker &w);
+
+   util::allocator m_allocator;
+
+   util::vector<util::unique_ptr<worker>> m_workers;
+
+   /** Protects m_registrations and the workers' swapchain counts. */
+   std::mutex m_registry_lock;
+
+   util::vector<util::unique_ptr<registration>> m_registrations;
+};
+
+} /* namespace wsi */
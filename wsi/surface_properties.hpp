@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, 2021-2025 Arm Limited.
+ * Copyright (c) 2017-2019, 2021-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -113,6 +113,17 @@ public:
 
    virtual bool is_compatible_present_modes(VkPresentModeKHR present_mode_a, VkPresentModeKHR present_mode_b) = 0;
 
+   /**
+    * @brief Surface counters (VK_EXT_display_surface_counter) the surface type can serve.
+    *
+    * The base implementation reports none; backends with direct access to the
+    * presentation hardware override this.
+    */
+   virtual VkSurfaceCounterFlagsEXT get_supported_surface_counters()
+   {
+      return 0;
+   }
+
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
    /**
     * @brief Get the present timing surface capabilities for the specific VkSurface type.
@@ -120,11 +131,6 @@ public:
    virtual void get_present_timing_surface_caps(VkPresentTimingSurfaceCapabilitiesEXT *present_timing_surface_caps) = 0;
 #endif
 
-private:
-   /**
-    * @brief Set which presentation modes are compatible with each other for a particular surface
-    */
-   virtual void populate_present_mode_compatibilities() = 0;
 };
 
 class surface_format_properties
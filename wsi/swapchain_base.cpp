@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2025 Arm Limited.
+ * Copyright (c) 2017-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -31,128 +31,156 @@
  * that is not specific to how images are created or presented.
  */
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <ctime>
 #include <system_error>
 
+#include <sys/timerfd.h>
 #include <unistd.h>
 #include <vulkan/vulkan.h>
 
+#include "util/allocation_tracker.hpp"
+#include "util/config.hpp"
 #include "util/log.hpp"
 #include "util/helpers.hpp"
+#include "util/thread_scheduling.hpp"
+#include "util/usdt.hpp"
 
+#include "presentation_thread_pool.hpp"
 #include "swapchain_base.hpp"
+#include "swapchain_present_loop.hpp"
 #include "wsi_factory.hpp"
 
+#include "extensions/present_id.hpp"
 #include "extensions/present_timing.hpp"
 #include "extensions/swapchain_maintenance.hpp"
 
 namespace wsi
 {
 
-void swapchain_base::page_flip_thread()
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+namespace
 {
-   auto &sc_images = m_swapchain_images;
-   VkResult vk_res = VK_SUCCESS;
-   uint64_t timeout = UINT64_MAX;
-   constexpr uint64_t SEMAPHORE_TIMEOUT = 250000000; /* 250 ms. */
 
-   /* No mutex is needed for the accesses to m_page_flip_thread_run variable as after the variable is
-    * initialized it is only ever changed to false. The while loop will make the thread read the
-    * value repeatedly, and the combination of semaphores and thread joins will force any changes to
-    * the variable to be visible to this thread.
-    */
-   while (m_page_flip_thread_run)
-   {
-      pending_present_request submit_info{};
-      if (m_present_mode == VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR)
-      {
-         /* In continuous mode the application will only make one presentation request,
-          * therefore the page flip semaphore will only be signalled once. */
-         if (!m_first_present)
-         {
-            vk_res = VK_SUCCESS;
-         }
-         else if ((vk_res = m_page_flip_semaphore.wait(SEMAPHORE_TIMEOUT)) == VK_TIMEOUT)
-         {
-            /* Image is not ready yet. */
-            continue;
-         }
-         assert(vk_res == VK_SUCCESS);
+/**
+ * Margin subtracted from target present times before the page flip thread
+ * commits, covering the cost of the commit itself so the frame latches at the
+ * vblank nearest the requested time rather than the one after it.
+ */
+constexpr uint64_t TARGET_PRESENT_SCHEDULING_MARGIN_NS = 500000;
 
-         /* Check for shutdown after waking from semaphore wait. */
-         if (!m_page_flip_thread_run)
-            break;
+uint64_t monotonic_time_ns()
+{
+   timespec now = {};
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
 
-         /* For continuous mode there will be only one image in the swapchain.
-          * This image will always be used, and there is no pending state in this case. */
-         submit_info.image_index = 0;
-      }
-      else
-      {
-         /* Waiting for the page_flip_semaphore which will be signalled once there is an
-          * image to display.*/
-         if ((vk_res = m_page_flip_semaphore.wait(SEMAPHORE_TIMEOUT)) == VK_TIMEOUT)
-         {
-            /* Image is not ready yet. */
-            continue;
-         }
+bool target_present_time_is_due(uint64_t target_time_ns)
+{
+   return target_time_ns <= monotonic_time_ns() + TARGET_PRESENT_SCHEDULING_MARGIN_NS;
+}
 
-         /* Check for shutdown after waking from semaphore wait. */
-         if (!m_page_flip_thread_run)
-            break;
+} /* namespace */
 
-         /* We want to present the oldest queued for present image from our present queue,
-          * which we can find at the sc->pending_buffer_pool.head index. */
-         std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
+bool swapchain_base::wait_until_target_present_time(uint64_t target_time_ns)
+{
+   if (target_present_time_is_due(target_time_ns))
+   {
+      return true;
+   }
 
-         auto pending_submission = m_pending_buffer_pool.pop_front();
-         assert(pending_submission.has_value());
-         submit_info = *pending_submission;
+   if (!m_present_timer_fd.is_valid())
+   {
+      m_present_timer_fd = util::fd_owner{ timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC) };
+      if (!m_present_timer_fd.is_valid())
+      {
+         WSI_LOG_WARNING("Failed to create present timer (%d), presenting immediately.", errno);
+         return true;
       }
+   }
+
+   /* The target is an absolute CLOCK_MONOTONIC time, which is exactly what an
+    * absolute CLOCK_MONOTONIC timerfd expires against, so no clock conversion
+    * is needed and a clock adjustment cannot skew the wait. */
+   itimerspec deadline = {};
+   const uint64_t wake_time_ns = target_time_ns - TARGET_PRESENT_SCHEDULING_MARGIN_NS;
+   deadline.it_value.tv_sec = static_cast<time_t>(wake_time_ns / 1000000000ull);
+   deadline.it_value.tv_nsec = static_cast<long>(wake_time_ns % 1000000000ull);
+   if (timerfd_settime(m_present_timer_fd.get(), TFD_TIMER_ABSTIME, &deadline, nullptr) != 0)
+   {
+      WSI_LOG_WARNING("Failed to arm present timer (%d), presenting immediately.", errno);
+      return true;
+   }
 
-      /* We may need to wait for the payload of the present sync of the oldest pending image to be finished. */
-      while ((vk_res = image_wait_present(sc_images[submit_info.image_index], timeout)) == VK_TIMEOUT)
+   /* Wait in bounded slices so swapchain teardown is not held up by a
+    * far-future target, mirroring the page flip semaphore's periodic
+    * shutdown checks. */
+   while (m_page_flip_thread_run)
+   {
+      constexpr int TIMER_WAIT_TIMEOUT_MS = 250;
+      auto status = util::wait_for_readable(m_present_timer_fd.get(), TIMER_WAIT_TIMEOUT_MS);
+      if (status == util::fd_wait_status::timeout)
       {
-         WSI_LOG_WARNING("Timeout waiting for image's present fences, retrying..");
+         continue;
       }
-      if (vk_res != VK_SUCCESS)
+      if (status == util::fd_wait_status::readable)
       {
-         set_error_state(vk_res);
-         m_free_image_semaphore.post();
-         continue;
+         uint64_t expirations = 0;
+         UNUSED(read(m_present_timer_fd.get(), &expirations, sizeof(expirations)));
       }
-
-      call_present(submit_info);
+      return true;
    }
+
+   return false;
 }
+#endif
 
 void swapchain_base::call_present(const pending_present_request &pending_present)
 {
-   /* First present of the swapchain. If it has an ancestor, wait until all the
-    * pending buffers from the ancestor have been presented. */
-   if (m_first_present)
-   {
-      if (m_ancestor != VK_NULL_HANDLE)
-      {
-         auto *ancestor = reinterpret_cast<swapchain_base *>(m_ancestor);
-         ancestor->wait_for_pending_buffers();
-      }
+   call_present_loop<swapchain_base>(pending_present);
+}
 
-      sem_post(&m_start_present_semaphore);
+void swapchain_base::process_pending_presents(uint64_t count)
+{
+   m_process_pending_presents_fn(*this, count);
+}
 
-      present_image(pending_present);
+void swapchain_base::page_flip_thread()
+{
+   m_page_flip_thread_fn(*this);
+}
 
-      m_first_present = false;
+void swapchain_base::deliver_captured_frame(const pending_present_request &pending_present)
+{
+   if (!m_frame_capture.try_claim_frame())
+   {
+      /* Frame-skip backpressure: the consumer still holds its maximum number
+       * of frames, so this one is dropped before any fds are duplicated. */
+      return;
    }
-   /* The swapchain has already started presenting. */
-   else
+
+   VkCapturedFrameWSI frame = {};
+   frame.imageIndex = pending_present.image_index;
+   frame.presentId = pending_present.present_id;
+   frame.width = m_image_create_info.extent.width;
+   frame.height = m_image_create_info.extent.height;
+   frame.format = m_image_create_info.format;
+   frame.releaseFenceFd = -1;
+
+   if (!fill_captured_frame(pending_present.image_index, frame))
    {
-      present_image(pending_present);
+      m_frame_capture.abandon_frame();
+      return;
    }
+
+   m_frame_capture.deliver(frame);
 }
 
 bool swapchain_base::has_descendant_started_presenting()
@@ -168,12 +196,63 @@ bool swapchain_base::has_descendant_started_presenting()
 
 VkResult swapchain_base::init_page_flip_thread()
 {
+   /* Prefer the device-wide presentation thread pool over a dedicated thread.
+    * Shared present modes are excluded: continuous refresh re-presents from its
+    * thread without further requests, which would monopolize a pool worker.
+    * Deferred allocation relies on the dedicated thread's periodic wake-ups to
+    * scavenge released images, whereas pool workers only wake on presents. */
+   bool pool_eligible = m_present_mode != VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR &&
+                        m_present_mode != VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR &&
+                        !m_image_deferred_allocation;
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   /* Present timing lets the application request target present times, which the
+    * page flip thread honours by sleeping on a timerfd until the target is due.
+    * A pool worker serves every swapchain on the device, so a timed swapchain
+    * keeps a dedicated thread that can block without stalling other presents. */
+   pool_eligible = pool_eligible && get_swapchain_extension<wsi::wsi_ext_present_timing>() == nullptr;
+#endif
+
+   if (pool_eligible)
+   {
+      auto *pool = m_device_data.get_presentation_thread_pool();
+      if (pool != nullptr)
+      {
+         m_present_event_fd = pool->register_swapchain(*this);
+         if (m_present_event_fd >= 0)
+         {
+            /* Present requests still take the threaded path through
+             * m_pending_buffer_pool; the pool worker plays the consumer role. */
+            m_page_flip_thread_run = true;
+            return VK_SUCCESS;
+         }
+      }
+   }
+
+   /* The dedicated thread is not spawned here: swapchains that are created
+    * and immediately replaced without presenting (e.g. while probing surface
+    * settings) would pay for the thread and its idle wake-up loop for
+    * nothing. Only the routing decision is made now - presents queue through
+    * m_pending_buffer_pool - and the spawn happens on first use, pre-warmed
+    * by the first acquire. */
+   m_page_flip_thread_run = true;
+   m_page_flip_thread_deferred = true;
+   return VK_SUCCESS;
+}
+
+VkResult swapchain_base::start_page_flip_thread()
+{
+   if (!m_page_flip_thread_deferred)
+   {
+      return VK_SUCCESS;
+   }
+   m_page_flip_thread_deferred = false;
+
    /* Setup semaphore for signaling pageflip thread */
    TRY_LOG_CALL(m_page_flip_semaphore.init(0));
    m_thread_sem_defined = true;
 
    /* Launch page flipping thread */
-   m_page_flip_thread_run = true;
    try
    {
       m_page_flip_thread = std::thread(&swapchain_base::page_flip_thread, this);
@@ -189,38 +268,106 @@ VkResult swapchain_base::init_page_flip_thread()
    return VK_SUCCESS;
 }
 
-void swapchain_base::unpresent_image(uint32_t presented_index)
+void swapchain_base::start_image_growth()
 {
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
+   m_image_growth_spawned = true;
+   try
+   {
+      m_image_growth_thread = std::thread(&swapchain_base::image_growth_thread, this);
+   }
+   catch (const std::system_error &)
+   {
+      /* No thread available: build the images on this thread instead. Slower
+       * for this acquire, but the swapchain still reaches its full count. */
+      image_growth_thread();
+   }
+}
 
-   if (m_present_mode == VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR ||
-       m_present_mode == VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR)
+void swapchain_base::image_growth_thread()
+{
+   for (auto &img : m_swapchain_images)
    {
-      m_swapchain_images[presented_index].status = swapchain_image::ACQUIRED;
+      if (img.status != swapchain_image::UNALLOCATED)
+      {
+         continue;
+      }
+
+      const VkResult result = allocate_and_bind_swapchain_image(m_image_create_info, img);
+      if (result != VK_SUCCESS)
+      {
+         /* Keep operating with the images built so far; the count stays out of
+          * the free image semaphore so nothing ever waits for this image. */
+         WSI_LOG_WARNING("Failed to grow swapchain to its full image count, continuing with fewer images.");
+         break;
+      }
+
+      /* Publish: the status store must be visible before the post wakes an
+       * acquire scanning for a FREE image. */
+      img.status = swapchain_image::FREE;
+      m_unallocated_image_count.fetch_sub(1, std::memory_order_relaxed);
+      m_free_image_semaphore.post();
+   }
+}
+
+void swapchain_base::signal_pending_present()
+{
+   if (m_present_event_fd >= 0)
+   {
+      /* The eventfd counter accumulates one increment per queued present; the
+       * pool worker reads it in one go and processes that many ring entries. */
+      const uint64_t one = 1;
+      UNUSED(write(m_present_event_fd, &one, sizeof(one)));
    }
    else
    {
-      m_swapchain_images[presented_index].status = swapchain_image::FREE;
+      m_page_flip_semaphore.post();
    }
+}
 
-   image_status_lock.unlock();
+void swapchain_base::unpresent_image(uint32_t presented_index)
+{
+   WSI_USDT2(buffer_release, this, presented_index);
 
-   if (m_present_mode != VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR &&
-       m_present_mode != VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR)
+   if (mark_image_free(presented_index))
    {
       m_free_image_semaphore.post();
    }
+
+   if (m_descendant != VK_NULL_HANDLE)
+   {
+      signal_handoff_if_drained();
+   }
+}
+
+bool swapchain_base::mark_image_free(uint32_t presented_index)
+{
+   m_latency_tracker.mark_released(presented_index);
+
+   /* The status is atomic, so the page flip thread can release an image
+    * without contending with the application thread. */
+   if (m_present_mode == VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR ||
+       m_present_mode == VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR)
+   {
+      m_swapchain_images[presented_index].status = swapchain_image::ACQUIRED;
+      return false;
+   }
+
+   m_swapchain_images[presented_index].status = swapchain_image::FREE;
+   return true;
 }
 
 swapchain_base::swapchain_base(layer::device_private_data &dev_data, const VkAllocationCallbacks *callbacks)
    : m_device_data(dev_data)
    , m_page_flip_thread_run(false)
+   , m_page_flip_thread_deferred(false)
    , m_start_present_semaphore()
    , m_thread_sem_defined(false)
    , m_first_present(true)
    , m_pending_buffer_pool()
    , m_allocator(dev_data.get_allocator(), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, callbacks)
    , m_swapchain_images(m_allocator)
+   , m_scavenge_queue(m_allocator)
+   , m_aliased_image_cache(m_allocator)
    , m_surface(VK_NULL_HANDLE)
    , m_present_mode(VK_PRESENT_MODE_IMMEDIATE_KHR)
    , m_present_modes(m_allocator)
@@ -234,6 +381,18 @@ swapchain_base::swapchain_base(layer::device_private_data &dev_data, const VkAll
    , m_started_presenting(false)
    , m_extensions(m_allocator)
 {
+   /* VULKAN_WSI_ACQUIRE_SPIN_US caps how long acquire may busy-poll for a free
+    * buffer before parking on the semaphore. Unset or 0 keeps the previous
+    * sleep-immediately behaviour. */
+   const uint64_t acquire_spin_us = util::config::get().acquire_spin_us();
+   if (acquire_spin_us != 0)
+   {
+      m_acquire_spin_limit_ns = acquire_spin_us * 1000;
+      /* Start from the cap so the predictor learns the real latency downwards. */
+      m_predicted_free_wait_ns = m_acquire_spin_limit_ns;
+   }
+
+   m_governor_enabled = util::config::get().latency_governor();
 }
 
 VkResult swapchain_base::init(VkDevice device, const VkSwapchainCreateInfoKHR *swapchain_create_info)
@@ -266,6 +425,20 @@ VkResult swapchain_base::init(VkDevice device, const VkSwapchainCreateInfoKHR *s
    bool use_presentation_thread = true;
    TRY_LOG_CALL(init_platform(device, swapchain_create_info, use_presentation_thread));
 
+   /* Select the synchronization backend. When the WSI backend allows it and the device
+    * supports timeline semaphores, a single timeline per swapchain replaces the
+    * per-image fences. On failure we silently fall back to the backend's fences. */
+   if (can_use_timeline_sync() && timeline_sync::is_supported(m_device_data))
+   {
+      m_timeline_sync = timeline_sync::create(m_device_data);
+   }
+
+   /* Decided here rather than with the image setup below so init_page_flip_thread
+    * can rule out the shared presentation pool, whose workers only wake on
+    * presents and so never scavenge released images periodically. */
+   m_image_deferred_allocation =
+      (swapchain_create_info->flags & VK_SWAPCHAIN_CREATE_DEFERRED_MEMORY_ALLOCATION_BIT_EXT) != 0;
+
    if (use_presentation_thread)
    {
       TRY_LOG_CALL(init_page_flip_thread());
@@ -289,26 +462,81 @@ VkResult swapchain_base::init(VkDevice device, const VkSwapchainCreateInfoKHR *s
    image_create_info.pQueueFamilyIndices = swapchain_create_info->pQueueFamilyIndices;
    image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-   VkResult result = m_free_image_semaphore.init(m_swapchain_images.size());
-   if (result != VK_SUCCESS)
+   const bool image_deferred_allocation = m_image_deferred_allocation;
+   if (!m_scavenge_queue.try_reserve(m_swapchain_images.size()))
    {
-      assert(result == VK_ERROR_OUT_OF_HOST_MEMORY);
-      return result;
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
 
-   const bool image_deferred_allocation =
-      swapchain_create_info->flags & VK_SWAPCHAIN_CREATE_DEFERRED_MEMORY_ALLOCATION_BIT_EXT;
-   for (auto &img : m_swapchain_images)
+   /* When replacing an old swapchain, try to adopt its compatible FREE images instead
+    * of allocating new ones. This happens before the ancestor is deprecated, which
+    * would otherwise destroy the FREE images. */
+   swapchain_base *ancestor_sc = nullptr;
+   if (swapchain_create_info->oldSwapchain != VK_NULL_HANDLE && !image_deferred_allocation && can_transfer_images())
+   {
+      ancestor_sc = reinterpret_cast<swapchain_base *>(swapchain_create_info->oldSwapchain);
+   }
+
+   /* Images whose backend resources still need to be allocated after the
+    * serial creation pass below. */
+   util::vector<size_t> images_to_allocate(util::allocator(m_allocator, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND));
+   if (!images_to_allocate.try_reserve(m_swapchain_images.size()))
+   {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   /* Lazy growth: build only the first few images eagerly and leave the rest
+    * for a background allocator on first demand. Many applications never keep
+    * more than two images in flight, so the remaining allocations - tens of MB
+    * each at 4K - often never happen at all. Deferred-memory-allocation
+    * swapchains already defer everything, so the knob is ignored for them. */
+   size_t eager_image_budget = m_swapchain_images.size();
+   if (!image_deferred_allocation)
+   {
+      const size_t lazy_image_count = util::config::get().lazy_image_count();
+      if (lazy_image_count != 0)
+      {
+         eager_image_budget = std::min(lazy_image_count, eager_image_budget);
+      }
+   }
+
+   size_t ready_images = 0;
+   for (size_t image_index = 0; image_index < m_swapchain_images.size(); image_index++)
    {
+      auto &img = m_swapchain_images[image_index];
+      if (ancestor_sc != nullptr && ancestor_sc->transfer_compatible_free_image(image_create_info, m_allocator, img))
+      {
+         /* The image arrives complete with its VkImage handle, backend resources and
+          * present semaphores. Inherit the image creation parameters in case no image
+          * needs to be created from scratch below. */
+         m_image_create_info = ancestor_sc->m_image_create_info;
+         m_image_create_info.pNext = nullptr;
+         TRY(inherit_image_creation_parameters(*ancestor_sc));
+         ready_images++;
+         continue;
+      }
+
       TRY(create_swapchain_image(image_create_info, img));
 
       if (image_deferred_allocation)
       {
          img.status = swapchain_image::UNALLOCATED;
       }
+      else if (ready_images < eager_image_budget)
+      {
+         /* Allocation is deferred to the loop below so it can run for all
+          * images concurrently; try_reserve above makes this infallible. */
+         bool pushed = images_to_allocate.try_push_back(image_index);
+         assert(pushed);
+         UNUSED(pushed);
+         ready_images++;
+      }
       else
       {
-         TRY_LOG_CALL(allocate_and_bind_swapchain_image(image_create_info, img));
+         /* Beyond the eager budget: leave the backend resources unbuilt for
+          * the growth thread started on first demand. */
+         img.status = swapchain_image::UNALLOCATED;
+         m_unallocated_image_count.fetch_add(1, std::memory_order_relaxed);
       }
 
       VkSemaphoreCreateInfo semaphore_info = {};
@@ -320,7 +548,84 @@ VkResult swapchain_base::init(VkDevice device, const VkSwapchainCreateInfoKHR *s
                                                       &img.present_fence_wait));
    }
 
-   m_device_data.disp.GetDeviceQueue(m_device, 0, 0, &m_queue);
+   /* Lazily deferred images only post the semaphore once the growth thread has
+    * built them, so they do not contribute to the initial count. */
+   VkResult result = m_free_image_semaphore.init(m_swapchain_images.size() -
+                                                 m_unallocated_image_count.load(std::memory_order_relaxed));
+   if (result != VK_SUCCESS)
+   {
+      assert(result == VK_ERROR_OUT_OF_HOST_MEMORY);
+      return result;
+   }
+
+   if (can_allocate_images_concurrently() && images_to_allocate.size() > 1)
+   {
+      /* Build the per-image backend resources (buffer allocation, memory
+       * import, presentation fences) across a small task pool, so creation
+       * latency approaches the cost of the slowest image. On failure the
+       * already-built images are released by teardown(), exactly as for a
+       * failure in the serial path. */
+      constexpr size_t MAX_IMAGE_ALLOCATION_THREADS = 4;
+
+      std::atomic<size_t> next_image{ 0 };
+      std::atomic<VkResult> first_error{ VK_SUCCESS };
+
+      auto allocation_worker = [&]() {
+         while (first_error.load(std::memory_order_relaxed) == VK_SUCCESS)
+         {
+            const size_t index = next_image.fetch_add(1, std::memory_order_relaxed);
+            if (index >= images_to_allocate.size())
+            {
+               break;
+            }
+
+            const VkResult alloc_result =
+               allocate_and_bind_swapchain_image(image_create_info, m_swapchain_images[images_to_allocate[index]]);
+            if (alloc_result != VK_SUCCESS)
+            {
+               VkResult expected = VK_SUCCESS;
+               first_error.compare_exchange_strong(expected, alloc_result);
+            }
+         }
+      };
+
+      std::array<std::thread, MAX_IMAGE_ALLOCATION_THREADS - 1> helpers;
+      size_t helper_count = std::min(images_to_allocate.size(), MAX_IMAGE_ALLOCATION_THREADS) - 1;
+      for (size_t i = 0; i < helper_count; i++)
+      {
+         try
+         {
+            helpers[i] = std::thread(allocation_worker);
+         }
+         catch (const std::system_error &)
+         {
+            /* Whatever could not be offloaded is picked up by this thread. */
+            helper_count = i;
+            break;
+         }
+      }
+
+      allocation_worker();
+
+      for (size_t i = 0; i < helper_count; i++)
+      {
+         helpers[i].join();
+      }
+
+      TRY_LOG(first_error.load(), "Failed to allocate and bind swapchain images");
+   }
+   else
+   {
+      for (const size_t image_index : images_to_allocate)
+      {
+         TRY_LOG_CALL(allocate_and_bind_swapchain_image(image_create_info, m_swapchain_images[image_index]));
+      }
+   }
+
+   /* The device-wide present queue selection steers payload submissions away
+    * from the queue the application renders on when it created more than one. */
+   m_device_data.disp.GetDeviceQueue(m_device, m_device_data.get_present_queue_family(),
+                                     m_device_data.get_present_queue_index(), &m_queue);
    TRY_LOG_CALL(m_device_data.SetDeviceLoaderData(m_device, m_queue));
 
    int res = sem_init(&m_start_present_semaphore, 0, 0);
@@ -331,6 +636,13 @@ VkResult swapchain_base::init(VkDevice device, const VkSwapchainCreateInfoKHR *s
       return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
 
+   res = sem_init(&m_handoff_semaphore, 0, 0);
+   assert(res == 0);
+   if (res != 0)
+   {
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
    /* Release the swapchain images of the old swapchain in order
     * to free up memory for new swapchain. This is necessary especially
     * on platform with limited display memory size.
@@ -358,6 +670,13 @@ void swapchain_base::teardown()
     * immediately. For images in the PENDING state, we will block until the
     * presentation engine is finished with them. */
 
+   if (m_image_growth_thread.joinable())
+   {
+      /* Growth is bounded work; once joined the unallocated count is stable
+       * for the pending-buffer accounting below. */
+      m_image_growth_thread.join();
+   }
+
    if (has_descendant_started_presenting())
    {
       /* Here we wait for the start_present_semaphore, once this semaphore is up,
@@ -379,6 +698,15 @@ void swapchain_base::teardown()
    }
 
    /* We are safe to destroy everything. */
+   if (m_present_event_fd >= 0)
+   {
+      /* Synchronously drops this swapchain from the shared pool; when this
+       * returns no worker is still processing our presents. */
+      m_device_data.get_presentation_thread_pool()->unregister_swapchain(*this);
+      m_present_event_fd = -1;
+      m_page_flip_thread_run = false;
+   }
+
    if (m_thread_sem_defined)
    {
       /* Tell flip thread to end. */
@@ -400,6 +728,12 @@ void swapchain_base::teardown()
       WSI_LOG_ERROR("sem_destroy failed for start_present_semaphore with %d", errno);
    }
 
+   res = sem_destroy(&m_handoff_semaphore);
+   if (res != 0)
+   {
+      WSI_LOG_ERROR("sem_destroy failed for handoff_semaphore with %d", errno);
+   }
+
    if (m_descendant != VK_NULL_HANDLE)
    {
       auto *sc = reinterpret_cast<swapchain_base *>(m_descendant);
@@ -420,11 +754,39 @@ void swapchain_base::teardown()
       m_device_data.disp.DestroySemaphore(m_device, img.present_semaphore, get_allocation_callbacks());
       m_device_data.disp.DestroySemaphore(m_device, img.present_fence_wait, get_allocation_callbacks());
    }
+
+   /* Stop routing vkDestroyImage calls here first, then destroy the cached
+    * handles: they were never bound and the application no longer holds them.
+    * Aliased handles the application does still hold were only dropped from
+    * the tracking and take the regular destruction path into the driver. */
+   m_device_data.untrack_swapchain_aliased_images(reinterpret_cast<VkSwapchainKHR>(this));
+   {
+      const std::lock_guard<std::mutex> lock(m_aliased_image_cache_lock);
+      for (auto &image : m_aliased_image_cache)
+      {
+         m_device_data.disp.DestroyImage(m_device, image, get_allocation_callbacks());
+      }
+      m_aliased_image_cache.clear();
+   }
 }
 
 VkResult swapchain_base::acquire_next_image(uint64_t timeout, VkSemaphore semaphore, VkFence fence,
                                             uint32_t *image_index)
 {
+   util::hot_path_scope allocation_scope;
+
+   /* Taken on entry so the trace records the application's call cadence, not
+    * how long the acquire blocked. */
+   const uint64_t trace_start_ns = m_present_trace.is_enabled() ? present_trace::timestamp() : 0;
+
+   /* Pre-warm the deferred page flip thread: the first acquire runs at least a
+    * frame of application work before the first present needs a consumer, so
+    * the spawn cost never lands on the present critical path. */
+   if (m_page_flip_thread_deferred)
+   {
+      TRY_LOG_CALL(start_page_flip_thread());
+   }
+
    std::unique_lock<std::mutex> acquire_lock(m_image_acquire_lock);
 
    TRY(wait_for_free_buffer(timeout));
@@ -433,24 +795,53 @@ VkResult swapchain_base::acquire_next_image(uint64_t timeout, VkSemaphore semaph
       return get_error_state();
    }
 
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
+   /* On deferred-allocation swapchains the scan must be serialized with the page
+    * flip thread's scavenger, which tears down and rebuilds released images. All
+    * other swapchains claim a free image without any lock. */
+   std::unique_lock<std::mutex> scavenge_lock(m_scavenge_queue_mutex, std::defer_lock);
+   if (m_image_deferred_allocation)
+   {
+      scavenge_lock.lock();
+   }
 
    size_t i;
    for (i = 0; i < m_swapchain_images.size(); ++i)
    {
       if (m_swapchain_images[i].status == swapchain_image::UNALLOCATED)
       {
-         auto res = allocate_and_bind_swapchain_image(m_image_create_info, m_swapchain_images[i]);
-         if (res != VK_SUCCESS)
+         if (!m_image_deferred_allocation)
          {
-            WSI_LOG_ERROR("Failed to allocate swapchain image.");
-            return res != VK_ERROR_INITIALIZATION_FAILED ? res : VK_ERROR_OUT_OF_HOST_MEMORY;
+            /* A lazy-growth image the background allocator has not built yet. The
+             * free image semaphore only counts built images, so a FREE image is
+             * guaranteed further along the scan. */
+            continue;
+         }
+
+         /* An image released with vkReleaseSwapchainImagesEXT that the scavenger has
+          * not reached yet still has its backing memory: reclaim it warm instead of
+          * reallocating. */
+         auto it = std::find(m_scavenge_queue.begin(), m_scavenge_queue.end(), static_cast<uint32_t>(i));
+         if (it != m_scavenge_queue.end())
+         {
+            m_scavenge_queue.erase(it);
+            m_swapchain_images[i].status = swapchain_image::FREE;
+         }
+         else
+         {
+            auto res = allocate_and_bind_swapchain_image(m_image_create_info, m_swapchain_images[i]);
+            if (res != VK_SUCCESS)
+            {
+               WSI_LOG_ERROR("Failed to allocate swapchain image.");
+               return res != VK_ERROR_INITIALIZATION_FAILED ? res : VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
          }
       }
 
-      if (m_swapchain_images[i].status == swapchain_image::FREE)
+      /* Claim the image with a CAS: the page flip thread releases images to FREE
+       * concurrently, and a descendant swapchain may adopt them. */
+      auto expected = swapchain_image::FREE;
+      if (m_swapchain_images[i].status.compare_exchange_strong(expected, swapchain_image::ACQUIRED))
       {
-         m_swapchain_images[i].status = swapchain_image::ACQUIRED;
          *image_index = i;
          break;
       }
@@ -458,7 +849,13 @@ VkResult swapchain_base::acquire_next_image(uint64_t timeout, VkSemaphore semaph
 
    assert(i < m_swapchain_images.size());
 
-   image_status_lock.unlock();
+   if (scavenge_lock.owns_lock())
+   {
+      scavenge_lock.unlock();
+   }
+
+   m_present_trace.trace_acquire(trace_start_ns, *image_index, m_present_mode.load(std::memory_order_relaxed),
+                                 static_cast<uint32_t>(m_pending_buffer_pool.size()));
 
    /* Try to signal fences/semaphores with a sync FD for optimal performance. */
    if (m_device_data.disp.get_fn<PFN_vkImportFenceFdKHR>("vkImportFenceFdKHR").has_value() &&
@@ -517,6 +914,13 @@ VkResult swapchain_base::acquire_next_image(uint64_t timeout, VkSemaphore semaph
       }
    }
 
+   /* Everything was signalled through sync FD imports, or the application did
+    * not ask for a signal at all: nothing left to submit. */
+   if (fence == VK_NULL_HANDLE && semaphore == VK_NULL_HANDLE)
+   {
+      return VK_SUCCESS;
+   }
+
    /* Fallback for when importing fence/semaphore sync FDs is unsupported by the ICD. */
    queue_submit_semaphores semaphores = {
       nullptr,
@@ -571,7 +975,44 @@ VkResult swapchain_base::get_swapchain_images(uint32_t *swapchain_image_count, V
 
 VkResult swapchain_base::create_aliased_image_handle(VkImage *image)
 {
-   return m_device_data.disp.CreateImage(m_device, &m_image_create_info, get_allocation_callbacks(), image);
+   VkImage handle = VK_NULL_HANDLE;
+   {
+      const std::lock_guard<std::mutex> lock(m_aliased_image_cache_lock);
+      if (!m_aliased_image_cache.empty())
+      {
+         handle = m_aliased_image_cache.back();
+         m_aliased_image_cache.pop_back();
+      }
+   }
+
+   if (handle == VK_NULL_HANDLE)
+   {
+      TRY(m_device_data.disp.CreateImage(m_device, &m_image_create_info, get_allocation_callbacks(), &handle));
+   }
+
+   /* Track the handle so vkDestroyImage can route it back here for as long as
+    * it stays unbound. Tracking is best-effort: an untracked handle is simply
+    * destroyed by the driver. */
+   m_device_data.track_aliased_image(handle, reinterpret_cast<VkSwapchainKHR>(this));
+
+   *image = handle;
+   return VK_SUCCESS;
+}
+
+bool swapchain_base::recycle_aliased_image_handle(VkImage image)
+{
+   /* An application holding more unbound aliases than there are presentable
+    * images gains nothing from the extras, so cap the cache at the image
+    * count. The count is fixed once init() has run and aliases cannot be
+    * created before that, so reading it unlocked is safe. */
+   const size_t max_cached = m_swapchain_images.size();
+
+   const std::lock_guard<std::mutex> lock(m_aliased_image_cache_lock);
+   if (m_aliased_image_cache.size() >= max_cached)
+   {
+      return false;
+   }
+   return m_aliased_image_cache.try_push_back(image);
 }
 
 VkResult swapchain_base::get_swapchain_status()
@@ -579,9 +1020,34 @@ VkResult swapchain_base::get_swapchain_status()
    return get_error_state();
 }
 
+VkResult swapchain_base::wait_for_present(uint64_t present_id, uint64_t timeout)
+{
+   if (error_has_occured())
+   {
+      return get_error_state();
+   }
+
+   auto *ext = get_swapchain_extension<wsi_ext_present_id>();
+   if (ext == nullptr)
+   {
+      /* Waiting requires the presentId feature, which the application never
+       * enabled; no ID can ever be reached so the wait degenerates to a
+       * timeout. */
+      WSI_LOG_WARNING("vkWaitForPresentKHR called without the presentId feature enabled.");
+      return VK_TIMEOUT;
+   }
+
+   return ext->wait_for_present_id(present_id, timeout);
+}
+
 VkResult swapchain_base::notify_presentation_engine(const pending_present_request &pending_present)
 {
-   const std::lock_guard<std::recursive_mutex> lock(m_image_status_mutex);
+   /* Shared presentable images can be presented without a prior acquire, so
+    * the deferred thread may not have been pre-warmed yet. */
+   if (m_page_flip_thread_deferred)
+   {
+      TRY_LOG_CALL(start_page_flip_thread());
+   }
 
    /* If the descendant has started presenting, we should release the image
     * however we do not want to block inside the main thread so we mark it
@@ -594,24 +1060,51 @@ VkResult swapchain_base::notify_presentation_engine(const pending_present_reques
       return VK_ERROR_OUT_OF_DATE_KHR;
    }
 
-   /* If the image is already PENDING (queued from a previous present without
-    * re-acquisition), skip the duplicate push.  The page_flip_thread will
-    * present the latest content when it processes the original entry because
-    * image_wait_present uses the image's current fence (set by the most
-    * recent image_set_present_payload call). */
-   if (m_swapchain_images[pending_present.image_index].status == swapchain_image::PENDING)
+   /* Move the image to PENDING with a CAS so the check does not race with the
+    * page flip thread releasing it. If the image is already PENDING (queued from
+    * a previous present without re-acquisition), skip the duplicate push. The
+    * page_flip_thread will present the latest content when it processes the
+    * original entry because image_wait_present uses the image's current fence
+    * (set by the most recent image_set_present_payload call). */
+   auto expected = swapchain_image::ACQUIRED;
+   if (!m_swapchain_images[pending_present.image_index].status.compare_exchange_strong(expected,
+                                                                                       swapchain_image::PENDING))
    {
-      return VK_SUCCESS;
+      if (expected == swapchain_image::PENDING)
+      {
+         if (pending_present.damage_rect_count > 0)
+         {
+            /* The queued request only carries its own damage rectangles, so a
+             * follow-up present with damage of its own must reach the backend as
+             * well: the presentation engine needs the union of both regions. If
+             * the buffer pool has no room left keep the skip - the queued entry
+             * still presents the latest content. */
+            if (!m_page_flip_thread_run)
+            {
+               call_present(pending_present);
+            }
+            else if (m_pending_buffer_pool.push_back(pending_present))
+            {
+               signal_pending_present();
+            }
+         }
+         return VK_SUCCESS;
+      }
+
+      /* The image was in another state, e.g. FREE on a shared presentable
+       * swapchain: take it to PENDING unconditionally as before. */
+      m_swapchain_images[pending_present.image_index].status = swapchain_image::PENDING;
    }
 
-   m_swapchain_images[pending_present.image_index].status = swapchain_image::PENDING;
    m_started_presenting = true;
 
+   m_latency_tracker.mark_queue_present(pending_present.image_index);
+
    if (m_page_flip_thread_run)
    {
       bool buffer_pool_res = m_pending_buffer_pool.push_back(pending_present);
       assert(buffer_pool_res);
-      m_page_flip_semaphore.post();
+      signal_pending_present();
    }
    else
    {
@@ -621,9 +1114,55 @@ VkResult swapchain_base::notify_presentation_engine(const pending_present_reques
    return VK_SUCCESS;
 }
 
+present_info_extensions index_present_info_extensions(const void *pNext)
+{
+   present_info_extensions extensions{};
+
+   for (auto entry = reinterpret_cast<const VkBaseInStructure *>(pNext); entry != nullptr; entry = entry->pNext)
+   {
+      switch (entry->sType)
+      {
+      case VK_STRUCTURE_TYPE_PRESENT_ID_KHR:
+         extensions.present_ids = reinterpret_cast<const VkPresentIdKHR *>(entry);
+         break;
+      case VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR:
+         extensions.present_regions = reinterpret_cast<const VkPresentRegionsKHR *>(entry);
+         break;
+      case VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_FENCE_INFO_EXT:
+         extensions.present_fence_info = reinterpret_cast<const VkSwapchainPresentFenceInfoEXT *>(entry);
+         break;
+      case VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_MODE_INFO_EXT:
+         extensions.present_mode_info = reinterpret_cast<const VkSwapchainPresentModeInfoEXT *>(entry);
+         break;
+      case VK_STRUCTURE_TYPE_FRAME_BOUNDARY_EXT:
+         extensions.frame_boundary = reinterpret_cast<const VkFrameBoundaryEXT *>(entry);
+         break;
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+      case VK_STRUCTURE_TYPE_PRESENT_TIMINGS_INFO_EXT:
+         extensions.present_timings_info = reinterpret_cast<const VkPresentTimingsInfoEXT *>(entry);
+         break;
+#endif
+      default:
+         break;
+      }
+   }
+
+   return extensions;
+}
+
 VkResult swapchain_base::queue_present(VkQueue queue, const VkPresentInfoKHR *present_info,
                                        const swapchain_presentation_parameters &submit_info)
 {
+   util::hot_path_scope allocation_scope;
+
+   WSI_USDT3(queue_present, this, submit_info.pending_present.image_index, submit_info.pending_present.present_id);
+
+   const uint64_t trace_start_ns = m_present_trace.is_enabled() ? present_trace::timestamp() : 0;
+
+   /* Payload submissions go to the layer's own present queue; the queue the
+    * application presented on is not used directly. */
+   UNUSED(queue);
+
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
    auto *ext = get_swapchain_extension<wsi::wsi_ext_present_timing>();
    if (ext)
@@ -641,65 +1180,276 @@ VkResult swapchain_base::queue_present(VkQueue queue, const VkPresentInfoKHR *pr
       if (ext)
       {
          TRY_LOG_CALL(ext->handle_switching_presentation_mode(submit_info.present_mode));
+
+         /* Flip the mode the presentation consumer acts on. The switch is only
+          * reachable for modes the backend reports as compatible, which never
+          * change the threading setup chosen at init, so the page flip thread
+          * simply picks up the new queueing behaviour - e.g. mailbox
+          * skip-ahead - from the next batch on, with no swapchain recreation. */
+         m_present_mode.store(submit_info.present_mode, std::memory_order_relaxed);
       }
    }
 
-   const VkSemaphore *wait_semaphores = &m_swapchain_images[submit_info.pending_present.image_index].present_semaphore;
-   uint32_t sem_count = 1;
-   if (!submit_info.use_image_present_semaphore)
+   /* When the payload was already covered by a batched multi-swapchain
+    * submission there is nothing left to submit here. */
+   if (!submit_info.payload_already_set)
    {
-      wait_semaphores = present_info->pWaitSemaphores;
-      sem_count = present_info->waitSemaphoreCount;
+      const VkSemaphore *wait_semaphores =
+         &m_swapchain_images[submit_info.pending_present.image_index].present_semaphore;
+      uint32_t sem_count = 1;
+      if (!submit_info.use_image_present_semaphore)
+      {
+         wait_semaphores = present_info->pWaitSemaphores;
+         sem_count = present_info->waitSemaphoreCount;
+      }
+
+      if (!m_page_flip_thread_run)
+      {
+         /* If the page flip thread is not running, we need to wait for any present payload here, before setting a new present payload. */
+         constexpr uint64_t WAIT_PRESENT_TIMEOUT = 1000000000; /* 1 second */
+         TRY_LOG_CALL(
+            wait_present_payload(m_swapchain_images[submit_info.pending_present.image_index], WAIT_PRESENT_TIMEOUT));
+      }
+
+      void *submission_pnext = nullptr;
+      std::optional<VkFrameBoundaryEXT> frame_boundary;
+      /* Do not handle the event if it was handled before reaching this point */
+      if (submit_info.handle_present_frame_boundary_event)
+      {
+         auto *ext = get_swapchain_extension<wsi::wsi_ext_frame_boundary>();
+         frame_boundary = handle_frame_boundary_event(
+            submit_info.app_frame_boundary, &m_swapchain_images[submit_info.pending_present.image_index].image, ext);
+
+         if (frame_boundary)
+         {
+            submission_pnext = &frame_boundary.value();
+         }
+      }
+
+      /* The timeline payload submission does not occupy the fence slot of its
+       * queue submission, so a present fence can be signalled directly from it
+       * instead of through a second submission chained via present_fence_wait. */
+      const bool fold_present_fence = submit_info.present_fence != VK_NULL_HANDLE && m_timeline_sync.has_value();
+      const bool chain_present_fence = submit_info.present_fence != VK_NULL_HANDLE && !fold_present_fence;
+
+      queue_submit_semaphores semaphores = {
+         wait_semaphores,
+         sem_count,
+         chain_present_fence ? &m_swapchain_images[submit_info.pending_present.image_index].present_fence_wait :
+                               nullptr,
+         chain_present_fence ? 1u : 0,
+      };
+      /* Submit the payload on the layer's present queue rather than the queue
+       * handed to vkQueuePresentKHR. The submission only waits and signals
+       * semaphores, so any queue can carry it, and keeping it off the
+       * application's queue avoids serializing behind in-flight render command
+       * buffers. */
+      TRY_LOG_CALL(set_present_payload(m_swapchain_images[submit_info.pending_present.image_index], m_queue, semaphores,
+                                       submission_pnext,
+                                       fold_present_fence ? submit_info.present_fence : VK_NULL_HANDLE));
+
+      if (chain_present_fence)
+      {
+         const queue_submit_semaphores wait_semaphores = {
+            &m_swapchain_images[submit_info.pending_present.image_index].present_fence_wait, 1, nullptr, 0
+         };
+         /*
+          * Here we chain wait_semaphores with present_fence through present_fence_wait.
+          */
+         TRY(sync_queue_submit(m_device_data, m_queue, submit_info.present_fence, wait_semaphores));
+      }
    }
 
-   if (!m_page_flip_thread_run)
+   if (m_present_trace.is_enabled())
+   {
+      const present_info_extensions extensions = index_present_info_extensions(present_info->pNext);
+      uint32_t extension_mask = 0;
+      extension_mask |= extensions.present_ids != nullptr ? PRESENT_TRACE_EXT_PRESENT_ID : 0;
+      extension_mask |= extensions.present_regions != nullptr ? PRESENT_TRACE_EXT_PRESENT_REGIONS : 0;
+      extension_mask |= extensions.present_fence_info != nullptr ? PRESENT_TRACE_EXT_PRESENT_FENCE : 0;
+      extension_mask |= extensions.present_mode_info != nullptr ? PRESENT_TRACE_EXT_PRESENT_MODE_INFO : 0;
+      extension_mask |= extensions.frame_boundary != nullptr ? PRESENT_TRACE_EXT_FRAME_BOUNDARY : 0;
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+      extension_mask |= extensions.present_timings_info != nullptr ? PRESENT_TRACE_EXT_PRESENT_TIMINGS : 0;
+#endif
+      /* The queue depth is sampled before this present is pushed, so it counts
+       * how far ahead the application already was. */
+      m_present_trace.trace_present(trace_start_ns, submit_info.pending_present.image_index,
+                                    m_present_mode.load(std::memory_order_relaxed),
+                                    static_cast<uint32_t>(m_pending_buffer_pool.size()), extension_mask);
+   }
+
+   TRY(notify_presentation_engine(submit_info.pending_present));
+
+   return VK_SUCCESS;
+}
+
+bool swapchain_base::can_batch_present_payload() const
+{
+   return m_timeline_sync.has_value() && m_page_flip_thread_run;
+}
+
+VkSemaphore swapchain_base::begin_batched_payload(uint32_t image_index, uint64_t *payload_value)
+{
+   assert(m_timeline_sync.has_value());
+   VkSemaphore timeline_semaphore = m_timeline_sync->reserve_payload(payload_value);
+   m_swapchain_images[image_index].present_payload_value = *payload_value;
+   return timeline_semaphore;
+}
+
+void swapchain_base::abandon_batched_payload(uint32_t image_index)
+{
+   assert(m_timeline_sync.has_value());
+   m_timeline_sync->cancel_reserved_payload(&m_swapchain_images[image_index].present_payload_value);
+}
+
+/* Compare application provided allocation callbacks for equality. Images can only move
+ * between swapchains whose resources are allocated and freed through the same callbacks. */
+static bool same_allocation_callbacks(const VkAllocationCallbacks *a, const VkAllocationCallbacks *b)
+{
+   if (a == b)
+   {
+      return true;
+   }
+   if (a == nullptr || b == nullptr)
    {
-      /* If the page flip thread is not running, we need to wait for any present payload here, before setting a new present payload. */
-      constexpr uint64_t WAIT_PRESENT_TIMEOUT = 1000000000; /* 1 second */
-      TRY_LOG_CALL(
-         image_wait_present(m_swapchain_images[submit_info.pending_present.image_index], WAIT_PRESENT_TIMEOUT));
+      return false;
    }
+   return a->pUserData == b->pUserData && a->pfnAllocation == b->pfnAllocation &&
+          a->pfnReallocation == b->pfnReallocation && a->pfnFree == b->pfnFree &&
+          a->pfnInternalAllocation == b->pfnInternalAllocation && a->pfnInternalFree == b->pfnInternalFree;
+}
 
-   void *submission_pnext = nullptr;
-   std::optional<VkFrameBoundaryEXT> frame_boundary;
-   /* Do not handle the event if it was handled before reaching this point */
-   if (submit_info.handle_present_frame_boundary_event)
+/**
+ * @brief Slab backing a swapchain's backend image data blocks.
+ *
+ * A header followed by cache line aligned slots, all from one allocation, so
+ * the per-image blocks the hot paths chase through swapchain_image::data sit
+ * in consecutive cache lines. See the declaration in swapchain_base.hpp for
+ * the reference counting rationale.
+ */
+struct swapchain_base::image_data_slab
+{
+   /** Allocator the slab was created with, kept to free it from any swapchain. */
+   util::allocator alloc;
+   /** One reference for the creating swapchain plus one per live block. */
+   std::atomic<size_t> refs;
+   /** Size of the underlying std::max_align_t allocation, in elements. */
+   size_t alloc_units;
+   /** Bytes per slot. */
+   size_t stride;
+   /** Total and used slot counts; slots are only handed out, never recycled. */
+   size_t capacity;
+   size_t used;
+};
+
+swapchain_base::image_data_slab *swapchain_base::create_image_data_slab(size_t stride)
+{
+   const size_t capacity = m_swapchain_images.size();
+   if (capacity == 0)
    {
-      auto *ext = get_swapchain_extension<wsi::wsi_ext_frame_boundary>();
-      frame_boundary = handle_frame_boundary_event(
-         present_info, &m_swapchain_images[submit_info.pending_present.image_index].image, ext);
+      return nullptr;
+   }
 
-      if (frame_boundary)
-      {
-         submission_pnext = &frame_boundary.value();
-      }
+   const size_t header_size = (sizeof(image_data_slab) + IMAGE_DATA_LINE_SIZE - 1) & ~(IMAGE_DATA_LINE_SIZE - 1);
+   const size_t alloc_units =
+      (header_size + capacity * stride + alignof(std::max_align_t) - 1) / alignof(std::max_align_t);
+   auto *storage = m_allocator.create<std::max_align_t>(alloc_units);
+   if (storage == nullptr)
+   {
+      return nullptr;
    }
 
-   queue_submit_semaphores semaphores = {
-      wait_semaphores,
-      sem_count,
-      (submit_info.present_fence != VK_NULL_HANDLE) ?
-         &m_swapchain_images[submit_info.pending_present.image_index].present_fence_wait :
-         nullptr,
-      (submit_info.present_fence != VK_NULL_HANDLE) ? 1u : 0,
-   };
-   TRY_LOG_CALL(image_set_present_payload(m_swapchain_images[submit_info.pending_present.image_index], queue,
-                                          semaphores, submission_pnext));
+   return new (storage) image_data_slab{ m_allocator, { 1 }, alloc_units, stride, capacity, 0 };
+}
 
-   if (submit_info.present_fence != VK_NULL_HANDLE)
+size_t swapchain_base::image_data_slab_stride(const image_data_slab *slab)
+{
+   return slab->stride;
+}
+
+bool swapchain_base::image_data_slab_has_space(const image_data_slab *slab)
+{
+   return slab->used < slab->capacity;
+}
+
+char *swapchain_base::image_data_slab_allocate(image_data_slab *slab)
+{
+   /* Slot storage starts at the first cache line boundary past the slab header. */
+   const size_t header_size = (sizeof(image_data_slab) + IMAGE_DATA_LINE_SIZE - 1) & ~(IMAGE_DATA_LINE_SIZE - 1);
+   char *slot = reinterpret_cast<char *>(slab) + header_size + slab->used * slab->stride;
+   slab->used++;
+   slab->refs.fetch_add(1, std::memory_order_relaxed);
+   return slot;
+}
+
+void swapchain_base::release_image_data_slab(image_data_slab *slab)
+{
+   if (slab->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
    {
-      const queue_submit_semaphores wait_semaphores = {
-         &m_swapchain_images[submit_info.pending_present.image_index].present_fence_wait, 1, nullptr, 0
-      };
-      /*
-       * Here we chain wait_semaphores with present_fence through present_fence_wait.
-       */
-      TRY(sync_queue_submit(m_device_data, queue, submit_info.present_fence, wait_semaphores));
+      return;
    }
+   util::allocator alloc = slab->alloc;
+   const size_t alloc_units = slab->alloc_units;
+   slab->~image_data_slab();
+   alloc.destroy(alloc_units, reinterpret_cast<std::max_align_t *>(slab));
+}
 
-   TRY(notify_presentation_engine(submit_info.pending_present));
+bool swapchain_base::is_image_compatible(const VkImageCreateInfo &image_create_info) const
+{
+   const VkImageCreateInfo &ours = m_image_create_info;
+   return image_create_info.imageType == ours.imageType && image_create_info.format == ours.format &&
+          image_create_info.extent.width == ours.extent.width &&
+          image_create_info.extent.height == ours.extent.height &&
+          image_create_info.extent.depth == ours.extent.depth && image_create_info.mipLevels == ours.mipLevels &&
+          image_create_info.arrayLayers == ours.arrayLayers && image_create_info.samples == ours.samples &&
+          image_create_info.usage == ours.usage && image_create_info.sharingMode == ours.sharingMode;
+}
 
-   return VK_SUCCESS;
+bool swapchain_base::transfer_compatible_free_image(const VkImageCreateInfo &image_create_info,
+                                                    const util::allocator &allocator, swapchain_image &image)
+{
+   if (!same_allocation_callbacks(m_allocator.get_original_callbacks(), allocator.get_original_callbacks()))
+   {
+      return false;
+   }
+
+   if (!is_image_compatible(image_create_info))
+   {
+      return false;
+   }
+
+   for (auto &img : m_swapchain_images)
+   {
+      /* Claim the image with a CAS straight to INVALID: this swapchain's page
+       * flip thread may still be releasing other images to FREE while the
+       * descendant adopts this one. */
+      auto expected = swapchain_image::FREE;
+      if (!img.status.compare_exchange_strong(expected, swapchain_image::INVALID))
+      {
+         continue;
+      }
+
+      image = img;
+      image.status = swapchain_image::FREE;
+      /* Any payload belongs to this swapchain's timeline, not the new one's. */
+      image.present_payload_value = 0;
+
+      /* Ownership has moved to the new swapchain. The source slot stays INVALID so
+       * that deprecate and teardown skip it. */
+      img.data = nullptr;
+      img.image = VK_NULL_HANDLE;
+      img.present_semaphore = VK_NULL_HANDLE;
+      img.present_fence_wait = VK_NULL_HANDLE;
+
+      /* Take down the free image semaphore count that was posted for this image so
+       * the accounting of the remaining images stays exact. */
+      m_free_image_semaphore.wait(0);
+
+      return true;
+   }
+
+   return false;
 }
 
 void swapchain_base::deprecate(VkSwapchainKHR descendant)
@@ -714,6 +1464,10 @@ void swapchain_base::deprecate(VkSwapchainKHR descendant)
 
    /* Set its descendant. */
    m_descendant = descendant;
+
+   /* A swapchain with nothing left in flight hands over immediately; otherwise
+    * the token is posted from the release path as the queued flips land. */
+   signal_handoff_if_drained();
 }
 
 void swapchain_base::wait_for_pending_buffers()
@@ -721,8 +1475,9 @@ void swapchain_base::wait_for_pending_buffers()
    std::unique_lock<std::mutex> acquire_lock(m_image_acquire_lock);
    int wait;
    int acquired_images = 0;
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
 
+   /* Holding the acquire lock means no image can move to ACQUIRED while the
+    * atomic statuses are counted. */
    for (auto &img : m_swapchain_images)
    {
       if (img.status == swapchain_image::ACQUIRED)
@@ -733,9 +1488,12 @@ void swapchain_base::wait_for_pending_buffers()
 
    /* Waiting for free images waits for both free and pending. One pending image may be presented and acquired by a
     * compositor. The WSI backend may not necessarily know which pending image is presented to change its state. It may
-    * be impossible to wait for that one presented image. */
-   wait = static_cast<int>(m_swapchain_images.size()) - acquired_images - 1;
-   image_status_lock.unlock();
+    * be impossible to wait for that one presented image.
+    *
+    * Images the lazy-growth allocator never built have never posted the free
+    * image semaphore and cannot be pending, so they are left out of the count. */
+   wait = static_cast<int>(m_swapchain_images.size() - m_unallocated_image_count.load(std::memory_order_relaxed)) -
+          acquired_images - 1;
 
    while (wait > 0)
    {
@@ -745,6 +1503,31 @@ void swapchain_base::wait_for_pending_buffers()
    }
 }
 
+void swapchain_base::wait_for_handoff()
+{
+   sem_wait(&m_handoff_semaphore);
+}
+
+void swapchain_base::signal_handoff_if_drained()
+{
+   /* The image still on screen stays PENDING until the descendant's first flip
+    * replaces it, so it cannot be waited for: the drain is complete when it is
+    * the only one left. This mirrors the "- 1" in wait_for_pending_buffers. */
+   uint32_t pending = 0;
+   for (auto &img : m_swapchain_images)
+   {
+      if (img.status == swapchain_image::PENDING)
+      {
+         pending++;
+      }
+   }
+
+   if (pending <= 1)
+   {
+      sem_post(&m_handoff_semaphore);
+   }
+}
+
 void swapchain_base::clear_ancestor()
 {
    m_ancestor = VK_NULL_HANDLE;
@@ -755,11 +1538,176 @@ void swapchain_base::clear_descendant()
    m_descendant = VK_NULL_HANDLE;
 }
 
+VkResult swapchain_base::set_present_payload(swapchain_image &image, VkQueue queue,
+                                             const queue_submit_semaphores &semaphores, const void *submission_pnext,
+                                             VkFence submission_fence)
+{
+   if (m_timeline_sync.has_value())
+   {
+      return m_timeline_sync->set_payload(queue, semaphores, &image.present_payload_value, submission_pnext,
+                                          submission_fence);
+   }
+   /* The backend payload submission uses the fence slot for the image's own fence. */
+   assert(submission_fence == VK_NULL_HANDLE);
+   return image_set_present_payload(image, queue, semaphores, submission_pnext);
+}
+
+VkResult swapchain_base::wait_present_payload(swapchain_image &image, uint64_t timeout)
+{
+   if (m_timeline_sync.has_value())
+   {
+      return m_timeline_sync->wait_for_value(image.present_payload_value, timeout);
+   }
+   return image_wait_present(image, timeout);
+}
+
+void swapchain_base::update_acquire_spin_prediction(uint64_t waited_ns)
+{
+   uint64_t predicted = m_predicted_free_wait_ns.load(std::memory_order_relaxed);
+   if (waited_ns <= m_acquire_spin_limit_ns)
+   {
+      /* Track the observed release latency with some headroom, so ordinary
+       * jitter does not push the next wait over the budget into a sleep. */
+      uint64_t target = std::min(waited_ns + waited_ns / 4, m_acquire_spin_limit_ns);
+      predicted = (3 * predicted + target) / 4;
+   }
+   else
+   {
+      /* The buffer came back far later than we are prepared to spin: back off
+       * quickly so slow frames do not burn a core before every sleep. The
+       * average grows again once releases land within the cap. */
+      predicted /= 2;
+   }
+   m_predicted_free_wait_ns.store(predicted, std::memory_order_relaxed);
+}
+
+void swapchain_base::update_latency_governor()
+{
+   /* Presents between cap reconsiderations; about a second at 60 Hz, so the
+    * averages settle before the next step. */
+   constexpr uint32_t GOVERNOR_ADJUST_WINDOW = 64;
+   /* A sustained backlog of one request or more means frames sit queued behind
+    * the presentation engine - buffering that only adds latency. */
+   constexpr uint32_t GOVERNOR_BACKLOG_THRESHOLD_X16 = 16;
+   /* Never cap below one in-flight image: the application always needs one to
+    * render into while another scans out. */
+   constexpr uint32_t GOVERNOR_MIN_DEPTH = 1;
+
+   const auto now = std::chrono::steady_clock::now();
+   if (m_governor_last_present_time != std::chrono::steady_clock::time_point{})
+   {
+      const uint64_t interval_ns =
+         std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_governor_last_present_time).count();
+      m_governor_interval_ema_ns += (static_cast<int64_t>(interval_ns) - static_cast<int64_t>(m_governor_interval_ema_ns)) / 8;
+   }
+   m_governor_last_present_time = now;
+
+   /* The request being dispatched has already been popped, so the pool size is
+    * the backlog this frame left behind. */
+   const uint32_t backlog_x16 = static_cast<uint32_t>(m_pending_buffer_pool.size()) << 4;
+   m_governor_backlog_ema_x16 += (static_cast<int64_t>(backlog_x16) - m_governor_backlog_ema_x16) / 8;
+
+   if (++m_governor_presents_since_adjust < GOVERNOR_ADJUST_WINDOW)
+   {
+      return;
+   }
+   m_governor_presents_since_adjust = 0;
+
+   const uint32_t image_count =
+      static_cast<uint32_t>(m_swapchain_images.size()) - m_unallocated_image_count.load(std::memory_order_relaxed);
+   const uint32_t cap = m_acquire_depth_cap.load(std::memory_order_relaxed);
+
+   if (cap != 0 && m_governor_baseline_interval_ns != 0 &&
+       m_governor_interval_ema_ns > m_governor_baseline_interval_ns + m_governor_baseline_interval_ns / 4)
+   {
+      /* The present cadence degraded since the cap was applied: the
+       * application is no longer beating vsync and needs its buffering back.
+       * Step the cap up and drop it entirely once it stops constraining. */
+      const uint32_t raised = cap + 1;
+      m_acquire_depth_cap.store(raised + 1 >= image_count ? 0 : raised, std::memory_order_relaxed);
+      m_governor_baseline_interval_ns = m_governor_interval_ema_ns;
+      return;
+   }
+
+   if (m_governor_backlog_ema_x16 >= GOVERNOR_BACKLOG_THRESHOLD_X16)
+   {
+      /* Frames queue faster than they flip: reclaim one image worth of
+       * buffering per window, down to the floor. The backlog average resets
+       * through the same EMA once the cap bites, so consecutive windows only
+       * keep stepping down while the queue genuinely persists. */
+      const uint32_t current = cap == 0 ? image_count : cap;
+      if (current > GOVERNOR_MIN_DEPTH)
+      {
+         m_acquire_depth_cap.store(current - 1, std::memory_order_relaxed);
+         m_governor_baseline_interval_ns = m_governor_interval_ema_ns;
+      }
+   }
+}
+
 VkResult swapchain_base::wait_for_free_buffer(uint64_t timeout)
 {
+   /* Adaptive latency governor gate: before taking the token for this acquire,
+    * demand enough additional free images that at most m_acquire_depth_cap
+    * images stay on the application's side once this one is handed out. The
+    * surplus tokens are only consumed to observe that the headroom exists -
+    * acquires are serialized by m_image_acquire_lock and only the presentation
+    * engine posts, so they can be returned untouched before the normal wait
+    * below takes the real token. */
+   const uint32_t depth_cap = m_acquire_depth_cap.load(std::memory_order_relaxed);
+   const uint32_t built_images =
+      static_cast<uint32_t>(m_swapchain_images.size()) - m_unallocated_image_count.load(std::memory_order_relaxed);
+   if (depth_cap > 0 && depth_cap + 1 < built_images)
+   {
+      const uint32_t headroom = built_images - 1 - depth_cap;
+      uint32_t held = 0;
+      VkResult gate_result = VK_SUCCESS;
+      while (held < headroom && gate_result == VK_SUCCESS)
+      {
+         gate_result = m_free_image_semaphore.wait(timeout);
+         if (gate_result == VK_SUCCESS)
+         {
+            held++;
+         }
+      }
+      if (held > 0)
+      {
+         m_free_image_semaphore.post(held);
+      }
+      if (gate_result != VK_SUCCESS)
+      {
+         return gate_result;
+      }
+   }
+
    VkResult retval;
    /* first see if a buffer is already marked as free */
    retval = m_free_image_semaphore.wait(0);
+   if (retval != VK_NOT_READY)
+   {
+      return retval;
+   }
+
+   /* First demand beyond the eagerly allocated images: grow the swapchain in
+    * the background. The current wait is still served by whichever image comes
+    * back from the presentation engine first; later acquires find the grown
+    * images without waiting. */
+   if (!m_image_growth_spawned && m_unallocated_image_count.load(std::memory_order_relaxed) > 0)
+   {
+      start_image_growth();
+   }
+
+   const bool spin_enabled = m_acquire_spin_limit_ns > 0 && timeout > 0;
+   std::chrono::steady_clock::time_point wait_start;
+   if (spin_enabled)
+   {
+      /* Busy-poll for as long as recent releases have taken to arrive: at high
+       * frame rates unpresent_image usually posts within tens of microseconds
+       * and the futex sleep/wake round trip costs more than the wait itself. */
+      wait_start = std::chrono::steady_clock::now();
+      uint64_t spin_budget = std::min(m_predicted_free_wait_ns.load(std::memory_order_relaxed), timeout);
+      retval = m_free_image_semaphore.spin_wait(spin_budget);
+   }
+
    if (retval == VK_NOT_READY)
    {
       /* if not, we still have work to do even if timeout==0 -
@@ -781,19 +1729,83 @@ VkResult swapchain_base::wait_for_free_buffer(uint64_t timeout)
       }
    }
 
+   if (spin_enabled && retval == VK_SUCCESS)
+   {
+      const auto waited = std::chrono::steady_clock::now() - wait_start;
+      update_acquire_spin_prediction(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count());
+   }
+
    return retval;
 }
 
 void swapchain_base::release_images(uint32_t image_count, const uint32_t *indices)
 {
+   /* On deferred-memory-allocation swapchains a released image may have its backing
+    * freed. Queue it for the page flip thread instead of freeing here, so the
+    * munmap/close/vkFreeMemory work does not stall the application thread. The image
+    * stays acquirable straight away: acquire either reclaims it warm from the queue
+    * or rebuilds it through the regular deferred-allocation path. */
+   const bool scavenge = m_image_deferred_allocation && m_page_flip_thread_run &&
+                         m_present_mode != VK_PRESENT_MODE_SHARED_DEMAND_REFRESH_KHR &&
+                         m_present_mode != VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR;
+
+   uint32_t posts_owed = 0;
    for (uint32_t i = 0; i < image_count; i++)
    {
       uint32_t index = indices[i];
       assert(index < m_swapchain_images.size());
       /* Applications can only pass acquired images that the device doesn't own */
       assert(m_swapchain_images[index].status == swapchain_image::ACQUIRED);
-      unpresent_image(index);
+      if (scavenge)
+      {
+         const std::lock_guard<std::mutex> lock(m_scavenge_queue_mutex);
+         m_swapchain_images[index].status = swapchain_image::UNALLOCATED;
+         bool pushed = m_scavenge_queue.try_push_back(index);
+         assert(pushed); /* capacity reserved at init */
+         UNUSED(pushed);
+         posts_owed++;
+      }
+      else if (mark_image_free(index))
+      {
+         posts_owed++;
+      }
+   }
+
+   /* Post once for the whole batch: each released image frees up one acquire
+    * slot, but a single counter add and wake covers all of them. */
+   if (posts_owed > 0)
+   {
+      m_free_image_semaphore.post(posts_owed);
+   }
+}
+
+void swapchain_base::scavenge_released_images()
+{
+   const std::lock_guard<std::mutex> lock(m_scavenge_queue_mutex);
+
+   for (const uint32_t index : m_scavenge_queue)
+   {
+      auto &image = m_swapchain_images[index];
+      /* Acquire may have reclaimed the image from the queue path below before we got
+       * here; its memory is live again and must not be touched. */
+      if (image.status != swapchain_image::UNALLOCATED)
+      {
+         continue;
+      }
+
+      /* A VkImage cannot be rebound to new memory, so the whole image is torn down
+       * and recreated in the same unallocated state it had before its first acquire:
+       * handle and backend data exist, backing memory does not. */
+      destroy_image(image);
+      if (create_swapchain_image(m_image_create_info, image) != VK_SUCCESS)
+      {
+         /* The image cannot be rebuilt; surface the failure on the next acquire. */
+         set_error_state(VK_ERROR_OUT_OF_HOST_MEMORY);
+         continue;
+      }
+      image.status = swapchain_image::UNALLOCATED;
    }
+   m_scavenge_queue.clear();
 }
 
 VkResult swapchain_base::is_bind_allowed(uint32_t image_index) const
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2025 Arm Limited.
+ * Copyright (c) 2017-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -33,16 +33,24 @@
 #include <pthread.h>
 #include <semaphore.h>
 #include <vulkan/vulkan.h>
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <array>
+#include <cstddef>
+#include <new>
 
 #include <util/custom_allocator.hpp>
+#include <util/file_descriptor.hpp>
 #include <util/helpers.hpp>
 #include <util/ring_buffer.hpp>
 #include <util/timed_semaphore.hpp>
 #include <util/log.hpp>
 #include <layer/private_data.hpp>
 
+#include "frame_capture.hpp"
+#include "frame_latency_tracker.hpp"
+#include "present_trace.hpp"
 #include "surface_properties.hpp"
 #include "synchronization.hpp"
 
@@ -66,17 +74,63 @@ struct swapchain_image
       UNALLOCATED,
    };
 
+   swapchain_image() = default;
+
+   /* std::atomic members are not copyable, but swapchain images live in a
+    * util::vector that copies its elements on resize. Copies transfer the
+    * current status value. */
+   swapchain_image(const swapchain_image &rhs)
+      : data(rhs.data)
+      , image(rhs.image)
+      , status(rhs.status.load())
+      , present_semaphore(rhs.present_semaphore)
+      , present_fence_wait(rhs.present_fence_wait)
+      , present_payload_value(rhs.present_payload_value)
+   {
+   }
+
+   swapchain_image &operator=(const swapchain_image &rhs)
+   {
+      data = rhs.data;
+      image = rhs.image;
+      status.store(rhs.status.load());
+      present_semaphore = rhs.present_semaphore;
+      present_fence_wait = rhs.present_fence_wait;
+      present_payload_value = rhs.present_payload_value;
+      return *this;
+   }
+
    /* Implementation specific data */
    void *data{ nullptr };
 
    VkImage image{ VK_NULL_HANDLE };
-   status status{ swapchain_image::INVALID };
+
+   /**
+    * Status of the image. All transitions are atomic - contended ones such as
+    * claiming a FREE image use compare-and-swap - so acquire, the page flip
+    * thread and the WSI backends' event threads never lock to update it.
+    */
+   std::atomic<enum status> status{ swapchain_image::INVALID };
+
    VkSemaphore present_semaphore{ VK_NULL_HANDLE };
    VkSemaphore present_fence_wait{ VK_NULL_HANDLE };
+
+   /**
+    * Timeline point signalled by the image's present payload when the
+    * swapchain uses timeline semaphore synchronization. 0 when no payload
+    * has been set for the image yet.
+    */
+   uint64_t present_payload_value{ 0 };
 };
 
 struct pending_present_request
 {
+   /**
+    * Maximum number of VK_KHR_incremental_present damage rectangles carried per
+    * request. Presents with more rectangles fall back to full-surface damage.
+    */
+   static constexpr uint32_t MAX_DAMAGE_RECTANGLES = 16;
+
    /* The index of the pending image to use for present. */
    uint32_t image_index;
 
@@ -85,8 +139,69 @@ struct pending_present_request
     * If 0, no present ID has been assigned to this request.
     */
    uint64_t present_id;
+
+   /**
+    * Number of valid entries in damage_rects. 0 means the damage is unknown
+    * and backends must assume the whole image changed.
+    */
+   uint32_t damage_rect_count;
+
+   /**
+    * Damage rectangles supplied by the application with VkPresentRegionsKHR,
+    * in image coordinates. Copied out of the present info pNext chain as the
+    * request may outlive the vkQueuePresentKHR call on the page flip thread.
+    */
+   std::array<VkRectLayerKHR, MAX_DAMAGE_RECTANGLES> damage_rects;
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   /**
+    * Absolute target present time in CLOCK_MONOTONIC nanoseconds, supplied by
+    * the application with VkPresentTimingInfoEXT. 0 means no target was
+    * requested and the image is presented as soon as possible.
+    */
+   uint64_t target_present_time{ 0 };
+#endif
 };
 
+/**
+ * @brief Typed index of the extension structs chained to a VkPresentInfoKHR.
+ *
+ * Built by index_present_info_extensions() with a single walk of the pNext
+ * chain, so every per-frame consumer reads its typed pointer from here
+ * instead of re-walking the chain: inspection costs one pass per present
+ * rather than one pass per extension.
+ */
+struct present_info_extensions
+{
+   /* VK_KHR_present_id */
+   const VkPresentIdKHR *present_ids{ nullptr };
+
+   /* VK_KHR_incremental_present */
+   const VkPresentRegionsKHR *present_regions{ nullptr };
+
+   /* VK_EXT_swapchain_maintenance1 */
+   const VkSwapchainPresentFenceInfoEXT *present_fence_info{ nullptr };
+   const VkSwapchainPresentModeInfoEXT *present_mode_info{ nullptr };
+
+   /* VK_EXT_frame_boundary */
+   const VkFrameBoundaryEXT *frame_boundary{ nullptr };
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   /* VK_EXT_present_timing */
+   const VkPresentTimingsInfoEXT *present_timings_info{ nullptr };
+#endif
+};
+
+/**
+ * @brief Scan a present-info pNext chain once into a typed index.
+ *
+ * @param pNext The pNext chain of a VkPresentInfoKHR.
+ *
+ * @return Index with a pointer per recognized extension struct, nullptr for
+ *         the ones not present in the chain.
+ */
+present_info_extensions index_present_info_extensions(const void *pNext);
+
 struct swapchain_presentation_parameters
 {
    /* Fence supplied by the application with VkSwapchainPresentFenceInfoEXT. */
@@ -115,6 +230,20 @@ struct swapchain_presentation_parameters
     */
    VkBool32 handle_present_frame_boundary_event{ true };
 
+   /**
+    * Application-provided VkFrameBoundaryEXT from the present pNext chain, or
+    * nullptr. Indexed once by the present entrypoint so the payload
+    * submission does not walk the chain again.
+    */
+   const VkFrameBoundaryEXT *app_frame_boundary{ nullptr };
+
+   /**
+    * Flag that indicates the present payload was already submitted as part of
+    * a batched multi-swapchain submission (see begin_batched_payload), so
+    * queue_present must not submit one of its own.
+    */
+   VkBool32 payload_already_set{ false };
+
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
    /**
     * The present timing info.
@@ -138,7 +267,12 @@ public:
 
    virtual ~swapchain_base()
    {
-      /* nop */
+      if (m_image_data_slab != nullptr)
+      {
+         /* Drop the owning reference. Blocks adopted by a descendant swapchain
+          * keep their own references, so the slab outlives us if needed. */
+         release_image_data_slab(m_image_data_slab);
+      }
    }
 
    /**
@@ -196,6 +330,19 @@ public:
    VkResult queue_present(VkQueue queue, const VkPresentInfoKHR *present_info,
                           const swapchain_presentation_parameters &presentation_parameters);
 
+   /**
+    * @brief Present a batch of queued entries from the pending buffer pool.
+    *
+    * Called by the presentation thread pool worker the swapchain is assigned
+    * to, with the number of presents accumulated on the swapchain's eventfd
+    * since the last wake-up. The worker is the single consumer of the ring
+    * buffer, mirroring the dedicated page flip thread. For mailbox swapchains
+    * stale entries within the batch are skipped and recycled.
+    *
+    * @param count The number of entries to consume from the pending buffer pool.
+    */
+   void process_pending_presents(uint64_t count);
+
    /**
     * @brief Get the allocator
     *
@@ -206,6 +353,19 @@ public:
       return m_allocator;
    }
 
+   /**
+    * @brief Copy up to @p count completed frame latency records, oldest first.
+    *
+    * Only returns data when latency tracking is enabled via VULKAN_WSI_LATENCY_DUMP; see
+    * @ref frame_latency_tracker.
+    *
+    * @return The number of records copied.
+    */
+   size_t get_frame_latency_records(frame_latency_record *records, size_t count)
+   {
+      return m_latency_tracker.get_records(records, count);
+   }
+
    /**
     * @brief Creates a VkImage handle.
     *
@@ -222,6 +382,22 @@ public:
     */
    VkResult create_aliased_image_handle(VkImage *image);
 
+   /**
+    * @brief Take back a never-bound aliased image handle for reuse.
+    *
+    * Called through the device's alias tracking when the application destroys
+    * an aliased handle it never bound. All aliases are created from the same
+    * m_image_create_info, so a cached handle can satisfy the next
+    * create_aliased_image_handle() call without paying vkCreateImage and the
+    * driver's memory-requirement queries again.
+    *
+    * @param image The handle being destroyed.
+    *
+    * @return true when the handle was cached and must not be destroyed, false
+    *         when the cache is full and the caller should destroy it.
+    */
+   bool recycle_aliased_image_handle(VkImage image);
+
    /**
     * @brief Bind image to a swapchain
     *
@@ -251,6 +427,51 @@ public:
       return m_swapchain_images[image_index].present_semaphore;
    }
 
+   /**
+    * @brief Get a swapchain image's Vulkan handle
+    *
+    * @param image_index Image's index
+    *
+    * @return the image's VkImage handle
+    */
+   VkImage get_image_handle(uint32_t image_index)
+   {
+      return m_swapchain_images[image_index].image;
+   }
+
+   /**
+    * @brief Whether the present payload can be folded into a batched submission.
+    *
+    * True when a single timeline point represents the payload and the page
+    * flip thread performs the payload wait. Without the thread, queue_present
+    * waits for the image's previous payload before setting a new one, which
+    * the batched path has no opportunity to do.
+    */
+   bool can_batch_present_payload() const;
+
+   /**
+    * @brief Reserve this swapchain's present payload for a batched submission.
+    *
+    * The caller must signal the returned timeline semaphore with the returned
+    * value in its own queue submission and then present with
+    * swapchain_presentation_parameters::payload_already_set, or call
+    * abandon_batched_payload if the submission fails. Only valid when
+    * can_batch_present_payload() returns true.
+    *
+    * @param      image_index   The index of the image being presented.
+    * @param[out] payload_value The timeline point the caller must signal.
+    *
+    * @return The timeline semaphore to signal.
+    */
+   VkSemaphore begin_batched_payload(uint32_t image_index, uint64_t *payload_value);
+
+   /**
+    * @brief Roll back a batched payload reservation that was never submitted.
+    *
+    * @param image_index The image index passed to begin_batched_payload.
+    */
+   void abandon_batched_payload(uint32_t image_index);
+
    /**
     * @brief Get the swapchain status.
     *
@@ -258,6 +479,101 @@ public:
     */
    VkResult get_swapchain_status();
 
+   /**
+    * @brief Wait until the swapchain's present ID reaches @p present_id.
+    *
+    * Sleeps on the present ID extension's dedicated futex waiter, so the
+    * caller only wakes when the target ID can be satisfied rather than on
+    * every frame.
+    *
+    * @param present_id The present ID to wait for.
+    * @param timeout    Time to wait (ns). 0 doesn't block, UINT64_MAX waits indefinitely.
+    *
+    * @return VK_SUCCESS when the ID is reached, VK_TIMEOUT on expiry, or the
+    *         swapchain's error state if it has entered one.
+    */
+   VkResult wait_for_present(uint64_t present_id, uint64_t timeout);
+
+   /**
+    * @brief Query the persistent CPU mapping of a swapchain image.
+    *
+    * Backends that allocate host-visible, persistently mapped images override
+    * this so applications can read back presented frames without a GPU copy.
+    * The base implementation reports that no mapping is available.
+    *
+    * @param[in]  image_index The index of the swapchain image to query.
+    * @param[out] mapped_ptr  The persistent CPU mapping of the image memory.
+    * @param[out] layout      The image's subresource layout, including the row
+    *                         stride. May be nullptr if not needed.
+    *
+    * @return VK_SUCCESS on success, VK_ERROR_FEATURE_NOT_PRESENT when the
+    *         backend does not map its images.
+    */
+   virtual VkResult get_host_image_mapping(uint32_t image_index, void **mapped_ptr, VkSubresourceLayout *layout)
+   {
+      UNUSED(image_index);
+      UNUSED(mapped_ptr);
+      UNUSED(layout);
+      return VK_ERROR_FEATURE_NOT_PRESENT;
+   }
+
+   /**
+    * @brief Query a surface counter (vkGetSwapchainCounterEXT).
+    *
+    * Backends that can read a counter out of the presentation hardware
+    * override this. The base implementation reports that no counters are
+    * available.
+    *
+    * @param[in]  counter       The counter to query; exactly one bit must be set.
+    * @param[out] counter_value The counter's current value.
+    *
+    * @return VK_SUCCESS on success, VK_ERROR_FEATURE_NOT_PRESENT when the
+    *         backend does not serve the requested counter.
+    */
+   virtual VkResult get_swapchain_counter(VkSurfaceCounterFlagBitsEXT counter, uint64_t *counter_value)
+   {
+      UNUSED(counter);
+      UNUSED(counter_value);
+      return VK_ERROR_FEATURE_NOT_PRESENT;
+   }
+
+   /**
+    * @brief Register a zero-copy frame capture consumer (vkRegisterSwapchainFrameCaptureWSI).
+    *
+    * The consumer receives every presented frame as duplicated dmabuf fds plus
+    * a sync_fd release fence; only the dmabuf-based backends can serve it.
+    * See @ref frame_capture for the delivery and backpressure semantics.
+    *
+    * @param callback           Invoked with each presented frame.
+    * @param user_data          Opaque pointer passed back to the callback.
+    * @param max_pending_frames Frames the consumer may hold before new ones
+    *                           are skipped; 0 selects the default of 1.
+    *
+    * @return VK_SUCCESS on success, VK_ERROR_INITIALIZATION_FAILED when a
+    *         consumer is already registered.
+    */
+   VkResult register_frame_capture(PFN_vkFrameCaptureCallbackWSI callback, void *user_data,
+                                   uint32_t max_pending_frames)
+   {
+      return m_frame_capture.register_consumer(callback, user_data, max_pending_frames);
+   }
+
+   /**
+    * @brief Unregister the frame capture consumer (vkUnregisterSwapchainFrameCaptureWSI).
+    */
+   VkResult unregister_frame_capture()
+   {
+      return m_frame_capture.unregister_consumer();
+   }
+
+   /**
+    * @brief Mark one captured frame as processed (vkCompleteCapturedFrameWSI).
+    */
+   void complete_captured_frame()
+   {
+      m_frame_capture.complete_frame();
+   }
+
    /**
     * @brief Release all images not belonging to the device
     * by making them available to be acquired again
@@ -317,6 +633,15 @@ protected:
     */
    bool m_page_flip_thread_run;
 
+   /**
+    * @brief True while the dedicated page flip thread is decided on but not yet spawned.
+    *
+    * Swapchains that are created and replaced without ever presenting should
+    * not pay for a thread and its idle wake-up loop, so the spawn is deferred
+    * until the swapchain is first used. Cleared by start_page_flip_thread().
+    */
+   bool m_page_flip_thread_deferred;
+
    /**
     * @brief A semaphore to be signalled once a page flip event occurs.
     */
@@ -328,14 +653,25 @@ protected:
    sem_t m_start_present_semaphore;
 
    /**
-    * @brief A mutex to protect access to the statuses of the swapchain's images and
-    * any code paths that rely on this information. We use a recursive mutex as some
-    * functions such as 'destroy_image' both change an image's status and are called
-    * conditionally based on an image's status in some cases. A recursive mutex allows
-    * these functions to be called both with and without the mutex already locked in the
-    * same thread.
+    * @brief Handoff token posted once this swapchain is deprecated and its queued flips have landed.
+    *
+    * A descendant's first present waits on this token instead of polling the
+    * free image semaphore, so the drain resolves on the page flip machinery
+    * the moment the ancestor's last queued frame reaches the screen.
     */
-   std::recursive_mutex m_image_status_mutex;
+   sem_t m_handoff_semaphore;
+
+   /**
+    * @brief A mutex protecting m_scavenge_queue and the rebuild of released images.
+    *
+    * Only taken on deferred-memory-allocation swapchains, where the page flip
+    * thread tears down and rebuilds images released with
+    * vkReleaseSwapchainImagesEXT while acquire may reclaim them. All other
+    * status bookkeeping uses compare-and-swap transitions on the atomic
+    * per-image status, so acquire and the page flip thread never block each
+    * other on it.
+    */
+   std::mutex m_scavenge_queue_mutex;
 
    /**
     * @brief Defines if the pthread_t and sem_t members of the class are defined.
@@ -352,12 +688,56 @@ protected:
 
    /**
     * @brief In order to present the images in a FIFO order we implement
-    * a ring buffer to hold the images queued for presentation. Since the
-    * two pointers (head and tail) are used by different
-    * threads and we do not allow the application to acquire more images
-    * than we have we eliminate race conditions.
+    * a ring buffer to hold the images queued for presentation. The
+    * application thread pushes entries and the page flip thread pops them.
+    * A lock-free single-producer/single-consumer ring buffer is used so the
+    * page flip thread consumes presents without taking any lock. As we do
+    * not allow the application to acquire
+    * more images than we have, the buffer can never overflow.
+    */
+   util::spsc_ring_buffer<pending_present_request, wsi::surface_properties::MAX_SWAPCHAIN_IMAGE_COUNT>
+      m_pending_buffer_pool;
+
+   /**
+    * @brief The present doorbell eventfd when the swapchain is served by the
+    * device's shared presentation thread pool, -1 when a dedicated page flip
+    * thread is used. The pool owns the descriptor; it stays valid until
+    * teardown() unregisters the swapchain.
+    */
+   int m_present_event_fd{ -1 };
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   /**
+    * @brief CLOCK_MONOTONIC timerfd used by the page flip thread to hold back
+    * commits with a target present time. Created lazily on the first timed
+    * present and only used on swapchains with a dedicated page flip thread.
+    */
+   util::fd_owner m_present_timer_fd;
+#endif
+
+   /**
+    * @brief Frame latency instrumentation, enabled via VULKAN_WSI_LATENCY_DUMP.
+    *
+    * Records where each presented frame spent time inside the layer; a no-op unless the
+    * environment variable is set.
     */
-   util::ring_buffer<pending_present_request, wsi::surface_properties::MAX_SWAPCHAIN_IMAGE_COUNT> m_pending_buffer_pool;
+   frame_latency_tracker m_latency_tracker;
+
+   /**
+    * @brief Acquire/present trace capture, enabled via VULKAN_WSI_PRESENT_TRACE.
+    *
+    * Streams the timing and parameters of every acquire and present call to a
+    * binary trace for offline replay; a no-op unless the knob is set.
+    */
+   present_trace m_present_trace;
+
+   /**
+    * @brief Zero-copy frame capture, driven by vkRegisterSwapchainFrameCaptureWSI.
+    *
+    * Hands each presented frame to a registered consumer as dmabuf fds plus a
+    * sync_fd release fence; a no-op while no consumer is registered.
+    */
+   frame_capture m_frame_capture;
 
    /**
     * @brief User provided memory allocation callbacks.
@@ -369,15 +749,80 @@ protected:
     */
    util::vector<swapchain_image> m_swapchain_images;
 
+   /**
+    * @brief Whether the swapchain was created with VK_SWAPCHAIN_CREATE_DEFERRED_MEMORY_ALLOCATION_BIT_EXT.
+    */
+   bool m_image_deferred_allocation{ false };
+
+   /**
+    * @brief Number of images whose backend resources the lazy-growth allocator has not built yet.
+    *
+    * Always zero unless lazy image growth (VULKAN_WSI_LAZY_IMAGE_COUNT) is
+    * enabled. These images have never contributed a post to
+    * m_free_image_semaphore, so accounting that assumes one post per image -
+    * wait_for_pending_buffers - subtracts this count. Only ever decremented
+    * once an image has been built.
+    */
+   std::atomic<uint32_t> m_unallocated_image_count{ 0 };
+
+   /**
+    * @brief Background thread growing the swapchain to its full image count.
+    *
+    * Started by wait_for_free_buffer the first time the application demands
+    * more images than were allocated eagerly; joined in teardown.
+    */
+   std::thread m_image_growth_thread;
+
+   /**
+    * @brief Whether the growth thread has been started.
+    *
+    * Only accessed under m_image_acquire_lock, which both callers of
+    * wait_for_free_buffer hold.
+    */
+   bool m_image_growth_spawned{ false };
+
+   /**
+    * @brief Images released with vkReleaseSwapchainImagesEXT whose backend resources
+    * still need to be freed.
+    *
+    * Only used on deferred-memory-allocation swapchains. The page flip thread drains
+    * the queue when it next wakes, so the munmap/close/vkFreeMemory work stays off the
+    * application thread. An image that is re-acquired before the scavenge runs is
+    * simply taken out of the queue again with its still-warm buffer intact. Guarded by
+    * m_scavenge_queue_mutex; capacity is reserved at init so pushes cannot fail.
+    */
+   util::vector<uint32_t> m_scavenge_queue;
+
+   /**
+    * @brief Never-bound aliased image handles available for reuse.
+    *
+    * All entries were created from m_image_create_info, which is fixed for the
+    * swapchain's lifetime, so any of them can satisfy the next
+    * create_aliased_image_handle() call. Capped at the swapchain's image count
+    * and destroyed in teardown(). Guarded by m_aliased_image_cache_lock.
+    */
+   util::vector<VkImage> m_aliased_image_cache;
+
+   /**
+    * @brief Guards m_aliased_image_cache.
+    */
+   std::mutex m_aliased_image_cache_lock;
+
    /**
     * @brief Handle to the surface object this swapchain will present images to.
     */
    VkSurfaceKHR m_surface;
 
    /**
-    * @brief Present mode currently being used for this swapchain
+    * @brief Present mode currently being used for this swapchain.
+    *
+    * Atomic because VkSwapchainPresentModeInfoEXT lets the application switch
+    * between compatible modes per present: queue_present stores the new mode
+    * on the application thread while the page flip thread reads it to decide
+    * the queueing behaviour. Only modes the backend reports as compatible can
+    * be switched to, so the threading setup chosen at init never changes.
     */
-   VkPresentModeKHR m_present_mode;
+   std::atomic<VkPresentModeKHR> m_present_mode;
 
    /**
     * @brief Possible presentation modes this swapchain is allowed to present with VkSwapchainPresentModesCreateInfoEXT
@@ -428,6 +873,24 @@ protected:
     */
    void wait_for_pending_buffers();
 
+   /**
+    * @brief Block until this swapchain's handoff token has been posted.
+    *
+    * Called by the descendant's page flip machinery ahead of its first
+    * present. Returns once at most one of this swapchain's images is still
+    * pending - the image on screen, which the descendant's own flip replaces.
+    */
+   void wait_for_handoff();
+
+   /**
+    * @brief Post the handoff token if the swapchain is deprecated and drained.
+    *
+    * Called on deprecation and again each time an image is released
+    * afterwards. Extra posts are harmless: the token is waited on at most
+    * once, by the descendant's first present.
+    */
+   void signal_handoff_if_drained();
+
    /**
     * @brief Remove cached ancestor.
     */
@@ -479,6 +942,25 @@ protected:
       return VK_SUCCESS;
    }
 
+   /**
+    * @brief Transfer a compatible FREE image to a new swapchain.
+    *
+    * Called on a swapchain that is about to be deprecated by a descendant created
+    * with it as oldSwapchain. If this swapchain has a FREE image matching the
+    * descendant's image parameters, ownership of the image - its VkImage handle,
+    * backend specific resources and present semaphores - is moved into @p image
+    * and the source slot is marked INVALID so that teardown and deprecate skip it.
+    * This avoids re-allocating presentable images on reconfigure.
+    *
+    * @param      image_create_info Image parameters of the new swapchain's images.
+    * @param      allocator         The allocator of the new swapchain.
+    * @param[out] image             Receives the transferred image on success.
+    *
+    * @return true if an image was transferred, false otherwise.
+    */
+   bool transfer_compatible_free_image(const VkImageCreateInfo &image_create_info, const util::allocator &allocator,
+                                       swapchain_image &image);
+
    /**
     * @brief Base swapchain teardown.
     *
@@ -522,6 +1004,30 @@ protected:
     */
    virtual void present_image(const pending_present_request &pending_present) = 0;
 
+   /**
+    * @brief Fill @p frame with the dmabuf handles backing a swapchain image.
+    *
+    * Backends whose images are dmabufs override this for frame capture. The
+    * implementation duplicates the image's per-plane buffer fds into the frame
+    * and shares the image's present fence as the release fence, leaving the
+    * frame's fds owned by the caller. Called on the presentation thread, after
+    * the image's present payload has been submitted and before present_image.
+    * The base implementation reports that the backend cannot export frames.
+    *
+    * @param[in]     image_index The index of the presented swapchain image.
+    * @param[in,out] frame       The frame to fill; the presentation metadata
+    *                            is already set by the caller.
+    *
+    * @return true when the frame was filled, false when the backend cannot
+    *         export the image (the frame is then skipped).
+    */
+   virtual bool fill_captured_frame(uint32_t image_index, VkCapturedFrameWSI &frame)
+   {
+      UNUSED(image_index);
+      UNUSED(frame);
+      return false;
+   }
+
    /**
     * @brief Transition a presented image to free.
     *
@@ -531,6 +1037,18 @@ protected:
     */
    void unpresent_image(uint32_t presented_index);
 
+   /**
+    * @brief Transition a presented image to free without posting the free image semaphore.
+    *
+    * Same as unpresent_image() but leaves posting m_free_image_semaphore to the
+    * caller, so a batch of releases can be covered by a single post.
+    *
+    * @param presented_index Index of the image to be marked as free.
+    *
+    * @return true if the caller owes a post on m_free_image_semaphore.
+    */
+   bool mark_image_free(uint32_t presented_index);
+
    /**
     * @brief Method to release a swapchain image
     *
@@ -587,6 +1105,190 @@ protected:
     */
    virtual VkResult image_wait_present(swapchain_image &image, uint64_t timeout) = 0;
 
+   /**
+    * @brief Whether the swapchain can use the generic timeline semaphore synchronization.
+    *
+    * Backends that only use their present payloads for CPU-side waiting can return true
+    * to let the base swapchain manage present synchronization with a single timeline
+    * semaphore per swapchain, avoiding per-present fence resets. Backends that export
+    * their payload to the windowing system (e.g. as a sync FD) must keep the default.
+    */
+   virtual bool can_use_timeline_sync() const
+   {
+      return false;
+   }
+
+   /**
+    * @brief Whether the presentation engine waits for present payloads itself.
+    *
+    * Backends that hand the present payload over to the windowing system (e.g. as
+    * an IN_FENCE_FD on a DRM atomic commit) can return true to skip the CPU-side
+    * payload wait on the page flip thread, overlapping payload completion with
+    * present processing. Backends that need the payload to have completed before
+    * presenting must keep the default.
+    */
+   virtual bool presentation_engine_waits_for_payload() const
+   {
+      return false;
+   }
+
+   /**
+    * @brief Route the presentation consumer through loops monomorphized for the backend.
+    *
+    * Replaces the generic consumer loops - which reach present_image,
+    * image_wait_present and presentation_engine_waits_for_payload through the
+    * vtable on every frame - with instantiations that statically bind to
+    * @p SwapchainT, so the per-frame path is devirtualized and inlined per
+    * backend. Called from the backend's constructor; @p SwapchainT must be the
+    * concrete (final) swapchain class. Without this call the consumer runs the
+    * generic instantiation, which dispatches exactly as before.
+    */
+   template <typename SwapchainT>
+   void select_present_loop()
+   {
+      m_process_pending_presents_fn = &swapchain_base::process_pending_presents_entry<SwapchainT>;
+      m_page_flip_thread_fn = &swapchain_base::page_flip_thread_entry<SwapchainT>;
+   }
+
+   /**
+    * @brief Whether images can be transferred from a deprecated ancestor swapchain.
+    *
+    * Backends whose per-image resources are self contained can return true to let
+    * init adopt compatible FREE images from the swapchain passed as oldSwapchain
+    * instead of allocating new ones. Backends whose images are wired to
+    * per-swapchain windowing state (e.g. Wayland buffer listeners on a private
+    * event queue) must keep the default until they re-register that state on
+    * transfer.
+    */
+   virtual bool can_transfer_images() const
+   {
+      return false;
+   }
+
+   /**
+    * @brief Inherit backend specific image creation parameters from an ancestor swapchain.
+    *
+    * Called by init after an image was adopted from the swapchain passed as oldSwapchain,
+    * alongside the base class copying the ancestor's image create info. Backends whose
+    * image creation depends on state derived during their own create_swapchain_image
+    * (e.g. a negotiated format and modifier layout) must copy that state here so images
+    * created from scratch next to adopted ones stay interchangeable with them.
+    *
+    * @param ancestor The swapchain images are being adopted from, of the same backend type.
+    *
+    * @return VK_SUCCESS on success or an error code otherwise.
+    */
+   virtual VkResult inherit_image_creation_parameters(const swapchain_base &ancestor)
+   {
+      UNUSED(ancestor);
+      return VK_SUCCESS;
+   }
+
+   /**
+    * @brief Whether allocate_and_bind_swapchain_image may run for several images concurrently.
+    *
+    * Backends whose per-image allocation only touches per-image state, or guards
+    * the shared parts with their own locks, can return true to let init build
+    * the image resources across a small thread pool, bringing swapchain
+    * creation latency close to the cost of the single slowest image. Backends
+    * with unguarded shared allocation state must keep the default.
+    */
+   virtual bool can_allocate_images_concurrently() const
+   {
+      return false;
+   }
+
+   /**
+    * @brief Allocate and construct a backend image data block.
+    *
+    * The blocks of all of a swapchain's images are carved out of a single
+    * cache line strided slab instead of one heap allocation each, so code
+    * that walks the images and dereferences their data pointers - present
+    * processing, payload waits, teardown - lands in consecutive cache lines
+    * rather than scattered across the heap. Falls back to an individual
+    * allocation when the slab cannot be created or runs out of slots; slots
+    * are not recycled, so repeated release_images() rebuilds eventually take
+    * the fallback path.
+    *
+    * @return The constructed block or nullptr on failure.
+    */
+   template <typename T, typename... Args>
+   T *create_image_data(Args &&...args)
+   {
+      static_assert(alignof(T) <= alignof(std::max_align_t), "image data blocks assume fundamental alignment");
+      const size_t stride = image_data_stride(sizeof(T));
+
+      if (m_image_data_slab == nullptr)
+      {
+         m_image_data_slab = create_image_data_slab(stride);
+      }
+
+      char *slot = nullptr;
+      image_data_slab *slab = m_image_data_slab;
+      if (slab != nullptr && image_data_slab_stride(slab) == stride && image_data_slab_has_space(slab))
+      {
+         slot = image_data_slab_allocate(slab);
+      }
+      else
+      {
+         slab = nullptr;
+         slot = reinterpret_cast<char *>(m_allocator.create<std::max_align_t>(stride / alignof(std::max_align_t)));
+         if (slot == nullptr)
+         {
+            return nullptr;
+         }
+      }
+      reinterpret_cast<image_data_block *>(slot)->slab = slab;
+
+      T *data;
+      try
+      {
+         data = new (slot + IMAGE_DATA_HEADER_SIZE) T(std::forward<Args>(args)...);
+      }
+      catch (...)
+      {
+         if (slab != nullptr)
+         {
+            release_image_data_slab(slab);
+         }
+         else
+         {
+            m_allocator.destroy(stride / alignof(std::max_align_t), reinterpret_cast<std::max_align_t *>(slot));
+         }
+         return nullptr;
+      }
+      return data;
+   }
+
+   /**
+    * @brief Destroy a block created by create_image_data.
+    *
+    * Safe to call on blocks adopted from a deprecated ancestor swapchain: each
+    * block references the slab it was carved from and the slab stays alive
+    * until its last block is destroyed, however the owning swapchains' blocks
+    * and lifetimes are interleaved.
+    */
+   template <typename T>
+   void destroy_image_data(T *data)
+   {
+      if (data == nullptr)
+      {
+         return;
+      }
+      char *slot = reinterpret_cast<char *>(data) - IMAGE_DATA_HEADER_SIZE;
+      image_data_slab *slab = reinterpret_cast<image_data_block *>(slot)->slab;
+      data->~T();
+      if (slab != nullptr)
+      {
+         release_image_data_slab(slab);
+      }
+      else
+      {
+         const size_t stride = image_data_stride(sizeof(T));
+         m_allocator.destroy(stride / alignof(std::max_align_t), reinterpret_cast<std::max_align_t *>(slot));
+      }
+   }
+
    /**
     * @brief Returns true if an error has occurred.
     */
@@ -629,6 +1331,73 @@ private:
     */
    VkResult wait_for_free_buffer(uint64_t timeout);
 
+   /**
+    * @brief Feed an observed free-buffer wait into the acquire spin predictor.
+    *
+    * @param waited_ns Time wait_for_free_buffer spent blocked until unpresent_image
+    *                  posted the free image semaphore.
+    */
+   void update_acquire_spin_prediction(uint64_t waited_ns);
+
+   /**
+    * @brief Free the backend resources of images queued by release_images().
+    *
+    * Runs on the page flip thread. Each scavenged image is returned to the
+    * UNALLOCATED state it had before its first acquire, so a later acquire
+    * rebuilds it through the regular deferred-allocation path.
+    */
+   void scavenge_released_images();
+
+   /**
+    * @brief Check whether this swapchain's images match the given image parameters.
+    *
+    * Fields that the WSI backend derives from the surface (tiling, flags, pNext)
+    * are ignored, as they are identical for swapchains created for the same surface.
+    *
+    * @param image_create_info Image parameters to compare against.
+    *
+    * @return true if images with these parameters are interchangeable with ours.
+    */
+   bool is_image_compatible(const VkImageCreateInfo &image_create_info) const;
+
+   /**
+    * @brief Sets the present payload for an image using the selected synchronization backend.
+    *
+    * Dispatches to the swapchain's timeline semaphore when one was created at init
+    * time, otherwise to the WSI backend's image_set_present_payload implementation.
+    *
+    * @param[in] image            The swapchain image for which to set a present payload.
+    * @param     queue            A Vulkan queue that can be used for any Vulkan commands needed.
+    * @param[in] semaphores       The wait and signal semaphores and their number of elements.
+    * @param[in] submission_pnext Chain of pointers to attach to the payload submission.
+    * @param     submission_fence Optional fence to signal from the payload submission. Only supported
+    *                             on the timeline path, whose submission has a free fence slot; must be
+    *                             VK_NULL_HANDLE when the swapchain has no timeline semaphore.
+    *
+    * @return VK_SUCCESS on success or an error code otherwise.
+    */
+   VkResult set_present_payload(swapchain_image &image, VkQueue queue, const queue_submit_semaphores &semaphores,
+                                const void *submission_pnext = nullptr, VkFence submission_fence = VK_NULL_HANDLE);
+
+   /**
+    * @brief Waits for an image's present payload using the selected synchronization backend.
+    *
+    * @param[in] image   The swapchain image to wait for.
+    * @param     timeout Timeout for any wait in nanoseconds.
+    *
+    * @return VK_SUCCESS if waiting was successful or unnecessary. An error code otherwise.
+    */
+   VkResult wait_present_payload(swapchain_image &image, uint64_t timeout);
+
+   /**
+    * @brief Timeline semaphore synchronization selected at init time.
+    *
+    * Only set when the WSI backend allows it and the device supports
+    * VK_KHR_timeline_semaphore. When unset, the backend's per-image present
+    * payload implementation is used instead.
+    */
+   std::optional<timeline_sync> m_timeline_sync;
+
    /**
     * @brief A semaphore to be signalled once a free image becomes available.
     *
@@ -639,6 +1408,72 @@ private:
     */
    util::timed_semaphore m_free_image_semaphore;
 
+   /**
+    * @brief Cap on the acquire busy-poll, in nanoseconds.
+    *
+    * Parsed once from VULKAN_WSI_ACQUIRE_SPIN_US at construction. 0 (the
+    * default) disables the busy-poll so acquire parks on
+    * m_free_image_semaphore immediately, as before.
+    */
+   uint64_t m_acquire_spin_limit_ns{ 0 };
+
+   /**
+    * @brief Dynamic cap on the images the application may hold, 0 when uncapped.
+    *
+    * Written by the adaptive latency governor on the presentation consumer and
+    * read by acquire_next_image, which blocks handing out a free image until
+    * the application's acquired-or-queued image count is below the cap. Always
+    * 0 unless VULKAN_WSI_LATENCY_GOVERNOR is set.
+    */
+   std::atomic<uint32_t> m_acquire_depth_cap{ 0 };
+
+   /** Whether the adaptive latency governor is enabled for this swapchain. */
+   bool m_governor_enabled{ false };
+
+   /*
+    * Governor state, only touched on the presentation consumer (the page flip
+    * thread, a pool worker, or the application thread for synchronous
+    * presents), so no locking is needed.
+    */
+
+   /** Fixed-point (x16) moving average of the present backlog left after each dispatch. */
+   uint32_t m_governor_backlog_ema_x16{ 0 };
+
+   /** Moving average of the interval between processed presents, in nanoseconds. */
+   uint64_t m_governor_interval_ema_ns{ 0 };
+
+   /** Present interval observed when the current cap was applied; 0 while uncapped. */
+   uint64_t m_governor_baseline_interval_ns{ 0 };
+
+   /** Timestamp of the previously processed present. */
+   std::chrono::steady_clock::time_point m_governor_last_present_time{};
+
+   /** Presents processed since the cap was last reconsidered. */
+   uint32_t m_governor_presents_since_adjust{ 0 };
+
+   /**
+    * @brief Feed one processed present into the adaptive latency governor.
+    *
+    * Called from call_present. Maintains moving averages of the backlog left
+    * in m_pending_buffer_pool and of the present cadence, and periodically
+    * re-derives m_acquire_depth_cap from them: a persistent backlog means the
+    * application runs ahead of the presentation engine and its frames queue -
+    * pure latency - so the cap removes the unused buffering; a capped
+    * swapchain whose present cadence then degrades gets the buffering back.
+    */
+   void update_latency_governor();
+
+   /**
+    * @brief Predicted wait for the next buffer release, in nanoseconds.
+    *
+    * Exponential moving average of the time wait_for_free_buffer spent blocked
+    * until unpresent_image posted the free image semaphore. Bounds the
+    * busy-poll so acquire only spins as long as presents have recently taken
+    * to complete. Halved whenever a wait overruns the cap, so slow frames stop
+    * the spinning quickly.
+    */
+   std::atomic<uint64_t> m_predicted_free_wait_ns{ 0 };
+
    /**
     * @brief Per swapchain thread function that handles page flipping.
     *
@@ -665,28 +1500,159 @@ private:
     **/
    void page_flip_thread();
 
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   /**
+    * @brief Block the page flip thread until a target present time is due.
+    *
+    * Arms m_present_timer_fd to expire a scheduling margin before
+    * @p target_time_ns and waits on it, periodically re-checking
+    * m_page_flip_thread_run so swapchain teardown is not held up by a
+    * far-future target.
+    *
+    * @param target_time_ns Absolute CLOCK_MONOTONIC target in nanoseconds.
+    *
+    * @return true when the target time is due (or the timer could not be
+    *         created, in which case the image is presented immediately),
+    *         false when the thread is shutting down.
+    */
+   bool wait_until_target_present_time(uint64_t target_time_ns);
+#endif
+
    /**
     * @brief Call the swapchain implementation specific present_image function.
     *
     * In addition to calling the present_image function it also handles the
-    * communication with the ancestor before the first presentation.
+    * communication with the ancestor before the first presentation. Defined in
+    * swapchain_present_loop.hpp; see @ref select_present_loop for the
+    * monomorphization scheme.
     *
     * @param pending_present_request Submission information for the present request.
     */
+   template <typename SwapchainT>
+   void call_present_loop(const pending_present_request &pending_present);
+
+   /**
+    * @brief Generic call_present_loop entry for the non-threaded present path.
+    *
+    * queue_present falls back to presenting synchronously when no consumer
+    * thread is running; that path is not per-frame critical, so it keeps the
+    * generic (virtually dispatching) instantiation.
+    */
    void call_present(const pending_present_request &pending_present);
 
+   /**
+    * @brief Monomorphized body of process_pending_presents; defined in
+    * swapchain_present_loop.hpp.
+    */
+   template <typename SwapchainT>
+   void process_pending_presents_loop(uint64_t count);
+
+   /**
+    * @brief Monomorphized body of page_flip_thread; defined in
+    * swapchain_present_loop.hpp.
+    */
+   template <typename SwapchainT>
+   void page_flip_thread_loop();
+
+   /**
+    * @brief Monomorphized wait_present_payload; defined in swapchain_present_loop.hpp.
+    */
+   template <typename SwapchainT>
+   VkResult wait_present_payload_loop(swapchain_image &image, uint64_t timeout);
+
+   /* Plain-function entry points for the loop instantiations, so the selected
+    * loop can be stored in a data member. A backend's constructor instantiates
+    * its entries by calling select_present_loop from a translation unit that
+    * includes swapchain_present_loop.hpp. */
+   template <typename SwapchainT>
+   static void process_pending_presents_entry(swapchain_base &base, uint64_t count)
+   {
+      base.process_pending_presents_loop<SwapchainT>(count);
+   }
+
+   template <typename SwapchainT>
+   static void page_flip_thread_entry(swapchain_base &base)
+   {
+      base.page_flip_thread_loop<SwapchainT>();
+   }
+
+   /**
+    * @brief The presentation consumer loops in use, generic until a backend
+    * selects its monomorphized instantiations.
+    */
+   void (*m_process_pending_presents_fn)(swapchain_base &, uint64_t){
+      &swapchain_base::process_pending_presents_entry<swapchain_base>
+   };
+   void (*m_page_flip_thread_fn)(swapchain_base &){ &swapchain_base::page_flip_thread_entry<swapchain_base> };
+
+   /**
+    * @brief Build and deliver a presented frame to the capture consumer.
+    *
+    * Claims a delivery slot first, so a saturated consumer skips the frame
+    * before any fds are duplicated, then fills the frame through
+    * fill_captured_frame and hands it over. Runs on the presentation thread,
+    * before present_image: sharing the release fence must happen before the
+    * backend consumes the fence export for its own commit.
+    *
+    * @param pending_present Submission information for the present request.
+    */
+   void deliver_captured_frame(const pending_present_request &pending_present);
+
    /**
     * @brief Return true if the descendant has started presenting.
     */
    bool has_descendant_started_presenting();
 
    /**
-    * @brief Initialize the page flipping thread.
+    * @brief Initialize the presentation consumer for the swapchain.
+    *
+    * Registers the swapchain with the device's shared presentation thread pool
+    * when eligible, otherwise spawns a dedicated page flipping thread. Either
+    * way queue_present hands presents over through m_pending_buffer_pool.
     *
     * @return VK_SUCCESS if the initialization was successful or an error code otherwise.
     */
    VkResult init_page_flip_thread();
 
+   /**
+    * @brief Spawn the deferred dedicated page flip thread.
+    *
+    * No-op unless init_page_flip_thread() decided on a dedicated thread. The
+    * first acquire calls this to pre-warm the thread - acquires run frames
+    * before the first present needs a consumer - keeping the spawn off the
+    * present critical path; a present that arrives without a prior acquire
+    * spawns it synchronously instead.
+    *
+    * @return VK_SUCCESS if the thread is running or an error code otherwise.
+    */
+   VkResult start_page_flip_thread();
+
+   /**
+    * @brief Start building the lazily deferred images in the background.
+    *
+    * Called with m_image_acquire_lock held the first time acquisition finds no
+    * free image while unbuilt images remain. Falls back to building the images
+    * on the calling thread if the growth thread cannot be created.
+    */
+   void start_image_growth();
+
+   /**
+    * @brief Growth thread entry point: allocate and publish the remaining images.
+    *
+    * Each image is built with the regular backend allocation path, moved to
+    * FREE and posted on m_free_image_semaphore. A failed allocation stops the
+    * growth; the swapchain keeps operating with the images built so far.
+    */
+   void image_growth_thread();
+
+   /**
+    * @brief Wake the presentation consumer for a newly queued present.
+    *
+    * Increments the pool eventfd when the swapchain uses the shared
+    * presentation thread pool, posts the page flip semaphore otherwise.
+    */
+   void signal_pending_present();
+
    /**
     * @brief Notify the presentation engine with the next image to be presented.
     *
@@ -700,6 +1666,67 @@ private:
     */
    VkResult notify_presentation_engine(const pending_present_request &submit_info);
 
+   /**
+    * @brief Shared slab backing the backend image data blocks, defined in the
+    * translation unit.
+    *
+    * Reference counted rather than owned outright: init may adopt whole images
+    * - including their data pointers - from the swapchain passed as
+    * oldSwapchain, so a block can outlive the swapchain whose slab it was
+    * carved from. The slab holds one reference for its creating swapchain and
+    * one per live block, and is freed with the allocator it captured at
+    * creation once both are gone.
+    */
+   struct image_data_slab;
+
+   /**
+    * @brief Header preceding every backend image data block.
+    *
+    * Links the block back to its slab so destroy_image_data can release the
+    * right reference; nullptr for individually allocated fallback blocks,
+    * which are freed with the destroying swapchain's allocator as before.
+    */
+   struct image_data_block
+   {
+      image_data_slab *slab;
+   };
+
+   /** Distance from a block's header to its payload. */
+   static constexpr size_t IMAGE_DATA_HEADER_SIZE = alignof(std::max_align_t);
+
+   /** Slab slots are padded out to whole cache lines so blocks never share one. */
+   static constexpr size_t IMAGE_DATA_LINE_SIZE = 64;
+
+   /** Size of a slab slot holding a header and a payload of @p payload_size bytes. */
+   static size_t image_data_stride(size_t payload_size)
+   {
+      return (IMAGE_DATA_HEADER_SIZE + payload_size + IMAGE_DATA_LINE_SIZE - 1) & ~(IMAGE_DATA_LINE_SIZE - 1);
+   }
+
+   /**
+    * @brief Create the slab for this swapchain's image data blocks.
+    *
+    * Sized for m_swapchain_images.size() slots of @p stride bytes, so it must
+    * not be called before init has sized the image array. Returns nullptr on
+    * allocation failure, in which case blocks are allocated individually.
+    */
+   image_data_slab *create_image_data_slab(size_t stride);
+
+   /** Slot size the slab was created with. */
+   static size_t image_data_slab_stride(const image_data_slab *slab);
+
+   /** Whether the slab still has an unused slot. */
+   static bool image_data_slab_has_space(const image_data_slab *slab);
+
+   /** Take the next unused slot and a block reference on the slab. */
+   static char *image_data_slab_allocate(image_data_slab *slab);
+
+   /** Drop one slab reference, freeing the slab when the last one goes. */
+   static void release_image_data_slab(image_data_slab *slab);
+
+   /** This swapchain's image data slab; nullptr until the first block or on failure. */
+   image_data_slab *m_image_data_slab{ nullptr };
+
    /**
     * @brief A flag to track if swapchain has started presenting.
     */
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Per-backend monomorphized presentation consumer loops.
+ *
+ * The bodies of the page flip consumer, templated on the concrete swapchain
+ * class so the per-frame calls to present_image, image_wait_present and
+ * presentation_engine_waits_for_payload bind statically and inline. Each
+ * backend includes this header in its own translation unit and instantiates
+ * its loops by calling swapchain_base::select_present_loop from its
+ * constructor; the backend classes are final, which is what lets the compiler
+ * drop the vtable dispatch. Cold paths reached from the loops (error handling,
+ * scavenging, frame capture delivery) keep their virtual calls.
+ *
+ * swapchain_base.cpp instantiates the generic <swapchain_base> loops, which
+ * dispatch through the vtable exactly as the pre-template code did; they serve
+ * as the default until (and unless) a backend selects its own.
+ */
+
+#pragma once
+
+#include "swapchain_base.hpp"
+
+#include "util/allocation_tracker.hpp"
+#include "util/thread_scheduling.hpp"
+#include "util/usdt.hpp"
+
+namespace wsi
+{
+
+template <typename SwapchainT>
+VkResult swapchain_base::wait_present_payload_loop(swapchain_image &image, uint64_t timeout)
+{
+   if (m_timeline_sync.has_value())
+   {
+      return m_timeline_sync->wait_for_value(image.present_payload_value, timeout);
+   }
+   return static_cast<SwapchainT &>(*this).image_wait_present(image, timeout);
+}
+
+template <typename SwapchainT>
+void swapchain_base::call_present_loop(const pending_present_request &pending_present)
+{
+   SwapchainT &self = static_cast<SwapchainT &>(*this);
+   WSI_USDT3(present_dispatch, this, pending_present.image_index, pending_present.present_id);
+
+   if (m_governor_enabled)
+   {
+      update_latency_governor();
+   }
+
+   if (m_frame_capture.is_armed())
+   {
+      deliver_captured_frame(pending_present);
+   }
+
+   /* First present of the swapchain. If it has an ancestor, wait until all the
+    * pending buffers from the ancestor have been presented. */
+   if (m_first_present)
+   {
+      if (m_ancestor != VK_NULL_HANDLE)
+      {
+         /* Queue behind the ancestor's handoff token rather than polling its
+          * free image semaphore: the token is posted by the ancestor's page
+          * flip machinery the moment its last queued frame reaches the screen,
+          * and this wait sits on the presentation consumer, so the application
+          * thread is never stalled by the drain. */
+         auto *ancestor = reinterpret_cast<swapchain_base *>(m_ancestor);
+         ancestor->wait_for_handoff();
+      }
+
+      sem_post(&m_start_present_semaphore);
+
+      self.present_image(pending_present);
+
+      m_first_present = false;
+   }
+   /* The swapchain has already started presenting. */
+   else
+   {
+      self.present_image(pending_present);
+   }
+}
+
+template <typename SwapchainT>
+void swapchain_base::process_pending_presents_loop(uint64_t count)
+{
+   SwapchainT &self = static_cast<SwapchainT &>(*this);
+   /* Steady-state presentation must not touch the heap; report violations when
+    * allocation tracking is enabled. */
+   util::hot_path_scope allocation_scope;
+
+   auto &sc_images = m_swapchain_images;
+   VkResult vk_res = VK_SUCCESS;
+   uint64_t timeout = UINT64_MAX;
+
+   while (count > 0)
+   {
+      /* We want to present the oldest queued for present image from our present queue,
+       * which we can find at the front of the pending buffer pool. The pool is a
+       * lock-free SPSC ring buffer, so no lock is needed to consume from it here. */
+      auto pending_submission = m_pending_buffer_pool.pop_front();
+      assert(pending_submission.has_value());
+      pending_present_request submit_info = *pending_submission;
+      count--;
+
+      /* Real mailbox semantics: when the application has queued newer presents, skip
+       * ahead to the newest one and immediately recycle the stale images so they can
+       * be reacquired. An image is only dropped once its present payload completed,
+       * as it may be reused by the application right after it is marked FREE. Only
+       * entries covered by this batch are consumed, keeping the producer's signal
+       * count and the ring buffer in sync. */
+      if (m_present_mode == VK_PRESENT_MODE_MAILBOX_KHR)
+      {
+         while (count > 0 && wait_present_payload_loop<SwapchainT>(sc_images[submit_info.image_index], 0) == VK_SUCCESS)
+         {
+            auto newer_submission = m_pending_buffer_pool.pop_front();
+            assert(newer_submission.has_value());
+            count--;
+            unpresent_image(submit_info.image_index);
+            submit_info = *newer_submission;
+         }
+      }
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+      /* Hold the commit back until just before the requested present time. Only
+       * swapchains with a dedicated page flip thread carry targets (see
+       * init_page_flip_thread), so blocking here stalls nobody else. */
+      if (submit_info.target_present_time != 0 && wait_until_target_present_time(submit_info.target_present_time))
+      {
+         /* While we slept the application may have queued newer frames whose
+          * targets have also come due, making this frame late. Per mailbox
+          * semantics it is dropped and replaced with the newest due frame; a
+          * frame is only dropped once its payload completed and the
+          * replacement's turn has actually arrived. */
+         if (m_present_mode == VK_PRESENT_MODE_MAILBOX_KHR)
+         {
+            while (count > 0)
+            {
+               auto *newer_request = m_pending_buffer_pool.front();
+               if (newer_request == nullptr ||
+                   (newer_request->target_present_time != 0 &&
+                    !target_present_time_is_due(newer_request->target_present_time)) ||
+                   wait_present_payload_loop<SwapchainT>(sc_images[submit_info.image_index], 0) != VK_SUCCESS)
+               {
+                  break;
+               }
+
+               auto newer_submission = m_pending_buffer_pool.pop_front();
+               assert(newer_submission.has_value());
+               count--;
+               unpresent_image(submit_info.image_index);
+               submit_info = *newer_submission;
+            }
+         }
+      }
+#endif
+
+      m_latency_tracker.mark_flip_dequeue(submit_info.image_index);
+
+      /* We may need to wait for the payload of the present sync of the oldest pending image to be
+       * finished. When the presentation engine waits for the payload itself the wait is skipped
+       * here, letting the backend overlap payload completion with present processing. */
+      if (!self.presentation_engine_waits_for_payload())
+      {
+         while ((vk_res = wait_present_payload_loop<SwapchainT>(sc_images[submit_info.image_index], timeout)) == VK_TIMEOUT)
+         {
+            WSI_LOG_WARNING("Timeout waiting for image's present fences, retrying..");
+         }
+         if (vk_res != VK_SUCCESS)
+         {
+            set_error_state(vk_res);
+            m_free_image_semaphore.post();
+            continue;
+         }
+         m_latency_tracker.mark_payload_done(submit_info.image_index);
+      }
+
+      call_present_loop<SwapchainT>(submit_info);
+      m_latency_tracker.mark_presented(submit_info.image_index);
+   }
+}
+
+template <typename SwapchainT>
+void swapchain_base::page_flip_thread_loop()
+{
+   SwapchainT &self = static_cast<SwapchainT &>(*this);
+   util::apply_presentation_thread_scheduling("page flip");
+   util::hot_path_scope allocation_scope;
+
+   auto &sc_images = m_swapchain_images;
+   VkResult vk_res = VK_SUCCESS;
+   uint64_t timeout = UINT64_MAX;
+   constexpr uint64_t SEMAPHORE_TIMEOUT = 250000000; /* 250 ms. */
+
+   /* No mutex is needed for the accesses to m_page_flip_thread_run variable as after the variable is
+    * initialized it is only ever changed to false. The while loop will make the thread read the
+    * value repeatedly, and the combination of semaphores and thread joins will force any changes to
+    * the variable to be visible to this thread.
+    */
+   while (m_page_flip_thread_run)
+   {
+      /* Free the backing of any images released with vkReleaseSwapchainImagesEXT
+       * since the last wake-up. The gate is immutable after init, so swapchains
+       * without deferred allocation never take the status lock here. */
+      if (m_image_deferred_allocation)
+      {
+         scavenge_released_images();
+      }
+
+      if (m_present_mode == VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR)
+      {
+         /* In continuous mode the application will only make one presentation request,
+          * therefore the page flip semaphore will only be signalled once. */
+         if (!m_first_present)
+         {
+            vk_res = VK_SUCCESS;
+         }
+         else if ((vk_res = m_page_flip_semaphore.wait(SEMAPHORE_TIMEOUT)) == VK_TIMEOUT)
+         {
+            /* Image is not ready yet. */
+            continue;
+         }
+         assert(vk_res == VK_SUCCESS);
+
+         /* Check for shutdown after waking from semaphore wait. */
+         if (!m_page_flip_thread_run)
+            break;
+
+         /* For continuous mode there will be only one image in the swapchain.
+          * This image will always be used, and there is no pending state in this case. */
+         pending_present_request submit_info{};
+         submit_info.image_index = 0;
+
+         m_latency_tracker.mark_flip_dequeue(submit_info.image_index);
+
+         if (!self.presentation_engine_waits_for_payload())
+         {
+            while ((vk_res = wait_present_payload_loop<SwapchainT>(sc_images[submit_info.image_index], timeout)) == VK_TIMEOUT)
+            {
+               WSI_LOG_WARNING("Timeout waiting for image's present fences, retrying..");
+            }
+            if (vk_res != VK_SUCCESS)
+            {
+               set_error_state(vk_res);
+               m_free_image_semaphore.post();
+               continue;
+            }
+            m_latency_tracker.mark_payload_done(submit_info.image_index);
+         }
+
+         call_present_loop<SwapchainT>(submit_info);
+         m_latency_tracker.mark_presented(submit_info.image_index);
+      }
+      else
+      {
+         /* Waiting for the page_flip_semaphore which will be signalled once there is an
+          * image to display.*/
+         if ((vk_res = m_page_flip_semaphore.wait(SEMAPHORE_TIMEOUT)) == VK_TIMEOUT)
+         {
+            /* Image is not ready yet. */
+            continue;
+         }
+
+         /* Check for shutdown after waking from semaphore wait. */
+         if (!m_page_flip_thread_run)
+            break;
+
+         /* Drain any further posts so the whole backlog is handled as one batch,
+          * keeping the semaphore count and the ring buffer in sync. */
+         uint64_t count = 1;
+         while (m_page_flip_semaphore.wait(0) == VK_SUCCESS)
+         {
+            count++;
+         }
+
+         process_pending_presents_loop<SwapchainT>(count);
+      }
+   }
+}
+
+} /* namespace wsi */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2024 Arm Limited.
+ * Copyright (c) 2021-2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -33,26 +33,35 @@
 #include "util/helpers.hpp"
 
 #include <algorithm>
+#include <array>
+#include <unistd.h>
 
 namespace wsi
 {
 
-fence_sync::fence_sync(layer::device_private_data &device, VkFence vk_fence)
+fence_sync::fence_sync(layer::device_private_data &device, VkFence vk_fence, bool exportable_fence)
    : fence{ vk_fence }
    , has_payload{ false }
+   , exportable{ exportable_fence }
    , dev{ &device }
 {
 }
 
 std::optional<fence_sync> fence_sync::create(layer::device_private_data &device)
 {
-   VkFence fence{ VK_NULL_HANDLE };
-   VkFenceCreateInfo fence_info{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, 0 };
-   VkResult res =
-      device.disp.CreateFence(device.device, &fence_info, device.get_allocator().get_original_callbacks(), &fence);
-   if (res != VK_SUCCESS)
+   /* Recycle a fence from a previous swapchain generation when one is
+    * available. set_payload resets the fence before every submission, so its
+    * current signal state does not matter. */
+   VkFence fence = device.acquire_pooled_fence(false);
+   if (fence == VK_NULL_HANDLE)
    {
-      return std::nullopt;
+      VkFenceCreateInfo fence_info{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, 0 };
+      VkResult res =
+         device.disp.CreateFence(device.device, &fence_info, device.get_allocator().get_original_callbacks(), &fence);
+      if (res != VK_SUCCESS)
+      {
+         return std::nullopt;
+      }
    }
    return fence_sync(device, fence);
 }
@@ -67,6 +76,7 @@ fence_sync &fence_sync::operator=(fence_sync &&rhs)
    std::swap(fence, rhs.fence);
    std::swap(has_payload, rhs.has_payload);
    std::swap(payload_finished, rhs.payload_finished);
+   std::swap(exportable, rhs.exportable);
    std::swap(dev, rhs.dev);
    return *this;
 }
@@ -76,7 +86,12 @@ fence_sync::~fence_sync()
    if (fence != VK_NULL_HANDLE)
    {
       wait_payload(UINT64_MAX);
-      dev->disp.DestroyFence(dev->device, fence, dev->get_allocator().get_original_callbacks());
+      /* Hand the fence back to the device's pool for the next swapchain
+       * generation; only destroy it when the pool is full. */
+      if (!dev->release_pooled_fence(fence, exportable))
+      {
+         dev->disp.DestroyFence(dev->device, fence, dev->get_allocator().get_original_callbacks());
+      }
    }
 }
 
@@ -121,7 +136,7 @@ bool fence_sync::swap_payload(bool new_payload)
 }
 
 sync_fd_fence_sync::sync_fd_fence_sync(layer::device_private_data &device, VkFence vk_fence)
-   : fence_sync{ device, vk_fence }
+   : fence_sync{ device, vk_fence, true }
 {
 }
 
@@ -138,22 +153,34 @@ bool sync_fd_fence_sync::is_supported(layer::instance_private_data &instance, Vk
 
 std::optional<sync_fd_fence_sync> sync_fd_fence_sync::create(layer::device_private_data &device)
 {
-   VkExportFenceCreateInfo export_fence_create_info = {};
-   export_fence_create_info.sType = VK_STRUCTURE_TYPE_EXPORT_FENCE_CREATE_INFO;
-   export_fence_create_info.handleTypes = VK_EXTERNAL_FENCE_HANDLE_TYPE_SYNC_FD_BIT;
-   VkFenceCreateInfo fence_info = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, &export_fence_create_info, 0 };
-   VkFence fence = VK_NULL_HANDLE;
-   VkResult res =
-      device.disp.CreateFence(device.device, &fence_info, device.get_allocator().get_original_callbacks(), &fence);
-   if (res != VK_SUCCESS)
+   /* Exportable fences live in their own pool: exportability is baked in at
+    * fence creation, so the two kinds cannot be mixed. */
+   VkFence fence = device.acquire_pooled_fence(true);
+   if (fence == VK_NULL_HANDLE)
    {
-      return std::nullopt;
+      VkExportFenceCreateInfo export_fence_create_info = {};
+      export_fence_create_info.sType = VK_STRUCTURE_TYPE_EXPORT_FENCE_CREATE_INFO;
+      export_fence_create_info.handleTypes = VK_EXTERNAL_FENCE_HANDLE_TYPE_SYNC_FD_BIT;
+      VkFenceCreateInfo fence_info = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, &export_fence_create_info, 0 };
+      VkResult res =
+         device.disp.CreateFence(device.device, &fence_info, device.get_allocator().get_original_callbacks(), &fence);
+      if (res != VK_SUCCESS)
+      {
+         return std::nullopt;
+      }
    }
    return sync_fd_fence_sync{ device, fence };
 }
 
 std::optional<util::fd_owner> sync_fd_fence_sync::export_sync_fd()
 {
+   if (m_shared_export.is_valid())
+   {
+      /* The payload was already exported through share_sync_fd(); hand over
+       * the retained fd instead of exporting the now-reset fence again. */
+      return std::move(m_shared_export);
+   }
+
    int exported_fd = -1;
    VkFenceGetFdInfoKHR fence_fd_info = {};
    fence_fd_info.sType = VK_STRUCTURE_TYPE_FENCE_GET_FD_INFO_KHR;
@@ -169,6 +196,168 @@ std::optional<util::fd_owner> sync_fd_fence_sync::export_sync_fd()
    return std::nullopt;
 }
 
+std::optional<util::fd_owner> sync_fd_fence_sync::share_sync_fd()
+{
+   if (!m_shared_export.is_valid())
+   {
+      auto exported_fd = export_sync_fd();
+      if (!exported_fd.has_value() || !exported_fd->is_valid())
+      {
+         return std::nullopt;
+      }
+      m_shared_export = std::move(exported_fd.value());
+   }
+
+   int duplicated_fd = dup(m_shared_export.get());
+   if (duplicated_fd < 0)
+   {
+      return std::nullopt;
+   }
+   return util::fd_owner(duplicated_fd);
+}
+
+VkResult sync_fd_fence_sync::set_payload(VkQueue queue, const queue_submit_semaphores &semaphores,
+                                         const void *submission_pnext)
+{
+   /* A retained export the presentation path never consumed belongs to the
+    * previous payload; drop it before the fence is reused. */
+   m_shared_export = util::fd_owner{};
+   return fence_sync::set_payload(queue, semaphores, submission_pnext);
+}
+
+timeline_sync::timeline_sync(layer::device_private_data &device, VkSemaphore vk_semaphore)
+   : semaphore{ vk_semaphore }
+   , dev{ &device }
+{
+}
+
+bool timeline_sync::is_supported(layer::device_private_data &device)
+{
+   /* The entrypoints only resolve when the device was created with timeline
+    * semaphore support. We additionally require the extension to be enabled as
+    * we cannot tell whether the timelineSemaphore feature was enabled on
+    * Vulkan 1.2+ devices that did not enable the extension explicitly. */
+   if (!device.is_device_extension_enabled(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+   {
+      return false;
+   }
+
+   auto wait_semaphores = device.disp.get_fn<PFN_vkWaitSemaphoresKHR>("vkWaitSemaphoresKHR");
+   return wait_semaphores.has_value() && *wait_semaphores != nullptr;
+}
+
+std::optional<timeline_sync> timeline_sync::create(layer::device_private_data &device)
+{
+   VkSemaphoreTypeCreateInfoKHR type_info = {};
+   type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+   type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+   type_info.initialValue = 0;
+   VkSemaphoreCreateInfo semaphore_info = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, &type_info, 0 };
+   VkSemaphore semaphore = VK_NULL_HANDLE;
+   VkResult res = device.disp.CreateSemaphore(device.device, &semaphore_info,
+                                              device.get_allocator().get_original_callbacks(), &semaphore);
+   if (res != VK_SUCCESS)
+   {
+      return std::nullopt;
+   }
+   return timeline_sync(device, semaphore);
+}
+
+timeline_sync::timeline_sync(timeline_sync &&rhs)
+{
+   *this = std::move(rhs);
+}
+
+timeline_sync &timeline_sync::operator=(timeline_sync &&rhs)
+{
+   std::swap(semaphore, rhs.semaphore);
+   std::swap(timeline_value, rhs.timeline_value);
+   std::swap(dev, rhs.dev);
+   return *this;
+}
+
+timeline_sync::~timeline_sync()
+{
+   if (semaphore != VK_NULL_HANDLE)
+   {
+      wait_all_pending(UINT64_MAX);
+      dev->disp.DestroySemaphore(dev->device, semaphore, dev->get_allocator().get_original_callbacks());
+   }
+}
+
+VkResult timeline_sync::set_payload(VkQueue queue, const queue_submit_semaphores &semaphores, uint64_t *payload_value,
+                                    const void *submission_pnext, VkFence submission_fence)
+{
+   assert(payload_value != nullptr);
+   /* Current callers signal at most one binary semaphore alongside the timeline. */
+   assert(semaphores.signal_semaphores_count <= 1);
+
+   const uint64_t signal_value = timeline_value + 1;
+
+   std::array<VkSemaphore, 2> signal_semaphores = { semaphore, VK_NULL_HANDLE };
+   /* Values for binary semaphores are ignored, but the value count must match
+    * the signal semaphore count of the submission. */
+   std::array<uint64_t, 2> signal_values = { signal_value, 0 };
+   uint32_t signal_count = 1;
+   for (uint32_t i = 0; i < semaphores.signal_semaphores_count && signal_count < signal_semaphores.size(); ++i)
+   {
+      signal_semaphores[signal_count++] = semaphores.signal_semaphores[i];
+   }
+
+   VkTimelineSemaphoreSubmitInfoKHR timeline_info = {};
+   timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+   timeline_info.pNext = submission_pnext;
+   timeline_info.signalSemaphoreValueCount = signal_count;
+   timeline_info.pSignalSemaphoreValues = signal_values.data();
+
+   const queue_submit_semaphores submit_semaphores = { semaphores.wait_semaphores, semaphores.wait_semaphores_count,
+                                                       signal_semaphores.data(), signal_count };
+   TRY(sync_queue_submit(*dev, queue, submission_fence, submit_semaphores, &timeline_info));
+
+   timeline_value = signal_value;
+   *payload_value = signal_value;
+   return VK_SUCCESS;
+}
+
+VkSemaphore timeline_sync::reserve_payload(uint64_t *payload_value)
+{
+   assert(payload_value != nullptr);
+   timeline_value++;
+   *payload_value = timeline_value;
+   return semaphore;
+}
+
+void timeline_sync::cancel_reserved_payload(uint64_t *payload_value)
+{
+   assert(payload_value != nullptr);
+   assert(*payload_value == timeline_value);
+   timeline_value--;
+   /* Fall back to the last point that will actually signal, so waits on this
+    * payload do not hang on the abandoned reservation. */
+   *payload_value = timeline_value;
+}
+
+VkResult timeline_sync::wait_for_value(uint64_t value, uint64_t timeout)
+{
+   if (value == 0)
+   {
+      /* No payload has been set for this point. */
+      return VK_SUCCESS;
+   }
+
+   VkSemaphoreWaitInfoKHR wait_info = {};
+   wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+   wait_info.semaphoreCount = 1;
+   wait_info.pSemaphores = &semaphore;
+   wait_info.pValues = &value;
+   return dev->disp.WaitSemaphoresKHR(dev->device, &wait_info, timeout);
+}
+
+VkResult timeline_sync::wait_all_pending(uint64_t timeout)
+{
+   return wait_for_value(timeline_value, timeout);
+}
+
 VkResult sync_queue_submit(const layer::device_private_data &device, VkQueue queue, VkFence fence,
                            const queue_submit_semaphores &semaphores, const void *submission_pnext)
 {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2024 Arm Limited.
+ * Copyright (c) 2021-2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -62,6 +62,9 @@ public:
    /**
     * Creates a new fence synchronization object.
     *
+    * Reuses a fence from the device's pool when one is available, only
+    * creating a new Vulkan fence otherwise.
+    *
     * @param device The device private data for which to create it.
     *
     * @return Empty optional on failure or initialized fence.
@@ -100,17 +103,20 @@ public:
     *
     * @return VK_SUCCESS on success or other error code on failing to set the payload.
     */
-   VkResult set_payload(VkQueue queue, const queue_submit_semaphores &semaphores,
-                        const void *submission_pnext = nullptr);
+   virtual VkResult set_payload(VkQueue queue, const queue_submit_semaphores &semaphores,
+                                const void *submission_pnext = nullptr);
 
 protected:
    /**
     * Non-public constructor to initialize the object with valid data.
     *
-    * @param device   The device private data for the fence.
-    * @param vk_fence The created Vulkan fence.
+    * @param device           The device private data for the fence.
+    * @param vk_fence         The created Vulkan fence.
+    * @param exportable_fence Whether the fence was created exportable to a
+    *                         native handle. Determines which of the device's
+    *                         fence pools the fence is recycled through.
     */
-   fence_sync(layer::device_private_data &device, VkFence vk_fence);
+   fence_sync(layer::device_private_data &device, VkFence vk_fence, bool exportable_fence = false);
 
    VkFence get_fence()
    {
@@ -135,6 +141,10 @@ private:
    VkFence fence{ VK_NULL_HANDLE };
    bool has_payload{ false };
    bool payload_finished{ false };
+
+   /** Whether the fence was created exportable to a native handle. */
+   bool exportable{ false };
+
    layer::device_private_data *dev{ nullptr };
 };
 
@@ -174,6 +184,29 @@ public:
     */
    std::optional<util::fd_owner> export_sync_fd();
 
+   /**
+    * Exports the fence to a Sync FD without consuming the export.
+    *
+    * Sync FD export resets the fence, so a payload can only be exported once -
+    * but the resulting sync file can be dup()ed freely. This performs the
+    * export on first use, retains the fd for a later export_sync_fd() call and
+    * returns a duplicate, letting a second reader of the same payload (frame
+    * capture) share the fence with the presentation path.
+    *
+    * @note This method is not threadsafe.
+    *
+    * @return A dup of the exported Sync FD, owned by the caller, or empty
+    *         optional on failure.
+    */
+   std::optional<util::fd_owner> share_sync_fd();
+
+   /**
+    * Sets the payload, dropping a retained export the presentation path never
+    * consumed so it cannot be mistaken for the new payload's fence.
+    */
+   VkResult set_payload(VkQueue queue, const queue_submit_semaphores &semaphores,
+                        const void *submission_pnext = nullptr) override;
+
 private:
    /**
     * Non-public constructor to initialize the object with valid data.
@@ -182,6 +215,130 @@ private:
     * @param vk_fence The created exportable Vulkan fence.
     */
    sync_fd_fence_sync(layer::device_private_data &device, VkFence vk_fence);
+
+   /** Sync FD retained by share_sync_fd() for the presentation path's export. */
+   util::fd_owner m_shared_export;
+};
+
+/**
+ * Synchronization using a Vulkan timeline semaphore.
+ *
+ * A single monotonically increasing timeline covers all present payloads of a
+ * swapchain. Every payload signals the next point on the timeline, so waiting
+ * for any number of pending payloads is a single vkWaitSemaphores call and no
+ * per-present fence reset is needed.
+ */
+class timeline_sync
+{
+public:
+   /**
+    * Checks if a Vulkan device can support timeline semaphore synchronization.
+    *
+    * @param device The device private data to check support for.
+    *
+    * @return true if supported, false otherwise.
+    */
+   static bool is_supported(layer::device_private_data &device);
+
+   /**
+    * Creates a new timeline synchronization object.
+    *
+    * @param device The device private data for which to create it.
+    *
+    * @return Empty optional on failure or initialized timeline.
+    */
+   static std::optional<timeline_sync> create(layer::device_private_data &device);
+
+   timeline_sync() = default;
+   timeline_sync(const timeline_sync &) = delete;
+   timeline_sync &operator=(const timeline_sync &) = delete;
+
+   timeline_sync(timeline_sync &&rhs);
+   timeline_sync &operator=(timeline_sync &&rhs);
+
+   ~timeline_sync();
+
+   /**
+    * Sets a payload signalling the next point on the timeline.
+    *
+    * @note This method is not threadsafe.
+    *
+    * @param      queue            The Vulkan queue that may be used to submit synchronization commands.
+    * @param      semaphores       The wait and signal semaphores.
+    * @param[out] payload_value    The timeline point the payload signals. Pass it to wait_for_value
+    *                              to wait for this payload to complete.
+    * @param      submission_pnext Chain of pointers to attach to the payload submission.
+    * @param      submission_fence Optional fence to signal from the payload submission. The timeline
+    *                              path keeps the fence slot of its queue submission free, so callers
+    *                              can piggyback a fence signal instead of issuing a separate submit.
+    *
+    * @return VK_SUCCESS on success or other error code on failing to set the payload.
+    */
+   VkResult set_payload(VkQueue queue, const queue_submit_semaphores &semaphores, uint64_t *payload_value,
+                        const void *submission_pnext = nullptr, VkFence submission_fence = VK_NULL_HANDLE);
+
+   /**
+    * Reserves the next point on the timeline for a payload submitted by the caller.
+    *
+    * Unlike set_payload no submission is performed: the caller must include a
+    * signal of the returned semaphore with the returned value in its own queue
+    * submission, or roll the reservation back with cancel_reserved_payload if
+    * that submission fails. Used to fold the payloads of several swapchains
+    * into a single batched submission.
+    *
+    * @note This method is not threadsafe.
+    *
+    * @param[out] payload_value The timeline point the caller must signal.
+    *
+    * @return The timeline semaphore to signal.
+    */
+   VkSemaphore reserve_payload(uint64_t *payload_value);
+
+   /**
+    * Rolls back a reservation whose submission was never queued.
+    *
+    * Must be called before any further payload is set on this timeline, so the
+    * reservation being cancelled is still the latest point.
+    *
+    * @note This method is not threadsafe.
+    *
+    * @param[in,out] payload_value The reserved point, updated to the last point
+    *                              that will actually signal.
+    */
+   void cancel_reserved_payload(uint64_t *payload_value);
+
+   /**
+    * Waits until the timeline reaches the given point.
+    *
+    * @param value   Timeline point to wait for, as returned by set_payload. 0 returns immediately.
+    * @param timeout Timeout for waiting in nanoseconds.
+    *
+    * @return VK_SUCCESS on success, VK_TIMEOUT or other error code otherwise.
+    */
+   VkResult wait_for_value(uint64_t value, uint64_t timeout);
+
+   /**
+    * Waits for all payloads submitted so far with a single call.
+    *
+    * @param timeout Timeout for waiting in nanoseconds.
+    *
+    * @return VK_SUCCESS on success, VK_TIMEOUT or other error code otherwise.
+    */
+   VkResult wait_all_pending(uint64_t timeout);
+
+private:
+   /**
+    * Non-public constructor to initialize the object with valid data.
+    *
+    * @param device       The device private data for the timeline.
+    * @param vk_semaphore The created Vulkan timeline semaphore.
+    */
+   timeline_sync(layer::device_private_data &device, VkSemaphore vk_semaphore);
+
+   VkSemaphore semaphore{ VK_NULL_HANDLE };
+   /* Last timeline point that a payload was set for. */
+   uint64_t timeline_value{ 0 };
+   layer::device_private_data *dev{ nullptr };
 };
 
 /**
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2025 Arm Limited.
+ * Copyright (c) 2025-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -30,28 +30,88 @@
 
 #include "present_timing_handler.hpp"
 
+#include <util/log.hpp>
+
 wsi_ext_present_timing_wayland::wsi_ext_present_timing_wayland(const util::allocator &allocator)
    : wsi_ext_present_timing(allocator)
 {
 }
 
 util::unique_ptr<wsi_ext_present_timing_wayland> wsi_ext_present_timing_wayland::create(
-   const util::allocator &allocator)
+   const util::allocator &allocator, bool monotonic_feedback_clock)
 {
-   std::array<util::unique_ptr<wsi::vulkan_time_domain>, 1> time_domains_array = {
-      allocator.make_unique<wsi::vulkan_time_domain>(VK_PRESENT_STAGE_QUEUE_OPERATIONS_END_BIT_EXT,
-                                                     VK_TIME_DOMAIN_DEVICE_KHR)
-   };
+   auto present_timing = allocator.make_unique<wsi_ext_present_timing_wayland>(allocator);
+   if (present_timing == nullptr)
+   {
+      return nullptr;
+   }
+
+   auto queue_end_domain = allocator.make_unique<wsi::vulkan_time_domain>(VK_PRESENT_STAGE_QUEUE_OPERATIONS_END_BIT_EXT,
+                                                                          VK_TIME_DOMAIN_DEVICE_KHR);
+   if (queue_end_domain == nullptr ||
+       !present_timing->get_swapchain_time_domains().add_time_domain(std::move(queue_end_domain)))
+   {
+      WSI_LOG_ERROR("Failed to add a time domain.");
+      return nullptr;
+   }
+
+   if (monotonic_feedback_clock)
+   {
+      auto feedback_domain =
+         allocator.make_unique<presentation_feedback_time_domain>(VK_PRESENT_STAGE_IMAGE_FIRST_PIXEL_VISIBLE_BIT_EXT);
+      if (feedback_domain == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to add a time domain.");
+         return nullptr;
+      }
 
-   return wsi_ext_present_timing::create<wsi_ext_present_timing_wayland>(allocator, time_domains_array);
+      /* The list owns the domain; the raw pointer is only used to feed it the
+       * feedback timestamps and shares the extension's lifetime. */
+      auto *feedback_domain_ptr = feedback_domain.get();
+      if (!present_timing->get_swapchain_time_domains().add_time_domain(std::move(feedback_domain)))
+      {
+         WSI_LOG_ERROR("Failed to add a time domain.");
+         return nullptr;
+      }
+      present_timing->m_feedback_time_domain = feedback_domain_ptr;
+   }
+
+   return present_timing;
 }
 
 VkResult wsi_ext_present_timing_wayland::get_swapchain_timing_properties(
    uint64_t &timing_properties_counter, VkSwapchainTimingPropertiesEXT &timing_properties)
 {
-   timing_properties_counter = 0;
-   timing_properties.refreshDuration = 0;
+   /* The refresh duration comes from the compositor's presentation feedback,
+    * so it tracks the output the surface is actually shown on; it reads 0
+    * until the first presented event arrives. The counter is bumped whenever
+    * feedback reports a different duration, e.g. after the window moved to a
+    * monitor with another refresh rate. */
+   timing_properties_counter = m_timing_properties_counter.load(std::memory_order_relaxed);
+   timing_properties.refreshDuration = m_refresh_duration_ns.load(std::memory_order_relaxed);
    timing_properties.variableRefreshDelay = 0;
 
    return VK_SUCCESS;
-}
\ No newline at end of file
+}
+
+void wsi_ext_present_timing_wayland::handle_presentation_feedback(uint64_t time_ns, uint32_t refresh_ns,
+                                                                  bool presented)
+{
+   if (!presented)
+   {
+      /* A discarded frame never reached the screen; there is no scanout
+       * timestamp to record. */
+      return;
+   }
+
+   if (m_feedback_time_domain != nullptr)
+   {
+      m_feedback_time_domain->set_last_presented_time(time_ns);
+   }
+
+   if (refresh_ns != 0 && m_refresh_duration_ns.load(std::memory_order_relaxed) != refresh_ns)
+   {
+      m_refresh_duration_ns.store(refresh_ns, std::memory_order_relaxed);
+      m_timing_properties_counter.fetch_add(1, std::memory_order_relaxed);
+   }
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2025 Arm Limited.
+ * Copyright (c) 2025-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -31,8 +31,46 @@
 
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
 
+#include <atomic>
+
 #include <wsi/extensions/present_timing.hpp>
 
+/**
+ * @brief Time domain anchored on compositor presentation feedback.
+ *
+ * wp_presentation feedback events carry the hardware-clock timestamp of the
+ * first pixel of a frame becoming visible. Like the display backend's vblank
+ * domain, calibration reports the most recent such timestamp, so the domain is
+ * only registered when the compositor clocks its feedback with CLOCK_MONOTONIC.
+ */
+class presentation_feedback_time_domain : public wsi::swapchain_time_domain
+{
+public:
+   presentation_feedback_time_domain(VkPresentStageFlagsEXT present_stages)
+      : wsi::swapchain_time_domain(present_stages)
+   {
+   }
+
+   wsi::swapchain_calibrated_time calibrate() override
+   {
+      return { VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR, m_last_presented_time_ns.load(std::memory_order_relaxed) };
+   }
+
+   /**
+    * @brief Record the timestamp of the latest presented feedback event.
+    *
+    * @param time_ns First-pixel-visible time in nanoseconds on the feedback clock.
+    */
+   void set_last_presented_time(uint64_t time_ns)
+   {
+      m_last_presented_time_ns.store(time_ns, std::memory_order_relaxed);
+   }
+
+private:
+   /** Timestamp of the most recent presented event, 0 until the first one arrives. */
+   std::atomic<uint64_t> m_last_presented_time_ns{ 0 };
+};
+
 /**
  * @brief Present timing extension class
  *
@@ -41,16 +79,59 @@
 class wsi_ext_present_timing_wayland : public wsi::wsi_ext_present_timing
 {
 public:
-   static util::unique_ptr<wsi_ext_present_timing_wayland> create(const util::allocator &allocator);
+   /**
+    * @brief Create the Wayland present timing extension.
+    *
+    * @param allocator                Allocator for the extension object.
+    * @param monotonic_feedback_clock Whether the compositor reported CLOCK_MONOTONIC
+    *                                 as its wp_presentation clock. When true a
+    *                                 first-pixel-visible time domain backed by the
+    *                                 feedback timestamps is registered.
+    */
+   static util::unique_ptr<wsi_ext_present_timing_wayland> create(const util::allocator &allocator,
+                                                                  bool monotonic_feedback_clock);
 
    VkResult get_swapchain_timing_properties(uint64_t &timing_properties_counter,
                                             VkSwapchainTimingPropertiesEXT &timing_properties) override;
 
+   /**
+    * @brief Record a wp_presentation feedback event for a committed frame.
+    *
+    * Called from Wayland event dispatch when the compositor reports a frame as
+    * presented or discarded. Presented events update the feedback time domain
+    * and the swapchain's refresh duration, turning the layer-local guesses into
+    * compositor-reported scanout data.
+    *
+    * @param time_ns    First-pixel-visible timestamp in nanoseconds; only
+    *                   meaningful when @p presented is true.
+    * @param refresh_ns Compositor-reported refresh duration in nanoseconds, 0
+    *                   when unknown (e.g. VRR).
+    * @param presented  True when the frame reached the screen, false when it
+    *                   was discarded without being shown.
+    */
+   void handle_presentation_feedback(uint64_t time_ns, uint32_t refresh_ns, bool presented);
+
 private:
    wsi_ext_present_timing_wayland(const util::allocator &allocator);
 
    /* Allow util::allocator to access the private constructor */
    friend util::allocator;
+
+   /**
+    * @brief Refresh duration last reported through presentation feedback, 0 until known.
+    */
+   std::atomic<uint64_t> m_refresh_duration_ns{ 0 };
+
+   /**
+    * @brief Bumped whenever the reported timing properties change.
+    */
+   std::atomic<uint64_t> m_timing_properties_counter{ 0 };
+
+   /**
+    * @brief Feedback-backed time domain, owned by the time domain list. Nullptr
+    * when the compositor does not clock its feedback with CLOCK_MONOTONIC.
+    */
+   presentation_feedback_time_domain *m_feedback_time_domain{ nullptr };
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, 2024-2025 Arm Limited.
+ * Copyright (c) 2021, 2024-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -33,14 +33,58 @@
 #include "wl_helpers.hpp"
 #include "util/log.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 namespace wsi
 {
 namespace wayland
 {
 
+#if WSI_WAYLAND_HAVE_DMABUF_FEEDBACK
+
+bool dmabuf_format_table::map(int fd, uint32_t size)
+{
+   if (entries != nullptr)
+   {
+      munmap(const_cast<entry *>(entries), count * sizeof(entry));
+      entries = nullptr;
+      count = 0;
+   }
+
+   void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (data == MAP_FAILED)
+   {
+      WSI_LOG_ERROR("Failed to map the dmabuf-feedback format table: %d.", errno);
+      return false;
+   }
+
+   entries = static_cast<const entry *>(data);
+   count = size / sizeof(entry);
+   return true;
+}
+
+dmabuf_format_table::~dmabuf_format_table()
+{
+   if (entries != nullptr)
+   {
+      munmap(const_cast<entry *>(entries), count * sizeof(entry));
+   }
+}
+
+#endif /* WSI_WAYLAND_HAVE_DMABUF_FEEDBACK */
+
 struct formats_vector
 {
-   util::vector<drm_format_pair> *formats{ nullptr };
+   std::vector<drm_format_pair> *formats{ nullptr };
    bool is_out_of_memory{ false };
 };
 
@@ -69,9 +113,281 @@ zwp_linux_dmabuf_v1_modifier_impl(void *data, struct zwp_linux_dmabuf_v1 *dma_bu
 
    if (!drm_supported_formats->is_out_of_memory)
    {
-      drm_supported_formats->is_out_of_memory = !drm_supported_formats->formats->try_push_back(format);
+      /* Allocation failures must not unwind through the libwayland dispatcher. */
+      try
+      {
+         drm_supported_formats->formats->push_back(format);
+      }
+      catch (const std::bad_alloc &)
+      {
+         drm_supported_formats->is_out_of_memory = true;
+      }
    }
 }
+
+#if WSI_WAYLAND_HAVE_DMABUF_FEEDBACK
+
+/**
+ * @brief State shared with the zwp_linux_dmabuf_feedback_v1 listener while the
+ *        initial feedback burst is collected.
+ *
+ * The table mapping and the tranche index arrays are the only allocations made;
+ * individual formats are never unpacked from the table.
+ */
+struct feedback_state
+{
+   /** The table the tranche indices refer to. */
+   dmabuf_format_table *table{ nullptr };
+   /** Output list of tranches. */
+   std::vector<feedback_tranche> *tranches{ nullptr };
+   /** Tranche being accumulated until the next tranche_done event. */
+   feedback_tranche pending{};
+   /** Set by the done event once the full feedback state has been sent. */
+   bool done{ false };
+   /** Set when the table could not be mapped or the host went out of memory. */
+   bool error{ false };
+};
+
+VWL_CAPI_CALL(void)
+dmabuf_feedback_format_table_impl(void *data, struct zwp_linux_dmabuf_feedback_v1 *feedback, int32_t fd,
+                                  uint32_t size) VWL_API_POST
+{
+   UNUSED(feedback);
+   auto *state = reinterpret_cast<feedback_state *>(data);
+   if (!state->table->map(fd, size))
+   {
+      state->error = true;
+   }
+}
+
+VWL_CAPI_CALL(void)
+dmabuf_feedback_main_device_impl(void *data, struct zwp_linux_dmabuf_feedback_v1 *feedback,
+                                 struct wl_array *device) VWL_API_POST
+{
+   UNUSED(data);
+   UNUSED(feedback);
+   UNUSED(device);
+}
+
+VWL_CAPI_CALL(void)
+dmabuf_feedback_tranche_target_device_impl(void *data, struct zwp_linux_dmabuf_feedback_v1 *feedback,
+                                           struct wl_array *device) VWL_API_POST
+{
+   UNUSED(data);
+   UNUSED(feedback);
+   UNUSED(device);
+}
+
+VWL_CAPI_CALL(void)
+dmabuf_feedback_tranche_formats_impl(void *data, struct zwp_linux_dmabuf_feedback_v1 *feedback,
+                                     struct wl_array *indices) VWL_API_POST
+{
+   UNUSED(feedback);
+   auto *state = reinterpret_cast<feedback_state *>(data);
+   if (state->error)
+   {
+      return;
+   }
+
+   const auto *begin = static_cast<const uint16_t *>(indices->data);
+   /* One bulk copy of the index array; allocation failures must not unwind
+    * through the libwayland dispatcher. */
+   try
+   {
+      state->pending.formats.assign(begin, begin + indices->size / sizeof(uint16_t));
+   }
+   catch (const std::bad_alloc &)
+   {
+      state->error = true;
+   }
+}
+
+VWL_CAPI_CALL(void)
+dmabuf_feedback_tranche_flags_impl(void *data, struct zwp_linux_dmabuf_feedback_v1 *feedback,
+                                   uint32_t flags) VWL_API_POST
+{
+   UNUSED(feedback);
+   auto *state = reinterpret_cast<feedback_state *>(data);
+   state->pending.flags = flags;
+}
+
+VWL_CAPI_CALL(void)
+dmabuf_feedback_tranche_done_impl(void *data, struct zwp_linux_dmabuf_feedback_v1 *feedback) VWL_API_POST
+{
+   UNUSED(feedback);
+   auto *state = reinterpret_cast<feedback_state *>(data);
+   if (!state->error)
+   {
+      try
+      {
+         state->tranches->push_back(std::move(state->pending));
+      }
+      catch (const std::bad_alloc &)
+      {
+         state->error = true;
+      }
+   }
+   state->pending = {};
+}
+
+VWL_CAPI_CALL(void)
+dmabuf_feedback_done_impl(void *data, struct zwp_linux_dmabuf_feedback_v1 *feedback) VWL_API_POST
+{
+   UNUSED(feedback);
+   auto *state = reinterpret_cast<feedback_state *>(data);
+   state->done = true;
+}
+
+const zwp_linux_dmabuf_feedback_v1_listener dmabuf_feedback_listener = {
+   .done = dmabuf_feedback_done_impl,
+   .format_table = dmabuf_feedback_format_table_impl,
+   .main_device = dmabuf_feedback_main_device_impl,
+   .tranche_done = dmabuf_feedback_tranche_done_impl,
+   .tranche_target_device = dmabuf_feedback_tranche_target_device_impl,
+   .tranche_formats = dmabuf_feedback_tranche_formats_impl,
+   .tranche_flags = dmabuf_feedback_tranche_flags_impl,
+};
+
+/**
+ * @brief Collect the initial burst of events from a feedback object.
+ *
+ * @param[in]  display  The wl_display that is being used.
+ * @param[in]  queue    The queue the @p feedback object dispatches on.
+ * @param[in]  feedback The feedback object to listen on.
+ * @param[in]  table    The format table the tranche indices refer to.
+ * @param[out] tranches Output list of collected tranches.
+ *
+ * @retval VK_SUCCESS                  Indicates success.
+ * @retval VK_ERROR_UNKNOWN            Indicates one of the Wayland functions failed.
+ * @retval VK_ERROR_OUT_OF_HOST_MEMORY Indicates the host went out of memory.
+ */
+VkResult collect_dmabuf_feedback(wl_display *display, wl_event_queue *queue, zwp_linux_dmabuf_feedback_v1 *feedback,
+                                 dmabuf_format_table &table, std::vector<feedback_tranche> &tranches)
+{
+   feedback_state state;
+   state.table = &table;
+   state.tranches = &tranches;
+
+   int res = zwp_linux_dmabuf_feedback_v1_add_listener(feedback, &dmabuf_feedback_listener, &state);
+   if (res < 0)
+   {
+      WSI_LOG_ERROR("Failed to add zwp_linux_dmabuf_feedback_v1 listener.");
+      return VK_ERROR_UNKNOWN;
+   }
+
+   /* The compositor sends the complete feedback state, terminated by a done
+    * event, in response to the get_*_feedback request. */
+   while (!state.done && !state.error)
+   {
+      res = wl_display_roundtrip_queue(display, queue);
+      if (res < 0)
+      {
+         WSI_LOG_ERROR("Roundtrip failed.");
+         return VK_ERROR_UNKNOWN;
+      }
+   }
+
+   if (state.error)
+   {
+      return table.entries == nullptr ? VK_ERROR_UNKNOWN : VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   return VK_SUCCESS;
+}
+
+#endif /* WSI_WAYLAND_HAVE_DMABUF_FEEDBACK */
+
+/* Handler for the clock_id event of wp_presentation, recording which clock the
+ * compositor timestamps presentation feedback with. */
+VWL_CAPI_CALL(void)
+wp_presentation_clock_id_handler(void *data, struct wp_presentation *presentation, uint32_t clk_id) VWL_API_POST
+{
+   UNUSED(presentation);
+   auto *globals = reinterpret_cast<display_globals *>(data);
+   globals->presentation_clock_id = clk_id;
+}
+
+const wp_presentation_listener presentation_time_listener = {
+   .clock_id = wp_presentation_clock_id_handler,
+};
+
+/* Handler for global events of the wl_registry interface, binding the globals needed by the layer. */
+VWL_CAPI_CALL(void)
+surface_registry_handler(void *data, struct wl_registry *wl_registry, uint32_t name, const char *interface,
+                         uint32_t version) VWL_API_POST
+{
+   auto *globals = reinterpret_cast<display_globals *>(data);
+
+   if (!strcmp(interface, zwp_linux_dmabuf_v1_interface.name) && version >= ZWP_LINUX_DMABUF_V1_MODIFIER_SINCE_VERSION)
+   {
+#if WSI_WAYLAND_HAVE_DMABUF_FEEDBACK
+      /* Bind up to v4 to get dmabuf-feedback when the compositor has it. */
+      const uint32_t bind_version =
+         std::min(version, static_cast<uint32_t>(ZWP_LINUX_DMABUF_V1_GET_DEFAULT_FEEDBACK_SINCE_VERSION));
+#else
+      const uint32_t bind_version = ZWP_LINUX_DMABUF_V1_MODIFIER_SINCE_VERSION;
+#endif
+      zwp_linux_dmabuf_v1 *dmabuf_interface_obj = reinterpret_cast<zwp_linux_dmabuf_v1 *>(
+         wl_registry_bind(wl_registry, name, &zwp_linux_dmabuf_v1_interface, bind_version));
+
+      if (dmabuf_interface_obj == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to get zwp_linux_dmabuf_v1 interface.");
+         return;
+      }
+
+      globals->dmabuf_interface.reset(dmabuf_interface_obj);
+   }
+   else if (!strcmp(interface, zwp_linux_explicit_synchronization_v1_interface.name))
+   {
+      zwp_linux_explicit_synchronization_v1 *explicit_sync_interface_obj =
+         reinterpret_cast<zwp_linux_explicit_synchronization_v1 *>(
+            wl_registry_bind(wl_registry, name, &zwp_linux_explicit_synchronization_v1_interface, 1));
+
+      if (explicit_sync_interface_obj == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to get zwp_linux_explicit_synchronization_v1 interface.");
+         return;
+      }
+
+      globals->explicit_sync_interface.reset(explicit_sync_interface_obj);
+   }
+   else if (!strcmp(interface, wp_presentation_interface.name))
+   {
+      wp_presentation *wp_presentation_obj =
+         reinterpret_cast<wp_presentation *>(wl_registry_bind(wl_registry, name, &wp_presentation_interface, 1));
+
+      if (wp_presentation_obj == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to get wp_presentation interface.");
+         return;
+      }
+
+      globals->presentation_time_interface.reset(wp_presentation_obj);
+
+      /* The clock_id event arrives with the format events collected by the
+       * round trips that follow the binds, so it costs nothing extra. */
+      if (wp_presentation_add_listener(wp_presentation_obj, &presentation_time_listener, globals) < 0)
+      {
+         WSI_LOG_WARNING("Failed to add wp_presentation listener, assuming a monotonic feedback clock.");
+      }
+   }
+#if WAYLAND_TEARING_CONTROL_ENABLED
+   else if (!strcmp(interface, wp_tearing_control_manager_v1_interface.name))
+   {
+      wp_tearing_control_manager_v1 *tearing_manager_obj = reinterpret_cast<wp_tearing_control_manager_v1 *>(
+         wl_registry_bind(wl_registry, name, &wp_tearing_control_manager_v1_interface, 1));
+
+      if (tearing_manager_obj == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to get wp_tearing_control_manager_v1 interface.");
+         return;
+      }
+
+      globals->tearing_control_manager.reset(tearing_manager_obj);
+   }
+#endif
+}
 } // namespace
 
 /*
@@ -89,7 +405,7 @@ zwp_linux_dmabuf_v1_modifier_impl(void *data, struct zwp_linux_dmabuf_v1 *dma_bu
  */
 static VkResult get_supported_formats_and_modifiers(wl_display *display, wl_event_queue *queue,
                                                     zwp_linux_dmabuf_v1 *dmabuf_interface,
-                                                    util::vector<drm_format_pair> &supported_formats)
+                                                    std::vector<drm_format_pair> &supported_formats)
 {
    formats_vector drm_supported_formats;
    drm_supported_formats.formats = &supported_formats;
@@ -136,57 +452,173 @@ surface::surface(const init_parameters &params)
    , wayland_surface(params.surf)
    , supported_formats(params.allocator)
    , properties(this, params.allocator)
-   , last_frame_callback(nullptr)
-   , present_pending(false)
+   , m_reader_queues(params.allocator)
 {
 }
 
-VWL_CAPI_CALL(void)
-surface_registry_handler(void *data, struct wl_registry *wl_registry, uint32_t name, const char *interface,
-                         uint32_t version) VWL_API_POST
+/**
+ * @brief Bind the layer's globals from a display and fetch the dmabuf format table.
+ *
+ * Issues every bind from a single registry listing, so the sequence costs exactly
+ * two round trips: one for the compositor to announce the globals and one to
+ * flush the binds and collect the dmabuf format events they trigger. This is the
+ * protocol minimum - the global names must arrive before a bind can be issued and
+ * the format events are only sent in response to the bind.
+ *
+ * @param display The Wayland display to bind the globals from.
+ *
+ * @return The bound globals, or nullptr on failure.
+ */
+static std::shared_ptr<display_globals> bind_display_globals(wl_display *display)
 {
-   auto wsi_surface = reinterpret_cast<wsi::wayland::surface *>(data);
+   auto globals = std::make_shared<display_globals>();
 
-   if (!strcmp(interface, zwp_linux_dmabuf_v1_interface.name) && version >= ZWP_LINUX_DMABUF_V1_MODIFIER_SINCE_VERSION)
+   globals->queue.reset(wl_display_create_queue(display));
+   if (globals->queue.get() == nullptr)
    {
-      zwp_linux_dmabuf_v1 *dmabuf_interface_obj = reinterpret_cast<zwp_linux_dmabuf_v1 *>(wl_registry_bind(
-         wl_registry, name, &zwp_linux_dmabuf_v1_interface, ZWP_LINUX_DMABUF_V1_MODIFIER_SINCE_VERSION));
+      WSI_LOG_ERROR("Failed to create wl display globals queue.");
+      return nullptr;
+   }
 
-      if (dmabuf_interface_obj == nullptr)
-      {
-         WSI_LOG_ERROR("Failed to get zwp_linux_dmabuf_v1 interface.");
-         return;
-      }
+   auto display_proxy = make_proxy_with_queue(display, globals->queue.get());
+   if (display_proxy == nullptr)
+   {
+      WSI_LOG_ERROR("Failed to create wl display proxy.");
+      return nullptr;
+   };
 
-      wsi_surface->dmabuf_interface.reset(dmabuf_interface_obj);
+   auto registry = wayland_owner<wl_registry>{ wl_display_get_registry(display_proxy.get()) };
+   if (registry == nullptr)
+   {
+      WSI_LOG_ERROR("Failed to get wl display registry.");
+      return nullptr;
    }
-   else if (!strcmp(interface, zwp_linux_explicit_synchronization_v1_interface.name))
+
+   const wl_registry_listener registry_listener = { surface_registry_handler, nullptr };
+   int res = wl_registry_add_listener(registry.get(), &registry_listener, globals.get());
+   if (res < 0)
    {
-      zwp_linux_explicit_synchronization_v1 *explicit_sync_interface_obj =
-         reinterpret_cast<zwp_linux_explicit_synchronization_v1 *>(
-            wl_registry_bind(wl_registry, name, &zwp_linux_explicit_synchronization_v1_interface, 1));
+      WSI_LOG_ERROR("Failed to add registry listener.");
+      return nullptr;
+   }
 
-      if (explicit_sync_interface_obj == nullptr)
+   res = wl_display_roundtrip_queue(display, globals->queue.get());
+   if (res < 0)
+   {
+      WSI_LOG_ERROR("Roundtrip failed.");
+      return nullptr;
+   }
+
+   if (globals->dmabuf_interface.get() == nullptr)
+   {
+      WSI_LOG_ERROR("Failed to obtain zwp_linux_dma_buf_v1 interface.");
+      return nullptr;
+   }
+
+   if (globals->presentation_time_interface.get() == nullptr)
+   {
+      WSI_LOG_ERROR("Failed to obtain wp_presentation interface.");
+      //return nullptr;
+   }
+
+#if WSI_WAYLAND_HAVE_DMABUF_FEEDBACK
+   globals->has_feedback = wl_proxy_get_version(reinterpret_cast<wl_proxy *>(globals->dmabuf_interface.get())) >=
+                           ZWP_LINUX_DMABUF_V1_GET_DEFAULT_FEEDBACK_SINCE_VERSION;
+   if (globals->has_feedback)
+   {
+      /* dmabuf-feedback replaces the v3 modifier events: the compositor shares
+       * its format table through an fd which is mapped and indexed in place. The
+       * default feedback provides the display-wide format list; per-surface
+       * tranches are fetched by each surface. */
+      auto feedback = wayland_owner<zwp_linux_dmabuf_feedback_v1>{ zwp_linux_dmabuf_v1_get_default_feedback(
+         globals->dmabuf_interface.get()) };
+      if (feedback == nullptr)
       {
-         WSI_LOG_ERROR("Failed to get zwp_linux_explicit_synchronization_v1 interface.");
-         return;
+         WSI_LOG_ERROR("Failed to get default dmabuf feedback.");
+         return nullptr;
+      }
+
+      std::vector<feedback_tranche> tranches;
+      VkResult vk_res =
+         collect_dmabuf_feedback(display, globals->queue.get(), feedback.get(), globals->format_table, tranches);
+      if (vk_res != VK_SUCCESS)
+      {
+         return nullptr;
       }
 
-      wsi_surface->explicit_sync_interface.reset(explicit_sync_interface_obj);
+      /* Flatten the tranches into the display format list, deduplicating by
+       * table row so overlapping tranches do not repeat formats. */
+      const auto &table = globals->format_table;
+      try
+      {
+         std::vector<bool> seen(table.count, false);
+         for (const auto &tranche : tranches)
+         {
+            for (uint16_t index : tranche.formats)
+            {
+               if (index >= table.count || seen[index])
+               {
+                  continue;
+               }
+               seen[index] = true;
+               globals->supported_formats.push_back({ table.entries[index].format, table.entries[index].modifier });
+            }
+         }
+      }
+      catch (const std::bad_alloc &)
+      {
+         WSI_LOG_ERROR("Host got out of memory.");
+         return nullptr;
+      }
+
+      return globals;
    }
-   else if (!strcmp(interface, wp_presentation_interface.name))
+#endif
+
+   VkResult vk_res = get_supported_formats_and_modifiers(display, globals->queue.get(),
+                                                         globals->dmabuf_interface.get(), globals->supported_formats);
+   if (vk_res != VK_SUCCESS)
    {
-      wp_presentation *wp_presentation_obj =
-         reinterpret_cast<wp_presentation *>(wl_registry_bind(wl_registry, name, &wp_presentation_interface, 1));
+      return nullptr;
+   }
 
-      if (wp_presentation_obj == nullptr)
+   return globals;
+}
+
+/**
+ * @brief Get the globals for a display, binding them on first use.
+ *
+ * The cache holds weak references: surfaces own the globals and the entry for a
+ * display expires when its last surface is destroyed, releasing the proxies
+ * before the application can legally destroy the wl_display.
+ *
+ * @param display The Wayland display the surface was created from.
+ *
+ * @return The shared globals for @p display, or nullptr on failure.
+ */
+static std::shared_ptr<display_globals> get_display_globals(wl_display *display)
+{
+   static std::mutex cache_mutex;
+   static std::unordered_map<wl_display *, std::weak_ptr<display_globals>> cache;
+
+   std::lock_guard<std::mutex> lock(cache_mutex);
+
+   auto entry = cache.find(display);
+   if (entry != cache.end())
+   {
+      if (auto globals = entry->second.lock())
       {
-         WSI_LOG_ERROR("Failed to get wp_presentation interface.");
-         return;
+         return globals;
       }
+      cache.erase(entry);
+   }
 
-      wsi_surface->presentation_time_interface.reset(wp_presentation_obj);
+   auto globals = bind_display_globals(display);
+   if (globals != nullptr)
+   {
+      cache[display] = globals;
    }
+   return globals;
 }
 
 bool surface::init()
@@ -198,70 +630,148 @@ bool surface::init()
       return false;
    }
 
-   auto display_proxy = make_proxy_with_queue(wayland_display, surface_queue.get());
-   if (display_proxy == nullptr)
-   {
-      WSI_LOG_ERROR("Failed to create wl display proxy.");
-      return false;
-   };
-
-   auto registry = wayland_owner<wl_registry>{ wl_display_get_registry(display_proxy.get()) };
-   if (registry == nullptr)
+   /* Bind the globals, or share the ones an earlier surface on this display
+    * already bound. Only the cache miss costs compositor round trips. */
+   globals = get_display_globals(wayland_display);
+   if (globals == nullptr)
    {
-      WSI_LOG_ERROR("Failed to get wl display registry.");
       return false;
    }
 
-   const wl_registry_listener registry_listener = { surface_registry_handler, nullptr };
-   int res = wl_registry_add_listener(registry.get(), &registry_listener, this);
-   if (res < 0)
+   if (globals->explicit_sync_interface.get() != nullptr)
    {
-      WSI_LOG_ERROR("Failed to add registry listener.");
-      return false;
-   }
+      /* Route the request through a wrapper on the surface queue so the surface
+       * synchronization object and its descendants dispatch there, not on the
+       * shared globals queue. */
+      auto explicit_sync_proxy = make_proxy_with_queue(globals->explicit_sync_interface.get(), surface_queue.get());
+      if (explicit_sync_proxy == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to create zwp_linux_explicit_synchronization_v1 proxy.");
+         return false;
+      }
 
-   res = wl_display_roundtrip_queue(wayland_display, surface_queue.get());
-   if (res < 0)
-   {
-      WSI_LOG_ERROR("Roundtrip failed.");
-      return false;
-   }
+      auto surface_sync_obj =
+         zwp_linux_explicit_synchronization_v1_get_synchronization(explicit_sync_proxy.get(), wayland_surface);
+      if (surface_sync_obj == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to retrieve surface synchronization interface");
+         return false;
+      }
 
-   if (dmabuf_interface.get() == nullptr)
-   {
-      WSI_LOG_ERROR("Failed to obtain zwp_linux_dma_buf_v1 interface.");
-      return false;
+      surface_sync_interface.reset(surface_sync_obj);
    }
 
-   if (presentation_time_interface.get() == nullptr)
+#if WAYLAND_TEARING_CONTROL_ENABLED
+   if (globals->tearing_control_manager.get() != nullptr)
    {
-      WSI_LOG_ERROR("Failed to obtain wp_presentation interface.");
-      //return false;
+      /* The tearing control object is per surface; route the request through a
+       * wrapper on the surface queue like the synchronization object above. */
+      auto tearing_proxy = make_proxy_with_queue(globals->tearing_control_manager.get(), surface_queue.get());
+      if (tearing_proxy == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to create wp_tearing_control_manager_v1 proxy.");
+         return false;
+      }
+
+      m_tearing_control.reset(wp_tearing_control_manager_v1_get_tearing_control(tearing_proxy.get(), wayland_surface));
+      if (m_tearing_control.get() == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to get wp_tearing_control_v1 for the surface.");
+         return false;
+      }
    }
+#endif
 
-   if (explicit_sync_interface.get() != nullptr)
+#if WSI_WAYLAND_HAVE_DMABUF_FEEDBACK
+   if (globals->has_feedback)
    {
-      auto surface_sync_obj =
-         zwp_linux_explicit_synchronization_v1_get_synchronization(explicit_sync_interface.get(), wayland_surface);
-      if (surface_sync_obj == nullptr)
+      /* Fetch the surface's own feedback tranches so image allocation can
+       * prefer modifiers the compositor can scan out directly for this surface.
+       * The tranche index arrays point into the display's shared format table,
+       * so no per-format state is copied. */
+      auto dmabuf_proxy = make_proxy_with_queue(globals->dmabuf_interface.get(), surface_queue.get());
+      if (dmabuf_proxy == nullptr)
       {
-         WSI_LOG_ERROR("Failed to retrieve surface synchronization interface");
+         WSI_LOG_ERROR("Failed to create zwp_linux_dmabuf_v1 proxy.");
          return false;
       }
 
-      surface_sync_interface.reset(surface_sync_obj);
+      auto feedback = wayland_owner<zwp_linux_dmabuf_feedback_v1>{ zwp_linux_dmabuf_v1_get_surface_feedback(
+         dmabuf_proxy.get(), wayland_surface) };
+      if (feedback == nullptr)
+      {
+         WSI_LOG_ERROR("Failed to get surface dmabuf feedback.");
+         return false;
+      }
+
+      VkResult vk_res = collect_dmabuf_feedback(wayland_display, surface_queue.get(), feedback.get(), m_format_table,
+                                                m_feedback_tranches);
+      if (vk_res != VK_SUCCESS)
+      {
+         return false;
+      }
    }
+#endif
 
-   VkResult vk_res = get_supported_formats_and_modifiers(wayland_display, surface_queue.get(), dmabuf_interface.get(),
-                                                         supported_formats);
-   if (vk_res != VK_SUCCESS)
+   /* Copy the shared format table into the surface's allocator-scoped list. */
+   if (!supported_formats.try_push_back_many(globals->supported_formats.data(),
+                                             globals->supported_formats.data() + globals->supported_formats.size()))
    {
+      WSI_LOG_ERROR("Host got out of memory.");
       return false;
    }
 
    return true;
 }
 
+bool surface::supports_scanout(uint32_t fourcc, uint64_t modifier) const
+{
+#if WSI_WAYLAND_HAVE_DMABUF_FEEDBACK
+   for (const auto &tranche : m_feedback_tranches)
+   {
+      if (!(tranche.flags & ZWP_LINUX_DMABUF_FEEDBACK_V1_TRANCHE_FLAGS_SCANOUT))
+      {
+         continue;
+      }
+      for (uint16_t index : tranche.formats)
+      {
+         if (index < m_format_table.count && m_format_table.entries[index].format == fourcc &&
+             m_format_table.entries[index].modifier == modifier)
+         {
+            return true;
+         }
+      }
+   }
+#else
+   UNUSED(fourcc);
+   UNUSED(modifier);
+#endif
+   return false;
+}
+
+bool surface::has_tearing_control() const
+{
+#if WAYLAND_TEARING_CONTROL_ENABLED
+   return m_tearing_control.get() != nullptr;
+#else
+   return false;
+#endif
+}
+
+void surface::set_tearing_hint(bool async)
+{
+#if WAYLAND_TEARING_CONTROL_ENABLED
+   if (m_tearing_control.get() != nullptr)
+   {
+      wp_tearing_control_v1_set_presentation_hint(m_tearing_control.get(),
+                                                  async ? WP_TEARING_CONTROL_V1_PRESENTATION_HINT_ASYNC :
+                                                          WP_TEARING_CONTROL_V1_PRESENTATION_HINT_VSYNC);
+   }
+#else
+   UNUSED(async);
+#endif
+}
+
 util::unique_ptr<surface> surface::make_surface(const util::allocator &allocator, wl_display *display, wl_surface *surf)
 {
    init_parameters params{ allocator, display, surf };
@@ -278,87 +788,173 @@ util::unique_ptr<surface> surface::make_surface(const util::allocator &allocator
 
 surface::~surface()
 {
+   /* Swapchains unregister their queues on destruction, so the thread is normally
+    * already stopped by the time the surface goes away. */
+   stop_event_reader();
 }
 
-wsi::surface_properties &surface::get_properties()
+bool surface::register_swapchain_queue(wl_event_queue *queue)
 {
-   return properties;
-}
+   /* The reader must not be mid-dispatch while the queue list changes, restart it
+    * around the mutation. Registration only happens at swapchain creation so the
+    * extra thread churn is not a concern. */
+   stop_event_reader();
 
-util::unique_ptr<swapchain_base> surface::allocate_swapchain(layer::device_private_data &dev_data,
-                                                             const VkAllocationCallbacks *allocator)
-{
-   util::allocator alloc{ dev_data.get_allocator(), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, allocator };
-   return util::unique_ptr<swapchain_base>(alloc.make_unique<swapchain>(dev_data, allocator, *this));
+   {
+      std::lock_guard<std::mutex> lock(m_reader_mutex);
+      if (!m_reader_queues.try_push_back(queue))
+      {
+         return false;
+      }
+   }
+
+   if (!start_event_reader())
+   {
+      std::lock_guard<std::mutex> lock(m_reader_mutex);
+      m_reader_queues.pop_back();
+      return false;
+   }
+
+   return true;
 }
 
-static void frame_done(void *data, wl_callback *cb, uint32_t time)
+void surface::unregister_swapchain_queue(wl_event_queue *queue)
 {
-   UNUSED(time);
-   UNUSED(cb);
+   stop_event_reader();
 
-   bool *present_pending = reinterpret_cast<bool *>(data);
-   assert(present_pending);
+   bool restart = false;
+   {
+      std::lock_guard<std::mutex> lock(m_reader_mutex);
+      auto it = std::find(m_reader_queues.begin(), m_reader_queues.end(), queue);
+      if (it != m_reader_queues.end())
+      {
+         m_reader_queues.erase(it);
+      }
+      restart = !m_reader_queues.empty();
+   }
 
-   *present_pending = false;
+   if (restart)
+   {
+      start_event_reader();
+   }
 }
 
-bool surface::set_frame_callback()
+bool surface::start_event_reader()
 {
-   /* request a hint when we can present the _next_ frame */
-   auto surface_proxy = make_proxy_with_queue(wayland_surface, surface_queue.get());
-   if (surface_proxy == nullptr)
+   assert(!m_event_reader.joinable());
+
+   m_reader_stop_fd = eventfd(0, EFD_CLOEXEC);
+   if (m_reader_stop_fd < 0)
    {
-      WSI_LOG_ERROR("failed to create wl_surface proxy");
+      WSI_LOG_ERROR("Failed to create eventfd for the Wayland event reader thread.");
       return false;
    }
 
-   /* Reset will also destroy the previous callback object. */
-   last_frame_callback.reset(wl_surface_frame(surface_proxy.get()));
-   if (last_frame_callback.get() == nullptr)
+   try
    {
-      WSI_LOG_ERROR("Failed to create frame callback.");
-      return false;
+      m_event_reader = std::thread(&surface::event_reader_loop, this);
    }
-
-   static const wl_callback_listener frame_listener = { frame_done };
-   present_pending = true;
-   int res = wl_callback_add_listener(last_frame_callback.get(), &frame_listener, &present_pending);
-   if (res < 0)
+   catch (const std::system_error &)
    {
-      WSI_LOG_ERROR("Failed to add frame done callback listener.");
+      WSI_LOG_ERROR("Failed to start the Wayland event reader thread.");
+      close(m_reader_stop_fd);
+      m_reader_stop_fd = -1;
       return false;
    }
 
    return true;
 }
 
-bool surface::wait_next_frame_event()
+void surface::stop_event_reader()
 {
-   /*
-    * In a previous present call we sent a wl_surface::frame request, which will
-    * trigger an event when the compositor starts a redraw using the previous frame
-    * we sent. If the compositor isn't sending us frame events at least every second
-    * we don't wait indefinitely so we don't block the next image presentation if
-    * we are, e.g. minimised.
-    */
-   const int timeout = 1000;
-   while (present_pending)
+   if (!m_event_reader.joinable())
    {
-      int res = dispatch_queue(wayland_display, surface_queue.get(), timeout);
+      return;
+   }
+
+   const uint64_t stop_value = 1;
+   ssize_t res = write(m_reader_stop_fd, &stop_value, sizeof(stop_value));
+   UNUSED(res);
+
+   m_event_reader.join();
+   close(m_reader_stop_fd);
+   m_reader_stop_fd = -1;
+}
+
+void surface::event_reader_loop()
+{
+   while (true)
+   {
+      wl_event_queue *read_queue = nullptr;
+      {
+         std::lock_guard<std::mutex> lock(m_reader_mutex);
+         if (m_reader_queues.empty())
+         {
+            return;
+         }
+         read_queue = m_reader_queues.front();
+      }
+
+      /* Dispatch anything already queued before committing to a read. Which queue
+       * is used for the read preparation does not matter for event delivery, a
+       * read demultiplexes events to all queues of the display. */
+      while (wl_display_prepare_read_queue(wayland_display, read_queue) != 0)
+      {
+         std::lock_guard<std::mutex> lock(m_reader_mutex);
+         wl_display_dispatch_queue_pending(wayland_display, read_queue);
+      }
+      wl_display_flush(wayland_display);
+
+      pollfd fds[2] = { { wl_display_get_fd(wayland_display), POLLIN, 0 }, { m_reader_stop_fd, POLLIN, 0 } };
+      int res = poll(fds, 2, -1);
       if (res < 0)
       {
-         WSI_LOG_ERROR("Error while waiting for the compositor to send the next frame event.");
-         return false;
+         wl_display_cancel_read(wayland_display);
+         if (errno == EINTR)
+         {
+            continue;
+         }
+         WSI_LOG_ERROR("Wayland event reader thread failed to poll the display: %d.", errno);
+         return;
+      }
+
+      if (fds[1].revents & POLLIN)
+      {
+         wl_display_cancel_read(wayland_display);
+         return;
+      }
+
+      if (fds[0].revents & POLLIN)
+      {
+         if (wl_display_read_events(wayland_display) < 0)
+         {
+            WSI_LOG_ERROR("Wayland event reader thread failed to read display events.");
+            return;
+         }
+      }
+      else
+      {
+         wl_display_cancel_read(wayland_display);
       }
-      else if (res == 0)
+
+      std::lock_guard<std::mutex> lock(m_reader_mutex);
+      for (auto *queue : m_reader_queues)
       {
-         WSI_LOG_INFO("Wait for frame event timed out, present anyway.");
-         present_pending = false;
+         wl_display_dispatch_queue_pending(wayland_display, queue);
       }
    }
+}
 
-   return true;
+wsi::surface_properties &surface::get_properties()
+{
+   return properties;
+}
+
+util::unique_ptr<swapchain_base> surface::allocate_swapchain(layer::device_private_data &dev_data,
+                                                             const VkAllocationCallbacks *allocator)
+{
+   util::allocator alloc{ dev_data.get_allocator(), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT, allocator };
+   return util::unique_ptr<swapchain_base>(alloc.make_unique<swapchain>(dev_data, allocator, *this));
 }
 
 } // namespace wayland
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, 2024 Arm Limited.
+ * Copyright (c) 2021, 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -38,17 +38,131 @@
 #include "wl_object_owner.hpp"
 #include "util/macros.hpp"
 
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace wsi
 {
 namespace wayland
 {
 
+/* dmabuf-feedback arrived in version 4 of the linux-dmabuf protocol; when built
+ * against an older wayland-protocols the layer falls back to the v3 modifier
+ * events for format advertisement. */
+#if defined(ZWP_LINUX_DMABUF_V1_GET_DEFAULT_FEEDBACK_SINCE_VERSION)
+#define WSI_WAYLAND_HAVE_DMABUF_FEEDBACK 1
+#else
+#define WSI_WAYLAND_HAVE_DMABUF_FEEDBACK 0
+#endif
+
+#if WSI_WAYLAND_HAVE_DMABUF_FEEDBACK
 /**
- * Wayland callback for global wl_registry events to handle global objects required by @ref wsi::wayland::surface
+ * @brief The compositor's binary format table, mmap'd from the dmabuf-feedback format_table event.
+ *
+ * Feedback tranches refer to formats as 16-bit indices into this table, so the
+ * mapping is indexed in place rather than unpacked into a per-format container.
  */
-VWL_CAPI_CALL(void)
-surface_registry_handler(void *data, struct wl_registry *wl_registry, uint32_t name, const char *interface,
-                         uint32_t version) VWL_API_POST;
+struct dmabuf_format_table
+{
+   /** Layout of one table row, fixed by the linux-dmabuf protocol. */
+   struct entry
+   {
+      uint32_t format;
+      uint32_t padding;
+      uint64_t modifier;
+   };
+
+   dmabuf_format_table() = default;
+   dmabuf_format_table(const dmabuf_format_table &) = delete;
+   dmabuf_format_table &operator=(const dmabuf_format_table &) = delete;
+   ~dmabuf_format_table();
+
+   /**
+    * @brief Map the table sent by the compositor, replacing any previous mapping.
+    *
+    * Takes ownership of @p fd and closes it.
+    *
+    * @return true on success, false otherwise.
+    */
+   bool map(int fd, uint32_t size);
+
+   /** The mapped table rows, valid until the struct is destroyed or remapped. */
+   const entry *entries{ nullptr };
+   /** Number of rows in the table. */
+   size_t count{ 0 };
+};
+
+/**
+ * @brief One dmabuf-feedback tranche: a preference-ordered group of format table rows.
+ */
+struct feedback_tranche
+{
+   /** Bitmask of ZWP_LINUX_DMABUF_FEEDBACK_V1_TRANCHE_FLAGS_* reported for the tranche. */
+   uint32_t flags{ 0 };
+   /** Indices into the display's @ref dmabuf_format_table for the formats in the tranche. */
+   std::vector<uint16_t> formats;
+};
+#endif /* WSI_WAYLAND_HAVE_DMABUF_FEEDBACK */
+
+/**
+ * @brief Globals bound from a Wayland display, shared by every surface created on it.
+ *
+ * Binding the globals costs two compositor round trips: one for the registry to
+ * announce them and a second to flush the bind requests and collect the dmabuf
+ * format events, which the compositor only sends in response to the bind. The
+ * bound proxies and the format table depend solely on the display, so they are
+ * cached per wl_display and only the first surface on a display pays for the
+ * round trips.
+ *
+ * The struct is reference counted by the surfaces sharing it; the cache keeps a
+ * weak reference so the proxies are released when the last surface on the
+ * display is destroyed. The members are process-wide state and therefore do not
+ * use the Vulkan instance allocator.
+ */
+struct display_globals
+{
+   /** Queue the globals are bound on. Events for objects created from the
+    *  shared proxies default to this queue unless re-assigned by the creator. */
+   wayland_owner<wl_event_queue> queue;
+
+   /** Container for the zwp_linux_dmabuf_v1 interface binding */
+   wayland_owner<zwp_linux_dmabuf_v1> dmabuf_interface;
+
+   /** Container for the zwp_linux_explicit_synchronization_v1 interface binding */
+   wayland_owner<zwp_linux_explicit_synchronization_v1> explicit_sync_interface;
+
+   /** Container for the wp_presentation interface binding */
+   wayland_owner<wp_presentation> presentation_time_interface;
+
+#if WAYLAND_TEARING_CONTROL_ENABLED
+   /** Container for the wp_tearing_control_manager_v1 interface binding */
+   wayland_owner<wp_tearing_control_manager_v1> tearing_control_manager;
+#endif
+
+   /**
+    * Clock domain the compositor timestamps presentation feedback with, as
+    * reported by wp_presentation's clock_id event. Defaults to CLOCK_MONOTONIC,
+    * which is what every mainstream compositor reports.
+    */
+   uint32_t presentation_clock_id{ CLOCK_MONOTONIC };
+
+   /** DRM formats and modifiers reported through the dmabuf interface. */
+   std::vector<drm_format_pair> supported_formats;
+
+#if WSI_WAYLAND_HAVE_DMABUF_FEEDBACK
+   /**
+    * The compositor's format table, shared by the feedback objects of the display.
+    * Only mapped when #has_feedback is true.
+    */
+   dmabuf_format_table format_table;
+
+   /** True when the compositor implements dmabuf-feedback (linux-dmabuf v4). */
+   bool has_feedback{ false };
+#endif
+};
 
 class surface : public wsi::surface
 {
@@ -97,7 +211,7 @@ public:
     */
    zwp_linux_dmabuf_v1 *get_dmabuf_interface()
    {
-      return dmabuf_interface.get();
+      return globals->dmabuf_interface.get();
    }
 
    /**
@@ -111,6 +225,47 @@ public:
       return surface_sync_interface.get();
    }
 
+   /**
+    * @brief Returns the wp_presentation interface of the display, or nullptr when the compositor lacks it.
+    *
+    * The raw pointer is valid throughout the lifetime of this surface.
+    */
+   wp_presentation *get_presentation_time_interface()
+   {
+      return globals->presentation_time_interface.get();
+   }
+
+   /**
+    * @brief Clock domain of wp_presentation feedback timestamps.
+    *
+    * CLOCK_MONOTONIC unless the compositor reported a different clock.
+    */
+   uint32_t get_presentation_clock_id() const
+   {
+      return globals->presentation_clock_id;
+   }
+
+   /**
+    * @brief Whether the compositor implements wp_tearing_control_v1 for this surface.
+    *
+    * When true VK_PRESENT_MODE_IMMEDIATE_KHR is advertised for the surface and
+    * the swapchain can ask the compositor to scan it out without waiting for
+    * vertical blank. Always false when built against a wayland-protocols that
+    * lacks the tearing-control staging protocol.
+    */
+   bool has_tearing_control() const;
+
+   /**
+    * @brief Set the surface's tearing presentation hint.
+    *
+    * The hint is double-buffered wl_surface state: it takes effect on the next
+    * commit of the surface, which every present performs anyway. A no-op when
+    * the compositor lacks the protocol.
+    *
+    * @param async true requests tearing (async) flips, false restores vsync.
+    */
+   void set_tearing_hint(bool async);
+
    /**
     * @brief Returns a reference to a list of DRM formats supported by the Wayland surface.
     *
@@ -122,21 +277,45 @@ public:
    }
 
    /**
-    * @brief Set the next frame callback.
+    * @brief Check whether the compositor reported a format as scanout-capable for this surface.
     *
-    * Make a frame request on the compositor which will be applied in the next
-    * wl_surface::commit. It overwrites previous requested frame events.
+    * Queries the surface's dmabuf-feedback tranches: a format in a tranche with
+    * the SCANOUT flag can be put on a hardware plane directly, skipping a
+    * composition pass. Always false when the compositor does not implement
+    * dmabuf-feedback.
     *
-    * @return true for success, false otherwise.
+    * @param fourcc   DRM fourcc of the format.
+    * @param modifier DRM modifier of the format.
+    *
+    * @return true when the format is scanout-capable on this surface.
     */
-   bool set_frame_callback();
+   bool supports_scanout(uint32_t fourcc, uint64_t modifier) const;
 
    /**
-    * @brief Wait for the compositor's last requested frame event.
+    * @brief Register a swapchain event queue to be drained by the surface's reader thread.
+    *
+    * The reader thread sleeps on the display file descriptor and dispatches the
+    * registered queues as soon as events arrive, so buffer release events are
+    * observed the moment the compositor sends them rather than at the next
+    * present. The first registration starts the thread.
     *
-    * @return true for success, false otherwise.
+    * @param queue The swapchain's buffer event queue.
+    *
+    * @return true on success, false if the reader thread could not be started. The
+    *         queue is not registered on failure and events on it must be dispatched
+    *         by its owner as before.
     */
-   bool wait_next_frame_event();
+   bool register_swapchain_queue(wl_event_queue *queue);
+
+   /**
+    * @brief Remove a queue registered with register_swapchain_queue().
+    *
+    * Once this returns the reader thread no longer touches the queue, making it
+    * safe to destroy. Stopping the last registered queue stops the thread.
+    *
+    * @param queue The queue to remove.
+    */
+   void unregister_swapchain_queue(wl_event_queue *queue);
 
 private:
    /**
@@ -146,15 +325,32 @@ private:
     */
    bool init();
 
-   friend void surface_registry_handler(void *data, struct wl_registry *wl_registry, uint32_t name,
-                                        const char *interface, uint32_t version) VWL_API_POST;
+   /**
+    * @brief Start the event reader thread. The thread must not be running.
+    *
+    * @return true on success, false otherwise.
+    */
+   bool start_event_reader();
+
+   /**
+    * @brief Stop and join the event reader thread if it is running.
+    */
+   void stop_event_reader();
+
+   /**
+    * @brief Main loop of the event reader thread.
+    *
+    * Follows the libwayland multi-threaded read protocol: prepare a read on one of
+    * the registered queues, sleep on the display file descriptor, read and then
+    * dispatch every registered queue. Exits when woken through #m_reader_stop_fd.
+    */
+   void event_reader_loop();
 
    /** The native Wayland display */
    wl_display *wayland_display;
 
    /**
     * Container for a private queue for surface events generated by the layer.
-    * The queue is also used for dispatching frame callback events.
     * It should be destroyed after the objects that attached to it.
     */
    wayland_owner<wl_event_queue> surface_queue;
@@ -166,34 +362,54 @@ private:
    /** Surface properties specific to the Wayland surface. */
    surface_properties properties;
 
-   /** Container for the zwp_linux_dmabuf_v1 interface binding */
-   wayland_owner<zwp_linux_dmabuf_v1> dmabuf_interface;
+   /**
+    * Globals bound from #wayland_display, shared with every other surface on the
+    * same display through the per-display cache. Holding the reference keeps the
+    * shared proxies alive for the lifetime of this surface.
+    */
+   std::shared_ptr<display_globals> globals;
 
-   /** Container for the zwp_linux_explicit_synchronization_v1 interface binding */
-   wayland_owner<zwp_linux_explicit_synchronization_v1> explicit_sync_interface;
    /** Container for the surface specific zwp_linux_surface_synchronization_v1 interface. */
    wayland_owner<zwp_linux_surface_synchronization_v1> surface_sync_interface;
 
-   /** Container for the wp_presentation interface binding */
-   wayland_owner<wp_presentation> presentation_time_interface;
+#if WAYLAND_TEARING_CONTROL_ENABLED
+   /** Container for the surface specific wp_tearing_control_v1 interface. */
+   wayland_owner<wp_tearing_control_v1> m_tearing_control;
+#endif
 
+#if WSI_WAYLAND_HAVE_DMABUF_FEEDBACK
    /**
-    * Container for a callback object for the latest frame done event.
-    *
-    * The callback object should be destroyed before the queue so any new events
-    * on the queue will be discarded. If a proxy object is destroyed after a queue,
-    * it is possible in the meantime for a new event to arrive and processed.
-    * This will result in a use after free error.
+    * The format table sent on the surface's own feedback object. Tranche indices
+    * are only meaningful against the table of the feedback object that sent
+    * them, so each surface maps its own copy (the mapping shares pages with the
+    * display-wide one when the compositor reuses the fd).
     */
-   wayland_owner<wl_callback> last_frame_callback;
+   dmabuf_format_table m_format_table;
 
    /**
-    * @brief true when waiting for the server hint to present a buffer
-    *
-    * true if a buffer has been presented and we've not had a wl_surface::frame
-    * callback to indicate the server is ready for the next buffer.
+    * Per-surface dmabuf-feedback tranches, indexing #m_format_table. Captured
+    * once at surface creation; the compositor may later resend feedback (e.g. on
+    * a fullscreen transition) but the initial tranches already carry the scanout
+    * capability of the formats, which is all the layer consumes.
     */
-   bool present_pending;
+   std::vector<feedback_tranche> m_feedback_tranches;
+#endif
+
+   /**
+    * Swapchain event queues drained by the reader thread. Guarded by #m_reader_mutex,
+    * which is also held while dispatching so a queue can be unregistered and then
+    * safely destroyed.
+    */
+   util::vector<wl_event_queue *> m_reader_queues;
+
+   /** Guards #m_reader_queues and reader thread start/stop. */
+   std::mutex m_reader_mutex;
+
+   /** Dedicated thread draining the registered buffer event queues. */
+   std::thread m_event_reader;
+
+   /** eventfd used to wake the reader thread for shutdown. */
+   int m_reader_stop_fd{ -1 };
 };
 
 } // namespace wayland
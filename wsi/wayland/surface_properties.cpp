@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, 2021-2025 Arm Limited.
+ * Copyright (c) 2017-2019, 2021-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -51,21 +51,62 @@ namespace wsi
 namespace wayland
 {
 
-void surface_properties::populate_present_mode_compatibilities()
-{
-   std::array<present_mode_compatibility, 2> compatible_present_modes_list = {
-      present_mode_compatibility{ VK_PRESENT_MODE_FIFO_KHR, 1, { VK_PRESENT_MODE_FIFO_KHR } },
-      present_mode_compatibility{ VK_PRESENT_MODE_MAILBOX_KHR, 1, { VK_PRESENT_MODE_MAILBOX_KHR } }
-   };
-   m_compatible_present_modes = compatible_present_modes<2>(compatible_present_modes_list);
-}
+/* FIFO and MAILBOX only differ in per-commit behaviour - whether a frame
+ * callback throttles the next present and whether queued presents may be
+ * replaced - so they can be switched per present without recreating the
+ * swapchain. The relation is fixed for the backend: every surface points at
+ * this table, so the EXT_surface_maintenance1 queries build nothing at
+ * runtime. */
+static constexpr std::array<present_mode_compatibility, 2> COMPATIBLE_PRESENT_MODES = {
+   present_mode_compatibility{ VK_PRESENT_MODE_FIFO_KHR, 2,
+                               { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR } },
+   present_mode_compatibility{ VK_PRESENT_MODE_MAILBOX_KHR, 2,
+                               { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR } }
+};
+
+/* When the compositor implements wp_tearing_control_v1 the surface also offers
+ * IMMEDIATE. The tearing hint is double-buffered wl_surface state sent with the
+ * commit, so IMMEDIATE can be switched per present like the other two modes. */
+static constexpr std::array<present_mode_compatibility, 3> COMPATIBLE_PRESENT_MODES_TEARING = {
+   present_mode_compatibility{
+      VK_PRESENT_MODE_FIFO_KHR,
+      3,
+      { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR } },
+   present_mode_compatibility{
+      VK_PRESENT_MODE_MAILBOX_KHR,
+      3,
+      { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR } },
+   present_mode_compatibility{
+      VK_PRESENT_MODE_IMMEDIATE_KHR,
+      3,
+      { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR } }
+};
+
+/* Mode sets advertised without and with compositor tearing control. */
+static constexpr std::array<VkPresentModeKHR, 2> SUPPORTED_MODES = { VK_PRESENT_MODE_FIFO_KHR,
+                                                                    VK_PRESENT_MODE_MAILBOX_KHR };
+static constexpr std::array<VkPresentModeKHR, 3> SUPPORTED_MODES_TEARING = { VK_PRESENT_MODE_FIFO_KHR,
+                                                                             VK_PRESENT_MODE_MAILBOX_KHR,
+                                                                             VK_PRESENT_MODE_IMMEDIATE_KHR };
 
 surface_properties::surface_properties(surface *wsi_surface, const util::allocator &allocator)
    : specific_surface(wsi_surface)
    , supported_formats(allocator)
-   , m_supported_modes({ VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR })
 {
-   populate_present_mode_compatibilities();
+}
+
+bool surface_properties::supports_tearing_control() const
+{
+   return specific_surface != nullptr && specific_surface->has_tearing_control();
+}
+
+compatible_present_modes surface_properties::get_present_mode_compatibility() const
+{
+   if (supports_tearing_control())
+   {
+      return compatible_present_modes{ COMPATIBLE_PRESENT_MODES_TEARING };
+   }
+   return compatible_present_modes{ COMPATIBLE_PRESENT_MODES };
 }
 
 surface_properties::surface_properties()
@@ -97,12 +138,19 @@ VkResult surface_properties::get_surface_capabilities(VkPhysicalDevice physical_
                                                       const VkPhysicalDeviceSurfaceInfo2KHR *pSurfaceInfo,
                                                       VkSurfaceCapabilities2KHR *pSurfaceCapabilities)
 {
-   TRY(check_surface_present_mode_query_is_supported(pSurfaceInfo, m_supported_modes));
+   if (supports_tearing_control())
+   {
+      TRY(check_surface_present_mode_query_is_supported(pSurfaceInfo, SUPPORTED_MODES_TEARING));
+   }
+   else
+   {
+      TRY(check_surface_present_mode_query_is_supported(pSurfaceInfo, SUPPORTED_MODES));
+   }
 
    /* Image count limits */
    get_surface_capabilities(physical_device, &pSurfaceCapabilities->surfaceCapabilities);
 
-   m_compatible_present_modes.get_surface_present_mode_compatibility_common(pSurfaceInfo, pSurfaceCapabilities);
+   get_present_mode_compatibility().get_surface_present_mode_compatibility_common(pSurfaceInfo, pSurfaceCapabilities);
 
    auto surface_scaling_capabilities = util::find_extension<VkSurfacePresentScalingCapabilitiesEXT>(
       VK_STRUCTURE_TYPE_SURFACE_PRESENT_SCALING_CAPABILITIES_EXT, pSurfaceCapabilities);
@@ -243,7 +291,11 @@ VkResult surface_properties::get_surface_present_modes(VkPhysicalDevice physical
    UNUSED(physical_device);
    UNUSED(surface);
 
-   return get_surface_present_modes_common(pPresentModeCount, pPresentModes, m_supported_modes);
+   if (supports_tearing_control())
+   {
+      return get_surface_present_modes_common(pPresentModeCount, pPresentModes, SUPPORTED_MODES_TEARING);
+   }
+   return get_surface_present_modes_common(pPresentModeCount, pPresentModes, SUPPORTED_MODES);
 }
 
 VkResult surface_properties::get_required_device_extensions(util::extension_list &extension_list)
@@ -414,7 +466,7 @@ void surface_properties::get_surface_present_scaling_and_gravity(
 
 bool surface_properties::is_compatible_present_modes(VkPresentModeKHR present_mode_a, VkPresentModeKHR present_mode_b)
 {
-   return m_compatible_present_modes.is_compatible_present_modes(present_mode_a, present_mode_b);
+   return get_present_mode_compatibility().is_compatible_present_modes(present_mode_a, present_mode_b);
 }
 
 #if VULKAN_WSI_LAYER_EXPERIMENTAL
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, 2021-2024 Arm Limited.
+ * Copyright (c) 2017-2019, 2021-2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -87,13 +87,17 @@ private:
    /** Set of supported Vulkan formats by the @ref specific_surface. */
    surface_format_properties_map supported_formats;
 
-   /* List of supported presentation modes */
-   std::array<VkPresentModeKHR, 2> m_supported_modes;
-
-   /* Stores compatible presentation modes */
-   compatible_present_modes<2> m_compatible_present_modes;
+   /**
+    * @brief Whether the surface's compositor implements wp_tearing_control_v1.
+    *
+    * IMMEDIATE is only advertised when it does; otherwise the mode would
+    * silently behave like FIFO under the compositor's vsync. Always false for
+    * the generic instance, which has no surface to consult.
+    */
+   bool supports_tearing_control() const;
 
-   void populate_present_mode_compatibilities() override;
+   /** View of the constexpr compatibility table matching the advertised mode set. */
+   compatible_present_modes get_present_mode_compatibility() const;
 
    void get_surface_present_scaling_and_gravity(VkSurfacePresentScalingCapabilitiesEXT *scaling_capabilities) override;
 };
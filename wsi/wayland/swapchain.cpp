@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2025 Arm Limited.
+ * Copyright (c) 2017-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -25,11 +25,14 @@
 #define VK_USE_PLATFORM_WAYLAND_KHR 1
 
 #include "surface_properties.hpp"
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <cassert>
 #include <unistd.h>
 #include <cstdlib>
+#include <ctime>
 #include <cerrno>
 #include <cstdio>
 #include <climits>
@@ -41,6 +44,7 @@
 #include "util/helpers.hpp"
 #include "util/log.hpp"
 #include "util/macros.hpp"
+#include "util/usdt.hpp"
 #include "wl_helpers.hpp"
 
 #include <wsi/extensions/image_compression_control.hpp>
@@ -48,6 +52,7 @@
 #include <wsi/extensions/swapchain_maintenance.hpp>
 
 #include "present_timing_handler.hpp"
+#include <wsi/swapchain_present_loop.hpp>
 
 namespace wsi
 {
@@ -65,17 +70,57 @@ swapchain::swapchain(layer::device_private_data &dev_data, const VkAllocationCal
    , m_image_creation_parameters({}, m_allocator, {}, {})
 {
    m_image_create_info.format = VK_FORMAT_UNDEFINED;
+   select_present_loop<swapchain>();
 }
 
 swapchain::~swapchain()
 {
+   /* Make sure the surface's reader thread can no longer dispatch events for this
+    * swapchain before any of its state is torn down. */
+   if (m_buffer_queue_registered)
+   {
+      m_wsi_surface->unregister_swapchain_queue(m_buffer_queue);
+      m_buffer_queue_registered = false;
+   }
+
    teardown();
 
+   /* Restore the vsync hint so a future swapchain on this surface does not
+    * inherit tearing; the reset latches on the surface's next commit. */
+   if (m_tearing_hint_async)
+   {
+      m_wsi_surface->set_tearing_hint(false);
+   }
+
    if (m_wsi_allocator != nullptr)
    {
       wsialloc_delete(m_wsi_allocator);
    }
    m_wsi_allocator = nullptr;
+
+   /* The images hold their own duplicates, closed with their external memory
+    * during teardown() above. */
+   if (m_slab_fd >= 0)
+   {
+      close(m_slab_fd);
+      m_slab_fd = -1;
+   }
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   /* The compositor never answered these; destroy the feedback objects before
+    * the queue they are tracked on. */
+   for (auto &request : m_feedback_requests)
+   {
+      if (request.feedback != nullptr)
+      {
+         wp_presentation_feedback_destroy(request.feedback);
+         request.feedback = nullptr;
+      }
+   }
+#endif
+
+   /* The frame callback is attached to m_buffer_queue, destroy it first. */
+   m_frame_callback.reset();
    if (m_buffer_queue != nullptr)
    {
       wl_event_queue_destroy(m_buffer_queue);
@@ -121,7 +166,11 @@ VkResult swapchain::add_required_extensions(VkDevice device, const VkSwapchainCr
    bool swapchain_support_enabled = swapchain_create_info->flags & VK_SWAPCHAIN_CREATE_PRESENT_TIMING_BIT_EXT;
    if (swapchain_support_enabled)
    {
-      if (!add_swapchain_extension(wsi_ext_present_timing_wayland::create(m_allocator)))
+      /* The feedback-backed time domain is only meaningful when the compositor
+       * clocks its wp_presentation feedback with CLOCK_MONOTONIC. */
+      bool monotonic_feedback_clock = m_wsi_surface->get_presentation_time_interface() != nullptr &&
+                                      m_wsi_surface->get_presentation_clock_id() == CLOCK_MONOTONIC;
+      if (!add_swapchain_extension(wsi_ext_present_timing_wayland::create(m_allocator, monotonic_feedback_clock)))
       {
          return VK_ERROR_OUT_OF_HOST_MEMORY;
       }
@@ -150,6 +199,15 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
       return VK_ERROR_INITIALIZATION_FAILED;
    }
 
+   /* Hand the queue to the surface's reader thread so buffer release events are
+    * dispatched as soon as the compositor sends them. If this fails the events
+    * are still picked up by the dispatch in get_free_buffer, just later. */
+   m_buffer_queue_registered = m_wsi_surface->register_swapchain_queue(m_buffer_queue);
+   if (!m_buffer_queue_registered)
+   {
+      WSI_LOG_WARNING("Buffer release events will only be dispatched on demand.");
+   }
+
    WSIALLOC_ASSERT_VERSION();
    if (wsialloc_new(&m_wsi_allocator) != WSIALLOC_ERROR_NONE)
    {
@@ -158,12 +216,13 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
    }
 
    /*
-    * When VK_PRESENT_MODE_MAILBOX_KHR has been chosen by the application we don't
-    * initialize the page flip thread so the present_image function can be called
-    * during vkQueuePresent.
+    * When VK_PRESENT_MODE_MAILBOX_KHR or VK_PRESENT_MODE_IMMEDIATE_KHR has been
+    * chosen by the application we don't initialize the page flip thread so the
+    * present_image function can be called during vkQueuePresent.
     */
-   use_presentation_thread =
-      WAYLAND_FIFO_PRESENTATION_THREAD_ENABLED && (m_present_mode != VK_PRESENT_MODE_MAILBOX_KHR);
+   use_presentation_thread = WAYLAND_FIFO_PRESENTATION_THREAD_ENABLED &&
+                             (m_present_mode != VK_PRESENT_MODE_MAILBOX_KHR) &&
+                             (m_present_mode != VK_PRESENT_MODE_IMMEDIATE_KHR);
 
    return VK_SUCCESS;
 }
@@ -307,6 +366,19 @@ VkResult swapchain::get_surface_compatible_formats(const VkImageCreateInfo &info
       }
    }
 
+   /* The allocator picks from the candidates in order, so rank them: modifiers the
+    * compositor reports as scanout-capable for this surface (dmabuf-feedback
+    * tranches) come first - allocating one lets the compositor put the buffer
+    * on a hardware plane and skip a composition pass - followed by compressed
+    * layouts and then linear, with the bandwidth estimate breaking ties. */
+   std::stable_sort(importable_formats.begin(), importable_formats.end(),
+                    [this](const wsialloc_format &lhs, const wsialloc_format &rhs) {
+                       return util::drm::modifier_score(lhs.fourcc, lhs.modifier,
+                                                        m_wsi_surface->supports_scanout(lhs.fourcc, lhs.modifier)) >
+                              util::drm::modifier_score(rhs.fourcc, rhs.modifier,
+                                                        m_wsi_surface->supports_scanout(rhs.fourcc, rhs.modifier));
+                    });
+
    return VK_SUCCESS;
 }
 
@@ -337,6 +409,11 @@ VkResult swapchain::allocate_wsialloc(VkImageCreateInfo &image_create_info, wayl
       }
    }
 
+   if (m_opportunistic_compression)
+   {
+      allocation_flags |= WSIALLOC_ALLOCATE_HIGHEST_FIXED_RATE_COMPRESSION;
+   }
+
    wsialloc_allocate_info alloc_info = { importable_formats.data(), static_cast<unsigned>(importable_formats.size()),
                                          image_create_info.extent.width, image_create_info.extent.height,
                                          allocation_flags };
@@ -409,15 +486,126 @@ static VkResult fill_image_create_info(VkImageCreateInfo &image_create_info,
    return VK_SUCCESS;
 }
 
+void swapchain::try_allocate_slab()
+{
+   m_slab_attempted = true;
+
+   /* Sub-allocating images out of one buffer is only sound for linear
+    * single-planar formats, where every row is self-contained: a run of rows
+    * starting at any stride-aligned offset is itself a valid image. Tiled or
+    * compressed modifiers lay out superblocks and metadata across the whole
+    * buffer, so their images must stay one allocation each. */
+   const auto &fmt = m_image_creation_parameters.m_allocated_format;
+   const uint32_t image_count = static_cast<uint32_t>(m_swapchain_images.size());
+   if (image_count < 2 || fmt.modifier != DRM_FORMAT_MOD_LINEAR ||
+       util::drm::drm_fourcc_format_get_num_planes(fmt.fourcc) != 1 ||
+       m_image_creation_parameters.m_image_layout.empty())
+   {
+      return;
+   }
+
+   /* Pad each image to a multiple of 64 rows: together with the allocator's
+    * 64-byte stride alignment this makes every image offset page aligned, so
+    * any VkMemoryRequirements::alignment of the imported memory is met. */
+   const uint32_t height = m_image_create_info.extent.height;
+   const uint32_t slot_rows = (height + 63) & ~63u;
+   if (slot_rows > UINT32_MAX / image_count)
+   {
+      return;
+   }
+
+   bool is_protected_memory = (m_image_create_info.flags & VK_IMAGE_CREATE_PROTECTED_BIT) != 0;
+   wsialloc_format slab_format = fmt;
+   wsialloc_allocate_info alloc_info = { &slab_format, 1, m_image_create_info.extent.width, slot_rows * image_count,
+                                         is_protected_memory ? WSIALLOC_ALLOCATE_PROTECTED : 0 };
+
+   wsialloc_allocate_result alloc_result = { {}, { 0 }, { 0 }, { -1 }, false };
+   for (int i = 0; i < WSIALLOC_MAX_PLANES; ++i)
+   {
+      alloc_result.buffer_fds[i] = -1;
+      alloc_result.average_row_strides[i] = -1;
+   }
+   if (wsialloc_alloc(m_wsi_allocator, &alloc_info, &alloc_result) != WSIALLOC_ERROR_NONE)
+   {
+      WSI_LOG_WARNING("Slab allocation for %u swapchain images failed, falling back to per-image allocations.",
+                      image_count);
+      return;
+   }
+
+   /* The stride the allocator picked for the taller buffer must match the one
+    * baked into the VkImage plane layout by the initial no-memory allocation,
+    * and the offsets it implies must stay page aligned. */
+   const int stride = alloc_result.average_row_strides[0];
+   if (alloc_result.format.fourcc != fmt.fourcc || alloc_result.format.modifier != fmt.modifier ||
+       alloc_result.is_disjoint || stride <= 0 || (stride & 63) != 0 ||
+       static_cast<VkDeviceSize>(stride) != m_image_creation_parameters.m_image_layout[0].rowPitch ||
+       static_cast<uint64_t>(stride) * slot_rows * image_count > UINT32_MAX)
+   {
+      for (int fd : alloc_result.buffer_fds)
+      {
+         if (fd >= 0)
+         {
+            close(fd);
+         }
+      }
+      return;
+   }
+
+   m_slab_fd = alloc_result.buffer_fds[0];
+   m_slab_stride = stride;
+   m_slab_image_size = static_cast<uint32_t>(stride) * slot_rows;
+   m_slab_base_offset = alloc_result.offsets[0];
+   m_slab_next_image = 0;
+   m_slab_image_count = image_count;
+}
+
+VkResult swapchain::allocate_image_from_slab(wayland_image_data *image_data)
+{
+   /* external_memory owns and closes its fds, so each image gets its own
+    * duplicate of the slab fd. */
+   int fd = dup(m_slab_fd);
+   if (fd < 0)
+   {
+      WSI_LOG_ERROR("Failed to duplicate slab fd: %s", std::strerror(errno));
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   auto &external_memory = image_data->external_mem;
+   external_memory.set_buffer_fds(std::array<int, MAX_PLANES>{ fd, -1, -1, -1 });
+   external_memory.set_strides(std::array<int, MAX_PLANES>{ m_slab_stride, -1, -1, -1 });
+   external_memory.set_offsets(
+      std::array<uint32_t, MAX_PLANES>{ m_slab_base_offset + m_slab_next_image * m_slab_image_size, 0, 0, 0 });
+   external_memory.set_num_memories(1);
+   external_memory.set_format_info(false, 1);
+   external_memory.set_memory_handle_type(VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT);
+
+   m_slab_next_image++;
+   return VK_SUCCESS;
+}
+
 VkResult swapchain::allocate_image(wayland_image_data *image_data)
 {
+   /* The image count and format are both settled by the time the first image
+    * is allocated, so this is the earliest point the slab can be sized. */
+   if (!m_slab_attempted)
+   {
+      try_allocate_slab();
+   }
+   if (m_slab_fd >= 0 && m_slab_next_image < m_slab_image_count)
+   {
+      return allocate_image_from_slab(image_data);
+   }
+
    util::vector<wsialloc_format> importable_formats(util::allocator(m_allocator, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND));
-   auto &m_allocated_format = m_image_creation_parameters.m_allocated_format;
-   if (!importable_formats.try_push_back(m_allocated_format))
+   /* Work on a local copy of the allocated format: the allocator is constrained to the format already selected for
+    * the swapchain, so the result cannot differ, and concurrent allocations must not rewrite the shared parameters. */
+   wsialloc_format allocated_format = m_image_creation_parameters.m_allocated_format;
+   if (!importable_formats.try_push_back(allocated_format))
    {
       return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
-   TRY_LOG_CALL(allocate_wsialloc(m_image_create_info, image_data, importable_formats, &m_allocated_format, false));
+   TRY_LOG_CALL(allocate_wsialloc(m_image_create_info, image_data, importable_formats, &allocated_format, false));
+   assert(allocated_format.fourcc == m_image_creation_parameters.m_allocated_format.fourcc);
 
    return VK_SUCCESS;
 }
@@ -457,13 +645,16 @@ VkResult swapchain::create_wl_buffer(const VkImageCreateInfo &image_create_info,
 
 VkResult swapchain::allocate_and_bind_swapchain_image(VkImageCreateInfo image_create_info, swapchain_image &image)
 {
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
    image.status = swapchain_image::FREE;
 
    assert(image.data != nullptr);
    auto image_data = static_cast<wayland_image_data *>(image.data);
-   TRY_LOG(allocate_image(image_data), "Failed to allocate image");
-   image_status_lock.unlock();
+   {
+      /* The wsialloc allocator is shared between the images, so concurrent
+       * allocation worker threads must serialize their allocate_image calls. */
+      const std::lock_guard<std::mutex> lock(m_image_allocation_mutex);
+      TRY_LOG(allocate_image(image_data), "Failed to allocate image");
+   }
 
    TRY_LOG(create_wl_buffer(image_create_info, image, image_data), "Failed to create wl_buffer");
 
@@ -484,7 +675,7 @@ VkResult swapchain::allocate_and_bind_swapchain_image(VkImageCreateInfo image_cr
 VkResult swapchain::create_swapchain_image(VkImageCreateInfo image_create_info, swapchain_image &image)
 {
    /* Create image_data */
-   auto image_data = m_allocator.create<wayland_image_data>(1, m_device, m_allocator);
+   auto image_data = create_image_data<wayland_image_data>(m_device, m_allocator);
    if (image_data == nullptr)
    {
       return VK_ERROR_OUT_OF_HOST_MEMORY;
@@ -512,7 +703,34 @@ VkResult swapchain::create_swapchain_image(VkImageCreateInfo image_create_info,
       }
 
       wsialloc_format allocated_format = { 0, 0, 0 };
-      TRY_LOG_CALL(allocate_wsialloc(image_create_info, image_data, importable_formats, &allocated_format, true));
+
+      /* Opportunistic fixed-rate compression: when the application leaves image
+       * compression unspecified, probe for a compressed candidate first with a
+       * no-memory allocation.  importable_formats is already restricted to the
+       * compositor's dmabuf format table, so the probe only succeeds with a
+       * modifier the compositor can consume; if the allocator has no compressed
+       * candidate we fall back to the normal selection.  Display bandwidth is
+       * the dominant power/perf cost at high resolutions, so compressed scanout
+       * is preferred whenever both sides support it. */
+      bool compression_specified = false;
+      if (m_device_data.is_swapchain_compression_control_enabled())
+      {
+         compression_specified = get_swapchain_extension<wsi_ext_image_compression_control>() != nullptr;
+      }
+      if (!compression_specified)
+      {
+         m_opportunistic_compression = true;
+         if (allocate_wsialloc(image_create_info, image_data, importable_formats, &allocated_format, true) !=
+             VK_SUCCESS)
+         {
+            WSI_LOG_INFO("No fixed-rate compressed format candidate, using uncompressed allocation.");
+            m_opportunistic_compression = false;
+         }
+      }
+      if (!m_opportunistic_compression)
+      {
+         TRY_LOG_CALL(allocate_wsialloc(image_create_info, image_data, importable_formats, &allocated_format, true));
+      }
 
       for (auto &prop : drm_format_props)
       {
@@ -533,14 +751,218 @@ VkResult swapchain::create_swapchain_image(VkImageCreateInfo image_create_info,
    return m_device_data.disp.CreateImage(m_device, &m_image_create_info, get_allocation_callbacks(), &image.image);
 }
 
+VWL_CAPI_CALL(void) frame_done(void *data, wl_callback *cb, uint32_t cb_data) VWL_API_POST
+{
+   UNUSED(cb);
+   UNUSED(cb_data);
+
+   auto sc = reinterpret_cast<swapchain *>(data);
+   sc->on_frame_done();
+}
+
+static const wl_callback_listener frame_listener = { frame_done };
+
+void swapchain::on_frame_done()
+{
+   std::lock_guard<std::mutex> lock(m_frame_pending_mutex);
+   m_frame_pending = false;
+   m_frame_pending_cond.notify_one();
+}
+
+bool swapchain::set_frame_callback()
+{
+   /* Request a hint for when we can present the _next_ frame. The callback is
+    * created through a wrapper so its event is delivered on the buffer queue. */
+   auto surface_proxy = make_proxy_with_queue(m_surface, m_buffer_queue);
+   if (surface_proxy == nullptr)
+   {
+      WSI_LOG_ERROR("failed to create wl_surface proxy");
+      return false;
+   }
+
+   /* Reset will also destroy the previous callback object. */
+   m_frame_callback.reset(wl_surface_frame(surface_proxy.get()));
+   if (m_frame_callback.get() == nullptr)
+   {
+      WSI_LOG_ERROR("Failed to create frame callback.");
+      return false;
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(m_frame_pending_mutex);
+      m_frame_pending = true;
+   }
+   int res = wl_callback_add_listener(m_frame_callback.get(), &frame_listener, this);
+   if (res < 0)
+   {
+      WSI_LOG_ERROR("Failed to add frame done callback listener.");
+      return false;
+   }
+
+   return true;
+}
+
+bool swapchain::wait_frame_event()
+{
+   /* If the compositor isn't sending us frame events at least every second we
+    * don't wait indefinitely so we don't block the next image presentation if
+    * we are, e.g. minimised. */
+   const int timeout_ms = 1000;
+
+   std::unique_lock<std::mutex> lock(m_frame_pending_mutex);
+   while (m_frame_pending)
+   {
+      if (m_buffer_queue_registered)
+      {
+         /* The reader thread dispatches the buffer queue, just wait for the signal. */
+         if (m_frame_pending_cond.wait_for(lock, std::chrono::milliseconds(timeout_ms)) == std::cv_status::timeout)
+         {
+            WSI_LOG_INFO("Wait for frame event timed out, present anyway.");
+            m_frame_pending = false;
+         }
+      }
+      else
+      {
+         /* No reader thread: dispatch the buffer queue ourselves, as get_free_buffer does. */
+         lock.unlock();
+         int res = dispatch_queue(m_display, m_buffer_queue, timeout_ms);
+         lock.lock();
+         if (res < 0)
+         {
+            WSI_LOG_ERROR("Error while waiting for the compositor to send the next frame event.");
+            return false;
+         }
+         else if (res == 0)
+         {
+            WSI_LOG_INFO("Wait for frame event timed out, present anyway.");
+            m_frame_pending = false;
+         }
+      }
+   }
+
+   return true;
+}
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+VWL_CAPI_CALL(void)
+presentation_feedback_sync_output(void *data, struct wp_presentation_feedback *feedback,
+                                  struct wl_output *output) VWL_API_POST
+{
+   UNUSED(data);
+   UNUSED(feedback);
+   UNUSED(output);
+}
+
+VWL_CAPI_CALL(void)
+presentation_feedback_presented(void *data, struct wp_presentation_feedback *feedback, uint32_t tv_sec_hi,
+                                uint32_t tv_sec_lo, uint32_t tv_nsec, uint32_t refresh, uint32_t seq_hi,
+                                uint32_t seq_lo, uint32_t flags) VWL_API_POST
+{
+   UNUSED(feedback);
+   UNUSED(seq_hi);
+   UNUSED(seq_lo);
+   UNUSED(flags);
+
+   auto *request = reinterpret_cast<swapchain::presentation_feedback_request *>(data);
+   uint64_t time_ns =
+      ((static_cast<uint64_t>(tv_sec_hi) << 32) | tv_sec_lo) * 1000000000ull + static_cast<uint64_t>(tv_nsec);
+   request->owner->on_presentation_feedback(*request, time_ns, refresh, true);
+}
+
+VWL_CAPI_CALL(void)
+presentation_feedback_discarded(void *data, struct wp_presentation_feedback *feedback) VWL_API_POST
+{
+   UNUSED(feedback);
+
+   auto *request = reinterpret_cast<swapchain::presentation_feedback_request *>(data);
+   request->owner->on_presentation_feedback(*request, 0, 0, false);
+}
+
+static const wp_presentation_feedback_listener presentation_feedback_listener = {
+   presentation_feedback_sync_output,
+   presentation_feedback_presented,
+   presentation_feedback_discarded,
+};
+
+void swapchain::on_presentation_feedback(presentation_feedback_request &request, uint64_t time_ns, uint32_t refresh_ns,
+                                         bool presented)
+{
+   auto *ext = get_swapchain_extension<wsi_ext_present_timing_wayland>();
+   if (ext != nullptr)
+   {
+      ext->handle_presentation_feedback(time_ns, refresh_ns, presented);
+   }
+
+   wp_presentation_feedback_destroy(request.feedback);
+   request.feedback = nullptr;
+   request.active.store(false, std::memory_order_release);
+}
+
+void swapchain::request_presentation_feedback()
+{
+   if (get_swapchain_extension<wsi_ext_present_timing_wayland>() == nullptr ||
+       m_wsi_surface->get_presentation_time_interface() == nullptr)
+   {
+      return;
+   }
+
+   /* Claim a request slot. The events release slots from Wayland dispatch, so
+    * claiming has to be an atomic handover; if the compositor is sitting on
+    * every slot's answer the frame simply goes untimed. */
+   presentation_feedback_request *request = nullptr;
+   for (auto &slot : m_feedback_requests)
+   {
+      bool expected = false;
+      if (slot.active.compare_exchange_strong(expected, true, std::memory_order_acquire))
+      {
+         request = &slot;
+         break;
+      }
+   }
+   if (request == nullptr)
+   {
+      return;
+   }
+
+   /* Route the feedback events to the buffer queue, so they are delivered by
+    * the surface's reader thread (or the dispatch in get_free_buffer) along
+    * with buffer releases - no extra round trips. */
+   auto presentation_proxy = make_proxy_with_queue(m_wsi_surface->get_presentation_time_interface(), m_buffer_queue);
+   if (presentation_proxy == nullptr)
+   {
+      request->active.store(false, std::memory_order_release);
+      return;
+   }
+
+   request->owner = this;
+   request->feedback = wp_presentation_feedback(presentation_proxy.get(), m_surface);
+   if (request->feedback == nullptr)
+   {
+      request->active.store(false, std::memory_order_release);
+      return;
+   }
+
+   if (wp_presentation_feedback_add_listener(request->feedback, &presentation_feedback_listener, request) < 0)
+   {
+      wp_presentation_feedback_destroy(request->feedback);
+      request->feedback = nullptr;
+      request->active.store(false, std::memory_order_release);
+   }
+}
+#endif
+
 void swapchain::present_image(const pending_present_request &pending_present)
 {
+   WSI_USDT3(present_submit, this, pending_present.image_index, pending_present.present_id);
+
    int res;
    wayland_image_data *image_data =
       reinterpret_cast<wayland_image_data *>(m_swapchain_images[pending_present.image_index].data);
 
-   /* if a frame is already pending, wait for a hint to present again */
-   if (!m_wsi_surface->wait_next_frame_event())
+   /* Gate the commit on the previous frame callback: the compositor holds at
+    * most one queued buffer and later frames wait in the layer's pending buffer
+    * pool instead, where mailbox-style replacement can still drop them. */
+   if (!wait_frame_event())
    {
       set_error_state(VK_ERROR_SURFACE_LOST_KHR);
    }
@@ -562,17 +984,48 @@ void swapchain::present_image(const pending_present_request &pending_present)
       }
    }
 
-   /* TODO: work out damage */
-   wl_surface_damage(m_surface, 0, 0, INT32_MAX, INT32_MAX);
+   /* VkRectLayerKHR rectangles are in buffer coordinates, matching wl_surface_damage_buffer. Fall back to
+    * full-surface damage when the application gave no rectangles or the compositor's wl_surface is too old. */
+   if (pending_present.damage_rect_count > 0 &&
+       wl_proxy_get_version(reinterpret_cast<wl_proxy *>(m_surface)) >= WL_SURFACE_DAMAGE_BUFFER_SINCE_VERSION)
+   {
+      for (uint32_t i = 0; i < pending_present.damage_rect_count; i++)
+      {
+         const VkRectLayerKHR &rect = pending_present.damage_rects[i];
+         assert(rect.extent.width <= INT32_MAX && rect.extent.height <= INT32_MAX);
+         wl_surface_damage_buffer(m_surface, rect.offset.x, rect.offset.y, rect.extent.width, rect.extent.height);
+      }
+   }
+   else
+   {
+      wl_surface_damage(m_surface, 0, 0, INT32_MAX, INT32_MAX);
+   }
 
    if (m_present_mode == VK_PRESENT_MODE_FIFO_KHR)
    {
-      if (!m_wsi_surface->set_frame_callback())
+      if (!set_frame_callback())
       {
          set_error_state(VK_ERROR_SURFACE_LOST_KHR);
       }
    }
 
+   /* The tearing hint is double-buffered wl_surface state, so it rides on the
+    * commit below. Only re-send it when the effective mode changes - present
+    * modes can be switched per present with swapchain maintenance. */
+   bool want_async_hint = m_present_mode == VK_PRESENT_MODE_IMMEDIATE_KHR;
+   if (want_async_hint != m_tearing_hint_async && m_wsi_surface->has_tearing_control())
+   {
+      m_wsi_surface->set_tearing_hint(want_async_hint);
+      m_tearing_hint_async = want_async_hint;
+   }
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   /* Ask the compositor to report when (or whether) this commit reaches the
+    * screen. The request rides on the commit below and its events arrive on
+    * the buffer queue with the buffer releases. */
+   request_presentation_feedback();
+#endif
+
    wl_surface_commit(m_surface);
    res = wl_display_flush(m_display);
    if (res < 0)
@@ -591,21 +1044,18 @@ void swapchain::present_image(const pending_present_request &pending_present)
 
 void swapchain::destroy_image(swapchain_image &image)
 {
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
-
-   if (image.status != swapchain_image::INVALID)
+   /* Move the status to INVALID atomically: only the caller whose exchange
+    * observes a different previous state tears the VkImage down, which keeps
+    * destroy_image safe to reach twice for the same image. */
+   if (image.status.exchange(swapchain_image::INVALID) != swapchain_image::INVALID)
    {
       if (image.image != VK_NULL_HANDLE)
       {
          m_device_data.disp.DestroyImage(m_device, image.image, get_allocation_callbacks());
          image.image = VK_NULL_HANDLE;
       }
-
-      image.status = swapchain_image::INVALID;
    }
 
-   image_status_lock.unlock();
-
    if (image.data != nullptr)
    {
       auto image_data = reinterpret_cast<wayland_image_data *>(image.data);
@@ -613,7 +1063,7 @@ void swapchain::destroy_image(swapchain_image &image)
       {
          wl_buffer_destroy(image_data->buffer);
       }
-      m_allocator.destroy(1, image_data);
+      destroy_image_data(image_data);
       image.data = nullptr;
    }
 }
@@ -643,6 +1093,13 @@ VkResult swapchain::get_free_buffer(uint64_t *timeout)
       ms_timeout = *timeout / 1000llu / 1000llu;
    }
 
+   /* The surface's reader thread may have already dispatched the release event. */
+   if (free_image_found())
+   {
+      *timeout = 0;
+      return VK_SUCCESS;
+   }
+
    /* The current dispatch_queue implementation will return if any
     * events are returned, even if no events are dispatched to the buffer
     * queue. Therefore dispatch repeatedly until a buffer has been freed.
@@ -659,6 +1116,14 @@ VkResult swapchain::get_free_buffer(uint64_t *timeout)
    }
    else if (res == 0)
    {
+      /* The release event may have been dispatched by the reader thread while we
+       * were waiting on the display, which leaves nothing for this queue. */
+      if (free_image_found())
+      {
+         *timeout = 0;
+         return VK_SUCCESS;
+      }
+
       if (*timeout == 0)
       {
          return VK_NOT_READY;
@@ -674,6 +1139,12 @@ VkResult swapchain::get_free_buffer(uint64_t *timeout)
    }
 }
 
+bool swapchain::fill_captured_frame(uint32_t image_index, VkCapturedFrameWSI &frame)
+{
+   auto *image_data = reinterpret_cast<wayland_image_data *>(m_swapchain_images[image_index].data);
+   return fill_captured_frame_from_dmabuf(image_data->external_mem, image_data->present_fence, frame);
+}
+
 VkResult swapchain::image_set_present_payload(swapchain_image &image, VkQueue queue,
                                               const queue_submit_semaphores &semaphores, const void *submission_pnext)
 {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2025 Arm Limited.
+ * Copyright (c) 2017-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -43,6 +43,11 @@ extern "C" {
 
 #include <wsi/external_memory.hpp>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 namespace wsi
 {
 namespace wayland
@@ -79,7 +84,7 @@ struct image_creation_parameters
    }
 };
 
-class swapchain : public wsi::swapchain_base
+class swapchain final : public wsi::swapchain_base
 {
 public:
    explicit swapchain(layer::device_private_data &dev_data, const VkAllocationCallbacks *allocator,
@@ -90,6 +95,45 @@ public:
    /* TODO: make the buffer destructor a friend? so this can be protected */
    void release_buffer(struct wl_buffer *wl_buffer);
 
+   /**
+    * @brief Called by the frame callback listener when the compositor hints the next frame can be drawn.
+    */
+   void on_frame_done();
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   /**
+    * @brief One in-flight wp_presentation feedback request.
+    *
+    * Slots are claimed on the presentation thread and released from Wayland
+    * event dispatch when the compositor answers, so requesting feedback never
+    * allocates on the present path.
+    */
+   struct presentation_feedback_request
+   {
+      /** Swapchain the request was issued for. */
+      swapchain *owner{ nullptr };
+      /** The feedback object, destroyed by the event that ends the request. */
+      wp_presentation_feedback *feedback{ nullptr };
+      /** True from claim until the presented/discarded event releases the slot. */
+      std::atomic<bool> active{ false };
+   };
+
+   /**
+    * @brief Called by the feedback listener when the compositor reports on a frame.
+    *
+    * Feeds the event into the present timing extension, destroys the feedback
+    * object and releases the slot.
+    *
+    * @param request    The request the event answers.
+    * @param time_ns    First-pixel-visible timestamp in nanoseconds; only
+    *                   meaningful when @p presented is true.
+    * @param refresh_ns Compositor-reported refresh duration in nanoseconds.
+    * @param presented  True for a presented event, false for discarded.
+    */
+   void on_presentation_feedback(presentation_feedback_request &request, uint64_t time_ns, uint32_t refresh_ns,
+                                 bool presented);
+#endif
+
 protected:
    /**
     * @brief Initialize platform specifics.
@@ -128,6 +172,11 @@ protected:
     */
    void present_image(const pending_present_request &pending_present) override;
 
+   /**
+    * @brief Fill a captured frame with the dmabuf handles backing an image.
+    */
+   bool fill_captured_frame(uint32_t image_index, VkCapturedFrameWSI &frame) override;
+
    /**
     * @brief Method to release a swapchain image
     *
@@ -181,6 +230,18 @@ protected:
    VkResult bind_swapchain_image(VkDevice &device, const VkBindImageMemoryInfo *bind_image_mem_info,
                                  const VkBindImageMemorySwapchainInfoKHR *bind_sc_info) override;
 
+   /**
+    * @brief The Wayland backend supports concurrent image allocation.
+    *
+    * allocate_and_bind_swapchain_image only touches per-image state, except for
+    * the shared wsialloc allocator which allocate_image serializes under
+    * m_image_allocation_mutex.
+    */
+   bool can_allocate_images_concurrently() const override
+   {
+      return true;
+   }
+
 private:
    VkResult create_wl_buffer(const VkImageCreateInfo &image_create_info, swapchain_image &image,
                              wayland_image_data *image_data);
@@ -189,6 +250,23 @@ private:
                               util::vector<wsialloc_format> &importable_formats, wsialloc_format *allocated_format,
                               bool avoid_allocation);
 
+   /**
+    * @brief Try to allocate one slab dmabuf backing all swapchain images.
+    *
+    * Runs once, on the first allocate_image call, when the image count and the
+    * selected format are known. Failure is soft: the images fall back to one
+    * allocation each. Must be called with m_image_allocation_mutex held.
+    */
+   void try_allocate_slab();
+
+   /**
+    * @brief Sub-allocate the next image from the slab dmabuf.
+    *
+    * Hands the image a dup of the slab fd and its page-aligned byte offset
+    * within it. Must be called with m_image_allocation_mutex held.
+    */
+   VkResult allocate_image_from_slab(wayland_image_data *image_data);
+
    /**
     * @brief Adds required extensions to the extension list of the swapchain
     *
@@ -207,16 +285,73 @@ private:
    /* The queue on which we dispatch buffer related events, mostly buffer_release */
    struct wl_event_queue *m_buffer_queue;
 
+   /* true while m_buffer_queue is registered with the surface's event reader thread */
+   bool m_buffer_queue_registered{ false };
+
+   /**
+    * @brief The tearing hint last sent on the surface.
+    *
+    * Mirrors the double-buffered wl_surface state so an unchanged hint is not
+    * re-sent on every present. Only ever true when the compositor implements
+    * wp_tearing_control_v1.
+    */
+   bool m_tearing_hint_async{ false };
+
    /**
     * @brief Handle to the WSI allocator.
     */
    wsialloc_allocator *m_wsi_allocator;
 
+   /**
+    * @brief Serializes allocate_image calls on the shared @ref m_wsi_allocator
+    * when images are allocated by concurrent worker threads.
+    */
+   std::mutex m_image_allocation_mutex;
+
    /**
     * @brief Image creation parameters used for all swapchain images.
     */
    struct image_creation_parameters m_image_creation_parameters;
 
+   /**
+    * @brief dmabuf backing all swapchain images at once, or -1.
+    *
+    * When the selected format is linear and single-planar, the first
+    * allocate_image call makes one allocation tall enough for every image and
+    * the images are carved out of it at fixed offsets, turning N allocation
+    * ioctls per swapchain into one. All slab state is guarded by
+    * m_image_allocation_mutex.
+    */
+   int m_slab_fd = -1;
+
+   /** True once try_allocate_slab has run, whatever the outcome. */
+   bool m_slab_attempted = false;
+
+   /** Row stride of the slab allocation, in bytes. */
+   int m_slab_stride = 0;
+
+   /** Bytes between consecutive images in the slab, a multiple of the page size. */
+   uint32_t m_slab_image_size = 0;
+
+   /** Offset of the first image within the slab dmabuf. */
+   uint32_t m_slab_base_offset = 0;
+
+   /** Index of the next unused image slot in the slab. */
+   uint32_t m_slab_next_image = 0;
+
+   /** Number of image slots the slab was allocated for. */
+   uint32_t m_slab_image_count = 0;
+
+   /**
+    * @brief Whether the layer opted this swapchain into fixed-rate compression.
+    *
+    * Set when the application left image compression unspecified and a no-memory
+    * probe allocation confirmed a fixed-rate compressed candidate the compositor
+    * can consume. The per-image allocations then request the same compression so
+    * every buffer matches the probed modifier.
+    */
+   bool m_opportunistic_compression = false;
+
    /**
     * @brief Finds what formats are compatible with the requested swapchain image Vulkan Device and Wayland surface.
     *
@@ -230,6 +365,66 @@ private:
                                            util::vector<wsialloc_format> &importable_formats,
                                            util::vector<uint64_t> &exportable_modifers,
                                            util::vector<VkDrmFormatModifierPropertiesEXT> &drm_format_props);
+
+   /**
+    * @brief Request a wl_surface::frame callback before the next commit.
+    *
+    * The callback is tracked on #m_buffer_queue: when the queue is registered
+    * with the surface's event reader thread the event is dispatched the moment
+    * the compositor sends it and #wait_frame_event only sleeps on a condition
+    * variable, keeping the page flip thread out of Wayland dispatching.
+    *
+    * @return true for success, false otherwise.
+    */
+   bool set_frame_callback();
+
+   /**
+    * @brief Gate the next commit on the previous frame callback.
+    *
+    * Blocks until the compositor hints it is ready for a new frame, bounding the
+    * queue inside the compositor to a single committed buffer. Frames submitted
+    * meanwhile are held in the layer's own pending buffer pool, where the page
+    * flip thread can still apply mailbox-style replacement before they reach
+    * this gate. Waits are capped so a stalled compositor (e.g. a minimised
+    * window) does not block presentation indefinitely.
+    *
+    * @return true for success, false otherwise.
+    */
+   bool wait_frame_event();
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   /**
+    * @brief Attach a wp_presentation feedback request to the upcoming commit.
+    *
+    * Only acts when the swapchain has the present timing extension and the
+    * compositor implements wp_presentation. The feedback events are tracked on
+    * #m_buffer_queue, so they arrive through the dispatching that already
+    * happens for buffer releases - no extra round trips. When every slot is
+    * waiting on the compositor the frame simply goes untimed.
+    */
+   void request_presentation_feedback();
+
+   /** Upper bound on unanswered feedback requests. */
+   static constexpr size_t MAX_PRESENTATION_FEEDBACK_REQUESTS = 16;
+
+   /** Slots for in-flight feedback requests; see presentation_feedback_request. */
+   std::array<presentation_feedback_request, MAX_PRESENTATION_FEEDBACK_REQUESTS> m_feedback_requests;
+#endif
+
+   /**
+    * Frame callback object for the last FIFO commit. Destroyed before
+    * #m_buffer_queue so a late event cannot be dispatched on a dead queue.
+    */
+   wayland_owner<wl_callback> m_frame_callback;
+
+   /** Guards #m_frame_pending. */
+   std::mutex m_frame_pending_mutex;
+
+   /** Signalled by on_frame_done() when the frame callback fires. */
+   std::condition_variable m_frame_pending_cond;
+
+   /** True from a FIFO commit until its frame callback fires. */
+   bool m_frame_pending{ false };
 };
 
 } // namespace wayland
@@ -26,18 +26,17 @@
 
 #include <cstring>
 #include <memory>
-#include <poll.h>
 #include <errno.h>
 #include <cassert>
 
 #include "wl_object_owner.hpp"
 
+#include "util/file_descriptor.hpp"
 #include "util/log.hpp"
 
 int dispatch_queue(struct wl_display *display, struct wl_event_queue *queue, int timeout)
 {
    int err;
-   struct pollfd pfd = {};
    int retval;
 
    /* Before we sleep, dispatch any pending events. prepare_read_queue will return 0 whilst there are pending
@@ -54,51 +53,20 @@ int dispatch_queue(struct wl_display *display, struct wl_event_queue *queue, int
       }
    }
 
-   /* wl_display_read_events performs a non-blocking read. */
-   pfd.fd = wl_display_get_fd(display);
-   pfd.events = POLLIN;
-   while (true)
+   /* wl_display_read_events performs a non-blocking read, so wait for the
+    * compositor connection to become readable first. Signal interruptions
+    * restart the wait. */
+   switch (util::wait_for_readable(wl_display_get_fd(display), timeout))
    {
-      /* Timeout is given in milliseconds. A return value of 0, or -1 with errno set to EINTR means that we
-       * should retry as the timeout was exceeded or we were interrupted by a signal, respectively. A
-       * return value of 1 means that something happened, and we should inspect the pollfd structure to see
-       * just what that was.
-       */
-      err = poll(&pfd, 1, timeout);
-      if (0 == err)
-      {
-         /* Timeout. */
-         wl_display_cancel_read(display);
-         return 0;
-      }
-      else if (-1 == err)
-      {
-         if (EINTR == errno)
-         {
-            /* Interrupted by a signal; restart. This resets the timeout. */
-            continue;
-         }
-         else
-         {
-            /* Something else bad happened; abort. */
-            wl_display_cancel_read(display);
-            return -1;
-         }
-      }
-      else
-      {
-         if (POLLIN == pfd.revents)
-         {
-            /* We have data to read, and no errors; proceed to read_events. */
-            break;
-         }
-         else
-         {
-            /* An error occurred, e.g. file descriptor was closed from underneath us. */
-            wl_display_cancel_read(display);
-            return -1;
-         }
-      }
+   case util::fd_wait_status::timeout:
+      wl_display_cancel_read(display);
+      return 0;
+   case util::fd_wait_status::error:
+      /* E.g. the file descriptor was closed from underneath us. */
+      wl_display_cancel_read(display);
+      return -1;
+   case util::fd_wait_status::readable:
+      break;
    }
 
    /* Actually read the events from the display. A failure in read_events calls cancel_read internally for us,
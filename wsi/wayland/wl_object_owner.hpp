@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, 2024 Arm Limited.
+ * Copyright (c) 2021, 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -31,6 +31,9 @@
 #include <linux-dmabuf-unstable-v1-client-protocol.h>
 #include <linux-explicit-synchronization-unstable-v1-protocol.h>
 #include <presentation-time-client-protocol.h>
+#if WAYLAND_TEARING_CONTROL_ENABLED
+#include <tearing-control-v1-client-protocol.h>
+#endif
 #include <memory.h>
 #include <functional>
 
@@ -49,6 +52,13 @@ static inline void wayland_object_destroy(zwp_linux_dmabuf_v1 *obj)
    zwp_linux_dmabuf_v1_destroy(obj);
 }
 
+#if defined(ZWP_LINUX_DMABUF_V1_GET_DEFAULT_FEEDBACK_SINCE_VERSION)
+static inline void wayland_object_destroy(zwp_linux_dmabuf_feedback_v1 *obj)
+{
+   zwp_linux_dmabuf_feedback_v1_destroy(obj);
+}
+#endif
+
 static inline void wayland_object_destroy(zwp_linux_explicit_synchronization_v1 *obj)
 {
    zwp_linux_explicit_synchronization_v1_destroy(obj);
@@ -64,6 +74,18 @@ static inline void wayland_object_destroy(wp_presentation *obj)
    wp_presentation_destroy(obj);
 }
 
+#if WAYLAND_TEARING_CONTROL_ENABLED
+static inline void wayland_object_destroy(wp_tearing_control_manager_v1 *obj)
+{
+   wp_tearing_control_manager_v1_destroy(obj);
+}
+
+static inline void wayland_object_destroy(wp_tearing_control_v1 *obj)
+{
+   wp_tearing_control_v1_destroy(obj);
+}
+#endif
+
 static inline void wayland_object_destroy(wl_callback *obj)
 {
    wl_callback_destroy(obj);
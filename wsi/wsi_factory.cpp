@@ -29,6 +29,7 @@
 
 #include "wsi_factory.hpp"
 #include "surface.hpp"
+#include "util/arena_allocator.hpp"
 
 #if BUILD_WSI_HEADLESS
 #include "headless/surface_properties.hpp"
@@ -202,11 +203,26 @@ VkResult add_device_extensions_required_by_layer(VkPhysicalDevice phys_dev,
                                                  const util::wsi_platform_set enabled_platforms,
                                                  util::extension_list &extensions_to_enable)
 {
-   util::allocator allocator{ extensions_to_enable.get_allocator(), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND };
-
-   util::extension_list available_device_extensions{ allocator };
-   TRY_LOG(get_available_device_extensions(phys_dev, available_device_extensions),
-           "Failed to acquire available device extensions");
+   /* The extension lists built below are all discarded on return, serve them from a
+    * bump allocator so the whole call costs at most one heap allocation. */
+   util::arena arena{ extensions_to_enable.get_allocator() };
+   const util::allocator &allocator = arena.get_allocator();
+
+   /* The supported extension set of a physical device cannot change, so it is
+    * enumerated once and cached in the instance; repeat device creations on the
+    * same physical device skip the enumerate-and-sort cycle entirely. */
+   auto &instance_data = layer::instance_private_data::get(phys_dev);
+   const util::extension_list *available_device_extensions = instance_data.get_cached_device_extensions(phys_dev);
+   if (available_device_extensions == nullptr)
+   {
+      util::extension_list enumerated_extensions{ allocator };
+      TRY_LOG(get_available_device_extensions(phys_dev, enumerated_extensions),
+              "Failed to acquire available device extensions");
+      TRY_LOG(instance_data.cache_device_extensions(phys_dev, enumerated_extensions),
+              "Failed to cache available device extensions");
+      available_device_extensions = instance_data.get_cached_device_extensions(phys_dev);
+      assert(available_device_extensions != nullptr);
+   }
 
    /* Add optional extensions independent of winsys. */
    {
@@ -222,7 +238,7 @@ VkResult add_device_extensions_required_by_layer(VkPhysicalDevice phys_dev,
 
       for (auto extension : optional_extensions)
       {
-         if (available_device_extensions.contains(extension))
+         if (available_device_extensions->contains(extension))
          {
             TRY_LOG_CALL(extensions_to_enable.add(extension));
          }
@@ -247,7 +263,7 @@ VkResult add_device_extensions_required_by_layer(VkPhysicalDevice phys_dev,
       TRY_LOG(props->get_required_device_extensions(extensions_required_by_layer),
               "Failed to acquire required device extensions");
 
-      bool supported = available_device_extensions.contains(extensions_required_by_layer);
+      bool supported = available_device_extensions->contains(extensions_required_by_layer);
       if (!supported)
       {
          WSI_LOG_WARNING("Device missing required extensions for platform %d, skipping",
@@ -263,7 +279,8 @@ VkResult add_device_extensions_required_by_layer(VkPhysicalDevice phys_dev,
 VkResult add_instance_extensions_required_by_layer(const util::wsi_platform_set enabled_platforms,
                                                    util::extension_list &extensions_to_enable)
 {
-   util::allocator allocator{ extensions_to_enable.get_allocator(), VK_SYSTEM_ALLOCATION_SCOPE_COMMAND };
+   util::arena arena{ extensions_to_enable.get_allocator() };
+   const util::allocator &allocator = arena.get_allocator();
    /* Requesting available instance extensions (as it happens with the device)
     * before adding additional ones isn't supported during the instance creation.
     * The reason for that is that the vulkan loader doesn't support layers to call vkEnumerateInstanceExtensionProperties.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2025 Arm Limited.
+ * Copyright (c) 2025-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  */
@@ -35,6 +35,14 @@
 #include <xcb/present.h>
 #include <xcb/xcb.h>
 
+/* DRI3 1.4 / Present 1.4 explicit synchronization needs the syncobj requests
+ * from libxcb 1.17; compile the support out against older headers. */
+#if defined(XCB_DRI3_IMPORT_SYNCOBJ) && defined(XCB_PRESENT_PIXMAP_SYNCED)
+#define WSI_X11_DRI3_SYNCOBJ 1
+#else
+#define WSI_X11_DRI3_SYNCOBJ 0
+#endif
+
 namespace wsi
 {
 namespace x11
@@ -46,22 +54,72 @@ dri3_presenter::dri3_presenter()
 
 dri3_presenter::~dri3_presenter()
 {
+   if (m_special_event_queue != nullptr)
+   {
+      xcb_unregister_for_special_event(m_connection, m_special_event_queue);
+   }
+
    if (m_render_node_fd >= 0)
    {
       close(m_render_node_fd);
    }
 }
 
+VkResult dri3_presenter::register_present_events()
+{
+   if (!m_connection)
+   {
+      return VK_ERROR_INITIALIZATION_FAILED;
+   }
+
+   m_present_event_id = xcb_generate_id(m_connection);
+
+   /* Attach the special-event queue before selecting input so no event can be
+    * delivered in between and end up in the application's event queue. */
+   m_special_event_queue = xcb_register_for_special_xge(m_connection, &xcb_present_id, m_present_event_id, nullptr);
+   if (m_special_event_queue == nullptr)
+   {
+      return VK_ERROR_INITIALIZATION_FAILED;
+   }
+
+   auto cookie = xcb_present_select_input_checked(m_connection, m_present_event_id, m_window,
+                                                  XCB_PRESENT_EVENT_MASK_COMPLETE_NOTIFY |
+                                                     XCB_PRESENT_EVENT_MASK_IDLE_NOTIFY |
+                                                     XCB_PRESENT_EVENT_MASK_CONFIGURE_NOTIFY);
+   xcb_generic_error_t *error = xcb_request_check(m_connection, cookie);
+   if (error != nullptr)
+   {
+      WSI_LOG_WARNING("dri3_presenter: failed to select Present events (X11 error %d)", error->error_code);
+      free(error);
+      xcb_unregister_for_special_event(m_connection, m_special_event_queue);
+      m_special_event_queue = nullptr;
+      return VK_ERROR_INITIALIZATION_FAILED;
+   }
+
+   return VK_SUCCESS;
+}
+
+xcb_generic_event_t *dri3_presenter::poll_present_event()
+{
+   if (m_special_event_queue == nullptr)
+   {
+      return nullptr;
+   }
+   return xcb_poll_for_special_event(m_connection, m_special_event_queue);
+}
+
 bool dri3_presenter::query_dri3_present(xcb_connection_t *connection)
 {
-   /* Check DRI3 extension */
-   auto dri3_cookie = xcb_dri3_query_version(connection, 1, 2);
+   /* Check DRI3 extension. 1.4 is asked for to negotiate explicit sync
+    * support; the server answers with whatever it actually provides. */
+   auto dri3_cookie = xcb_dri3_query_version(connection, 1, 4);
    auto *dri3_reply = xcb_dri3_query_version_reply(connection, dri3_cookie, nullptr);
    if (!dri3_reply)
    {
       return false;
    }
    uint32_t dri3_major = dri3_reply->major_version;
+   m_dri3_minor = dri3_reply->minor_version;
    free(dri3_reply);
 
    if (dri3_major < 1)
@@ -70,17 +128,56 @@ bool dri3_presenter::query_dri3_present(xcb_connection_t *connection)
    }
 
    /* Check Present extension */
-   auto present_cookie = xcb_present_query_version(connection, 1, 2);
+   auto present_cookie = xcb_present_query_version(connection, 1, 4);
    auto *present_reply = xcb_present_query_version_reply(connection, present_cookie, nullptr);
    if (!present_reply)
    {
       return false;
    }
+   m_present_minor = present_reply->minor_version;
    free(present_reply);
 
    return true;
 }
 
+void dri3_presenter::probe_explicit_sync()
+{
+#if WSI_X11_DRI3_SYNCOBJ
+   if (m_dri3_minor < 4 || m_present_minor < 4)
+   {
+      return;
+   }
+
+#ifdef DRM_CAP_SYNCOBJ_TIMELINE
+   uint64_t cap = 0;
+   if (drmGetCap(m_render_node_fd, DRM_CAP_SYNCOBJ_TIMELINE, &cap) != 0 || cap == 0)
+   {
+      return;
+   }
+#else
+   return;
+#endif
+
+   /* The window's driver may not support syncobj waits even when the
+    * extension versions line up (e.g. a software-rendered screen). */
+   auto caps_cookie = xcb_present_query_capabilities(m_connection, m_window);
+   auto *caps_reply = xcb_present_query_capabilities_reply(m_connection, caps_cookie, nullptr);
+   if (caps_reply == nullptr)
+   {
+      return;
+   }
+   bool has_syncobj_cap = (caps_reply->capabilities & XCB_PRESENT_CAPABILITY_SYNCOBJ) != 0;
+   free(caps_reply);
+
+   if (has_syncobj_cap)
+   {
+      m_explicit_sync_supported = true;
+      WSI_LOG_INFO("dri3_presenter: explicit sync available (DRI3 1.%u, Present 1.%u)", m_dri3_minor,
+                   m_present_minor);
+   }
+#endif /* WSI_X11_DRI3_SYNCOBJ */
+}
+
 int dri3_presenter::open_render_node(xcb_connection_t *connection, xcb_window_t root)
 {
    /* Try xcb_dri3_open first — asks the X server for its render node */
@@ -139,13 +236,20 @@ int dri3_presenter::open_render_node(xcb_connection_t *connection, xcb_window_t
    return fd;
 }
 
-bool dri3_presenter::is_available(xcb_connection_t *connection)
+bool dri3_presenter::is_available(xcb_connection_t *connection, bool have_render_node)
 {
    if (!query_dri3_present(connection))
    {
       return false;
    }
 
+   if (have_render_node)
+   {
+      /* The caller already holds an open render node for this connection, so
+       * there is no need to prove one exists by scanning /dev/dri/ again. */
+      return true;
+   }
+
    /* Check that a render node exists by scanning /dev/dri/ */
    DIR *dir = opendir("/dev/dri");
    if (!dir)
@@ -168,24 +272,38 @@ bool dri3_presenter::is_available(xcb_connection_t *connection)
    return found;
 }
 
-VkResult dri3_presenter::init(xcb_connection_t *connection, xcb_window_t window, surface *wsi_surface)
+VkResult dri3_presenter::init(xcb_connection_t *connection, xcb_window_t window, surface *wsi_surface,
+                              int render_node_fd)
 {
    m_connection = connection;
    m_window = window;
    m_wsi_surface = wsi_surface;
 
-   /* Get root window for DRI3 open */
-   auto setup = xcb_get_setup(connection);
-   auto screen = xcb_setup_roots_iterator(setup).data;
-   xcb_window_t root = screen->root;
+   if (render_node_fd >= 0)
+   {
+      /* Adopt the render node cached by an earlier probe on this connection:
+       * subsequent swapchains bind to the node with no filesystem traffic. */
+      m_render_node_fd = render_node_fd;
+   }
+   else
+   {
+      /* Get root window for DRI3 open */
+      auto setup = xcb_get_setup(connection);
+      auto screen = xcb_setup_roots_iterator(setup).data;
+      xcb_window_t root = screen->root;
+
+      m_render_node_fd = open_render_node(connection, root);
+   }
 
-   m_render_node_fd = open_render_node(connection, root);
    if (m_render_node_fd < 0)
    {
       WSI_LOG_ERROR("dri3_presenter: no render node available");
       return VK_ERROR_INITIALIZATION_FAILED;
    }
 
+   query_dri3_present(connection);
+   probe_explicit_sync();
+
    return VK_SUCCESS;
 }
 
@@ -205,6 +323,36 @@ VkResult dri3_presenter::create_image_resources(x11_image_data *image_data, uint
       return VK_ERROR_INITIALIZATION_FAILED;
    }
 
+   /* Identify the buffer by its DMA-BUF inode. The surface's pixmap cache
+    * keeps a dup of each cached buffer's fd, so a live identity can never be
+    * recycled by a newly allocated buffer. */
+   uint64_t buffer_id = 0;
+   struct stat buffer_stat;
+   if (fstat(dma_buf_fd, &buffer_stat) == 0)
+   {
+      buffer_id = static_cast<uint64_t>(buffer_stat.st_ino);
+   }
+
+   if (buffer_id != 0 && m_wsi_surface != nullptr)
+   {
+      xcb_pixmap_t cached = m_wsi_surface->take_cached_pixmap(buffer_id, width, height, stride, modifier);
+      if (cached != XCB_PIXMAP_NONE)
+      {
+         /* Same buffer, same import parameters: the X server already holds
+          * this pixmap, no allocation round trip needed. */
+         image_data->pixmap = cached;
+         image_data->width = width;
+         image_data->height = height;
+         image_data->depth = depth;
+         image_data->pixmap_buffer_id = buffer_id;
+         image_data->pixmap_stride = stride;
+         image_data->pixmap_modifier = modifier;
+         image_data->pixmap_buffer_fd = dup(dma_buf_fd);
+         create_image_syncobjs(image_data);
+         return VK_SUCCESS;
+      }
+   }
+
    /* Dup the fd — DRI3 takes ownership */
    int fd_for_dri3 = dup(dma_buf_fd);
    if (fd_for_dri3 < 0)
@@ -247,6 +395,12 @@ VkResult dri3_presenter::create_image_resources(x11_image_data *image_data, uint
    image_data->width = width;
    image_data->height = height;
    image_data->depth = depth;
+   image_data->pixmap_buffer_id = buffer_id;
+   image_data->pixmap_stride = stride;
+   image_data->pixmap_modifier = modifier;
+   image_data->pixmap_buffer_fd = buffer_id != 0 ? dup(dma_buf_fd) : -1;
+
+   create_image_syncobjs(image_data);
 
    fprintf(stderr, "dri3_presenter: created DRI3 pixmap %u (%ux%u, fourcc=0x%x, mod=0x%lx)\n",
            pixmap, width, height, fourcc, (unsigned long)modifier);
@@ -254,6 +408,61 @@ VkResult dri3_presenter::create_image_resources(x11_image_data *image_data, uint
    return VK_SUCCESS;
 }
 
+void dri3_presenter::create_image_syncobjs(x11_image_data *image_data)
+{
+#if WSI_X11_DRI3_SYNCOBJ
+   if (!m_explicit_sync)
+   {
+      return;
+   }
+
+   uint32_t timeline = 0;
+   uint32_t import = 0;
+   if (drmSyncobjCreate(m_render_node_fd, 0, &timeline) != 0)
+   {
+      WSI_LOG_WARNING("dri3_presenter: syncobj creation failed: %s", strerror(errno));
+      return;
+   }
+   if (drmSyncobjCreate(m_render_node_fd, 0, &import) != 0)
+   {
+      WSI_LOG_WARNING("dri3_presenter: syncobj creation failed: %s", strerror(errno));
+      drmSyncobjDestroy(m_render_node_fd, timeline);
+      return;
+   }
+
+   int syncobj_fd = -1;
+   if (drmSyncobjHandleToFD(m_render_node_fd, timeline, &syncobj_fd) != 0)
+   {
+      WSI_LOG_WARNING("dri3_presenter: syncobj export failed: %s", strerror(errno));
+      drmSyncobjDestroy(m_render_node_fd, timeline);
+      drmSyncobjDestroy(m_render_node_fd, import);
+      return;
+   }
+
+   /* The import request takes ownership of the fd.  Checked, so a server that
+    * advertised 1.4 but rejects the import downgrades the image to implicit
+    * sync instead of erroring on every present. */
+   xcb_dri3_syncobj_t xid = xcb_generate_id(m_connection);
+   auto cookie = xcb_dri3_import_syncobj_checked(m_connection, xid, m_window, syncobj_fd);
+   xcb_generic_error_t *error = xcb_request_check(m_connection, cookie);
+   if (error != nullptr)
+   {
+      WSI_LOG_WARNING("dri3_presenter: syncobj import rejected (X11 error %d)", error->error_code);
+      free(error);
+      drmSyncobjDestroy(m_render_node_fd, timeline);
+      drmSyncobjDestroy(m_render_node_fd, import);
+      return;
+   }
+
+   image_data->syncobj_handle = timeline;
+   image_data->syncobj_import_handle = import;
+   image_data->syncobj_xid = xid;
+   image_data->syncobj_point = 0;
+#else
+   (void)image_data;
+#endif /* WSI_X11_DRI3_SYNCOBJ */
+}
+
 VkResult dri3_presenter::present_image(x11_image_data *image_data, uint32_t serial)
 {
    (void)serial;
@@ -263,6 +472,25 @@ VkResult dri3_presenter::present_image(x11_image_data *image_data, uint32_t seri
       return VK_ERROR_SURFACE_LOST_KHR;
    }
 
+#if WSI_X11_DRI3_SYNCOBJ
+   if (m_explicit_sync && image_data->syncobj_xid != 0)
+   {
+      if (present_image_synced(image_data) == VK_SUCCESS)
+      {
+         return VK_SUCCESS;
+      }
+
+      /* Fall through to the implicit path.  The page flip thread skipped the
+       * CPU wait on the present payload because this presenter forwards it,
+       * so complete the wait here before handing the buffer to the server. */
+      constexpr uint64_t WAIT_PRESENT_TIMEOUT = 1000000000; /* 1 second */
+      while (image_data->present_fence.wait_payload(WAIT_PRESENT_TIMEOUT) == VK_TIMEOUT)
+      {
+         WSI_LOG_WARNING("Timeout waiting for image's present fences, retrying..");
+      }
+   }
+#endif
+
    m_present_serial++;
 
    /* xcb_present_pixmap with COPY option: the X server copies the pixmap
@@ -283,18 +511,122 @@ VkResult dri3_presenter::present_image(x11_image_data *image_data, uint32_t seri
                       0,        /* notifies_len */
                       nullptr); /* notifies */
 
+   /* The present cycle's only flush; completion and idle events come back
+    * through the shared event drain. */
+   xcb_flush(m_connection);
+
+   return VK_SUCCESS;
+}
+
+VkResult dri3_presenter::present_image_synced(x11_image_data *image_data)
+{
+#if WSI_X11_DRI3_SYNCOBJ
+   /* Forward the present payload GPU-side: the sync_fd goes through the
+    * scratch binary syncobj onto the timeline's next acquire point, and the
+    * server waits for that point before its copy instead of this thread
+    * burning the wait on the CPU. */
+   auto payload_fd = image_data->present_fence.export_sync_fd();
+   if (!payload_fd.has_value() || !payload_fd->is_valid())
+   {
+      WSI_LOG_WARNING("dri3_presenter: failed to export present payload, presenting implicitly");
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   if (drmSyncobjImportSyncFile(m_render_node_fd, image_data->syncobj_import_handle, payload_fd->get()) != 0)
+   {
+      WSI_LOG_WARNING("dri3_presenter: sync_fd import failed: %s", strerror(errno));
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   uint64_t acquire_point = ++image_data->syncobj_point;
+   uint64_t release_point = ++image_data->syncobj_point;
+
+   if (drmSyncobjTransfer(m_render_node_fd, image_data->syncobj_handle, acquire_point,
+                          image_data->syncobj_import_handle, 0, 0) != 0)
+   {
+      WSI_LOG_WARNING("dri3_presenter: syncobj transfer failed: %s", strerror(errno));
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+   }
+
+   m_present_serial++;
+
+   /* Still OPTION_COPY, as in the implicit path: the server's copy is ordered
+    * after the acquire point, and its own GPU work attaches implicit fences to
+    * the DMA-BUF, so the application reusing the buffer after IDLE_NOTIFY
+    * stays ordered against the read.  The release point is signalled when the
+    * copy completes; it is passed for protocol completeness and becomes the
+    * reuse gate if flips are ever enabled. */
+   xcb_present_pixmap_synced(m_connection, m_window, image_data->pixmap,
+                             m_present_serial,
+                             XCB_NONE, /* valid_region — whole pixmap */
+                             XCB_NONE, /* update_region — whole pixmap */
+                             0, 0,     /* x_off, y_off */
+                             XCB_NONE, /* target_crtc — let X server decide */
+                             image_data->syncobj_xid, /* acquire_syncobj */
+                             image_data->syncobj_xid, /* release_syncobj */
+                             acquire_point, release_point,
+                             XCB_PRESENT_OPTION_COPY,
+                             0,        /* target_msc — immediate */
+                             0, 0,     /* divisor, remainder */
+                             0,        /* notifies_len */
+                             nullptr); /* notifies */
+
+   /* The present cycle's only flush; completion and idle events come back
+    * through the shared event drain. */
    xcb_flush(m_connection);
 
    return VK_SUCCESS;
+#else
+   (void)image_data;
+   return VK_ERROR_FEATURE_NOT_PRESENT;
+#endif /* WSI_X11_DRI3_SYNCOBJ */
 }
 
 void dri3_presenter::destroy_image_resources(x11_image_data *image_data)
 {
    if (m_connection && image_data->pixmap != XCB_PIXMAP_NONE)
    {
-      xcb_free_pixmap(m_connection, image_data->pixmap);
+      if (image_data->pixmap_buffer_id != 0 && image_data->pixmap_buffer_fd >= 0 && m_wsi_surface != nullptr)
+      {
+         /* Park the pixmap on the surface, which outlives this swapchain, so
+          * a recreation presenting the same buffers skips the import. */
+         m_wsi_surface->cache_pixmap(image_data->pixmap_buffer_id, image_data->width, image_data->height,
+                                     image_data->pixmap_stride, image_data->pixmap_modifier, image_data->pixmap,
+                                     image_data->pixmap_buffer_fd);
+         image_data->pixmap_buffer_fd = -1;
+      }
+      else
+      {
+         xcb_free_pixmap(m_connection, image_data->pixmap);
+      }
       image_data->pixmap = XCB_PIXMAP_NONE;
    }
+
+   if (image_data->pixmap_buffer_fd >= 0)
+   {
+      close(image_data->pixmap_buffer_fd);
+      image_data->pixmap_buffer_fd = -1;
+   }
+
+#if WSI_X11_DRI3_SYNCOBJ
+   /* Unlike the pixmap, the syncobjs are not parked on the surface: they are
+    * cheap to recreate and their timeline points are per-swapchain state. */
+   if (image_data->syncobj_xid != 0 && m_connection)
+   {
+      xcb_dri3_free_syncobj(m_connection, image_data->syncobj_xid);
+      image_data->syncobj_xid = 0;
+   }
+   if (image_data->syncobj_handle != 0 && m_render_node_fd >= 0)
+   {
+      drmSyncobjDestroy(m_render_node_fd, image_data->syncobj_handle);
+      image_data->syncobj_handle = 0;
+   }
+   if (image_data->syncobj_import_handle != 0 && m_render_node_fd >= 0)
+   {
+      drmSyncobjDestroy(m_render_node_fd, image_data->syncobj_import_handle);
+      image_data->syncobj_import_handle = 0;
+   }
+#endif /* WSI_X11_DRI3_SYNCOBJ */
 }
 
 } /* namespace x11 */
@@ -38,15 +38,27 @@ public:
     * @brief Check if DRI3 presentation is available.
     *
     * Checks for DRI3 + Present extensions and a usable render node.
+    *
+    * @param connection       The X11 connection.
+    * @param have_render_node When true the caller already holds an open render
+    *                         node for this connection, so the /dev/dri scan
+    *                         that proves one exists is skipped.
     */
-   bool is_available(xcb_connection_t *connection);
+   bool is_available(xcb_connection_t *connection, bool have_render_node = false);
 
    /**
     * @brief Initialize the DRI3 presenter.
     *
     * Opens the render node via DRI3, queries Present extension.
+    *
+    * @param connection      The X11 connection.
+    * @param window          The window to present to.
+    * @param wsi_surface     The surface owning the window.
+    * @param render_node_fd  An already-open render node to adopt instead of
+    *                        probing for one; ownership passes to the
+    *                        presenter. Pass -1 to probe via DRI3.
     */
-   VkResult init(xcb_connection_t *connection, xcb_window_t window, surface *wsi_surface);
+   VkResult init(xcb_connection_t *connection, xcb_window_t window, surface *wsi_surface, int render_node_fd = -1);
 
    /**
     * @brief Create a DRI3 pixmap from DMA-BUF fds for an image.
@@ -68,10 +80,50 @@ public:
    /**
     * @brief Present an image via the Present extension.
     *
-    * Zero-copy: sends the pre-created pixmap to the X server.
+    * Zero-copy: sends the pre-created pixmap to the X server.  With explicit
+    * sync enabled the present payload is forwarded as a syncobj acquire point
+    * for the server to wait on GPU-side; otherwise the caller must have
+    * completed the CPU-side payload wait before calling in here.
     */
    VkResult present_image(x11_image_data *image_data, uint32_t serial);
 
+   /**
+    * @brief Whether the server and render node support DRI3/Present 1.4
+    * explicit synchronization via imported syncobjs.
+    */
+   bool supports_explicit_sync() const { return m_explicit_sync_supported; }
+
+   /**
+    * @brief Enable or disable the use of explicit sync for presents.
+    *
+    * The swapchain decides once at creation whether the per-image fences keep
+    * carrying the present payload; explicit sync is only usable when they do.
+    * No effect when support is missing.
+    */
+   void set_explicit_sync_enabled(bool enabled) { m_explicit_sync = enabled && m_explicit_sync_supported; }
+
+   /**
+    * @brief Register for Present completion events on the window.
+    *
+    * Selects COMPLETE_NOTIFY and IDLE_NOTIFY input and attaches a dedicated
+    * xcb special-event queue to it, keeping the events out of the
+    * application's normal event queue.
+    */
+   VkResult register_present_events();
+
+   /**
+    * @brief Poll the special-event queue for the next Present event.
+    *
+    * @return The next event or nullptr when the queue is empty. The caller
+    *         owns the returned event and must free() it.
+    */
+   xcb_generic_event_t *poll_present_event();
+
+   /**
+    * @brief Whether register_present_events() succeeded.
+    */
+   bool has_present_events() const { return m_special_event_queue != nullptr; }
+
    /**
     * @brief Destroy DRI3 resources for an image.
     */
@@ -90,8 +142,54 @@ private:
    int m_render_node_fd = -1;
    uint32_t m_present_serial = 0;
 
+   /** Negotiated extension minor versions (majors are both 1). */
+   uint32_t m_dri3_minor = 0;
+   uint32_t m_present_minor = 0;
+
+   /** Whether server, libxcb and render node all support explicit sync. */
+   bool m_explicit_sync_supported = false;
+   /** Whether explicit sync is actually in use for presents. */
+   bool m_explicit_sync = false;
+
+   /** Special-event queue receiving Present COMPLETE/IDLE notify events. */
+   xcb_special_event_t *m_special_event_queue = nullptr;
+   /** Event id used for xcb_present_select_input. */
+   uint32_t m_present_event_id = 0;
+
    bool query_dri3_present(xcb_connection_t *connection);
    int open_render_node(xcb_connection_t *connection, xcb_window_t root);
+
+   /**
+    * @brief Probe for DRI3/Present 1.4 explicit sync support.
+    *
+    * Checks the negotiated extension versions, the render node's timeline
+    * syncobj capability and the Present SYNCOBJ capability on the window.
+    * Sets m_explicit_sync_supported.
+    */
+   void probe_explicit_sync();
+
+   /**
+    * @brief Create the per-image syncobjs used for explicit sync.
+    *
+    * Creates a DRM timeline syncobj on the render node, imports it into the X
+    * server, and creates the scratch binary syncobj used to feed payload
+    * sync_fds onto the timeline.  Failure is soft: the image falls back to
+    * implicit sync with its syncobj fields left zero.
+    */
+   void create_image_syncobjs(x11_image_data *image_data);
+
+   /**
+    * @brief Present with syncobj acquire/release points (Present 1.4).
+    *
+    * Imports the image's present payload sync_fd onto the next acquire point
+    * of its timeline and issues xcb_present_pixmap_synced, so the X server
+    * waits for the render GPU-side.
+    *
+    * @return VK_SUCCESS when the synced present was issued, an error when the
+    *         payload could not be forwarded (the caller then completes the
+    *         CPU-side wait and presents implicitly).
+    */
+   VkResult present_image_synced(x11_image_data *image_data);
 };
 
 } /* namespace x11 */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2024 Arm Limited.
+ * Copyright (c) 2024, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -23,6 +23,7 @@
  */
 
 #include "drm_display.hpp"
+#include "util/config.hpp"
 #include "util/custom_allocator.hpp"
 #include "wsi/surface.hpp"
 
@@ -345,7 +346,7 @@ std::optional<drm_display> &drm_display::get_display()
    static std::optional<drm_display> display{ std::nullopt };
 
    std::call_once(flag, []() {
-      const char *dri_device = std::getenv("WSI_DISPLAY_DRI_DEV");
+      const char *dri_device = util::config::get().display_dri_device();
       if (!dri_device)
       {
          dri_device = default_dri_device_name.c_str();
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file present_timing_handler.cpp
+ *
+ * @brief Contains the functionality to implement features for present timing extension.
+ */
+
+#include "present_timing_handler.hpp"
+
+#include <util/log.hpp>
+
+wsi_ext_present_timing_x11::wsi_ext_present_timing_x11(const util::allocator &allocator)
+   : wsi_ext_present_timing(allocator)
+{
+}
+
+util::unique_ptr<wsi_ext_present_timing_x11> wsi_ext_present_timing_x11::create(const util::allocator &allocator)
+{
+   auto present_timing = allocator.make_unique<wsi_ext_present_timing_x11>(allocator);
+   if (present_timing == nullptr)
+   {
+      return nullptr;
+   }
+
+   auto queue_end_domain = allocator.make_unique<wsi::vulkan_time_domain>(VK_PRESENT_STAGE_QUEUE_OPERATIONS_END_BIT_EXT,
+                                                                          VK_TIME_DOMAIN_DEVICE_KHR);
+   if (queue_end_domain == nullptr ||
+       !present_timing->get_swapchain_time_domains().add_time_domain(std::move(queue_end_domain)))
+   {
+      WSI_LOG_ERROR("Failed to add a time domain.");
+      return nullptr;
+   }
+
+   auto complete_domain =
+      allocator.make_unique<present_complete_time_domain>(VK_PRESENT_STAGE_IMAGE_FIRST_PIXEL_VISIBLE_BIT_EXT);
+   if (complete_domain == nullptr)
+   {
+      WSI_LOG_ERROR("Failed to add a time domain.");
+      return nullptr;
+   }
+
+   /* The list owns the domain; the raw pointer is only used to feed it the
+    * completion timestamps and shares the extension's lifetime. */
+   auto *complete_domain_ptr = complete_domain.get();
+   if (!present_timing->get_swapchain_time_domains().add_time_domain(std::move(complete_domain)))
+   {
+      WSI_LOG_ERROR("Failed to add a time domain.");
+      return nullptr;
+   }
+   present_timing->m_complete_time_domain = complete_domain_ptr;
+
+   return present_timing;
+}
+
+VkResult wsi_ext_present_timing_x11::get_swapchain_timing_properties(uint64_t &timing_properties_counter,
+                                                                     VkSwapchainTimingPropertiesEXT &timing_properties)
+{
+   /* The refresh duration comes from the spacing of Present completions, so it
+    * tracks the output the window is actually scanned out on; it reads 0 until
+    * two completions have arrived. The counter is bumped whenever the derived
+    * duration changes beyond the jitter tolerance, e.g. after a mode switch or
+    * the window moving to a monitor with another refresh rate. */
+   timing_properties_counter = m_timing_properties_counter.load(std::memory_order_relaxed);
+   timing_properties.refreshDuration = m_refresh_duration_ns.load(std::memory_order_relaxed);
+   timing_properties.variableRefreshDelay = 0;
+
+   return VK_SUCCESS;
+}
+
+void wsi_ext_present_timing_x11::handle_complete_notify(uint64_t ust, uint64_t msc)
+{
+   /* UST is in microseconds on the server's CLOCK_MONOTONIC. */
+   m_complete_time_domain->set_last_complete_time(ust * 1000);
+
+   /* Dividing the UST delta by the MSC delta gives the refresh duration even
+    * when frames were skipped, as long as the counter moved forward; a reset
+    * or wrapped MSC just means this pair contributes no estimate. */
+   if (m_last_msc != 0 && msc > m_last_msc && ust > m_last_ust)
+   {
+      uint64_t refresh_ns = (ust - m_last_ust) * 1000 / (msc - m_last_msc);
+      uint64_t reported = m_refresh_duration_ns.load(std::memory_order_relaxed);
+      uint64_t deviation = refresh_ns > reported ? refresh_ns - reported : reported - refresh_ns;
+      if (deviation > REFRESH_TOLERANCE_NS)
+      {
+         m_refresh_duration_ns.store(refresh_ns, std::memory_order_relaxed);
+         m_timing_properties_counter.fetch_add(1, std::memory_order_relaxed);
+      }
+   }
+
+   m_last_ust = ust;
+   m_last_msc = msc;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2026 Arm Limited.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file present_timing_handler.hpp
+ *
+ * @brief Contains the functionality to implement features for present timing extension.
+ */
+#pragma once
+
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+
+#include <atomic>
+
+#include <wsi/extensions/present_timing.hpp>
+
+/**
+ * @brief Time domain anchored on Present COMPLETE_NOTIFY timestamps.
+ *
+ * The X server stamps each completion with the UST/MSC pair of the vblank the
+ * frame became visible on, where UST is a CLOCK_MONOTONIC microsecond
+ * timestamp. Like the display backend's vblank domain, calibration reports the
+ * most recent such timestamp, converted to nanoseconds.
+ */
+class present_complete_time_domain : public wsi::swapchain_time_domain
+{
+public:
+   present_complete_time_domain(VkPresentStageFlagsEXT present_stages)
+      : wsi::swapchain_time_domain(present_stages)
+   {
+   }
+
+   wsi::swapchain_calibrated_time calibrate() override
+   {
+      return { VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR, m_last_complete_time_ns.load(std::memory_order_relaxed) };
+   }
+
+   /**
+    * @brief Record the timestamp of the latest completion event.
+    *
+    * @param time_ns UST of the completion converted to nanoseconds.
+    */
+   void set_last_complete_time(uint64_t time_ns)
+   {
+      m_last_complete_time_ns.store(time_ns, std::memory_order_relaxed);
+   }
+
+private:
+   /** Timestamp of the most recent completion, 0 until the first one arrives. */
+   std::atomic<uint64_t> m_last_complete_time_ns{ 0 };
+};
+
+/**
+ * @brief Present timing extension class
+ *
+ * This class implements present timing features declarations that are specific to the X11 backend.
+ */
+class wsi_ext_present_timing_x11 : public wsi::wsi_ext_present_timing
+{
+public:
+   /**
+    * @brief Create the X11 present timing extension.
+    *
+    * @param allocator Allocator for the extension object.
+    */
+   static util::unique_ptr<wsi_ext_present_timing_x11> create(const util::allocator &allocator);
+
+   VkResult get_swapchain_timing_properties(uint64_t &timing_properties_counter,
+                                            VkSwapchainTimingPropertiesEXT &timing_properties) override;
+
+   /**
+    * @brief Record a Present COMPLETE_NOTIFY event for a presented frame.
+    *
+    * Called from the present event thread when the X server reports a frame on
+    * screen. The UST anchors the completion time domain and consecutive
+    * UST/MSC pairs yield the output's refresh duration, all from events the
+    * server already sends - no extra round trips.
+    *
+    * @param ust Microsecond CLOCK_MONOTONIC timestamp of the vblank the frame
+    *            became visible on.
+    * @param msc Media stream counter (vblank count) of that vblank.
+    */
+   void handle_complete_notify(uint64_t ust, uint64_t msc);
+
+private:
+   wsi_ext_present_timing_x11(const util::allocator &allocator);
+
+   /* Allow util::allocator to access the private constructor */
+   friend util::allocator;
+
+   /**
+    * @brief Slack allowed before a refresh estimate counts as a new duration.
+    *
+    * UST deltas carry a little scheduling jitter; without a tolerance the
+    * derived duration would differ by a few nanoseconds every frame and bump
+    * the properties counter continuously. Real mode changes differ by far
+    * more than this.
+    */
+   static constexpr uint64_t REFRESH_TOLERANCE_NS = 4000;
+
+   /**
+    * @brief UST/MSC of the previous completion, only touched from the present
+    * event thread. MSC 0 marks "no previous sample".
+    */
+   uint64_t m_last_ust{ 0 };
+   uint64_t m_last_msc{ 0 };
+
+   /**
+    * @brief Refresh duration derived from completion spacing, 0 until known.
+    */
+   std::atomic<uint64_t> m_refresh_duration_ns{ 0 };
+
+   /**
+    * @brief Bumped whenever the reported timing properties change.
+    */
+   std::atomic<uint64_t> m_timing_properties_counter{ 0 };
+
+   /**
+    * @brief Completion-backed time domain, owned by the time domain list.
+    */
+   present_complete_time_domain *m_complete_time_domain{ nullptr };
+};
+
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2025 Arm Limited.
+ * Copyright (c) 2025-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -31,21 +31,29 @@
 #include "shm_presenter.hpp"
 #include "surface.hpp"
 #include "swapchain.hpp"
+#include "util/config.hpp"
 #include "util/log.hpp"
+#include "util/thread_scheduling.hpp"
 
 #include <sys/shm.h>
 #include <sys/ipc.h>
+#include <poll.h>
 #include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <unordered_map>
 #include <thread>
-#include <future>
 #include <vector>
 #include <chrono>
 #include <cmath>
 #ifdef ENABLE_ARM_NEON
 #include <arm_neon.h>
 #endif
+#ifdef WSI_SHM_X86_SIMD
+#include <immintrin.h>
+#endif
 #include <X11/Xlib.h>
 #include <X11/extensions/Xrandr.h>
 #include <xcb/sync.h>
@@ -57,25 +65,238 @@ namespace x11
 
 static constexpr uint32_t THREADING_PIXEL_THRESHOLD = 400 * 400;
 static constexpr uint32_t MAX_WORKER_THREADS = 8u;
+static constexpr uint32_t COPY_ROWS_PER_CHUNK = 16u;
 static constexpr uint32_t SIMD_VECTOR_SIZE = 4;
 static constexpr uint32_t LOOP_UNROLL_BOUNDARY = 3;
 static constexpr int SHM_PERMISSIONS = 0666;
+static constexpr size_t SCALING_LUT_CACHE_SIZE = 4;
 static constexpr uint32_t GC_COLOR_MASK = XCB_GC_BACKGROUND | XCB_GC_FOREGROUND;
+/* Touch granularity used when prefaulting fresh SHM segments. */
+static constexpr size_t PREFAULT_PAGE_SIZE = 4096;
+/* LLC size assumed when sysconf cannot report one. */
+static constexpr long FALLBACK_LLC_SIZE = 4 * 1024 * 1024;
+/* Poll granularity while waiting for an SHM completion event; the wait
+ * normally ends on the connection fd, this only bounds a missed wakeup. */
+static constexpr int SEGMENT_RELEASE_POLL_MS = 4;
+
+namespace
+{
+
+/**
+ * @brief Process-wide pool of MIT-SHM segments.
+ *
+ * Swapchain recreation on a window resize tears down every SHM segment and
+ * allocates new ones, which costs two syscalls plus a full round of page
+ * faults per segment on every resize step. Segments are instead returned
+ * here on destruction and handed back out to later swapchain generations
+ * whenever a pooled one is large enough.
+ *
+ * Every segment is marked IPC_RMID right after it is attached, so a crash can
+ * never leak shared memory. Linux allows both this process and the X server
+ * to attach segments already marked for removal, which is also what makes
+ * reuse across swapchain generations safe.
+ */
+class shm_segment_pool
+{
+public:
+   static shm_segment_pool &instance()
+   {
+      static shm_segment_pool pool;
+      return pool;
+   }
+
+   /**
+    * @brief Hand out a segment of at least @p size bytes.
+    *
+    * Prefers the smallest pooled segment that fits. Otherwise a new segment is
+    * created, first requesting hugepage backing to cut the TLB footprint of
+    * the copy loops and falling back to normal pages when huge pages are not
+    * available to the process.
+    *
+    * @param      size  Minimum usable size in bytes.
+    * @param[out] addr  Mapped address of the segment.
+    * @param[out] fresh Set to true when the segment was newly created and none
+    *                   of its pages have been faulted in yet.
+    *
+    * @return The SysV id of the segment, or -1 on failure.
+    */
+   int acquire(size_t size, void **addr, bool *fresh)
+   {
+      const std::lock_guard<std::mutex> lock(m_mutex);
+
+      auto best = m_free_segments.end();
+      for (auto it = m_free_segments.begin(); it != m_free_segments.end(); ++it)
+      {
+         if (it->size >= size && (best == m_free_segments.end() || it->size < best->size))
+         {
+            best = it;
+         }
+      }
+      if (best != m_free_segments.end())
+      {
+         int shm_id = best->shm_id;
+         *addr = best->addr;
+         *fresh = false;
+         m_live_sizes[shm_id] = best->size;
+         m_free_segments.erase(best);
+         return shm_id;
+      }
+
+      int shm_id = -1;
+      size_t alloc_size = size;
+#ifdef SHM_HUGETLB
+      /* Creation with SHM_HUGETLB fails when no huge pages are reserved or the
+       * process lacks the privilege; latch the failure so the extra shmget is
+       * not retried on every allocation. Segments smaller than one huge page
+       * are not worth the rounding waste. */
+      if (!m_hugetlb_unavailable && size >= HUGE_PAGE_SIZE)
+      {
+         size_t huge_size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+         shm_id = shmget(IPC_PRIVATE, huge_size, IPC_CREAT | SHM_HUGETLB | SHM_PERMISSIONS);
+         if (shm_id >= 0)
+         {
+            alloc_size = huge_size;
+         }
+         else
+         {
+            m_hugetlb_unavailable = true;
+         }
+      }
+#endif
+      if (shm_id < 0)
+      {
+         shm_id = shmget(IPC_PRIVATE, size, IPC_CREAT | SHM_PERMISSIONS);
+      }
+      if (shm_id < 0)
+      {
+         return -1;
+      }
+
+      *addr = shmat(shm_id, nullptr, 0);
+      if (*addr == (void *)-1)
+      {
+         shmctl(shm_id, IPC_RMID, nullptr);
+         return -1;
+      }
+
+      /* Mark for removal up front: the kernel keeps the segment alive while it
+       * is attached and reclaims it automatically even if the process dies. */
+      shmctl(shm_id, IPC_RMID, nullptr);
+
+      m_live_sizes[shm_id] = alloc_size;
+      *fresh = true;
+      return shm_id;
+   }
+
+   /**
+    * @brief Return a segment for reuse, detaching the oldest pooled one if the
+    * pool is full.
+    */
+   void release(int shm_id, void *addr)
+   {
+      const std::lock_guard<std::mutex> lock(m_mutex);
+
+      auto it = m_live_sizes.find(shm_id);
+      if (it == m_live_sizes.end())
+      {
+         /* Not handed out by the pool - just detach. */
+         shmdt(addr);
+         return;
+      }
+      size_t size = it->second;
+      m_live_sizes.erase(it);
+
+      if (m_free_segments.size() >= MAX_POOLED_SEGMENTS)
+      {
+         shmdt(m_free_segments.front().addr);
+         m_free_segments.erase(m_free_segments.begin());
+      }
+      m_free_segments.push_back({ shm_id, addr, size });
+   }
+
+   /**
+    * @brief Detach every pooled segment, returning its memory to the kernel.
+    *
+    * The segments are already marked IPC_RMID, so the last detach frees them
+    * outright. Used by the idle governor; later acquires simply create fresh
+    * segments again.
+    */
+   void trim()
+   {
+      const std::lock_guard<std::mutex> lock(m_mutex);
+
+      for (auto &segment : m_free_segments)
+      {
+         shmdt(segment.addr);
+      }
+      m_free_segments.clear();
+   }
+
+private:
+   shm_segment_pool()
+   {
+      /* Keeps release() from ever reallocating on the destruction path. */
+      m_free_segments.reserve(MAX_POOLED_SEGMENTS);
+   }
+
+   ~shm_segment_pool()
+   {
+      for (auto &segment : m_free_segments)
+      {
+         shmdt(segment.addr);
+      }
+   }
+
+   struct pooled_segment
+   {
+      int shm_id;
+      void *addr;
+      size_t size;
+   };
+
+   static constexpr size_t MAX_POOLED_SEGMENTS = 8;
+   static constexpr size_t HUGE_PAGE_SIZE = size_t(2) * 1024 * 1024;
+
+   std::mutex m_mutex;
+   std::vector<pooled_segment> m_free_segments;
+   std::unordered_map<int, size_t> m_live_sizes;
+   bool m_hugetlb_unavailable = false;
+};
+
+} /* namespace */
 
 shm_presenter::shm_presenter()
    : m_sync_pending(false)
-   , m_frame_interval(std::chrono::microseconds(16667))
+   , m_frame_interval_us(16667)
    , m_refresh_rate_hz(60.0)
 {
 }
 
 shm_presenter::~shm_presenter()
 {
+   stop_worker_pool();
+
+   if (m_event_display)
+   {
+      if (m_wsi_surface)
+      {
+         m_wsi_surface->set_geometry_event_stream_active(false);
+      }
+      XCloseDisplay(m_event_display);
+      m_event_display = nullptr;
+   }
+
    if (m_sync_pending)
    {
       ensure_sync_completion();
    }
    cleanup_fence_sync();
+
+   if (m_completion_pipelining && m_put_connection != nullptr)
+   {
+      xcb_disconnect(m_put_connection);
+      m_put_connection = nullptr;
+   }
 }
 
 bool shm_presenter::is_aligned(const void *ptr, size_t alignment)
@@ -91,12 +312,316 @@ bool shm_presenter::are_pointers_neon_aligned(const void *src, void *dst)
 }
 #endif
 
+#ifdef WSI_SHM_X86_SIMD
+bool shm_presenter::are_pointers_sse_aligned(const void *src, void *dst)
+{
+   constexpr size_t SSE_ALIGNMENT = 16;
+   return is_aligned(src, SSE_ALIGNMENT) && is_aligned(dst, SSE_ALIGNMENT);
+}
+
+bool shm_presenter::are_pointers_avx_aligned(const void *src, void *dst)
+{
+   constexpr size_t AVX_ALIGNMENT = 32;
+   return is_aligned(src, AVX_ALIGNMENT) && is_aligned(dst, AVX_ALIGNMENT);
+}
+
+void shm_presenter::detect_x86_simd_level()
+{
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2"))
+   {
+      m_x86_simd_level = x86_simd_level::AVX2;
+   }
+   else if (__builtin_cpu_supports("sse4.1"))
+   {
+      m_x86_simd_level = x86_simd_level::SSE41;
+   }
+   m_has_f16c = __builtin_cpu_supports("f16c");
+}
+#endif
+
+/* Bit-exact half → float conversion for the scalar tails; the SIMD kernels use
+ * the hardware converters instead. */
+static float half_to_float(uint16_t h)
+{
+   uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+   uint32_t exponent = (h >> 10) & 0x1Fu;
+   uint32_t mantissa = h & 0x3FFu;
+   uint32_t bits;
+
+   if (exponent == 31u)
+   {
+      /* Inf/NaN */
+      bits = sign | 0x7F800000u | (mantissa << 13);
+   }
+   else if (exponent != 0u)
+   {
+      bits = sign | ((exponent - 15u + 127u) << 23) | (mantissa << 13);
+   }
+   else if (mantissa != 0u)
+   {
+      /* Subnormal: renormalize */
+      exponent = 127u - 15u + 1u;
+      while ((mantissa & 0x400u) == 0u)
+      {
+         mantissa <<= 1;
+         exponent--;
+      }
+      bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+   }
+   else
+   {
+      bits = sign;
+   }
+
+   float f;
+   std::memcpy(&f, &bits, sizeof(f));
+   return f;
+}
+
+static uint32_t float_to_unorm8(float value)
+{
+   if (!(value > 0.0f))
+   {
+      /* Negative and NaN clamp to 0. */
+      return 0u;
+   }
+   if (value >= 1.0f)
+   {
+      return 255u;
+   }
+   return static_cast<uint32_t>(value * 255.0f + 0.5f);
+}
+
+shm_presenter::pixel_conversion shm_presenter::conversion_for_format(VkFormat format)
+{
+   switch (format)
+   {
+   case VK_FORMAT_R16G16B16A16_SFLOAT:
+      return pixel_conversion::RGBA16F;
+   case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+      return pixel_conversion::RGB10A2_ABGR;
+   case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
+      return pixel_conversion::RGB10A2_ARGB;
+   default:
+      return pixel_conversion::NONE;
+   }
+}
+
+void shm_presenter::convert_row_rgba16f_scalar(const uint16_t *src_row, uint32_t *dst_row, uint32_t dst_width)
+{
+   for (uint32_t x = 0; x < dst_width; x++)
+   {
+      const uint16_t *px = src_row + x * 4;
+      uint32_t r = float_to_unorm8(half_to_float(px[0]));
+      uint32_t g = float_to_unorm8(half_to_float(px[1]));
+      uint32_t b = float_to_unorm8(half_to_float(px[2]));
+      dst_row[x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+   }
+}
+
+void shm_presenter::convert_row_rgb10a2_scalar(const uint32_t *src_row, uint32_t *dst_row, uint32_t dst_width,
+                                               bool red_in_high)
+{
+   for (uint32_t x = 0; x < dst_width; x++)
+   {
+      uint32_t v = src_row[x];
+      uint32_t lo = (v >> 2) & 0xFFu;
+      uint32_t mid = (v >> 12) & 0xFFu;
+      uint32_t hi = (v >> 22) & 0xFFu;
+      uint32_t r = red_in_high ? hi : lo;
+      uint32_t b = red_in_high ? lo : hi;
+      dst_row[x] = 0xFF000000u | (r << 16) | (mid << 8) | b;
+   }
+}
+
+#ifdef ENABLE_ARM_NEON
+#if defined(__aarch64__)
+void shm_presenter::convert_row_rgba16f_neon(const uint16_t *src_row, uint32_t *dst_row, uint32_t dst_width)
+{
+   const float32x4_t scale = vdupq_n_f32(255.0f);
+   const float32x4_t zero = vdupq_n_f32(0.0f);
+   const float32x4_t half = vdupq_n_f32(0.5f);
+   const uint32x4_t max255 = vdupq_n_u32(255u);
+   const uint32x4_t alpha = vdupq_n_u32(0xFF000000u);
+
+   uint32_t x = 0;
+   for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
+   {
+      /* De-interleave 4 pixels into R/G/B/A lanes, widen to f32, then
+       * scale+round+clamp; negatives and NaNs come out as 0 from the
+       * unsigned convert. */
+      uint16x4x4_t px = vld4_u16(src_row + x * 4);
+      float32x4_t r = vcvt_f32_f16(vreinterpret_f16_u16(px.val[0]));
+      float32x4_t g = vcvt_f32_f16(vreinterpret_f16_u16(px.val[1]));
+      float32x4_t b = vcvt_f32_f16(vreinterpret_f16_u16(px.val[2]));
+
+      uint32x4_t ri = vminq_u32(vcvtq_u32_f32(vmlaq_f32(half, vmaxq_f32(r, zero), scale)), max255);
+      uint32x4_t gi = vminq_u32(vcvtq_u32_f32(vmlaq_f32(half, vmaxq_f32(g, zero), scale)), max255);
+      uint32x4_t bi = vminq_u32(vcvtq_u32_f32(vmlaq_f32(half, vmaxq_f32(b, zero), scale)), max255);
+
+      uint32x4_t out = vorrq_u32(alpha, vorrq_u32(vshlq_n_u32(ri, 16), vorrq_u32(vshlq_n_u32(gi, 8), bi)));
+      vst1q_u32(&dst_row[x], out);
+   }
+
+   convert_row_rgba16f_scalar(src_row + x * 4, dst_row + x, dst_width - x);
+}
+#endif
+
+void shm_presenter::convert_row_rgb10a2_neon(const uint32_t *src_row, uint32_t *dst_row, uint32_t dst_width,
+                                             bool red_in_high)
+{
+   const uint32x4_t mask = vdupq_n_u32(0xFFu);
+   const uint32x4_t alpha = vdupq_n_u32(0xFF000000u);
+
+   uint32_t x = 0;
+   for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
+   {
+      uint32x4_t v = vld1q_u32(&src_row[x]);
+      uint32x4_t lo = vandq_u32(vshrq_n_u32(v, 2), mask);
+      uint32x4_t mid = vandq_u32(vshrq_n_u32(v, 12), mask);
+      uint32x4_t hi = vandq_u32(vshrq_n_u32(v, 22), mask);
+      uint32x4_t r = red_in_high ? hi : lo;
+      uint32x4_t b = red_in_high ? lo : hi;
+      uint32x4_t out = vorrq_u32(alpha, vorrq_u32(vshlq_n_u32(r, 16), vorrq_u32(vshlq_n_u32(mid, 8), b)));
+      vst1q_u32(&dst_row[x], out);
+   }
+
+   convert_row_rgb10a2_scalar(src_row + x, dst_row + x, dst_width - x, red_in_high);
+}
+#endif
+
+#ifdef WSI_SHM_X86_SIMD
+__attribute__((target("sse4.1,f16c"))) void shm_presenter::convert_row_rgba16f_f16c(const uint16_t *src_row,
+                                                                                    uint32_t *dst_row,
+                                                                                    uint32_t dst_width)
+{
+   const __m128 scale = _mm_set1_ps(255.0f);
+   const __m128 zero = _mm_setzero_ps();
+   const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+   /* Per pixel the packed bytes are R,G,B,A; XRGB8888 memory order is B,G,R,X. */
+   const __m128i swizzle = _mm_set_epi8(15, 12, 13, 14, 11, 8, 9, 10, 7, 4, 5, 6, 3, 0, 1, 2);
+
+   uint32_t x = 0;
+   for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
+   {
+      const __m128i *src = reinterpret_cast<const __m128i *>(src_row + x * 4);
+      __m128i h01 = _mm_loadu_si128(src);
+      __m128i h23 = _mm_loadu_si128(src + 1);
+
+      /* One pixel per F16C convert; the saturating packs handle the high
+       * clamp, the max the low one (NaN converts to INT_MIN and packs to 0). */
+      __m128 p0 = _mm_mul_ps(_mm_max_ps(_mm_cvtph_ps(h01), zero), scale);
+      __m128 p1 = _mm_mul_ps(_mm_max_ps(_mm_cvtph_ps(_mm_srli_si128(h01, 8)), zero), scale);
+      __m128 p2 = _mm_mul_ps(_mm_max_ps(_mm_cvtph_ps(h23), zero), scale);
+      __m128 p3 = _mm_mul_ps(_mm_max_ps(_mm_cvtph_ps(_mm_srli_si128(h23, 8)), zero), scale);
+
+      __m128i i01 = _mm_packus_epi32(_mm_cvtps_epi32(p0), _mm_cvtps_epi32(p1));
+      __m128i i23 = _mm_packus_epi32(_mm_cvtps_epi32(p2), _mm_cvtps_epi32(p3));
+      __m128i rgba = _mm_packus_epi16(i01, i23);
+
+      __m128i out = _mm_or_si128(_mm_shuffle_epi8(rgba, swizzle), alpha);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst_row[x]), out);
+   }
+
+   convert_row_rgba16f_scalar(src_row + x * 4, dst_row + x, dst_width - x);
+}
+
+__attribute__((target("sse4.1"))) void shm_presenter::convert_row_rgb10a2_sse41(const uint32_t *src_row,
+                                                                                uint32_t *dst_row, uint32_t dst_width,
+                                                                                bool red_in_high)
+{
+   const __m128i mask = _mm_set1_epi32(0xFF);
+   const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+   uint32_t x = 0;
+   for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
+   {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src_row[x]));
+      __m128i lo = _mm_and_si128(_mm_srli_epi32(v, 2), mask);
+      __m128i mid = _mm_and_si128(_mm_srli_epi32(v, 12), mask);
+      __m128i hi = _mm_and_si128(_mm_srli_epi32(v, 22), mask);
+      __m128i r = red_in_high ? hi : lo;
+      __m128i b = red_in_high ? lo : hi;
+      __m128i out = _mm_or_si128(alpha, _mm_or_si128(_mm_slli_epi32(r, 16), _mm_or_si128(_mm_slli_epi32(mid, 8), b)));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst_row[x]), out);
+   }
+
+   convert_row_rgb10a2_scalar(src_row + x, dst_row + x, dst_width - x, red_in_high);
+}
+#endif
+
+void shm_presenter::convert_row_rgba16f(const uint16_t *src_row, uint32_t *dst_row, uint32_t dst_width)
+{
+#if defined(ENABLE_ARM_NEON) && defined(__aarch64__)
+   convert_row_rgba16f_neon(src_row, dst_row, dst_width);
+#elif defined(WSI_SHM_X86_SIMD)
+   if (m_has_f16c)
+   {
+      convert_row_rgba16f_f16c(src_row, dst_row, dst_width);
+      return;
+   }
+   convert_row_rgba16f_scalar(src_row, dst_row, dst_width);
+#else
+   convert_row_rgba16f_scalar(src_row, dst_row, dst_width);
+#endif
+}
+
+void shm_presenter::convert_row_rgb10a2(const uint32_t *src_row, uint32_t *dst_row, uint32_t dst_width,
+                                        bool red_in_high)
+{
+#if defined(ENABLE_ARM_NEON)
+   convert_row_rgb10a2_neon(src_row, dst_row, dst_width, red_in_high);
+#elif defined(WSI_SHM_X86_SIMD)
+   if (m_x86_simd_level != x86_simd_level::NONE)
+   {
+      convert_row_rgb10a2_sse41(src_row, dst_row, dst_width, red_in_high);
+      return;
+   }
+   convert_row_rgb10a2_scalar(src_row, dst_row, dst_width, red_in_high);
+#else
+   convert_row_rgb10a2_scalar(src_row, dst_row, dst_width, red_in_high);
+#endif
+}
+
+void shm_presenter::convert_pixels(pixel_conversion conversion, const uint32_t *src_pixels, uint32_t *dst_pixels,
+                                   uint32_t src_stride_pixels, uint32_t dst_width, uint32_t height)
+{
+   for (uint32_t row = 0; row < height; row++)
+   {
+      const uint32_t *src_row = src_pixels + (row * src_stride_pixels);
+      uint32_t *dst_row = dst_pixels + (row * dst_width);
+
+      if (row + 1 < height)
+      {
+         __builtin_prefetch(src_row + src_stride_pixels, 0, 3);
+      }
+
+      if (conversion == pixel_conversion::RGBA16F)
+      {
+         convert_row_rgba16f(reinterpret_cast<const uint16_t *>(src_row), dst_row, dst_width);
+      }
+      else
+      {
+         convert_row_rgb10a2(src_row, dst_row, dst_width, conversion == pixel_conversion::RGB10A2_ARGB);
+      }
+   }
+}
+
 double shm_presenter::get_window_refresh_rate()
 {
    double detected_refresh_rate = 60.0;
    bool found_refresh_rate = false;
 
-   Display *display = XOpenDisplay(nullptr);
+   /* Reuse the persistent event connection when it is up; the query then only
+    * costs the RandR round trips, which all happen off the present path. */
+   Display *display = m_event_display;
+   bool owns_display = false;
+   if (!display)
+   {
+      display = XOpenDisplay(nullptr);
+      owns_display = true;
+   }
    if (!display)
    {
       WSI_LOG_WARNING("Failed to open X11 display, using 60Hz default");
@@ -203,7 +728,10 @@ double shm_presenter::get_window_refresh_rate()
       WSI_LOG_WARNING("XRandR extension not available");
    }
 
-   XCloseDisplay(display);
+   if (owns_display)
+   {
+      XCloseDisplay(display);
+   }
 
    if (!found_refresh_rate)
    {
@@ -225,219 +753,1205 @@ void shm_presenter::detect_refresh_rate()
    double detected_refresh_rate = get_window_refresh_rate();
 
    m_refresh_rate_hz = detected_refresh_rate;
-   auto interval_us = static_cast<long>(1000000.0 / detected_refresh_rate);
-   m_frame_interval = std::chrono::microseconds(interval_us);
+   auto interval_us = static_cast<int64_t>(1000000.0 / detected_refresh_rate);
+   m_frame_interval_us.store(interval_us, std::memory_order_relaxed);
+}
+
+bool shm_presenter::subscribe_geometry_events()
+{
+   m_event_display = XOpenDisplay(nullptr);
+   if (!m_event_display)
+   {
+      WSI_LOG_WARNING("Failed to open X display for geometry events, refresh rate will not track the window");
+      return false;
+   }
+
+   /* Event masks are per client: selecting from this second connection leaves
+    * the application's event queue untouched. */
+   XSelectInput(m_event_display, m_window, StructureNotifyMask);
+
+   int error_base = 0;
+   if (XRRQueryExtension(m_event_display, &m_rr_event_base, &error_base))
+   {
+      XRRSelectInput(m_event_display, DefaultRootWindow(m_event_display), RRScreenChangeNotifyMask);
+   }
+   else
+   {
+      m_rr_event_base = -1;
+   }
+
+   XFlush(m_event_display);
+   return true;
 }
 
-void shm_presenter::precompute_scaling_lut(uint32_t gpu_width, uint32_t display_width)
+void shm_presenter::process_events()
 {
-   if (m_last_gpu_width == gpu_width && m_last_display_width == display_width)
+   /* Recycle the segments the server has finished reading, so the present
+    * path usually finds its target segment released before it ever waits. */
+   drain_completion_events();
+
+   if (!m_event_display)
    {
       return;
    }
 
-   m_scaling_lut.reserve(display_width);
-   m_scaling_lut.resize(display_width);
+   bool rate_dirty = false;
+   while (XPending(m_event_display) > 0)
+   {
+      XEvent event;
+      XNextEvent(m_event_display, &event);
+
+      if (event.type == ConfigureNotify)
+      {
+         const XConfigureEvent &configure = event.xconfigure;
+         if (configure.window == m_window && m_wsi_surface != nullptr)
+         {
+            m_wsi_surface->update_cached_geometry(configure.width, configure.height);
+         }
+         /* A move may have dragged the window onto an output with a different
+          * refresh rate. */
+         rate_dirty = true;
+      }
+      else if (m_rr_event_base >= 0 && event.type == m_rr_event_base + RRScreenChangeNotify)
+      {
+         XRRUpdateConfiguration(&event);
+         rate_dirty = true;
+      }
+   }
 
-   for (uint32_t dst_x = 0; dst_x < display_width; dst_x++)
+   if (rate_dirty)
    {
-      uint32_t src_x = (dst_x * gpu_width) / display_width;
-      if (src_x >= gpu_width)
-         src_x = gpu_width - 1;
-      m_scaling_lut[dst_x] = src_x;
+      /* Requeried here on the event thread; the present path only reads the
+       * cached interval. */
+      detect_refresh_rate();
    }
 
-   m_last_gpu_width = gpu_width;
-   m_last_display_width = display_width;
+   maybe_trim_idle_resources();
 }
 
-#ifdef ENABLE_ARM_NEON
-void shm_presenter::copy_pixels_simd(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
-                                     uint32_t dst_width, uint32_t height)
+void shm_presenter::maybe_trim_idle_resources()
+{
+   if (m_idle_trim_us <= 0)
+   {
+      return;
+   }
+
+   std::lock_guard<std::mutex> lock(m_idle_mutex);
+   if (m_idle_trimmed ||
+       std::chrono::steady_clock::now() - m_last_present_time < std::chrono::microseconds(m_idle_trim_us))
+   {
+      return;
+   }
+
+   /* The present path refreshes the timestamp under m_idle_mutex before it
+    * touches any of this state, so reaching here means no copy is in flight
+    * and none can start until the trim finishes. */
+   stop_worker_pool();
+
+   m_scaling_lut.clear();
+   m_scaling_lut.shrink_to_fit();
+   m_scaling_weights.clear();
+   m_scaling_weights.shrink_to_fit();
+   m_row_lut.clear();
+   m_row_lut.shrink_to_fit();
+   m_row_weights.clear();
+   m_row_weights.shrink_to_fit();
+   m_lut_cache.clear();
+   m_lut_cache.shrink_to_fit();
+
+   /* Forget the cached geometry so the next present rebuilds its LUT pair. */
+   m_last_gpu_width = 0;
+   m_last_display_width = 0;
+   m_last_gpu_height = 0;
+   m_last_display_height = 0;
+
+   m_bounce_arena.clear();
+   m_bounce_arena.shrink_to_fit();
+
+   shm_segment_pool::instance().trim();
+
+   m_idle_trimmed = true;
+}
+
+void shm_presenter::stash_active_lut()
+{
+   if (m_scaling_lut.empty() && m_row_lut.empty())
+   {
+      return;
+   }
+
+   if (m_lut_cache.size() >= SCALING_LUT_CACHE_SIZE)
+   {
+      auto lru = m_lut_cache.begin();
+      for (auto it = m_lut_cache.begin(); it != m_lut_cache.end(); ++it)
+      {
+         if (it->last_used < lru->last_used)
+         {
+            lru = it;
+         }
+      }
+      m_lut_cache.erase(lru);
+   }
+
+   scaling_lut_entry entry;
+   entry.gpu_width = m_last_gpu_width;
+   entry.display_width = m_last_display_width;
+   entry.gpu_height = m_last_gpu_height;
+   entry.display_height = m_last_display_height;
+   entry.x_lut = std::move(m_scaling_lut);
+   entry.x_weights = std::move(m_scaling_weights);
+   entry.row_lut = std::move(m_row_lut);
+   entry.row_weights = std::move(m_row_weights);
+   entry.last_used = ++m_lut_use_counter;
+   m_lut_cache.push_back(std::move(entry));
+
+   m_scaling_lut.clear();
+   m_scaling_weights.clear();
+   m_row_lut.clear();
+   m_row_weights.clear();
+}
+
+/* Half-pixel-centred source positions in 24.8 fixed point: destination texel
+ * centre x + 0.5 maps to source (x + 0.5) * src / dst - 0.5.  The base index
+ * is clamped so the blend partner base + 1 always exists; the edge texels
+ * saturate their weight instead.  Exact-ratio positions land on whole texels
+ * with weight 0, which degenerates to the old nearest-neighbour result. */
+static void build_bilinear_lut(uint32_t src_size, uint32_t dst_size, std::vector<uint32_t> &lut,
+                               std::vector<uint8_t> &weights)
+{
+   lut.resize(dst_size);
+   weights.resize(dst_size);
+
+   if (src_size < 2)
+   {
+      std::fill(lut.begin(), lut.end(), 0u);
+      std::fill(weights.begin(), weights.end(), uint8_t{ 0 });
+      return;
+   }
+
+   const int64_t step = (static_cast<int64_t>(src_size) << 8) / dst_size;
+   for (uint32_t dst = 0; dst < dst_size; dst++)
+   {
+      int64_t pos = ((2 * static_cast<int64_t>(dst) + 1) * step - (int64_t{ 1 } << 8)) / 2;
+      if (pos < 0)
+      {
+         pos = 0;
+      }
+
+      uint32_t base = static_cast<uint32_t>(pos >> 8);
+      uint32_t frac = static_cast<uint32_t>(pos & 0xff);
+      if (base > src_size - 2)
+      {
+         base = src_size - 2;
+         frac = 0xff;
+      }
+
+      lut[dst] = base;
+      weights[dst] = static_cast<uint8_t>(frac);
+   }
+}
+
+void shm_presenter::precompute_scaling_lut(uint32_t gpu_width, uint32_t display_width, uint32_t gpu_height,
+                                           uint32_t display_height)
+{
+   if (m_last_gpu_width == gpu_width && m_last_display_width == display_width && m_last_gpu_height == gpu_height &&
+       m_last_display_height == display_height)
+   {
+      return;
+   }
+
+   stash_active_lut();
+
+   m_last_gpu_width = gpu_width;
+   m_last_display_width = display_width;
+   m_last_gpu_height = gpu_height;
+   m_last_display_height = display_height;
+
+   /* Cache hit: move the parked pair back out instead of rebuilding. */
+   for (auto it = m_lut_cache.begin(); it != m_lut_cache.end(); ++it)
+   {
+      if (it->gpu_width == gpu_width && it->display_width == display_width && it->gpu_height == gpu_height &&
+          it->display_height == display_height)
+      {
+         m_scaling_lut = std::move(it->x_lut);
+         m_scaling_weights = std::move(it->x_weights);
+         m_row_lut = std::move(it->row_lut);
+         m_row_weights = std::move(it->row_weights);
+         m_lut_cache.erase(it);
+         return;
+      }
+   }
+
+   /* Identity mappings keep the LUTs empty so the copy fast paths stay on. */
+   if (display_width != gpu_width)
+   {
+      build_bilinear_lut(gpu_width, display_width, m_scaling_lut, m_scaling_weights);
+   }
+
+   if (display_height != gpu_height)
+   {
+      build_bilinear_lut(gpu_height, display_height, m_row_lut, m_row_weights);
+   }
+}
+
+#ifdef ENABLE_ARM_NEON
+void shm_presenter::copy_pixels_simd(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
+                                     uint32_t dst_width, uint32_t height)
+{
+   /* Scaled copies are routed through scale_rows_bilinear before the copy
+    * kernels are picked; rows here always map 1:1. */
+   if (m_use_nt_stores)
+   {
+      for (uint32_t row = 0; row < height; row++)
+      {
+         copy_bytes_streaming(dst_pixels + (row * dst_width), src_pixels + (row * src_stride_pixels),
+                              dst_width * sizeof(uint32_t));
+      }
+      return;
+   }
+
+   for (uint32_t row = 0; row < height; row++)
+   {
+      const uint32_t *src_row = src_pixels + (row * src_stride_pixels);
+      uint32_t *dst_row = dst_pixels + (row * dst_width);
+
+      uint32_t x = 0;
+      bool use_aligned_simd = are_pointers_neon_aligned(&src_row[0], &dst_row[0]);
+
+      if (use_aligned_simd)
+      {
+         for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
+         {
+            uint32x4_t pixels = vld1q_u32(&src_row[x]);
+            vst1q_u32(&dst_row[x], pixels);
+         }
+      }
+      else
+      {
+         for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
+         {
+            uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(&src_row[x]));
+            vst1q_u8(reinterpret_cast<uint8_t *>(&dst_row[x]), bytes);
+         }
+      }
+
+      for (; x < dst_width; x++)
+      {
+         dst_row[x] = src_row[x];
+      }
+   }
+}
+#endif
+
+#ifdef WSI_SHM_X86_SIMD
+static constexpr uint32_t AVX2_PIXELS_PER_VECTOR = 8;
+
+__attribute__((target("sse4.1"))) void shm_presenter::copy_row_sse41(const uint32_t *src_row, uint32_t *dst_row,
+                                                                     uint32_t dst_width)
+{
+   uint32_t x = 0;
+
+   if (are_pointers_sse_aligned(&src_row[0], &dst_row[0]))
+   {
+      for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
+      {
+         __m128i pixels = _mm_load_si128(reinterpret_cast<const __m128i *>(&src_row[x]));
+         _mm_store_si128(reinterpret_cast<__m128i *>(&dst_row[x]), pixels);
+      }
+   }
+   else
+   {
+      for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
+      {
+         __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src_row[x]));
+         _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst_row[x]), pixels);
+      }
+   }
+
+   for (; x < dst_width; x++)
+   {
+      dst_row[x] = src_row[x];
+   }
+}
+
+__attribute__((target("avx2"))) void shm_presenter::copy_row_avx2(const uint32_t *src_row, uint32_t *dst_row,
+                                                                  uint32_t dst_width)
+{
+   uint32_t x = 0;
+
+   if (are_pointers_avx_aligned(&src_row[0], &dst_row[0]))
+   {
+      for (; x + (AVX2_PIXELS_PER_VECTOR - 1) < dst_width; x += AVX2_PIXELS_PER_VECTOR)
+      {
+         __m256i pixels = _mm256_load_si256(reinterpret_cast<const __m256i *>(&src_row[x]));
+         _mm256_store_si256(reinterpret_cast<__m256i *>(&dst_row[x]), pixels);
+      }
+   }
+   else
+   {
+      for (; x + (AVX2_PIXELS_PER_VECTOR - 1) < dst_width; x += AVX2_PIXELS_PER_VECTOR)
+      {
+         __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&src_row[x]));
+         _mm256_storeu_si256(reinterpret_cast<__m256i *>(&dst_row[x]), pixels);
+      }
+   }
+
+   for (; x < dst_width; x++)
+   {
+      dst_row[x] = src_row[x];
+   }
+}
+
+void shm_presenter::copy_pixels_simd(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
+                                     uint32_t dst_width, uint32_t height)
+{
+   /* Scaled copies are routed through scale_rows_bilinear before the copy
+    * kernels are picked; rows here always map 1:1. */
+   if (m_x86_simd_level == x86_simd_level::NONE)
+   {
+      copy_pixels_scalar(src_pixels, dst_pixels, src_stride_pixels, dst_width, height);
+      return;
+   }
+
+   if (m_use_nt_stores)
+   {
+      for (uint32_t row = 0; row < height; row++)
+      {
+         copy_bytes_streaming(dst_pixels + (row * dst_width), src_pixels + (row * src_stride_pixels),
+                              dst_width * sizeof(uint32_t));
+      }
+      return;
+   }
+
+   for (uint32_t row = 0; row < height; row++)
+   {
+      const uint32_t *src_row = src_pixels + (row * src_stride_pixels);
+      uint32_t *dst_row = dst_pixels + (row * dst_width);
+
+      if (m_x86_simd_level == x86_simd_level::AVX2)
+      {
+         copy_row_avx2(src_row, dst_row, dst_width);
+      }
+      else
+      {
+         copy_row_sse41(src_row, dst_row, dst_width);
+      }
+   }
+}
+#endif
+
+void shm_presenter::detect_nt_copy_threshold()
+{
+   long cache_size = 0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+   cache_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+#ifdef _SC_LEVEL2_CACHE_SIZE
+   if (cache_size <= 0)
+   {
+      cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+   }
+#endif
+   if (cache_size <= 0)
+   {
+      cache_size = FALLBACK_LLC_SIZE;
+   }
+
+   m_nt_copy_threshold = static_cast<size_t>(cache_size) / 2;
+}
+
+bool shm_presenter::use_nt_copy(size_t bytes) const
+{
+   return m_nt_copy_threshold != 0 && bytes >= m_nt_copy_threshold;
+}
+
+/* Candidate locations of the wsi_copy_bench machine profile, searched in
+ * order. Matches the search order of the layer's config files. */
+static constexpr const char *COPY_PROFILE_PATHS[] = {
+   "/etc/sky1/wsi-copy-profile.conf",
+   "/usr/share/cix-gpu/wsi-copy-profile.conf",
+};
+
+void shm_presenter::load_copy_profile()
+{
+   /* Built-in heuristics first; the profile only overrides what it sets. */
+   m_threading_pixel_threshold = THREADING_PIXEL_THRESHOLD;
+   m_profiled_copy_threads = 0;
+
+   FILE *file = nullptr;
+   const char *override_path = util::config::get().copy_profile();
+   if (override_path != nullptr)
+   {
+      file = std::fopen(override_path, "r");
+   }
+   else
+   {
+      for (const char *path : COPY_PROFILE_PATHS)
+      {
+         file = std::fopen(path, "r");
+         if (file != nullptr)
+         {
+            break;
+         }
+      }
+   }
+
+   if (file == nullptr)
+   {
+      /* Not an error: machines are profiled opportunistically and the
+       * heuristics serve the rest. */
+      return;
+   }
+
+   char line[128];
+   while (std::fgets(line, sizeof(line), file) != nullptr)
+   {
+      if (line[0] == '#' || line[0] == '\n')
+      {
+         continue;
+      }
+
+      char *separator = std::strchr(line, '=');
+      if (separator == nullptr)
+      {
+         continue;
+      }
+      *separator = '\0';
+      const char *key = line;
+      const char *value = separator + 1;
+
+      char *end = nullptr;
+      const unsigned long long parsed = std::strtoull(value, &end, 10);
+      if (end == value || parsed == 0)
+      {
+         continue;
+      }
+
+      if (std::strcmp(key, "COPY_THREADS") == 0)
+      {
+         m_profiled_copy_threads = static_cast<uint32_t>(std::min<unsigned long long>(parsed, MAX_WORKER_THREADS));
+      }
+      else if (std::strcmp(key, "COPY_THREAD_PIXELS") == 0)
+      {
+         m_threading_pixel_threshold = static_cast<uint32_t>(std::min<unsigned long long>(parsed, UINT32_MAX));
+      }
+      else if (std::strcmp(key, "COPY_NT_BYTES") == 0)
+      {
+         m_nt_copy_threshold = static_cast<size_t>(parsed);
+      }
+   }
+
+   std::fclose(file);
+}
+
+#ifdef WSI_SHM_X86_SIMD
+__attribute__((target("sse2"))) void shm_presenter::copy_bytes_streaming_sse2(void *dst, const void *src, size_t size)
+{
+   auto *d = static_cast<char *>(dst);
+   auto *s = static_cast<const char *>(src);
+
+   /* movntdq needs a 16-byte aligned destination; copy a short head normally
+    * to get there. */
+   size_t head = (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15;
+   head = std::min(head, size);
+   std::memcpy(d, s, head);
+   d += head;
+   s += head;
+   size -= head;
+
+   const size_t vectors = size / 16;
+   for (size_t i = 0; i < vectors; i++)
+   {
+      __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s) + i);
+      _mm_stream_si128(reinterpret_cast<__m128i *>(d) + i, pixels);
+   }
+
+   std::memcpy(d + vectors * 16, s + vectors * 16, size - vectors * 16);
+}
+#endif
+
+#if defined(ENABLE_ARM_NEON) && defined(__aarch64__)
+void shm_presenter::copy_bytes_streaming_neon(void *dst, const void *src, size_t size)
+{
+   auto *d = static_cast<unsigned char *>(dst);
+   auto *s = static_cast<const unsigned char *>(src);
+
+   const size_t pairs = size / 32;
+   for (size_t i = 0; i < pairs; i++)
+   {
+      uint8x16_t lo = vld1q_u8(s + i * 32);
+      uint8x16_t hi = vld1q_u8(s + i * 32 + 16);
+      /* ACLE has no intrinsic for the non-temporal pair store. */
+      __asm__ volatile("stnp %q0, %q1, [%2]" : : "w"(lo), "w"(hi), "r"(d + i * 32) : "memory");
+   }
+
+   std::memcpy(d + pairs * 32, s + pairs * 32, size - pairs * 32);
+}
+#endif
+
+void shm_presenter::copy_bytes_streaming(void *dst, const void *src, size_t size)
+{
+#if defined(WSI_SHM_X86_SIMD)
+   if (m_x86_simd_level != x86_simd_level::NONE)
+   {
+      copy_bytes_streaming_sse2(dst, src, size);
+      return;
+   }
+   std::memcpy(dst, src, size);
+#elif defined(ENABLE_ARM_NEON) && defined(__aarch64__)
+   copy_bytes_streaming_neon(dst, src, size);
+#else
+   std::memcpy(dst, src, size);
+#endif
+}
+
+#ifdef WSI_SHM_X86_SIMD
+__attribute__((target("sse4.1"))) void shm_presenter::copy_bytes_streaming_load_sse41(void *dst, const void *src,
+                                                                                      size_t size)
+{
+   auto *d = static_cast<char *>(dst);
+   auto *s = static_cast<const char *>(src);
+
+   /* movntdqa needs a 16-byte aligned source; copy a short head normally to
+    * get there. */
+   size_t head = (16 - (reinterpret_cast<uintptr_t>(s) & 15)) & 15;
+   head = std::min(head, size);
+   std::memcpy(d, s, head);
+   d += head;
+   s += head;
+   size -= head;
+
+   const size_t vectors = size / 16;
+   for (size_t i = 0; i < vectors; i++)
+   {
+      __m128i pixels = _mm_stream_load_si128(const_cast<__m128i *>(reinterpret_cast<const __m128i *>(s)) + i);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(d) + i, pixels);
+   }
+
+   std::memcpy(d + vectors * 16, s + vectors * 16, size - vectors * 16);
+}
+#endif
+
+#if defined(ENABLE_ARM_NEON) && defined(__aarch64__)
+void shm_presenter::copy_bytes_streaming_load_neon(void *dst, const void *src, size_t size)
+{
+   auto *d = static_cast<unsigned char *>(dst);
+   auto *s = static_cast<const unsigned char *>(src);
+
+   const size_t pairs = size / 32;
+   for (size_t i = 0; i < pairs; i++)
+   {
+      uint8x16_t lo;
+      uint8x16_t hi;
+      /* As with the store, ACLE has no intrinsic for the non-temporal pair load. */
+      __asm__ volatile("ldnp %q0, %q1, [%2]" : "=w"(lo), "=w"(hi) : "r"(s + i * 32) : "memory");
+      vst1q_u8(d + i * 32, lo);
+      vst1q_u8(d + i * 32 + 16, hi);
+   }
+
+   std::memcpy(d + pairs * 32, s + pairs * 32, size - pairs * 32);
+}
+#endif
+
+void shm_presenter::copy_bytes_streaming_load(void *dst, const void *src, size_t size)
+{
+#if defined(WSI_SHM_X86_SIMD)
+   /* SSE41 is the floor for movntdqa; the probe folds its absence into NONE. */
+   if (m_x86_simd_level != x86_simd_level::NONE)
+   {
+      copy_bytes_streaming_load_sse41(dst, src, size);
+      return;
+   }
+   std::memcpy(dst, src, size);
+#elif defined(ENABLE_ARM_NEON) && defined(__aarch64__)
+   copy_bytes_streaming_load_neon(dst, src, size);
+#else
+   std::memcpy(dst, src, size);
+#endif
+}
+
+#ifdef WSI_SHM_X86_SIMD
+__attribute__((target("sse"))) void shm_presenter::streaming_store_fence()
+{
+   if (m_x86_simd_level != x86_simd_level::NONE)
+   {
+      _mm_sfence();
+   }
+}
+#elif defined(ENABLE_ARM_NEON) && defined(__aarch64__)
+void shm_presenter::streaming_store_fence()
+{
+   /* stnp is weakly ordered; drain the streamed writes before the copied rows
+    * are published. */
+   __asm__ volatile("dmb ishst" ::: "memory");
+}
+#else
+void shm_presenter::streaming_store_fence()
+{
+}
+#endif
+
+void shm_presenter::copy_pixels_scalar(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
+                                       uint32_t dst_width, uint32_t height)
+{
+   /* Scaled copies never reach this kernel; rows map 1:1 and only the strides
+    * may differ. */
+   size_t copy_size = dst_width * sizeof(uint32_t);
+   for (uint32_t row = 0; row < height; row++)
+   {
+      const uint32_t *src_row = src_pixels + (row * src_stride_pixels);
+      uint32_t *dst_row = dst_pixels + (row * dst_width);
+
+      if (row + 1 < height)
+      {
+         __builtin_prefetch(src_row + src_stride_pixels, 0, 3);
+      }
+
+      if (m_use_nt_stores)
+      {
+         copy_bytes_streaming(dst_row, src_row, copy_size);
+      }
+      else
+      {
+         memcpy(dst_row, src_row, copy_size);
+      }
+   }
+}
+
+/* Fixed-point lerp of two XRGB/BGRA pixels with w in [0, 256): the red/blue
+ * and alpha/green channel pairs ride in separate 16-bit halves of one 32-bit
+ * multiply, so a blend is four multiplies per pixel instead of per channel. */
+static inline uint32_t lerp_pixels(uint32_t a, uint32_t b, uint32_t w)
+{
+   const uint32_t inv = 256 - w;
+   const uint32_t rb = (((a & 0x00ff00ffu) * inv + (b & 0x00ff00ffu) * w) >> 8) & 0x00ff00ffu;
+   const uint32_t ag = (((a >> 8) & 0x00ff00ffu) * inv + ((b >> 8) & 0x00ff00ffu) * w) & 0xff00ff00u;
+   return rb | ag;
+}
+
+void shm_presenter::scale_row_bilinear_scalar(const uint32_t *src_row0, const uint32_t *src_row1, uint32_t *dst_row,
+                                              uint32_t dst_width, uint32_t wy)
+{
+   const bool x_scaled = !m_scaling_lut.empty();
+
+   for (uint32_t x = 0; x < dst_width; x++)
+   {
+      uint32_t x0 = x;
+      uint32_t wx = 0;
+      if (x_scaled)
+      {
+         x0 = m_scaling_lut[x];
+         wx = m_scaling_weights[x];
+      }
+      const uint32_t x1 = x_scaled ? x0 + 1 : x0;
+
+      uint32_t out = lerp_pixels(src_row0[x0], src_row0[x1], wx);
+      if (wy != 0)
+      {
+         const uint32_t bottom = lerp_pixels(src_row1[x0], src_row1[x1], wx);
+         out = lerp_pixels(out, bottom, wy);
+      }
+      dst_row[x] = out;
+   }
+}
+
+#ifdef ENABLE_ARM_NEON
+void shm_presenter::scale_row_bilinear_neon(const uint32_t *src_row0, const uint32_t *src_row1, uint32_t *dst_row,
+                                            uint32_t dst_width, uint32_t wy)
+{
+   /* The horizontal weight changes per destination pixel, which rules out one
+    * widening multiply across a whole vector. Instead each pixel's adjacent
+    * texel pair is loaded as one 8-byte vector and both horizontal blends run
+    * in 16-bit lanes; the products carry a factor of 256, so the vertical
+    * blend's second factor of 256 comes out in a single narrowing shift. */
+   const uint16x4_t vwy = vdup_n_u16(static_cast<uint16_t>(wy));
+   const uint16x4_t vwy_inv = vdup_n_u16(static_cast<uint16_t>(256 - wy));
+
+   for (uint32_t x = 0; x < dst_width; x++)
+   {
+      const uint32_t x0 = m_scaling_lut[x];
+      const uint16_t wx = m_scaling_weights[x];
+      const uint16x8_t wx_pair = vcombine_u16(vdup_n_u16(static_cast<uint16_t>(256 - wx)), vdup_n_u16(wx));
+
+      const uint16x8_t top_pair = vmovl_u8(vld1_u8(reinterpret_cast<const uint8_t *>(&src_row0[x0])));
+      const uint16x8_t top_scaled = vmulq_u16(top_pair, wx_pair);
+      const uint16x4_t top = vadd_u16(vget_low_u16(top_scaled), vget_high_u16(top_scaled));
+
+      const uint16x8_t bottom_pair = vmovl_u8(vld1_u8(reinterpret_cast<const uint8_t *>(&src_row1[x0])));
+      const uint16x8_t bottom_scaled = vmulq_u16(bottom_pair, wx_pair);
+      const uint16x4_t bottom = vadd_u16(vget_low_u16(bottom_scaled), vget_high_u16(bottom_scaled));
+
+      const uint32x4_t blended = vmlal_u16(vmull_u16(top, vwy_inv), bottom, vwy);
+      const uint16x4_t narrowed = vshrn_n_u32(blended, 16);
+      const uint8x8_t pixel = vmovn_u16(vcombine_u16(narrowed, narrowed));
+      vst1_lane_u32(&dst_row[x], vreinterpret_u32_u8(pixel), 0);
+   }
+}
+
+void shm_presenter::blend_rows_neon(const uint32_t *src_row0, const uint32_t *src_row1, uint32_t *dst_row,
+                                    uint32_t dst_width, uint32_t wy)
+{
+   /* Vertical-only mapping: the weight is uniform across the row, so four
+    * pixels blend per iteration. */
+   const uint16x8_t vwy = vdupq_n_u16(static_cast<uint16_t>(wy));
+   const uint16x8_t vwy_inv = vdupq_n_u16(static_cast<uint16_t>(256 - wy));
+
+   uint32_t x = 0;
+   for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
+   {
+      const uint8x16_t top8 = vld1q_u8(reinterpret_cast<const uint8_t *>(&src_row0[x]));
+      const uint8x16_t bottom8 = vld1q_u8(reinterpret_cast<const uint8_t *>(&src_row1[x]));
+
+      const uint16x8_t blended_lo = vaddq_u16(vmulq_u16(vmovl_u8(vget_low_u8(top8)), vwy_inv),
+                                              vmulq_u16(vmovl_u8(vget_low_u8(bottom8)), vwy));
+      const uint16x8_t blended_hi = vaddq_u16(vmulq_u16(vmovl_u8(vget_high_u8(top8)), vwy_inv),
+                                              vmulq_u16(vmovl_u8(vget_high_u8(bottom8)), vwy));
+
+      const uint8x16_t out = vcombine_u8(vshrn_n_u16(blended_lo, 8), vshrn_n_u16(blended_hi, 8));
+      vst1q_u8(reinterpret_cast<uint8_t *>(&dst_row[x]), out);
+   }
+
+   for (; x < dst_width; x++)
+   {
+      dst_row[x] = lerp_pixels(src_row0[x], src_row1[x], wy);
+   }
+}
+#endif
+
+#ifdef WSI_SHM_X86_SIMD
+__attribute__((target("avx2"))) static inline __m256i lerp_pixels_avx2(__m256i a, __m256i b, __m256i w, __m256i w_inv)
+{
+   const __m256i mask_rb = _mm256_set1_epi32(0x00ff00ff);
+   const __m256i mask_ag = _mm256_set1_epi32(static_cast<int>(0xff00ff00));
+
+   const __m256i rb =
+      _mm256_and_si256(_mm256_srli_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(a, mask_rb), w_inv),
+                                                          _mm256_mullo_epi32(_mm256_and_si256(b, mask_rb), w)),
+                                         8),
+                       mask_rb);
+   const __m256i ag =
+      _mm256_and_si256(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 8), mask_rb), w_inv),
+                                        _mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(b, 8), mask_rb), w)),
+                       mask_ag);
+   return _mm256_or_si256(rb, ag);
+}
+
+__attribute__((target("avx2"))) void shm_presenter::scale_row_bilinear_avx2(const uint32_t *src_row0,
+                                                                            const uint32_t *src_row1,
+                                                                            uint32_t *dst_row, uint32_t dst_width,
+                                                                            uint32_t wy)
+{
+   const __m256i vwy = _mm256_set1_epi32(static_cast<int>(wy));
+   const __m256i vwy_inv = _mm256_set1_epi32(static_cast<int>(256 - wy));
+   const __m256i v256 = _mm256_set1_epi32(256);
+   const __m256i one = _mm256_set1_epi32(1);
+
+   uint32_t x = 0;
+   for (; x + (AVX2_PIXELS_PER_VECTOR - 1) < dst_width; x += AVX2_PIXELS_PER_VECTOR)
+   {
+      const __m256i idx0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&m_scaling_lut[x]));
+      const __m256i idx1 = _mm256_add_epi32(idx0, one);
+      const __m256i wx =
+         _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&m_scaling_weights[x])));
+      const __m256i wx_inv = _mm256_sub_epi32(v256, wx);
+
+      const __m256i p00 = _mm256_i32gather_epi32(reinterpret_cast<const int *>(src_row0), idx0, sizeof(uint32_t));
+      const __m256i p01 = _mm256_i32gather_epi32(reinterpret_cast<const int *>(src_row0), idx1, sizeof(uint32_t));
+      __m256i out = lerp_pixels_avx2(p00, p01, wx, wx_inv);
+
+      if (wy != 0)
+      {
+         const __m256i p10 = _mm256_i32gather_epi32(reinterpret_cast<const int *>(src_row1), idx0, sizeof(uint32_t));
+         const __m256i p11 = _mm256_i32gather_epi32(reinterpret_cast<const int *>(src_row1), idx1, sizeof(uint32_t));
+         const __m256i bottom = lerp_pixels_avx2(p10, p11, wx, wx_inv);
+         out = lerp_pixels_avx2(out, bottom, vwy, vwy_inv);
+      }
+
+      /* One write of the destination row; streamed past the LLC threshold. */
+      if (m_use_nt_stores && is_aligned(&dst_row[x], 32))
+      {
+         _mm256_stream_si256(reinterpret_cast<__m256i *>(&dst_row[x]), out);
+      }
+      else
+      {
+         _mm256_storeu_si256(reinterpret_cast<__m256i *>(&dst_row[x]), out);
+      }
+   }
+
+   for (; x < dst_width; x++)
+   {
+      const uint32_t x0 = m_scaling_lut[x];
+      const uint32_t wx = m_scaling_weights[x];
+      uint32_t out = lerp_pixels(src_row0[x0], src_row0[x0 + 1], wx);
+      if (wy != 0)
+      {
+         out = lerp_pixels(out, lerp_pixels(src_row1[x0], src_row1[x0 + 1], wx), wy);
+      }
+      dst_row[x] = out;
+   }
+}
+
+__attribute__((target("avx2"))) void shm_presenter::blend_rows_avx2(const uint32_t *src_row0, const uint32_t *src_row1,
+                                                                    uint32_t *dst_row, uint32_t dst_width, uint32_t wy)
+{
+   const __m256i vwy = _mm256_set1_epi32(static_cast<int>(wy));
+   const __m256i vwy_inv = _mm256_set1_epi32(static_cast<int>(256 - wy));
+
+   uint32_t x = 0;
+   for (; x + (AVX2_PIXELS_PER_VECTOR - 1) < dst_width; x += AVX2_PIXELS_PER_VECTOR)
+   {
+      const __m256i top = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&src_row0[x]));
+      const __m256i bottom = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&src_row1[x]));
+      const __m256i out = lerp_pixels_avx2(top, bottom, vwy, vwy_inv);
+
+      if (m_use_nt_stores && is_aligned(&dst_row[x], 32))
+      {
+         _mm256_stream_si256(reinterpret_cast<__m256i *>(&dst_row[x]), out);
+      }
+      else
+      {
+         _mm256_storeu_si256(reinterpret_cast<__m256i *>(&dst_row[x]), out);
+      }
+   }
+
+   for (; x < dst_width; x++)
+   {
+      dst_row[x] = lerp_pixels(src_row0[x], src_row1[x], wy);
+   }
+}
+#endif
+
+void shm_presenter::scale_rows_bilinear(const uint32_t *src_base, uint32_t *dst_base, uint32_t src_stride_pixels,
+                                        uint32_t dst_width, uint32_t first_row, uint32_t row_count)
+{
+   const bool x_scaled = !m_scaling_lut.empty();
+
+   for (uint32_t i = 0; i < row_count; i++)
+   {
+      const uint32_t row = first_row + i;
+      uint32_t y0 = row;
+      uint32_t wy = 0;
+      if (!m_row_lut.empty())
+      {
+         y0 = m_row_lut[row];
+         wy = m_row_weights[row];
+      }
+
+      const uint32_t *src_row0 = src_base + (static_cast<size_t>(y0) * src_stride_pixels);
+      /* A weight of 0 never reads the partner row; aliasing it to the top row
+       * keeps the kernels free of bounds checks on the last source row. */
+      const uint32_t *src_row1 = wy != 0 ? src_row0 + src_stride_pixels : src_row0;
+      uint32_t *dst_row = dst_base + (static_cast<size_t>(row) * dst_width);
+
+#if defined(ENABLE_ARM_NEON)
+      if (x_scaled)
+      {
+         scale_row_bilinear_neon(src_row0, src_row1, dst_row, dst_width, wy);
+      }
+      else
+      {
+         blend_rows_neon(src_row0, src_row1, dst_row, dst_width, wy);
+      }
+#elif defined(WSI_SHM_X86_SIMD)
+      if (m_x86_simd_level == x86_simd_level::AVX2)
+      {
+         if (x_scaled)
+         {
+            scale_row_bilinear_avx2(src_row0, src_row1, dst_row, dst_width, wy);
+         }
+         else
+         {
+            blend_rows_avx2(src_row0, src_row1, dst_row, dst_width, wy);
+         }
+      }
+      else
+      {
+         /* SSE4.1 has no gather for the horizontal fetches, so below AVX2 the
+          * fused scalar kernel covers scaling. */
+         scale_row_bilinear_scalar(src_row0, src_row1, dst_row, dst_width, wy);
+      }
+#else
+      scale_row_bilinear_scalar(src_row0, src_row1, dst_row, dst_width, wy);
+#endif
+   }
+}
+
+void shm_presenter::start_worker_pool()
+{
+   {
+      /* The pool restarts after an idle trim; clear the flag its last shutdown
+       * left behind. */
+      std::lock_guard<std::mutex> lock(m_pool_mutex);
+      m_pool_shutdown = false;
+   }
+
+   uint32_t copy_threads = m_profiled_copy_threads;
+   if (copy_threads == 0)
+   {
+      /* No machine profile: size the pool from the hardware thread count. */
+      copy_threads = std::thread::hardware_concurrency();
+      if (copy_threads == 0)
+      {
+         copy_threads = 1;
+      }
+   }
+
+   /* The presentation thread takes part in each copy, so one worker less than the
+    * targeted concurrency is enough. */
+   const uint32_t num_workers = std::min(copy_threads, MAX_WORKER_THREADS) - 1;
+
+   m_copy_workers.reserve(num_workers);
+   for (uint32_t i = 0; i < num_workers; i++)
+   {
+      try
+      {
+         m_copy_workers.emplace_back(&shm_presenter::worker_thread_loop, this);
+      }
+      catch (const std::system_error &)
+      {
+         WSI_LOG_WARNING("Failed to start SHM copy worker %u of %u, continuing with fewer workers", i, num_workers);
+         break;
+      }
+   }
+}
+
+void shm_presenter::stop_worker_pool()
+{
+   {
+      std::lock_guard<std::mutex> lock(m_pool_mutex);
+      m_pool_shutdown = true;
+   }
+   m_pool_cv.notify_all();
+
+   for (auto &worker : m_copy_workers)
+   {
+      if (worker.joinable())
+      {
+         worker.join();
+      }
+   }
+   m_copy_workers.clear();
+}
+
+void shm_presenter::worker_thread_loop()
 {
-   if (m_scaling_lut.empty() || m_scaling_lut[dst_width - 1] == dst_width - 1)
+   util::apply_presentation_thread_scheduling("SHM copy worker");
+
+   uint64_t last_generation = 0;
+
+   std::unique_lock<std::mutex> lock(m_pool_mutex);
+   while (true)
    {
-      for (uint32_t row = 0; row < height; row++)
+      m_pool_cv.wait(lock, [this, last_generation] { return m_pool_shutdown || m_job_generation != last_generation; });
+      if (m_pool_shutdown)
       {
-         const uint32_t *src_row = src_pixels + (row * src_stride_pixels);
-         uint32_t *dst_row = dst_pixels + (row * dst_width);
+         return;
+      }
 
-         uint32_t x = 0;
-         bool use_aligned_simd = are_pointers_neon_aligned(&src_row[0], &dst_row[0]);
+      last_generation = m_job_generation;
+      m_workers_active++;
+      lock.unlock();
 
-         if (use_aligned_simd)
-         {
-            for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
-            {
-               uint32x4_t pixels = vld1q_u32(&src_row[x]);
-               vst1q_u32(&dst_row[x], pixels);
-            }
-         }
-         else
-         {
-            for (; x + LOOP_UNROLL_BOUNDARY < dst_width; x += SIMD_VECTOR_SIZE)
-            {
-               uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(&src_row[x]));
-               vst1q_u8(reinterpret_cast<uint8_t *>(&dst_row[x]), bytes);
-            }
-         }
+      process_copy_rows();
 
-         for (; x < dst_width; x++)
-         {
-            dst_row[x] = src_row[x];
-         }
+      lock.lock();
+      m_workers_active--;
+      if (m_workers_active == 0)
+      {
+         m_pool_done_cv.notify_one();
       }
    }
-   else
-   {
-      copy_pixels_scalar(src_pixels, dst_pixels, src_stride_pixels, dst_width, height);
-   }
 }
-#endif
 
-void shm_presenter::copy_pixels_scalar(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
-                                       uint32_t dst_width, uint32_t height)
+void shm_presenter::process_copy_rows()
 {
-   uint32_t src_width = src_stride_pixels;
+   uint32_t rows_processed = 0;
 
-   if (src_width == dst_width &&
-       (m_scaling_lut.empty() || (dst_width > 0 && m_scaling_lut[dst_width - 1] == dst_width - 1)))
+   /* Claim small row ranges until the job is exhausted. The shared row counter lets
+    * fast workers steal the tail of slower workers' strips, so uneven strips don't
+    * leave cores idle. */
+   while (true)
    {
-      size_t copy_size = dst_width * sizeof(uint32_t);
-      for (uint32_t row = 0; row < height; row++)
+      const uint32_t row = m_copy_job.next_row.fetch_add(COPY_ROWS_PER_CHUNK, std::memory_order_relaxed);
+      if (row >= m_copy_job.height)
       {
-         const uint32_t *src_row = src_pixels + (row * src_stride_pixels);
-         uint32_t *dst_row = dst_pixels + (row * dst_width);
+         break;
+      }
+
+      const uint32_t count = std::min(COPY_ROWS_PER_CHUNK, m_copy_job.height - row);
 
-         if (row + 1 < height)
+      if (m_copy_job.prefault)
+      {
+         /* One "row" per page: a single store faults the page in on the node
+          * of the worker that claimed it. See prefault_segment(). */
+         uint32_t *chunk_dst = m_copy_job.dst_pixels + (row * m_copy_job.dst_width);
+         for (uint32_t page = 0; page < count; page++)
          {
-            __builtin_prefetch(src_row + src_stride_pixels, 0, 3);
+            chunk_dst[page * m_copy_job.dst_width] = 0;
          }
-
-         memcpy(dst_row, src_row, copy_size);
+         rows_processed += count;
+         continue;
       }
-      return;
-   }
-
-   for (uint32_t row = 0; row < height; row++)
-   {
-      const uint32_t *src_row = src_pixels + (row * src_stride_pixels);
-      uint32_t *dst_row = dst_pixels + (row * dst_width);
 
-      if (row + 1 < height)
+      try
       {
-         __builtin_prefetch(src_row + src_stride_pixels, 0, 3);
-      }
+         if (m_copy_job.scaled)
+         {
+            /* The bilinear rows address both buffers absolutely, so the
+             * chunk's row range is handed over as-is. */
+            scale_rows_bilinear(m_copy_job.src_pixels, m_copy_job.dst_pixels, m_copy_job.src_stride_pixels,
+                                m_copy_job.dst_width, row, count);
+         }
+         else
+         {
+            const uint32_t *chunk_src = m_copy_job.src_pixels + (row * m_copy_job.src_stride_pixels);
+            uint32_t *chunk_dst = m_copy_job.dst_pixels + (row * m_copy_job.dst_width);
 
-      uint32_t dst_x = 0;
-      for (; dst_x + LOOP_UNROLL_BOUNDARY < dst_width; dst_x += SIMD_VECTOR_SIZE)
+            if (m_copy_job.conversion != pixel_conversion::NONE)
+            {
+               convert_pixels(m_copy_job.conversion, chunk_src, chunk_dst, m_copy_job.src_stride_pixels,
+                              m_copy_job.dst_width, count);
+            }
+            else
+            {
+#if defined(ENABLE_ARM_NEON) || defined(WSI_SHM_X86_SIMD)
+               copy_pixels_simd(chunk_src, chunk_dst, m_copy_job.src_stride_pixels, m_copy_job.dst_width, count);
+#else
+               copy_pixels_scalar(chunk_src, chunk_dst, m_copy_job.src_stride_pixels, m_copy_job.dst_width, count);
+#endif
+            }
+         }
+      }
+      catch (const std::exception &e)
       {
-         dst_row[dst_x] = src_row[m_scaling_lut[dst_x]];
-         dst_row[dst_x + 1] = src_row[m_scaling_lut[dst_x + 1]];
-         dst_row[dst_x + 2] = src_row[m_scaling_lut[dst_x + 2]];
-         dst_row[dst_x + 3] = src_row[m_scaling_lut[dst_x + 3]];
+         WSI_LOG_ERROR("Thread pixel copy failed with exception: %s", e.what());
+         m_thread_error_occurred.store(true, std::memory_order_release);
       }
-
-      for (; dst_x < dst_width; dst_x++)
+      catch (...)
       {
-         dst_row[dst_x] = src_row[m_scaling_lut[dst_x]];
+         WSI_LOG_ERROR("Thread pixel copy failed with unknown exception");
+         m_thread_error_occurred.store(true, std::memory_order_release);
       }
+
+      rows_processed += count;
+   }
+
+   if (m_use_nt_stores)
+   {
+      /* Order this thread's streamed writes before the row count that
+       * publishes them to the waiting presentation thread. */
+      streaming_store_fence();
+   }
+
+   if (rows_processed > 0)
+   {
+      m_copy_job.rows_done.fetch_add(rows_processed, std::memory_order_acq_rel);
    }
 }
 
 void shm_presenter::copy_pixels_threaded(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
-                                         uint32_t dst_width, uint32_t height)
+                                         uint32_t dst_width, uint32_t height, pixel_conversion conversion)
 {
    if (!src_pixels || !dst_pixels || dst_width == 0 || height == 0)
    {
       return;
    }
 
+   /* Plain copies past the LLC threshold stream straight to memory; the flag
+    * is only flipped while the worker pool is idle. */
+   const bool use_nt = conversion == pixel_conversion::NONE &&
+                       use_nt_copy(static_cast<size_t>(dst_width) * height * sizeof(uint32_t));
+
+   /* Scaled plain copies run the fused bilinear kernels; both they and the
+    * pool's chunking address rows absolutely, so scaled copies spread over
+    * the workers exactly like 1:1 ones. Conversions keep ignoring the LUTs,
+    * as they always have. */
+   const bool scaled =
+      conversion == pixel_conversion::NONE && (!m_scaling_lut.empty() || !m_row_lut.empty());
+
    const uint32_t total_pixels = dst_width * height;
 
-   if (total_pixels > THREADING_PIXEL_THRESHOLD)
+   if (total_pixels > m_threading_pixel_threshold && !m_copy_workers.empty())
    {
-      const uint32_t num_threads = std::min(std::thread::hardware_concurrency(), MAX_WORKER_THREADS);
-      if (num_threads > 1)
       {
-         const uint32_t rows_per_thread = height / num_threads;
-         std::vector<std::future<void>> futures;
-         futures.reserve(num_threads);
-
-         try
-         {
-            for (uint32_t t = 0; t < num_threads; t++)
-            {
-               uint32_t start_row = t * rows_per_thread;
-               uint32_t end_row = (t == num_threads - 1) ? height : (t + 1) * rows_per_thread;
-
-               if (start_row >= height)
-                  break;
-               if (end_row > height)
-                  end_row = height;
-
-               futures.emplace_back(std::async(std::launch::async, [=]() {
-                  try
-                  {
-                     const uint32_t *thread_src = src_pixels + (start_row * src_stride_pixels);
-                     uint32_t *thread_dst = dst_pixels + (start_row * dst_width);
-                     uint32_t thread_height = end_row - start_row;
+         std::unique_lock<std::mutex> lock(m_pool_mutex);
+         /* A worker that woke up late for an earlier job may still be scanning the
+          * job fields; wait for it to retire before overwriting them. */
+         m_pool_done_cv.wait(lock, [this] { return m_workers_active == 0; });
+         m_copy_job.src_pixels = src_pixels;
+         m_copy_job.dst_pixels = dst_pixels;
+         m_copy_job.src_stride_pixels = src_stride_pixels;
+         m_copy_job.dst_width = dst_width;
+         m_copy_job.height = height;
+         m_copy_job.conversion = conversion;
+         m_copy_job.prefault = false;
+         m_copy_job.scaled = scaled;
+         m_use_nt_stores = use_nt;
+         m_copy_job.next_row.store(0, std::memory_order_relaxed);
+         m_copy_job.rows_done.store(0, std::memory_order_relaxed);
+         ++m_job_generation;
+      }
+      m_pool_cv.notify_all();
 
-                     if (thread_height > 0)
-                     {
-#ifdef ENABLE_ARM_NEON
-                        copy_pixels_simd(thread_src, thread_dst, src_stride_pixels, dst_width, thread_height);
-#else
-                        copy_pixels_scalar(thread_src, thread_dst, src_stride_pixels, dst_width, thread_height);
-#endif
-                     }
-                  }
-                  catch (const std::exception &e)
-                  {
-                     WSI_LOG_ERROR("Thread pixel copy failed with exception: %s", e.what());
-                     m_thread_error_occurred.store(true, std::memory_order_release);
-                  }
-                  catch (...)
-                  {
-                     WSI_LOG_ERROR("Thread pixel copy failed with unknown exception");
-                     m_thread_error_occurred.store(true, std::memory_order_release);
-                  }
-               }));
-            }
+      /* The presentation thread takes part in the copy instead of idling. */
+      process_copy_rows();
 
-            for (auto &future : futures)
-            {
-               if (future.valid())
-               {
-                  future.wait();
-               }
-            }
+      {
+         /* Wait until every row was copied and no worker is still touching the job,
+          * so the next frame can be published without racing a straggler. */
+         std::unique_lock<std::mutex> lock(m_pool_mutex);
+         m_pool_done_cv.wait(lock, [this] {
+            return m_workers_active == 0 && m_copy_job.rows_done.load(std::memory_order_acquire) >= m_copy_job.height;
+         });
+      }
 
-            if (m_thread_error_occurred.load(std::memory_order_acquire))
-            {
-               std::lock_guard<std::mutex> lock(m_error_recovery_mutex);
-               WSI_LOG_ERROR("Thread errors detected, falling back to single-threaded processing");
-               m_thread_error_occurred.store(false, std::memory_order_release);
-               copy_pixels_optimized_single_thread(src_pixels, dst_pixels, src_stride_pixels, dst_width, height);
-            }
+      if (m_thread_error_occurred.load(std::memory_order_acquire))
+      {
+         std::lock_guard<std::mutex> lock(m_error_recovery_mutex);
+         WSI_LOG_ERROR("Thread errors detected, falling back to single-threaded processing");
+         m_thread_error_occurred.store(false, std::memory_order_release);
+         if (scaled)
+         {
+            scale_rows_bilinear(src_pixels, dst_pixels, src_stride_pixels, dst_width, 0, height);
          }
-         catch (...)
+         else
          {
-            std::lock_guard<std::mutex> lock(m_error_recovery_mutex);
-            WSI_LOG_ERROR("Threading setup failed, falling back to single-threaded processing");
-            copy_pixels_optimized_single_thread(src_pixels, dst_pixels, src_stride_pixels, dst_width, height);
+            copy_pixels_optimized_single_thread(src_pixels, dst_pixels, src_stride_pixels, dst_width, height,
+                                                conversion);
+         }
+         if (use_nt)
+         {
+            streaming_store_fence();
          }
-         return;
       }
+      return;
    }
 
-   copy_pixels_optimized_single_thread(src_pixels, dst_pixels, src_stride_pixels, dst_width, height);
+   m_use_nt_stores = use_nt;
+   if (scaled)
+   {
+      scale_rows_bilinear(src_pixels, dst_pixels, src_stride_pixels, dst_width, 0, height);
+   }
+   else
+   {
+      copy_pixels_optimized_single_thread(src_pixels, dst_pixels, src_stride_pixels, dst_width, height, conversion);
+   }
+   if (use_nt)
+   {
+      streaming_store_fence();
+   }
 }
 
 void shm_presenter::copy_pixels_optimized_single_thread(const uint32_t *src_pixels, uint32_t *dst_pixels,
-                                                        uint32_t src_stride_pixels, uint32_t dst_width, uint32_t height)
+                                                        uint32_t src_stride_pixels, uint32_t dst_width, uint32_t height,
+                                                        pixel_conversion conversion)
 {
-#ifdef ENABLE_ARM_NEON
+   if (conversion != pixel_conversion::NONE)
+   {
+      convert_pixels(conversion, src_pixels, dst_pixels, src_stride_pixels, dst_width, height);
+      return;
+   }
+#if defined(ENABLE_ARM_NEON) || defined(WSI_SHM_X86_SIMD)
    copy_pixels_simd(src_pixels, dst_pixels, src_stride_pixels, dst_width, height);
 #else
    copy_pixels_scalar(src_pixels, dst_pixels, src_stride_pixels, dst_width, height);
@@ -445,16 +1959,53 @@ void shm_presenter::copy_pixels_optimized_single_thread(const uint32_t *src_pixe
 }
 
 void shm_presenter::copy_pixels_optimized(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
-                                          uint32_t dst_width, uint32_t height)
+                                          uint32_t dst_width, uint32_t height, pixel_conversion conversion)
 {
-   if (src_stride_pixels == dst_width && m_scaling_lut.empty())
+   if (conversion == pixel_conversion::NONE && src_stride_pixels == dst_width && m_scaling_lut.empty() &&
+       m_row_lut.empty())
    {
       const size_t copy_size = dst_width * height * sizeof(uint32_t);
-      std::memcpy(dst_pixels, src_pixels, copy_size);
+      if (m_src_write_combined)
+      {
+         /* The source reads back uncached; stream it through the non-temporal
+          * load buffers straight into the SHM buffer. No bounce is needed for
+          * a plain copy, the destination is cached memory. */
+         copy_bytes_streaming_load(dst_pixels, src_pixels, copy_size);
+      }
+      else if (use_nt_copy(copy_size))
+      {
+         /* A full 4K frame is an order of magnitude bigger than most LLCs;
+          * streaming it keeps the copy from evicting the application's
+          * working set every frame. */
+         copy_bytes_streaming(dst_pixels, src_pixels, copy_size);
+         streaming_store_fence();
+      }
+      else
+      {
+         std::memcpy(dst_pixels, src_pixels, copy_size);
+      }
       return;
    }
 
-   copy_pixels_threaded(src_pixels, dst_pixels, src_stride_pixels, dst_width, height);
+   if (m_src_write_combined && height > 0)
+   {
+      /* Scaling and conversion gather from the source, and every gathered
+       * load from a write-combined mapping pays the full memory latency.
+       * Stage the rows the kernels will touch into the cached bounce arena
+       * with one sequential streaming pass first. */
+      /* The last bilinear row also reads its blend partner one row down. */
+      const uint32_t src_rows =
+         m_row_lut.empty() ? height : std::min(m_row_lut[height - 1] + 2, m_last_gpu_height);
+      const size_t arena_pixels = static_cast<size_t>(src_rows) * src_stride_pixels;
+      if (m_bounce_arena.size() < arena_pixels)
+      {
+         m_bounce_arena.resize(arena_pixels);
+      }
+      copy_bytes_streaming_load(m_bounce_arena.data(), src_pixels, arena_pixels * sizeof(uint32_t));
+      src_pixels = m_bounce_arena.data();
+   }
+
+   copy_pixels_threaded(src_pixels, dst_pixels, src_stride_pixels, dst_width, height, conversion);
 }
 
 void shm_presenter::start_async_sync()
@@ -590,18 +2141,12 @@ void shm_presenter::wait_for_presentation_fence()
       return;
    }
 
+   /* Queued, not flushed: the await and reset ride the present cycle's single
+    * flush. The await is server-side pacing - it holds back the requests
+    * queued after it until the previous frame's trigger has fired - so nothing
+    * here needs to reach the server ahead of the put. */
    xcb_sync_await_fence(m_connection, 1, &m_presentation_fence);
-   int flush_result = xcb_flush(m_connection);
-   if (flush_result <= 0)
-   {
-      WSI_LOG_ERROR("SHM presenter xcb_flush failed: result=%d", flush_result);
-   }
    xcb_sync_reset_fence(m_connection, m_presentation_fence);
-   int flush_result2 = xcb_flush(m_connection);
-   if (flush_result2 <= 0)
-   {
-      WSI_LOG_ERROR("SHM presenter xcb_flush failed: result=%d", flush_result2);
-   }
 }
 
 void shm_presenter::trigger_presentation_fence()
@@ -611,11 +2156,107 @@ void shm_presenter::trigger_presentation_fence()
       return;
    }
 
+   /* Queued behind the put; present_image flushes both together. */
    xcb_sync_trigger_fence(m_connection, m_presentation_fence);
-   int trigger_flush_result = xcb_flush(m_connection);
-   if (trigger_flush_result <= 0)
+}
+
+bool shm_presenter::init_completion_pipelining()
+{
+   /* Completion events for a put are delivered to the client that issued it,
+    * so puts go out on a private connection: its event queue is layer-owned
+    * and can be drained freely, while the application's queue on m_connection
+    * stays untouched. */
+   xcb_connection_t *connection = xcb_connect(nullptr, nullptr);
+   if (connection == nullptr || xcb_connection_has_error(connection))
    {
-      WSI_LOG_ERROR("SHM presenter xcb_flush failed: result=%d", trigger_flush_result);
+      if (connection != nullptr)
+      {
+         xcb_disconnect(connection);
+      }
+      WSI_LOG_WARNING("Could not open a private connection for SHM completion events, using fence pacing");
+      return false;
+   }
+
+   const xcb_query_extension_reply_t *shm_ext = xcb_get_extension_data(connection, &xcb_shm_id);
+   if (shm_ext == nullptr || !shm_ext->present)
+   {
+      xcb_disconnect(connection);
+      return false;
+   }
+
+   m_put_connection = connection;
+   m_shm_completion_event = shm_ext->first_event + XCB_SHM_COMPLETION;
+   m_completion_pipelining = true;
+   return true;
+}
+
+void shm_presenter::drain_completion_events()
+{
+   if (!m_completion_pipelining)
+   {
+      return;
+   }
+
+   xcb_generic_event_t *event = nullptr;
+   while ((event = xcb_poll_for_event(m_put_connection)) != nullptr)
+   {
+      if ((event->response_type & 0x7f) == m_shm_completion_event)
+      {
+         auto *completion = reinterpret_cast<xcb_shm_completion_event_t *>(event);
+
+         std::lock_guard<std::mutex> lock(m_completion_mutex);
+         auto it = m_segment_busy.find(completion->shmseg);
+         if (it != m_segment_busy.end())
+         {
+            *it->second = false;
+         }
+      }
+      free(event);
+   }
+}
+
+void shm_presenter::wait_for_segment_release(bool *busy_flag)
+{
+   drain_completion_events();
+   {
+      std::lock_guard<std::mutex> lock(m_completion_mutex);
+      if (!*busy_flag)
+      {
+         return;
+      }
+   }
+
+   /* Two frames at the current rate: a healthy server releases the other
+    * segment well within one, so anything past this is a stall, not pacing. */
+   const auto deadline = std::chrono::steady_clock::now() +
+                         std::chrono::microseconds(2 * m_frame_interval_us.load(std::memory_order_relaxed));
+   const int fd = xcb_get_file_descriptor(m_put_connection);
+
+   while (true)
+   {
+      struct pollfd poll_fd = { fd, POLLIN, 0 };
+      poll(&poll_fd, 1, SEGMENT_RELEASE_POLL_MS);
+
+      drain_completion_events();
+
+      std::lock_guard<std::mutex> lock(m_completion_mutex);
+      if (!*busy_flag)
+      {
+         return;
+      }
+
+      if (std::chrono::steady_clock::now() >= deadline)
+      {
+         /* Reusing the segment early can tear one frame; stalling the present
+          * path on a wedged server would be worse. */
+         if (!m_completion_timeout_logged)
+         {
+            WSI_LOG_WARNING("Timed out waiting for an SHM completion event, reusing the segment");
+            m_completion_timeout_logged = true;
+         }
+         *busy_flag = false;
+         return;
+      }
    }
 }
 
@@ -648,8 +2289,40 @@ VkResult shm_presenter::init(xcb_connection_t *connection, xcb_window_t window,
    m_window = window;
    m_wsi_surface = wsi_surface;
 
+   /* Opened before the graphics context and the segment attaches so both land
+    * on the connection the puts go out on. */
+   if (!init_completion_pipelining())
+   {
+      m_put_connection = m_connection;
+   }
+
+   /* Subscribe before the first rate query so it can reuse the connection;
+    * while the subscription is live the surface can answer geometry queries
+    * from its cache. */
+   if (subscribe_geometry_events())
+   {
+      m_wsi_surface->set_geometry_event_stream_active(true);
+   }
+
    detect_refresh_rate();
 
+#ifdef WSI_SHM_X86_SIMD
+   detect_x86_simd_level();
+#endif
+
+   detect_nt_copy_threshold();
+
+   /* Loaded after the threshold detection so a measured profile wins over the
+    * cache-size heuristic. */
+   load_copy_profile();
+
+   /* Seeded here so a swapchain that never presents still gets its workers
+    * parked once the idle period elapses. */
+   m_idle_trim_us = static_cast<int64_t>(util::config::get().idle_trim_ms()) * 1000;
+   m_last_present_time = std::chrono::steady_clock::now();
+
+   start_worker_pool();
+
    cache_x11_formats();
 
    VkResult result = create_graphics_context();
@@ -659,11 +2332,71 @@ VkResult shm_presenter::init(xcb_connection_t *connection, xcb_window_t window,
       return result;
    }
 
-   init_fence_sync();
+   if (!m_completion_pipelining)
+   {
+      /* Only needed when completion events cannot pace segment reuse. */
+      init_fence_sync();
+   }
 
    return VK_SUCCESS;
 }
 
+void shm_presenter::prefault_segment(void *addr, size_t size)
+{
+   /* SysV segments are attached lazily: the first store to each page takes a
+    * minor fault and commits the page on the NUMA node of the faulting thread.
+    * Fault fresh segments in through the copy worker pool, with the same
+    * chunked claiming as the real copies, so on multi-socket machines the
+    * pages spread across the nodes the copy workers run on instead of all
+    * landing on whichever node happened to run swapchain creation. Fresh
+    * segments are zero-filled, so the touching stores change nothing. */
+   auto *base = static_cast<uint32_t *>(addr);
+   const uint32_t pixels_per_page = PREFAULT_PAGE_SIZE / sizeof(uint32_t);
+   const uint32_t full_pages = static_cast<uint32_t>(size / PREFAULT_PAGE_SIZE);
+
+   if (full_pages > 0 && !m_copy_workers.empty())
+   {
+      {
+         std::unique_lock<std::mutex> lock(m_pool_mutex);
+         m_pool_done_cv.wait(lock, [this] { return m_workers_active == 0; });
+         m_copy_job.src_pixels = nullptr;
+         m_copy_job.dst_pixels = base;
+         m_copy_job.src_stride_pixels = 0;
+         m_copy_job.dst_width = pixels_per_page;
+         m_copy_job.height = full_pages;
+         m_copy_job.conversion = pixel_conversion::NONE;
+         m_copy_job.prefault = true;
+         m_copy_job.scaled = false;
+         m_use_nt_stores = false;
+         m_copy_job.next_row.store(0, std::memory_order_relaxed);
+         m_copy_job.rows_done.store(0, std::memory_order_relaxed);
+         ++m_job_generation;
+      }
+      m_pool_cv.notify_all();
+
+      process_copy_rows();
+
+      std::unique_lock<std::mutex> lock(m_pool_mutex);
+      m_pool_done_cv.wait(lock, [this] {
+         return m_workers_active == 0 && m_copy_job.rows_done.load(std::memory_order_acquire) >= m_copy_job.height;
+      });
+   }
+   else
+   {
+      for (uint32_t page = 0; page < full_pages; page++)
+      {
+         base[page * pixels_per_page] = 0;
+      }
+   }
+
+   if (size % PREFAULT_PAGE_SIZE != 0)
+   {
+      /* The stride is a multiple of 4, so a partial tail page has room for the
+       * touching store. */
+      base[full_pages * pixels_per_page] = 0;
+   }
+}
+
 VkResult shm_presenter::create_image_resources(x11_image_data *image_data, uint32_t width, uint32_t height, int depth)
 {
    image_data->width = width;
@@ -676,92 +2409,125 @@ VkResult shm_presenter::create_image_resources(x11_image_data *image_data, uint3
    size_t shm_size = image_data->stride * height;
    image_data->shm_size = shm_size;
 
-   image_data->shm_id = shmget(IPC_PRIVATE, shm_size, IPC_CREAT | SHM_PERMISSIONS);
+   bool fresh = false;
+   image_data->shm_id = shm_segment_pool::instance().acquire(shm_size, &image_data->shm_addr, &fresh);
    if (image_data->shm_id < 0)
    {
       WSI_LOG_ERROR("Failed to create shared memory segment of size %zu", shm_size);
+      image_data->shm_addr = nullptr;
       return VK_ERROR_OUT_OF_HOST_MEMORY;
    }
-
-   image_data->shm_addr = shmat(image_data->shm_id, nullptr, 0);
-   if (image_data->shm_addr == (void *)-1)
+   if (fresh)
    {
-      WSI_LOG_ERROR("Failed to attach shared memory segment");
-      shmctl(image_data->shm_id, IPC_RMID, nullptr);
-      image_data->shm_id = -1;
-      return VK_ERROR_OUT_OF_HOST_MEMORY;
+      prefault_segment(image_data->shm_addr, shm_size);
    }
 
-   image_data->shm_seg = xcb_generate_id(m_connection);
-   xcb_shm_attach(m_connection, image_data->shm_seg, image_data->shm_id, 0);
+   image_data->shm_seg = xcb_generate_id(m_put_connection);
+   xcb_shm_attach(m_put_connection, image_data->shm_seg, image_data->shm_id, 0);
 
-   image_data->shm_id_alt = shmget(IPC_PRIVATE, shm_size, IPC_CREAT | SHM_PERMISSIONS);
+   bool fresh_alt = false;
+   image_data->shm_id_alt = shm_segment_pool::instance().acquire(shm_size, &image_data->shm_addr_alt, &fresh_alt);
    if (image_data->shm_id_alt < 0)
    {
       WSI_LOG_ERROR("Failed to create alternate shared memory segment");
+      image_data->shm_addr_alt = nullptr;
    }
    else
    {
-      image_data->shm_addr_alt = shmat(image_data->shm_id_alt, nullptr, 0);
-      if (image_data->shm_addr_alt == (void *)-1)
+      if (fresh_alt)
       {
-         WSI_LOG_ERROR("Failed to attach alternate shared memory segment");
-         shmctl(image_data->shm_id_alt, IPC_RMID, nullptr);
-         image_data->shm_id_alt = -1;
-         image_data->shm_addr_alt = nullptr;
+         prefault_segment(image_data->shm_addr_alt, shm_size);
       }
-      else
+      image_data->shm_seg_alt = xcb_generate_id(m_put_connection);
+      xcb_shm_attach(m_put_connection, image_data->shm_seg_alt, image_data->shm_id_alt, 0);
+   }
+
+   if (m_completion_pipelining)
+   {
+      std::lock_guard<std::mutex> lock(m_completion_mutex);
+      image_data->shm_seg_busy = false;
+      m_segment_busy[image_data->shm_seg] = &image_data->shm_seg_busy;
+      if (image_data->shm_seg_alt != XCB_NONE)
       {
-         image_data->shm_seg_alt = xcb_generate_id(m_connection);
-         xcb_shm_attach(m_connection, image_data->shm_seg_alt, image_data->shm_id_alt, 0);
+         image_data->shm_seg_alt_busy = false;
+         m_segment_busy[image_data->shm_seg_alt] = &image_data->shm_seg_alt_busy;
       }
    }
 
-   int create_resources_flush_result = xcb_flush(m_connection);
+   int create_resources_flush_result = xcb_flush(m_put_connection);
    if (create_resources_flush_result <= 0)
    {
       WSI_LOG_ERROR("SHM presenter xcb_flush failed: result=%d", create_resources_flush_result);
    }
 
-   xcb_get_input_focus_cookie_t sync_cookie = xcb_get_input_focus(m_connection);
-   xcb_get_input_focus_reply_t *sync_reply = xcb_get_input_focus_reply(m_connection, sync_cookie, nullptr);
+   xcb_get_input_focus_cookie_t sync_cookie = xcb_get_input_focus(m_put_connection);
+   xcb_get_input_focus_reply_t *sync_reply = xcb_get_input_focus_reply(m_put_connection, sync_cookie, nullptr);
    if (sync_reply)
    {
       free(sync_reply);
    }
 
-   shmctl(image_data->shm_id, IPC_RMID, nullptr);
-   if (image_data->shm_id_alt >= 0)
-   {
-      shmctl(image_data->shm_id_alt, IPC_RMID, nullptr);
-   }
-
    return VK_SUCCESS;
 }
 
 
 
 
-VkResult shm_presenter::present_image(x11_image_data *image_data, uint32_t /*serial*/)
+VkResult shm_presenter::present_image(x11_image_data *image_data, uint32_t /*serial*/, const VkRectLayerKHR *damage_rects,
+                                      uint32_t damage_rect_count)
 {
-
-   if (m_fence_available && !m_first_frame)
    {
-      wait_for_presentation_fence();
+      /* Refreshing the timestamp under the trim lock also fences against the
+       * idle governor on the event thread: after this block it cannot trim
+       * until the presenter goes idle again. */
+      std::lock_guard<std::mutex> lock(m_idle_mutex);
+      m_last_present_time = std::chrono::steady_clock::now();
+      if (m_idle_trimmed)
+      {
+         /* The LUTs, the bounce arena and the pooled segments rebuild
+          * themselves on demand; only the workers need an explicit restart. */
+         start_worker_pool();
+         m_idle_trimmed = false;
+      }
    }
-   else if (!m_fence_available)
+
+   /* Restrict the copy and the put to the band of rows the damage rectangles cover. Rows outside the
+    * band are unchanged since the last present, so the window already shows their content. Degenerate
+    * rectangle lists fall back to a full-frame copy. */
+   uint32_t copy_first_row = 0;
+   uint32_t copy_row_count = image_data->height;
+   if (damage_rect_count > 0)
    {
-      if (m_sync_pending)
+      uint32_t first_dirty_row = image_data->height;
+      uint32_t end_dirty_row = 0;
+      for (uint32_t i = 0; i < damage_rect_count; i++)
+      {
+         uint32_t rect_first = std::min<uint32_t>(std::max(damage_rects[i].offset.y, 0), image_data->height);
+         uint32_t rect_end = std::min<uint64_t>(rect_first + damage_rects[i].extent.height, image_data->height);
+         first_dirty_row = std::min(first_dirty_row, rect_first);
+         end_dirty_row = std::max(end_dirty_row, rect_end);
+      }
+      if (first_dirty_row < end_dirty_row)
       {
-         ensure_sync_completion();
+         copy_first_row = first_dirty_row;
+         copy_row_count = end_dirty_row - first_dirty_row;
       }
    }
-   m_first_frame = false;
 
-   int present_flush_result = xcb_flush(m_connection);
-   if (present_flush_result <= 0)
+   if (!m_completion_pipelining)
    {
-      WSI_LOG_ERROR("SHM presenter xcb_flush failed: result=%d", present_flush_result);
+      if (m_fence_available && !m_first_frame)
+      {
+         wait_for_presentation_fence();
+      }
+      else if (!m_fence_available)
+      {
+         if (m_sync_pending)
+         {
+            ensure_sync_completion();
+         }
+      }
+      m_first_frame = false;
    }
 
    image_data->use_alt_buffer = !image_data->use_alt_buffer;
@@ -769,6 +2535,17 @@ VkResult shm_presenter::present_image(x11_image_data *image_data, uint32_t /*ser
       image_data->use_alt_buffer && image_data->shm_seg_alt != XCB_NONE ? image_data->shm_seg_alt : image_data->shm_seg;
    void *active_addr = image_data->use_alt_buffer && image_data->shm_addr_alt != nullptr ? image_data->shm_addr_alt :
                                                                                            image_data->shm_addr;
+   bool *active_seg_busy = image_data->use_alt_buffer && image_data->shm_seg_alt != XCB_NONE ?
+                              &image_data->shm_seg_alt_busy :
+                              &image_data->shm_seg_busy;
+
+   if (m_completion_pipelining)
+   {
+      /* Only waits while the server is still reading this segment's put from
+       * two presents ago; with the other segment's blit typically still in
+       * flight, the copy below overlaps it. */
+      wait_for_segment_release(active_seg_busy);
+   }
 
    if (active_addr && image_data->shm_size > 0)
    {
@@ -788,34 +2565,46 @@ VkResult shm_presenter::present_image(x11_image_data *image_data, uint32_t /*ser
 
             char *src_base = (char *)mapped_memory + source_offset;
 
-            if (gpu_pixels_per_row != display_pixels_per_row)
-            {
-               precompute_scaling_lut(gpu_pixels_per_row, display_pixels_per_row);
-            }
-            else
-            {
-               m_scaling_lut.clear();
-            }
+            /* Recorded per image when the memory type was chosen at bind time;
+             * republishing it here is a plain load, not a memory property query. */
+            m_src_write_combined = !image_data->external_mem.is_host_memory_cached();
+
+            precompute_scaling_lut(gpu_pixels_per_row, display_pixels_per_row, image_data->height,
+                                   image_data->height);
 
             char *dst_base = (char *)active_addr;
 
             if (bytes_per_pixel == 4)
             {
-               uint32_t *src_pixels = (uint32_t *)src_base;
-               uint32_t *dst_pixels = (uint32_t *)dst_base;
+               /* bytes_per_pixel describes the destination; wide source formats
+                * (RGBA16F, RGB10A2) are converted and packed in the same pass as
+                * the copy.  Strides count 32-bit units, so an RGBA16F pixel just
+                * spans two of them and the per-row offsets stay valid. */
+               const pixel_conversion conversion = conversion_for_format(image_data->format);
+
                uint32_t src_stride_pixels = source_stride / bytes_per_pixel;
+               uint32_t dst_stride_pixels = dest_stride / bytes_per_pixel;
+               uint32_t *src_pixels = (uint32_t *)src_base + copy_first_row * src_stride_pixels;
+               uint32_t *dst_pixels = (uint32_t *)dst_base + copy_first_row * dst_stride_pixels;
 
                copy_pixels_optimized(src_pixels, dst_pixels, src_stride_pixels, display_pixels_per_row,
-                                     image_data->height);
+                                     copy_row_count, conversion);
             }
             else
             {
-               for (uint32_t row = 0; row < image_data->height; row++)
+               for (uint32_t row = copy_first_row; row < copy_first_row + copy_row_count; row++)
                {
                   char *src_row = src_base + (row * source_stride);
                   char *dst_row = dst_base + (row * dest_stride);
                   size_t copy_size = std::min(source_stride, dest_stride);
-                  std::memcpy(dst_row, src_row, copy_size);
+                  if (m_src_write_combined)
+                  {
+                     copy_bytes_streaming_load(dst_row, src_row, copy_size);
+                  }
+                  else
+                  {
+                     std::memcpy(dst_row, src_row, copy_size);
+                  }
                }
             }
          }
@@ -835,15 +2624,23 @@ VkResult shm_presenter::present_image(x11_image_data *image_data, uint32_t /*ser
       return VK_ERROR_UNKNOWN;
    }
 
-   xcb_shm_put_image(m_connection, m_window, m_gc, image_data->width, image_data->height, 0, 0, image_data->width,
-                     image_data->height, 0, 0, image_data->depth, XCB_IMAGE_FORMAT_Z_PIXMAP, 0, active_seg, 0);
+   xcb_shm_put_image(m_put_connection, m_window, m_gc, image_data->width, image_data->height, 0, copy_first_row,
+                     image_data->width, copy_row_count, 0, copy_first_row, image_data->depth,
+                     XCB_IMAGE_FORMAT_Z_PIXMAP, m_completion_pipelining ? 1 : 0, active_seg, 0);
+
+   if (m_completion_pipelining)
+   {
+      std::lock_guard<std::mutex> lock(m_completion_mutex);
+      *active_seg_busy = true;
+   }
 
    auto current_time = std::chrono::steady_clock::now();
    auto time_since_last = std::chrono::duration_cast<std::chrono::microseconds>(current_time - m_last_frame_time);
 
-   if (m_last_frame_time.time_since_epoch().count() > 0 && time_since_last < m_frame_interval)
+   const auto frame_interval = std::chrono::microseconds(m_frame_interval_us.load(std::memory_order_relaxed));
+   if (m_last_frame_time.time_since_epoch().count() > 0 && time_since_last < frame_interval)
    {
-      auto sleep_time = m_frame_interval - time_since_last;
+      auto sleep_time = frame_interval - time_since_last;
 
       if (sleep_time > std::chrono::microseconds(500))
       {
@@ -851,7 +2648,7 @@ VkResult shm_presenter::present_image(x11_image_data *image_data, uint32_t /*ser
          std::this_thread::sleep_for(conservative_sleep);
       }
 
-      auto target_time = m_last_frame_time + m_frame_interval;
+      auto target_time = m_last_frame_time + frame_interval;
       while (std::chrono::steady_clock::now() < target_time)
       {
          std::this_thread::sleep_for(std::chrono::microseconds(10));
@@ -860,7 +2657,12 @@ VkResult shm_presenter::present_image(x11_image_data *image_data, uint32_t /*ser
    }
    m_last_frame_time = current_time;
 
-   if (m_fence_available)
+   if (m_completion_pipelining)
+   {
+      /* The completion event requested with the put paces segment reuse;
+       * nothing extra to queue. */
+   }
+   else if (m_fence_available)
    {
       trigger_presentation_fence();
    }
@@ -869,7 +2671,12 @@ VkResult shm_presenter::present_image(x11_image_data *image_data, uint32_t /*ser
       start_async_sync();
    }
 
-   int final_flush_result = xcb_flush(m_connection);
+   /* The present cycle's only flush: everything queued above - the put, and on
+    * the fence fallback the await/reset before the copy and the trigger (or
+    * geometry sync request) after it - leaves in one write syscall. Replies
+    * and events come back through the shared event drain, which never needs a
+    * flush of its own. */
+   int final_flush_result = xcb_flush(m_put_connection);
    if (final_flush_result <= 0)
    {
       WSI_LOG_ERROR("SHM presenter xcb_flush failed: result=%d", final_flush_result);
@@ -879,10 +2686,22 @@ VkResult shm_presenter::present_image(x11_image_data *image_data, uint32_t /*ser
 }
 void shm_presenter::destroy_image_resources(x11_image_data *image_data)
 {
+   if (m_completion_pipelining)
+   {
+      /* The detaches below are queued behind any in-flight put, so the server
+       * finishes reading first; a completion event arriving after this simply
+       * finds no entry. */
+      std::lock_guard<std::mutex> lock(m_completion_mutex);
+      m_segment_busy.erase(image_data->shm_seg);
+      m_segment_busy.erase(image_data->shm_seg_alt);
+      image_data->shm_seg_busy = false;
+      image_data->shm_seg_alt_busy = false;
+   }
+
    if (image_data->shm_seg != XCB_NONE)
    {
-      xcb_generic_error_t *error = xcb_request_check(m_connection, 
-          xcb_shm_detach_checked(m_connection, image_data->shm_seg));
+      xcb_generic_error_t *error = xcb_request_check(m_put_connection,
+          xcb_shm_detach_checked(m_put_connection, image_data->shm_seg));
       if (error)
       {
          WSI_LOG_ERROR("SHM detach failed: error_code=%d, sequence=%d", 
@@ -895,8 +2714,8 @@ void shm_presenter::destroy_image_resources(x11_image_data *image_data)
 
    if (image_data->shm_seg_alt != XCB_NONE)
    {
-      xcb_generic_error_t *error = xcb_request_check(m_connection, 
-          xcb_shm_detach_checked(m_connection, image_data->shm_seg_alt));
+      xcb_generic_error_t *error = xcb_request_check(m_put_connection,
+          xcb_shm_detach_checked(m_put_connection, image_data->shm_seg_alt));
       if (error)
       {
          WSI_LOG_ERROR("SHM alt detach failed: error_code=%d, sequence=%d", 
@@ -907,23 +2726,18 @@ void shm_presenter::destroy_image_resources(x11_image_data *image_data)
       image_data->shm_seg_alt = XCB_NONE;
    }
 
+   /* The segments go back to the process-wide pool rather than being detached,
+    * so the next swapchain generation can pick them up without fresh page
+    * faults; the pool detaches them itself once it is full. */
    if (image_data->shm_addr && image_data->shm_addr != (void *)-1)
    {
-      int detach_result = shmdt(image_data->shm_addr);
-      if (detach_result != 0)
-      {
-         WSI_LOG_ERROR("Failed to detach shared memory: errno=%d", errno);
-      }
+      shm_segment_pool::instance().release(image_data->shm_id, image_data->shm_addr);
       image_data->shm_addr = nullptr;
    }
 
    if (image_data->shm_addr_alt && image_data->shm_addr_alt != (void *)-1)
    {
-      int detach_result = shmdt(image_data->shm_addr_alt);
-      if (detach_result != 0)
-      {
-         WSI_LOG_ERROR("Failed to detach alternate shared memory: errno=%d", errno);
-      }
+      shm_segment_pool::instance().release(image_data->shm_id_alt, image_data->shm_addr_alt);
       image_data->shm_addr_alt = nullptr;
    }
 
@@ -940,15 +2754,15 @@ bool shm_presenter::is_available(xcb_connection_t * /*connection*/, surface *wsi
 
 VkResult shm_presenter::create_graphics_context()
 {
-   m_gc = xcb_generate_id(m_connection);
+   m_gc = xcb_generate_id(m_put_connection);
 
    uint32_t values[] = { 0, 0 };
 
    uint32_t mask = GC_COLOR_MASK;
 
-   xcb_create_gc(m_connection, m_gc, m_window, mask, values);
+   xcb_create_gc(m_put_connection, m_gc, m_window, mask, values);
 
-   int create_gc_flush_result = xcb_flush(m_connection);
+   int create_gc_flush_result = xcb_flush(m_put_connection);
    if (create_gc_flush_result <= 0)
    {
       WSI_LOG_ERROR("SHM presenter xcb_flush failed: result=%d", create_gc_flush_result);
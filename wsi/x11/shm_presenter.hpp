@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2025 Arm Limited.
+ * Copyright (c) 2025-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -41,8 +41,18 @@
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
 #include <xcb/sync.h>
 
+/* Runtime dispatched x86 SIMD copy kernels are available on x86 builds. */
+#if defined(__x86_64__) || defined(__i386__)
+#define WSI_SHM_X86_SIMD 1
+#endif
+
+/* From Xlib; kept out of this header to avoid pulling in its macro namespace. */
+struct _XDisplay;
+
 namespace wsi
 {
 namespace x11
@@ -62,21 +72,87 @@ public:
 
    VkResult create_image_resources(x11_image_data *image_data, uint32_t width, uint32_t height, int depth);
 
-   VkResult present_image(x11_image_data *image_data, uint32_t serial);
+   /**
+    * @brief Copy the image into the SHM segment and put it to the window.
+    *
+    * @param image_data        The image to present.
+    * @param serial            Serial number of the present request.
+    * @param damage_rects      Optional VK_KHR_incremental_present damage rectangles. The copy and the
+    *                          put are restricted to the dirty row band they cover.
+    * @param damage_rect_count Number of rectangles; 0 presents the full frame.
+    */
+   VkResult present_image(x11_image_data *image_data, uint32_t serial, const VkRectLayerKHR *damage_rects,
+                          uint32_t damage_rect_count);
 
    void destroy_image_resources(x11_image_data *image_data);
 
    bool is_available(xcb_connection_t *connection, surface *wsi_surface);
 
+   /**
+    * @brief Drain the presenter's private X connections.
+    *
+    * Called from the swapchain's event thread. SHM completion events release
+    * the segments the server has finished reading, so the present path
+    * usually finds its target segment already recycled. ConfigureNotify keeps
+    * the surface's geometry cache current and, together with RandR
+    * screen-change events, triggers a requery of the cached refresh rate on
+    * this thread, so the present path never waits on an X reply for either.
+    * Also drives the idle governor, trimming pooled resources once the
+    * presenter has gone quiet.
+    */
+   void process_events();
+
 private:
    xcb_connection_t *m_connection = nullptr;
    xcb_window_t m_window = 0;
    surface *m_wsi_surface = nullptr;
    xcb_gcontext_t m_gc = XCB_NONE;
 
+   /**
+    * @brief Bilinear scaling LUTs.
+    *
+    * Each destination column/row maps to the left/top source index in the
+    * *_lut vector plus an 8-bit fixed-point blend weight towards the next
+    * source texel in the *_weights vector. Identity mappings keep all four
+    * empty so the copy fast paths stay on, and exact-ratio positions get a
+    * weight of 0, which degenerates to the old nearest-neighbour result.
+    */
    std::vector<uint32_t> m_scaling_lut;
+   std::vector<uint8_t> m_scaling_weights;
+   std::vector<uint32_t> m_row_lut;
+   std::vector<uint8_t> m_row_weights;
    uint32_t m_last_gpu_width = 0;
    uint32_t m_last_display_width = 0;
+   uint32_t m_last_gpu_height = 0;
+   uint32_t m_last_display_height = 0;
+
+   /**
+    * @brief A parked pair of scaling LUTs, keyed by the sizes they map.
+    *
+    * Interactive resizes flip between a handful of sizes frame to frame, so
+    * instead of rebuilding the LUTs on every size change the active pair is
+    * moved back into this cache and a cached pair is moved out, both O(1).
+    */
+   struct scaling_lut_entry
+   {
+      uint32_t gpu_width = 0;
+      uint32_t display_width = 0;
+      uint32_t gpu_height = 0;
+      uint32_t display_height = 0;
+      std::vector<uint32_t> x_lut;
+      std::vector<uint8_t> x_weights;
+      std::vector<uint32_t> row_lut;
+      std::vector<uint8_t> row_weights;
+      uint64_t last_used = 0;
+   };
+
+   std::vector<scaling_lut_entry> m_lut_cache;
+   uint64_t m_lut_use_counter = 0;
+
+   /**
+    * @brief Park the active LUT pair in the cache, evicting the LRU entry if full.
+    */
+   void stash_active_lut();
 
    xcb_get_geometry_cookie_t m_pending_sync_cookie;
    bool m_sync_pending = false;
@@ -85,32 +161,372 @@ private:
    bool m_fence_available = false;
    bool m_first_frame = true;
 
+   /**
+    * @brief Connection the puts are issued on.
+    *
+    * A private connection when completion pipelining is active, otherwise an
+    * alias of m_connection. Puts on the private connection request
+    * XCB_SHM_COMPLETION events, and because the connection is layer-owned
+    * those can be drained without consuming events the application is waiting
+    * for. Segment reuse is then paced by the completions instead of a fence
+    * round trip, so the copy of frame N+1 overlaps the server's blit of
+    * frame N.
+    */
+   xcb_connection_t *m_put_connection = nullptr;
+
+   /** True when m_put_connection is private and completions pace segment reuse. */
+   bool m_completion_pipelining = false;
+
+   /** Event code of XCB_SHM_COMPLETION on m_put_connection. */
+   uint8_t m_shm_completion_event = 0;
+
+   /**
+    * @brief Maps each attached segment's X id to its image's busy flag.
+    *
+    * Guarded by m_completion_mutex together with the flags themselves;
+    * entries live from create_image_resources to destroy_image_resources.
+    */
+   std::unordered_map<xcb_shm_seg_t, bool *> m_segment_busy;
+   std::mutex m_completion_mutex;
+
+   /** One-shot so a server that stops sending completions warns once, not per frame. */
+   bool m_completion_timeout_logged = false;
+
+   /**
+    * @brief Release pooled and cached resources after a present-free period.
+    *
+    * Runs on the swapchain's event thread, which keeps polling while the
+    * application is backgrounded. Once no present has happened for the
+    * configured period it parks the copy workers, drops the scaling LUTs and
+    * their cache, frees the bounce arena and detaches the pooled SHM
+    * segments, so an idle window stops pinning memory it is not using. The
+    * next present restores everything lazily.
+    */
+   void maybe_trim_idle_resources();
+
+   /** VULKAN_WSI_IDLE_TRIM_MS converted to microseconds; 0 disables trimming. */
+   int64_t m_idle_trim_us = 0;
+
+   /**
+    * @brief Guards the idle trim state between the event and present threads.
+    *
+    * The present path takes it only to refresh the timestamp and to restore
+    * after a trim, so a trim can never overlap an in-flight copy.
+    */
+   std::mutex m_idle_mutex;
+
+   /** Time of the last present, seeded at init. Under m_idle_mutex. */
+   std::chrono::steady_clock::time_point m_last_present_time{};
+
+   /** True while the idle governor holds the presenter's resources trimmed. */
+   bool m_idle_trimmed = false;
+
    std::unordered_map<int, uint8_t> m_depth_to_bpp_cache;
 
    std::chrono::steady_clock::time_point m_last_frame_time;
-   std::chrono::microseconds m_frame_interval;
+   /**
+    * @brief Cached frame interval in microseconds.
+    *
+    * Written by detect_refresh_rate() - at init and again from the event
+    * thread when a configure or screen-change event arrives - and read by the
+    * pacing logic in present_image(), hence atomic.
+    */
+   std::atomic<int64_t> m_frame_interval_us;
    double m_refresh_rate_hz;
 
+   /**
+    * @brief Private X connection used for geometry and RandR event delivery.
+    *
+    * Event masks are per client, so selecting on a second connection leaves
+    * the application's event queue untouched. Null when the connection could
+    * not be opened; the refresh rate then stays at its init-time value.
+    */
+   _XDisplay *m_event_display = nullptr;
+   /** First RandR event code on m_event_display, -1 when RandR is absent. */
+   int m_rr_event_base = -1;
+
+   /**
+    * @brief Open m_event_display and select ConfigureNotify and RandR
+    * screen-change events.
+    *
+    * @return true when the subscription is active.
+    */
+   bool subscribe_geometry_events();
+
    std::atomic<bool> m_thread_error_occurred{ false };
    std::mutex m_error_recovery_mutex;
 
+   /**
+    * @brief Copy size in bytes above which the copy kernels switch to
+    * non-temporal stores, measured at init as half the last level cache.
+    *
+    * Frames below it copy faster through the cache and stay warm for the X
+    * server's read back; anything bigger only evicts the application's
+    * working set on its way through. 0 disables streaming stores.
+    */
+   size_t m_nt_copy_threshold = 0;
+
+   /**
+    * @brief Destination pixel count above which the copy is split across the
+    * worker pool; smaller frames copy faster on one thread than they take to
+    * wake the pool.
+    */
+   uint32_t m_threading_pixel_threshold = 0;
+
+   /**
+    * @brief Copy worker count measured for this machine, 0 to size the pool
+    * from the hardware thread count.
+    */
+   uint32_t m_profiled_copy_threads = 0;
+
+   /**
+    * @brief Per-frame streaming store decision, published with the copy job.
+    *
+    * Only written while the worker pool is idle; read by the copy kernels on
+    * every thread taking part in the copy.
+    */
+   bool m_use_nt_stores = false;
+
+   void detect_nt_copy_threshold();
+   bool use_nt_copy(size_t bytes) const;
+
+   /**
+    * @brief Load the machine copy profile measured by the wsi_copy_bench tool.
+    *
+    * The profile overrides the built-in heuristics for the copy thread count,
+    * the threading size threshold and the streaming store threshold; knobs the
+    * profile does not set keep their detected defaults. Looked up at the path
+    * in VULKAN_WSI_COPY_PROFILE, falling back to the standard config
+    * directories; missing files are not an error.
+    */
+   void load_copy_profile();
+
+   /**
+    * @brief Cache-bypassing row copy used when m_use_nt_stores is set.
+    *
+    * Streams the bytes straight to memory with non-temporal stores where the
+    * architecture has them and falls back to memcpy elsewhere. Streamed
+    * writes are weakly ordered: every thread must call
+    * streaming_store_fence() after its last streamed write and before
+    * publishing the copied rows.
+    */
+   void copy_bytes_streaming(void *dst, const void *src, size_t size);
+   void streaming_store_fence();
+#ifdef WSI_SHM_X86_SIMD
+   void copy_bytes_streaming_sse2(void *dst, const void *src, size_t size);
+#endif
+#if defined(ENABLE_ARM_NEON) && defined(__aarch64__)
+   static void copy_bytes_streaming_neon(void *dst, const void *src, size_t size);
+#endif
+
+   /**
+    * @brief True when the current frame's source mapping is write-combined.
+    *
+    * Recorded per image by external_memory when the memory type is chosen at
+    * bind time; present_image() republishes it here before each copy so the
+    * kernels decide without any per-frame memory property query. Ordinary
+    * loads from a write-combined mapping bypass the CPU caches and read at a
+    * fraction of DRAM speed on some SoCs.
+    */
+   bool m_src_write_combined = false;
+
+   /**
+    * @brief Cached staging buffer for reads from write-combined sources.
+    *
+    * Scaling and conversion gather from the source; gathering straight from
+    * an uncached mapping pays the full memory latency per access, so the rows
+    * are first streamed into this arena with non-temporal loads and the
+    * kernels run over cached memory. Sized lazily to the largest band staged.
+    */
+   std::vector<uint32_t> m_bounce_arena;
+
+   /**
+    * @brief Sequential copy out of a write-combined source.
+    *
+    * Reads with non-temporal loads where the architecture has them (they fill
+    * the dedicated load buffers instead of issuing one uncached access per
+    * word) and plain stores, as the destination is ordinary cached memory.
+    */
+   void copy_bytes_streaming_load(void *dst, const void *src, size_t size);
+#ifdef WSI_SHM_X86_SIMD
+   void copy_bytes_streaming_load_sse41(void *dst, const void *src, size_t size);
+#endif
+#if defined(ENABLE_ARM_NEON) && defined(__aarch64__)
+   static void copy_bytes_streaming_load_neon(void *dst, const void *src, size_t size);
+#endif
+
+   /**
+    * @brief Pixel copy work shared with the persistent worker pool.
+    *
+    * Published under m_pool_mutex before a generation bump; workers claim row
+    * ranges from next_row so faster workers steal the tail of slower ones.
+    */
+   /**
+    * @brief Pixel conversion applied while copying into the SHM segment.
+    *
+    * X servers with legacy 24-bit visuals only accept XRGB8888 pixmap data, so
+    * swapchains created with wider formats are converted and packed in the same
+    * pass over the rows as the copy itself rather than through an intermediate
+    * buffer.  Values outside [0, 1] are clamped — the legacy visual is SDR.
+    */
+   enum class pixel_conversion
+   {
+      NONE,         /**< Source is already 32-bit BGRA/XRGB, plain copy. */
+      RGBA16F,      /**< VK_FORMAT_R16G16B16A16_SFLOAT. */
+      RGB10A2_ABGR, /**< VK_FORMAT_A2B10G10R10_UNORM_PACK32 (red in the low bits). */
+      RGB10A2_ARGB, /**< VK_FORMAT_A2R10G10B10_UNORM_PACK32 (red in the high bits). */
+   };
+
+   /**
+    * @brief Map a swapchain image format to the conversion the copy needs.
+    *
+    * @param format The Vulkan format of the swapchain images.
+    *
+    * @return The conversion to apply, NONE for native 32-bit formats.
+    */
+   static pixel_conversion conversion_for_format(VkFormat format);
+
+   struct copy_job
+   {
+      const uint32_t *src_pixels = nullptr;
+      uint32_t *dst_pixels = nullptr;
+      uint32_t src_stride_pixels = 0;
+      uint32_t dst_width = 0;
+      uint32_t height = 0;
+      pixel_conversion conversion = pixel_conversion::NONE;
+      /** Fault the destination pages in instead of copying; see prefault_segment(). */
+      bool prefault = false;
+      /** Run the bilinear scaler over the claimed rows instead of the copy
+       *  kernels. Scaled rows address both buffers absolutely, so the pool's
+       *  chunking composes with vertical scaling. */
+      bool scaled = false;
+      std::atomic<uint32_t> next_row{ 0 };
+      std::atomic<uint32_t> rows_done{ 0 };
+   };
+
+   std::vector<std::thread> m_copy_workers;
+   std::mutex m_pool_mutex;
+   std::condition_variable m_pool_cv;
+   std::condition_variable m_pool_done_cv;
+   copy_job m_copy_job;
+   uint64_t m_job_generation = 0;
+   uint32_t m_workers_active = 0;
+   bool m_pool_shutdown = false;
+
+   void start_worker_pool();
+   void stop_worker_pool();
+   void worker_thread_loop();
+   void process_copy_rows();
 
    VkResult create_graphics_context();
 
-   void precompute_scaling_lut(uint32_t gpu_width, uint32_t display_width);
+   /**
+    * @brief Fault the pages of a freshly created SHM segment in.
+    *
+    * Spreads the first touch of each page over the copy worker pool so the
+    * pages are committed on the NUMA nodes of the threads that will write
+    * them, instead of being faulted in lazily during the first frame's copy.
+    *
+    * @param addr Mapped address of the segment.
+    * @param size Usable size of the segment in bytes.
+    */
+   void prefault_segment(void *addr, size_t size);
+
+   void precompute_scaling_lut(uint32_t gpu_width, uint32_t display_width, uint32_t gpu_height,
+                               uint32_t display_height);
    void copy_pixels_optimized(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
-                              uint32_t dst_width, uint32_t height);
+                              uint32_t dst_width, uint32_t height, pixel_conversion conversion);
    void copy_pixels_threaded(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
-                             uint32_t dst_width, uint32_t height);
+                             uint32_t dst_width, uint32_t height, pixel_conversion conversion);
    void copy_pixels_optimized_single_thread(const uint32_t *src_pixels, uint32_t *dst_pixels,
-                                            uint32_t src_stride_pixels, uint32_t dst_width, uint32_t height);
+                                            uint32_t src_stride_pixels, uint32_t dst_width, uint32_t height,
+                                            pixel_conversion conversion);
+
+   /**
+    * @brief Fused convert+pack stage for non-native swapchain formats.
+    *
+    * Converts each row straight into the SHM destination in one pass, using
+    * the same row granularity as the plain copy so the worker pool can spread
+    * the work the same way.  src_stride_pixels counts 32-bit units, so RGBA16F
+    * pixels span two of them.
+    */
+   void convert_pixels(pixel_conversion conversion, const uint32_t *src_pixels, uint32_t *dst_pixels,
+                       uint32_t src_stride_pixels, uint32_t dst_width, uint32_t height);
+   void convert_row_rgba16f(const uint16_t *src_row, uint32_t *dst_row, uint32_t dst_width);
+   void convert_row_rgba16f_scalar(const uint16_t *src_row, uint32_t *dst_row, uint32_t dst_width);
+   void convert_row_rgb10a2(const uint32_t *src_row, uint32_t *dst_row, uint32_t dst_width, bool red_in_high);
+   void convert_row_rgb10a2_scalar(const uint32_t *src_row, uint32_t *dst_row, uint32_t dst_width, bool red_in_high);
 #ifdef ENABLE_ARM_NEON
+   void convert_row_rgba16f_neon(const uint16_t *src_row, uint32_t *dst_row, uint32_t dst_width);
+   void convert_row_rgb10a2_neon(const uint32_t *src_row, uint32_t *dst_row, uint32_t dst_width, bool red_in_high);
+#endif
+#ifdef WSI_SHM_X86_SIMD
+   void convert_row_rgba16f_f16c(const uint16_t *src_row, uint32_t *dst_row, uint32_t dst_width);
+   void convert_row_rgb10a2_sse41(const uint32_t *src_row, uint32_t *dst_row, uint32_t dst_width, bool red_in_high);
+#endif
+#ifdef ENABLE_ARM_NEON
+   void copy_pixels_simd(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
+                         uint32_t dst_width, uint32_t height);
+#endif
+#ifdef WSI_SHM_X86_SIMD
+   /**
+    * @brief x86 SIMD support level, probed once at init with CPUID.
+    */
+   enum class x86_simd_level
+   {
+      NONE,
+      SSE41,
+      AVX2,
+   };
+
+   x86_simd_level m_x86_simd_level = x86_simd_level::NONE;
+
+   /**
+    * @brief True when the CPU supports F16C half-float conversions, probed at init.
+    */
+   bool m_has_f16c = false;
+
+   void detect_x86_simd_level();
+
+   /**
+    * @brief x86 counterpart of the NEON copy kernel, dispatching per the detected
+    * SIMD level. Falls back to copy_pixels_scalar when no usable level was
+    * detected.
+    */
    void copy_pixels_simd(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
                          uint32_t dst_width, uint32_t height);
+   void copy_row_sse41(const uint32_t *src_row, uint32_t *dst_row, uint32_t dst_width);
+   void copy_row_avx2(const uint32_t *src_row, uint32_t *dst_row, uint32_t dst_width);
 #endif
    void copy_pixels_scalar(const uint32_t *src_pixels, uint32_t *dst_pixels, uint32_t src_stride_pixels,
                            uint32_t dst_width, uint32_t height);
 
+   /**
+    * @brief Fused fixed-point bilinear scaler.
+    *
+    * Produces each destination row in one pass over the source row pair it
+    * straddles - one read of the pair, one write of the row - using the 8-bit
+    * weights precomputed next to the scaling LUTs.  Rows are addressed
+    * absolutely in both buffers, so the worker pool chunks scaled copies
+    * exactly like plain ones.
+    */
+   void scale_rows_bilinear(const uint32_t *src_base, uint32_t *dst_base, uint32_t src_stride_pixels,
+                            uint32_t dst_width, uint32_t first_row, uint32_t row_count);
+   void scale_row_bilinear_scalar(const uint32_t *src_row0, const uint32_t *src_row1, uint32_t *dst_row,
+                                  uint32_t dst_width, uint32_t wy);
+#ifdef ENABLE_ARM_NEON
+   void scale_row_bilinear_neon(const uint32_t *src_row0, const uint32_t *src_row1, uint32_t *dst_row,
+                                uint32_t dst_width, uint32_t wy);
+   void blend_rows_neon(const uint32_t *src_row0, const uint32_t *src_row1, uint32_t *dst_row, uint32_t dst_width,
+                        uint32_t wy);
+#endif
+#ifdef WSI_SHM_X86_SIMD
+   void scale_row_bilinear_avx2(const uint32_t *src_row0, const uint32_t *src_row1, uint32_t *dst_row,
+                                uint32_t dst_width, uint32_t wy);
+   void blend_rows_avx2(const uint32_t *src_row0, const uint32_t *src_row1, uint32_t *dst_row, uint32_t dst_width,
+                        uint32_t wy);
+#endif
+
    void start_async_sync();
    bool check_pending_sync();
    void ensure_sync_completion();
@@ -120,12 +536,42 @@ private:
    void wait_for_presentation_fence();
    void trigger_presentation_fence();
 
+   /**
+    * @brief Open the private put connection and resolve the SHM completion
+    * event code on it.
+    *
+    * @return true when completion pipelining is active.
+    */
+   bool init_completion_pipelining();
+
+   /**
+    * @brief Drain the private put connection, releasing every segment whose
+    * XCB_SHM_COMPLETION event has arrived.
+    *
+    * Called from both the present path and the event thread; the busy flags
+    * are the only shared state and m_completion_mutex covers them.
+    */
+   void drain_completion_events();
+
+   /**
+    * @brief Block until the server has finished reading the segment.
+    *
+    * Sleeps on the put connection's fd, so the wait ends the moment the
+    * completion event arrives. Reuses the segment anyway after two frame
+    * intervals rather than stalling the present path on a wedged server.
+    */
+   void wait_for_segment_release(bool *busy_flag);
+
    void cache_x11_formats();
    uint8_t get_bits_per_pixel_for_depth(int depth);
 
    bool is_aligned(const void *ptr, size_t alignment);
 #ifdef ENABLE_ARM_NEON
    bool are_pointers_neon_aligned(const void *src, void *dst);
+#endif
+#ifdef WSI_SHM_X86_SIMD
+   bool are_pointers_sse_aligned(const void *src, void *dst);
+   bool are_pointers_avx_aligned(const void *src, void *dst);
 #endif
    void detect_refresh_rate();
    double get_window_refresh_rate();
@@ -26,6 +26,8 @@
  * @brief Implementation of a x11 WSI Surface
  */
 
+#include <cassert>
+#include <unistd.h>
 #include <xcb/xcb.h>
 #include <xcb/xproto.h>
 #include <xcb/shm.h>
@@ -46,16 +48,26 @@ struct surface::init_parameters
    xcb_window_t window;
 };
 
+/* Two swapchain generations of triple-buffered images fit with headroom. */
+static constexpr size_t PIXMAP_CACHE_SIZE = 16;
+
 surface::surface(const init_parameters &params)
    : wsi::surface()
    , m_connection(params.connection)
    , m_window(params.window)
    , properties(this, params.allocator)
 {
+   /* Keeps cache_pixmap() from ever reallocating on the destruction path. */
+   m_pixmap_cache.reserve(PIXMAP_CACHE_SIZE);
 }
 
 surface::~surface()
 {
+   for (auto &entry : m_pixmap_cache)
+   {
+      xcb_free_pixmap(m_connection, entry.pixmap);
+      close(entry.buffer_fd);
+   }
 }
 
 bool surface::init()
@@ -70,6 +82,17 @@ bool surface::init()
 
 bool surface::get_size_and_depth(uint32_t *width, uint32_t *height, int *depth)
 {
+   {
+      std::lock_guard<std::mutex> lock(m_geometry_lock);
+      if (m_geometry_cache_valid && m_geometry_event_streams > 0)
+      {
+         *width = m_cached_width;
+         *height = m_cached_height;
+         *depth = m_cached_depth;
+         return true;
+      }
+   }
+
    auto cookie = xcb_get_geometry(m_connection, m_window);
    if (auto *geom = xcb_get_geometry_reply(m_connection, cookie, nullptr))
    {
@@ -77,11 +100,82 @@ bool surface::get_size_and_depth(uint32_t *width, uint32_t *height, int *depth)
       *height = static_cast<uint32_t>(geom->height);
       *depth = static_cast<int>(geom->depth);
       free(geom);
+
+      std::lock_guard<std::mutex> lock(m_geometry_lock);
+      m_cached_width = *width;
+      m_cached_height = *height;
+      m_cached_depth = *depth;
+      m_depth_known = true;
+      m_geometry_cache_valid = true;
       return true;
    }
    return false;
 }
 
+void surface::update_cached_geometry(uint32_t width, uint32_t height)
+{
+   std::lock_guard<std::mutex> lock(m_geometry_lock);
+   m_cached_width = width;
+   m_cached_height = height;
+   /* The configure event does not carry the depth, so the cache only becomes usable once a
+    * round-trip has filled it in. */
+   m_geometry_cache_valid = m_depth_known;
+}
+
+void surface::set_geometry_event_stream_active(bool active)
+{
+   std::lock_guard<std::mutex> lock(m_geometry_lock);
+   if (active)
+   {
+      m_geometry_event_streams++;
+      /* A resize may have happened before the event stream started; force one fresh
+       * round-trip, after which configure events keep the cache current. */
+      m_geometry_cache_valid = false;
+   }
+   else
+   {
+      m_geometry_event_streams--;
+      assert(m_geometry_event_streams >= 0);
+      if (m_geometry_event_streams == 0)
+      {
+         m_geometry_cache_valid = false;
+      }
+   }
+}
+
+xcb_pixmap_t surface::take_cached_pixmap(uint64_t buffer_id, uint32_t width, uint32_t height, uint32_t stride,
+                                         uint64_t modifier)
+{
+   std::lock_guard<std::mutex> lock(m_pixmap_cache_lock);
+   for (auto it = m_pixmap_cache.begin(); it != m_pixmap_cache.end(); ++it)
+   {
+      if (it->buffer_id == buffer_id && it->width == width && it->height == height && it->stride == stride &&
+          it->modifier == modifier)
+      {
+         xcb_pixmap_t pixmap = it->pixmap;
+         /* The caller's image holds its own reference to the buffer now. */
+         close(it->buffer_fd);
+         m_pixmap_cache.erase(it);
+         return pixmap;
+      }
+   }
+   return XCB_PIXMAP_NONE;
+}
+
+void surface::cache_pixmap(uint64_t buffer_id, uint32_t width, uint32_t height, uint32_t stride, uint64_t modifier,
+                           xcb_pixmap_t pixmap, int buffer_fd)
+{
+   std::lock_guard<std::mutex> lock(m_pixmap_cache_lock);
+   if (m_pixmap_cache.size() >= PIXMAP_CACHE_SIZE)
+   {
+      auto &oldest = m_pixmap_cache.front();
+      xcb_free_pixmap(m_connection, oldest.pixmap);
+      close(oldest.buffer_fd);
+      m_pixmap_cache.erase(m_pixmap_cache.begin());
+   }
+   m_pixmap_cache.push_back({ buffer_id, width, height, stride, modifier, pixmap, buffer_fd });
+}
+
 wsi::surface_properties &surface::get_properties()
 {
    return properties;
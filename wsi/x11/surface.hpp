@@ -28,6 +28,8 @@
 
 #pragma once
 #include <memory>
+#include <mutex>
+#include <vector>
 #include <vulkan/vk_icd.h>
 #include <xcb/xcb.h>
 #include <xcb/xproto.h>
@@ -64,6 +66,29 @@ public:
 
    bool get_size_and_depth(uint32_t *width, uint32_t *height, int *depth);
 
+   /**
+    * @brief Update the cached window geometry from a Present ConfigureNotify event.
+    *
+    * Called from the swapchain's event thread whenever the X server reports a new window
+    * configuration, so capability queries can be answered from the cache without a round-trip.
+    *
+    * @param width  New window width.
+    * @param height New window height.
+    */
+   void update_cached_geometry(uint32_t width, uint32_t height);
+
+   /**
+    * @brief Tell the surface whether ConfigureNotify events are being delivered for its window.
+    *
+    * While at least one swapchain drains a Present special event queue for the window the
+    * cached geometry is kept up to date by @ref update_cached_geometry, so
+    * @ref get_size_and_depth can skip the xcb_get_geometry round-trip. Without an event
+    * stream every query goes to the server, as the cache would go stale on a resize.
+    *
+    * @param active Whether a configure event stream has started or stopped.
+    */
+   void set_geometry_event_stream_active(bool active);
+
    xcb_connection_t *get_connection()
    {
       return m_connection;
@@ -79,6 +104,31 @@ public:
       return m_has_shm;
    }
 
+   /**
+    * @brief Take a DRI3 pixmap previously cached for the same buffer and geometry.
+    *
+    * @param buffer_id Identity of the backing DMA-BUF (its inode number).
+    * @param width     Pixmap width in pixels.
+    * @param height    Pixmap height in pixels.
+    * @param stride    Row stride in bytes the buffer was imported with.
+    * @param modifier  DRM format modifier the buffer was imported with.
+    *
+    * @return The cached pixmap, or XCB_PIXMAP_NONE when there is no match.
+    */
+   xcb_pixmap_t take_cached_pixmap(uint64_t buffer_id, uint32_t width, uint32_t height, uint32_t stride,
+                                   uint64_t modifier);
+
+   /**
+    * @brief Park a DRI3 pixmap for reuse across swapchain recreation.
+    *
+    * Takes ownership of @p pixmap and of @p buffer_fd, a dup of the backing
+    * DMA-BUF fd; holding the fd keeps the buffer's inode allocated, so a
+    * cached identity can never be recycled by a new buffer. The oldest entry
+    * is freed when the cache is full.
+    */
+   void cache_pixmap(uint64_t buffer_id, uint32_t width, uint32_t height, uint32_t stride, uint64_t modifier,
+                     xcb_pixmap_t pixmap, int buffer_fd);
+
    /** Get or create the shared Wayland bypass presenter.
     * The bypass persists across swapchain recreations to avoid
     * creating new Wayland surfaces (which causes window jumping). */
@@ -93,6 +143,43 @@ private:
    /** X11 extension capabilities */
    bool m_has_shm = false;
 
+   /** Protects the cached window geometry below. */
+   std::mutex m_geometry_lock;
+   uint32_t m_cached_width = 0;
+   uint32_t m_cached_height = 0;
+   int m_cached_depth = 0;
+   /** The depth never changes for a window, so it is reusable once queried. */
+   bool m_depth_known = false;
+   /** Whether the cached size is coherent with the configure event stream. */
+   bool m_geometry_cache_valid = false;
+   /** Number of swapchains currently delivering ConfigureNotify events for the window. */
+   int m_geometry_event_streams = 0;
+
+   /**
+    * @brief Pixmaps parked across swapchain recreation, keyed by buffer
+    * identity and geometry.
+    *
+    * Dragging a window between mixed-DPI monitors recreates the swapchain in
+    * a ping-pong between two sizes; when the buffers themselves are reused,
+    * the pixmaps importing them into the X server are reused too, skipping
+    * the server-side allocation round trip per image.
+    */
+   struct cached_pixmap
+   {
+      uint64_t buffer_id;
+      uint32_t width;
+      uint32_t height;
+      uint32_t stride;
+      uint64_t modifier;
+      xcb_pixmap_t pixmap;
+      /** Dup of the backing DMA-BUF fd, pinning the buffer identity. */
+      int buffer_fd;
+   };
+
+   /** Protects m_pixmap_cache. */
+   std::mutex m_pixmap_cache_lock;
+   std::vector<cached_pixmap> m_pixmap_cache;
+
    /** Shared bypass presenter — persists across swapchain recreations. */
    std::shared_ptr<class wayland_bypass> m_bypass;
 };
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, 2021-2022 Arm Limited.
+ * Copyright (c) 2017-2019, 2021-2022, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -27,7 +27,6 @@
 #include <cstdlib>
 #include <cstring>
 
-#include <vector>
 #include <xcb/xcb.h>
 #include <X11/Xlib-xcb.h>
 #include <vulkan/vk_icd.h>
@@ -40,6 +39,7 @@
 
 #include "surface_properties.hpp"
 #include "surface.hpp"
+#include "swapchain.hpp"
 #include "util/macros.hpp"
 
 namespace wsi
@@ -47,22 +47,20 @@ namespace wsi
 namespace x11
 {
 
-void surface_properties::populate_present_mode_compatibilities()
-{
-   std::array<present_mode_compatibility, 3> compatible_present_modes_list = {
-      present_mode_compatibility{ VK_PRESENT_MODE_FIFO_KHR, 1, { VK_PRESENT_MODE_FIFO_KHR } },
-      present_mode_compatibility{ VK_PRESENT_MODE_MAILBOX_KHR, 1, { VK_PRESENT_MODE_MAILBOX_KHR } },
-      present_mode_compatibility{ VK_PRESENT_MODE_IMMEDIATE_KHR, 1, { VK_PRESENT_MODE_IMMEDIATE_KHR } }
-   };
-   m_compatible_present_modes = compatible_present_modes<3>(compatible_present_modes_list);
-}
+/* The compatibility relation is fixed for the backend: every surface points at
+ * this table, so the EXT_surface_maintenance1 queries build nothing at runtime. */
+static constexpr std::array<present_mode_compatibility, 3> COMPATIBLE_PRESENT_MODES = {
+   present_mode_compatibility{ VK_PRESENT_MODE_FIFO_KHR, 1, { VK_PRESENT_MODE_FIFO_KHR } },
+   present_mode_compatibility{ VK_PRESENT_MODE_MAILBOX_KHR, 1, { VK_PRESENT_MODE_MAILBOX_KHR } },
+   present_mode_compatibility{ VK_PRESENT_MODE_IMMEDIATE_KHR, 1, { VK_PRESENT_MODE_IMMEDIATE_KHR } }
+};
 
 surface_properties::surface_properties(surface *wsi_surface, const util::allocator &allocator)
    : specific_surface(wsi_surface)
    , m_supported_modes({ VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR })
+   , m_compatible_present_modes(COMPATIBLE_PRESENT_MODES)
 {
    UNUSED(allocator);
-   populate_present_mode_compatibilities();
 }
 
 surface_properties::surface_properties()
@@ -79,9 +77,11 @@ surface_properties &surface_properties::get_instance()
 VkResult surface_properties::get_surface_capabilities(VkPhysicalDevice physical_device,
                                                       VkSurfaceCapabilitiesKHR *surface_capabilities)
 {
-   /* Image count limits */
+   /* Image count limits. The presenter routing is process-wide and known
+    * before any swapchain exists, so the true minimum of the selected path is
+    * reported rather than one conservative value sized for the deepest one. */
    get_surface_capabilities_common(physical_device, surface_capabilities);
-   surface_capabilities->minImageCount = 4;
+   surface_capabilities->minImageCount = predicted_min_image_count();
 
    int depth;
    specific_surface->get_size_and_depth(&surface_capabilities->currentExtent.width,
@@ -118,9 +118,12 @@ VkResult surface_properties::get_surface_capabilities(VkPhysicalDevice physical_
    return VK_SUCCESS;
 }
 
-std::vector<VkFormat> support_formats {
-   VK_FORMAT_B8G8R8A8_UNORM, 
-   VK_FORMAT_B8G8R8A8_SRGB
+/* The format list is fixed, so queries are served straight from this table
+ * instead of building a per-call copy on the heap. The sRGB variant is listed
+ * first to keep the order the previous front-insertion produced. */
+static std::array<surface_format_properties, 2> supported_formats{
+   surface_format_properties{ VK_FORMAT_B8G8R8A8_SRGB },
+   surface_format_properties{ VK_FORMAT_B8G8R8A8_UNORM },
 };
 
 VkResult surface_properties::get_surface_formats(VkPhysicalDevice physical_device, uint32_t *surface_format_count,
@@ -128,16 +131,8 @@ VkResult surface_properties::get_surface_formats(VkPhysicalDevice physical_devic
                                                  VkSurfaceFormat2KHR *extended_surface_formats)
 {
    UNUSED(physical_device);
-   std::vector<surface_format_properties> formats;
-   for (auto &format : support_formats)
-   {
-      if (format != VK_FORMAT_UNDEFINED)
-      {
-         formats.insert(formats.begin(), (surface_format_properties){ format });
-      }
-   }
-   return surface_properties_formats_helper(formats.begin(), formats.end(), surface_format_count, surface_formats,
-                                            extended_surface_formats);
+   return surface_properties_formats_helper(supported_formats.begin(), supported_formats.end(), surface_format_count,
+                                            surface_formats, extended_surface_formats);
 }
 
 VkResult surface_properties::get_surface_present_modes(VkPhysicalDevice physical_device, VkSurfaceKHR surface,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2022 Arm Limited.
+ * Copyright (c) 2017-2022, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -28,24 +28,33 @@
  * @brief Contains the implementation for a x11 swapchain.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <mutex>
 #include <system_error>
 #include <thread>
 
+#include <sys/stat.h>
+
 #include <dlfcn.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <util/thread_scheduling.hpp>
 #include <util/timed_semaphore.hpp>
 #include <vulkan/vulkan_core.h>
 
 #include <xcb/dri3.h>
+#include <xcb/present.h>
 #include <xcb/xcb.h>
 #include <xcb/xproto.h>
 
@@ -53,9 +62,12 @@
 #include "swapchain.hpp"
 #include "util/log.hpp"
 #include "util/macros.hpp"
+#include "util/usdt.hpp"
 #include "wsi/external_memory.hpp"
 #include "wsi/swapchain_base.hpp"
+#include "wsi/swapchain_present_loop.hpp"
 #include "wsi/extensions/present_id.hpp"
+#include "present_timing_handler.hpp"
 #include "shm_presenter.hpp"
 #include "dri3_presenter.hpp"
 #include "wayland_bypass.hpp"
@@ -67,6 +79,185 @@ namespace x11
 
 #define X11_SWAPCHAIN_MAX_PENDING_COMPLETIONS 128
 
+namespace
+{
+
+enum class preferred_presenter
+{
+   AUTO,
+   BYPASS,
+   DRI3,
+   SHM
+};
+
+/**
+ * @brief Process-wide cache of the presenter routing decision.
+ *
+ * The process name and the Zink detection (env var, loaded libraries) cannot
+ * change for the lifetime of the process, and the routing config files rarely
+ * change at all, so there is no reason to re-open and line-parse them on every
+ * swapchain creation: a resize storm recreating the swapchain at 10+ Hz would
+ * pay file I/O and a /proc/self/maps scan per frame.  The parse result is
+ * computed once and afterwards revalidated with a stat() per config file,
+ * re-parsing only when an mtime changes.
+ */
+class presenter_config
+{
+public:
+   /**
+    * @brief Get the preferred presenter for this process.
+    *
+    * @return The configured or auto-detected presenter, never AUTO.
+    */
+   static preferred_presenter get()
+   {
+      static presenter_config instance;
+      std::lock_guard<std::mutex> lock(instance.m_lock);
+      instance.refresh();
+      return instance.m_config_override != preferred_presenter::AUTO ?
+                instance.m_config_override :
+                (instance.m_is_zink ? preferred_presenter::BYPASS : preferred_presenter::DRI3);
+   }
+
+private:
+   static constexpr const char *CONFIG_PATHS[] = { "/etc/sky1/wsi-routing.conf",
+                                                   "/usr/share/cix-gpu/wsi-routing.conf" };
+   static constexpr size_t NUM_CONFIG_PATHS = sizeof(CONFIG_PATHS) / sizeof(CONFIG_PATHS[0]);
+
+   presenter_config()
+   {
+      FILE *f = fopen("/proc/self/comm", "r");
+      if (f)
+      {
+         if (fgets(m_proc_name, sizeof(m_proc_name), f))
+         {
+            /* Strip trailing newline. */
+            char *nl = strchr(m_proc_name, '\n');
+            if (nl)
+               *nl = '\0';
+         }
+         fclose(f);
+      }
+
+      /* Auto-detect Zink: MESA_LOADER_DRIVER_OVERRIDE=zink or zink_dri.so
+       * mapped into the process.  Zink loads its driver before it creates a
+       * swapchain, so a one-shot scan is sufficient. */
+      const char *driver = getenv("MESA_LOADER_DRIVER_OVERRIDE");
+      if (driver && strcmp(driver, "zink") == 0)
+      {
+         m_is_zink = true;
+      }
+      else
+      {
+         FILE *maps = fopen("/proc/self/maps", "r");
+         if (maps)
+         {
+            char line[512];
+            while (fgets(line, sizeof(line), maps))
+            {
+               if (strstr(line, "zink_dri.so"))
+               {
+                  m_is_zink = true;
+                  break;
+               }
+            }
+            fclose(maps);
+         }
+      }
+      if (m_is_zink)
+      {
+         WSI_LOG_INFO("x11 swapchain: auto-detected Zink → bypass");
+      }
+   }
+
+   /**
+    * @brief Re-parse the routing config if any config file changed on disk.
+    */
+   void refresh()
+   {
+      bool changed = false;
+      for (size_t i = 0; i < NUM_CONFIG_PATHS; i++)
+      {
+         struct stat st = {};
+         /* A missing file stats to the zero-initialized timestamp, so both
+          * appearing and disappearing count as a change. */
+         if (stat(CONFIG_PATHS[i], &st) != 0)
+         {
+            st = {};
+         }
+         if (st.st_mtim.tv_sec != m_config_mtime[i].tv_sec || st.st_mtim.tv_nsec != m_config_mtime[i].tv_nsec)
+         {
+            m_config_mtime[i] = st.st_mtim;
+            changed = true;
+         }
+      }
+
+      if (!changed || m_proc_name[0] == '\0')
+      {
+         return;
+      }
+
+      /* Read config files: lines of "app_name presenter" (bypass/dri3/shm).
+       * Lines starting with # are comments, empty lines are skipped.  The
+       * first matching entry across the paths wins. */
+      m_config_override = preferred_presenter::AUTO;
+      for (size_t i = 0; i < NUM_CONFIG_PATHS && m_config_override == preferred_presenter::AUTO; i++)
+      {
+         FILE *cfg = fopen(CONFIG_PATHS[i], "r");
+         if (!cfg)
+            continue;
+         char line[512];
+         while (fgets(line, sizeof(line), cfg))
+         {
+            if (line[0] == '#' || line[0] == '\n')
+               continue;
+            char app[256], pres[64];
+            if (sscanf(line, "%255s %63s", app, pres) == 2)
+            {
+               if (strcmp(app, m_proc_name) == 0)
+               {
+                  if (strcmp(pres, "bypass") == 0)
+                     m_config_override = preferred_presenter::BYPASS;
+                  else if (strcmp(pres, "dri3") == 0)
+                     m_config_override = preferred_presenter::DRI3;
+                  else if (strcmp(pres, "shm") == 0)
+                     m_config_override = preferred_presenter::SHM;
+                  WSI_LOG_INFO("x11 swapchain: config override '%s' → %s", m_proc_name, pres);
+                  break;
+               }
+            }
+         }
+         fclose(cfg);
+      }
+   }
+
+   std::mutex m_lock;
+   char m_proc_name[256] = {};
+   bool m_is_zink = false;
+   preferred_presenter m_config_override = preferred_presenter::AUTO;
+   struct timespec m_config_mtime[NUM_CONFIG_PATHS] = {};
+};
+
+/* Minimum image counts reported per presenter route. The dmabuf presenters
+ * (DRI3 and Wayland bypass) have one buffer held by the compositor while the
+ * next is in flight, so the application needs a third to render into. The SHM
+ * presenter copies the image into a shared segment at present time and
+ * releases it straight away, so double buffering suffices. */
+constexpr uint32_t DMABUF_MIN_IMAGE_COUNT = 3;
+constexpr uint32_t SHM_MIN_IMAGE_COUNT = 2;
+
+} /* anonymous namespace */
+
+uint32_t predicted_min_image_count()
+{
+   /* The SHM prediction is exact: when a process is routed to SHM the fallback
+    * chain never tries the dmabuf presenters. The dmabuf prediction covers
+    * both DRI3 and bypass, which hold the same number of buffers; should both
+    * fail, the swapchain lands on SHM where the higher report is still safe,
+    * just not minimal. */
+   return presenter_config::get() == preferred_presenter::SHM ? SHM_MIN_IMAGE_COUNT : DMABUF_MIN_IMAGE_COUNT;
+}
+
 swapchain::swapchain(layer::device_private_data &dev_data, const VkAllocationCallbacks *pAllocator,
                      surface &wsi_surface)
    : swapchain_base(dev_data, pAllocator)
@@ -74,6 +265,7 @@ swapchain::swapchain(layer::device_private_data &dev_data, const VkAllocationCal
    , m_window(wsi_surface.get_window())
    , m_wsi_surface(&wsi_surface)
    , m_wsi_allocator(nullptr)
+   , m_memory_slab(m_device, m_allocator)
    , m_image_creation_parameters({}, m_allocator, {}, {})
    , m_send_sbc(0)
    , m_target_msc(0)
@@ -81,16 +273,33 @@ swapchain::swapchain(layer::device_private_data &dev_data, const VkAllocationCal
    , m_thread_status_cond()
 {
    m_image_create_info.format = VK_FORMAT_UNDEFINED;
+   select_present_loop<swapchain>();
 }
 
 swapchain::~swapchain()
 {
+   /* The bypass is shared across swapchain recreations, so stop release
+    * delivery into this swapchain before its images start going away.  The
+    * call synchronizes with any in-flight callback. */
+   if (m_bypass_event_recycling && m_wayland_bypass)
+   {
+      m_wayland_bypass->set_release_callback(nullptr, nullptr);
+   }
+
    {
       auto thread_status_lock = std::unique_lock<std::mutex>(m_thread_status_lock);
       m_present_event_thread_run = false;
       m_thread_status_cond.notify_all();
    }
 
+   /* The event thread sleeps in poll() on the connection fds; kick it so
+    * teardown does not wait out the poll timeout. */
+   if (m_event_thread_wake.is_valid())
+   {
+      uint64_t one = 1;
+      UNUSED(write(m_event_thread_wake.get(), &one, sizeof(one)));
+   }
+
    /* Always join — the thread may not have set m_present_event_thread_run
     * yet when we check it (race), so join unconditionally if started. */
    if (m_present_event_thread.joinable())
@@ -108,11 +317,45 @@ swapchain::~swapchain()
       }
    }
 
+   /* With event recycling the event thread is gone, so release any images
+    * whose IDLE_NOTIFY had not arrived yet before teardown. */
+   if (m_dri3_event_recycling)
+   {
+      for (uint32_t i = 0; i < m_swapchain_images.size(); i++)
+      {
+         if (m_swapchain_images[i].status == swapchain_image::PRESENTED)
+         {
+            unpresent_image(i);
+         }
+      }
+
+      /* No more configure events will be drained for the window. */
+      m_wsi_surface->set_geometry_event_stream_active(false);
+   }
+
+   /* Same for the bypass: release delivery has stopped, so free any images
+    * whose wl_buffer.release had not arrived yet. */
+   if (m_bypass_event_recycling)
+   {
+      for (uint32_t i = 0; i < m_swapchain_images.size(); i++)
+      {
+         if (m_swapchain_images[i].status == swapchain_image::PRESENTED)
+         {
+            unpresent_image(i);
+         }
+      }
+   }
+
    /* Wake the page_flip_thread immediately so teardown doesn't block
     * for the full 250ms semaphore timeout.  The thread checks
-    * m_page_flip_thread_run after waking and will exit cleanly. */
+    * m_page_flip_thread_run after waking and will exit cleanly. The semaphore
+    * only exists once the dedicated thread has been spawned; pool-served and
+    * never-presented swapchains have nothing to wake. */
    m_page_flip_thread_run = false;
-   m_page_flip_semaphore.post();
+   if (m_thread_sem_defined)
+   {
+      m_page_flip_semaphore.post();
+   }
 
    /* Call the base's teardown */
    teardown();
@@ -151,105 +394,9 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
     *
     * Zink/GL apps need Wayland bypass with deferred buffer release to avoid
     * FBO flicker.  Direct Vulkan apps use DRI3 for best performance and
-    * window decorations under Xwayland. */
-   enum class preferred_presenter { AUTO, BYPASS, DRI3, SHM };
-   preferred_presenter preferred = preferred_presenter::AUTO;
-
-   /* 1. Check config file override (process name → presenter). */
-   {
-      char proc_name[256] = {};
-      FILE *f = fopen("/proc/self/comm", "r");
-      if (f)
-      {
-         if (fgets(proc_name, sizeof(proc_name), f))
-         {
-            /* Strip trailing newline. */
-            char *nl = strchr(proc_name, '\n');
-            if (nl)
-               *nl = '\0';
-         }
-         fclose(f);
-      }
-
-      if (proc_name[0])
-      {
-         /* Read config file: lines of "app_name presenter" (bypass/dri3/shm).
-          * Lines starting with # are comments, empty lines are skipped. */
-         static const char *config_paths[] = {
-            "/etc/sky1/wsi-routing.conf",
-            "/usr/share/cix-gpu/wsi-routing.conf",
-            nullptr
-         };
-         for (const char **path = config_paths; *path; path++)
-         {
-            FILE *cfg = fopen(*path, "r");
-            if (!cfg)
-               continue;
-            char line[512];
-            while (fgets(line, sizeof(line), cfg))
-            {
-               if (line[0] == '#' || line[0] == '\n')
-                  continue;
-               char app[256], pres[64];
-               if (sscanf(line, "%255s %63s", app, pres) == 2)
-               {
-                  if (strcmp(app, proc_name) == 0)
-                  {
-                     if (strcmp(pres, "bypass") == 0)
-                        preferred = preferred_presenter::BYPASS;
-                     else if (strcmp(pres, "dri3") == 0)
-                        preferred = preferred_presenter::DRI3;
-                     else if (strcmp(pres, "shm") == 0)
-                        preferred = preferred_presenter::SHM;
-                     WSI_LOG_INFO("x11 swapchain: config override '%s' → %s", proc_name, pres);
-                     break;
-                  }
-               }
-            }
-            fclose(cfg);
-            if (preferred != preferred_presenter::AUTO)
-               break;
-         }
-      }
-   }
-
-   /* 2. Auto-detect Zink: check /proc/self/maps for zink_dri.so loaded.
-    *    Also check MESA_LOADER_DRIVER_OVERRIDE=zink env var. */
-   bool is_zink = false;
-   if (preferred == preferred_presenter::AUTO)
-   {
-      const char *driver = getenv("MESA_LOADER_DRIVER_OVERRIDE");
-      if (driver && strcmp(driver, "zink") == 0)
-      {
-         is_zink = true;
-      }
-      else
-      {
-         FILE *maps = fopen("/proc/self/maps", "r");
-         if (maps)
-         {
-            char line[512];
-            while (fgets(line, sizeof(line), maps))
-            {
-               if (strstr(line, "zink_dri.so"))
-               {
-                  is_zink = true;
-                  break;
-               }
-            }
-            fclose(maps);
-         }
-      }
-      if (is_zink)
-      {
-         preferred = preferred_presenter::BYPASS;
-         WSI_LOG_INFO("x11 swapchain: auto-detected Zink → bypass");
-      }
-      else
-      {
-         preferred = preferred_presenter::DRI3;
-      }
-   }
+    * window decorations under Xwayland.  The decision is process-wide and
+    * cached across swapchain creations — see presenter_config. */
+   preferred_presenter preferred = presenter_config::get();
 
    /* 3. Try the preferred presenter, with fallback chain:
     *    bypass → DRI3 → SHM
@@ -282,12 +429,20 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
    {
       try
       {
+         /* The first probe on a connection caches its render node fd in the
+          * instance, so recreating the swapchain (e.g. on resize) adopts a dup
+          * of the cached node instead of re-scanning /dev/dri/. */
+         int cached_render_node_fd = m_device_data.instance_data.get_cached_render_node_fd(m_connection);
          auto dri3 = std::make_unique<dri3_presenter>();
-         if (dri3->is_available(m_connection))
+         if (dri3->is_available(m_connection, cached_render_node_fd >= 0))
          {
-            VkResult dri3_result = dri3->init(m_connection, m_window, m_wsi_surface);
+            VkResult dri3_result = dri3->init(m_connection, m_window, m_wsi_surface, cached_render_node_fd);
             if (dri3_result == VK_SUCCESS)
             {
+               if (cached_render_node_fd < 0)
+               {
+                  m_device_data.instance_data.cache_render_node_fd(m_connection, dri3->get_render_node_fd());
+               }
                m_dri3_presenter = std::move(dri3);
                m_presenter = presenter_type::DRI3;
                WSI_LOG_INFO("x11 swapchain: using DRI3 zero-copy presenter");
@@ -299,6 +454,10 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
          }
          else
          {
+            if (cached_render_node_fd >= 0)
+            {
+               close(cached_render_node_fd);
+            }
             WSI_LOG_INFO("x11 swapchain: DRI3 not available");
          }
       }
@@ -351,6 +510,13 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
             return init_result;
          }
          WSI_LOG_INFO("x11 swapchain: using SHM fallback presenter");
+
+         /* All SHM images come from one shared host-visible allocation, mapped
+          * once for the worker's per-frame reads. */
+         VkMemoryPropertyFlags optimal = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+                                         VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+         VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+         m_memory_slab.configure(static_cast<uint32_t>(m_swapchain_images.size()), required, optimal, true);
       }
       catch (const std::exception &e)
       {
@@ -359,13 +525,66 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
       }
    }
 
-   /* Deferred release for zero-copy presenters: keeps a 2-frame delay before
-    * returning buffers.  Both bypass and DRI3 present DMA-BUFs asynchronously —
-    * the compositor/X server may still be reading the buffer when the call
-    * returns.  Without the delay, the app renders into a buffer the server
-    * is still scanning out, causing FBO flicker. */
-   m_bypass_deferred_release = (m_presenter == presenter_type::WAYLAND_BYPASS ||
-                                m_presenter == presenter_type::DRI3);
+   /* Event-driven recycling for DRI3: when the X server delivers Present
+    * IDLE_NOTIFY events we release each buffer the moment the server reports it
+    * idle, so multiple frames can be in flight and acquire latency stops
+    * tracking the server's round-trip time. */
+   if (m_presenter == presenter_type::DRI3 && m_dri3_presenter->register_present_events() == VK_SUCCESS)
+   {
+      m_dri3_event_recycling = true;
+      /* The special event queue also delivers ConfigureNotify, which keeps the surface's
+       * geometry cache current so capability queries skip the xcb_get_geometry round-trip. */
+      m_wsi_surface->set_geometry_event_stream_active(true);
+   }
+
+   /* Event-driven recycling for bypass: forward wl_buffer.release straight
+    * into the free-image accounting the moment the compositor sends it, so a
+    * triple-buffered client gets its buffer back on the compositor's actual
+    * release instead of after the fixed 2-frame delay. */
+   if (m_presenter == presenter_type::WAYLAND_BYPASS && m_wayland_bypass)
+   {
+      m_wayland_bypass->set_release_callback(
+         [](void *user_data, struct wl_buffer *buffer) {
+            static_cast<swapchain *>(user_data)->handle_bypass_buffer_release(buffer);
+         },
+         this);
+      m_bypass_event_recycling = true;
+   }
+
+   /* With explicit sync the compositor waits on the image's acquire fence
+    * itself, so frames can be committed before the GPU finishes rendering.
+    * Decided here, before the base swapchain picks its sync backend:
+    * can_use_timeline_sync() must keep the per-image sync_fd fences when the
+    * payload is exported to the compositor. */
+   m_bypass_explicit_sync =
+      m_presenter == presenter_type::WAYLAND_BYPASS && m_wayland_bypass && m_wayland_bypass->supports_explicit_sync();
+
+   /* Explicit sync for DRI3 (DRI3/Present 1.4): the image's present payload
+    * is imported as a syncobj acquire point the X server waits on GPU-side,
+    * so the page flip thread stops CPU-waiting the fence before every
+    * xcb_present_pixmap.  Decided here for the same reason as the bypass
+    * flag above: the per-image sync_fd fences must keep carrying the
+    * payload. */
+   m_dri3_explicit_sync =
+      m_presenter == presenter_type::DRI3 && m_dri3_presenter && m_dri3_presenter->supports_explicit_sync();
+   if (m_dri3_presenter)
+   {
+      m_dri3_presenter->set_explicit_sync_enabled(m_dri3_explicit_sync);
+   }
+
+   /* Deferred release for zero-copy presenters without completion events: keeps
+    * a 2-frame delay before returning buffers.  Both bypass and DRI3 present
+    * DMA-BUFs asynchronously — the compositor/X server may still be reading the
+    * buffer when the call returns.  Without the delay, the app renders into a
+    * buffer the server is still scanning out, causing FBO flicker. */
+   m_bypass_deferred_release = ((m_presenter == presenter_type::WAYLAND_BYPASS && !m_bypass_event_recycling) ||
+                                (m_presenter == presenter_type::DRI3 && !m_dri3_event_recycling));
+
+   /* Bypass was asked for but is not up yet (Xwayland's bypass socket can come
+    * up after the app starts).  The event thread keeps probing for it and
+    * upgrades through a live migration once it appears, instead of staying on
+    * DRI3 for the swapchain's whole lifetime. */
+   m_bypass_preferred = (preferred == preferred_presenter::BYPASS && m_presenter == presenter_type::DRI3);
 
    /* Resolve X11 atoms for WM_PING response (DRI3 event drain needs these
     * to reply to the window manager's liveness checks). */
@@ -390,6 +609,11 @@ VkResult swapchain::init_platform(VkDevice device, const VkSwapchainCreateInfoKH
       }
    }
 
+   /* Lets the event thread sleep on the connection fds instead of a fixed
+    * timer and still be woken immediately at teardown.  On failure the fd
+    * stays invalid and the thread falls back to short poll timeouts. */
+   m_event_thread_wake = util::fd_owner{ eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) };
+
    try
    {
       m_present_event_thread = std::thread(&swapchain::present_event_thread, this);
@@ -519,6 +743,15 @@ VkResult swapchain::get_surface_compatible_formats(const VkImageCreateInfo &info
       }
    }
 
+   /* The allocator picks from the candidates in order. Every candidate already
+    * passed the display's scanout format check, so rank compressed layouts ahead
+    * of linear ones and break ties with the bandwidth estimate. */
+   std::stable_sort(importable_formats.begin(), importable_formats.end(),
+                    [](const wsialloc_format &lhs, const wsialloc_format &rhs) {
+                       return util::drm::modifier_score(lhs.fourcc, lhs.modifier, true) >
+                              util::drm::modifier_score(rhs.fourcc, rhs.modifier, true);
+                    });
+
    return VK_SUCCESS;
 }
 
@@ -608,14 +841,11 @@ VkResult swapchain::allocate_image(VkImageCreateInfo &image_create_info, x11_ima
 
 VkResult swapchain::allocate_and_bind_swapchain_image(VkImageCreateInfo image_create_info, swapchain_image &image)
 {
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
    image.status = swapchain_image::FREE;
 
    assert(image.data != nullptr);
    auto image_data = static_cast<x11_image_data *>(image.data);
 
-   image_status_lock.unlock();
-
    uint32_t width = image_create_info.extent.width;
    uint32_t height = image_create_info.extent.height;
 
@@ -634,6 +864,12 @@ VkResult swapchain::allocate_and_bind_swapchain_image(VkImageCreateInfo image_cr
        * resources from the fds BEFORE importing into Vulkan (import closes fds). */
       TRY_LOG_CALL(allocate_image(m_image_create_info, image_data));
 
+      /* Retain a dup of the plane-0 DMA-BUF: the Vulkan import below consumes
+       * the original fds, and a later live presenter migration needs to re-wrap
+       * the buffer for the other zero-copy presenter.  Failure only disables
+       * migration, not the swapchain. */
+      image_data->migration_fd = dup(image_data->external_mem.get_buffer_fds()[0]);
+
       if (m_presenter == presenter_type::WAYLAND_BYPASS && m_wayland_bypass)
       {
          TRY_LOG(m_wayland_bypass->create_image_resources(image_data, width, height,
@@ -671,7 +907,7 @@ VkResult swapchain::allocate_and_bind_swapchain_image(VkImageCreateInfo image_cr
 VkResult swapchain::create_swapchain_image(VkImageCreateInfo image_create_info, swapchain_image &image)
 {
    /* Create image_data */
-   auto image_data = m_allocator.create<x11_image_data>(1, m_device, m_allocator);
+   auto image_data = create_image_data<x11_image_data>(m_device, m_allocator);
    if (image_data == nullptr)
    {
       return VK_ERROR_OUT_OF_HOST_MEMORY;
@@ -799,10 +1035,25 @@ VkResult swapchain::create_swapchain_image(VkImageCreateInfo image_create_info,
 
       TRY_LOG_CALL(image_data->external_mem.configure_for_host_visible(image_create_info, required, optimal));
 
+      image_data->format = image_create_info.format;
+
       image_create_info.tiling = VK_IMAGE_TILING_LINEAR;
       TRY_LOG(m_device_data.disp.CreateImage(m_device, &image_create_info, get_allocation_callbacks(), &image.image),
               "Failed to create image for SHM");
 
+      if (m_memory_slab.is_configured())
+      {
+         VkDeviceMemory slab_memory = VK_NULL_HANDLE;
+         VkDeviceSize slab_offset = 0;
+         void *slab_mapped = nullptr;
+         if (m_memory_slab.acquire_slice(image.image, &slab_memory, &slab_offset, &slab_mapped) == VK_SUCCESS)
+         {
+            image_data->external_mem.configure_for_host_visible_slice(slab_memory, slab_offset, slab_mapped,
+                                                                      m_memory_slab.is_memory_cached());
+         }
+         /* On failure the image simply falls back to a dedicated allocation. */
+      }
+
       return image_data->external_mem.allocate_and_bind_image(image.image, image_create_info);
    }
    else
@@ -811,11 +1062,53 @@ VkResult swapchain::create_swapchain_image(VkImageCreateInfo image_create_info,
    }
 }
 
+void swapchain::wait_for_events(int event_fd, int timeout_ms)
+{
+   struct pollfd fds[2] = {};
+   nfds_t num_fds = 0;
+   if (event_fd >= 0)
+   {
+      fds[num_fds].fd = event_fd;
+      fds[num_fds].events = POLLIN;
+      num_fds++;
+   }
+   if (m_event_thread_wake.is_valid())
+   {
+      fds[num_fds].fd = m_event_thread_wake.get();
+      fds[num_fds].events = POLLIN;
+      num_fds++;
+   }
+   else if (timeout_ms > 4)
+   {
+      /* Without the wake fd teardown cannot interrupt the sleep; keep it short. */
+      timeout_ms = 4;
+   }
+
+   if (poll(fds, num_fds, timeout_ms) > 0 && m_event_thread_wake.is_valid() &&
+       (fds[num_fds - 1].revents & POLLIN) != 0)
+   {
+      /* Drain the wake counter so the next poll sleeps again. */
+      uint64_t value;
+      UNUSED(read(m_event_thread_wake.get(), &value, sizeof(value)));
+   }
+}
+
 void swapchain::present_event_thread()
 {
+   util::apply_presentation_thread_scheduling("present event");
+
    auto thread_status_lock = std::unique_lock<std::mutex>(m_thread_status_lock);
    m_present_event_thread_run = true;
 
+   /* Upper bound for the fd sleeps below; a missed wake only delays
+    * housekeeping (WM_PING replies, bypass probes) by this much, events
+    * themselves interrupt the sleep through the connection fd. */
+   constexpr int EVENT_POLL_TIMEOUT_MS = 100;
+
+   /* Throttles the DRI3 → bypass upgrade probe; get_or_create_bypass costs a
+    * socket connect attempt per call. */
+   auto next_bypass_probe = std::chrono::steady_clock::now();
+
    while (m_present_event_thread_run)
    {
       if (error_has_occured())
@@ -823,9 +1116,11 @@ void swapchain::present_event_thread()
          break;
       }
 
-      /* Bypass mode: dispatch Wayland events (pings, configures) but
-       * buffer release is handled by the 1-frame delay in present_image,
-       * so no buffer tracking needed here.  Just keep the connection alive. */
+      /* Bypass mode: dispatch Wayland events (pings, configures).  Releases
+       * reach handle_bypass_buffer_release() from dispatch context, so this
+       * poll only picks up events that arrive between presents; with event
+       * recycling disabled the 2-frame delay in present_image covers release
+       * instead and the returned list stays unused. */
       if (m_presenter == presenter_type::WAYLAND_BYPASS && m_wayland_bypass)
       {
          thread_status_lock.unlock();
@@ -834,8 +1129,12 @@ void swapchain::present_event_thread()
          std::vector<struct wl_buffer *> unused;
          m_wayland_bypass->dispatch_and_get_releases(unused);
 
+         /* Sleep on the compositor connection fd so buffer releases are
+          * dispatched the moment they arrive instead of on the next fixed
+          * 16ms tick. */
+         wait_for_events(m_wayland_bypass->get_event_fd(), EVENT_POLL_TIMEOUT_MS);
+
          thread_status_lock.lock();
-         m_thread_status_cond.wait_for(thread_status_lock, std::chrono::milliseconds(16));
          continue;
       }
 
@@ -871,11 +1170,68 @@ void swapchain::present_event_thread()
             free(event);
          }
 
+         /* Drain Present completion events from the dedicated special-event
+          * queue and recycle buffers the server has finished reading. */
+         if (m_dri3_event_recycling)
+         {
+            xcb_generic_event_t *present_event;
+            while ((present_event = m_dri3_presenter->poll_present_event()) != nullptr)
+            {
+               handle_present_event(reinterpret_cast<xcb_ge_generic_event_t *>(present_event));
+               free(present_event);
+            }
+         }
+
+         /* Upgrade path: bypass was preferred but not available when the
+          * swapchain was created.  Probe for it and hand the actual switch to
+          * the page flip thread, which migrates at a frame boundary. */
+         if (m_bypass_preferred && std::chrono::steady_clock::now() >= next_bypass_probe)
+         {
+            next_bypass_probe = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+            std::shared_ptr<wayland_bypass> bypass;
+            try
+            {
+               auto *x11_surf = static_cast<x11::surface *>(m_wsi_surface);
+               bypass = x11_surf->get_or_create_bypass(m_image_create_info.extent.width,
+                                                       m_image_create_info.extent.height);
+            }
+            catch (const std::exception &e)
+            {
+               WSI_LOG_WARNING("x11 swapchain: bypass probe exception: %s", e.what());
+            }
+
+            if (bypass)
+            {
+               thread_status_lock.lock();
+               m_wayland_bypass = std::move(bypass);
+               m_bypass_preferred = false;
+               request_presenter_migration(presenter_type::WAYLAND_BYPASS);
+               thread_status_lock.unlock();
+            }
+         }
+
+         /* Sleep on the X connection fd instead of a fixed 4ms timer: the main
+          * event queue and the Present special-event queue share the socket,
+          * so a single poll covers WM_PING traffic and COMPLETE/IDLE
+          * notifications, and the thread only wakes when the server actually
+          * sent something. */
+         wait_for_events(xcb_get_file_descriptor(m_connection), EVENT_POLL_TIMEOUT_MS);
+
          thread_status_lock.lock();
-         m_thread_status_cond.wait_for(thread_status_lock, std::chrono::milliseconds(4));
          continue;
       }
 
+      /* SHM mode: drain the presenter's private geometry/RandR event
+       * connection here so the cached window geometry and refresh rate stay
+       * current without the present path ever waiting on an X reply. */
+      if (m_presenter == presenter_type::SHM && m_shm_presenter)
+      {
+         thread_status_lock.unlock();
+         m_shm_presenter->process_events();
+         thread_status_lock.lock();
+      }
+
       /* SHM mode: original behavior — wait for pending completions. */
       auto assume_forward_progress = false;
 
@@ -908,11 +1264,357 @@ void swapchain::present_event_thread()
    m_thread_status_cond.notify_all();
 }
 
+void swapchain::handle_present_event(xcb_ge_generic_event_t *event)
+{
+   switch (event->event_type)
+   {
+   case XCB_PRESENT_EVENT_IDLE_NOTIFY:
+   {
+      auto *idle = reinterpret_cast<xcb_present_idle_notify_event_t *>(event);
+      for (uint32_t i = 0; i < m_swapchain_images.size(); i++)
+      {
+         auto *data = reinterpret_cast<x11_image_data *>(m_swapchain_images[i].data);
+         if (data != nullptr && data->pixmap == idle->pixmap)
+         {
+            /* Only images presented through the event pipeline are released
+             * here; error paths recycle their image directly and produce no
+             * idle event. */
+            if (m_swapchain_images[i].status == swapchain_image::PRESENTED)
+            {
+               unpresent_image(i);
+            }
+            break;
+         }
+      }
+      break;
+   }
+   case XCB_PRESENT_EVENT_COMPLETE_NOTIFY:
+   {
+      /* The frame is on screen; buffers are recycled on IDLE_NOTIFY, which the
+       * server sends once it has stopped reading the pixmap. */
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+      /* The completion carries the UST/MSC pair of the vblank the frame became
+       * visible on; feed it to present timing. */
+      auto *complete = reinterpret_cast<xcb_present_complete_notify_event_t *>(event);
+      auto *ext = get_swapchain_extension<wsi_ext_present_timing_x11>();
+      if (ext != nullptr)
+      {
+         ext->handle_complete_notify(complete->ust, complete->msc);
+      }
+#endif
+      break;
+   }
+   case XCB_PRESENT_EVENT_CONFIGURE_NOTIFY:
+   {
+      auto *configure = reinterpret_cast<xcb_present_configure_notify_event_t *>(event);
+      m_wsi_surface->update_cached_geometry(configure->width, configure->height);
+      break;
+   }
+   default:
+      break;
+   }
+}
+
+void swapchain::handle_bypass_buffer_release(struct wl_buffer *buffer)
+{
+   for (uint32_t i = 0; i < m_swapchain_images.size(); i++)
+   {
+      auto *data = reinterpret_cast<x11_image_data *>(m_swapchain_images[i].data);
+      if (data != nullptr && data->cpu_buffer == reinterpret_cast<void *>(buffer))
+      {
+         /* Only images presented through the release pipeline are freed here;
+          * error paths recycle their image directly and the compositor sends
+          * no release for buffers it never latched. */
+         if (m_swapchain_images[i].status == swapchain_image::PRESENTED)
+         {
+            unpresent_image(i);
+         }
+         break;
+      }
+   }
+}
+
+void swapchain::request_presenter_migration(presenter_type target)
+{
+   if (target == m_presenter)
+   {
+      return;
+   }
+   m_migration_target = target;
+   m_presenter_migration_pending = true;
+}
+
+void swapchain::try_migrate_presenter()
+{
+   if (!m_presenter_migration_pending)
+   {
+      return;
+   }
+   m_presenter_migration_pending = false;
+
+   const presenter_type target = m_migration_target;
+   if (target == m_presenter || target == presenter_type::SHM || m_presenter == presenter_type::SHM)
+   {
+      /* SHM images are host-visible Vulkan allocations, not DMA-BUFs, so they
+       * cannot be handed to a zero-copy presenter (nor the reverse) without
+       * reallocating the images — entering or leaving SHM still goes through
+       * swapchain recreation. */
+      return;
+   }
+
+   /* Make sure the target presenter exists before touching any image. */
+   if (target == presenter_type::DRI3 && m_dri3_presenter == nullptr)
+   {
+      try
+      {
+         int cached_render_node_fd = m_device_data.instance_data.get_cached_render_node_fd(m_connection);
+         auto dri3 = std::make_unique<dri3_presenter>();
+         if (!dri3->is_available(m_connection, cached_render_node_fd >= 0))
+         {
+            if (cached_render_node_fd >= 0)
+            {
+               close(cached_render_node_fd);
+            }
+            WSI_LOG_WARNING("x11 swapchain: DRI3 unavailable, cannot migrate away from bypass");
+            return;
+         }
+         if (dri3->init(m_connection, m_window, m_wsi_surface, cached_render_node_fd) != VK_SUCCESS)
+         {
+            WSI_LOG_WARNING("x11 swapchain: DRI3 unavailable, cannot migrate away from bypass");
+            return;
+         }
+         if (cached_render_node_fd < 0)
+         {
+            m_device_data.instance_data.cache_render_node_fd(m_connection, dri3->get_render_node_fd());
+         }
+         m_dri3_presenter = std::move(dri3);
+      }
+      catch (const std::exception &e)
+      {
+         WSI_LOG_WARNING("x11 swapchain: DRI3 exception during migration: %s", e.what());
+         return;
+      }
+   }
+   if (target == presenter_type::WAYLAND_BYPASS && m_wayland_bypass == nullptr)
+   {
+      return;
+   }
+
+   int depth = 24;
+   uint32_t dummy_w, dummy_h;
+   if (!m_wsi_surface->get_size_and_depth(&dummy_w, &dummy_h, &depth))
+   {
+      WSI_LOG_WARNING("Could not get surface depth, using default: %d", depth);
+   }
+
+   /* Re-wrap every image's DMA-BUF on the target presenter.  The presenters
+    * read (and dup) the plane-0 fd from external_mem, which the Vulkan import
+    * consumed, so the retained migration fd is staged there for the call.
+    * Pixmap (DRI3) and wl_buffer (bypass) live in separate image fields, so
+    * the old resources stay valid until the switch commits and a failure can
+    * roll back with the old presenter untouched. */
+   const auto &fmt = m_image_creation_parameters.m_allocated_format;
+   VkResult result = VK_SUCCESS;
+   uint32_t migrated = 0;
+   for (; migrated < m_swapchain_images.size(); migrated++)
+   {
+      auto &image = m_swapchain_images[migrated];
+      if (image.status == swapchain_image::INVALID || image.data == nullptr)
+      {
+         continue;
+      }
+      auto *data = reinterpret_cast<x11_image_data *>(image.data);
+      if (data->migration_fd < 0)
+      {
+         result = VK_ERROR_INITIALIZATION_FAILED;
+         break;
+      }
+
+      auto saved_fds = data->external_mem.get_buffer_fds();
+      auto staged_fds = saved_fds;
+      staged_fds[0] = data->migration_fd;
+      data->external_mem.set_buffer_fds(staged_fds);
+
+      if (target == presenter_type::WAYLAND_BYPASS)
+      {
+         result = m_wayland_bypass->create_image_resources(data, m_image_create_info.extent.width,
+                                                           m_image_create_info.extent.height, fmt.fourcc, fmt.modifier);
+      }
+      else
+      {
+         uint32_t stride = data->external_mem.get_strides()[0];
+         result = m_dri3_presenter->create_image_resources(data, m_image_create_info.extent.width,
+                                                           m_image_create_info.extent.height, depth, stride, fmt.fourcc,
+                                                           fmt.modifier);
+      }
+      data->external_mem.set_buffer_fds(saved_fds);
+
+      if (result != VK_SUCCESS)
+      {
+         break;
+      }
+   }
+
+   if (result != VK_SUCCESS)
+   {
+      WSI_LOG_WARNING("x11 swapchain: presenter migration failed (%d), staying on current presenter", result);
+      for (uint32_t i = 0; i < migrated; i++)
+      {
+         auto &image = m_swapchain_images[i];
+         if (image.status == swapchain_image::INVALID || image.data == nullptr)
+         {
+            continue;
+         }
+         auto *data = reinterpret_cast<x11_image_data *>(image.data);
+         if (target == presenter_type::WAYLAND_BYPASS)
+         {
+            m_wayland_bypass->destroy_image_resources(data);
+         }
+         else
+         {
+            m_dri3_presenter->destroy_image_resources(data);
+         }
+      }
+      return;
+   }
+
+   /* Stop release delivery from the old presenter before any image changes
+    * hands; the call synchronizes with in-flight callbacks. */
+   if (m_presenter == presenter_type::WAYLAND_BYPASS && m_bypass_event_recycling)
+   {
+      m_wayland_bypass->set_release_callback(nullptr, nullptr);
+      m_bypass_event_recycling = false;
+   }
+
+   /* Flush the deferred-release ring: its entries were paced for the old
+    * presenter and would otherwise leak across the switch. */
+   for (int i = 0; i < BYPASS_DEFER_FRAMES; i++)
+   {
+      if (m_bypass_deferred[i] >= 0)
+      {
+         unpresent_image(m_bypass_deferred[i]);
+         m_bypass_deferred[i] = -1;
+      }
+   }
+   m_bypass_defer_head = 0;
+
+   for (uint32_t i = 0; i < m_swapchain_images.size(); i++)
+   {
+      auto &image = m_swapchain_images[i];
+      if (image.status == swapchain_image::INVALID || image.data == nullptr)
+      {
+         continue;
+      }
+
+      /* The old presenter's release event for this image will no longer be
+       * acted on once the flags flip; release it now.  The server may still
+       * be finishing its last read of the old buffer — a one-shot cost
+       * equivalent to the present-failure path. */
+      if (image.status == swapchain_image::PRESENTED)
+      {
+         unpresent_image(i);
+      }
+
+      auto *data = reinterpret_cast<x11_image_data *>(image.data);
+      if (m_presenter == presenter_type::WAYLAND_BYPASS)
+      {
+         m_wayland_bypass->destroy_image_resources(data);
+      }
+      else
+      {
+         m_dri3_presenter->destroy_image_resources(data);
+      }
+   }
+
+   if (target == presenter_type::WAYLAND_BYPASS)
+   {
+      m_wayland_bypass->set_release_callback(
+         [](void *user_data, struct wl_buffer *buffer) {
+            static_cast<swapchain *>(user_data)->handle_bypass_buffer_release(buffer);
+         },
+         this);
+      m_bypass_event_recycling = true;
+
+      /* The bypass presents straight to the compositor; hide the X window
+       * like init_platform does. */
+      xcb_unmap_window(m_connection, m_window);
+      xcb_flush(m_connection);
+   }
+   else
+   {
+      if (!m_dri3_event_recycling && m_dri3_presenter->register_present_events() == VK_SUCCESS)
+      {
+         m_dri3_event_recycling = true;
+         m_wsi_surface->set_geometry_event_stream_active(true);
+      }
+
+      /* Resolve the WM_PING atoms the DRI3 event drain needs if the swapchain
+       * started in bypass mode and never did. */
+      if (m_root_window == XCB_NONE)
+      {
+         auto setup = xcb_get_setup(m_connection);
+         m_root_window = xcb_setup_roots_iterator(setup).data->root;
+
+         auto wm_cookie = xcb_intern_atom(m_connection, 0, 12, "WM_PROTOCOLS");
+         auto ping_cookie = xcb_intern_atom(m_connection, 0, 12, "_NET_WM_PING");
+         auto *wm_reply = xcb_intern_atom_reply(m_connection, wm_cookie, nullptr);
+         auto *ping_reply = xcb_intern_atom_reply(m_connection, ping_cookie, nullptr);
+         if (wm_reply)
+         {
+            m_wm_protocols_atom = wm_reply->atom;
+            free(wm_reply);
+         }
+         if (ping_reply)
+         {
+            m_net_wm_ping_atom = ping_reply->atom;
+            free(ping_reply);
+         }
+      }
+
+      /* Re-map the window that bypass mode unmapped. */
+      xcb_map_window(m_connection, m_window);
+      xcb_flush(m_connection);
+   }
+
+   m_presenter = target;
+   m_bypass_deferred_release = ((m_presenter == presenter_type::WAYLAND_BYPASS && !m_bypass_event_recycling) ||
+                                (m_presenter == presenter_type::DRI3 && !m_dri3_event_recycling));
+
+   WSI_LOG_INFO("x11 swapchain: live migration to %s presenter complete",
+                target == presenter_type::WAYLAND_BYPASS ? "bypass" : "DRI3");
+}
+
 void swapchain::present_image(const pending_present_request &pending_present)
 {
+   WSI_USDT3(present_submit, this, pending_present.image_index, pending_present.present_id);
+
    auto image_data = reinterpret_cast<x11_image_data *>(m_swapchain_images[pending_present.image_index].data);
    auto thread_status_lock = std::unique_lock<std::mutex>(m_thread_status_lock);
 
+   /* Matches the value the page flip thread saw before calling in here: the
+    * presenter only changes on this thread, in try_migrate_presenter() below. */
+   const bool payload_wait_skipped = presentation_engine_waits_for_payload();
+
+   /* A migration requested by the event thread (bypass became available) or by
+    * a previous present failure runs here, between frames, where no present
+    * request is in flight. */
+   try_migrate_presenter();
+
+   /* The page flip thread skips the CPU wait on the present payload when the
+    * bypass presenter forwards it as an acquire fence.  If the migration above
+    * moved this frame off that path, nothing downstream carries the fence, so
+    * complete the wait here before handing the buffer over.  Forwarding was on
+    * when the wait was skipped, so timeline sync is not in use and the
+    * per-image fence holds the payload. */
+   if (payload_wait_skipped && !presentation_engine_waits_for_payload())
+   {
+      constexpr uint64_t WAIT_PRESENT_TIMEOUT = 1000000000; /* 1 second */
+      while (image_data->present_fence.wait_payload(WAIT_PRESENT_TIMEOUT) == VK_TIMEOUT)
+      {
+         WSI_LOG_WARNING("Timeout waiting for image's present fences, retrying..");
+      }
+   }
+
    while (image_data->pending_completions.size() == X11_SWAPCHAIN_MAX_PENDING_COMPLETIONS)
    {
       if (!m_present_event_thread_run)
@@ -933,13 +1635,46 @@ void swapchain::present_image(const pending_present_request &pending_present)
    VkResult present_result;
    if (m_presenter == presenter_type::WAYLAND_BYPASS && m_wayland_bypass)
    {
+      /* With event recycling the image must be marked PRESENTED before the
+       * commit is sent: the release callback fires from dispatch context —
+       * possibly inside present_image itself — before this thread gets to
+       * run again. */
+      if (m_bypass_event_recycling)
+      {
+         m_swapchain_images[pending_present.image_index].status = swapchain_image::PRESENTED;
+      }
+
+      /* Export the present payload as a sync_fd acquire fence for the
+       * compositor to wait on.  The fd_owner must stay alive across the
+       * unlocked present call below; the protocol only borrows the fd. */
+      util::fd_owner acquire_fence;
+      if (m_bypass_explicit_sync)
+      {
+         auto present_sync_fd = image_data->present_fence.export_sync_fd();
+         if (!present_sync_fd.has_value())
+         {
+            WSI_LOG_ERROR("Failed to export present fence.");
+            set_error_state(VK_ERROR_SURFACE_LOST_KHR);
+         }
+         else
+         {
+            acquire_fence = std::move(present_sync_fd.value());
+         }
+      }
+
       thread_status_lock.unlock();
-      present_result = m_wayland_bypass->present_image(image_data);
+      present_result =
+         m_wayland_bypass->present_image(image_data, acquire_fence.is_valid() ? acquire_fence.get() : -1);
       thread_status_lock.lock();
 
       if (present_result == VK_SUCCESS)
       {
-         if (m_bypass_deferred_release)
+         if (m_bypass_event_recycling)
+         {
+            /* Released by handle_bypass_buffer_release() once the compositor
+             * sends wl_buffer.release; nothing further to do here. */
+         }
+         else if (m_bypass_deferred_release)
          {
             /* Deferred release (Zink/GL): keep a 2-frame delay before
              * freeing.  On present N, free image N-2.  This gives the
@@ -960,16 +1695,33 @@ void swapchain::present_image(const pending_present_request &pending_present)
       else
       {
          WSI_LOG_ERROR("Failed to present image using bypass: %d", present_result);
+         /* The compositor side of the bypass is gone; fall back to DRI3
+          * without recreating the swapchain.  The migration runs at the next
+          * present — this frame is dropped either way. */
+         request_presenter_migration(presenter_type::DRI3);
          unpresent_image(pending_present.image_index);
       }
    }
    else if (m_presenter == presenter_type::DRI3 && m_dri3_presenter)
    {
+      /* With event recycling the image must be marked PRESENTED before the
+       * request is sent: the event thread releases it on IDLE_NOTIFY and the
+       * server can reply before this thread gets to run again. */
+      if (m_dri3_event_recycling)
+      {
+         m_swapchain_images[pending_present.image_index].status = swapchain_image::PRESENTED;
+      }
+
       present_result = m_dri3_presenter->present_image(image_data, serial);
 
       if (present_result == VK_SUCCESS)
       {
-         if (m_bypass_deferred_release)
+         if (m_dri3_event_recycling)
+         {
+            /* Released by handle_present_event() once the server is done
+             * reading the buffer; nothing further to do here. */
+         }
+         else if (m_bypass_deferred_release)
          {
             int oldest = m_bypass_deferred[m_bypass_defer_head];
             if (oldest >= 0)
@@ -990,7 +1742,8 @@ void swapchain::present_image(const pending_present_request &pending_present)
    }
    else
    {
-      present_result = m_shm_presenter->present_image(image_data, serial);
+      present_result = m_shm_presenter->present_image(image_data, serial, pending_present.damage_rects.data(),
+                                                      pending_present.damage_rect_count);
 
       if (present_result != VK_SUCCESS)
          WSI_LOG_ERROR("Failed to present image using SHM: %d", present_result);
@@ -1060,26 +1813,30 @@ VkResult swapchain::get_free_buffer(uint64_t *timeout)
 
 void swapchain::destroy_image(wsi::swapchain_image &image)
 {
-   std::unique_lock<std::recursive_mutex> image_status_lock(m_image_status_mutex);
-   if (image.status != wsi::swapchain_image::INVALID)
+   /* Move the status to INVALID atomically: only the caller whose exchange
+    * observes a different previous state tears the VkImage down, which keeps
+    * destroy_image safe to reach twice for the same image. */
+   if (image.status.exchange(wsi::swapchain_image::INVALID) != wsi::swapchain_image::INVALID)
    {
       if (image.image != VK_NULL_HANDLE)
       {
          m_device_data.disp.DestroyImage(m_device, image.image, get_allocation_callbacks());
          image.image = VK_NULL_HANDLE;
       }
-
-      image.status = wsi::swapchain_image::INVALID;
    }
 
-   image_status_lock.unlock();
-
    if (image.data != nullptr)
    {
       auto data = reinterpret_cast<x11_image_data *>(image.data);
 
       if (data != nullptr)
       {
+         if (data->migration_fd >= 0)
+         {
+            close(data->migration_fd);
+            data->migration_fd = -1;
+         }
+
          if (m_presenter == presenter_type::WAYLAND_BYPASS && m_wayland_bypass)
          {
             m_wayland_bypass->destroy_image_resources(data);
@@ -1094,11 +1851,17 @@ void swapchain::destroy_image(wsi::swapchain_image &image)
          }
       }
 
-      m_allocator.destroy(1, data);
+      destroy_image_data(data);
       image.data = nullptr;
    }
 }
 
+bool swapchain::fill_captured_frame(uint32_t image_index, VkCapturedFrameWSI &frame)
+{
+   auto *image_data = reinterpret_cast<x11_image_data *>(m_swapchain_images[image_index].data);
+   return fill_captured_frame_from_dmabuf(image_data->external_mem, image_data->present_fence, frame);
+}
+
 VkResult swapchain::image_set_present_payload(swapchain_image &image, VkQueue queue,
                                               const queue_submit_semaphores &semaphores, const void *submission_pnext)
 {
@@ -1112,6 +1875,14 @@ VkResult swapchain::image_wait_present(swapchain_image &image, uint64_t timeout)
    return data->present_fence.wait_payload(timeout);
 }
 
+bool swapchain::presentation_engine_waits_for_payload() const
+{
+   /* Only read and written on the page flip thread (m_presenter changes in
+    * try_migrate_presenter(), which runs there), so no lock is needed. */
+   return (m_presenter == presenter_type::WAYLAND_BYPASS && m_bypass_explicit_sync) ||
+          (m_presenter == presenter_type::DRI3 && m_dri3_explicit_sync);
+}
+
 VkResult swapchain::bind_swapchain_image(VkDevice &device, const VkBindImageMemoryInfo *bind_image_mem_info,
                                          const VkBindImageMemorySwapchainInfoKHR *bind_sc_info)
 {
@@ -1134,6 +1905,17 @@ VkResult swapchain::add_required_extensions(VkDevice device, const VkSwapchainCr
       }
    }
 
+#if VULKAN_WSI_LAYER_EXPERIMENTAL
+   bool swapchain_support_enabled = swapchain_create_info->flags & VK_SWAPCHAIN_CREATE_PRESENT_TIMING_BIT_EXT;
+   if (swapchain_support_enabled)
+   {
+      if (!add_swapchain_extension(wsi_ext_present_timing_x11::create(m_allocator)))
+      {
+         return VK_ERROR_OUT_OF_HOST_MEMORY;
+      }
+   }
+#endif
+
    return VK_SUCCESS;
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, 2021-2022 Arm Limited.
+ * Copyright (c) 2017-2019, 2021-2022, 2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  *
@@ -70,6 +70,19 @@ struct pending_completion
    std::optional<std::chrono::steady_clock::time_point> timestamp;
 };
 
+/**
+ * @brief Predict the minimum number of swapchain images the presenter for this process needs.
+ *
+ * Consults the process-wide presenter routing that init_platform uses, so surface
+ * capability queries can report the minimum the selected path actually requires
+ * instead of one conservative value: the dmabuf presenters have a buffer held by
+ * the compositor while another is in flight, whereas the SHM presenter copies at
+ * present time and holds nothing.
+ *
+ * @return The minimum image count to report in the surface capabilities.
+ */
+uint32_t predicted_min_image_count();
+
 struct x11_image_data
 {
    x11_image_data(const VkDevice &device, const util::allocator &allocator)
@@ -79,9 +92,37 @@ struct x11_image_data
 
    external_memory external_mem;
    xcb_pixmap_t pixmap = XCB_PIXMAP_NONE;
+
+   /** Identity of the DMA-BUF backing @ref pixmap (its inode number), 0 when
+    *  unknown. Keys the surface's pixmap cache together with the geometry. */
+   uint64_t pixmap_buffer_id = 0;
+   /** Stride and modifier the pixmap was imported with. */
+   uint32_t pixmap_stride = 0;
+   uint64_t pixmap_modifier = 0;
+   /** Dup of the DMA-BUF fd handed to the surface's pixmap cache on
+    *  destruction, so a cached identity cannot be recycled by a new buffer;
+    *  -1 when the pixmap is not cacheable. */
+   int pixmap_buffer_fd = -1;
+
+   /** DRM timeline syncobj carrying the image's explicit-sync acquire and
+    *  release points for DRI3/Present 1.4, and the X protocol id it was
+    *  imported into the server under.  0 when explicit sync is not in use
+    *  for this image. */
+   uint32_t syncobj_handle = 0;
+   uint32_t syncobj_xid = 0;
+   /** Binary syncobj the present payload's sync_fd is imported into before
+    *  being transferred onto the timeline's next acquire point. */
+   uint32_t syncobj_import_handle = 0;
+   /** Last timeline point handed out; acquire/release points are allocated
+    *  by incrementing it, so the timeline is strictly monotonic. */
+   uint64_t syncobj_point = 0;
+
    std::vector<pending_completion> pending_completions;
 
-   fence_sync present_fence;
+   /** Exportable so the payload can be forwarded GPU-side — to the Wayland
+    *  compositor as a sync_fd acquire fence, or to the X server as a DRI3
+    *  syncobj acquire point. */
+   sync_fd_fence_sync present_fence;
 
    xcb_shm_seg_t shm_seg = XCB_NONE;
    int shm_id = -1;
@@ -93,14 +134,30 @@ struct x11_image_data
    void *shm_addr_alt = nullptr;
    bool use_alt_buffer = false;
 
+   /** Set from the put until its XCB_SHM_COMPLETION event comes back, i.e.
+    *  while the X server may still be reading the segment. Guarded by the SHM
+    *  presenter's completion mutex. */
+   bool shm_seg_busy = false;
+   bool shm_seg_alt_busy = false;
+
    uint32_t width = 0;
    uint32_t height = 0;
    uint32_t stride = 0;
    int depth = 0;
 
+   /** Vulkan format of the image; the SHM presenter uses it to pick the pixel
+    *  conversion when the swapchain format does not match the X visual. */
+   VkFormat format = VK_FORMAT_UNDEFINED;
+
    void *cpu_buffer = nullptr;
    size_t cpu_buffer_size = 0;
 
+   /** Dup of the plane-0 DMA-BUF fd, retained across the Vulkan import (which
+    *  consumes the original fds) so the buffer can be re-wrapped by the other
+    *  zero-copy presenter during a live presenter migration.  -1 when the
+    *  image is not DMA-BUF backed. */
+   int migration_fd = -1;
+
    VkDevice device = VK_NULL_HANDLE;
    layer::device_private_data *device_data = nullptr;
 };
@@ -129,7 +186,7 @@ struct image_creation_parameters
  * This class is mostly empty, because all the swapchain stuff is handled by the swapchain class,
  * which we inherit. This class only provides a way to create an image and page-flip ops.
  */
-class swapchain : public wsi::swapchain_base
+class swapchain final : public wsi::swapchain_base
 {
 public:
    explicit swapchain(layer::device_private_data &dev_data, const VkAllocationCallbacks *pAllocator,
@@ -174,6 +231,14 @@ protected:
     */
    void present_image(const pending_present_request &pending_present) override;
 
+   /**
+    * @brief Fill a captured frame with the dmabuf handles backing an image.
+    *
+    * Served for the DRI3 and Wayland bypass presenters; SHM images are
+    * host-visible and cannot be exported.
+    */
+   bool fill_captured_frame(uint32_t image_index, VkCapturedFrameWSI &frame) override;
+
    /**
     * @brief Method to release a swapchain image
     *
@@ -196,6 +261,31 @@ protected:
 
    VkResult image_wait_present(swapchain_image &image, uint64_t timeout) override;
 
+   /**
+    * @brief The present payloads are only used for CPU-side waiting unless a
+    * presenter forwards them downstream — the bypass presenter as sync_fd
+    * acquire fences, the DRI3 presenter as syncobj acquire points — which
+    * needs the per-image fences kept. Otherwise the swapchain can rely on the
+    * base class timeline semaphore synchronization when the device supports
+    * it.
+    */
+   bool can_use_timeline_sync() const override
+   {
+      return !m_bypass_explicit_sync && !m_dri3_explicit_sync;
+   }
+
+   /**
+    * @brief Whether the present payload wait can be left to the presentation
+    * engine.
+    *
+    * @return true when the active presenter forwards the payload GPU-side —
+    *         the bypass presenter as a sync_fd acquire fence for the Wayland
+    *         compositor, or the DRI3 presenter as a syncobj acquire point the
+    *         X server waits on — instead of it being waited for on the page
+    *         flip thread.
+    */
+   bool presentation_engine_waits_for_payload() const override;
+
    /**
     * @brief Bind image to a swapchain
     *
@@ -270,6 +360,14 @@ private:
     */
    std::unique_ptr<shm_presenter> m_shm_presenter;
 
+   /**
+    * @brief One host-visible allocation shared by all SHM images.
+    *
+    * Armed in init_platform when the SHM presenter is selected, so the
+    * swapchain makes a single driver allocation instead of one per image.
+    */
+   device_memory_slab m_memory_slab;
+
    enum class presenter_type { WAYLAND_BYPASS, DRI3, SHM } m_presenter = presenter_type::SHM;
 
    /**
@@ -304,6 +402,94 @@ private:
    int m_bypass_defer_head = 0;
    bool m_bypass_deferred_release = false;
 
+   /** True when the X server delivers Present COMPLETE/IDLE notify events on the
+    *  DRI3 presenter's special-event queue.  Buffers are then recycled by
+    *  handle_present_event() as soon as the server reports them idle, instead of
+    *  after the fixed 2-frame delay, so multiple frames can be in flight. */
+   bool m_dri3_event_recycling = false;
+
+   /** True when the bypass presenter forwards wl_buffer.release through
+    *  handle_bypass_buffer_release() the moment it arrives, so buffers are
+    *  recycled on the compositor's release instead of after the fixed
+    *  2-frame delay.  Triple-buffered clients then stop stalling an extra
+    *  frame waiting for the event thread's poll. */
+   bool m_bypass_event_recycling = false;
+
+   /** True when the swapchain was created on the bypass presenter and the
+    *  Wayland compositor supports explicit synchronization.  Present payloads
+    *  are then forwarded as sync_fd acquire fences instead of being waited for
+    *  on the page flip thread.  Decided once at creation: a bypass presenter
+    *  that only appears later through a live migration keeps CPU-side waiting,
+    *  because by then the base swapchain may have picked timeline sync and the
+    *  per-image fences no longer carry the payload. */
+   bool m_bypass_explicit_sync = false;
+
+   /** True when the swapchain was created on the DRI3 presenter and both the
+    *  X server and the render node support DRI3/Present 1.4 explicit sync.
+    *  Present payloads are then imported as syncobj acquire points the server
+    *  waits on GPU-side instead of being waited for on the page flip thread.
+    *  Decided once at creation for the same reason as the bypass flag above:
+    *  after a live migration the per-image fences may no longer carry the
+    *  payload. */
+   bool m_dri3_explicit_sync = false;
+
+   /**
+    * @brief Handle a wl_buffer.release forwarded by the bypass presenter.
+    *
+    * Releases the matching image back for acquire through unpresent_image().
+    * Called from Wayland dispatch context (the event thread or the page flip
+    * thread's in-present dispatch).
+    *
+    * @param buffer The wl_buffer the compositor has finished reading.
+    */
+   void handle_bypass_buffer_release(struct wl_buffer *buffer);
+
+   /**
+    * @brief Handle one Present event from the DRI3 special-event queue.
+    *
+    * IDLE_NOTIFY releases the matching image back for acquire through
+    * unpresent_image().
+    *
+    * @param event The generic event received from the special-event queue.
+    */
+   void handle_present_event(xcb_ge_generic_event_t *event);
+
+   /** True when bypass was the preferred presenter but was not available when
+    *  the swapchain was created (Xwayland's bypass socket can come up after
+    *  the app starts).  The event thread then keeps probing for it and
+    *  upgrades through a live migration once it appears. */
+   bool m_bypass_preferred = false;
+
+   /** Presenter migration request, consumed by the page flip thread at the
+    *  start of present_image().  Guarded by m_thread_status_lock. */
+   bool m_presenter_migration_pending = false;
+   presenter_type m_migration_target = presenter_type::SHM;
+
+   /**
+    * @brief Request a live switch to another zero-copy presenter.
+    *
+    * The switch itself runs on the page flip thread at the next present, where
+    * no present request is in flight.  The caller must hold
+    * m_thread_status_lock.
+    *
+    * @param target The presenter to migrate to.
+    */
+   void request_presenter_migration(presenter_type target);
+
+   /**
+    * @brief Execute a pending presenter migration, if one was requested.
+    *
+    * Re-wraps every swapchain image's DMA-BUF (retained in
+    * x11_image_data::migration_fd) as presentation resources of the target
+    * presenter, then atomically flips m_presenter and the recycling/deferral
+    * flags.  Only DRI3 <-> Wayland bypass migrations are supported: SHM images
+    * are host-visible Vulkan allocations that cannot be re-exported as
+    * DMA-BUFs, so entering or leaving SHM still requires swapchain recreation.
+    * A failed migration rolls back and stays on the current presenter.
+    * Called from present_image() with m_thread_status_lock held.
+    */
+   void try_migrate_presenter();
+
    VkPhysicalDeviceMemoryProperties2 m_memory_props;
 
    /** X11 atoms and root window for WM_PING response in DRI3 event drain. */
@@ -312,6 +498,24 @@ private:
    xcb_window_t m_root_window = XCB_NONE;
 
    void present_event_thread();
+
+   /**
+    * @brief Sleep until a connection fd becomes readable or a timeout elapses.
+    *
+    * Polls @p event_fd together with m_event_thread_wake so teardown can
+    * interrupt the sleep.  Called by the present event thread between event
+    * drains, replacing fixed-interval timer wakes.
+    *
+    * @param event_fd   Connection fd to wait on, or -1 to sleep on the timeout only.
+    * @param timeout_ms Upper bound for the sleep, in milliseconds.
+    */
+   void wait_for_events(int event_fd, int timeout_ms);
+
+   /** Wakes the present event thread out of its poll sleep, primarily at
+    *  teardown.  Invalid when eventfd creation failed, in which case the
+    *  thread falls back to the short fixed poll timeouts. */
+   util::fd_owner m_event_thread_wake;
+
    bool m_present_event_thread_run;
    std::thread m_present_event_thread;
    std::mutex m_thread_status_lock;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2025 Arm Limited.
+ * Copyright (c) 2025-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  */
@@ -16,14 +16,18 @@
  *
  * Buffer lifecycle:
  *   The compositor sends wl_buffer.release when it is done reading a
- *   buffer.  Released buffers are collected in m_released_buffers and
- *   returned to the swapchain via dispatch_and_get_releases().  The
- *   swapchain must NOT re-use a buffer until release has been received,
- *   otherwise the compositor may read an incomplete frame (flicker).
+ *   buffer.  With a release callback registered (the swapchain's normal
+ *   mode) the release is forwarded from dispatch context the moment it
+ *   arrives; otherwise released buffers are collected in
+ *   m_released_buffers and returned via dispatch_and_get_releases().
+ *   The swapchain must NOT re-use a buffer until release has been
+ *   received, otherwise the compositor may read an incomplete frame
+ *   (flicker).
  */
 
 #include "wayland_bypass.hpp"
 #include "swapchain.hpp"
+#include "util/config.hpp"
 #include "util/log.hpp"
 
 #include <cerrno>
@@ -31,12 +35,14 @@
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <mutex>
 #include <poll.h>
 #include <unistd.h>
 
 #include <wayland-client.h>
 #include "xdg-shell-client-protocol.h"
 #include "linux-dmabuf-unstable-v1-client-protocol.h"
+#include "linux-explicit-synchronization-unstable-v1-protocol.h"
 #include "xdg-decoration-unstable-v1-client-protocol.h"
 
 namespace wsi
@@ -44,15 +50,78 @@ namespace wsi
 namespace x11
 {
 
+/**
+ * @brief Process-wide shared Wayland connection for bypass presenters.
+ *
+ * Every bypass window used to open its own wl_display, bind its own globals
+ * and answer its own xdg_wm_base pings, so N windows meant N socket
+ * connections and N dispatch loops.  One connection and one bound-global set
+ * is now shared per process; each wayland_bypass instance gets a private
+ * wl_event_queue for its surface's events, the same split the native Wayland
+ * backend uses between the surface queue and each swapchain's buffer queue.
+ *
+ * Registry and xdg_wm_base events are kept on their own globals queue so a
+ * ping is never stranded on a per-surface queue that nobody polls; any
+ * presenter that dispatches its own queue also drains the globals queue.
+ * The connection is established once and kept for the process lifetime,
+ * like the cached DRM display in drm_display::get_display().
+ */
+struct bypass_connection
+{
+   struct wl_display *display = nullptr;
+   struct wl_registry *registry = nullptr;
+   struct wl_compositor *compositor = nullptr;
+   struct xdg_wm_base *wm_base = nullptr;
+   struct zwp_linux_dmabuf_v1 *dmabuf = nullptr;
+   struct zwp_linux_explicit_synchronization_v1 *explicit_sync = nullptr;
+   struct zxdg_decoration_manager_v1 *decoration_manager = nullptr;
+
+   /** One entry per advertised wl_output; current mode size used for
+    *  fullscreen matching.  Guarded by globals_mutex after setup. */
+   struct output_info
+   {
+      struct wl_output *output = nullptr;
+      int32_t width = 0;
+      int32_t height = 0;
+   };
+   std::vector<output_info> outputs;
+
+   /** Queue carrying registry and xdg_wm_base events (pings). */
+   struct wl_event_queue *globals_queue = nullptr;
+
+   /** Serializes dispatch of globals_queue between presenter threads. */
+   std::mutex globals_mutex;
+
+   ~bypass_connection()
+   {
+      for (auto &info : outputs)
+         wl_output_destroy(info.output);
+      if (decoration_manager)
+         zxdg_decoration_manager_v1_destroy(decoration_manager);
+      if (explicit_sync)
+         zwp_linux_explicit_synchronization_v1_destroy(explicit_sync);
+      if (dmabuf)
+         zwp_linux_dmabuf_v1_destroy(dmabuf);
+      if (wm_base)
+         xdg_wm_base_destroy(wm_base);
+      if (compositor)
+         wl_compositor_destroy(compositor);
+      if (registry)
+         wl_registry_destroy(registry);
+      if (globals_queue)
+         wl_event_queue_destroy(globals_queue);
+      if (display)
+      {
+         wl_display_flush(display);
+         wl_display_disconnect(display);
+      }
+   }
+};
+
 /* --- Static Wayland callbacks --- */
 
 static void registry_global(void *data, struct wl_registry *registry, uint32_t name,
-                            const char *interface, uint32_t version)
-{
-   auto *self = static_cast<wayland_bypass *>(data);
-   self->handle_registry_global(name, interface, version);
-   (void)registry;
-}
+                            const char *interface, uint32_t version);
 
 static void registry_global_remove(void *, struct wl_registry *, uint32_t) {}
 
@@ -63,15 +132,186 @@ static const struct wl_registry_listener registry_listener = {
 
 static void xdg_wm_base_ping(void *data, struct xdg_wm_base *wm_base, uint32_t serial)
 {
-   auto *self = static_cast<wayland_bypass *>(data);
-   self->handle_xdg_wm_base_ping(serial);
-   (void)wm_base;
+   /* Liveness check from the compositor; answered here on behalf of every
+    * bypass window sharing the connection. */
+   xdg_wm_base_pong(wm_base, serial);
+   (void)data;
 }
 
 static const struct xdg_wm_base_listener wm_base_listener = {
    xdg_wm_base_ping,
 };
 
+static void output_geometry(void *, struct wl_output *, int32_t, int32_t, int32_t, int32_t,
+                            int32_t, const char *, const char *, int32_t) {}
+
+static void output_mode(void *data, struct wl_output *output, uint32_t flags,
+                        int32_t width, int32_t height, int32_t refresh)
+{
+   if (!(flags & WL_OUTPUT_MODE_CURRENT))
+      return;
+   auto *conn = static_cast<bypass_connection *>(data);
+   for (auto &info : conn->outputs)
+   {
+      if (info.output == output)
+      {
+         info.width = width;
+         info.height = height;
+         break;
+      }
+   }
+   (void)refresh;
+}
+
+static void output_done(void *, struct wl_output *) {}
+static void output_scale(void *, struct wl_output *, int32_t) {}
+
+/* Bound at version <= 2, so the v4 name/description events never arrive. */
+static const struct wl_output_listener output_listener = {
+   output_geometry,
+   output_mode,
+   output_done,
+   output_scale,
+};
+
+static void registry_global(void *data, struct wl_registry *registry, uint32_t name,
+                            const char *interface, uint32_t version)
+{
+   auto *conn = static_cast<bypass_connection *>(data);
+
+   if (strcmp(interface, "wl_compositor") == 0)
+   {
+      conn->compositor = static_cast<struct wl_compositor *>(
+         wl_registry_bind(registry, name, &wl_compositor_interface, 4));
+   }
+   else if (strcmp(interface, "xdg_wm_base") == 0)
+   {
+      conn->wm_base = static_cast<struct xdg_wm_base *>(
+         wl_registry_bind(registry, name, &xdg_wm_base_interface, 1));
+      xdg_wm_base_add_listener(conn->wm_base, &wm_base_listener, conn);
+   }
+   else if (strcmp(interface, "zwp_linux_dmabuf_v1") == 0)
+   {
+      uint32_t bind_ver = version < 3 ? version : 3;
+      conn->dmabuf = static_cast<struct zwp_linux_dmabuf_v1 *>(
+         wl_registry_bind(registry, name, &zwp_linux_dmabuf_v1_interface, bind_ver));
+   }
+   else if (strcmp(interface, "zwp_linux_explicit_synchronization_v1") == 0)
+   {
+      conn->explicit_sync = static_cast<struct zwp_linux_explicit_synchronization_v1 *>(
+         wl_registry_bind(registry, name, &zwp_linux_explicit_synchronization_v1_interface, 1));
+   }
+   else if (strcmp(interface, "zxdg_decoration_manager_v1") == 0)
+   {
+      conn->decoration_manager = static_cast<struct zxdg_decoration_manager_v1 *>(
+         wl_registry_bind(registry, name, &zxdg_decoration_manager_v1_interface, 1));
+   }
+   else if (strcmp(interface, "wl_output") == 0)
+   {
+      uint32_t bind_ver = version < 2 ? version : 2;
+      auto *output = static_cast<struct wl_output *>(
+         wl_registry_bind(registry, name, &wl_output_interface, bind_ver));
+      if (output)
+      {
+         conn->outputs.push_back({ output, 0, 0 });
+         wl_output_add_listener(output, &output_listener, conn);
+      }
+   }
+   (void)version;
+}
+
+/**
+ * @brief Get the shared bypass connection, connecting on the first call.
+ *
+ * The returned object has a null display when no Wayland compositor could be
+ * reached; the probe result is cached either way.
+ */
+static bypass_connection &get_bypass_connection()
+{
+   static std::once_flag flag{};
+   static bypass_connection conn{};
+
+   std::call_once(flag, []() {
+      struct wl_display *display = wl_display_connect(nullptr);
+      if (!display)
+      {
+         /* Try the common default socket name */
+         display = wl_display_connect("wayland-0");
+      }
+      if (!display)
+      {
+         return;
+      }
+
+      conn.globals_queue = wl_display_create_queue(display);
+      if (!conn.globals_queue)
+      {
+         wl_display_disconnect(display);
+         return;
+      }
+
+      /* Put the registry - and everything bound through it - on the globals
+       * queue, so shared-proxy events never land on a per-surface queue. */
+      auto *display_wrapper = static_cast<struct wl_display *>(wl_proxy_create_wrapper(display));
+      if (!display_wrapper)
+      {
+         wl_event_queue_destroy(conn.globals_queue);
+         conn.globals_queue = nullptr;
+         wl_display_disconnect(display);
+         return;
+      }
+      wl_proxy_set_queue(reinterpret_cast<wl_proxy *>(display_wrapper), conn.globals_queue);
+      conn.registry = wl_display_get_registry(display_wrapper);
+      wl_proxy_wrapper_destroy(display_wrapper);
+
+      wl_registry_add_listener(conn.registry, &registry_listener, &conn);
+
+      /* Round-trip to get globals */
+      wl_display_roundtrip_queue(display, conn.globals_queue);
+
+      /* Second round-trip collects the initial events of the globals bound
+       * above — wl_output modes, needed for fullscreen matching. */
+      wl_display_roundtrip_queue(display, conn.globals_queue);
+
+      /* Set the Wayland fd to non-blocking so that wl_display_read_events()
+       * never blocks.  Without this, the event thread can block in read_events
+       * while holding m_wl_mutex, preventing present_image from committing
+       * new frames (causes slideshow-like stutter).  libwayland handles
+       * EAGAIN gracefully — read_events returns 0 without reading. */
+      int wl_fd = wl_display_get_fd(display);
+      int flags = fcntl(wl_fd, F_GETFL, 0);
+      if (flags >= 0)
+         fcntl(wl_fd, F_SETFL, flags | O_NONBLOCK);
+
+      conn.display = display;
+      WSI_LOG_INFO("wayland_bypass: shared Wayland connection established");
+   });
+
+   return conn;
+}
+
+/**
+ * @brief Create a child object through a proxy wrapper bound to @p queue.
+ *
+ * Wayland children inherit the queue of the proxy that creates them, so the
+ * shared globals are wrapped per call to keep each surface's events on its
+ * own queue.
+ */
+template <typename parent, typename create_fn>
+static auto create_on_queue(parent *global, struct wl_event_queue *queue, create_fn &&create)
+   -> decltype(create(global))
+{
+   auto *wrapper = static_cast<parent *>(wl_proxy_create_wrapper(global));
+   if (!wrapper)
+   {
+      return nullptr;
+   }
+   wl_proxy_set_queue(reinterpret_cast<wl_proxy *>(wrapper), queue);
+   auto *object = create(wrapper);
+   wl_proxy_wrapper_destroy(wrapper);
+   return object;
+}
+
 static void xdg_surface_configure(void *data, struct xdg_surface *surface, uint32_t serial)
 {
    auto *self = static_cast<wayland_bypass *>(data);
@@ -120,6 +360,28 @@ static const struct wl_buffer_listener buffer_listener = {
 };
 
 
+/**
+ * @brief Whether a DRM fourcc carries no alpha and can be declared opaque.
+ *
+ * Only the alpha-capable formats the swapchain can negotiate need listing;
+ * everything else — including the X variants the ARGB remap in
+ * create_image_resources produces — scans out opaque.
+ */
+static bool is_opaque_fourcc(uint32_t fourcc)
+{
+   switch (fourcc)
+   {
+   case 0x34325241: /* DRM_FORMAT_ARGB8888 */
+   case 0x34324241: /* DRM_FORMAT_ABGR8888 */
+   case 0x30335241: /* DRM_FORMAT_ARGB2101010 */
+   case 0x30334241: /* DRM_FORMAT_ABGR2101010 */
+   case 0x48344241: /* DRM_FORMAT_ABGR16161616F */
+      return false;
+   default:
+      return true;
+   }
+}
+
 /* --- wayland_bypass implementation --- */
 
 wayland_bypass::wayland_bypass()
@@ -134,78 +396,31 @@ wayland_bypass::~wayland_bypass()
       xdg_toplevel_destroy(m_xdg_toplevel);
    if (m_xdg_surface)
       xdg_surface_destroy(m_xdg_surface);
+   if (m_surface_sync)
+      zwp_linux_surface_synchronization_v1_destroy(m_surface_sync);
    if (m_wl_surface)
       wl_surface_destroy(m_wl_surface);
-   if (m_dmabuf)
-      zwp_linux_dmabuf_v1_destroy(m_dmabuf);
-   if (m_decoration_manager)
-      zxdg_decoration_manager_v1_destroy(m_decoration_manager);
-   if (m_xdg_wm_base)
-      xdg_wm_base_destroy(m_xdg_wm_base);
-   if (m_wl_compositor)
-      wl_compositor_destroy(m_wl_compositor);
-   if (m_wl_registry)
-      wl_registry_destroy(m_wl_registry);
+   if (m_queue)
+      wl_event_queue_destroy(m_queue);
    if (m_wl_display)
    {
+      /* The connection itself is shared with other bypass windows and stays
+       * open for the process lifetime; only flush our destroy requests. */
       wl_display_flush(m_wl_display);
-      wl_display_disconnect(m_wl_display);
    }
 }
 
 bool wayland_bypass::is_available()
 {
    /* Allow disabling bypass for testing/comparison */
-   if (getenv("WSI_NO_WAYLAND_BYPASS"))
+   if (util::config::get().wayland_bypass_disabled())
       return false;
 
-   /* Try connecting to Wayland — first via WAYLAND_DISPLAY, then default socket.
-    * Even if WAYLAND_DISPLAY is unset (app forced X11), we can still bypass
-    * if a Wayland compositor is running. */
-   struct wl_display *display = wl_display_connect(nullptr);
-   if (!display)
-   {
-      /* Try the common default socket name */
-      display = wl_display_connect("wayland-0");
-   }
-   if (!display)
-   {
-      return false;
-   }
-   wl_display_disconnect(display);
-   return true;
-}
-
-void wayland_bypass::handle_registry_global(uint32_t name, const char *interface, uint32_t version)
-{
-   if (strcmp(interface, "wl_compositor") == 0)
-   {
-      m_wl_compositor = static_cast<struct wl_compositor *>(
-         wl_registry_bind(m_wl_registry, name, &wl_compositor_interface, 4));
-   }
-   else if (strcmp(interface, "xdg_wm_base") == 0)
-   {
-      m_xdg_wm_base = static_cast<struct xdg_wm_base *>(
-         wl_registry_bind(m_wl_registry, name, &xdg_wm_base_interface, 1));
-      xdg_wm_base_add_listener(m_xdg_wm_base, &wm_base_listener, this);
-   }
-   else if (strcmp(interface, "zwp_linux_dmabuf_v1") == 0)
-   {
-      uint32_t bind_ver = version < 3 ? version : 3;
-      m_dmabuf = static_cast<struct zwp_linux_dmabuf_v1 *>(
-         wl_registry_bind(m_wl_registry, name, &zwp_linux_dmabuf_v1_interface, bind_ver));
-   }
-   else if (strcmp(interface, "zxdg_decoration_manager_v1") == 0)
-   {
-      m_decoration_manager = static_cast<struct zxdg_decoration_manager_v1 *>(
-         wl_registry_bind(m_wl_registry, name, &zxdg_decoration_manager_v1_interface, 1));
-   }
-   (void)version;
-}
-
-void wayland_bypass::handle_xdg_wm_base_ping(uint32_t serial)
-{
-   xdg_wm_base_pong(m_xdg_wm_base, serial);
+   /* Even if WAYLAND_DISPLAY is unset (app forced X11), we can still bypass
+    * if a Wayland compositor is running.  The first probe establishes the
+    * shared connection, so a positive answer here means init() and every
+    * later bypass window skip connection setup entirely. */
+   return get_bypass_connection().display != nullptr;
 }
 
 void wayland_bypass::handle_xdg_surface_configure(uint32_t serial)
@@ -231,73 +446,138 @@ void wayland_bypass::handle_xdg_toplevel_close()
 void wayland_bypass::handle_buffer_release(struct wl_buffer *buffer)
 {
    /* Called from wl_display_dispatch_pending() context.
-    * m_wl_mutex is held by the caller (dispatch_and_get_releases or init),
-    * so we only need m_release_mutex here. */
+    * m_wl_mutex is held by the caller (dispatch_and_get_releases,
+    * present_image or init), so we only need m_release_mutex here. */
    std::lock_guard<std::mutex> lock(m_release_mutex);
+   if (m_release_callback != nullptr)
+   {
+      /* Forward straight to the swapchain so the image returns to the free
+       * pool now, not on the next dispatch_and_get_releases() poll. */
+      m_release_callback(m_release_user_data, buffer);
+      return;
+   }
    m_released_buffers.push_back(buffer);
 }
 
+void wayland_bypass::set_release_callback(buffer_release_callback callback, void *user_data)
+{
+   std::lock_guard<std::mutex> lock(m_release_mutex);
+   m_release_callback = callback;
+   m_release_user_data = user_data;
+
+   /* Anything queued while no callback was registered belongs to a previous
+    * swapchain's buffers; drop it. */
+   m_released_buffers.clear();
+}
+
 VkResult wayland_bypass::init(uint32_t width, uint32_t height)
 {
    m_width = width;
    m_height = height;
 
-   m_wl_display = wl_display_connect(nullptr);
-   if (!m_wl_display)
-   {
-      m_wl_display = wl_display_connect("wayland-0");
-   }
-   if (!m_wl_display)
+   auto &conn = get_bypass_connection();
+   if (!conn.display)
    {
       WSI_LOG_ERROR("wayland_bypass: failed to connect to Wayland compositor");
       return VK_ERROR_INITIALIZATION_FAILED;
    }
-
-   m_wl_registry = wl_display_get_registry(m_wl_display);
-   wl_registry_add_listener(m_wl_registry, &registry_listener, this);
-
-   /* Round-trip to get globals */
-   wl_display_roundtrip(m_wl_display);
-
-   if (!m_wl_compositor)
+   if (!conn.compositor)
    {
       WSI_LOG_ERROR("wayland_bypass: compositor not found");
       return VK_ERROR_INITIALIZATION_FAILED;
    }
-   if (!m_xdg_wm_base)
+   if (!conn.wm_base)
    {
       WSI_LOG_ERROR("wayland_bypass: xdg_wm_base not found");
       return VK_ERROR_INITIALIZATION_FAILED;
    }
-   if (!m_dmabuf)
+   if (!conn.dmabuf)
    {
       WSI_LOG_ERROR("wayland_bypass: zwp_linux_dmabuf_v1 not found");
       return VK_ERROR_INITIALIZATION_FAILED;
    }
 
-   /* Create surface + xdg_toplevel */
-   m_wl_surface = wl_compositor_create_surface(m_wl_compositor);
+   m_conn = &conn;
+   m_wl_display = conn.display;
+
+   /* Private queue for this surface's events, so several bypass windows can
+    * dispatch concurrently without stealing each other's events. */
+   m_queue = wl_display_create_queue(conn.display);
+   if (!m_queue)
+   {
+      WSI_LOG_ERROR("wayland_bypass: failed to create event queue");
+      return VK_ERROR_INITIALIZATION_FAILED;
+   }
+
+   /* Create surface + xdg_toplevel on the private queue */
+   m_wl_surface = create_on_queue(conn.compositor, m_queue, wl_compositor_create_surface);
    if (!m_wl_surface)
    {
       WSI_LOG_ERROR("wayland_bypass: failed to create wl_surface");
       return VK_ERROR_INITIALIZATION_FAILED;
    }
 
-   m_xdg_surface = xdg_wm_base_get_xdg_surface(m_xdg_wm_base, m_wl_surface);
+   /* Per-surface explicit sync object, when the compositor supports it.
+    * Lets present_image forward the image's acquire fence as a sync_fd
+    * instead of the page flip thread CPU-waiting on it. */
+   if (conn.explicit_sync)
+   {
+      m_surface_sync = create_on_queue(conn.explicit_sync, m_queue, [this](auto *sync) {
+         return zwp_linux_explicit_synchronization_v1_get_synchronization(sync, m_wl_surface);
+      });
+   }
+
+   m_xdg_surface = create_on_queue(conn.wm_base, m_queue, [this](struct xdg_wm_base *wm_base) {
+      return xdg_wm_base_get_xdg_surface(wm_base, m_wl_surface);
+   });
+   if (!m_xdg_surface)
+   {
+      WSI_LOG_ERROR("wayland_bypass: failed to create xdg_surface");
+      return VK_ERROR_INITIALIZATION_FAILED;
+   }
    xdg_surface_add_listener(m_xdg_surface, &surface_listener, this);
 
+   /* Children of m_xdg_surface inherit the private queue. */
    m_xdg_toplevel = xdg_surface_get_toplevel(m_xdg_surface);
    xdg_toplevel_add_listener(m_xdg_toplevel, &toplevel_listener, this);
    xdg_toplevel_set_title(m_xdg_toplevel, "Vulkan (Xwayland bypass)");
    xdg_toplevel_set_app_id(m_xdg_toplevel, "vulkan-xwayland-bypass");
 
    /* Request server-side decorations (titlebar) */
-   if (m_decoration_manager)
+   if (conn.decoration_manager)
    {
-      m_toplevel_decoration = zxdg_decoration_manager_v1_get_toplevel_decoration(
-         m_decoration_manager, m_xdg_toplevel);
-      zxdg_toplevel_decoration_v1_set_mode(m_toplevel_decoration,
-         ZXDG_TOPLEVEL_DECORATION_V1_MODE_SERVER_SIDE);
+      m_toplevel_decoration = create_on_queue(conn.decoration_manager, m_queue, [this](auto *manager) {
+         return zxdg_decoration_manager_v1_get_toplevel_decoration(manager, m_xdg_toplevel);
+      });
+      if (m_toplevel_decoration)
+      {
+         zxdg_toplevel_decoration_v1_set_mode(m_toplevel_decoration,
+            ZXDG_TOPLEVEL_DECORATION_V1_MODE_SERVER_SIDE);
+      }
+   }
+
+   /* Buffers are attached at native scale and orientation; state it explicitly
+    * rather than leaving the compositor to assume.  Surfaces with non-trivial
+    * buffer transforms are disqualified from direct scanout on most
+    * compositors. */
+   wl_surface_set_buffer_scale(m_wl_surface, 1);
+   wl_surface_set_buffer_transform(m_wl_surface, WL_OUTPUT_TRANSFORM_NORMAL);
+
+   /* A window whose size matches an output's current mode is a fullscreen
+    * swapchain in all but name; say so through xdg_toplevel so the compositor
+    * can promote the buffer to a hardware plane instead of compositing it. */
+   {
+      std::lock_guard<std::mutex> globals_lock(conn.globals_mutex);
+      for (const auto &info : conn.outputs)
+      {
+         if (info.width == static_cast<int32_t>(m_width) && info.height == static_cast<int32_t>(m_height))
+         {
+            xdg_toplevel_set_fullscreen(m_xdg_toplevel, info.output);
+            WSI_LOG_INFO("wayland_bypass: window matches output mode %dx%d, requesting fullscreen",
+                         info.width, info.height);
+            break;
+         }
+      }
    }
 
    /* Commit to trigger configure */
@@ -307,23 +587,13 @@ VkResult wayland_bypass::init(uint32_t width, uint32_t height)
    /* Wait for initial configure */
    while (!m_configured)
    {
-      if (wl_display_dispatch(m_wl_display) < 0)
+      if (wl_display_dispatch_queue(m_wl_display, m_queue) < 0)
       {
          WSI_LOG_ERROR("wayland_bypass: display dispatch failed during configure");
          return VK_ERROR_INITIALIZATION_FAILED;
       }
    }
 
-   /* Set the Wayland fd to non-blocking so that wl_display_read_events()
-    * never blocks.  Without this, the event thread can block in read_events
-    * while holding m_wl_mutex, preventing present_image from committing
-    * new frames (causes slideshow-like stutter).  libwayland handles
-    * EAGAIN gracefully — read_events returns 0 without reading. */
-   int wl_fd = wl_display_get_fd(m_wl_display);
-   int flags = fcntl(wl_fd, F_GETFL, 0);
-   if (flags >= 0)
-      fcntl(wl_fd, F_SETFL, flags | O_NONBLOCK);
-
    WSI_LOG_INFO("wayland_bypass: initialized (%ux%u), zero-copy DMA-BUF presentation",
                 m_width, m_height);
 
@@ -333,7 +603,7 @@ VkResult wayland_bypass::init(uint32_t width, uint32_t height)
 VkResult wayland_bypass::create_image_resources(x11_image_data *image_data, uint32_t width, uint32_t height,
                                                  uint32_t fourcc, uint64_t modifier)
 {
-   if (!m_dmabuf || !m_wl_display)
+   if (!m_conn || !m_conn->dmabuf || !m_wl_display)
    {
       return VK_ERROR_INITIALIZATION_FAILED;
    }
@@ -356,7 +626,31 @@ VkResult wayland_bypass::create_image_resources(x11_image_data *image_data, uint
    if (fourcc == 0x34324241) /* DRM_FORMAT_ABGR8888 */
       fourcc = 0x34324258;   /* DRM_FORMAT_XBGR8888 */
 
-   struct zwp_linux_buffer_params_v1 *params = zwp_linux_dmabuf_v1_create_params(m_dmabuf);
+   /* An opaque buffer alone does not qualify the surface for direct scanout:
+    * compositors also want the opaque region to cover the surface, otherwise
+    * they must assume blending and composite.  Double-buffered state, so it
+    * latches on the next present's commit. */
+   if (is_opaque_fourcc(fourcc) && !m_opaque_region_set)
+   {
+      struct wl_region *region = wl_compositor_create_region(m_conn->compositor);
+      if (region)
+      {
+         wl_region_add(region, 0, 0, INT32_MAX, INT32_MAX);
+         wl_surface_set_opaque_region(m_wl_surface, region);
+         wl_region_destroy(region);
+         m_opaque_region_set = true;
+      }
+   }
+
+   /* The params - and the wl_buffer created from them - go on the private
+    * queue so release events arrive where this surface dispatches. */
+   struct zwp_linux_buffer_params_v1 *params =
+      create_on_queue(m_conn->dmabuf, m_queue, zwp_linux_dmabuf_v1_create_params);
+   if (!params)
+   {
+      WSI_LOG_ERROR("wayland_bypass: failed to create buffer params");
+      return VK_ERROR_INITIALIZATION_FAILED;
+   }
    zwp_linux_buffer_params_v1_add(params, dma_buf_fd, 0, offset, stride, modifier_hi, modifier_lo);
 
    struct wl_buffer *buffer = zwp_linux_buffer_params_v1_create_immed(params, width, height, fourcc, 0);
@@ -381,7 +675,7 @@ VkResult wayland_bypass::create_image_resources(x11_image_data *image_data, uint
    return VK_SUCCESS;
 }
 
-VkResult wayland_bypass::present_image(x11_image_data *image_data)
+VkResult wayland_bypass::present_image(x11_image_data *image_data, int acquire_fence_fd)
 {
    std::lock_guard<std::mutex> wl_lock(m_wl_mutex);
 
@@ -396,6 +690,16 @@ VkResult wayland_bypass::present_image(x11_image_data *image_data)
       return VK_ERROR_SURFACE_LOST_KHR;
    }
 
+   /* Hand the GPU completion fence to the compositor: it will not sample the
+    * buffer before the fence signals, so the caller can commit without
+    * CPU-waiting on the render first.  set_acquire_fence applies to the next
+    * commit only and the compositor dups the fd from the wire, so the
+    * caller's fd is untouched. */
+   if (m_surface_sync && acquire_fence_fd >= 0)
+   {
+      zwp_linux_surface_synchronization_v1_set_acquire_fence(m_surface_sync, acquire_fence_fd);
+   }
+
    wl_surface_attach(m_wl_surface, buffer, 0, 0);
    wl_surface_damage_buffer(m_wl_surface, 0, 0, INT32_MAX, INT32_MAX);
    wl_surface_commit(m_wl_surface);
@@ -407,25 +711,41 @@ VkResult wayland_bypass::present_image(x11_image_data *image_data)
       return VK_ERROR_SURFACE_LOST_KHR;
    }
 
+   /* Dispatch whatever the compositor has already sent while we still hold
+    * m_wl_mutex, so releases for displaced buffers are processed in the same
+    * batch as this commit instead of waiting for the event thread's next
+    * poll.  The fd is non-blocking, so this never stalls the present. */
+   dispatch_events_nonblocking();
+
    return VK_SUCCESS;
 }
 
+void wayland_bypass::dispatch_events_nonblocking()
+{
+   /* Non-blocking read + dispatch of the private queue:
+    * 1. Dispatch any events already in the queue
+    * 2. prepare_read_queue acquires the internal read lock
+    * 3. read_events does a non-blocking read from the socket
+    * 4. Dispatch the newly read events */
+   while (wl_display_prepare_read_queue(m_wl_display, m_queue) != 0)
+      wl_display_dispatch_queue_pending(m_wl_display, m_queue);
+
+   wl_display_read_events(m_wl_display);
+   wl_display_dispatch_queue_pending(m_wl_display, m_queue);
+
+   /* Drain the shared globals queue too, so an xdg_wm_base ping is answered
+    * by whichever bypass window happens to poll first. */
+   std::lock_guard<std::mutex> globals_lock(m_conn->globals_mutex);
+   wl_display_dispatch_queue_pending(m_wl_display, m_conn->globals_queue);
+}
+
 void wayland_bypass::dispatch_and_get_releases(std::vector<struct wl_buffer *> &released)
 {
    {
       std::lock_guard<std::mutex> wl_lock(m_wl_mutex);
       if (m_wl_display)
       {
-         /* Non-blocking read + dispatch:
-          * 1. Dispatch any events already in the queue
-          * 2. prepare_read acquires the internal read lock
-          * 3. read_events does a non-blocking read from the socket
-          * 4. Dispatch the newly read events */
-         while (wl_display_prepare_read(m_wl_display) != 0)
-            wl_display_dispatch_pending(m_wl_display);
-
-         wl_display_read_events(m_wl_display);
-         wl_display_dispatch_pending(m_wl_display);
+         dispatch_events_nonblocking();
       }
    }
 
@@ -436,6 +756,11 @@ void wayland_bypass::dispatch_and_get_releases(std::vector<struct wl_buffer *> &
    }
 }
 
+int wayland_bypass::get_event_fd()
+{
+   return m_wl_display ? wl_display_get_fd(m_wl_display) : -1;
+}
+
 void wayland_bypass::destroy_image_resources(x11_image_data *image_data)
 {
    struct wl_buffer *buffer = reinterpret_cast<struct wl_buffer *>(image_data->cpu_buffer);
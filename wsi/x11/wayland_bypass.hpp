@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2025 Arm Limited.
+ * Copyright (c) 2025-2026 Arm Limited.
  *
  * SPDX-License-Identifier: MIT
  */
@@ -27,6 +27,8 @@ struct xdg_wm_base;
 struct xdg_surface;
 struct xdg_toplevel;
 struct zwp_linux_dmabuf_v1;
+struct zwp_linux_explicit_synchronization_v1;
+struct zwp_linux_surface_synchronization_v1;
 struct zxdg_decoration_manager_v1;
 struct zxdg_toplevel_decoration_v1;
 
@@ -37,6 +39,9 @@ namespace x11
 
 struct x11_image_data;
 
+/** Process-wide shared Wayland connection and bound globals (see wayland_bypass.cpp). */
+struct bypass_connection;
+
 class wayland_bypass
 {
 public:
@@ -46,16 +51,18 @@ public:
    /**
     * @brief Check if Xwayland bypass is available.
     *
-    * Returns true if running under Xwayland (WAYLAND_DISPLAY is set)
-    * and the Wayland compositor supports zwp_linux_dmabuf_v1.
+    * Returns true if a Wayland compositor can be reached. Establishes the
+    * process-wide shared connection on the first call, so a positive answer
+    * also means init() will not pay any connection setup cost.
     */
    bool is_available();
 
    /**
     * @brief Initialize the bypass presenter.
     *
-    * Connects to the Wayland compositor, creates wl_surface + xdg_toplevel,
-    * and negotiates DMA-BUF formats.
+    * Attaches to the process-wide shared Wayland connection, creates
+    * wl_surface + xdg_toplevel on a private event queue, and negotiates
+    * DMA-BUF formats.
     */
    VkResult init(uint32_t width, uint32_t height);
 
@@ -69,20 +76,51 @@ public:
     * @brief Present an image via the Wayland compositor.
     *
     * Thread-safe: protected by m_wl_mutex.
+    *
+    * @param image_data       The image to present.
+    * @param acquire_fence_fd sync_fd the compositor must wait on before reading
+    *                         the buffer, or -1.  Forwarded through
+    *                         zwp_linux_surface_synchronization_v1 when the
+    *                         compositor supports explicit sync (see
+    *                         supports_explicit_sync()), ignored otherwise.  The
+    *                         fd is only borrowed for the duration of the call;
+    *                         the caller keeps ownership.
+    */
+   VkResult present_image(x11_image_data *image_data, int acquire_fence_fd = -1);
+
+   /**
+    * @brief Whether acquire fences can be forwarded to the compositor.
+    *
+    * True when the compositor supports zwp_linux_explicit_synchronization_v1,
+    * in which case the caller can skip CPU-waiting on the present payload and
+    * pass it to present_image() as a sync_fd instead.
     */
-   VkResult present_image(x11_image_data *image_data);
+   bool supports_explicit_sync() const
+   {
+      return m_surface_sync != nullptr;
+   }
 
    /**
     * @brief Destroy Wayland resources for an image.
     */
    void destroy_image_resources(x11_image_data *image_data);
 
+   /**
+    * @brief File descriptor of the Wayland connection, for external polling.
+    *
+    * Becomes readable when the compositor sends events (buffer releases,
+    * pings).  Returns -1 when not connected.
+    */
+   int get_event_fd();
+
    /**
     * @brief Non-blocking dispatch of Wayland events and collection of released buffers.
     *
     * Reads any pending data from the compositor, dispatches events (including
     * wl_buffer.release), and returns the list of wl_buffer pointers that were
-    * released since the last call.
+    * released since the last call.  With a release callback registered the
+    * releases are forwarded from dispatch context instead and @p released
+    * stays empty.
     *
     * Thread-safe: protected by m_wl_mutex and m_release_mutex.
     *
@@ -90,39 +128,74 @@ public:
     */
    void dispatch_and_get_releases(std::vector<struct wl_buffer *> &released);
 
+   /**
+    * @brief Callback invoked from dispatch context when the compositor releases a buffer.
+    */
+   using buffer_release_callback = void (*)(void *user_data, struct wl_buffer *buffer);
+
+   /**
+    * @brief Register a callback that receives wl_buffer.release the moment it arrives.
+    *
+    * While a callback is registered, released buffers are forwarded to it from
+    * dispatch context instead of being queued for the next
+    * dispatch_and_get_releases() poll, so the owning swapchain can return the
+    * image to its free pool immediately.  Pass nullptr to unregister; the call
+    * synchronizes with any in-flight release delivery.
+    */
+   void set_release_callback(buffer_release_callback callback, void *user_data);
+
    /* Wayland event handlers (called from static callbacks) */
-   void handle_registry_global(uint32_t name, const char *interface, uint32_t version);
-   void handle_xdg_wm_base_ping(uint32_t serial);
    void handle_xdg_surface_configure(uint32_t serial);
    void handle_xdg_toplevel_configure(int32_t width, int32_t height);
    void handle_xdg_toplevel_close();
    void handle_buffer_release(struct wl_buffer *buffer);
 
 private:
+   /**
+    * @brief Non-blocking read + dispatch of this surface's event queue.
+    *
+    * Also dispatches the shared connection's globals queue so xdg_wm_base
+    * pings are answered regardless of which presenter happens to poll.
+    * The caller must hold m_wl_mutex.
+    */
+   void dispatch_events_nonblocking();
+
+   /** Shared per-process connection and bound globals; not owned. */
+   bypass_connection *m_conn = nullptr;
+   /** The shared connection's wl_display; borrowed from m_conn. */
    struct wl_display *m_wl_display = nullptr;
-   struct wl_registry *m_wl_registry = nullptr;
-   struct wl_compositor *m_wl_compositor = nullptr;
+   /** Private event queue carrying this surface's events (configure, buffer
+    *  releases), mirroring the Wayland backend's per-swapchain buffer queue. */
+   struct wl_event_queue *m_queue = nullptr;
    struct wl_surface *m_wl_surface = nullptr;
-   struct xdg_wm_base *m_xdg_wm_base = nullptr;
    struct xdg_surface *m_xdg_surface = nullptr;
    struct xdg_toplevel *m_xdg_toplevel = nullptr;
-   struct zwp_linux_dmabuf_v1 *m_dmabuf = nullptr;
-   struct zxdg_decoration_manager_v1 *m_decoration_manager = nullptr;
+   struct zwp_linux_surface_synchronization_v1 *m_surface_sync = nullptr;
    struct zxdg_toplevel_decoration_v1 *m_toplevel_decoration = nullptr;
 
    bool m_configured = false;
    bool m_closed = false;
+   /** True once a full-surface opaque region has been declared for an
+    *  alpha-less buffer format (a direct-scanout prerequisite). */
+   bool m_opaque_region_set = false;
    uint32_t m_width = 0;
    uint32_t m_height = 0;
 
    /** Mutex protecting all Wayland display operations (commit, dispatch, flush). */
    std::mutex m_wl_mutex;
 
-   /** Mutex protecting m_released_buffers. */
+   /** Mutex protecting m_released_buffers and the release callback. */
    std::mutex m_release_mutex;
 
-   /** wl_buffer pointers released by the compositor, pending processing. */
+   /** wl_buffer pointers released by the compositor, pending processing.
+    *  Only used while no release callback is registered. */
    std::vector<struct wl_buffer *> m_released_buffers;
+
+   /** Callback forwarding releases directly to the swapchain, or nullptr. */
+   buffer_release_callback m_release_callback = nullptr;
+
+   /** User data passed back through m_release_callback. */
+   void *m_release_user_data = nullptr;
 };
 
 } /* namespace x11 */